@@ -23,6 +23,7 @@
 #include "mozilla/dom/WorkerScope.h"
 #include "mozilla/ipc/PBackgroundSharedTypes.h"
 #include "mozilla/ScopeExit.h"
+#include "mozilla/StaticPrefs_dom.h"
 #include "mozilla/TaskQueue.h"
 #include "nsComponentManagerUtils.h"
 #include "nsIFile.h"
@@ -30,6 +31,7 @@
 #include "nsIStreamLoader.h"
 #include "nsNetUtil.h"
 #include "nsProxyRelease.h"
+#include "nsThreadUtils.h"
 #include "nsIInputStream.h"
 
 // Undefine the macro of CreateFile to avoid FileCreatorHelper#CreateFile being
@@ -674,6 +676,7 @@ void BodyConsumer::ContinueConsumeBody(nsresult aStatus, uint32_t aResultLength,
 
   JSContext* cx = jsapi.cx();
   ErrorResult error;
+  JS::Rooted<JS::Value> json(cx);
 
   switch (mConsumeType) {
     case ConsumeType::ArrayBuffer: {
@@ -711,16 +714,32 @@ void BodyConsumer::ContinueConsumeBody(nsresult aStatus, uint32_t aResultLength,
       }
       break;
     }
-    case ConsumeType::Text:
-      // fall through handles early exit.
     case ConsumeType::JSON: {
+      if (BodyUtil::ConsumeAsciiJson(cx, &json, aResultLength,
+                                     resultPtr.get(), error)) {
+        if (!error.Failed()) {
+          localPromise->MaybeResolve(json);
+        }
+        break;
+      }
+
+      uint32_t threshold =
+          StaticPrefs::dom_fetch_json_decode_off_main_thread_threshold();
+      if (NS_IsMainThread() && threshold && aResultLength >= threshold) {
+        autoReleaseObject.release();
+        DecodeJsonBodyOffMainThread(localPromise, aResultLength,
+                                    std::move(resultPtr));
+        return;
+      }
+      [[fallthrough]];
+    }
+    case ConsumeType::Text: {
       nsString decoded;
       if (NS_SUCCEEDED(
               BodyUtil::ConsumeText(aResultLength, resultPtr.get(), decoded))) {
         if (mConsumeType == ConsumeType::Text) {
           localPromise->MaybeResolve(decoded);
         } else {
-          JS::Rooted<JS::Value> json(cx);
           BodyUtil::ConsumeJson(cx, &json, decoded, error);
           if (!error.Failed()) {
             localPromise->MaybeResolve(json);
@@ -739,6 +758,69 @@ void BodyConsumer::ContinueConsumeBody(nsresult aStatus, uint32_t aResultLength,
   }
 }
 
+void BodyConsumer::DecodeJsonBodyOffMainThread(
+    Promise* aPromise, uint32_t aResultLength,
+    UniquePtr<uint8_t[], JS::FreePolicy> aResult) {
+  AssertIsOnMainThread();
+
+  RefPtr<BodyConsumer> self = this;
+  nsMainThreadPtrHandle<Promise> promise(
+      new nsMainThreadPtrHolder<Promise>("BodyConsumer::mConsumePromise",
+                                         aPromise));
+  nsresult rv = NS_DispatchBackgroundTask(
+      NS_NewRunnableFunction(
+          "BodyConsumer::DecodeJsonBodyOffMainThread",
+          [self, promise, aResultLength, result = std::move(aResult)]() {
+            nsString decoded;
+            nsresult rv =
+                BodyUtil::ConsumeText(aResultLength, result.get(), decoded);
+            self->mMainThreadEventTarget->Dispatch(NS_NewRunnableFunction(
+                "BodyConsumer::ContinueConsumeDecodedJsonBody",
+                [self, promise, rv, decoded = std::move(decoded)]() {
+                  self->ContinueConsumeDecodedJsonBody(promise, rv, decoded);
+                }));
+          }),
+      NS_DISPATCH_EVENT_MAY_BLOCK);
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    aPromise->MaybeReject(NS_ERROR_DOM_ABORT_ERR);
+    ReleaseObject();
+  }
+}
+
+void BodyConsumer::ContinueConsumeDecodedJsonBody(Promise* aPromise,
+                                                  nsresult aStatus,
+                                                  const nsString& aDecoded) {
+  AssertIsOnMainThread();
+
+  RefPtr<BodyConsumer> self = this;
+  auto autoReleaseObject =
+      mozilla::MakeScopeExit([self] { self->ReleaseObject(); });
+
+  // The global went away while the body was being decoded.
+  if (!GetOwnerGlobal() || NS_FAILED(aStatus)) {
+    return;
+  }
+
+  AutoJSAPI jsapi;
+  if (!jsapi.Init(mGlobal)) {
+    aPromise->MaybeReject(NS_ERROR_UNEXPECTED);
+    return;
+  }
+
+  JSContext* cx = jsapi.cx();
+  ErrorResult error;
+  JS::Rooted<JS::Value> json(cx);
+  BodyUtil::ConsumeJson(cx, &json, aDecoded, error);
+  if (!error.Failed()) {
+    aPromise->MaybeResolve(json);
+  }
+
+  error.WouldReportJSException();
+  if (error.Failed()) {
+    aPromise->MaybeReject(std::move(error));
+  }
+}
+
 void BodyConsumer::ContinueConsumeBlobBody(BlobImpl* aBlobImpl,
                                            bool aShuttingDown) {
   AssertIsOnTargetThread();
@@ -11,6 +11,7 @@
 #include "mozilla/GlobalFreezeObserver.h"
 #include "mozilla/dom/AbortFollower.h"
 #include "mozilla/dom/MutableBlobStorage.h"
+#include "js/Utility.h"  // JS::FreePolicy
 #include "nsIInputStreamPump.h"
 
 class nsIThread;
@@ -83,6 +84,15 @@ class BodyConsumer final : public AbortFollower,
   void DispatchContinueConsumeBlobBody(BlobImpl* aBlobImpl,
                                        ThreadSafeWorkerRef* aWorkerRef);
 
+  // Large JSON bodies are UTF-8 decoded on a background thread so only
+  // JS_ParseJSON runs on the main thread.
+  void DecodeJsonBodyOffMainThread(
+      Promise* aPromise, uint32_t aResultLength,
+      UniquePtr<uint8_t[], JS::FreePolicy> aResult);
+
+  void ContinueConsumeDecodedJsonBody(Promise* aPromise, nsresult aStatus,
+                                      const nsString& aDecoded);
+
   void ShutDownMainThreadConsuming();
 
   void NullifyConsumeBodyPump() {
@@ -465,6 +465,20 @@ already_AddRefed<FormData> BodyUtil::ConsumeFormData(
   return nullptr;
 }
 
+static void ThrowJsonParseError(JSContext* aCx, ErrorResult& aRv) {
+  if (!JS_IsExceptionPending(aCx)) {
+    aRv.Throw(NS_ERROR_DOM_UNKNOWN_ERR);
+    return;
+  }
+
+  JS::Rooted<JS::Value> exn(aCx);
+  DebugOnly<bool> gotException = JS_GetPendingException(aCx, &exn);
+  MOZ_ASSERT(gotException);
+
+  JS_ClearPendingException(aCx);
+  aRv.ThrowJSException(aCx, exn);
+}
+
 // static
 nsresult BodyUtil::ConsumeText(uint32_t aInputLength, uint8_t* aInput,
                                nsString& aText) {
@@ -483,21 +497,34 @@ void BodyUtil::ConsumeJson(JSContext* aCx, JS::MutableHandle<JS::Value> aValue,
 
   JS::Rooted<JS::Value> json(aCx);
   if (!JS_ParseJSON(aCx, aStr.get(), aStr.Length(), &json)) {
-    if (!JS_IsExceptionPending(aCx)) {
-      aRv.Throw(NS_ERROR_DOM_UNKNOWN_ERR);
-      return;
-    }
+    ThrowJsonParseError(aCx, aRv);
+    return;
+  }
 
-    JS::Rooted<JS::Value> exn(aCx);
-    DebugOnly<bool> gotException = JS_GetPendingException(aCx, &exn);
-    MOZ_ASSERT(gotException);
+  aValue.set(json);
+}
 
-    JS_ClearPendingException(aCx);
-    aRv.ThrowJSException(aCx, exn);
-    return;
+// static
+bool BodyUtil::ConsumeAsciiJson(JSContext* aCx,
+                                JS::MutableHandle<JS::Value> aValue,
+                                uint32_t aInputLength, const uint8_t* aInput,
+                                ErrorResult& aRv) {
+  // A UTF-8 BOM isn't ASCII, so there is nothing to remove here.
+  Span<const uint8_t> input(aInput, aInputLength);
+  if (Encoding::ASCIIValidUpTo(input) != input.Length()) {
+    return false;
+  }
+
+  aRv.MightThrowJSException();
+
+  JS::Rooted<JS::Value> json(aCx);
+  if (!JS_ParseJSON(aCx, aInput, aInputLength, &json)) {
+    ThrowJsonParseError(aCx, aRv);
+    return true;
   }
 
   aValue.set(json);
+  return true;
 }
 
 }  // namespace mozilla::dom
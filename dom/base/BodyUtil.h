@@ -77,6 +77,18 @@ class BodyUtil final {
    */
   static void ConsumeJson(JSContext* aCx, JS::MutableHandle<JS::Value> aValue,
                           const nsString& aStr, ErrorResult& aRv);
+
+  /**
+   * Same as above, for the UTF-8 encoded |aInput| before ConsumeText()
+   * decoded it. Returns false, without parsing, if |aInput| is not all
+   * ASCII; otherwise it is parsed as Latin-1 in place, saving the decoding
+   * and the two-byte copy. The caller may free |aInput| once this method
+   * returns.
+   */
+  static bool ConsumeAsciiJson(JSContext* aCx,
+                               JS::MutableHandle<JS::Value> aValue,
+                               uint32_t aInputLength, const uint8_t* aInput,
+                               ErrorResult& aRv);
 };
 
 }  // namespace dom
@@ -292,10 +292,13 @@ nsresult CharacterData::SetTextInternal(
 
     // If this is marked as "maybe modified frequently", the text should be
     // stored as char16_t since converting char* to char16_t* is expensive.
-    // Use char16_t also when we have bidi characters.
-    bool use2b = HasFlag(NS_MAYBE_MODIFIED_FREQUENTLY) || bidi;
+    // Otherwise let the fragment pick 1-byte storage if the new text allows
+    // it: bidi characters are never 8-bit, so text that still has some is
+    // stored as char16_t anyway, and text that lost all of them isn't bidi
+    // anymore.
+    bool use2b = HasFlag(NS_MAYBE_MODIFIED_FREQUENTLY);
     bool ok = mText.SetTo(to, false, use2b);
-    mText.SetBidi(bidi);
+    mText.SetBidi(bidi && mText.Is2b());
 
     NS_ENSURE_TRUE(ok, NS_ERROR_OUT_OF_MEMORY);
   }
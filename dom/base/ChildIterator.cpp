@@ -59,10 +59,12 @@ Maybe<uint32_t> FlattenedChildIterator::GetIndexOf(
     const nsINode* aParent, const nsINode* aPossibleChild) {
   if (const auto* element = Element::FromNode(aParent)) {
     if (const auto* slot = HTMLSlotElement::FromNode(element)) {
-      const auto& assignedNodes = slot->AssignedNodes();
-      if (!assignedNodes.IsEmpty()) {
-        auto index = assignedNodes.IndexOf(aPossibleChild);
-        return index == assignedNodes.NoIndex ? Nothing() : Some(index);
+      if (!slot->AssignedNodes().IsEmpty()) {
+        if (!aPossibleChild->IsContent() ||
+            aPossibleChild->AsContent()->GetAssignedSlot() != slot) {
+          return Nothing();
+        }
+        return slot->IndexOfAssignedNode(*aPossibleChild);
       }
     } else if (auto* shadowRoot = element->GetShadowRoot()) {
       return shadowRoot->ComputeIndexOf(aPossibleChild);
@@ -112,6 +114,17 @@ bool FlattenedChildIterator::Seek(const nsIContent* aChildToFind) {
     return true;
   }
 
+  if (mParentAsSlot && aChildToFind->GetAssignedSlot() == mParentAsSlot) {
+    // Same for a node assigned to our slot, which knows its index.
+    if (Maybe<uint32_t> index =
+            mParentAsSlot->IndexOfAssignedNode(*aChildToFind)) {
+      mChild = const_cast<nsIContent*>(aChildToFind);
+      mIndexInInserted = *index;
+      mIsFirst = false;
+      return true;
+    }
+  }
+
   // Can we add more fast paths here based on whether the parent of aChildToFind
   // is a This version can take shortcuts that the two-argument version
   // can't, so can be faster (and in fact cshadow insertion point or content
@@ -27,13 +27,9 @@
 namespace mozilla::dom {
 using namespace compression;
 
-class CompressionStreamAlgorithms : public TransformerAlgorithmsWrapper {
+class DeflateCodec final : public Codec {
  public:
-  NS_DECL_ISUPPORTS_INHERITED
-  NS_DECL_CYCLE_COLLECTION_CLASS_INHERITED(CompressionStreamAlgorithms,
-                                           TransformerAlgorithmsBase)
-
-  explicit CompressionStreamAlgorithms(CompressionFormat format) {
+  explicit DeflateCodec(CompressionFormat format) {
     int8_t err = deflateInit2(&mZStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
                               ZLibWindowBits(format), 8 /* default memLevel */,
                               Z_DEFAULT_STRATEGY);
@@ -43,84 +39,22 @@ class CompressionStreamAlgorithms : public TransformerAlgorithmsWrapper {
     MOZ_ASSERT(err == Z_OK);
   }
 
-  // Step 3 of
-  // https://wicg.github.io/compression/#dom-compressionstream-compressionstream
-  // Let transformAlgorithm be an algorithm which takes a chunk argument and
-  // runs the compress and enqueue a chunk algorithm with this and chunk.
-  MOZ_CAN_RUN_SCRIPT
-  void TransformCallbackImpl(JS::Handle<JS::Value> aChunk,
-                             TransformStreamDefaultController& aController,
-                             ErrorResult& aRv) override {
-    AutoJSAPI jsapi;
-    if (!jsapi.Init(aController.GetParentObject())) {
-      aRv.ThrowUnknownError("Internal error");
-      return;
-    }
-    JSContext* cx = jsapi.cx();
-
-    // https://wicg.github.io/compression/#compress-and-enqueue-a-chunk
-
-    // Step 1: If chunk is not a BufferSource type, then throw a TypeError.
-    RootedUnion<OwningBufferSource> bufferSource(cx);
-    if (!bufferSource.Init(cx, aChunk)) {
-      aRv.MightThrowJSException();
-      aRv.StealExceptionFromJSContext(cx);
-      return;
-    }
-
-    // Step 2: Let buffer be the result of compressing chunk with cs's format
-    // and context.
-    // Step 3 - 5: (Done in CompressAndEnqueue)
-    ProcessTypedArraysFixed(
-        bufferSource,
-        [&](const Span<uint8_t>& aData) MOZ_CAN_RUN_SCRIPT_BOUNDARY {
-          CompressAndEnqueue(cx, aData, Flush::No, aController, aRv);
-        });
-  }
-
-  // Step 4 of
-  // https://wicg.github.io/compression/#dom-compressionstream-compressionstream
-  // Let flushAlgorithm be an algorithm which takes no argument and runs the
-  // compress flush and enqueue algorithm with this.
-  MOZ_CAN_RUN_SCRIPT void FlushCallbackImpl(
-      TransformStreamDefaultController& aController,
-      ErrorResult& aRv) override {
-    AutoJSAPI jsapi;
-    if (!jsapi.Init(aController.GetParentObject())) {
-      aRv.ThrowUnknownError("Internal error");
-      return;
-    }
-    JSContext* cx = jsapi.cx();
-
-    // https://wicg.github.io/compression/#compress-flush-and-enqueue
-
-    // Step 1: Let buffer be the result of compressing an empty input with cs's
-    // format and context, with the finish flag.
-    // Step 2 - 4: (Done in CompressAndEnqueue)
-    CompressAndEnqueue(cx, Span<const uint8_t>(), Flush::Yes, aController, aRv);
-  }
-
- private:
-  // Shared by:
-  // https://wicg.github.io/compression/#compress-and-enqueue-a-chunk
-  // https://wicg.github.io/compression/#compress-flush-and-enqueue
-  MOZ_CAN_RUN_SCRIPT void CompressAndEnqueue(
-      JSContext* aCx, Span<const uint8_t> aInput, Flush aFlush,
-      TransformStreamDefaultController& aController, ErrorResult& aRv) {
+  // Step 2 of
+  // https://wicg.github.io/compression/#compress-and-enqueue-a-chunk and
+  // step 1 of https://wicg.github.io/compression/#compress-flush-and-enqueue
+  bool Process(Span<const uint8_t> aInput, Flush aFlush,
+               nsTArray<OutputChunk>& aOutput, nsACString& aError) override {
     MOZ_ASSERT_IF(aFlush == Flush::Yes, !aInput.Length());
 
     mZStream.avail_in = aInput.Length();
     mZStream.next_in = const_cast<uint8_t*>(aInput.Elements());
 
-    JS::RootedVector<JSObject*> array(aCx);
-
     do {
-      static uint16_t kBufferSize = 16384;
       UniquePtr<uint8_t[], JS::FreePolicy> buffer(
-          static_cast<uint8_t*>(JS_malloc(aCx, kBufferSize)));
+          js_pod_malloc<uint8_t>(kBufferSize));
       if (!buffer) {
-        aRv.ThrowTypeError("Out of memory");
-        return;
+        aError.AssignLiteral("Out of memory");
+        return false;
       }
 
       mZStream.avail_out = kBufferSize;
@@ -148,8 +82,8 @@ class CompressionStreamAlgorithms : public TransformerAlgorithmsWrapper {
           // * Z_STREAM_ERROR if the stream state was inconsistent
           // (which is fatal)
           MOZ_ASSERT_UNREACHABLE("Unexpected compression error code");
-          aRv.ThrowTypeError("Unexpected compression error");
-          return;
+          aError.AssignLiteral("Unexpected compression error");
+          return false;
       }
 
       // Stream should end only when flushed, see above
@@ -166,48 +100,23 @@ class CompressionStreamAlgorithms : public TransformerAlgorithmsWrapper {
       }
 
       // Step 3: If buffer is empty, return.
-      // (We'll implicitly return when the array is empty.)
-
-      // Step 4: Split buffer into one or more non-empty pieces and convert them
-      // into Uint8Arrays.
-      // (The buffer is 'split' by having a fixed sized buffer above.)
-
-      JS::Rooted<JSObject*> view(aCx, nsJSUtils::MoveBufferAsUint8Array(
-                                          aCx, written, std::move(buffer)));
-      if (!view || !array.append(view)) {
-        JS_ClearPendingException(aCx);
-        aRv.ThrowTypeError("Out of memory");
-        return;
-      }
+      // (We'll implicitly return when the output is empty.)
+      aOutput.AppendElement(OutputChunk{std::move(buffer), written});
     } while (mZStream.avail_out == 0);
     // From the manual:
     // If deflate returns with avail_out == 0, this function must be called
     // again with the same value of the flush parameter and more output space
     // (updated avail_out)
 
-    // Step 5: For each Uint8Array array, enqueue array in cs's transform.
-    for (const auto& view : array) {
-      JS::Rooted<JS::Value> value(aCx, JS::ObjectValue(*view));
-      aController.Enqueue(aCx, value, aRv);
-      if (aRv.Failed()) {
-        return;
-      }
-    }
+    return true;
   }
 
-  ~CompressionStreamAlgorithms() override { deflateEnd(&mZStream); };
+ private:
+  ~DeflateCodec() override { deflateEnd(&mZStream); };
 
   z_stream mZStream = {};
 };
 
-NS_IMPL_CYCLE_COLLECTION_INHERITED(CompressionStreamAlgorithms,
-                                   TransformerAlgorithmsBase)
-NS_IMPL_ADDREF_INHERITED(CompressionStreamAlgorithms, TransformerAlgorithmsBase)
-NS_IMPL_RELEASE_INHERITED(CompressionStreamAlgorithms,
-                          TransformerAlgorithmsBase)
-NS_INTERFACE_MAP_BEGIN_CYCLE_COLLECTION(CompressionStreamAlgorithms)
-NS_INTERFACE_MAP_END_INHERITING(TransformerAlgorithmsBase)
-
 NS_IMPL_CYCLE_COLLECTION_WRAPPERCACHE(CompressionStream, mGlobal, mStream)
 NS_IMPL_CYCLE_COLLECTING_ADDREF(CompressionStream)
 NS_IMPL_CYCLE_COLLECTING_RELEASE(CompressionStream)
@@ -241,13 +150,14 @@ already_AddRefed<CompressionStream> CompressionStream::Constructor(
   // TypeError.
   // XXX: Skipped as we are using enum for this
 
-  // Step 2 - 4: (Done in CompressionStreamAlgorithms)
+  // Step 2 - 4: (Done in DeflateCodec and CodecAlgorithms)
 
   // Step 5: Set this's transform to a new TransformStream.
 
   // Step 6: Set up this's transform with transformAlgorithm set to
   // transformAlgorithm and flushAlgorithm set to flushAlgorithm.
-  auto algorithms = MakeRefPtr<CompressionStreamAlgorithms>(aFormat);
+  auto algorithms =
+      MakeRefPtr<CodecAlgorithms>(MakeAndAddRef<DeflateCodec>(aFormat));
 
   RefPtr<TransformStream> stream =
       TransformStream::CreateGeneric(aGlobal, *algorithms, aRv);
@@ -0,0 +1,230 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "CompressionStreamHelper.h"
+
+#include "js/GCVector.h"
+#include "mozilla/MozPromise.h"
+#include "mozilla/StaticPrefs_dom.h"
+#include "mozilla/dom/BufferSourceBinding.h"
+#include "mozilla/dom/BufferSourceBindingFwd.h"
+#include "mozilla/dom/Promise.h"
+#include "mozilla/dom/ScriptSettings.h"
+#include "mozilla/dom/TransformStreamDefaultController.h"
+#include "mozilla/dom/UnionTypes.h"
+#include "nsJSUtils.h"
+#include "nsThreadUtils.h"
+
+namespace mozilla::dom::compression {
+
+using ProcessPromise = MozPromise<nsTArray<OutputChunk>, nsCString, true>;
+
+NS_IMPL_CYCLE_COLLECTION_INHERITED(CodecAlgorithms, TransformerAlgorithmsBase)
+NS_IMPL_ADDREF_INHERITED(CodecAlgorithms, TransformerAlgorithmsBase)
+NS_IMPL_RELEASE_INHERITED(CodecAlgorithms, TransformerAlgorithmsBase)
+NS_INTERFACE_MAP_BEGIN_CYCLE_COLLECTION(CodecAlgorithms)
+NS_INTERFACE_MAP_END_INHERITING(TransformerAlgorithmsBase)
+
+// Step 4 and 5 of
+// https://compression.spec.whatwg.org/#compress-and-enqueue-a-chunk and of
+// https://compression.spec.whatwg.org/#decompress-and-enqueue-a-chunk
+MOZ_CAN_RUN_SCRIPT static void EnqueueOutput(
+    JSContext* aCx, nsTArray<OutputChunk>& aOutput,
+    TransformStreamDefaultController& aController, ErrorResult& aRv) {
+  // Step 4: Split buffer into one or more non-empty pieces and convert them
+  // into Uint8Arrays.
+  // (The buffer is 'split' by the codec having fixed sized buffers.)
+  JS::RootedVector<JSObject*> array(aCx);
+  for (OutputChunk& chunk : aOutput) {
+    JS::Rooted<JSObject*> view(
+        aCx, nsJSUtils::MoveBufferAsUint8Array(aCx, chunk.mLength,
+                                               std::move(chunk.mBuffer)));
+    if (!view || !array.append(view)) {
+      JS_ClearPendingException(aCx);
+      aRv.ThrowTypeError("Out of memory");
+      return;
+    }
+  }
+
+  // Step 5: For each Uint8Array array, enqueue array in the transform.
+  for (const auto& view : array) {
+    JS::Rooted<JS::Value> value(aCx, JS::ObjectValue(*view));
+    aController.Enqueue(aCx, value, aRv);
+    if (aRv.Failed()) {
+      return;
+    }
+  }
+}
+
+// Step 3 of
+// https://compression.spec.whatwg.org/#dom-compressionstream-compressionstream
+// and of
+// https://compression.spec.whatwg.org/#dom-decompressionstream-decompressionstream
+// Let transformAlgorithm be an algorithm which takes a chunk argument and
+// runs the (de)compress and enqueue a chunk algorithm with this and chunk.
+void CodecAlgorithms::TransformCallbackImpl(
+    JS::Handle<JS::Value> aChunk, TransformStreamDefaultController& aController,
+    ErrorResult& aRv) {
+  AutoJSAPI jsapi;
+  if (!jsapi.Init(aController.GetParentObject())) {
+    aRv.ThrowUnknownError("Internal error");
+    return;
+  }
+  JSContext* cx = jsapi.cx();
+
+  // Step 1: If chunk is not a BufferSource type, then throw a TypeError.
+  RootedUnion<OwningBufferSource> bufferSource(cx);
+  if (!bufferSource.Init(cx, aChunk)) {
+    aRv.MightThrowJSException();
+    aRv.StealExceptionFromJSContext(cx);
+    return;
+  }
+
+  // Step 2: Let buffer be the result of (de)compressing chunk with the
+  // stream's format and context. If this results in an error, then throw a
+  // TypeError.
+  // Step 3 - 5: (Done in ProcessAndEnqueue)
+  ProcessTypedArraysFixed(
+      bufferSource,
+      [&](const Span<uint8_t>& aData) MOZ_CAN_RUN_SCRIPT_BOUNDARY {
+        ProcessAndEnqueue(cx, aData, Flush::No, aController, aRv);
+      });
+}
+
+already_AddRefed<Promise> CodecAlgorithms::AsyncTransformCallbackImpl(
+    JS::Handle<JS::Value> aChunk, TransformStreamDefaultController& aController,
+    ErrorResult& aRv) {
+  // Workers don't jank the page, and would have to be kept alive until the
+  // output comes back.
+  if (!NS_IsMainThread() ||
+      !StaticPrefs::dom_compression_streams_background_threshold()) {
+    TransformCallbackImpl(aChunk, aController, aRv);
+    return nullptr;
+  }
+
+  AutoJSAPI jsapi;
+  if (!jsapi.Init(aController.GetParentObject())) {
+    aRv.ThrowUnknownError("Internal error");
+    return nullptr;
+  }
+  JSContext* cx = jsapi.cx();
+
+  RootedUnion<OwningBufferSource> bufferSource(cx);
+  if (!bufferSource.Init(cx, aChunk)) {
+    aRv.MightThrowJSException();
+    aRv.StealExceptionFromJSContext(cx);
+    return nullptr;
+  }
+
+  // The chunk can be modified or detached once we return, so a background
+  // task processes a copy.
+  nsTArray<uint8_t> input;
+  ProcessTypedArraysFixed(
+      bufferSource,
+      [&](const Span<uint8_t>& aData) MOZ_CAN_RUN_SCRIPT_BOUNDARY {
+        if (aData.Length() <
+            StaticPrefs::dom_compression_streams_background_threshold()) {
+          ProcessAndEnqueue(cx, aData, Flush::No, aController, aRv);
+          return;
+        }
+        if (!input.AppendElements(aData, fallible)) {
+          aRv.ThrowTypeError("Out of memory");
+        }
+      });
+  if (aRv.Failed() || input.IsEmpty()) {
+    return nullptr;
+  }
+
+  if (!mTaskQueue &&
+      NS_FAILED(NS_CreateBackgroundTaskQueue("CompressionStream",
+                                             getter_AddRefs(mTaskQueue)))) {
+    // We are shutting down.
+    ProcessAndEnqueue(cx, input, Flush::No, aController, aRv);
+    return nullptr;
+  }
+
+  RefPtr<Promise> promise = Promise::Create(aController.GetParentObject(), aRv);
+  if (aRv.Failed()) {
+    return nullptr;
+  }
+
+  InvokeAsync(mTaskQueue, __func__,
+              [codec = mCodec, input = std::move(input)]() {
+                nsTArray<OutputChunk> output;
+                nsAutoCString error;
+                if (!codec->Process(input, Flush::No, output, error)) {
+                  return ProcessPromise::CreateAndReject(error, __func__);
+                }
+                return ProcessPromise::CreateAndResolve(std::move(output),
+                                                        __func__);
+              })
+      ->Then(
+          GetMainThreadSerialEventTarget(), __func__,
+          [promise, controller = RefPtr{&aController}](
+              ProcessPromise::ResolveOrRejectValue&& aValue)
+              MOZ_CAN_RUN_SCRIPT_BOUNDARY {
+                if (aValue.IsReject()) {
+                  promise->MaybeRejectWithTypeError(aValue.RejectValue());
+                  return;
+                }
+
+                AutoJSAPI jsapi;
+                if (!jsapi.Init(promise->GetParentObject())) {
+                  promise->MaybeRejectWithUnknownError("Internal error");
+                  return;
+                }
+
+                ErrorResult rv;
+                EnqueueOutput(jsapi.cx(), aValue.ResolveValue(),
+                              MOZ_KnownLive(*controller), rv);
+                if (rv.Failed()) {
+                  promise->MaybeReject(std::move(rv));
+                  return;
+                }
+                promise->MaybeResolveWithUndefined();
+              });
+  return promise.forget();
+}
+
+// Step 4 of
+// https://compression.spec.whatwg.org/#dom-compressionstream-compressionstream
+// and of
+// https://compression.spec.whatwg.org/#dom-decompressionstream-decompressionstream
+// Let flushAlgorithm be an algorithm which takes no argument and runs the
+// (de)compress flush and enqueue algorithm with this.
+void CodecAlgorithms::FlushCallbackImpl(
+    TransformStreamDefaultController& aController, ErrorResult& aRv) {
+  AutoJSAPI jsapi;
+  if (!jsapi.Init(aController.GetParentObject())) {
+    aRv.ThrowUnknownError("Internal error");
+    return;
+  }
+  JSContext* cx = jsapi.cx();
+
+  // Step 1: Let buffer be the result of (de)compressing an empty input with
+  // the stream's format and context, with the finish flag.
+  // Step 2 - 4: (Done in ProcessAndEnqueue)
+  ProcessAndEnqueue(cx, Span<const uint8_t>(), Flush::Yes, aController, aRv);
+}
+
+// Shared by:
+// https://compression.spec.whatwg.org/#compress-and-enqueue-a-chunk
+// https://compression.spec.whatwg.org/#compress-flush-and-enqueue
+// https://compression.spec.whatwg.org/#decompress-and-enqueue-a-chunk
+// https://compression.spec.whatwg.org/#decompress-flush-and-enqueue
+void CodecAlgorithms::ProcessAndEnqueue(
+    JSContext* aCx, Span<const uint8_t> aInput, Flush aFlush,
+    TransformStreamDefaultController& aController, ErrorResult& aRv) {
+  nsTArray<OutputChunk> output;
+  nsAutoCString error;
+  if (!mCodec->Process(aInput, aFlush, output, error)) {
+    aRv.ThrowTypeError(error);
+    return;
+  }
+  EnqueueOutput(aCx, output, aController, aRv);
+}
+
+}  // namespace mozilla::dom::compression
@@ -8,9 +8,19 @@
 #define DOM_COMPRESSION_STREAM_HELPER_H_
 
 #include "js/TypeDecls.h"
+#include "js/Utility.h"
 #include "zlib.h"
 
+#include "mozilla/Span.h"
+#include "mozilla/UniquePtr.h"
 #include "mozilla/dom/CompressionStreamBinding.h"
+#include "mozilla/dom/TransformerCallbackHelpers.h"
+#include "nsCOMPtr.h"
+#include "nsISupportsImpl.h"
+#include "nsStringFwd.h"
+#include "nsTArray.h"
+
+class nsISerialEventTarget;
 
 namespace mozilla::dom::compression {
 
@@ -59,6 +69,71 @@ inline int8_t ZLibWindowBits(CompressionFormat format) {
   }
 }
 
+// A piece of (de)compressed output, which can be moved into a Uint8Array.
+struct OutputChunk {
+  UniquePtr<uint8_t[], JS::FreePolicy> mBuffer;
+  size_t mLength = 0;
+};
+
+// The (de)compression context of a stream.  It doesn't use JS, so that large
+// chunks can be processed on a background thread while the stream waits for
+// the result: the stream never processes two chunks at the same time.
+class Codec {
+ public:
+  NS_INLINE_DECL_THREADSAFE_REFCOUNTING(Codec)
+
+  static constexpr size_t kBufferSize = 16384;
+
+  // (De)compresses aInput, and appends the output to aOutput.  Returns false,
+  // with the message of the TypeError to throw in aError, if aInput is
+  // invalid or if we run out of memory.
+  virtual bool Process(Span<const uint8_t> aInput, Flush aFlush,
+                       nsTArray<OutputChunk>& aOutput, nsACString& aError) = 0;
+
+ protected:
+  virtual ~Codec() = default;
+};
+
+// The transform and flush algorithms of CompressionStream and
+// DecompressionStream, which run their Codec on the chunks.  On the main
+// thread, chunks of at least dom.compression_streams.background_threshold
+// bytes are copied and processed on a background task queue, and their
+// output is enqueued once it is ready.
+class CodecAlgorithms final : public TransformerAlgorithmsWrapper {
+ public:
+  NS_DECL_ISUPPORTS_INHERITED
+  NS_DECL_CYCLE_COLLECTION_CLASS_INHERITED(CodecAlgorithms,
+                                           TransformerAlgorithmsBase)
+
+  explicit CodecAlgorithms(already_AddRefed<Codec> aCodec)
+      : mCodec(aCodec) {}
+
+  MOZ_CAN_RUN_SCRIPT void TransformCallbackImpl(
+      JS::Handle<JS::Value> aChunk,
+      TransformStreamDefaultController& aController,
+      ErrorResult& aRv) override;
+
+  MOZ_CAN_RUN_SCRIPT already_AddRefed<Promise> AsyncTransformCallbackImpl(
+      JS::Handle<JS::Value> aChunk,
+      TransformStreamDefaultController& aController,
+      ErrorResult& aRv) override;
+
+  MOZ_CAN_RUN_SCRIPT void FlushCallbackImpl(
+      TransformStreamDefaultController& aController,
+      ErrorResult& aRv) override;
+
+ private:
+  ~CodecAlgorithms() override = default;
+
+  MOZ_CAN_RUN_SCRIPT void ProcessAndEnqueue(
+      JSContext* aCx, Span<const uint8_t> aInput, Flush aFlush,
+      TransformStreamDefaultController& aController, ErrorResult& aRv);
+
+  const RefPtr<Codec> mCodec;
+  // Created for the first chunk that is processed in the background.
+  nsCOMPtr<nsISerialEventTarget> mTaskQueue;
+};
+
 }  // namespace mozilla::dom::compression
 
 #endif  // DOM_COMPRESSION_STREAM_HELPER_H_
@@ -25,99 +25,11 @@
 namespace mozilla::dom {
 using namespace compression;
 
-class DecompressionStreamAlgorithms : public TransformerAlgorithmsWrapper {
- public:
-  NS_DECL_ISUPPORTS_INHERITED
-  NS_DECL_CYCLE_COLLECTION_CLASS_INHERITED(DecompressionStreamAlgorithms,
-                                           TransformerAlgorithmsBase)
-
-  // Step 3 of
-  // https://wicg.github.io/compression/#dom-decompressionstream-decompressionstream
-  // Let transformAlgorithm be an algorithm which takes a chunk argument and
-  // runs the compress and enqueue a chunk algorithm with this and chunk.
-  MOZ_CAN_RUN_SCRIPT
-  void TransformCallbackImpl(JS::Handle<JS::Value> aChunk,
-                             TransformStreamDefaultController& aController,
-                             ErrorResult& aRv) override {
-    AutoJSAPI jsapi;
-    if (!jsapi.Init(aController.GetParentObject())) {
-      aRv.ThrowUnknownError("Internal error");
-      return;
-    }
-    JSContext* cx = jsapi.cx();
-
-    // https://compression.spec.whatwg.org/#decompress-and-enqueue-a-chunk
-
-    // Step 1: If chunk is not a BufferSource type, then throw a TypeError.
-    RootedUnion<OwningBufferSource> bufferSource(cx);
-    if (!bufferSource.Init(cx, aChunk)) {
-      aRv.MightThrowJSException();
-      aRv.StealExceptionFromJSContext(cx);
-      return;
-    }
-
-    // Step 2: Let buffer be the result of decompressing chunk with ds's format
-    // and context. If this results in an error, then throw a TypeError.
-    // Step 3 - 5: (Done in DecompressAndEnqueue)
-    ProcessTypedArraysFixed(
-        bufferSource,
-        [&](const Span<uint8_t>& aData) MOZ_CAN_RUN_SCRIPT_BOUNDARY {
-          DecompressAndEnqueue(cx, aData, Flush::No, aController, aRv);
-        });
-  }
-
-  // Step 4 of
-  // https://compression.spec.whatwg.org/#dom-decompressionstream-decompressionstream
-  // Let flushAlgorithm be an algorithm which takes no argument and runs the
-  // compress flush and enqueue algorithm with this.
-  MOZ_CAN_RUN_SCRIPT void FlushCallbackImpl(
-      TransformStreamDefaultController& aController,
-      ErrorResult& aRv) override {
-    AutoJSAPI jsapi;
-    if (!jsapi.Init(aController.GetParentObject())) {
-      aRv.ThrowUnknownError("Internal error");
-      return;
-    }
-    JSContext* cx = jsapi.cx();
-
-    // https://wicg.github.io/compression/#decompress-flush-and-enqueue
-
-    // Step 1: Let buffer be the result of decompressing an empty input with
-    // ds's format and context, with the finish flag.
-    // Step 2 - 4: (Done in DecompressAndEnqueue)
-    DecompressAndEnqueue(cx, Span<const uint8_t>(), Flush::Yes, aController,
-                         aRv);
-  }
-
- protected:
-  static const uint16_t kBufferSize = 16384;
-
-  ~DecompressionStreamAlgorithms() = default;
-
-  MOZ_CAN_RUN_SCRIPT
-  virtual void DecompressAndEnqueue(
-      JSContext* aCx, Span<const uint8_t> aInput, Flush,
-      TransformStreamDefaultController& aController, ErrorResult& aRv) = 0;
-};
-
-NS_IMPL_CYCLE_COLLECTION_INHERITED(DecompressionStreamAlgorithms,
-                                   TransformerAlgorithmsBase)
-NS_IMPL_ADDREF_INHERITED(DecompressionStreamAlgorithms,
-                         TransformerAlgorithmsBase)
-NS_IMPL_RELEASE_INHERITED(DecompressionStreamAlgorithms,
-                          TransformerAlgorithmsBase)
-NS_INTERFACE_MAP_BEGIN_CYCLE_COLLECTION(DecompressionStreamAlgorithms)
-NS_INTERFACE_MAP_END_INHERITING(TransformerAlgorithmsBase)
-
 // See the zlib manual in https://www.zlib.net/manual.html or in
 // https://searchfox.org/mozilla-central/source/modules/zlib/src/zlib.h
-class ZLibDecompressionStreamAlgorithms : public DecompressionStreamAlgorithms {
+class ZLibDecompressionCodec final : public Codec {
  public:
-  NS_DECL_ISUPPORTS_INHERITED
-  NS_DECL_CYCLE_COLLECTION_CLASS_INHERITED(ZLibDecompressionStreamAlgorithms,
-                                           DecompressionStreamAlgorithms)
-
-  explicit ZLibDecompressionStreamAlgorithms(CompressionFormat format) {
+  explicit ZLibDecompressionCodec(CompressionFormat format) {
     int8_t err = inflateInit2(&mZStream, ZLibWindowBits(format));
     if (err == Z_MEM_ERROR) {
       MOZ_CRASH("Out of memory");
@@ -125,29 +37,24 @@ class ZLibDecompressionStreamAlgorithms : public DecompressionStreamAlgorithms {
     MOZ_ASSERT(err == Z_OK);
   }
 
- private:
   // Shared by:
   // https://wicg.github.io/compression/#decompress-and-enqueue-a-chunk
   // https://wicg.github.io/compression/#decompress-flush-and-enqueue
   // All data errors throw TypeError by step 2: If this results in an error,
   // then throw a TypeError.
-  MOZ_CAN_RUN_SCRIPT void DecompressAndEnqueue(
-      JSContext* aCx, Span<const uint8_t> aInput, Flush aFlush,
-      TransformStreamDefaultController& aController,
-      ErrorResult& aRv) override {
+  bool Process(Span<const uint8_t> aInput, Flush aFlush,
+               nsTArray<OutputChunk>& aOutput, nsACString& aError) override {
     MOZ_ASSERT_IF(aFlush == Flush::Yes, !aInput.Length());
 
     mZStream.avail_in = aInput.Length();
     mZStream.next_in = const_cast<uint8_t*>(aInput.Elements());
 
-    JS::RootedVector<JSObject*> array(aCx);
-
     do {
       UniquePtr<uint8_t[], JS::FreePolicy> buffer(
-          static_cast<uint8_t*>(JS_malloc(aCx, kBufferSize)));
+          js_pod_malloc<uint8_t>(kBufferSize));
       if (!buffer) {
-        aRv.ThrowTypeError("Out of memory");
-        return;
+        aError.AssignLiteral("Out of memory");
+        return false;
       }
 
       mZStream.avail_out = kBufferSize;
@@ -161,13 +68,13 @@ class ZLibDecompressionStreamAlgorithms : public DecompressionStreamAlgorithms {
           // Z_DATA_ERROR if the input data was corrupted (input stream not
           // conforming to the zlib format or incorrect check value, in which
           // case strm->msg points to a string with a more specific error)
-          aRv.ThrowTypeError("The input data is corrupted: "_ns +
-                             nsDependentCString(mZStream.msg));
-          return;
+          aError.AssignLiteral("The input data is corrupted: ");
+          aError.Append(mZStream.msg);
+          return false;
         case Z_MEM_ERROR:
           // Z_MEM_ERROR if there was not enough memory
-          aRv.ThrowTypeError("Out of memory");
-          return;
+          aError.AssignLiteral("Out of memory");
+          return false;
         case Z_NEED_DICT:
           // Z_NEED_DICT if a preset dictionary is needed at this point
           //
@@ -177,10 +84,10 @@ class ZLibDecompressionStreamAlgorithms : public DecompressionStreamAlgorithms {
           // stream if set.
           // And FDICT means preset dictionary per
           // https://datatracker.ietf.org/doc/html/rfc1950#page-5.
-          aRv.ThrowTypeError(
+          aError.AssignLiteral(
               "The stream needs a preset dictionary but such setup is "
               "unsupported");
-          return;
+          return false;
         case Z_STREAM_END:
           // Z_STREAM_END if the end of the compressed data has been reached and
           // all uncompressed output has been produced
@@ -191,8 +98,8 @@ class ZLibDecompressionStreamAlgorithms : public DecompressionStreamAlgorithms {
           // Note that additional calls for inflate() immediately emits
           // Z_STREAM_END after this point.
           if (mZStream.avail_in > 0) {
-            aRv.ThrowTypeError("Unexpected input after the end of stream");
-            return;
+            aError.AssignLiteral("Unexpected input after the end of stream");
+            return false;
           }
           mObservedStreamEnd = true;
           break;
@@ -211,8 +118,8 @@ class ZLibDecompressionStreamAlgorithms : public DecompressionStreamAlgorithms {
           // * Z_STREAM_ERROR if the stream state was inconsistent
           // (which is fatal)
           MOZ_ASSERT_UNREACHABLE("Unexpected decompression error code");
-          aRv.ThrowTypeError("Unexpected decompression error");
-          return;
+          aError.AssignLiteral("Unexpected decompression error");
+          return false;
       }
 
       // At this point we either exhausted the input or the output buffer
@@ -224,19 +131,8 @@ class ZLibDecompressionStreamAlgorithms : public DecompressionStreamAlgorithms {
       }
 
       // Step 3: If buffer is empty, return.
-      // (We'll implicitly return when the array is empty.)
-
-      // Step 4: Split buffer into one or more non-empty pieces and convert them
-      // into Uint8Arrays.
-      // (The buffer is 'split' by having a fixed sized buffer above.)
-
-      JS::Rooted<JSObject*> view(aCx, nsJSUtils::MoveBufferAsUint8Array(
-                                          aCx, written, std::move(buffer)));
-      if (!view || !array.append(view)) {
-        JS_ClearPendingException(aCx);
-        aRv.ThrowTypeError("Out of memory");
-        return;
-      }
+      // (We'll implicitly return when the output is empty.)
+      aOutput.AppendElement(OutputChunk{std::move(buffer), written});
     } while (mZStream.avail_out == 0 && !mObservedStreamEnd);
     // From the manual:
     // * It must update next_out and avail_out when avail_out has dropped to
@@ -249,44 +145,28 @@ class ZLibDecompressionStreamAlgorithms : public DecompressionStreamAlgorithms {
       // https://wicg.github.io/compression/#decompress-flush-and-enqueue
       // If the end of the compressed input has not been reached, then throw a
       // TypeError.
-      aRv.ThrowTypeError("The input is ended without reaching the stream end");
-      return;
+      aError.AssignLiteral(
+          "The input is ended without reaching the stream end");
+      return false;
     }
 
-    // Step 5: For each Uint8Array array, enqueue array in ds's transform.
-    for (const auto& view : array) {
-      JS::Rooted<JS::Value> value(aCx, JS::ObjectValue(*view));
-      aController.Enqueue(aCx, value, aRv);
-      if (aRv.Failed()) {
-        return;
-      }
-    }
+    return true;
   }
 
-  ~ZLibDecompressionStreamAlgorithms() override { inflateEnd(&mZStream); }
+
+ private:
+  ~ZLibDecompressionCodec() override { inflateEnd(&mZStream); }
 
   z_stream mZStream = {};
   bool mObservedStreamEnd = false;
 };
 
-NS_IMPL_CYCLE_COLLECTION_INHERITED(ZLibDecompressionStreamAlgorithms,
-                                   DecompressionStreamAlgorithms)
-NS_IMPL_ADDREF_INHERITED(ZLibDecompressionStreamAlgorithms,
-                         DecompressionStreamAlgorithms)
-NS_IMPL_RELEASE_INHERITED(ZLibDecompressionStreamAlgorithms,
-                          DecompressionStreamAlgorithms)
-NS_INTERFACE_MAP_BEGIN_CYCLE_COLLECTION(ZLibDecompressionStreamAlgorithms)
-NS_INTERFACE_MAP_END_INHERITING(DecompressionStreamAlgorithms)
-
 // See the zstd manual in https://facebook.github.io/zstd/zstd_manual.html or in
 // https://searchfox.org/mozilla-central/source/third_party/zstd/lib/zstd.h
-class ZstdDecompressionStreamAlgorithms : public DecompressionStreamAlgorithms {
+class ZstdDecompressionCodec final : public Codec {
  public:
-  NS_DECL_ISUPPORTS_INHERITED
-  NS_DECL_CYCLE_COLLECTION_CLASS_INHERITED(ZstdDecompressionStreamAlgorithms,
-                                           DecompressionStreamAlgorithms)
 
-  ZstdDecompressionStreamAlgorithms() {
+  ZstdDecompressionCodec() {
     mDStream = ZSTD_createDStream();
     if (!mDStream) {
       NS_ABORT_OOM(0);
@@ -298,21 +178,18 @@ class ZstdDecompressionStreamAlgorithms : public DecompressionStreamAlgorithms {
     ZSTD_DCtx_setParameter(mDStream, ZSTD_d_windowLogMax, WINDOW_LOG_MAX);
   }
 
- private:
   // Shared by:
   // https://wicg.github.io/compression/#decompress-and-enqueue-a-chunk
   // https://wicg.github.io/compression/#decompress-flush-and-enqueue
   // All data errors throw TypeError by step 2: If this results in an error,
   // then throw a TypeError.
-  MOZ_CAN_RUN_SCRIPT void DecompressAndEnqueue(
-      JSContext* aCx, Span<const uint8_t> aInput, Flush aFlush,
-      TransformStreamDefaultController& aController,
-      ErrorResult& aRv) override {
+  bool Process(Span<const uint8_t> aInput, Flush aFlush,
+               nsTArray<OutputChunk>& aOutput, nsACString& aError) override {
     MOZ_ASSERT_IF(aFlush == Flush::Yes, !aInput.Length());
 
     if (mObservedStreamEnd && aInput.Length() > 0) {
-      aRv.ThrowTypeError("Unexpected input after the end of stream");
-      return;
+      aError.AssignLiteral("Unexpected input after the end of stream");
+      return false;
     }
 
     ZSTD_inBuffer inBuffer = {
@@ -320,14 +197,12 @@ class ZstdDecompressionStreamAlgorithms : public DecompressionStreamAlgorithms {
         /* size */ aInput.Length(),
         /* pos  */ 0};
 
-    JS::RootedVector<JSObject*> array(aCx);
-
     while (inBuffer.pos < inBuffer.size) {
       UniquePtr<uint8_t[], JS::FreePolicy> buffer(
-          static_cast<uint8_t*>(JS_malloc(aCx, kBufferSize)));
+          js_pod_malloc<uint8_t>(kBufferSize));
       if (!buffer) {
-        aRv.ThrowTypeError("Out of memory");
-        return;
+        aError.AssignLiteral("Out of memory");
+        return false;
       }
 
       ZSTD_outBuffer outBuffer = {/* dst  */ buffer.get(),
@@ -336,35 +211,24 @@ class ZstdDecompressionStreamAlgorithms : public DecompressionStreamAlgorithms {
 
       size_t rv = ZSTD_decompressStream(mDStream, &outBuffer, &inBuffer);
       if (ZSTD_isError(rv)) {
-        aRv.ThrowTypeError("zstd decompression error: "_ns +
-                           nsDependentCString(ZSTD_getErrorName(rv)));
-        return;
+        aError.AssignLiteral("zstd decompression error: ");
+        aError.Append(ZSTD_getErrorName(rv));
+        return false;
       }
 
       if (rv == 0) {
         mObservedStreamEnd = true;
         if (inBuffer.pos < inBuffer.size) {
-          aRv.ThrowTypeError("Unexpected input after the end of stream");
-          return;
+          aError.AssignLiteral("Unexpected input after the end of stream");
+          return false;
         }
       }
 
       // Step 3: If buffer is empty, return.
-      // (We'll implicitly return when the array is empty.)
-
-      // Step 4: Split buffer into one or more non-empty pieces and convert them
-      // into Uint8Arrays.
-      // (The buffer is 'split' by having a fixed sized buffer above.)
-
+      // (We'll implicitly return when the output is empty.)
       size_t written = outBuffer.pos;
       if (written > 0) {
-        JS::Rooted<JSObject*> view(aCx, nsJSUtils::MoveBufferAsUint8Array(
-                                            aCx, written, std::move(buffer)));
-        if (!view || !array.append(view)) {
-          JS_ClearPendingException(aCx);
-          aRv.ThrowTypeError("Out of memory");
-          return;
-        }
+        aOutput.AppendElement(OutputChunk{std::move(buffer), written});
       }
     }
 
@@ -373,21 +237,17 @@ class ZstdDecompressionStreamAlgorithms : public DecompressionStreamAlgorithms {
       // https://wicg.github.io/compression/#decompress-flush-and-enqueue
       // If the end of the compressed input has not been reached, then throw a
       // TypeError.
-      aRv.ThrowTypeError("The input is ended without reaching the stream end");
-      return;
+      aError.AssignLiteral(
+          "The input is ended without reaching the stream end");
+      return false;
     }
 
-    // Step 5: For each Uint8Array array, enqueue array in ds's transform.
-    for (const auto& view : array) {
-      JS::Rooted<JS::Value> value(aCx, JS::ObjectValue(*view));
-      aController.Enqueue(aCx, value, aRv);
-      if (aRv.Failed()) {
-        return;
-      }
-    }
+    return true;
   }
 
-  ~ZstdDecompressionStreamAlgorithms() override {
+
+ private:
+  ~ZstdDecompressionCodec() override {
     if (mDStream) {
       ZSTD_freeDStream(mDStream);
       mDStream = nullptr;
@@ -398,30 +258,16 @@ class ZstdDecompressionStreamAlgorithms : public DecompressionStreamAlgorithms {
   bool mObservedStreamEnd = false;
 };
 
-NS_IMPL_CYCLE_COLLECTION_INHERITED(ZstdDecompressionStreamAlgorithms,
-                                   DecompressionStreamAlgorithms)
-NS_IMPL_ADDREF_INHERITED(ZstdDecompressionStreamAlgorithms,
-                         DecompressionStreamAlgorithms)
-NS_IMPL_RELEASE_INHERITED(ZstdDecompressionStreamAlgorithms,
-                          DecompressionStreamAlgorithms)
-NS_INTERFACE_MAP_BEGIN_CYCLE_COLLECTION(ZstdDecompressionStreamAlgorithms)
-NS_INTERFACE_MAP_END_INHERITING(DecompressionStreamAlgorithms)
-
 /*
- * Constructs either a ZLibDecompressionStreamAlgorithms or a
- * ZstdDecompressionStreamAlgorithms, based on the CompressionFormat.
+ * Constructs either a ZLibDecompressionCodec or a ZstdDecompressionCodec,
+ * based on the CompressionFormat.
  */
-static already_AddRefed<DecompressionStreamAlgorithms>
-CreateDecompressionStreamAlgorithms(CompressionFormat aFormat) {
+static already_AddRefed<Codec> CreateDecompressionCodec(
+    CompressionFormat aFormat) {
   if (aFormat == CompressionFormat::Zstd) {
-    RefPtr<DecompressionStreamAlgorithms> zstdAlgos =
-        new ZstdDecompressionStreamAlgorithms();
-    return zstdAlgos.forget();
+    return MakeAndAddRef<ZstdDecompressionCodec>();
   }
-
-  RefPtr<DecompressionStreamAlgorithms> zlibAlgos =
-      new ZLibDecompressionStreamAlgorithms(aFormat);
-  return zlibAlgos.forget();
+  return MakeAndAddRef<ZLibDecompressionCodec>(aFormat);
 }
 
 NS_IMPL_CYCLE_COLLECTION_WRAPPERCACHE(DecompressionStream, mGlobal, mStream)
@@ -459,14 +305,14 @@ already_AddRefed<DecompressionStream> DecompressionStream::Constructor(
   // TypeError.
   // XXX: Skipped as we are using enum for this
 
-  // Step 2 - 4: (Done in {ZLib|Zstd}DecompressionStreamAlgorithms)
+  // Step 2 - 4: (Done in {ZLib|Zstd}DecompressionCodec and CodecAlgorithms)
 
   // Step 5: Set this's transform to a new TransformStream.
 
   // Step 6: Set up this's transform with transformAlgorithm set to
   // transformAlgorithm and flushAlgorithm set to flushAlgorithm.
-  RefPtr<DecompressionStreamAlgorithms> algorithms =
-      CreateDecompressionStreamAlgorithms(aFormat);
+  auto algorithms =
+      MakeRefPtr<CodecAlgorithms>(CreateDecompressionCodec(aFormat));
 
   RefPtr<TransformStream> stream =
       TransformStream::CreateGeneric(aGlobal, *algorithms, aRv);
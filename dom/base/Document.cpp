@@ -2684,6 +2684,7 @@ NS_IMPL_CYCLE_COLLECTION_TRAVERSE_BEGIN_INTERNAL(Document)
   NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mScripts);
   NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mApplets);
   NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mAnchors);
+  NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mQuerySelectorAllLists);
   NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mAnonymousContents)
   NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mCommandDispatcher)
   NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mFeaturePolicy)
@@ -2819,6 +2820,7 @@ NS_IMPL_CYCLE_COLLECTION_UNLINK_BEGIN(Document)
   NS_IMPL_CYCLE_COLLECTION_UNLINK(mScripts);
   NS_IMPL_CYCLE_COLLECTION_UNLINK(mApplets);
   NS_IMPL_CYCLE_COLLECTION_UNLINK(mAnchors);
+  NS_IMPL_CYCLE_COLLECTION_UNLINK(mQuerySelectorAllLists);
   NS_IMPL_CYCLE_COLLECTION_UNLINK(mAnonymousContents)
   NS_IMPL_CYCLE_COLLECTION_UNLINK(mCommandDispatcher)
   NS_IMPL_CYCLE_COLLECTION_UNLINK(mFeaturePolicy)
@@ -7499,6 +7501,16 @@ bool Document::ShouldThrottleFrameRequests() const {
   return !output.Intersects();
 }
 
+bool Document::ShouldReduceFrameRequestRate() const {
+  if (mStaticCloneCount > 0) {
+    return false;
+  }
+  // Top-level documents, and frames the user interacted with (e.g. games),
+  // run at the display's rate.
+  WindowContext* wc = GetWindowContext();
+  return wc && !wc->IsTop() && !wc->HasBeenUserGestureActivated();
+}
+
 void Document::DeletePresShell() {
   mExternalResourceMap.HideViewers();
   mPendingFullscreenEvents.Clear();
@@ -11453,6 +11465,7 @@ void Document::FlushPendingNotifications(mozilla::ChangesToFlush aFlush) {
   if (StyleOrLayoutObservablyDependsOnParentDocumentLayout() &&
       mParentDocument->MayStartLayout() && IsSafeToFlush()) {
     ChangesToFlush parentFlush = aFlush;
+    parentFlush.mLayoutTarget = nullptr;
     if (flushType >= FlushType::Style) {
       // Since media queries mean that a size change of our container can affect
       // style, we need to promote a style flush on ourself to a layout flush on
@@ -19725,6 +19738,22 @@ void Document::SetCachedSizes(nsTabSizes* aSizes) {
   mCachedTabSizeGeneration = GetGeneration();
 }
 
+void Document::KeepQuerySelectorAllList(nsContentList* aList) {
+  // Lists that nobody asks about go dirty after a while, and stop doing work
+  // on mutations, so keeping a few of them is cheap.
+  static constexpr size_t kMaxLists = 8;
+  const auto index = mQuerySelectorAllLists.IndexOf(aList);
+  if (index == 0) {
+    return;
+  }
+  if (index != mQuerySelectorAllLists.NoIndex) {
+    mQuerySelectorAllLists.RemoveElementAt(index);
+  } else if (mQuerySelectorAllLists.Length() == kMaxLists) {
+    mQuerySelectorAllLists.RemoveLastElement();
+  }
+  mQuerySelectorAllLists.InsertElementAt(0, aList);
+}
+
 nsAtom* Document::GetContentLanguageAsAtomForStyle() const {
   // Content-Language may be a comma-separated list of language codes,
   // in which case the HTML5 spec says to treat it as unknown
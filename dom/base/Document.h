@@ -1425,6 +1425,10 @@ class Document : public nsINode,
   // Returns the current generation.
   inline int32_t GetGeneration() const { return mGeneration; }
 
+  // Keeps the live list that querySelectorAll copied its result from around
+  // for the next few queries, so that they find it up to date.
+  void KeepQuerySelectorAllList(nsContentList* aList);
+
   // Adds cached sizes values to aSizes if there's any
   // cached value and if the document generation hasn't
   // changed since the cache was created.
@@ -3161,6 +3165,13 @@ class Document : public nsINode,
    */
   bool ShouldThrottleFrameRequests() const;
 
+  /**
+   * @return true if this document's frame request callbacks may run at the
+   * default frame rate rather than at the display's rate. This is the case
+   * for subframes the user hasn't interacted with.
+   */
+  bool ShouldReduceFrameRequestRate() const;
+
   // This returns true when the document tree is being teared down.
   bool InUnlinkOrDeletion() { return mInUnlinkOrDeletion; }
 
@@ -4737,6 +4748,10 @@ class Document : public nsINode,
   nsCOMPtr<nsIHTMLCollection> mApplets;
   RefPtr<nsContentList> mAnchors;
 
+  // The lists of the last few querySelectorAll calls, most recent first.
+  // See KeepQuerySelectorAllList.
+  nsTArray<RefPtr<nsContentList>> mQuerySelectorAllLists;
+
   // container for per-context fonts (downloadable, SVG, etc.)
   RefPtr<FontFaceSet> mFontFaceSet;
 
@@ -65,6 +65,7 @@
 #include "mozilla/StaticAnalysisFunctions.h"
 #include "mozilla/StaticPrefs_dom.h"
 #include "mozilla/StaticPrefs_full_screen_api.h"
+#include "mozilla/StaticPrefs_layout.h"
 #include "mozilla/StaticString.h"
 #include "mozilla/TextControlElement.h"
 #include "mozilla/TextEditor.h"
@@ -270,7 +271,13 @@ nsIFrame* nsIContent::GetPrimaryFrame(mozilla::FlushType aType) {
   }
 
   // Cause a flush, so we get up-to-date frame information.
-  if (aType != mozilla::FlushType::None) {
+  if (aType == mozilla::FlushType::Layout &&
+      mozilla::StaticPrefs::layout_flush_selective_enabled()) {
+    mozilla::ChangesToFlush flush(aType, /* aFlushAnimations = */ true,
+                                  /* aUpdateRelevancy = */ true);
+    flush.mLayoutTarget = this;
+    doc->FlushPendingNotifications(flush);
+  } else if (aType != mozilla::FlushType::None) {
     doc->FlushPendingNotifications(aType);
   }
 
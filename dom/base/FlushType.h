@@ -11,6 +11,8 @@
 #include "X11UndefineNone.h"
 #include "mozilla/EnumeratedArray.h"
 
+class nsIContent;
+
 namespace mozilla {
 
 /**
@@ -69,6 +71,10 @@ struct ChangesToFlush {
   FlushType mFlushType;
   bool mFlushAnimations;
   bool mUpdateRelevancy;
+  // If set, a layout flush only needs the geometry of this content to be up
+  // to date, and may leave the dirty roots that can't affect it for later.
+  // Only applies to the document of the content, not to its ancestors.
+  nsIContent* mLayoutTarget = nullptr;
 };
 
 }  // namespace mozilla
@@ -172,6 +172,11 @@ void MutationObservers::NotifyContentInserted(nsINode* aContainer,
   MOZ_ASSERT(aContainer->IsContent() || aContainer->IsDocument(),
              "container must be an nsIContent or an Document");
   aContainer->OwnerDoc()->Changed();
+  if (AutoContentRangeInsertion::MaybeAddChild(aContainer, aChild)) {
+    Notify<NotifyPresShell::No>(aContainer, NOTIFIER(ContentInserted, aChild),
+                                nsIMutationObserver::kContentInserted);
+    return;
+  }
   Notify(aContainer, NOTIFIER(ContentInserted, aChild),
          nsIMutationObserver::kContentInserted);
 }
@@ -247,3 +252,64 @@ void MutationObservers::NotifyAnimationChanged(dom::Animation* aAnimation) {
 void MutationObservers::NotifyAnimationRemoved(dom::Animation* aAnimation) {
   NotifyAnimationMutated(aAnimation, AnimationMutationType::Removed);
 }
+
+AutoContentRangeInsertion* AutoContentRangeInsertion::sCurrent = nullptr;
+
+AutoContentRangeInsertion::AutoContentRangeInsertion(nsINode* aContainer)
+    : mPrevious(sCurrent), mContainer(aContainer) {
+  MOZ_ASSERT(aContainer->IsContent(),
+             "The frame constructor wants a single ContentInserted "
+             "notification for each child of a document");
+  if (mPrevious) {
+    // Keep the pres shell's view of the tree in order.
+    mPrevious->NotifyPresShell();
+  }
+  sCurrent = this;
+}
+
+AutoContentRangeInsertion::~AutoContentRangeInsertion() {
+  MOZ_ASSERT(sCurrent == this);
+  NotifyPresShell();
+  sCurrent = mPrevious;
+}
+
+/* static */
+bool AutoContentRangeInsertion::MaybeAddChild(nsINode* aContainer,
+                                              nsIContent* aChild) {
+  AutoContentRangeInsertion* insertion = sCurrent;
+  if (!insertion) {
+    return false;
+  }
+  if (aContainer == insertion->mContainer &&
+      (!insertion->mLastChild ||
+       aChild->GetPreviousSibling() == insertion->mLastChild)) {
+    if (!insertion->mStartChild) {
+      insertion->mStartChild = aChild;
+    }
+    insertion->mLastChild = aChild;
+    return true;
+  }
+  // Something else got inserted while the run was being built, which the
+  // pres shell must only hear about after the run.
+  insertion->NotifyPresShell();
+  return false;
+}
+
+void AutoContentRangeInsertion::NotifyPresShell() {
+  if (!mStartChild) {
+    return;
+  }
+  nsCOMPtr<nsIContent> startChild = std::move(mStartChild);
+  nsCOMPtr<nsIContent> lastChild = std::move(mLastChild);
+  if (!mContainer->IsInComposedDoc()) {
+    return;
+  }
+  MOZ_ASSERT(startChild->GetParentNode() == mContainer &&
+                 lastChild->GetParentNode() == mContainer,
+             "The run shouldn't change before the pres shell is notified");
+  Document* doc = mContainer->OwnerDoc();
+  nsDOMMutationEnterLeave enterLeave(doc);
+  if (PresShell* presShell = doc->GetObservingPresShell()) {
+    presShell->ContentRangeInserted(startChild, lastChild->GetNextSibling());
+  }
+}
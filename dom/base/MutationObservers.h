@@ -8,6 +8,7 @@
 #define DOM_BASE_MUTATIONOBSERVERS_H_
 
 #include "mozilla/DoublyLinkedList.h"
+#include "nsCOMPtr.h"
 #include "nsIContent.h"  // for use in inline function (NotifyParentChainChanged)
 #include "nsIMutationObserver.h"  // for use in inline function (NotifyParentChainChanged)
 #include "nsINode.h"
@@ -148,6 +149,39 @@ class MutationObservers {
   static void NotifyAnimationMutated(mozilla::dom::Animation* aAnimation,
                                      AnimationMutationType aMutatedType);
 };
+
+/**
+ * While an AutoContentRangeInsertion for aContainer is alive, the pres shell
+ * isn't notified of each child that is inserted into aContainer, but of the
+ * whole run of them at once when the AutoContentRangeInsertion goes away, so
+ * that it restyles the later siblings of the run once rather than once per
+ * child.  The other mutation observers still get a ContentInserted
+ * notification right after each insertion.
+ *
+ * Used when a DocumentFragment is inserted in the middle of a child list;
+ * appending one already notifies the whole run through ContentAppended.
+ */
+class MOZ_RAII AutoContentRangeInsertion final {
+ public:
+  explicit AutoContentRangeInsertion(nsINode* aContainer);
+  ~AutoContentRangeInsertion();
+
+ private:
+  friend class MutationObservers;
+
+  // Returns whether aChild was added to the run, and the pres shell should
+  // not be notified of it now.
+  static bool MaybeAddChild(nsINode* aContainer, nsIContent* aChild);
+
+  void NotifyPresShell();
+
+  static AutoContentRangeInsertion* sCurrent;
+
+  AutoContentRangeInsertion* const mPrevious;
+  const nsCOMPtr<nsINode> mContainer;
+  nsCOMPtr<nsIContent> mStartChild;
+  nsCOMPtr<nsIContent> mLastChild;
+};
 }  // namespace mozilla::dom
 
 #endif  // DOM_BASE_MUTATIONOBSERVERS_H_
@@ -808,7 +808,7 @@ void nsContentList::ContentInserted(nsIContent* aChild) {
       MayContainRelevantNodes(aChild->GetParentNode()) &&
       nsContentUtils::IsInSameAnonymousTree(mRootNode, aChild) &&
       MatchSelf(aChild)) {
-    SetDirty();
+    InsertMatchingSubtree(aChild);
   }
 
   ASSERT_IN_SYNC;
@@ -820,12 +820,106 @@ void nsContentList::ContentWillBeRemoved(nsIContent* aChild,
       MayContainRelevantNodes(aChild->GetParentNode()) &&
       nsContentUtils::IsInSameAnonymousTree(mRootNode, aChild) &&
       MatchSelf(aChild)) {
-    SetDirty();
+    RemoveMatchingSubtree(aChild);
   }
 
   ASSERT_IN_SYNC;
 }
 
+uint32_t nsContentList::CountElementsBefore(nsIContent* aContent) {
+  // Our elements are in tree order, and the check is cheap for the common
+  // case of a node after all of them.
+  uint32_t low = 0;
+  uint32_t high = mElements.Length();
+  if (!high ||
+      nsContentUtils::PositionIsBefore(mElements.LastElement(), aContent)) {
+    return high;
+  }
+  while (low < high) {
+    uint32_t mid = low + (high - low) / 2;
+    if (nsContentUtils::PositionIsBefore(mElements[mid], aContent)) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+void nsContentList::InsertMatchingSubtree(nsIContent* aContent) {
+  // Stop tracking mutations if nobody looks at us anymore.
+  MaybeMarkDirty();
+  if (mState == State::Dirty) {
+    return;
+  }
+
+  const uint32_t index = CountElementsBefore(aContent);
+  if (index == mElements.Length() && mState == State::Lazy) {
+    // We'll get to aContent if we ever populate ourselves further.
+    return;
+  }
+
+  AutoTArray<nsCOMPtr<nsIContent>, 8> newElements;
+  for (nsIContent* cur = aContent; cur;
+       cur = mDeep ? cur->GetNextNode(aContent) : nullptr) {
+    if (cur->IsElement() && Match(cur->AsElement())) {
+      newElements.AppendElement(cur);
+    }
+  }
+
+  for (const nsCOMPtr<nsIContent>& content : newElements) {
+    if (index == mElements.Length()) {
+      InvalidateNamedItemsCacheForInsertion(*content->AsElement());
+    } else if (content->HasName() || content->HasID()) {
+      // The cache holds the first element with each name, which this may
+      // now be.
+      InvalidateNamedItemsCache();
+    }
+  }
+  mElements.InsertElementsAt(index, newElements);
+}
+
+void nsContentList::RemoveMatchingSubtree(nsIContent* aContent) {
+  MaybeMarkDirty();
+  if (mState == State::Dirty) {
+    return;
+  }
+
+  // The matching elements of the subtree are next to each other in our list.
+  nsIContent* first = nullptr;
+  uint32_t count = 0;
+  for (nsIContent* cur = aContent; cur;
+       cur = mDeep ? cur->GetNextNode(aContent) : nullptr) {
+    if (cur->IsElement() && Match(cur->AsElement())) {
+      if (!first) {
+        first = cur;
+      }
+      count++;
+    }
+  }
+  MOZ_ASSERT(first, "MatchSelf should have found something");
+
+  const uint32_t index = CountElementsBefore(first);
+  if (index == mElements.Length()) {
+    // We haven't got to the subtree yet.
+    MOZ_ASSERT(mState == State::Lazy, "Missing elements in up-to-date list");
+    return;
+  }
+  if (NS_WARN_IF(mElements[index] != first)) {
+    SetDirty();
+    return;
+  }
+
+  // A lazy list only holds the part of the subtree it has looked at.  If
+  // that includes our last element, we'll look at the nodes between the new
+  // last element and the subtree again, which didn't match anyway.
+  count = std::min(count, uint32_t(mElements.Length() - index));
+  for (uint32_t i = index; i < index + count; ++i) {
+    InvalidateNamedItemsCacheForDeletion(*mElements[i]->AsElement());
+  }
+  mElements.RemoveElementsAt(index, count);
+}
+
 bool nsContentList::Match(Element* aElement) {
   if (mFunc) {
     return (*mFunc)(aElement, mMatchNameSpaceId, mXMLMatchAtom, mData);
@@ -388,6 +388,21 @@ class nsContentList : public nsBaseContentList,
    */
   bool MatchSelf(nsIContent* aContent);
 
+  /**
+   * Returns how many elements of our list come before aContent in tree
+   * order.
+   */
+  uint32_t CountElementsBefore(nsIContent* aContent);
+
+  /**
+   * Add the matching elements of the subtree rooted at aContent, which was
+   * just inserted, to our list, or remove them from it because aContent is
+   * about to be removed, rather than walking the whole tree again next time
+   * the list is used.
+   */
+  void InsertMatchingSubtree(nsIContent* aContent);
+  void RemoveMatchingSubtree(nsIContent* aContent);
+
   /**
    * Populate our list.  Stop once we have at least aNeededLength
    * elements.  At the end of PopulateSelf running, either the last
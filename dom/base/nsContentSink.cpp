@@ -10,6 +10,8 @@
  */
 
 #include "nsContentSink.h"
+#include <algorithm>
+
 #include "mozilla/Components.h"
 #include "mozilla/PresShell.h"
 #include "mozilla/StaticPrefs_browser.h"
@@ -121,6 +123,8 @@ nsContentSink::nsContentSink()
       mRunsToCompletion(0),
       mIsBlockingOnload(false),
       mDeflectedCount(0),
+      mDeflectLimit(0),
+      mLastClockCheckTime(0),
       mHasPendingEvent(false),
       mCurrentParseEndTime(0),
       mBeginLoadTime(0),
@@ -776,24 +780,54 @@ nsresult nsContentSink::DidProcessATokenImpl() {
   }
 
   // Have we processed enough tokens to check time?
-  if (!mHasPendingEvent &&
-      mDeflectedCount <
-          uint32_t(mDynamicLowerValue
-                       ? StaticPrefs::content_sink_interactive_deflect_count()
-                       : StaticPrefs::content_sink_perf_deflect_count())) {
+  if (!mHasPendingEvent && mDeflectedCount < DeflectLimit()) {
     return NS_OK;
   }
 
+  const uint32_t tokens = mDeflectedCount;
   mDeflectedCount = 0;
 
   // Check if it's time to return to the main event loop
-  if (PR_IntervalToMicroseconds(PR_IntervalNow()) > mCurrentParseEndTime) {
+  const uint32_t now = PR_IntervalToMicroseconds(PR_IntervalNow());
+  if (now > mCurrentParseEndTime) {
     return NS_ERROR_HTMLPARSER_INTERRUPTED;
   }
 
+  if (StaticPrefs::content_sink_adaptive_deflect_count()) {
+    UpdateDeflectLimit(tokens, now);
+  }
+
   return NS_OK;
 }
 
+uint32_t nsContentSink::DeflectLimit() const {
+  if (StaticPrefs::content_sink_adaptive_deflect_count()) {
+    return mDeflectLimit;
+  }
+  return uint32_t(mDynamicLowerValue
+                      ? StaticPrefs::content_sink_interactive_deflect_count()
+                      : StaticPrefs::content_sink_perf_deflect_count());
+}
+
+void nsContentSink::UpdateDeflectLimit(uint32_t aTokens, uint32_t aNow) {
+  const uint32_t lastCheck = mLastClockCheckTime;
+  mLastClockCheckTime = aNow;
+  if (!lastCheck || aNow < lastCheck || !aTokens) {
+    return;
+  }
+
+  // Aim to check the clock again once a quarter of the remaining time has
+  // passed, so that we don't overshoot the deadline by much when tokens are
+  // expensive, and don't read the clock for every token when they're cheap.
+  // Grow the limit at most twofold at a time, since a run of cheap tokens
+  // tells little about the next ones.
+  const uint64_t elapsed = std::max(aNow - lastCheck, 1u);
+  const uint64_t target = (mCurrentParseEndTime - aNow) / 4;
+  const uint64_t limit = uint64_t(aTokens) * target / elapsed;
+  mDeflectLimit =
+      uint32_t(std::clamp<uint64_t>(limit, 1, std::max(2 * mDeflectLimit, 2u)));
+}
+
 //----------------------------------------------------------------------
 
 void nsContentSink::BeginUpdate(Document* aDocument) {
@@ -921,6 +955,14 @@ nsresult nsContentSink::WillParseImpl(void) {
   mDeflectedCount = 0;
   mHasPendingEvent = false;
 
+  // Start from the fixed deflect count of the mode, which the adaptive one
+  // then adjusts.
+  mDeflectLimit =
+      uint32_t(mDynamicLowerValue
+                   ? StaticPrefs::content_sink_interactive_deflect_count()
+                   : StaticPrefs::content_sink_perf_deflect_count());
+  mLastClockCheckTime = currentTime;
+
   mCurrentParseEndTime =
       currentTime + (mDynamicLowerValue
                          ? StaticPrefs::content_sink_interactive_parse_time()
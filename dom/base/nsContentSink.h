@@ -199,10 +199,22 @@ class nsContentSink : public nsICSSLoaderObserver,
 
   void DoProcessLinkHeader();
 
+  // The number of tokens to process between checks of the clock.
+  uint32_t DeflectLimit() const;
+
+  // Makes the next token check the clock, e.g. after running a script. The
+  // time since the last check isn't spent on tokens, so it doesn't count
+  // towards the adaptive deflect limit.
   void StopDeflecting() {
-    mDeflectedCount = mozilla::StaticPrefs::content_sink_perf_deflect_count();
+    mDeflectedCount = DeflectLimit();
+    mLastClockCheckTime = 0;
   }
 
+  // Sizes mDeflectLimit so that the clock is checked a few times before
+  // mCurrentParseEndTime, based on how long aTokens tokens took since the
+  // last check.
+  void UpdateDeflectLimit(uint32_t aTokens, uint32_t aNow);
+
  protected:
   RefPtr<Document> mDocument;
   RefPtr<nsParserBase> mParser;
@@ -248,6 +260,12 @@ class nsContentSink : public nsICSSLoaderObserver,
   // if it's time to return to the main event loop.
   uint32_t mDeflectedCount;
 
+  // With content.sink.adaptive_deflect_count, the number of tokens to
+  // process before measuring again, and when we last measured, or 0 if the
+  // time since then shouldn't be used to size mDeflectLimit.
+  uint32_t mDeflectLimit;
+  uint32_t mLastClockCheckTime;
+
   // Is there currently a pending event?
   bool mHasPendingEvent;
 
@@ -30,6 +30,7 @@
 #include "mozilla/TextControlElement.h"
 #include "mozilla/TextControlState.h"
 #include "mozilla/TextEditor.h"
+#include "mozilla/TextUtils.h"
 #include "mozilla/TimeStamp.h"
 #include "mozilla/dom/BindContext.h"
 #include "mozilla/dom/CharacterData.h"
@@ -2946,6 +2947,13 @@ nsINode* nsINode::ReplaceOrInsertBefore(bool aReplace, nsINode* aNewChild,
     bool appending = !IsDocument() && !nodeToInsertBefore;
     nsIContent* firstInsertedContent = fragChildren->ElementAt(0);
 
+    // When inserting in the middle of the child list, let the pres shell
+    // handle the children as a single run, like it does when appending.
+    Maybe<AutoContentRangeInsertion> rangeInsertion;
+    if (!appending && !IsDocument() && count > 1) {
+      rangeInsertion.emplace(this);
+    }
+
     // Iterate through the fragment's children, and insert them in the new
     // parent
     for (uint32_t i = 0; i < count; ++i) {
@@ -3269,12 +3277,46 @@ Element* nsINode::QuerySelector(const nsACString& aSelector,
       Servo_SelectorList_QueryFirst(this, list, useInvalidation));
 }
 
+// Whether aSelector is a single class selector, like ".foo", whose class
+// name needs no escaping.
+static bool IsSimpleClassSelector(const nsACString& aSelector) {
+  if (aSelector.Length() < 2 || aSelector[0] != '.') {
+    return false;
+  }
+  const char first = aSelector[1];
+  if (!IsAsciiAlpha(first) && first != '_') {
+    return false;
+  }
+  for (char c : Substring(aSelector, 2)) {
+    if (!IsAsciiAlphanumeric(c) && c != '_' && c != '-') {
+      return false;
+    }
+  }
+  return true;
+}
+
 already_AddRefed<nsINodeList> nsINode::QuerySelectorAll(
     const nsACString& aSelector, ErrorResult& aResult) {
   AUTO_PROFILER_LABEL_DYNAMIC_NSCSTRING_RELEVANT_FOR_JS(
       "querySelectorAll", LAYOUT_SelectorQuery, aSelector);
 
   RefPtr<nsSimpleContentList> contentList = new nsSimpleContentList(this);
+
+  // Pages tend to query the same class over and over.  Copy the elements of
+  // the live getElementsByClassName list instead, which keeps itself up to
+  // date as the tree changes, rather than matching the whole subtree again.
+  if ((IsElement() || IsDocument()) && IsSimpleClassSelector(aSelector)) {
+    RefPtr<nsContentList> classList = nsContentUtils::GetElementsByClassName(
+        this, NS_ConvertUTF8toUTF16(Substring(aSelector, 1)));
+    const uint32_t length = classList->Length(/* aDoFlush = */ false);
+    contentList->SetCapacity(length);
+    for (uint32_t i = 0; i < length; ++i) {
+      contentList->AppendElement(classList->Item(i, /* aDoFlush = */ false));
+    }
+    OwnerDoc()->KeepQuerySelectorAllList(classList);
+    return contentList.forget();
+  }
+
   const StyleSelectorList* list = ParseSelectorList(aSelector, aResult);
   if (!list) {
     return contentList.forget();
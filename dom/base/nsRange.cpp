@@ -682,6 +682,7 @@ void nsRange::ContentInserted(nsIContent* aChild) {
     aChild->SetDescendantOfClosestCommonInclusiveAncestorForRangeInSelection();
   }
 
+  bool boundaryRefsChanged = false;
   if (mNextStartRef || mNextEndRef) {
     if (mNextStartRef) {
       newStart = {mStart.GetContainer(), mNextStartRef};
@@ -695,10 +696,15 @@ void nsRange::ContentInserted(nsIContent* aChild) {
     }
 
     updateBoundaries = true;
+    boundaryRefsChanged = true;
   }
 
   if (updateBoundaries) {
-    DoSetRange(newStart, newEnd, mRoot);
+    if (boundaryRefsChanged || NeedsToNotifySelectionsOfOffsetChange()) {
+      DoSetRange(newStart, newEnd, mRoot);
+    } else {
+      SetBoundariesWithInvalidatedOffsets(newStart, newEnd);
+    }
   } else {
     nsRange::AssertIfMismatchRootAndRangeBoundaries(mStart, mEnd, mRoot);
   }
@@ -718,6 +724,7 @@ void nsRange::ContentWillBeRemoved(nsIContent* aChild,
   RawRangeBoundary newEnd;
   Maybe<bool> gravitateStart;
   bool gravitateEnd;
+  bool boundaryRefsChanged = false;
 
   // Adjust position if a sibling was removed...
   if (container == startContainer) {
@@ -725,6 +732,7 @@ void nsRange::ContentWillBeRemoved(nsIContent* aChild,
     // we can just invalidate the offset.
     if (aChild == mStart.Ref()) {
       newStart = {container, aChild->GetPreviousSibling()};
+      boundaryRefsChanged = true;
     } else {
       newStart.CopyFrom(mStart, RangeBoundaryIsMutationObserved::Yes);
       newStart.InvalidateOffset();
@@ -733,6 +741,7 @@ void nsRange::ContentWillBeRemoved(nsIContent* aChild,
     gravitateStart = Some(startContainer->IsInclusiveDescendantOf(aChild));
     if (gravitateStart.value()) {
       newStart = {container, aChild->GetPreviousSibling()};
+      boundaryRefsChanged = true;
     }
   }
 
@@ -740,6 +749,7 @@ void nsRange::ContentWillBeRemoved(nsIContent* aChild,
   if (container == endContainer) {
     if (aChild == mEnd.Ref()) {
       newEnd = {container, aChild->GetPreviousSibling()};
+      boundaryRefsChanged = true;
     } else {
       newEnd.CopyFrom(mEnd, RangeBoundaryIsMutationObserved::Yes);
       newEnd.InvalidateOffset();
@@ -752,18 +762,24 @@ void nsRange::ContentWillBeRemoved(nsIContent* aChild,
     }
     if (gravitateEnd) {
       newEnd = {container, aChild->GetPreviousSibling()};
+      boundaryRefsChanged = true;
     }
   }
 
   bool newStartIsSet = newStart.IsSet();
   bool newEndIsSet = newEnd.IsSet();
   if (newStartIsSet || newEndIsSet) {
-    DoSetRange(
-        newStartIsSet ? newStart : mStart.AsRaw(),
-        newEndIsSet ? newEnd : mEnd.AsRaw(), mRoot, false,
-        // CrossShadowBoundaryRange mutates content
-        // removal fot itself, so no need for nsRange to do anything with it.
-        RangeBehaviour::KeepDefaultRangeAndCrossShadowBoundaryRanges);
+    const RawRangeBoundary start = newStartIsSet ? newStart : mStart.AsRaw();
+    const RawRangeBoundary end = newEndIsSet ? newEnd : mEnd.AsRaw();
+    if (boundaryRefsChanged || NeedsToNotifySelectionsOfOffsetChange()) {
+      DoSetRange(
+          start, end, mRoot, false,
+          // CrossShadowBoundaryRange mutates content
+          // removal fot itself, so no need for nsRange to do anything with it.
+          RangeBehaviour::KeepDefaultRangeAndCrossShadowBoundaryRanges);
+    } else {
+      SetBoundariesWithInvalidatedOffsets(start, end);
+    }
   } else {
     nsRange::AssertIfMismatchRootAndRangeBoundaries(mStart, mEnd, mRoot);
   }
@@ -780,6 +796,31 @@ void nsRange::ContentWillBeRemoved(nsIContent* aChild,
   }
 }
 
+bool nsRange::NeedsToNotifySelectionsOfOffsetChange() const {
+  if (mCrossShadowBoundaryRange) {
+    // DoSetRange resets it.
+    return true;
+  }
+  for (const WeakPtr<Selection>& weakSelection : mSelections) {
+    const Selection* selection = weakSelection.get();
+    if (selection && selection->Type() == SelectionType::eNormal) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void nsRange::SetBoundariesWithInvalidatedOffsets(
+    const RawRangeBoundary& aStart, const RawRangeBoundary& aEnd) {
+  MOZ_ASSERT(aStart.GetContainer() == mStart.GetContainer());
+  MOZ_ASSERT(aStart.Ref() == mStart.Ref());
+  MOZ_ASSERT(aEnd.GetContainer() == mEnd.GetContainer());
+  MOZ_ASSERT(aEnd.Ref() == mEnd.Ref());
+  mStart.CopyFrom(aStart, RangeBoundaryIsMutationObserved::Yes);
+  mEnd.CopyFrom(aEnd, RangeBoundaryIsMutationObserved::Yes);
+  nsRange::AssertIfMismatchRootAndRangeBoundaries(mStart, mEnd, mRoot);
+}
+
 void nsRange::ParentChainChanged(nsIContent* aContent) {
   NS_ASSERTION(mRoot == aContent, "Wrong ParentChainChanged notification?");
   nsINode* newRoot = RangeUtils::ComputeRootNode(mStart.GetContainer());
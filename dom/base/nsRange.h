@@ -381,6 +381,26 @@ class nsRange final : public mozilla::dom::AbstractRange,
   bool IsShadowIncludingInclusiveDescendantOfCrossBoundaryRangeAncestor(
       const nsINode& aContainer) const;
 
+  /**
+   * Whether a DOM mutation which only moved the offsets of our boundaries,
+   * not the nodes they refer to, has to go through DoSetRange.  The offsets
+   * are computed again from the reference nodes when they are accessed, and
+   * selections other than the normal one sort their ranges again on the next
+   * access after a DOM mutation, so only normal selections and cross shadow
+   * boundary ranges need to know about the change.  This keeps typing in
+   * editors with many spellcheck or highlight ranges from scheduling a
+   * selection notification for every range on every mutation.
+   */
+  bool NeedsToNotifySelectionsOfOffsetChange() const;
+
+  /**
+   * Sets our boundaries to aStart and aEnd, which refer to the same nodes as
+   * our current boundaries but have invalidated offsets.
+   */
+  void SetBoundariesWithInvalidatedOffsets(
+      const mozilla::RawRangeBoundary& aStart,
+      const mozilla::RawRangeBoundary& aEnd);
+
   /**
    * @brief Returns true if the range is part of exactly one |Selection|.
    */
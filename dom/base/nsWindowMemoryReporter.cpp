@@ -402,6 +402,10 @@ static void CollectWindowReports(nsGlobalWindowInner* aWindow,
               "Memory used for frame properties attached to frames "
               "within a window.");
 
+  REPORT_SIZE("/layout/line-box-data", mLayoutLineBoxDataSize,
+              "Memory used for the overflow areas and floats of line boxes "
+              "within a window.");
+
   REPORT_SIZE("/layout/computed-values/dom", mLayoutComputedValuesDom,
               "Memory used by ComputedValues objects accessible from DOM "
               "elements.");
@@ -643,6 +647,10 @@ nsWindowMemoryReporter::CollectReports(nsIHandleReportCallback* aHandleReport,
          windowTotalSizes.mLayoutFramePropertiesSize,
          "This is the sum of all windows' 'layout/frame-properties' numbers.");
 
+  REPORT("window-objects/layout/line-box-data",
+         windowTotalSizes.mLayoutLineBoxDataSize,
+         "This is the sum of all windows' 'layout/line-box-data' numbers.");
+
   REPORT("window-objects/layout/computed-values",
          windowTotalSizes.mLayoutComputedValuesDom +
              windowTotalSizes.mLayoutComputedValuesNonDom +
@@ -182,6 +182,7 @@ class nsWindowSizes {
   MACRO(Other, mLayoutTextRunsSize)                          \
   MACRO(Other, mLayoutPresContextSize)                       \
   MACRO(Other, mLayoutFramePropertiesSize)                   \
+  MACRO(Other, mLayoutLineBoxDataSize)                       \
   MACRO(Style, mLayoutComputedValuesDom)                     \
   MACRO(Style, mLayoutComputedValuesNonDom)                  \
   MACRO(Style, mLayoutComputedValuesVisited)                 \
@@ -79,7 +79,7 @@ const int32_t kHackyDowngradeSchemaVersion = 25;
 const int32_t kHackyPaddingSizePresentVersion = 27;
 //
 // Update this whenever the DB schema is changed.
-const int32_t kLatestSchemaVersion = 29;
+const int32_t kLatestSchemaVersion = 30;
 // ---------
 // The following constants define the SQL schema.  These are defined in the
 // same order the SQL should be executed in CreateOrMigrateSchema().  They are
@@ -243,6 +243,41 @@ const char kTriggerEntriesDelete[] =
     "WHERE usage_info.id = 1; "
     "END";
 
+// Bodies that are stored once for all the entries with the same content.
+// Entries referencing one of these bodies have a body disk size of 0, and
+// the disk size of the body is counted here instead.  Bodies written before
+// this table existed, and bodies that are never shared, have no row here.
+const char kTableBodies[] =
+    "CREATE TABLE bodies ("
+    "id TEXT NOT NULL PRIMARY KEY, "
+    "hash BLOB NOT NULL, "  // sha256 hash of the body file
+    "disk_size INTEGER NOT NULL, "
+    "refcount INTEGER NOT NULL"
+    ")";
+
+const char kIndexBodiesHash[] =
+    "CREATE INDEX bodies_hash_index ON bodies (hash)";
+
+const char kTriggerBodiesInsert[] =
+    "CREATE TRIGGER bodies_insert_trigger "
+    "AFTER INSERT ON bodies "
+    "FOR EACH ROW "
+    "BEGIN "
+    "UPDATE usage_info SET total_disk_usage = total_disk_usage + "
+    "NEW.disk_size "
+    "WHERE usage_info.id = 1; "
+    "END";
+
+const char kTriggerBodiesDelete[] =
+    "CREATE TRIGGER bodies_delete_trigger "
+    "AFTER DELETE ON bodies "
+    "FOR EACH ROW "
+    "BEGIN "
+    "UPDATE usage_info SET total_disk_usage = total_disk_usage - "
+    "OLD.disk_size "
+    "WHERE usage_info.id = 1; "
+    "END";
+
 // ---------
 // End schema definition
 // ---------
@@ -442,6 +477,12 @@ static nsresult InsertEntry(mozIStorageConnection& aConn, CacheId aCacheId,
                             const nsID* aRequestBodyId,
                             const CacheResponse& aResponse,
                             const nsID* aResponseBodyId);
+static nsresult AddRefBody(mozIStorageConnection& aConn, const nsID* aBodyId);
+// Drops a reference to each of the shared bodies in aDeletedBodyIdList, and
+// removes the bodies that are still referenced from the list, so that only
+// the files without any references left are deleted.
+static nsresult ReleaseBodies(mozIStorageConnection& aConn,
+                              nsTArray<nsID>& aDeletedBodyIdList);
 static Result<SavedResponse, nsresult> ReadResponse(
     mozIStorageConnection& aConn, EntryId aEntryId);
 static Result<SavedRequest, nsresult> ReadRequest(mozIStorageConnection& aConn,
@@ -558,6 +599,14 @@ nsresult CreateOrMigrateSchema(nsIFile& aDBDir, mozIStorageConnection& aConn) {
         aConn.ExecuteSimpleSQL(nsLiteralCString(kTriggerEntriesUpdate))));
     QM_TRY(MOZ_TO_RESULT(
         aConn.ExecuteSimpleSQL(nsLiteralCString(kTriggerEntriesDelete))));
+    QM_TRY(
+        MOZ_TO_RESULT(aConn.ExecuteSimpleSQL(nsLiteralCString(kTableBodies))));
+    QM_TRY(MOZ_TO_RESULT(
+        aConn.ExecuteSimpleSQL(nsLiteralCString(kIndexBodiesHash))));
+    QM_TRY(MOZ_TO_RESULT(
+        aConn.ExecuteSimpleSQL(nsLiteralCString(kTriggerBodiesInsert))));
+    QM_TRY(MOZ_TO_RESULT(
+        aConn.ExecuteSimpleSQL(nsLiteralCString(kTriggerBodiesDelete))));
     QM_TRY(MOZ_TO_RESULT(aConn.SetSchemaVersion(kLatestSchemaVersion)));
     QM_TRY_UNWRAP(schemaVersion, GetEffectiveSchemaVersion(aConn));
   }
@@ -665,6 +714,8 @@ Result<DeletionInfo, nsresult> DeleteCacheId(mozIStorageConnection& aConn,
 
   QM_TRY(MOZ_TO_RESULT(DeleteSecurityInfoList(aConn, deletedSecurityIdList)));
 
+  QM_TRY(MOZ_TO_RESULT(ReleaseBodies(aConn, deletedBodyIdList)));
+
   // Delete the remainder of the cache using cascade semantics.
   QM_TRY_INSPECT(const auto& state,
                  MOZ_TO_RESULT_INVOKE_MEMBER_TYPED(
@@ -774,6 +825,49 @@ Result<nsTHashSet<nsID>, nsresult> GetKnownBodyIds(
   return std::move(idSet);
 }
 
+Result<Maybe<nsID>, nsresult> FindBody(mozIStorageConnection& aConn,
+                                       const nsACString& aHash) {
+  MOZ_ASSERT(!NS_IsMainThread());
+
+  QM_TRY_INSPECT(const auto& state,
+                 quota::CreateAndExecuteSingleStepStatement<
+                     quota::SingleStepResult::ReturnNullIfNoResult>(
+                     aConn, "SELECT id FROM bodies WHERE hash=:hash;"_ns,
+                     [&aHash](auto& state) -> Result<Ok, nsresult> {
+                       QM_TRY(MOZ_TO_RESULT(
+                           state.BindUTF8StringAsBlobByName("hash"_ns, aHash)));
+                       return Ok{};
+                     }));
+
+  if (!state) {
+    return Maybe<nsID>();
+  }
+
+  QM_TRY_INSPECT(const auto& id, ExtractId(*state, 0));
+
+  return Some(id);
+}
+
+nsresult InsertBody(mozIStorageConnection& aConn, const nsID& aBodyId,
+                    const nsACString& aHash, int64_t aDiskSize) {
+  MOZ_ASSERT(!NS_IsMainThread());
+
+  // The entries referencing the body add their references when they're
+  // inserted.
+  QM_TRY_INSPECT(const auto& state,
+                 MOZ_TO_RESULT_INVOKE_MEMBER_TYPED(
+                     nsCOMPtr<mozIStorageStatement>, aConn, CreateStatement,
+                     "INSERT INTO bodies (id, hash, disk_size, refcount) "
+                     "VALUES (:id, :hash, :disk_size, 0);"_ns));
+
+  QM_TRY(MOZ_TO_RESULT(BindId(*state, "id"_ns, &aBodyId)));
+  QM_TRY(MOZ_TO_RESULT(state->BindUTF8StringAsBlobByName("hash"_ns, aHash)));
+  QM_TRY(MOZ_TO_RESULT(state->BindInt64ByName("disk_size"_ns, aDiskSize)));
+  QM_TRY(MOZ_TO_RESULT(state->Execute()));
+
+  return NS_OK;
+}
+
 Result<Maybe<SavedResponse>, nsresult> CacheMatch(
     mozIStorageConnection& aConn, CacheId aCacheId,
     const CacheRequest& aRequest, const CacheQueryParams& aParams) {
@@ -841,10 +935,16 @@ Result<DeletionInfo, nsresult> CachePut(mozIStorageConnection& aConn,
   QM_TRY(MOZ_TO_RESULT(InsertEntry(aConn, aCacheId, aRequest, aRequestBodyId,
                                    aResponse, aResponseBodyId)));
 
+  QM_TRY(MOZ_TO_RESULT(AddRefBody(aConn, aRequestBodyId)));
+  QM_TRY(MOZ_TO_RESULT(AddRefBody(aConn, aResponseBodyId)));
+
   // Delete the security values after doing the insert to avoid churning
-  // the security table when its not necessary.
+  // the security table when its not necessary.  Likewise, a body shared
+  // with the replaced entry stays in place.
   QM_TRY(MOZ_TO_RESULT(DeleteSecurityInfoList(aConn, deletedSecurityIdList)));
 
+  QM_TRY(MOZ_TO_RESULT(ReleaseBodies(aConn, deletedBodyIdList)));
+
   return DeletionInfo{std::move(deletedBodyIdList), deletedPaddingSize};
 }
 
@@ -867,6 +967,8 @@ Result<Maybe<DeletionInfo>, nsresult> CacheDelete(
 
   QM_TRY(MOZ_TO_RESULT(DeleteSecurityInfoList(aConn, deletedSecurityIdList)));
 
+  QM_TRY(MOZ_TO_RESULT(ReleaseBodies(aConn, deletedBodyIdList)));
+
   return Some(DeletionInfo{std::move(deletedBodyIdList), deletedPaddingSize});
 }
 
@@ -1678,6 +1780,80 @@ nsresult DeleteSecurityInfoList(
   return NS_OK;
 }
 
+nsresult AddRefBody(mozIStorageConnection& aConn, const nsID* aBodyId) {
+  if (!aBodyId) {
+    return NS_OK;
+  }
+
+  // This does nothing for bodies that aren't shared.
+  QM_TRY_INSPECT(const auto& state,
+                 MOZ_TO_RESULT_INVOKE_MEMBER_TYPED(
+                     nsCOMPtr<mozIStorageStatement>, aConn, CreateStatement,
+                     "UPDATE bodies SET refcount=refcount+1 WHERE id=:id;"_ns));
+
+  QM_TRY(MOZ_TO_RESULT(BindId(*state, "id"_ns, aBodyId)));
+  QM_TRY(MOZ_TO_RESULT(state->Execute()));
+
+  return NS_OK;
+}
+
+nsresult ReleaseBodies(mozIStorageConnection& aConn,
+                       nsTArray<nsID>& aDeletedBodyIdList) {
+  nsTArray<nsID> unreferencedBodyIdList;
+
+  for (const auto& id : aDeletedBodyIdList) {
+    QM_TRY_INSPECT(
+        const auto& selectStmt,
+        quota::CreateAndExecuteSingleStepStatement<
+            quota::SingleStepResult::ReturnNullIfNoResult>(
+            aConn, "SELECT refcount FROM bodies WHERE id=:id;"_ns,
+            [&id](auto& state) -> Result<Ok, nsresult> {
+              QM_TRY(MOZ_TO_RESULT(BindId(state, "id"_ns, &id)));
+              return Ok{};
+            }));
+
+    // This body was only ever referenced by the deleted entry.
+    if (!selectStmt) {
+      unreferencedBodyIdList.AppendElement(id);
+      continue;
+    }
+
+    QM_TRY_INSPECT(const int32_t& refcount,
+                   MOZ_TO_RESULT_INVOKE_MEMBER(selectStmt, GetInt32, 0));
+
+    MOZ_ASSERT_DEBUG_OR_FUZZING(refcount >= 1);
+
+    // If the last reference to this body was removed, remove its row and let
+    // the caller delete the file.
+    if (refcount <= 1) {
+      QM_TRY_INSPECT(const auto& state,
+                     MOZ_TO_RESULT_INVOKE_MEMBER_TYPED(
+                         nsCOMPtr<mozIStorageStatement>, aConn, CreateStatement,
+                         "DELETE FROM bodies WHERE id=:id;"_ns));
+
+      QM_TRY(MOZ_TO_RESULT(BindId(*state, "id"_ns, &id)));
+      QM_TRY(MOZ_TO_RESULT(state->Execute()));
+
+      unreferencedBodyIdList.AppendElement(id);
+      continue;
+    }
+
+    QM_TRY_INSPECT(
+        const auto& state,
+        MOZ_TO_RESULT_INVOKE_MEMBER_TYPED(
+            nsCOMPtr<mozIStorageStatement>, aConn, CreateStatement,
+            "UPDATE bodies SET refcount=:refcount WHERE id=:id;"_ns));
+
+    QM_TRY(MOZ_TO_RESULT(state->BindInt32ByName("refcount"_ns, refcount - 1)));
+    QM_TRY(MOZ_TO_RESULT(BindId(*state, "id"_ns, &id)));
+    QM_TRY(MOZ_TO_RESULT(state->Execute()));
+  }
+
+  aDeletedBodyIdList = std::move(unreferencedBodyIdList);
+
+  return NS_OK;
+}
+
 nsresult InsertEntry(mozIStorageConnection& aConn, CacheId aCacheId,
                      const CacheRequest& aRequest, const nsID* aRequestBodyId,
                      const CacheResponse& aResponse,
@@ -2474,6 +2650,11 @@ nsresult Validate(mozIStorageConnection& aConn) {
       Expect("entries_insert_trigger", "trigger", kTriggerEntriesInsert),
       Expect("entries_update_trigger", "trigger", kTriggerEntriesUpdate),
       Expect("entries_delete_trigger", "trigger", kTriggerEntriesDelete),
+      Expect("bodies", "table", kTableBodies),
+      Expect("sqlite_autoindex_bodies_1", "index"),  // auto-gen by sqlite
+      Expect("bodies_hash_index", "index", kIndexBodiesHash),
+      Expect("bodies_insert_trigger", "trigger", kTriggerBodiesInsert),
+      Expect("bodies_delete_trigger", "trigger", kTriggerBodiesDelete),
   };
 
   // Read the schema from the sqlite_master table and compare.
@@ -2573,6 +2754,8 @@ nsresult MigrateFrom27To28(nsIFile& aDBDir, mozIStorageConnection& aConn,
                            bool& aRewriteSchema);
 nsresult MigrateFrom28To29(nsIFile& aDBDir, mozIStorageConnection& aConn,
                            bool& aRewriteSchema);
+nsresult MigrateFrom29To30(nsIFile& aDBDir, mozIStorageConnection& aConn,
+                           bool& aRewriteSchema);
 // Configure migration functions to run for the given starting version.
 constexpr Migration sMigrationList[] = {
     Migration{15, MigrateFrom15To16}, Migration{16, MigrateFrom16To17},
@@ -2582,6 +2765,7 @@ constexpr Migration sMigrationList[] = {
     Migration{23, MigrateFrom23To24}, Migration{24, MigrateFrom24To25},
     Migration{25, MigrateFrom25To26}, Migration{26, MigrateFrom26To27},
     Migration{27, MigrateFrom27To28}, Migration{28, MigrateFrom28To29},
+    Migration{29, MigrateFrom29To30},
 };
 
 nsresult RewriteEntriesSchema(mozIStorageConnection& aConn) {
@@ -3228,5 +3412,26 @@ nsresult MigrateFrom28To29(nsIFile& aDBDir, mozIStorageConnection& aConn,
   return NS_OK;
 }
 
+nsresult MigrateFrom29To30(nsIFile& aDBDir, mozIStorageConnection& aConn,
+                           bool& aRewriteSchema) {
+  MOZ_ASSERT(!NS_IsMainThread());
+
+  // The existing bodies keep being owned by their entries.
+  QM_TRY(MOZ_TO_RESULT(aConn.ExecuteSimpleSQL(nsLiteralCString(kTableBodies))));
+
+  QM_TRY(MOZ_TO_RESULT(
+      aConn.ExecuteSimpleSQL(nsLiteralCString(kIndexBodiesHash))));
+
+  QM_TRY(MOZ_TO_RESULT(
+      aConn.ExecuteSimpleSQL(nsLiteralCString(kTriggerBodiesInsert))));
+
+  QM_TRY(MOZ_TO_RESULT(
+      aConn.ExecuteSimpleSQL(nsLiteralCString(kTriggerBodiesDelete))));
+
+  QM_TRY(MOZ_TO_RESULT(aConn.SetSchemaVersion(30)));
+
+  return NS_OK;
+}
+
 }  // anonymous namespace
 }  // namespace mozilla::dom::cache::db
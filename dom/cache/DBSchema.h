@@ -47,6 +47,16 @@ Result<int64_t, nsresult> GetTotalDiskUsage(mozIStorageConnection& aConn);
 Result<nsTHashSet<nsID>, nsresult> GetKnownBodyIds(
     mozIStorageConnection& aConn);
 
+// Returns the id of the shared body with the given content hash, if any.
+Result<Maybe<nsID>, nsresult> FindBody(mozIStorageConnection& aConn,
+                                       const nsACString& aHash);
+
+// Records the body file aBodyId as shared by every entry with the same
+// content.  The entries referencing it must be inserted with a body disk size
+// of 0, as the body's disk usage is counted once for all of them.
+nsresult InsertBody(mozIStorageConnection& aConn, const nsID& aBodyId,
+                    const nsACString& aHash, int64_t aDiskSize);
+
 Result<Maybe<SavedResponse>, nsresult> CacheMatch(
     mozIStorageConnection& aConn, CacheId aCacheId,
     const CacheRequest& aRequest, const CacheQueryParams& aParams);
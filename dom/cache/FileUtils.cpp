@@ -21,6 +21,8 @@
 #include "mozilla/ScopeExit.h"
 #include "mozilla/SnappyCompressOutputStream.h"
 #include "mozilla/Unused.h"
+#include "nsComponentManagerUtils.h"
+#include "nsICryptoHash.h"
 #include "nsIObjectInputStream.h"
 #include "nsIObjectOutputStream.h"
 #include "nsIFile.h"
@@ -224,6 +226,27 @@ Result<int64_t, nsresult> BodyFinalizeWrite(nsIFile& aBaseDir,
   return fileSize;
 }
 
+Result<nsCString, nsresult> BodyHashWrite(nsIFile& aBaseDir, const nsID& aId) {
+  QM_TRY_INSPECT(const auto& tmpFile,
+                 BodyIdToFile(aBaseDir, aId, BODY_FILE_TMP));
+
+  QM_TRY_INSPECT(const auto& stream,
+                 NS_NewLocalFileInputStream(tmpFile.get()));
+
+  QM_TRY_INSPECT(const auto& crypto,
+                 MOZ_TO_RESULT_GET_TYPED(nsCOMPtr<nsICryptoHash>,
+                                         MOZ_SELECT_OVERLOAD(do_CreateInstance),
+                                         NS_CRYPTO_HASH_CONTRACTID));
+
+  QM_TRY(MOZ_TO_RESULT(crypto->Init(nsICryptoHash::SHA256)));
+  QM_TRY(MOZ_TO_RESULT(crypto->UpdateFromStream(stream, UINT32_MAX)));
+
+  nsCString hash;
+  QM_TRY(MOZ_TO_RESULT(crypto->Finish(false /* based64 result */, hash)));
+
+  return hash;
+}
+
 Result<int64_t, nsresult> GetBodyDiskSize(nsIFile& aBaseDir, const nsID& aId) {
   QM_TRY_INSPECT(const auto& finalFile,
                  BodyIdToFile(aBaseDir, aId, BODY_FILE_FINAL));
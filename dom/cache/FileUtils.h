@@ -44,6 +44,10 @@ void BodyCancelWrite(nsISupports& aCopyContext);
 
 Result<int64_t, nsresult> BodyFinalizeWrite(nsIFile& aBaseDir, const nsID& aId);
 
+// Returns the sha256 hash of the body file written for aId, before it is
+// finalized.
+Result<nsCString, nsresult> BodyHashWrite(nsIFile& aBaseDir, const nsID& aId);
+
 Result<int64_t, nsresult> GetBodyDiskSize(nsIFile& aBaseDir, const nsID& aId);
 
 Result<MovingNotNull<nsCOMPtr<nsIInputStream>>, nsresult> BodyOpen(
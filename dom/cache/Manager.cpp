@@ -921,7 +921,7 @@ class Manager::CachePutAllAction final : public DBAction {
       QM_TRY(CollectEachInRange(mList, [this](Entry& e) -> nsresult {
         if (e.mRequestStream) {
           QM_TRY_UNWRAP(int64_t bodyDiskSize,
-                        BodyFinalizeWrite(*mDBDir, e.mRequestBodyId));
+                        FinalizeBody(e.mRequestBodyId, /* aShareable */ true));
           e.mRequest.bodyDiskSize() = bodyDiskSize;
         } else {
           e.mRequest.bodyDiskSize() = 0;
@@ -939,8 +939,12 @@ class Manager::CachePutAllAction final : public DBAction {
             mUpdatedPaddingSize += e.mResponse.paddingSize();
           }
 
-          QM_TRY_UNWRAP(int64_t bodyDiskSize,
-                        BodyFinalizeWrite(*mDBDir, e.mResponseBodyId));
+          // Opaque responses are padded so that their size doesn't leak, and
+          // sharing their bodies would reveal whether they match another one.
+          QM_TRY_UNWRAP(
+              int64_t bodyDiskSize,
+              FinalizeBody(e.mResponseBodyId,
+                           e.mResponse.type() != ResponseType::Opaque));
           e.mResponse.bodyDiskSize() = bodyDiskSize;
         } else {
           e.mResponse.bodyDiskSize() = 0;
@@ -1028,6 +1032,36 @@ class Manager::CachePutAllAction final : public DBAction {
 
   enum StreamId { RequestStream, ResponseStream };
 
+  // Finalizes the body file written for aBodyId, and returns the body disk
+  // size to store in its entry.  If aShareable and a body with the same
+  // content is already stored, the new file is deleted and aBodyId becomes
+  // the id of the stored body instead.
+  Result<int64_t, nsresult> FinalizeBody(nsID& aBodyId, bool aShareable) {
+    MOZ_ASSERT(mTarget->IsOnCurrentThread());
+
+    // Encrypted bodies never have the same content.
+    if (!aShareable || mDirectoryMetadata->mIsPrivate) {
+      QM_TRY_RETURN(BodyFinalizeWrite(*mDBDir, aBodyId));
+    }
+
+    QM_TRY_INSPECT(const auto& hash, BodyHashWrite(*mDBDir, aBodyId));
+
+    QM_TRY_INSPECT(const auto& maybeBodyId, db::FindBody(*mConn, hash));
+    if (maybeBodyId) {
+      QM_TRY(MOZ_TO_RESULT(BodyDeleteFiles(*mDirectoryMetadata, *mDBDir,
+                                           nsTArray<nsID>{aBodyId})));
+      aBodyId = *maybeBodyId;
+      return 0;
+    }
+
+    QM_TRY_INSPECT(const int64_t& bodyDiskSize,
+                   BodyFinalizeWrite(*mDBDir, aBodyId));
+    QM_TRY(MOZ_TO_RESULT(db::InsertBody(*mConn, aBodyId, hash, bodyDiskSize)));
+
+    // The disk size is counted in the bodies table.
+    return 0;
+  }
+
   nsresult StartStreamCopy(const CacheDirectoryMetadata& aDirectoryMetadata,
                            Entry& aEntry, StreamId aStreamId,
                            uint32_t* aCopyCountOut) {
@@ -6346,14 +6346,6 @@ nsresult CanvasRenderingContext2D::GetImageDataArray(
     return NS_ERROR_FAILURE;
   }
 
-  RefPtr<SourceSurface> snapshot = mBufferProvider->BorrowSnapshot();
-  if (!snapshot) {
-    return NS_ERROR_OUT_OF_MEMORY;
-  }
-
-  RefPtr<DataSourceSurface> readback = snapshot->GetDataSurface();
-  mBufferProvider->ReturnSnapshot(snapshot.forget());
-
   // Check for site-specific permission.
   CanvasUtils::ImageExtraction permission =
       CanvasUtils::ImageExtraction::Unrestricted;
@@ -6365,6 +6357,31 @@ nsresult CanvasRenderingContext2D::GetImageDataArray(
                                                     aSubjectPrincipal);
   }
 
+  RefPtr<SourceSurface> snapshot = mBufferProvider->BorrowSnapshot();
+  if (!snapshot) {
+    return NS_ERROR_OUT_OF_MEMORY;
+  }
+
+  // Reading back the whole of an accelerated canvas can be much slower than
+  // copying the requested part of it on the GPU and reading back only that,
+  // so try to extract just that part. Randomization depends on the whole
+  // image, so it still needs the whole canvas.
+  RefPtr<SourceSurface> subrect;
+  if (mBufferProvider->IsAccelerated() &&
+      srcReadRect.Size() != snapshot->GetSize() &&
+      permission == CanvasUtils::ImageExtraction::Unrestricted) {
+    subrect = snapshot->ExtractSubrect(srcReadRect);
+  }
+  IntPoint readbackOrigin = srcReadRect.TopLeft();
+  RefPtr<DataSourceSurface> readback;
+  if (subrect) {
+    readback = subrect->GetDataSurface();
+    readbackOrigin = IntPoint();
+  } else {
+    readback = snapshot->GetDataSurface();
+  }
+  mBufferProvider->ReturnSnapshot(snapshot.forget());
+
   // Clone the data source surface if canvas randomization is enabled. We need
   // to do this because we don't want to alter the actual image buffer.
   // Otherwise, we will provide inconsistent image data with multiple calls.
@@ -6412,7 +6429,7 @@ nsresult CanvasRenderingContext2D::GetImageDataArray(
 
     uint32_t srcStride = rawData.mStride;
     uint8_t* src =
-        rawData.mData + srcReadRect.y * srcStride + srcReadRect.x * 4;
+        rawData.mData + readbackOrigin.y * srcStride + readbackOrigin.x * 4;
 
     uint8_t* dst = data + dstWriteRect.y * (aWidth * 4) + dstWriteRect.x * 4;
 
@@ -198,6 +198,11 @@ DrawTargetWebgl::~DrawTargetWebgl() {
       mSkia->DetachAllSnapshots();
     }
     mSharedContext->ClearLastTexture(true);
+    if (mSharedContext->IsCurrentTarget(this)) {
+      // The framebuffer is going away, so there is no point in drawing the
+      // rectangles still batched for it.
+      mSharedContext->DiscardBatchedRects();
+    }
     if (mClipMask) {
       mSharedContext->RemoveUntrackedTextureMemory(mClipMask);
       mClipMask = nullptr;
@@ -233,6 +238,10 @@ SharedContextWebgl::~SharedContextWebgl() {
     RemoveUntrackedTextureMemory(mPathVertexBuffer);
     mPathVertexBuffer = nullptr;
   }
+  if (mBatchedRectBuffer) {
+    RemoveUntrackedTextureMemory(mBatchedRectBuffer);
+    mBatchedRectBuffer = nullptr;
+  }
   ClearZeroBuffer();
   ClearAllTextures();
   UnlinkSurfaceTextures();
@@ -569,6 +578,7 @@ void SharedContextWebgl::SetBlendState(CompositionOp aOp,
   if (aOp == mLastCompositionOp && mLastBlendColor == aColor) {
     return;
   }
+  FlushBatchedRects();
   mLastCompositionOp = aOp;
   mLastBlendColor = aColor;
   // AA is not supported for all composition ops, so switching blend modes may
@@ -630,6 +640,7 @@ bool SharedContextWebgl::SetTarget(DrawTargetWebgl* aDT) {
     return false;
   }
   if (aDT != mCurrentTarget) {
+    FlushBatchedRects();
     mCurrentTarget = aDT;
     if (aDT) {
       mWebgl->BindFramebuffer(LOCAL_GL_FRAMEBUFFER, aDT->mFramebuffer);
@@ -953,6 +964,7 @@ void* DrawTargetWebgl::GetNativeSurface(NativeSurfaceType aType) {
       if (!mWebglValid) {
         FlushFromSkia();
       }
+      mSharedContext->FlushBatchedRects();
       return mSharedContext->mWebgl.get();
     default:
       return nullptr;
@@ -1004,6 +1016,8 @@ already_AddRefed<TextureHandle> SharedContextWebgl::CopySnapshot(
     return nullptr;
   }
 
+  FlushBatchedRects();
+
   // If the target is going away, then we can just directly reuse the
   // framebuffer texture since it will never change.
   RefPtr<WebGLTexture> tex = mWebgl->CreateTexture();
@@ -1134,6 +1148,8 @@ bool SharedContextWebgl::ReadInto(uint8_t* aDstData, int32_t aDstStride,
   MOZ_ASSERT(aFormat == SurfaceFormat::B8G8R8A8 ||
              aFormat == SurfaceFormat::B8G8R8X8);
 
+  FlushBatchedRects();
+
   // If reading into a new texture, we have to bind it to a scratch framebuffer
   // for reading.
   if (aHandle) {
@@ -1560,16 +1576,147 @@ bool SharedContextWebgl::CreateShaders() {
     UniformData(LOCAL_GL_INT, mImageProgramSampler, Array<int32_t, 1>{0});
     UniformData(LOCAL_GL_INT, mImageProgramClipMask, Array<int32_t, 1>{1});
   }
+
+  if (!mBatchedRectProgram && !CreateBatchedRectProgram()) {
+    // Batching is optional, so just draw rectangles one at a time instead.
+    mBatchedRectProgram = nullptr;
+  }
+  return true;
+}
+
+// Format is the transform basis vectors, the translation and the color.
+static const size_t kBatchedRectFloats = 10;
+static const uint8_t kBatchedRectChannels[] = {4, 2, 4};
+// The most rectangles that are drawn by a single instanced draw call.
+static const size_t kMaxBatchedRects = 1024;
+static const size_t kBatchedRectBufferSize =
+    kMaxBatchedRects * kBatchedRectFloats * sizeof(float);
+
+// Creates the program and vertex state for drawing batches of solid color
+// rectangles. The program is the same as the solid program, except that the
+// transform and the color of each rectangle come from per-instance attributes,
+// and that there is no clip mask.
+bool SharedContextWebgl::CreateBatchedRectProgram() {
+  auto vsSource =
+      "attribute vec3 a_vertex;\n"
+      "attribute vec4 a_transform;\n"
+      "attribute vec2 a_offset;\n"
+      "attribute vec4 a_color;\n"
+      "uniform vec2 u_viewport;\n"
+      "uniform vec4 u_clipbounds;\n"
+      "varying vec4 v_clipdist;\n"
+      "varying vec4 v_dist;\n"
+      "varying float v_alpha;\n"
+      "varying vec4 v_color;\n"
+      "void main() {\n"
+      "   vec2 scale = vec2(dot(a_transform.xy, a_transform.xy),\n"
+      "                     dot(a_transform.zw, a_transform.zw));\n"
+      "   vec2 invScale = inversesqrt(scale + 1.0e-6);\n"
+      "   scale *= invScale;\n"
+      "   vec2 extrude = a_vertex.xy +\n"
+      "                  invScale * (2.0 * a_vertex.xy - 1.0);\n"
+      "   vec2 vertex = a_transform.xy * extrude.x +\n"
+      "                 a_transform.zw * extrude.y +\n"
+      "                 a_offset;\n"
+      "   gl_Position = vec4(vertex * 2.0 / u_viewport - 1.0, 0.0, 1.0);\n"
+      "   v_clipdist = vec4(vertex - u_clipbounds.xy,\n"
+      "                     u_clipbounds.zw - vertex);\n"
+      "   v_dist = vec4(extrude, 1.0 - extrude) * scale.xyxy + 0.5;\n"
+      "   v_alpha = min(a_vertex.z,\n"
+      "                 min(scale.x, 1.0) * min(scale.y, 1.0));\n"
+      "   v_color = a_color;\n"
+      "}\n";
+  auto fsSource =
+      "precision mediump float;\n"
+      "varying vec4 v_clipdist;\n"
+      "varying vec4 v_dist;\n"
+      "varying float v_alpha;\n"
+      "varying vec4 v_color;\n"
+      "void main() {\n"
+      "   vec4 dist = min(v_dist, v_clipdist);\n"
+      "   dist.xy = min(dist.xy, dist.zw);\n"
+      "   float aa = clamp(min(dist.x, dist.y), 0.0, v_alpha);\n"
+      "   gl_FragColor = aa * v_color;\n"
+      "}\n";
+  RefPtr<WebGLShader> vsId = mWebgl->CreateShader(LOCAL_GL_VERTEX_SHADER);
+  mWebgl->ShaderSource(*vsId, vsSource);
+  mWebgl->CompileShader(*vsId);
+  if (!mWebgl->GetCompileResult(*vsId).success) {
+    return false;
+  }
+  RefPtr<WebGLShader> fsId = mWebgl->CreateShader(LOCAL_GL_FRAGMENT_SHADER);
+  mWebgl->ShaderSource(*fsId, fsSource);
+  mWebgl->CompileShader(*fsId);
+  if (!mWebgl->GetCompileResult(*fsId).success) {
+    return false;
+  }
+  mBatchedRectProgram = mWebgl->CreateProgram();
+  mWebgl->AttachShader(*mBatchedRectProgram, *vsId);
+  mWebgl->AttachShader(*mBatchedRectProgram, *fsId);
+  mWebgl->BindAttribLocation(*mBatchedRectProgram, 0, "a_vertex");
+  mWebgl->BindAttribLocation(*mBatchedRectProgram, 1, "a_transform");
+  mWebgl->BindAttribLocation(*mBatchedRectProgram, 2, "a_offset");
+  mWebgl->BindAttribLocation(*mBatchedRectProgram, 3, "a_color");
+  mWebgl->LinkProgram(*mBatchedRectProgram);
+  if (!mWebgl->GetLinkResult(*mBatchedRectProgram).success) {
+    return false;
+  }
+  mBatchedRectProgramViewport =
+      GetUniformLocation(mBatchedRectProgram, "u_viewport");
+  mBatchedRectProgramClipBounds =
+      GetUniformLocation(mBatchedRectProgram, "u_clipbounds");
+  if (!mBatchedRectProgramViewport || !mBatchedRectProgramClipBounds) {
+    return false;
+  }
+
+  if (!mBatchedRectVertexArray) {
+    mBatchedRectVertexArray = mWebgl->CreateVertexArray();
+    mBatchedRectBuffer = mWebgl->CreateBuffer();
+    mWebgl->BindVertexArray(mBatchedRectVertexArray.get());
+
+    // The rectangle vertices come from the start of the path vertex buffer.
+    mWebgl->BindBuffer(LOCAL_GL_ARRAY_BUFFER, mPathVertexBuffer.get());
+    mWebgl->EnableVertexAttribArray(0);
+    webgl::VertAttribPointerDesc vertexDesc;
+    vertexDesc.channels = 3;
+    vertexDesc.type = LOCAL_GL_FLOAT;
+    vertexDesc.normalized = false;
+    mWebgl->VertexAttribPointer(0, vertexDesc);
+
+    mWebgl->BindBuffer(LOCAL_GL_ARRAY_BUFFER, mBatchedRectBuffer.get());
+    mWebgl->UninitializedBufferData_SizeOnly(
+        LOCAL_GL_ARRAY_BUFFER, kBatchedRectBufferSize, LOCAL_GL_STREAM_DRAW);
+    AddUntrackedTextureMemory(mBatchedRectBuffer);
+    uint64_t offset = 0;
+    for (uint32_t i = 0; i < std::size(kBatchedRectChannels); i++) {
+      webgl::VertAttribPointerDesc instanceDesc;
+      instanceDesc.channels = kBatchedRectChannels[i];
+      instanceDesc.type = LOCAL_GL_FLOAT;
+      instanceDesc.normalized = false;
+      instanceDesc.byteStrideOrZero = kBatchedRectFloats * sizeof(float);
+      instanceDesc.byteOffset = offset;
+      mWebgl->EnableVertexAttribArray(i + 1);
+      mWebgl->VertexAttribPointer(i + 1, instanceDesc);
+      mWebgl->VertexAttribDivisor(i + 1, 1);
+      offset += kBatchedRectChannels[i] * sizeof(float);
+    }
+
+    // Restore the path vertex state that other draws rely on.
+    mWebgl->BindVertexArray(mPathVertexArray.get());
+    mWebgl->BindBuffer(LOCAL_GL_ARRAY_BUFFER, mPathVertexBuffer.get());
+  }
   return true;
 }
 
 void SharedContextWebgl::EnableScissor(const IntRect& aRect) {
   // Only update scissor state if it actually changes.
   if (!mLastScissor.IsEqualEdges(aRect)) {
+    FlushBatchedRects();
     mLastScissor = aRect;
     mWebgl->Scissor(aRect.x, aRect.y, aRect.width, aRect.height);
   }
   if (!mScissorEnabled) {
+    FlushBatchedRects();
     mScissorEnabled = true;
     mWebgl->SetEnabled(LOCAL_GL_SCISSOR_TEST, {}, true);
   }
@@ -1577,6 +1724,7 @@ void SharedContextWebgl::EnableScissor(const IntRect& aRect) {
 
 void SharedContextWebgl::DisableScissor() {
   if (mScissorEnabled) {
+    FlushBatchedRects();
     mScissorEnabled = false;
     mWebgl->SetEnabled(LOCAL_GL_SCISSOR_TEST, {}, false);
   }
@@ -1655,6 +1803,7 @@ static inline DeviceColor PremultiplyColor(const DeviceColor& aColor,
 // Attempts to create the framebuffer used for drawing and also any relevant
 // non-shared resources. Returns whether or not this succeeded.
 bool DrawTargetWebgl::CreateFramebuffer() {
+  mSharedContext->FlushBatchedRects();
   RefPtr<WebGLContext> webgl = mSharedContext->mWebgl;
   if (!mFramebuffer) {
     mFramebuffer = webgl->CreateFramebuffer();
@@ -2022,6 +2171,7 @@ bool SharedContextWebgl::UploadSurface(DataSourceSurface* aData,
                                        const IntPoint& aDstOffset, bool aInit,
                                        bool aZero,
                                        const RefPtr<WebGLTexture>& aTex) {
+  FlushBatchedRects();
   webgl::TexUnpackBlobDesc texDesc = {
       LOCAL_GL_TEXTURE_2D,
       {uint32_t(aSrcRect.width), uint32_t(aSrcRect.height), 1}};
@@ -2268,14 +2418,84 @@ void SharedContextWebgl::MaybeUniformData(GLenum aFuncElemType,
 }
 
 inline void SharedContextWebgl::DrawQuad() {
+  FlushBatchedRects();
   mWebgl->DrawArraysInstanced(LOCAL_GL_TRIANGLE_FAN, 0, 4, 1);
 }
 
 void SharedContextWebgl::DrawTriangles(const PathVertexRange& aRange) {
+  FlushBatchedRects();
   mWebgl->DrawArraysInstanced(LOCAL_GL_TRIANGLES, GLint(aRange.mOffset),
                               GLsizei(aRange.mLength), 1);
 }
 
+// Queues a solid color rectangle with the given transform to be drawn in the
+// next instanced draw of the batched rectangles, if it doesn't need a clip
+// mask. Returns whether the rectangle was queued.
+bool SharedContextWebgl::BatchRect(const Matrix& aXform,
+                                   const DeviceColor& aColor) {
+  if (!mBatchRects || !mBatchedRectProgram || HasClipMask()) {
+    return false;
+  }
+  // The scissor and blend state changes already drew the batch if they had
+  // to, but the AA clip bounds are supplied when the batch is drawn.
+  if (!mBatchedRectData.empty() &&
+      !mBatchedRectClipAARect.IsEqualEdges(mClipAARect)) {
+    DrawBatchedRects();
+  }
+  mBatchedRectClipAARect = mClipAARect;
+  const float data[kBatchedRectFloats] = {
+      aXform._11, aXform._12, aXform._21, aXform._22, aXform._31,
+      aXform._32, aColor.b,   aColor.g,   aColor.r,   aColor.a};
+  mBatchedRectData.insert(mBatchedRectData.end(), data,
+                          data + kBatchedRectFloats);
+  if (mBatchedRectData.size() >= kMaxBatchedRects * kBatchedRectFloats) {
+    DrawBatchedRects();
+  }
+  return true;
+}
+
+// Draws all the batched rectangles with a single instanced draw call. Any
+// state change that would affect them draws them first, so the current
+// scissor and blend state are still the ones they were queued with.
+void SharedContextWebgl::DrawBatchedRects() {
+  // Take the batch first, so that the state changes below don't try to draw
+  // it again.
+  std::vector<float> data = std::move(mBatchedRectData);
+  mBatchedRectData.clear();
+
+  if (mLastProgram != mBatchedRectProgram) {
+    mWebgl->UseProgram(mBatchedRectProgram);
+    mLastProgram = mBatchedRectProgram;
+  }
+  Array<float, 2> viewportData = {float(mViewportSize.width),
+                                  float(mViewportSize.height)};
+  MaybeUniformData(LOCAL_GL_FLOAT_VEC2, mBatchedRectProgramViewport,
+                   viewportData, mBatchedRectProgramUniformState.mViewport);
+  Array<float, 4> clipData = {mBatchedRectClipAARect.x - 0.5f,
+                              mBatchedRectClipAARect.y - 0.5f,
+                              mBatchedRectClipAARect.XMost() + 0.5f,
+                              mBatchedRectClipAARect.YMost() + 0.5f};
+  MaybeUniformData(LOCAL_GL_FLOAT_VEC4, mBatchedRectProgramClipBounds,
+                   clipData, mBatchedRectProgramUniformState.mClipBounds);
+
+  // Orphan the contents of the instance buffer, which the previous batch may
+  // still be using, before uploading the new instances.
+  mWebgl->BindBuffer(LOCAL_GL_ARRAY_BUFFER, mBatchedRectBuffer.get());
+  mWebgl->UninitializedBufferData_SizeOnly(
+      LOCAL_GL_ARRAY_BUFFER, kBatchedRectBufferSize, LOCAL_GL_STREAM_DRAW);
+  mWebgl->BufferSubData(LOCAL_GL_ARRAY_BUFFER, 0, data.size() * sizeof(float),
+                        (const uint8_t*)data.data());
+  mWebgl->BindVertexArray(mBatchedRectVertexArray.get());
+  mWebgl->DrawArraysInstanced(LOCAL_GL_TRIANGLE_FAN, 0, 4,
+                              GLsizei(data.size() / kBatchedRectFloats));
+  mWebgl->BindVertexArray(mPathVertexArray.get());
+  mWebgl->BindBuffer(LOCAL_GL_ARRAY_BUFFER, mPathVertexBuffer.get());
+
+  // Keep the storage for the next batch.
+  data.clear();
+  mBatchedRectData = std::move(data);
+}
+
 // Common rectangle and pattern drawing function shared by many DrawTarget
 // commands. If aMaskColor is specified, the provided surface pattern will be
 // treated as a mask. If aHandle is specified, then the surface pattern's
@@ -2390,6 +2610,7 @@ bool SharedContextWebgl::DrawRectAccel(
               color =
                   PremultiplyColor(mCurrentTarget->GetClearPattern().mColor);
             }
+            FlushBatchedRects();
             mWebgl->ClearColor(color.b, color.g, color.r, color.a);
             mWebgl->Clear(LOCAL_GL_COLOR_BUFFER_BIT);
             success = true;
@@ -2409,6 +2630,16 @@ bool SharedContextWebgl::DrawRectAccel(
         color = DeviceColor(1, 1, 1, 1);
       }
       SetBlendState(aOptions.mCompositionOp, blendColor);
+      Matrix xform(aRect.width, 0.0f, 0.0f, aRect.height, aRect.x, aRect.y);
+      if (aTransformed) {
+        xform *= rectXform;
+      }
+      // Simple filled rectangles may be drawn along with other rectangles in
+      // a single instanced draw call.
+      if (!aVertexRange && BatchRect(xform, color)) {
+        success = true;
+        break;
+      }
       // Since it couldn't be mapped to a scissored clear, we need to use the
       // solid color shader with supplied transform.
       if (mLastProgram != mSolidProgram) {
@@ -2434,10 +2665,6 @@ bool SharedContextWebgl::DrawRectAccel(
                        mSolidProgramUniformState.mClipBounds);
 
       Array<float, 4> colorData = {color.b, color.g, color.r, color.a};
-      Matrix xform(aRect.width, 0.0f, 0.0f, aRect.height, aRect.x, aRect.y);
-      if (aTransformed) {
-        xform *= rectXform;
-      }
       Array<float, 6> xformData = {xform._11, xform._12, xform._21,
                                    xform._22, xform._31, xform._32};
       MaybeUniformData(LOCAL_GL_FLOAT_VEC2, mSolidProgramTransform, xformData,
@@ -2981,6 +3208,43 @@ HashNumber PathCacheEntry::HashPath(const QuantizedPath& aPath,
   return hash;
 }
 
+// Hashes the Skia path and the transform a path is quantized from. Unlike
+// HashPath, this hashes all of the path data, as matching entries by their
+// source is only worthwhile if it is cheaper than quantizing the path.
+HashNumber PathCacheEntry::HashSource(const SkPath& aSourcePath,
+                                      const Matrix& aSourceTransform) {
+  HashNumber hash = HashBytes(&aSourceTransform, sizeof(aSourceTransform));
+  hash = AddToHash(hash, int(aSourcePath.getFillType()));
+  SkPath::RawIter iter(aSourcePath);
+  SkPoint params[4];
+  SkPath::Verb verb;
+  while ((verb = iter.next(params)) != SkPath::kDone_Verb) {
+    hash = AddToHash(hash, int(verb));
+    switch (verb) {
+      case SkPath::kMove_Verb:
+        hash = AddToHash(hash, HashBytes(params, sizeof(SkPoint)));
+        break;
+      case SkPath::kLine_Verb:
+        hash = AddToHash(hash, HashBytes(&params[1], sizeof(SkPoint)));
+        break;
+      case SkPath::kConic_Verb: {
+        float w = iter.conicWeight();
+        hash = AddToHash(hash, HashBytes(&w, sizeof(w)));
+        [[fallthrough]];
+      }
+      case SkPath::kQuad_Verb:
+        hash = AddToHash(hash, HashBytes(&params[1], 2 * sizeof(SkPoint)));
+        break;
+      case SkPath::kCubic_Verb:
+        hash = AddToHash(hash, HashBytes(&params[1], 3 * sizeof(SkPoint)));
+        break;
+      default:
+        break;
+    }
+  }
+  return hash;
+}
+
 // When caching rendered geometry, we need to ensure the scale and orientation
 // is approximately the same. The offset will be considered separately.
 static inline bool HasMatchingScale(const Matrix& aTransform1,
@@ -2998,7 +3262,35 @@ inline bool PathCacheEntry::MatchesPath(
     const StrokeOptions* aStrokeOptions, AAStrokeMode aStrokeMode,
     const Matrix& aTransform, const IntRect& aBounds, const Point& aOrigin,
     HashNumber aHash, float aSigma) {
-  return aHash == mHash && HasMatchingScale(aTransform, mTransform) &&
+  return aHash == mHash &&
+         MatchesState(aPattern, aStrokeOptions, aStrokeMode, aTransform,
+                      aBounds, aOrigin, aSigma) &&
+         aPath == mPath;
+}
+
+// Determines if an existing path cache entry was last quantized from the same
+// Skia path and transform, in which case the quantized paths are the same.
+inline bool PathCacheEntry::MatchesSource(
+    const SkPath& aSourcePath, const Matrix& aSourceTransform,
+    HashNumber aSourceHash, const Pattern* aPattern,
+    const StrokeOptions* aStrokeOptions, AAStrokeMode aStrokeMode,
+    const Matrix& aTransform, const IntRect& aBounds, const Point& aOrigin,
+    float aSigma) {
+  return aSourceHash == mSourceHash && aSourceTransform == mSourceTransform &&
+         MatchesState(aPattern, aStrokeOptions, aStrokeMode, aTransform,
+                      aBounds, aOrigin, aSigma) &&
+         aSourcePath == mSourcePath;
+}
+
+// Determines if the pattern and drawing parameters of an incoming path match
+// those of the entry.
+inline bool PathCacheEntry::MatchesState(const Pattern* aPattern,
+                                         const StrokeOptions* aStrokeOptions,
+                                         AAStrokeMode aStrokeMode,
+                                         const Matrix& aTransform,
+                                         const IntRect& aBounds,
+                                         const Point& aOrigin, float aSigma) {
+  return HasMatchingScale(aTransform, mTransform) &&
          // Ensure the clipped relative bounds fit inside those of the entry
          aBounds.x - aOrigin.x >= mBounds.x - mOrigin.x &&
          (aBounds.x - aOrigin.x) + aBounds.width <=
@@ -3006,7 +3298,6 @@ inline bool PathCacheEntry::MatchesPath(
          aBounds.y - aOrigin.y >= mBounds.y - mOrigin.y &&
          (aBounds.y - aOrigin.y) + aBounds.height <=
              (mBounds.y - mOrigin.y) + mBounds.height &&
-         aPath == mPath &&
          (!aPattern ? !mPattern : mPattern && *aPattern == *mPattern) &&
          (!aStrokeOptions
               ? !mStrokeOptions
@@ -3067,6 +3358,38 @@ already_AddRefed<PathCacheEntry> PathCache::FindOrInsertEntry(
   return entry.forget();
 }
 
+already_AddRefed<PathCacheEntry> PathCache::FindRecentEntry(
+    const SkPath& aSourcePath, const Matrix& aSourceTransform,
+    HashNumber aSourceHash, const Pattern* aPattern,
+    const StrokeOptions* aStrokeOptions, AAStrokeMode aStrokeMode,
+    const Matrix& aTransform, const IntRect& aBounds, const Point& aOrigin,
+    float aSigma) {
+  RefPtr<PathCacheEntry>& recent =
+      mRecentEntries[aSourceHash % kNumRecentEntries];
+  if (!recent) {
+    return nullptr;
+  }
+  if (!recent->isInList()) {
+    // The entry was removed from the cache, so don't keep it alive.
+    recent = nullptr;
+    return nullptr;
+  }
+  if (!recent->MatchesSource(aSourcePath, aSourceTransform, aSourceHash,
+                             aPattern, aStrokeOptions, aStrokeMode, aTransform,
+                             aBounds, aOrigin, aSigma)) {
+    return nullptr;
+  }
+  return do_AddRef(recent);
+}
+
+void PathCache::SetRecentEntry(PathCacheEntry* aEntry,
+                               const SkPath& aSourcePath,
+                               const Matrix& aSourceTransform,
+                               HashNumber aSourceHash) {
+  aEntry->SetSource(aSourcePath, aSourceTransform, aSourceHash);
+  mRecentEntries[aSourceHash % kNumRecentEntries] = aEntry;
+}
+
 void DrawTargetWebgl::Fill(const Path* aPath, const Pattern& aPattern,
                            const DrawOptions& aOptions) {
   if (!aPath || aPath->GetBackendType() != BackendType::SKIA) {
@@ -3430,6 +3753,7 @@ static inline AAStrokeMode SupportsAAStroke(const Pattern& aPattern,
 // drawing.
 already_AddRefed<TextureHandle> SharedContextWebgl::DrawStrokeMask(
     const PathVertexRange& aVertexRange, const IntSize& aSize) {
+  FlushBatchedRects();
   // Allocate a new texture handle to store the rendered mask.
   RefPtr<TextureHandle> handle =
       AllocateTextureHandle(SurfaceFormat::A8, aSize, true, true);
@@ -3583,19 +3907,33 @@ bool SharedContextWebgl::DrawPathAccel(
     if (!mPathCache) {
       mPathCache = MakeUnique<PathCache>();
     }
-    // Use a quantized, relative (to its bounds origin) version of the path as
-    // a cache key to help limit cache bloat.
-    Maybe<QuantizedPath> qp = GenerateQuantizedPath(
-        mWGRPathBuilder, pathSkia->GetPath(), quantBounds, pathXform);
-    if (!qp) {
-      return false;
-    }
-    entry = mPathCache->FindOrInsertEntry(
-        std::move(*qp), color ? nullptr : &aPattern, aStrokeOptions,
-        aaStrokeMode, currentTransform, intBounds, quantizedOrigin,
-        aShadow ? aShadow->mSigma : -1.0f);
+    const SkPath& skiaPath = pathSkia->GetPath();
+    const Pattern* pattern = color ? nullptr : &aPattern;
+    float sigma = aShadow ? aShadow->mSigma : -1.0f;
+    // Paths that are redrawn every frame quantize to the same path as before,
+    // as long as the transform relative to their bounds stays the same, so
+    // look for the entry they were last drawn with first.
+    Matrix sourceXform = pathXform;
+    sourceXform.PostTranslate(-quantBounds.TopLeft());
+    HashNumber sourceHash = PathCacheEntry::HashSource(skiaPath, sourceXform);
+    entry = mPathCache->FindRecentEntry(
+        skiaPath, sourceXform, sourceHash, pattern, aStrokeOptions,
+        aaStrokeMode, currentTransform, intBounds, quantizedOrigin, sigma);
     if (!entry) {
-      return false;
+      // Use a quantized, relative (to its bounds origin) version of the path
+      // as a cache key to help limit cache bloat.
+      Maybe<QuantizedPath> qp = GenerateQuantizedPath(
+          mWGRPathBuilder, skiaPath, quantBounds, pathXform);
+      if (!qp) {
+        return false;
+      }
+      entry = mPathCache->FindOrInsertEntry(
+          std::move(*qp), pattern, aStrokeOptions, aaStrokeMode,
+          currentTransform, intBounds, quantizedOrigin, sigma);
+      if (!entry) {
+        return false;
+      }
+      mPathCache->SetRecentEntry(entry, skiaPath, sourceXform, sourceHash);
     }
     handle = entry->GetHandle();
   }
@@ -4971,6 +5309,7 @@ void SharedContextWebgl::CachePrefs() {
 
   mPathAAStroke = StaticPrefs::gfx_canvas_accelerated_aa_stroke_enabled();
   mPathWGRStroke = StaticPrefs::gfx_canvas_accelerated_stroke_to_fill_path();
+  mBatchRects = StaticPrefs::gfx_canvas_accelerated_batch_rects();
 }
 
 // For use within CanvasRenderingContext2D, called on BorrowDrawTarget.
@@ -5009,6 +5348,7 @@ void DrawTargetWebgl::EndFrame() {
   // Ensure we're not somehow using more than the allowed texture memory.
   mSharedContext->PruneTextureMemory();
   // Signal that we're done rendering the frame in case no present occurs.
+  mSharedContext->FlushBatchedRects();
   mSharedContext->mWebgl->EndOfFrame();
   // Check if we need to clear out any cached because of memory pressure.
   mSharedContext->ClearCachesIfNecessary();
@@ -5031,6 +5371,7 @@ bool DrawTargetWebgl::CopyToSwapChain(
       StaticPrefs::gfx_canvas_accelerated_async_present();
   options.remoteTextureId = aId;
   options.remoteTextureOwnerId = aOwnerId;
+  mSharedContext->FlushBatchedRects();
   return mSharedContext->mWebgl->CopyToSwapChain(mFramebuffer, aTextureType,
                                                  options, aOwnerClient);
 }
@@ -149,6 +149,9 @@ class SharedContextWebgl : public mozilla::RefCounted<SharedContextWebgl>,
   Maybe<uint32_t> mImageProgramSampler;
   Maybe<uint32_t> mImageProgramClipMask;
   Maybe<uint32_t> mImageProgramClipBounds;
+  RefPtr<WebGLProgram> mBatchedRectProgram;
+  Maybe<uint32_t> mBatchedRectProgramViewport;
+  Maybe<uint32_t> mBatchedRectProgramClipBounds;
 
   struct SolidProgramUniformState {
     Maybe<Array<float, 2>> mViewport;
@@ -169,6 +172,22 @@ class SharedContextWebgl : public mozilla::RefCounted<SharedContextWebgl>,
     Maybe<Array<float, 4>> mClipBounds;
   } mImageProgramUniformState;
 
+  struct BatchedRectProgramUniformState {
+    Maybe<Array<float, 2>> mViewport;
+    Maybe<Array<float, 4>> mClipBounds;
+  } mBatchedRectProgramUniformState;
+
+  // Solid color rectangles waiting to be drawn by a single instanced draw,
+  // stored as per-instance vertex data, and the buffer and vertex state used
+  // to draw them.
+  std::vector<float> mBatchedRectData;
+  // The AA clip rect the batched rectangles were queued with.
+  Rect mBatchedRectClipAARect;
+  RefPtr<WebGLBuffer> mBatchedRectBuffer;
+  RefPtr<WebGLVertexArray> mBatchedRectVertexArray;
+  // Whether to batch solid color rectangles.
+  bool mBatchRects = true;
+
   // Scratch framebuffer used to wrap textures for miscellaneous utility ops.
   RefPtr<WebGLFramebuffer> mScratchFramebuffer;
   // Buffer filled with zero data for initializing textures.
@@ -228,6 +247,7 @@ class SharedContextWebgl : public mozilla::RefCounted<SharedContextWebgl>,
 
   bool Initialize();
   bool CreateShaders();
+  bool CreateBatchedRectProgram();
   void ResetPathVertexBuffer();
 
   void BlendFunc(GLenum aSrcFactor, GLenum aDstFactor);
@@ -295,6 +315,14 @@ class SharedContextWebgl : public mozilla::RefCounted<SharedContextWebgl>,
       bool aRenderable = false);
   void DrawQuad();
   void DrawTriangles(const PathVertexRange& aRange);
+  bool BatchRect(const Matrix& aXform, const DeviceColor& aColor);
+  void DrawBatchedRects();
+  void FlushBatchedRects() {
+    if (!mBatchedRectData.empty()) {
+      DrawBatchedRects();
+    }
+  }
+  void DiscardBatchedRects() { mBatchedRectData.clear(); }
   bool DrawRectAccel(const Rect& aRect, const Pattern& aPattern,
                      const DrawOptions& aOptions,
                      Maybe<DeviceColor> aMaskColor = Nothing(),
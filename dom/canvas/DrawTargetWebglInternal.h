@@ -412,12 +412,31 @@ class PathCacheEntry : public CacheEntryImpl<PathCacheEntry> {
                    const IntRect& aBounds, const Point& aOrigin,
                    HashNumber aHash, float aSigma);
 
+  bool MatchesSource(const SkPath& aSourcePath,
+                     const Matrix& aSourceTransform, HashNumber aSourceHash,
+                     const Pattern* aPattern,
+                     const StrokeOptions* aStrokeOptions,
+                     AAStrokeMode aStrokeMode, const Matrix& aTransform,
+                     const IntRect& aBounds, const Point& aOrigin,
+                     float aSigma);
+
   static HashNumber HashPath(const QuantizedPath& aPath,
                              const Pattern* aPattern, const Matrix& aTransform,
                              const IntRect& aBounds, const Point& aOrigin);
 
+  static HashNumber HashSource(const SkPath& aSourcePath,
+                               const Matrix& aSourceTransform);
+
   const QuantizedPath& GetPath() const { return mPath; }
 
+  // Remember the path and transform the entry was last quantized from.
+  void SetSource(const SkPath& aSourcePath, const Matrix& aSourceTransform,
+                 HashNumber aSourceHash) {
+    mSourcePath = aSourcePath;
+    mSourceTransform = aSourceTransform;
+    mSourceHash = aSourceHash;
+  }
+
   const Point& GetOrigin() const { return mOrigin; }
 
   // Valid if either a mask (no pattern) or there is valid pattern.
@@ -427,8 +446,19 @@ class PathCacheEntry : public CacheEntryImpl<PathCacheEntry> {
   void SetVertexRange(const PathVertexRange& aRange) { mVertexRange = aRange; }
 
  private:
+  bool MatchesState(const Pattern* aPattern,
+                    const StrokeOptions* aStrokeOptions,
+                    AAStrokeMode aStrokeMode, const Matrix& aTransform,
+                    const IntRect& aBounds, const Point& aOrigin,
+                    float aSigma);
+
   // The actual path geometry supplied
   QuantizedPath mPath;
+  // The Skia path the entry was last quantized from, with the transform that
+  // was applied to it relative to the bounds origin
+  SkPath mSourcePath;
+  Matrix mSourceTransform;
+  HashNumber mSourceHash = 0;
   // The transformed origin of the path
   Point mOrigin;
   // The pattern used to rasterize the path, if not a mask
@@ -453,7 +483,24 @@ class PathCache : public CacheImpl<PathCacheEntry, true> {
       const Matrix& aTransform, const IntRect& aBounds, const Point& aOrigin,
       float aSigma = -1.0f);
 
+  // Look for an entry that was recently quantized from the same Skia path
+  // and transform, which avoids quantizing the path again to find it.
+  already_AddRefed<PathCacheEntry> FindRecentEntry(
+      const SkPath& aSourcePath, const Matrix& aSourceTransform,
+      HashNumber aSourceHash, const Pattern* aPattern,
+      const StrokeOptions* aStrokeOptions, AAStrokeMode aStrokeMode,
+      const Matrix& aTransform, const IntRect& aBounds, const Point& aOrigin,
+      float aSigma = -1.0f);
+  void SetRecentEntry(PathCacheEntry* aEntry, const SkPath& aSourcePath,
+                      const Matrix& aSourceTransform, HashNumber aSourceHash);
+
   void ClearVertexRanges();
+
+ private:
+  static constexpr size_t kNumRecentEntries = 256;
+
+  // Entries that were recently quantized, indexed by their source hash.
+  RefPtr<PathCacheEntry> mRecentEntries[kNumRecentEntries];
 };
 
 }  // namespace mozilla::gfx
@@ -360,7 +360,12 @@ OffscreenCanvasDisplayHelper::TransformSurface(gfx::SourceSurface* aSurface,
     return do_AddRef(aSurface);
   }
 
-  // Otherwise we need to copy and apply the necessary transformations.
+  // Otherwise we need to apply the necessary transformations. If the surface
+  // is a heap copy that nothing else refers to, such as a snapshot read back
+  // from WebGL or copied from the worker, then we can transform it in place
+  // rather than copying the frame again.
+  bool inPlace = aSurface->GetType() == gfx::SurfaceType::DATA_ALIGNED &&
+                 aSurface->hasOneRef();
   RefPtr<gfx::DataSourceSurface> srcSurface = aSurface->GetDataSurface();
   if (!srcSurface) {
     return nullptr;
@@ -370,39 +375,51 @@ OffscreenCanvasDisplayHelper::TransformSurface(gfx::SourceSurface* aSurface,
   const auto format = srcSurface->GetFormat();
 
   RefPtr<gfx::DataSourceSurface> dstSurface =
-      gfx::Factory::CreateDataSourceSurface(size, format, /* aZero */ false);
+      inPlace ? srcSurface
+              : gfx::Factory::CreateDataSourceSurface(size, format,
+                                                      /* aZero */ false);
   if (!dstSurface) {
     return nullptr;
   }
 
-  gfx::DataSourceSurface::ScopedMap srcMap(srcSurface,
-                                           gfx::DataSourceSurface::READ);
-  gfx::DataSourceSurface::ScopedMap dstMap(dstSurface,
-                                           gfx::DataSourceSurface::WRITE);
-  if (!srcMap.IsMapped() || !dstMap.IsMapped()) {
+  gfx::DataSourceSurface::ScopedMap dstMap(
+      dstSurface, inPlace ? gfx::DataSourceSurface::READ_WRITE
+                          : gfx::DataSourceSurface::WRITE);
+  if (!dstMap.IsMapped()) {
     return nullptr;
   }
+  const uint8_t* srcData = dstMap.GetData();
+  int32_t srcStride = dstMap.GetStride();
+  Maybe<gfx::DataSourceSurface::ScopedMap> srcMap;
+  if (!inPlace) {
+    srcMap.emplace(srcSurface, gfx::DataSourceSurface::READ);
+    if (!srcMap->IsMapped()) {
+      return nullptr;
+    }
+    srcData = srcMap->GetData();
+    srcStride = srcMap->GetStride();
+  }
 
   bool success;
   switch (aOriginPos) {
     case gl::OriginPos::BottomLeft:
       if (aHasAlpha && !aIsAlphaPremult) {
-        success = gfx::PremultiplyYFlipData(
-            srcMap.GetData(), srcMap.GetStride(), format, dstMap.GetData(),
-            dstMap.GetStride(), format, size);
+        success = gfx::PremultiplyYFlipData(srcData, srcStride, format,
+                                            dstMap.GetData(),
+                                            dstMap.GetStride(), format, size);
       } else {
-        success = gfx::SwizzleYFlipData(srcMap.GetData(), srcMap.GetStride(),
-                                        format, dstMap.GetData(),
-                                        dstMap.GetStride(), format, size);
+        success = gfx::SwizzleYFlipData(srcData, srcStride, format,
+                                        dstMap.GetData(), dstMap.GetStride(),
+                                        format, size);
       }
       break;
     case gl::OriginPos::TopLeft:
       if (aHasAlpha && !aIsAlphaPremult) {
-        success = gfx::PremultiplyData(srcMap.GetData(), srcMap.GetStride(),
-                                       format, dstMap.GetData(),
-                                       dstMap.GetStride(), format, size);
+        success = gfx::PremultiplyData(srcData, srcStride, format,
+                                       dstMap.GetData(), dstMap.GetStride(),
+                                       format, size);
       } else {
-        success = gfx::SwizzleData(srcMap.GetData(), srcMap.GetStride(), format,
+        success = gfx::SwizzleData(srcData, srcStride, format,
                                    dstMap.GetData(), dstMap.GetStride(), format,
                                    size);
       }
@@ -65,6 +65,9 @@ Maybe<Range<uint8_t>> WebGLChild::AllocPendingCmdBytes(
   const auto required = mPendingCmdsPos + size;
   if (required > range.length()) {
     FlushPendingCmds();
+    if (mPendingCmdsShmem.Size() < size) {
+      mPendingCmdsShmem = {};
+    }
     return AllocPendingCmdBytes(size, fyiAlignmentOverhead);
   }
   itr = range.begin() + mPendingCmdsPos;
@@ -75,11 +78,19 @@ Maybe<Range<uint8_t>> WebGLChild::AllocPendingCmdBytes(
 }
 
 void WebGLChild::FlushPendingCmds() {
-  if (!mPendingCmdsShmem.Size()) return;
+  if (!mPendingCmdsShmem.Size() || !mPendingCmdsPos) return;
 
   const auto byteSize = mPendingCmdsPos;
-  SendDispatchCommands(std::move(mPendingCmdsShmem), byteSize);
-  mPendingCmdsShmem = {};
+  if (byteSize < mozilla::ipc::BigBuffer::kShmemThreshold) {
+    // Small batches are copied into the message, so that we keep filling the
+    // same buffer rather than allocate and map new shmem for every flush.
+    SendDispatchCommands(
+        mozilla::ipc::BigBuffer(mPendingCmdsShmem.AsSpan().To(byteSize)),
+        byteSize);
+  } else {
+    SendDispatchCommands(std::move(mPendingCmdsShmem), byteSize);
+    mPendingCmdsShmem = {};
+  }
 
   mFlushedCmdInfo.flushes += 1;
   mFlushedCmdInfo.flushedCmdBytes += byteSize;
@@ -144,6 +155,9 @@ void WebGLChild::FlushPendingCmds() {
         mFlushedCmdInfo.flushedCmdBytes, 100 * totalOverheadRatio,
         mFlushedCmdInfo.flushes);
   }
+
+  mPendingCmdsPos = 0;
+  mPendingCmdsAlignmentOverhead = 0;
 }
 
 // -
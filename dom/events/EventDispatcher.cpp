@@ -302,6 +302,24 @@ class EventTargetChainItem {
                                      EventDispatchingCallback* aCallback,
                                      ELMCreationDetector& aCd);
 
+  /**
+   * Whether HandleEvent may call a listener or WillHandleEvent for aEvent.
+   * Returns false if the listener manager of the item, if any, already knows
+   * that it has no listeners for the type of aEvent.
+   */
+  bool MayHaveListenersFor(WidgetEvent* aEvent, ELMCreationDetector& aCd) {
+    if (WantsWillHandleEvent()) {
+      return true;
+    }
+    if (!mManager) {
+      if (!MayHaveListenerManager() && !aCd.MayHaveNewListenerManager()) {
+        return false;
+      }
+      mManager = mTarget->GetExistingListenerManager();
+    }
+    return mManager && !mManager->KnowsNoListenersFor(aEvent);
+  }
+
   /**
    * Resets aVisitor object and calls GetEventTargetParent.
    * Copies mItemFlags and mItemData to the current EventTargetChainItem.
@@ -376,6 +394,26 @@ class EventTargetChainItem {
   MOZ_CAN_RUN_SCRIPT void PostHandleEvent(EventChainPostVisitor& aVisitor);
 
  private:
+  /**
+   * Whether any item in aChain may have a listener for aEvent in the default
+   * event group.  Events like pointermove are dispatched at a high rate to
+   * targets whose ancestors have no listeners for them, and the capture,
+   * target and bubble phases can be skipped then, since they only retarget
+   * the event for the listeners.  Default handling happens in the system
+   * group.
+   */
+  static bool MayHaveListenersInDefaultGroup(
+      nsTArray<EventTargetChainItem>& aChain, WidgetEvent* aEvent,
+      ELMCreationDetector& aCd);
+
+  /**
+   * Runs the capture, target and bubble phases of the current event group.
+   */
+  MOZ_CAN_RUN_SCRIPT
+  static void HandleEventTargetChainPhases(
+      nsTArray<EventTargetChainItem>& aChain, EventChainPostVisitor& aVisitor,
+      WidgetTouchEvent* aTouchEvent, ELMCreationDetector& aCd);
+
   const nsCOMPtr<EventTarget> mTarget;
   nsCOMPtr<EventTarget> mRetargetedRelatedTarget;
   Maybe<nsTArray<RefPtr<EventTarget>>> mRetargetedTouchTargets;
@@ -489,26 +527,23 @@ void EventTargetChainItem::PostHandleEvent(EventChainPostVisitor& aVisitor) {
   MOZ_ASSERT(mItemData == aVisitor.mItemData);
 }
 
-void EventTargetChainItem::HandleEventTargetChain(
-    nsTArray<EventTargetChainItem>& aChain, EventChainPostVisitor& aVisitor,
-    EventDispatchingCallback* aCallback, ELMCreationDetector& aCd) {
-  // Save the target so that it can be restored later.
-  nsCOMPtr<EventTarget> firstTarget = aVisitor.mEvent->mTarget;
-  nsCOMPtr<EventTarget> firstRelatedTarget = aVisitor.mEvent->mRelatedTarget;
-  Maybe<AutoTArray<nsCOMPtr<EventTarget>, 10>> firstTouchTargets;
-  WidgetTouchEvent* touchEvent = nullptr;
-  if (aVisitor.mEvent->mClass == eTouchEventClass) {
-    touchEvent = aVisitor.mEvent->AsTouchEvent();
-    if (!aVisitor.mEvent->mFlags.mInSystemGroup) {
-      firstTouchTargets.emplace();
-      WidgetTouchEvent* touchEvent = aVisitor.mEvent->AsTouchEvent();
-      WidgetTouchEvent::TouchArray& touches = touchEvent->mTouches;
-      for (uint32_t i = 0; i < touches.Length(); ++i) {
-        firstTouchTargets->AppendElement(touches[i]->mTarget);
-      }
+bool EventTargetChainItem::MayHaveListenersInDefaultGroup(
+    nsTArray<EventTargetChainItem>& aChain, WidgetEvent* aEvent,
+    ELMCreationDetector& aCd) {
+  if (aEvent->mFlags.mOnlySystemGroupDispatch) {
+    return false;
+  }
+  for (EventTargetChainItem& item : aChain) {
+    if (!item.PreHandleEventOnly() && item.MayHaveListenersFor(aEvent, aCd)) {
+      return true;
     }
   }
+  return false;
+}
 
+void EventTargetChainItem::HandleEventTargetChainPhases(
+    nsTArray<EventTargetChainItem>& aChain, EventChainPostVisitor& aVisitor,
+    WidgetTouchEvent* aTouchEvent, ELMCreationDetector& aCd) {
   uint32_t chainLength = aChain.Length();
   EventTargetChainItem* chain = aChain.Elements();
   uint32_t firstCanHandleEventTargetIdx =
@@ -571,13 +606,13 @@ void EventTargetChainItem::HandleEventTargetChain(
         uint32_t childIndex = j - 1;
         if (chain[childIndex].HasRetargetTouchTargets()) {
           found = true;
-          chain[childIndex].RetargetTouchTargets(touchEvent,
-                                                 aVisitor.mDOMEvent);
+          chain[childIndex].RetargetTouchTargets(aTouchEvent,
+                                                  aVisitor.mDOMEvent);
           break;
         }
       }
       if (!found) {
-        WidgetTouchEvent::TouchArray& touches = touchEvent->mTouches;
+        WidgetTouchEvent::TouchArray& touches = aTouchEvent->mTouches;
         for (uint32_t i = 0; i < touches.Length(); ++i) {
           touches[i]->mTarget = touches[i]->mOriginalTarget;
         }
@@ -591,7 +626,7 @@ void EventTargetChainItem::HandleEventTargetChain(
   // Need to explicitly retarget touch targets so that initial targets get set
   // properly in case nothing else retargeted touches.
   if (targetItem.HasRetargetTouchTargets()) {
-    targetItem.RetargetTouchTargets(touchEvent, aVisitor.mDOMEvent);
+    targetItem.RetargetTouchTargets(aTouchEvent, aVisitor.mDOMEvent);
   }
   if (!aVisitor.mEvent->PropagationStopped() &&
       (!aVisitor.mEvent->mFlags.mNoContentDispatch ||
@@ -633,7 +668,7 @@ void EventTargetChainItem::HandleEventTargetChain(
     }
 
     if (item.HasRetargetTouchTargets()) {
-      item.RetargetTouchTargets(touchEvent, aVisitor.mDOMEvent);
+      item.RetargetTouchTargets(aTouchEvent, aVisitor.mDOMEvent);
     }
 
     if (aVisitor.mEvent->mFlags.mBubbles || newTarget) {
@@ -648,6 +683,32 @@ void EventTargetChainItem::HandleEventTargetChain(
     }
   }
   aVisitor.mEvent->mFlags.mInBubblingPhase = false;
+}
+
+void EventTargetChainItem::HandleEventTargetChain(
+    nsTArray<EventTargetChainItem>& aChain, EventChainPostVisitor& aVisitor,
+    EventDispatchingCallback* aCallback, ELMCreationDetector& aCd) {
+  // Save the target so that it can be restored later.
+  nsCOMPtr<EventTarget> firstTarget = aVisitor.mEvent->mTarget;
+  nsCOMPtr<EventTarget> firstRelatedTarget = aVisitor.mEvent->mRelatedTarget;
+  Maybe<AutoTArray<nsCOMPtr<EventTarget>, 10>> firstTouchTargets;
+  WidgetTouchEvent* touchEvent = nullptr;
+  if (aVisitor.mEvent->mClass == eTouchEventClass) {
+    touchEvent = aVisitor.mEvent->AsTouchEvent();
+    if (!aVisitor.mEvent->mFlags.mInSystemGroup) {
+      firstTouchTargets.emplace();
+      WidgetTouchEvent* touchEvent = aVisitor.mEvent->AsTouchEvent();
+      WidgetTouchEvent::TouchArray& touches = touchEvent->mTouches;
+      for (uint32_t i = 0; i < touches.Length(); ++i) {
+        firstTouchTargets->AppendElement(touches[i]->mTarget);
+      }
+    }
+  }
+
+  if (aVisitor.mEvent->mFlags.mInSystemGroup || touchEvent ||
+      MayHaveListenersInDefaultGroup(aChain, aVisitor.mEvent, aCd)) {
+    HandleEventTargetChainPhases(aChain, aVisitor, touchEvent, aCd);
+  }
 
   if (!aVisitor.mEvent->mFlags.mInSystemGroup &&
       aVisitor.mEvent->IsAllowedToDispatchInSystemGroup()) {
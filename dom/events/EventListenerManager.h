@@ -444,27 +444,35 @@ class EventListenerManager final : public EventListenerManagerBase {
       return;
     }
 
-    if (!aEvent->IsTrusted() && !mMayHaveListenersForUntrustedEvents) {
+    if (KnowsNoListenersFor(aEvent) || aEvent->PropagationStopped()) {
       return;
     }
 
+    HandleEventInternal(aPresContext, aEvent, aDOMEvent, aCurrentTarget,
+                        aEventStatus, aItemInShadowTree);
+  }
+
+  /**
+   * Whether HandleEvent is known to find no listener for aEvent, in any
+   * event group and phase.
+   */
+  bool KnowsNoListenersFor(const WidgetEvent* aEvent) const {
+    if (!aEvent->IsTrusted() && !mMayHaveListenersForUntrustedEvents) {
+      return true;
+    }
+
     // Check if we already know that there is no event listener for the event.
     if (aEvent->mMessage == eUnidentifiedEvent) {
       if (mNoListenerForEventAtom == aEvent->mSpecifiedEventType) {
-        return;
+        return true;
       }
     } else if (mNoListenerForEvents[0] == aEvent->mMessage ||
                mNoListenerForEvents[1] == aEvent->mMessage ||
                mNoListenerForEvents[2] == aEvent->mMessage) {
-      return;
-    }
-
-    if (mListenerMap.IsEmpty() || aEvent->PropagationStopped()) {
-      return;
+      return true;
     }
 
-    HandleEventInternal(aPresContext, aEvent, aDOMEvent, aCurrentTarget,
-                        aEventStatus, aItemInShadowTree);
+    return mListenerMap.IsEmpty();
   }
 
   /**
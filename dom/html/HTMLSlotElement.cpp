@@ -165,6 +165,26 @@ const nsTArray<RefPtr<nsINode>>& HTMLSlotElement::AssignedNodes() const {
   return mAssignedNodes;
 }
 
+Maybe<uint32_t> HTMLSlotElement::IndexOfAssignedNode(
+    const nsINode& aNode) const {
+  const uint32_t length = mAssignedNodes.Length();
+  // Try the last index we found and its neighbours first.
+  for (uint32_t index :
+       {mLastAssignedNodeIndex, mLastAssignedNodeIndex + 1,
+        mLastAssignedNodeIndex - 1}) {
+    if (index < length && mAssignedNodes[index] == &aNode) {
+      mLastAssignedNodeIndex = index;
+      return Some(index);
+    }
+  }
+  const auto index = mAssignedNodes.IndexOf(&aNode);
+  if (index == mAssignedNodes.NoIndex) {
+    return Nothing();
+  }
+  mLastAssignedNodeIndex = index;
+  return Some(uint32_t(index));
+}
+
 const nsTArray<nsINode*>& HTMLSlotElement::ManuallyAssignedNodes() const {
   return mManuallyAssignedNodes;
 }
@@ -343,7 +363,9 @@ void HTMLSlotElement::RemoveAssignedNode(nsIContent& aNode) {
   // hasn't been cleared.
   MOZ_ASSERT(!aNode.GetAssignedSlot() || aNode.GetAssignedSlot() == this,
              "How exactly?");
-  mAssignedNodes.RemoveElement(&aNode);
+  if (Maybe<uint32_t> index = IndexOfAssignedNode(aNode)) {
+    mAssignedNodes.RemoveElementAt(*index);
+  }
   aNode.SetAssignedSlot(nullptr);
 
   RecalculateHasSlottedState();
@@ -53,6 +53,10 @@ class HTMLSlotElement final : public nsGenericHTMLElement {
 
   // Helper methods
   const nsTArray<RefPtr<nsINode>>& AssignedNodes() const;
+  // The index of aNode in AssignedNodes().  Remembers the index it found, so
+  // that looking up the same node or one of its neighbours again, like
+  // iterators over the flattened tree do, costs O(1).
+  Maybe<uint32_t> IndexOfAssignedNode(const nsINode& aNode) const;
   const nsTArray<nsINode*>& ManuallyAssignedNodes() const;
   void InsertAssignedNode(uint32_t aIndex, nsIContent&);
   void AppendAssignedNode(nsIContent&);
@@ -78,6 +82,9 @@ class HTMLSlotElement final : public nsGenericHTMLElement {
   nsTArray<RefPtr<nsINode>> mAssignedNodes;
   nsTArray<nsINode*> mManuallyAssignedNodes;
 
+  // The index IndexOfAssignedNode found last, which may be stale.
+  mutable uint32_t mLastAssignedNodeIndex = 0;
+
   // Whether we're in the signal slot list of our unit of related similar-origin
   // browsing contexts.
   //
@@ -1868,6 +1868,10 @@ mozilla::ipc::IPCResult BackgroundRequestChild::Recv__delete__(
         HandleResponse(aResponse.get_ObjectStorePutResponse().key());
         break;
 
+      case RequestResponse::TObjectStorePutAllResponse:
+        HandleResponse(aResponse.get_ObjectStorePutAllResponse().keys());
+        break;
+
       case RequestResponse::TObjectStoreGetResponse:
         HandleResponse(
             std::move(aResponse.get_ObjectStoreGetResponse().cloneInfo()));
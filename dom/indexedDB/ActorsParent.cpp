@@ -3746,21 +3746,29 @@ class ObjectStoreAddOrPutRequestOp final : public NormalTransactionOp {
   };
   class SCInputStream;
 
-  ObjectStoreAddPutParams mParams;
-  Maybe<UniqueIndexTable> mUniqueIndexTable;
+  // What we keep for each record of mParams, at the same index.
+  struct Record final {
+    Maybe<UniqueIndexTable> mUniqueIndexTable;
+    nsTArray<StoredFileInfo> mStoredFileInfos;
+    Key mResponse;
+    bool mDataOverThreshold = false;
+  };
+
+  // Add and put requests write a single record.  Put-all requests write many
+  // records into the same objectStore, in one savepoint, so that importing
+  // lots of records doesn't need a request per record.
+  nsTArray<ObjectStoreAddPutParams> mParams;
+  nsTArray<Record> mRecords;
 
   // This must be non-const so that we can update the mNextAutoIncrementId field
   // if we are modifying an autoIncrement objectStore.
   SafeRefPtr<FullObjectStoreMetadata> mMetadata;
 
-  nsTArray<StoredFileInfo> mStoredFileInfos;
-
-  Key mResponse;
   const OriginMetadata mOriginMetadata;
   const PersistenceType mPersistenceType;
   const bool mOverwrite;
+  const bool mPutAll;
   bool mObjectStoreMayHaveIndexes;
-  bool mDataOverThreshold;
 
  private:
   // Only created by TransactionBase.
@@ -3770,7 +3778,19 @@ class ObjectStoreAddOrPutRequestOp final : public NormalTransactionOp {
 
   ~ObjectStoreAddOrPutRequestOp() override = default;
 
-  nsresult RemoveOldIndexDataValues(DatabaseConnection* aConnection);
+  nsresult RemoveOldIndexDataValues(DatabaseConnection* aConnection,
+                                    const ObjectStoreAddPutParams& aParams,
+                                    const Key& aKey);
+
+  bool InitRecord(TransactionBase& aTransaction,
+                  const ObjectStoreAddPutParams& aParams, Record& aRecord);
+
+  // Writes one record.  aNextAutoIncrementId is the id the record gets if
+  // the objectStore generates its key, and is updated for the next record.
+  nsresult WriteRecord(DatabaseConnection* aConnection,
+                       ObjectStoreAddPutParams& aParams, Record& aRecord,
+                       bool aObjectStoreHasIndexes,
+                       int64_t& aNextAutoIncrementId);
 
   bool Init(TransactionBase& aTransaction) override;
 
@@ -4262,6 +4282,17 @@ class CursorBase : public PBackgroundIDBCursorParent {
 
   const int32_t mMaxExtraCount;
 
+  // The number of extra records the next ContinueOp preloads.  The child
+  // only sends a plain continue() once it has used up the records preloaded
+  // for it, so every such request doubles this, up to
+  // kMaxExtraCountGrowth * mMaxExtraCount, and long scans need fewer and fewer
+  // round trips.  Continuing to a key or advancing by more than one record
+  // resets it to mMaxExtraCount.  This is only touched on the connection
+  // thread, by one op at a time.
+  uint32_t mExtraCount;
+
+  static constexpr uint32_t kMaxExtraCountGrowth = 16;
+
   const bool mIsSameProcessActor;
 
   struct ConstructFromTransactionBase {};
@@ -10108,6 +10139,26 @@ bool TransactionBase::VerifyRequestParams(const RequestParams& aParams) const {
       break;
     }
 
+    case RequestParams::TObjectStorePutAllParams: {
+      const nsTArray<ObjectStoreAddPutParams>& records =
+          aParams.get_ObjectStorePutAllParams().records();
+      if (NS_AUUF_OR_WARN_IF(records.IsEmpty())) {
+        return false;
+      }
+
+      for (const ObjectStoreAddPutParams& params : records) {
+        if (NS_AUUF_OR_WARN_IF(params.objectStoreId() !=
+                               records[0].objectStoreId())) {
+          return false;
+        }
+
+        if (NS_AUUF_OR_WARN_IF(!VerifyRequestParams(params))) {
+          return false;
+        }
+      }
+      break;
+    }
+
     case RequestParams::TObjectStoreGetParams: {
       const ObjectStoreGetParams& params = aParams.get_ObjectStoreGetParams();
       const SafeRefPtr<FullObjectStoreMetadata> objectStoreMetadata =
@@ -10494,6 +10545,7 @@ PBackgroundIDBRequestParent* TransactionBase::AllocRequest(
   switch (aParams.type()) {
     case RequestParams::TObjectStoreAddParams:
     case RequestParams::TObjectStorePutParams:
+    case RequestParams::TObjectStorePutAllParams:
       actor = new ObjectStoreAddOrPutRequestOp(SafeRefPtrFromThis(), aRequestId,
                                                std::move(aParams));
       break;
@@ -11439,6 +11491,7 @@ CursorBase::CursorBase(SafeRefPtr<TransactionBase> aTransaction,
       mObjectStoreId((*mObjectStoreMetadata)->mCommonMetadata.id()),
       mDirection(aDirection),
       mMaxExtraCount(IndexedDatabaseManager::MaxPreloadExtraRecords()),
+      mExtraCount(mMaxExtraCount),
       mIsSameProcessActor(!BackgroundParent::IsOtherProcessActor(
           mTransaction->GetBackgroundParent())) {
   AssertIsOnBackgroundThread();
@@ -18822,40 +18875,60 @@ ObjectStoreAddOrPutRequestOp::ObjectStoreAddOrPutRequestOp(
     SafeRefPtr<TransactionBase> aTransaction, const int64_t aRequestId,
     RequestParams&& aParams)
     : NormalTransactionOp(std::move(aTransaction), aRequestId),
-      mParams(
-          std::move(aParams.type() == RequestParams::TObjectStoreAddParams
-                        ? aParams.get_ObjectStoreAddParams().commonParams()
-                        : aParams.get_ObjectStorePutParams().commonParams())),
       mOriginMetadata(Transaction().GetDatabase().OriginMetadata()),
       mPersistenceType(Transaction().GetDatabase().Type()),
-      mOverwrite(aParams.type() == RequestParams::TObjectStorePutParams),
+      mOverwrite(aParams.type() != RequestParams::TObjectStoreAddParams),
+      mPutAll(aParams.type() == RequestParams::TObjectStorePutAllParams),
       mObjectStoreMayHaveIndexes(false) {
-  MOZ_ASSERT(aParams.type() == RequestParams::TObjectStoreAddParams ||
-             aParams.type() == RequestParams::TObjectStorePutParams);
+  switch (aParams.type()) {
+    case RequestParams::TObjectStoreAddParams:
+      mParams.AppendElement(
+          std::move(aParams.get_ObjectStoreAddParams().commonParams()));
+      break;
+
+    case RequestParams::TObjectStorePutParams:
+      mParams.AppendElement(
+          std::move(aParams.get_ObjectStorePutParams().commonParams()));
+      break;
+
+    case RequestParams::TObjectStorePutAllParams:
+      mParams = std::move(aParams.get_ObjectStorePutAllParams().records());
+      break;
+
+    default:
+      MOZ_CRASH("Should never get here!");
+  }
+  MOZ_ASSERT(!mParams.IsEmpty());
 
   mMetadata =
-      Transaction().GetMetadataForObjectStoreId(mParams.objectStoreId());
+      Transaction().GetMetadataForObjectStoreId(mParams[0].objectStoreId());
   MOZ_ASSERT(mMetadata);
 
   mObjectStoreMayHaveIndexes = mMetadata->HasLiveIndexes();
 
-  mDataOverThreshold =
-      snappy::MaxCompressedLength(mParams.cloneInfo().data().data.Size()) >
-      IndexedDatabaseManager::DataThreshold();
+  mRecords.SetLength(mParams.Length());
+  for (size_t i = 0; i < mParams.Length(); i++) {
+    MOZ_ASSERT(mParams[i].objectStoreId() == mParams[0].objectStoreId());
+
+    mRecords[i].mDataOverThreshold =
+        snappy::MaxCompressedLength(mParams[i].cloneInfo().data().data.Size()) >
+        IndexedDatabaseManager::DataThreshold();
+  }
 }
 
 nsresult ObjectStoreAddOrPutRequestOp::RemoveOldIndexDataValues(
-    DatabaseConnection* aConnection) {
+    DatabaseConnection* aConnection, const ObjectStoreAddPutParams& aParams,
+    const Key& aKey) {
   AssertIsOnConnectionThread();
   MOZ_ASSERT(aConnection);
   MOZ_ASSERT(mOverwrite);
-  MOZ_ASSERT(!mResponse.IsUnset());
+  MOZ_ASSERT(!aKey.IsUnset());
 
 #ifdef DEBUG
   {
     QM_TRY_INSPECT(const bool& hasIndexes,
                    DatabaseOperationBase::ObjectStoreHasIndexes(
-                       *aConnection, mParams.objectStoreId()),
+                       *aConnection, aParams.objectStoreId()),
                    QM_ASSERT_UNREACHABLE);
 
     MOZ_ASSERT(hasIndexes,
@@ -18871,12 +18944,12 @@ nsresult ObjectStoreAddOrPutRequestOp::RemoveOldIndexDataValues(
           "WHERE object_store_id = :"_ns +
               kStmtParamNameObjectStoreId + " AND key = :"_ns +
               kStmtParamNameKey + ";"_ns,
-          [&self = *this](auto& stmt) -> mozilla::Result<Ok, nsresult> {
+          [&aParams, &aKey](auto& stmt) -> mozilla::Result<Ok, nsresult> {
             QM_TRY(MOZ_TO_RESULT(stmt.BindInt64ByName(
-                kStmtParamNameObjectStoreId, self.mParams.objectStoreId())));
+                kStmtParamNameObjectStoreId, aParams.objectStoreId())));
 
-            QM_TRY(MOZ_TO_RESULT(
-                self.mResponse.BindToStatement(&stmt, kStmtParamNameKey)));
+            QM_TRY(
+                MOZ_TO_RESULT(aKey.BindToStatement(&stmt, kStmtParamNameKey)));
 
             return Ok{};
           }));
@@ -18886,20 +18959,23 @@ nsresult ObjectStoreAddOrPutRequestOp::RemoveOldIndexDataValues(
                    ReadCompressedIndexDataValues(**indexValuesStmt, 0));
 
     QM_TRY(MOZ_TO_RESULT(
-        DeleteIndexDataTableRows(aConnection, mResponse, existingIndexValues)));
+        DeleteIndexDataTableRows(aConnection, aKey, existingIndexValues)));
   }
 
   return NS_OK;
 }
 
-bool ObjectStoreAddOrPutRequestOp::Init(TransactionBase& aTransaction) {
+bool ObjectStoreAddOrPutRequestOp::InitRecord(
+    TransactionBase& aTransaction, const ObjectStoreAddPutParams& aParams,
+    Record& aRecord) {
   AssertIsOnOwningThread();
 
   const nsTArray<IndexUpdateInfo>& indexUpdateInfos =
-      mParams.indexUpdateInfos();
+      aParams.indexUpdateInfos();
 
+  Maybe<UniqueIndexTable>& uniqueIndexTable = aRecord.mUniqueIndexTable;
   if (!indexUpdateInfos.IsEmpty()) {
-    mUniqueIndexTable.emplace();
+    uniqueIndexTable.emplace();
 
     for (const auto& updateInfo : indexUpdateInfos) {
       auto indexMetadata = mMetadata->mIndexes.Lookup(updateInfo.indexId());
@@ -18913,25 +18989,25 @@ bool ObjectStoreAddOrPutRequestOp::Init(TransactionBase& aTransaction) {
 
       MOZ_ASSERT(indexId == updateInfo.indexId());
       MOZ_ASSERT_IF(!(*indexMetadata)->mCommonMetadata.multiEntry(),
-                    !mUniqueIndexTable.ref().Contains(indexId));
+                    !uniqueIndexTable.ref().Contains(indexId));
 
-      if (NS_WARN_IF(!mUniqueIndexTable.ref().InsertOrUpdate(indexId, unique,
-                                                             fallible))) {
+      if (NS_WARN_IF(!uniqueIndexTable.ref().InsertOrUpdate(indexId, unique,
+                                                            fallible))) {
         return false;
       }
     }
   } else if (mOverwrite) {
-    mUniqueIndexTable.emplace();
+    uniqueIndexTable.emplace();
   }
 
-  if (mUniqueIndexTable.isSome()) {
-    mUniqueIndexTable.ref().MarkImmutable();
+  if (uniqueIndexTable.isSome()) {
+    uniqueIndexTable.ref().MarkImmutable();
   }
 
   QM_TRY_UNWRAP(
-      mStoredFileInfos,
+      aRecord.mStoredFileInfos,
       TransformIntoNewArray(
-          mParams.fileAddInfos(),
+          aParams.fileAddInfos(),
           [](const auto& fileAddInfo) {
             MOZ_ASSERT(fileAddInfo.type() == StructuredCloneFileBase::eBlob ||
                        fileAddInfo.type() ==
@@ -18957,16 +19033,29 @@ bool ObjectStoreAddOrPutRequestOp::Init(TransactionBase& aTransaction) {
           fallible),
       false);
 
-  if (mDataOverThreshold) {
+  if (aRecord.mDataOverThreshold) {
     auto fileInfo =
         aTransaction.GetDatabase().GetFileManager().CreateFileInfo();
     if (NS_WARN_IF(!fileInfo)) {
       return false;
     }
 
-    mStoredFileInfos.EmplaceBack(StoredFileInfo::CreateForStructuredClone(
-        std::move(fileInfo),
-        MakeRefPtr<SCInputStream>(mParams.cloneInfo().data().data)));
+    aRecord.mStoredFileInfos.EmplaceBack(
+        StoredFileInfo::CreateForStructuredClone(
+            std::move(fileInfo),
+            MakeRefPtr<SCInputStream>(aParams.cloneInfo().data().data)));
+  }
+
+  return true;
+}
+
+bool ObjectStoreAddOrPutRequestOp::Init(TransactionBase& aTransaction) {
+  AssertIsOnOwningThread();
+
+  for (size_t i = 0; i < mParams.Length(); i++) {
+    if (!InitRecord(aTransaction, mParams[i], mRecords[i])) {
+      return false;
+    }
   }
 
   return true;
@@ -18989,20 +19078,56 @@ nsresult ObjectStoreAddOrPutRequestOp::DoDatabaseWork(
   );
 
   QM_TRY_INSPECT(const bool& objectStoreHasIndexes,
-                 ObjectStoreHasIndexes(*aConnection, mParams.objectStoreId(),
+                 ObjectStoreHasIndexes(*aConnection, mParams[0].objectStoreId(),
                                        mObjectStoreMayHaveIndexes));
 
+  int64_t nextAutoIncrementId = 0;
+  if (mMetadata->mCommonMetadata.autoIncrement()) {
+    const auto&& lockedAutoIncrementIds = mMetadata->mAutoIncrementIds.Lock();
+
+    nextAutoIncrementId = lockedAutoIncrementIds->next;
+  }
+  const int64_t initialNextAutoIncrementId = nextAutoIncrementId;
+
+  for (size_t i = 0; i < mParams.Length(); i++) {
+    QM_TRY(MOZ_TO_RESULT(WriteRecord(aConnection, mParams[i], mRecords[i],
+                                     objectStoreHasIndexes,
+                                     nextAutoIncrementId)));
+  }
+
+  QM_TRY(MOZ_TO_RESULT(autoSave.Commit()));
+
+  if (nextAutoIncrementId != initialNextAutoIncrementId) {
+    {
+      auto&& lockedAutoIncrementIds = mMetadata->mAutoIncrementIds.Lock();
+
+      lockedAutoIncrementIds->next = nextAutoIncrementId;
+    }
+
+    Transaction().NoteModifiedAutoIncrementObjectStore(mMetadata);
+  }
+
+  return NS_OK;
+}
+
+nsresult ObjectStoreAddOrPutRequestOp::WriteRecord(
+    DatabaseConnection* aConnection, ObjectStoreAddPutParams& aParams,
+    Record& aRecord, const bool aObjectStoreHasIndexes,
+    int64_t& aNextAutoIncrementId) {
+  MOZ_ASSERT(aConnection);
+  aConnection->AssertIsOnConnectionThread();
+
   // This will be the final key we use.
-  Key& key = mResponse;
-  key = mParams.key();
+  Key& key = aRecord.mResponse;
+  key = aParams.key();
 
   const bool keyUnset = key.IsUnset();
-  const IndexOrObjectStoreId osid = mParams.objectStoreId();
+  const IndexOrObjectStoreId osid = aParams.objectStoreId();
 
   // First delete old index_data_values if we're overwriting something and we
   // have indexes.
-  if (mOverwrite && !keyUnset && objectStoreHasIndexes) {
-    QM_TRY(MOZ_TO_RESULT(RemoveOldIndexDataValues(aConnection)));
+  if (mOverwrite && !keyUnset && aObjectStoreHasIndexes) {
+    QM_TRY(MOZ_TO_RESULT(RemoveOldIndexDataValues(aConnection, aParams, key)));
   }
 
   int64_t autoIncrementNum = 0;
@@ -19027,7 +19152,7 @@ nsresult ObjectStoreAddOrPutRequestOp::DoDatabaseWork(
     QM_TRY(MOZ_TO_RESULT(
         stmt->BindInt64ByName(kStmtParamNameObjectStoreId, osid)));
 
-    const SerializedStructuredCloneWriteInfo& cloneInfo = mParams.cloneInfo();
+    const SerializedStructuredCloneWriteInfo& cloneInfo = aParams.cloneInfo();
     const JSStructuredCloneData& cloneData = cloneInfo.data().data;
     const size_t cloneDataSize = cloneData.Size();
 
@@ -19036,12 +19161,7 @@ nsresult ObjectStoreAddOrPutRequestOp::DoDatabaseWork(
 
     if (mMetadata->mCommonMetadata.autoIncrement()) {
       if (keyUnset) {
-        {
-          const auto&& lockedAutoIncrementIds =
-              mMetadata->mAutoIncrementIds.Lock();
-
-          autoIncrementNum = lockedAutoIncrementIds->next;
-        }
+        autoIncrementNum = aNextAutoIncrementId;
 
         MOZ_ASSERT(autoIncrementNum > 0);
 
@@ -19052,7 +19172,7 @@ nsresult ObjectStoreAddOrPutRequestOp::DoDatabaseWork(
         QM_TRY(key.SetFromInteger(autoIncrementNum));
 
         // Update index keys if primary key is preserved in child.
-        for (auto& updateInfo : mParams.indexUpdateInfos()) {
+        for (auto& updateInfo : aParams.indexUpdateInfos()) {
           updateInfo.value().MaybeUpdateAutoIncrementKey(autoIncrementNum);
         }
       } else if (key.IsFloat()) {
@@ -19060,16 +19180,12 @@ nsresult ObjectStoreAddOrPutRequestOp::DoDatabaseWork(
         numericKey = std::min(numericKey, double(1LL << 53));
         numericKey = floor(numericKey);
 
-        const auto&& lockedAutoIncrementIds =
-            mMetadata->mAutoIncrementIds.Lock();
-        if (numericKey >= lockedAutoIncrementIds->next) {
+        if (numericKey >= aNextAutoIncrementId) {
           autoIncrementNum = numericKey;
         }
       }
 
       if (keyUnset && mMetadata->mCommonMetadata.keyPath().IsValid()) {
-        const SerializedStructuredCloneWriteInfo& cloneInfo =
-            mParams.cloneInfo();
         MOZ_ASSERT(cloneInfo.offsetToKeyProp());
         MOZ_ASSERT(cloneDataSize > sizeof(uint64_t));
         MOZ_ASSERT(cloneInfo.offsetToKeyProp() <=
@@ -19095,7 +19211,7 @@ nsresult ObjectStoreAddOrPutRequestOp::DoDatabaseWork(
 
     key.BindToStatement(&*stmt, kStmtParamNameKey);
 
-    if (mDataOverThreshold) {
+    if (aRecord.mDataOverThreshold) {
       // The data we store in the SQLite database is a (signed) 64-bit integer.
       // The flags are left-shifted 32 bits so the max value is 0xFFFFFFFF.
       // The file_ids index occupies the lower 32 bits and its max is
@@ -19105,7 +19221,7 @@ nsresult ObjectStoreAddOrPutRequestOp::DoDatabaseWork(
       uint32_t flags = 0;
       flags |= kCompressedFlag;
 
-      const uint32_t index = mStoredFileInfos.Length() - 1;
+      const uint32_t index = aRecord.mStoredFileInfos.Length() - 1;
 
       const int64_t data = (uint64_t(flags) << 32) | index;
 
@@ -19144,14 +19260,14 @@ nsresult ObjectStoreAddOrPutRequestOp::DoDatabaseWork(
           kStmtParamNameData, dataBuffer, dataBufferLength)));
     }
 
-    if (!mStoredFileInfos.IsEmpty()) {
+    if (!aRecord.mStoredFileInfos.IsEmpty()) {
       // Moved outside the loop to allow it to be cached when demanded by the
       // first write.  (We may have mStoredFileInfos without any required
       // writes.)
       Maybe<FileHelper> fileHelper;
       nsAutoString fileIds;
 
-      for (auto& storedFileInfo : mStoredFileInfos) {
+      for (auto& storedFileInfo : aRecord.mStoredFileInfos) {
         MOZ_ASSERT(storedFileInfo.IsValid());
 
         QM_TRY_INSPECT(const auto& inputStream,
@@ -19228,13 +19344,14 @@ nsresult ObjectStoreAddOrPutRequestOp::DoDatabaseWork(
   }
 
   // Update our indexes if needed.
-  if (!mParams.indexUpdateInfos().IsEmpty()) {
-    MOZ_ASSERT(mUniqueIndexTable.isSome());
+  if (!aParams.indexUpdateInfos().IsEmpty()) {
+    MOZ_ASSERT(aRecord.mUniqueIndexTable.isSome());
 
     // Write the index_data_values column.
-    QM_TRY_INSPECT(const auto& indexValues,
-                   IndexDataValuesFromUpdateInfos(mParams.indexUpdateInfos(),
-                                                  mUniqueIndexTable.ref()));
+    QM_TRY_INSPECT(
+        const auto& indexValues,
+        IndexDataValuesFromUpdateInfos(aParams.indexUpdateInfos(),
+                                       aRecord.mUniqueIndexTable.ref()));
 
     QM_TRY(
         MOZ_TO_RESULT(UpdateIndexValues(aConnection, osid, key, indexValues)));
@@ -19243,16 +19360,8 @@ nsresult ObjectStoreAddOrPutRequestOp::DoDatabaseWork(
         InsertIndexTableRows(aConnection, osid, key, indexValues)));
   }
 
-  QM_TRY(MOZ_TO_RESULT(autoSave.Commit()));
-
   if (autoIncrementNum) {
-    {
-      auto&& lockedAutoIncrementIds = mMetadata->mAutoIncrementIds.Lock();
-
-      lockedAutoIncrementIds->next = autoIncrementNum + 1;
-    }
-
-    Transaction().NoteModifiedAutoIncrementObjectStore(mMetadata);
+    aNextAutoIncrementId = autoIncrementNum + 1;
   }
 
   return NS_OK;
@@ -19262,19 +19371,34 @@ void ObjectStoreAddOrPutRequestOp::GetResponse(RequestResponse& aResponse,
                                                size_t* aResponseSize) {
   AssertIsOnOwningThread();
 
+  if (mPutAll) {
+    aResponse = ObjectStorePutAllResponse();
+    *aResponseSize = 0;
+
+    nsTArray<Key>& keys = aResponse.get_ObjectStorePutAllResponse().keys();
+    keys.SetCapacity(mRecords.Length());
+    for (auto& record : mRecords) {
+      *aResponseSize += record.mResponse.GetBuffer().Length();
+      keys.AppendElement(std::move(record.mResponse));
+    }
+    return;
+  }
+
+  MOZ_ASSERT(mRecords.Length() == 1);
+  const Key& key = mRecords[0].mResponse;
   if (mOverwrite) {
-    aResponse = ObjectStorePutResponse(mResponse);
-    *aResponseSize = mResponse.GetBuffer().Length();
+    aResponse = ObjectStorePutResponse(key);
+    *aResponseSize = key.GetBuffer().Length();
   } else {
-    aResponse = ObjectStoreAddResponse(mResponse);
-    *aResponseSize = mResponse.GetBuffer().Length();
+    aResponse = ObjectStoreAddResponse(key);
+    *aResponseSize = key.GetBuffer().Length();
   }
 }
 
 void ObjectStoreAddOrPutRequestOp::Cleanup() {
   AssertIsOnOwningThread();
 
-  mStoredFileInfos.Clear();
+  mRecords.Clear();
 
   NormalTransactionOp::Cleanup();
 }
@@ -20856,7 +20980,14 @@ nsresult Cursor<CursorType>::ContinueOp::DoDatabaseWork(
   // preload only for an assumed basic operation. Other operations would require
   // more work on the client side for invalidation, and may not make any sense
   // at all.
-  const uint32_t maxExtraCount = hasContinueKey ? 0 : mCursor->mMaxExtraCount;
+  if (!hasContinueKey && advanceCount == 1) {
+    mCursor->mExtraCount =
+        std::min(mCursor->mExtraCount * 2,
+                 CursorBase::kMaxExtraCountGrowth * mCursor->mMaxExtraCount);
+  } else {
+    mCursor->mExtraCount = mCursor->mMaxExtraCount;
+  }
+  const uint32_t maxExtraCount = hasContinueKey ? 0 : mCursor->mExtraCount;
 
   QM_TRY_INSPECT(const auto& stmt,
                  aConnection->BorrowCachedStatement(
@@ -20865,7 +20996,7 @@ nsresult Cursor<CursorType>::ContinueOp::DoDatabaseWork(
 
   QM_TRY(MOZ_TO_RESULT(stmt->BindUTF8StringByName(
       kStmtParamNameLimit,
-      IntToCString(advanceCount + mCursor->mMaxExtraCount))));
+      IntToCString(advanceCount + mCursor->mExtraCount))));
 
   QM_TRY(MOZ_TO_RESULT(stmt->BindInt64ByName(kStmtParamNameId, mCursor->Id())));
 
@@ -842,31 +842,47 @@ void IDBObjectStore::GetAddInfo(JSContext* aCx, ValueWrapper& aValueWrapper,
   }
 }
 
-RefPtr<IDBRequest> IDBObjectStore::AddOrPut(JSContext* aCx,
-                                            ValueWrapper& aValueWrapper,
-                                            JS::Handle<JS::Value> aKey,
-                                            bool aOverwrite, bool aFromCursor,
-                                            ErrorResult& aRv) {
-  AssertIsOnOwningThread();
-  MOZ_ASSERT(aCx);
-  MOZ_ASSERT_IF(aFromCursor, aOverwrite);
+// The most an add or put request may send to the parent, which is mainly the
+// structured clones, the encoded object keys, and the encoded index keys.
+static size_t MaxAddPutMessageSize() {
+  // kMaxIDBMsgOverhead covers the minor stuff not included in the size
+  // calculations because the precise calculation would slow down add and put
+  // operations.
+  static const size_t kMaxIDBMsgOverhead = 1024 * 1024;  // 1MB
+  const uint32_t maximalSizeFromPref =
+      IndexedDatabaseManager::MaxSerializedMsgSize();
+  MOZ_ASSERT(maximalSizeFromPref > kMaxIDBMsgOverhead);
+  return maximalSizeFromPref - kMaxIDBMsgOverhead;
+}
 
+bool IDBObjectStore::CheckWriteAllowed(ErrorResult& aRv) {
   if (mTransaction->GetMode() == IDBTransaction::Mode::Cleanup ||
       mDeletedSpec) {
     aRv.Throw(NS_ERROR_DOM_INDEXEDDB_NOT_ALLOWED_ERR);
-    return nullptr;
+    return false;
   }
 
   if (!mTransaction->IsActive()) {
     aRv.Throw(NS_ERROR_DOM_INDEXEDDB_TRANSACTION_INACTIVE_ERR);
-    return nullptr;
+    return false;
   }
 
   if (!mTransaction->IsWriteAllowed()) {
     aRv.Throw(NS_ERROR_DOM_INDEXEDDB_READ_ONLY_ERR);
-    return nullptr;
+    return false;
   }
 
+  return true;
+}
+
+void IDBObjectStore::GetAddPutParams(JSContext* aCx,
+                                     ValueWrapper& aValueWrapper,
+                                     JS::Handle<JS::Value> aKey,
+                                     ObjectStoreAddPutParams& aParams,
+                                     size_t* aMessageSize, ErrorResult& aRv) {
+  AssertIsOnOwningThread();
+  MOZ_ASSERT(aCx);
+
   Key key;
   StructuredCloneWriteInfo cloneWriteInfo(mTransaction->Database());
   nsTArray<IndexUpdateInfo> updateInfos;
@@ -890,11 +906,11 @@ RefPtr<IDBRequest> IDBObjectStore::AddOrPut(JSContext* aCx,
     mTransaction->TransitionToActive();
   } else if (!aRv.Failed()) {
     aRv.Throw(NS_ERROR_DOM_INDEXEDDB_ABORT_ERR);
-    return nullptr;  // It is mandatory to return right after throw
+    return;  // It is mandatory to return right after throw
   }
 
   if (aRv.Failed()) {
-    return nullptr;
+    return;
   }
 
   // Total structured clone size in bytes.
@@ -916,18 +932,11 @@ RefPtr<IDBRequest> IDBObjectStore::AddOrPut(JSContext* aCx,
         "The structured clone is too large"
         " (size=%zu bytes, max=%u bytes).",
         structuredCloneSize, IndexedDatabaseManager::MaxStructuredCloneSize()));
-    return nullptr;
+    return;
   }
 
-  // Check the size limit of the serialized message which mainly consists of
-  // a StructuredCloneBuffer, an encoded object key, and the encoded index keys.
-  // kMaxIDBMsgOverhead covers the minor stuff not included in this calculation
-  // because the precise calculation would slow down this AddOrPut operation.
-  static const size_t kMaxIDBMsgOverhead = 1024 * 1024;  // 1MB
-  const uint32_t maximalSizeFromPref =
-      IndexedDatabaseManager::MaxSerializedMsgSize();
-  MOZ_ASSERT(maximalSizeFromPref > kMaxIDBMsgOverhead);
-  const size_t kMaxMessageSize = maximalSizeFromPref - kMaxIDBMsgOverhead;
+  // Check the size limit of the serialized message.
+  const size_t kMaxMessageSize = MaxAddPutMessageSize();
 
   // Serialized structured clone size in bytes. For structured clone sizes >
   // IPC::kMessageBufferShmemThreshold, only the size and shared memory handle
@@ -958,20 +967,20 @@ RefPtr<IDBRequest> IDBObjectStore::AddOrPut(JSContext* aCx,
         nsPrintfCString("The serialized value is too large"
                         " (size=%zu bytes, max=%zu bytes).",
                         messageSize, kMaxMessageSize));
-    return nullptr;
+    return;
   }
+  *aMessageSize = messageSize;
 
-  ObjectStoreAddPutParams commonParams;
-  commonParams.objectStoreId() = Id();
-  commonParams.cloneInfo().data().data =
+  aParams.objectStoreId() = Id();
+  aParams.cloneInfo().data().data =
       std::move(cloneWriteInfo.mCloneBuffer.data());
-  commonParams.cloneInfo().offsetToKeyProp() = cloneWriteInfo.mOffsetToKeyProp;
-  commonParams.key() = key;
-  commonParams.indexUpdateInfos() = std::move(updateInfos);
+  aParams.cloneInfo().offsetToKeyProp() = cloneWriteInfo.mOffsetToKeyProp;
+  aParams.key() = std::move(key);
+  aParams.indexUpdateInfos() = std::move(updateInfos);
 
   // Convert any blobs or mutable files into FileAddInfos.
   QM_TRY_UNWRAP(
-      commonParams.fileAddInfos(),
+      aParams.fileAddInfos(),
       TransformIntoNewArrayAbortOnErr(
           cloneWriteInfo.mFiles,
           [&database = *mTransaction->Database()](
@@ -1010,7 +1019,29 @@ RefPtr<IDBRequest> IDBObjectStore::AddOrPut(JSContext* aCx,
             }
           },
           fallible),
-      nullptr, [&aRv](const nsresult result) { aRv = result; });
+      QM_VOID, [&aRv](const nsresult result) { aRv = result; });
+}
+
+RefPtr<IDBRequest> IDBObjectStore::AddOrPut(JSContext* aCx,
+                                            ValueWrapper& aValueWrapper,
+                                            JS::Handle<JS::Value> aKey,
+                                            bool aOverwrite, bool aFromCursor,
+                                            ErrorResult& aRv) {
+  AssertIsOnOwningThread();
+  MOZ_ASSERT(aCx);
+  MOZ_ASSERT_IF(aFromCursor, aOverwrite);
+
+  if (!CheckWriteAllowed(aRv)) {
+    return nullptr;
+  }
+
+  ObjectStoreAddPutParams commonParams;
+  size_t messageSize;
+  GetAddPutParams(aCx, aValueWrapper, aKey, commonParams, &messageSize, aRv);
+  if (aRv.Failed()) {
+    return nullptr;
+  }
+  const Key key = commonParams.key();
 
   const auto& params =
       aOverwrite ? RequestParams{ObjectStorePutParams(std::move(commonParams))}
@@ -1045,6 +1076,67 @@ RefPtr<IDBRequest> IDBObjectStore::AddOrPut(JSContext* aCx,
   return request;
 }
 
+RefPtr<IDBRequest> IDBObjectStore::PutAll(JSContext* aCx,
+                                          const Sequence<JS::Value>& aValues,
+                                          ErrorResult& aRv) {
+  AssertIsOnOwningThread();
+  MOZ_ASSERT(aCx);
+
+  if (!CheckWriteAllowed(aRv)) {
+    return nullptr;
+  }
+
+  if (aValues.IsEmpty()) {
+    aRv.ThrowTypeError("putAll() needs at least one value");
+    return nullptr;
+  }
+
+  nsTArray<ObjectStoreAddPutParams> records(aValues.Length());
+  size_t messageSize = 0;
+  const size_t kMaxMessageSize = MaxAddPutMessageSize();
+
+  for (const JS::Value& value : aValues) {
+    JS::Rooted<JS::Value> rootedValue(aCx, value);
+    ValueWrapper valueWrapper(aCx, rootedValue);
+
+    // The values have in-line keys, or the objectStore generates them.
+    ObjectStoreAddPutParams& record = *records.AppendElement();
+    size_t recordSize;
+    GetAddPutParams(aCx, valueWrapper, JS::UndefinedHandleValue, record,
+                    &recordSize, aRv);
+    if (aRv.Failed()) {
+      return nullptr;
+    }
+
+    messageSize += recordSize;
+    if (messageSize > kMaxMessageSize) {
+      IDB_REPORT_INTERNAL_ERR();
+      aRv.ThrowUnknownError(
+          nsPrintfCString("The serialized values are too large"
+                          " (size=%zu bytes, max=%zu bytes).",
+                          messageSize, kMaxMessageSize));
+      return nullptr;
+    }
+  }
+
+  const RequestParams params{ObjectStorePutAllParams(std::move(records))};
+
+  auto request = GenerateRequest(aCx, this).unwrap();
+
+  IDB_LOG_MARK_CHILD_TRANSACTION_REQUEST(
+      "database(%s).transaction(%s).objectStore(%s).putAll()",
+      "IDBObjectStore.putAll(%.0s%.0s%.0s)",
+      mTransaction->LoggingSerialNumber(), request->LoggingSerialNumber(),
+      IDB_LOG_STRINGIFY(mTransaction->Database()),
+      IDB_LOG_STRINGIFY(*mTransaction), IDB_LOG_STRINGIFY(this));
+
+  mTransaction->StartRequest(request, params);
+
+  mTransaction->InvalidateCursorCaches();
+
+  return request;
+}
+
 RefPtr<IDBRequest> IDBObjectStore::GetAllInternal(
     bool aKeysOnly, JSContext* aCx, JS::Handle<JS::Value> aKey,
     const Optional<uint32_t>& aLimit, ErrorResult& aRv) {
@@ -38,6 +38,7 @@ namespace indexedDB {
 class Key;
 class KeyPath;
 class IndexUpdateInfo;
+class ObjectStoreAddPutParams;
 class ObjectStoreSpec;
 struct StructuredCloneReadInfoChild;
 }  // namespace indexedDB
@@ -186,6 +187,17 @@ class IDBObjectStore final : public nsISupports, public nsWrapperCache {
                                        JS::Handle<JS::Value> aKey,
                                        ErrorResult& aRv);
 
+  /**
+   * Puts aValues, which must have in-line keys unless the objectStore
+   * generates them, in a single request.  The request's result is the array
+   * of their keys.  This is much faster than putting the values one by one
+   * when there are many of them, because the parent writes all of them at
+   * once.
+   */
+  [[nodiscard]] RefPtr<IDBRequest> PutAll(JSContext* aCx,
+                                          const Sequence<JS::Value>& aValues,
+                                          ErrorResult& aRv);
+
   [[nodiscard]] RefPtr<IDBRequest> Delete(JSContext* aCx,
                                           JS::Handle<JS::Value> aKey,
                                           ErrorResult& aRv);
@@ -268,6 +280,17 @@ class IDBObjectStore final : public nsISupports, public nsWrapperCache {
                   nsTArray<IndexUpdateInfo>& aUpdateInfoArray,
                   ErrorResult& aRv);
 
+  // Returns false, and throws, if this objectStore can't be written to now.
+  bool CheckWriteAllowed(ErrorResult& aRv);
+
+  // Clones the value, and computes its key and index keys, for an add or put
+  // request.  aMessageSize is set to the estimated size of the record in the
+  // request.
+  void GetAddPutParams(JSContext* aCx, ValueWrapper& aValueWrapper,
+                       JS::Handle<JS::Value> aKey,
+                       indexedDB::ObjectStoreAddPutParams& aParams,
+                       size_t* aMessageSize, ErrorResult& aRv);
+
   [[nodiscard]] RefPtr<IDBRequest> AddOrPut(JSContext* aCx,
                                             ValueWrapper& aValueWrapper,
                                             JS::Handle<JS::Value> aKey,
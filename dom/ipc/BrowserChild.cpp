@@ -315,6 +315,10 @@ BrowserChild::BrowserChild(ContentChild* aManager, const TabId& aTabId,
   if (StaticPrefs::dom_events_coalesce_touchmove()) {
     mCoalescedTouchMoveEventFlusher = new CoalescedTouchMoveFlusher(this);
   }
+
+  if (StaticPrefs::dom_events_coalesce_wheel()) {
+    mCoalescedWheelEventFlusher = new CoalescedWheelFlusher(this);
+  }
 }
 
 const CompositorOptions& BrowserChild::GetCompositorOptions() const {
@@ -680,6 +684,11 @@ void BrowserChild::DestroyWindow() {
     mCoalescedTouchMoveEventFlusher = nullptr;
   }
 
+  if (mCoalescedWheelEventFlusher) {
+    mCoalescedWheelEventFlusher->RemoveObserver();
+    mCoalescedWheelEventFlusher = nullptr;
+  }
+
   if (mSessionStoreChild) {
     mSessionStoreChild->Stop();
     mSessionStoreChild = nullptr;
@@ -1452,6 +1461,16 @@ void BrowserChild::ProcessPendingCoalescedTouchData() {
                                mCoalescedTouchData.GetApzResponse());
 }
 
+void BrowserChild::ProcessPendingCoalescedWheelData() {
+  if (mCoalescedWheelEventFlusher) {
+    mCoalescedWheelEventFlusher->RemoveObserver();
+  }
+
+  if (!mCoalescedWheelData.IsEmpty()) {
+    DispatchCoalescedWheelEvent();
+  }
+}
+
 void BrowserChild::ProcessPendingCoalescedMouseDataAndDispatchEvents() {
   if (!mCoalesceMouseMoveEvents || !mCoalescedMouseEventFlusher) {
     // We don't enable mouse coalescing or we are destroying BrowserChild.
@@ -1645,6 +1664,11 @@ mozilla::ipc::IPCResult BrowserChild::RecvNormalPrioritySynthMouseMoveEvent(
 mozilla::ipc::IPCResult BrowserChild::RecvRealMouseButtonEvent(
     const WidgetMouseEvent& aEvent, const ScrollableLayerGuid& aGuid,
     const uint64_t& aInputBlockId) {
+  if (aEvent.mMessage != eMouseMove) {
+    // Mouse buttons may act on what the pending wheel event scrolls.
+    ProcessPendingCoalescedWheelData();
+  }
+
   if (mCoalesceMouseMoveEvents && mCoalescedMouseEventFlusher &&
       aEvent.mMessage != eMouseMove) {
     // When receiving a mouse event other than mousemove, we have to dispatch
@@ -1900,11 +1924,19 @@ mozilla::ipc::IPCResult BrowserChild::RecvMouseWheelEvent(
     mCoalescedWheelData.Coalesce(aEvent, aGuid, aInputBlockId);
 
     MOZ_ASSERT(!mCoalescedWheelData.IsEmpty());
-    // If the next event isn't a wheel event, make sure we dispatch.
+    // If the next event isn't a wheel event, make sure we dispatch, either
+    // now or before the next refresh, so that the wheel events of a frame
+    // are coalesced even when they don't arrive together.
     if (!isNextWheelEvent) {
-      DispatchCoalescedWheelEvent();
+      if (mCoalescedWheelEventFlusher &&
+          mCoalescedWheelEventFlusher->GetRefreshDriver()) {
+        mCoalescedWheelEventFlusher->StartObserver();
+      } else {
+        DispatchCoalescedWheelEvent();
+      }
     }
   } else {
+    ProcessPendingCoalescedWheelData();
     DispatchWheelEvent(aEvent, aGuid, aInputBlockId);
   }
 
@@ -644,6 +644,8 @@ class BrowserChild final : public nsMessageManagerScriptExecutor,
 
   void ProcessPendingCoalescedTouchData();
 
+  void ProcessPendingCoalescedWheelData();
+
   /**
    * Dispatch an eMouseRawUpdate event for dispatching ePointerRawUpdate event
    * into the DOM immediately when aPendingEvent will be dispatched later.
@@ -932,6 +934,7 @@ class BrowserChild final : public nsMessageManagerScriptExecutor,
 
   RefPtr<CoalescedMouseMoveFlusher> mCoalescedMouseEventFlusher;
   RefPtr<CoalescedTouchMoveFlusher> mCoalescedTouchMoveEventFlusher;
+  RefPtr<CoalescedWheelFlusher> mCoalescedWheelEventFlusher;
 
   RefPtr<layers::IAPZCTreeManager> mApzcTreeManager;
   RefPtr<SessionStoreChild> mSessionStoreChild;
@@ -6,6 +6,7 @@
 #include "base/basictypes.h"
 
 #include "CoalescedWheelData.h"
+#include "BrowserChild.h"
 
 using namespace mozilla;
 using namespace mozilla::dom;
@@ -44,3 +45,13 @@ bool CoalescedWheelData::CanCoalesce(const WidgetWheelEvent& aEvent,
           mCoalescedInputEvent->mCanTriggerSwipe == aEvent.mCanTriggerSwipe &&
           mGuid == aGuid && mInputBlockId == aInputBlockId);
 }
+
+void CoalescedWheelFlusher::WillRefresh(mozilla::TimeStamp aTime) {
+  MOZ_ASSERT(mRefreshDriver);
+  mBrowserChild->ProcessPendingCoalescedWheelData();
+}
+
+CoalescedWheelFlusher::CoalescedWheelFlusher(BrowserChild* aBrowserChild)
+    : CoalescedInputFlusher(aBrowserChild) {}
+
+CoalescedWheelFlusher::~CoalescedWheelFlusher() { RemoveObserver(); }
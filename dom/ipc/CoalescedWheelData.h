@@ -23,6 +23,15 @@ class CoalescedWheelData final : public CoalescedInputData<WidgetWheelEvent> {
                    const uint64_t& aInputBlockId);
 };
 
+class CoalescedWheelFlusher final : public CoalescedInputFlusher {
+ public:
+  explicit CoalescedWheelFlusher(BrowserChild* aBrowserChild);
+  void WillRefresh(mozilla::TimeStamp aTime) override;
+
+ private:
+  ~CoalescedWheelFlusher() override;
+};
+
 }  // namespace mozilla::dom
 
 #endif  // mozilla_dom_CoalescedWheelData_h
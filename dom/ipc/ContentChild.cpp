@@ -86,6 +86,7 @@
 #include "mozilla/dom/ServiceWorkerManager.h"
 #include "mozilla/dom/SessionStorageManager.h"
 #include "mozilla/dom/URLClassifierChild.h"
+#include "MappedPrefixSet.h"
 #include "mozilla/dom/UserActivation.h"
 #include "mozilla/dom/WindowGlobalChild.h"
 #include "mozilla/dom/WorkerDebugger.h"
@@ -2323,6 +2324,23 @@ mozilla::ipc::IPCResult ContentChild::RecvSimpleURIUnknownRemoteSchemes(
   return IPC_OK();
 }
 
+mozilla::ipc::IPCResult ContentChild::RecvUpdateURLClassifierPrefixSets(
+    nsTArray<URLClassifierPrefixSetDescriptor>&& aPrefixSets) {
+  using namespace mozilla::safebrowsing;
+
+  MappedPrefixSetMap sets;
+  for (auto& descriptor : aPrefixSets) {
+    // A set that doesn't validate is left out, its table is classified by the
+    // parent.
+    if (RefPtr<MappedPrefixSet> set =
+            MappedPrefixSet::Create(descriptor.mapHandle())) {
+      sets.InsertOrUpdate(descriptor.table(), std::move(set));
+    }
+  }
+  MappedPrefixSet::SetShared(std::move(sets));
+  return IPC_OK();
+}
+
 mozilla::ipc::IPCResult ContentChild::RecvUpdateL10nFileSources(
     nsTArray<mozilla::dom::L10nFileSourceDescriptor>&& aDescriptors) {
   L10nRegistry::RegisterFileSourcesFromParentProcess(aDescriptors);
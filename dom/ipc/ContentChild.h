@@ -303,6 +303,9 @@ class ContentChild final : public PContentChild,
   mozilla::ipc::IPCResult RecvSimpleURIUnknownRemoteSchemes(
       nsTArray<nsCString>&& aRemoteSchemes);
 
+  mozilla::ipc::IPCResult RecvUpdateURLClassifierPrefixSets(
+      nsTArray<URLClassifierPrefixSetDescriptor>&& aPrefixSets);
+
   mozilla::ipc::IPCResult RecvUpdateL10nFileSources(
       nsTArray<L10nFileSourceDescriptor>&& aDescriptors);
 
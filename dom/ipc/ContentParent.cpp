@@ -133,6 +133,7 @@
 #include "mozilla/dom/StorageIPC.h"
 #include "mozilla/dom/UserActivation.h"
 #include "mozilla/dom/URLClassifierParent.h"
+#include "MappedPrefixSet.h"
 #include "mozilla/dom/WindowGlobalParent.h"
 #include "mozilla/dom/ipc/SharedMap.h"
 #include "mozilla/dom/ipc/StructuredCloneData.h"
@@ -1494,6 +1495,23 @@ void ContentParent::BroadcastStringBundle(
   }
 }
 
+void ContentParent::BroadcastURLClassifierPrefixSets() {
+  for (auto* cp : AllProcesses(eLive)) {
+    cp->SendURLClassifierPrefixSets();
+  }
+}
+
+void ContentParent::SendURLClassifierPrefixSets() {
+  const auto& sets = safebrowsing::MappedPrefixSet::Shared();
+
+  nsTArray<URLClassifierPrefixSetDescriptor> descriptors(sets.Count());
+  for (const auto& entry : sets) {
+    descriptors.AppendElement(URLClassifierPrefixSetDescriptor(
+        entry.GetKey(), entry.GetData()->CloneHandle()));
+  }
+  Unused << SendUpdateURLClassifierPrefixSets(std::move(descriptors));
+}
+
 void ContentParent::BroadcastShmBlockAdded(uint32_t aGeneration,
                                            uint32_t aIndex) {
   auto* pfl = gfxPlatformFontList::PlatformFontList();
@@ -2870,6 +2888,10 @@ bool ContentParent::InitInternal(ProcessPriority aInitialPriority) {
       components::StringBundle::Service();
   stringBundleService->SendContentBundles(this);
 
+  if (!safebrowsing::MappedPrefixSet::Shared().IsEmpty()) {
+    SendURLClassifierPrefixSets();
+  }
+
   if (gAppData) {
     nsCString version(gAppData->version);
     nsCString buildID(gAppData->buildID);
@@ -287,6 +287,9 @@ class ContentParent final : public PContentParent,
 
   static void BroadcastStringBundle(const StringBundleDescriptor&);
 
+  // Sends the shared Safe Browsing prefix sets to all content processes.
+  static void BroadcastURLClassifierPrefixSets();
+
   static void BroadcastShmBlockAdded(uint32_t aGeneration, uint32_t aIndex);
 
   static void BroadcastThemeUpdate(widget::ThemeChangeKind);
@@ -1379,6 +1382,9 @@ class ContentParent final : public PContentParent,
   // initializing.
   void MaybeEnableRemoteInputEventQueue();
 
+  // Sends the shared Safe Browsing prefix sets, see MappedPrefixSet.
+  void SendURLClassifierPrefixSets();
+
 #if defined(XP_MACOSX) && defined(MOZ_SANDBOX)
   void AppendSandboxParams(std::vector<std::string>& aArgs);
   void AppendDynamicSandboxParams(std::vector<std::string>& aArgs);
@@ -69,6 +69,12 @@ class PreallocatedProcessManagerImpl final : public nsIObserver {
   void Disable();
   void CloseProcesses();
 
+  // The number of processes we try to keep preallocated.
+  uint32_t TargetNumber() const { return mNumberPreallocs + mExtraPreallocs; }
+  void GrowAfterMiss();
+  void ShrinkAfterDecay();
+  void CloseExtraProcesses();
+
   bool IsEmpty() const { return mPreallocatedProcesses.IsEmpty(); }
   static bool IsShutdown() {
     return AppShutdown::IsInOrBeyond(ShutdownPhase::AppShutdownConfirmed);
@@ -78,6 +84,21 @@ class PreallocatedProcessManagerImpl final : public nsIObserver {
   bool mEnabled;
   uint32_t mNumberPreallocs;
   AutoTArray<UniqueContentParentKeepAlive, 3> mPreallocatedProcesses;
+
+  // With Fission, tabs opened in bursts can take processes faster than we
+  // preallocate them.  Whenever Take() finds none left we preallocate one
+  // more, up to dom.ipc.processPrelaunch.fission.maxNumber, and go back down
+  // one at a time after dom.ipc.processPrelaunch.fission.decayMs without
+  // another miss.  Memory pressure drops the extra processes, and keeps us
+  // from growing again for dom.ipc.processPrelaunch.fission.holdMs.
+  bool mAdaptive;
+  uint32_t mExtraPreallocs;
+  bool mShrinkScheduled;
+  TimeStamp mLastGrowth;
+  TimeStamp mLastMemoryPressure;
+  // How many Take() calls could and couldn't hide a process launch.
+  uint32_t mHits;
+  uint32_t mMisses;
   // Even if we have multiple PreallocatedProcessManagerImpls, we'll have
   // one blocker counter
   static uint32_t sNumBlockers;
@@ -112,7 +133,13 @@ PreallocatedProcessManagerImpl* PreallocatedProcessManagerImpl::Singleton() {
 NS_IMPL_ISUPPORTS(PreallocatedProcessManagerImpl, nsIObserver)
 
 PreallocatedProcessManagerImpl::PreallocatedProcessManagerImpl()
-    : mEnabled(false), mNumberPreallocs(1) {}
+    : mEnabled(false),
+      mNumberPreallocs(1),
+      mAdaptive(false),
+      mExtraPreallocs(0),
+      mShrinkScheduled(false),
+      mHits(0),
+      mMisses(0) {}
 
 PreallocatedProcessManagerImpl::~PreallocatedProcessManagerImpl() {
   // Note: mPreallocatedProcesses may not be null, but all processes should
@@ -158,6 +185,8 @@ PreallocatedProcessManagerImpl::Observe(nsISupports* aSubject,
       os->RemoveObserver(this, topic);
     }
   } else if (!strcmp("memory-pressure", aTopic)) {
+    mExtraPreallocs = 0;
+    mLastMemoryPressure = TimeStamp::Now();
     CloseProcesses();
   } else {
     MOZ_ASSERT_UNREACHABLE("Unknown topic");
@@ -170,20 +199,26 @@ void PreallocatedProcessManagerImpl::RereadPrefs() {
   if (mozilla::BrowserTabsRemoteAutostart() &&
       Preferences::GetBool("dom.ipc.processPrelaunch.enabled")) {
     int32_t number = 1;
+    mAdaptive = false;
     if (mozilla::FissionAutostart()) {
       number = StaticPrefs::dom_ipc_processPrelaunch_fission_number();
+      mAdaptive = true;
       // limit preallocated processes on low-mem machines
       PRUint64 bytes = PR_GetPhysicalMemorySize();
       if (bytes > 0 &&
           bytes <=
               StaticPrefs::dom_ipc_processPrelaunch_lowmem_mb() * 1024 * 1024) {
         number = 1;
+        mAdaptive = false;
       }
     }
+    if (!mAdaptive) {
+      mExtraPreallocs = 0;
+    }
     if (number >= 0) {
       Enable(number);
       // We have one prealloc queue for all types except File now
-      if (static_cast<uint64_t>(number) < mPreallocatedProcesses.Length()) {
+      if (TargetNumber() < mPreallocatedProcesses.Length()) {
         CloseProcesses();
       }
     }
@@ -198,7 +233,11 @@ UniqueContentParentKeepAlive PreallocatedProcessManagerImpl::Take(
     return nullptr;
   }
   UniqueContentParentKeepAlive process;
-  if (!IsEmpty()) {
+  if (IsEmpty()) {
+    mMisses++;
+    GrowAfterMiss();
+  } else {
+    mHits++;
     process = std::move(mPreallocatedProcesses.ElementAt(0));
     mPreallocatedProcesses.RemoveElementAt(0);
 
@@ -218,6 +257,9 @@ UniqueContentParentKeepAlive PreallocatedProcessManagerImpl::Take(
              process->IsLaunching() ? " (still launching)" : "",
              (unsigned long)mPreallocatedProcesses.Length()));
   }
+  MOZ_LOG(ContentParent::GetLog(), LogLevel::Debug,
+          ("Prealloc hits=%u misses=%u, keeping %u processes", mHits, mMisses,
+           TargetNumber()));
   if (process && !process->IsLaunching()) {
     ProcessPriorityManager::SetProcessPriority(process.get(),
                                                PROCESS_PRIORITY_FOREGROUND);
@@ -226,6 +268,71 @@ UniqueContentParentKeepAlive PreallocatedProcessManagerImpl::Take(
   return process;
 }
 
+void PreallocatedProcessManagerImpl::GrowAfterMiss() {
+  if (!mAdaptive ||
+      TargetNumber() >=
+          StaticPrefs::dom_ipc_processPrelaunch_fission_maxNumber()) {
+    return;
+  }
+  TimeStamp now = TimeStamp::Now();
+  if (!mLastMemoryPressure.IsNull() &&
+      (now - mLastMemoryPressure).ToMilliseconds() <
+          StaticPrefs::dom_ipc_processPrelaunch_fission_holdMs()) {
+    return;
+  }
+
+  mExtraPreallocs++;
+  mLastGrowth = now;
+  MOZ_LOG(ContentParent::GetLog(), LogLevel::Debug,
+          ("Growing preallocation to %u processes", TargetNumber()));
+  PROFILER_MARKER_TEXT("Process", DOM, {}, "Grew preallocation"_ns);
+
+  if (!mShrinkScheduled) {
+    mShrinkScheduled = true;
+    NS_DelayedDispatchToCurrentThread(
+        NewRunnableMethod("PreallocatedProcessManagerImpl::ShrinkAfterDecay",
+                          this,
+                          &PreallocatedProcessManagerImpl::ShrinkAfterDecay),
+        StaticPrefs::dom_ipc_processPrelaunch_fission_decayMs());
+  }
+}
+
+void PreallocatedProcessManagerImpl::ShrinkAfterDecay() {
+  mShrinkScheduled = false;
+  if (!mExtraPreallocs) {
+    return;
+  }
+
+  uint32_t decayMs = StaticPrefs::dom_ipc_processPrelaunch_fission_decayMs();
+  double sinceGrowth = (TimeStamp::Now() - mLastGrowth).ToMilliseconds();
+  if (sinceGrowth >= decayMs) {
+    mExtraPreallocs--;
+    mLastGrowth = TimeStamp::Now();
+    MOZ_LOG(ContentParent::GetLog(), LogLevel::Debug,
+            ("Shrinking preallocation to %u processes", TargetNumber()));
+    PROFILER_MARKER_TEXT("Process", DOM, {}, "Shrank preallocation"_ns);
+    CloseExtraProcesses();
+    if (!mExtraPreallocs) {
+      return;
+    }
+    sinceGrowth = 0;
+  }
+
+  mShrinkScheduled = true;
+  NS_DelayedDispatchToCurrentThread(
+      NewRunnableMethod("PreallocatedProcessManagerImpl::ShrinkAfterDecay",
+                        this, &PreallocatedProcessManagerImpl::ShrinkAfterDecay),
+      decayMs - uint32_t(sinceGrowth));
+}
+
+void PreallocatedProcessManagerImpl::CloseExtraProcesses() {
+  // Drop the most recently started processes, which are the likeliest to be
+  // still launching.
+  while (mPreallocatedProcesses.Length() > TargetNumber()) {
+    mPreallocatedProcesses.RemoveLastElement();
+  }
+}
+
 void PreallocatedProcessManagerImpl::Erase(ContentParent* aParent) {
   (void)mPreallocatedProcesses.RemoveElement(aParent);
 }
@@ -272,7 +379,7 @@ void PreallocatedProcessManagerImpl::RemoveBlocker(ContentParent* aParent) {
 
 bool PreallocatedProcessManagerImpl::CanAllocate() {
   return IsEnabled() && sNumBlockers == 0 &&
-         mPreallocatedProcesses.Length() < mNumberPreallocs && !IsShutdown() &&
+         mPreallocatedProcesses.Length() < TargetNumber() && !IsShutdown() &&
          (FissionAutostart() ||
           !ContentParent::IsMaxProcessCountReached(DEFAULT_REMOTE_TYPE));
 }
@@ -341,7 +448,7 @@ void PreallocatedProcessManagerImpl::AllocateNow() {
             } else if (self->CanAllocate()) {
               // Continue prestarting processes if needed
               if (self->mPreallocatedProcesses.Length() <
-                  self->mNumberPreallocs) {
+                  self->TargetNumber()) {
                 self->AllocateOnIdle();
               }
             }
@@ -352,8 +459,8 @@ void PreallocatedProcessManagerImpl::AllocateNow() {
 
   mPreallocatedProcesses.AppendElement(std::move(process));
   MOZ_LOG(ContentParent::GetLog(), LogLevel::Debug,
-          ("Preallocated = %lu of %d processes",
-           (unsigned long)mPreallocatedProcesses.Length(), mNumberPreallocs));
+          ("Preallocated = %lu of %u processes",
+           (unsigned long)mPreallocatedProcesses.Length(), TargetNumber()));
 }
 
 void PreallocatedProcessManagerImpl::Disable() {
@@ -362,6 +469,7 @@ void PreallocatedProcessManagerImpl::Disable() {
   }
 
   mEnabled = false;
+  mExtraPreallocs = 0;
   CloseProcesses();
 }
 
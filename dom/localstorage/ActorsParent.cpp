@@ -227,7 +227,18 @@ static_assert(kSQLiteGrowthIncrement >= 0 &&
 constexpr auto kDataFileName = u"data.sqlite"_ns;
 
 /**
- * The journal corresponding to kDataFileName.  (We don't use WAL mode.)
+ * The write-ahead log corresponding to kDataFileName, and its shared memory
+ * index.  Flushes append their changes to the log, and SQLite moves them into
+ * the database in batches (see SetJournalMode).
+ */
+constexpr auto kWALFileName = u"data.sqlite-wal"_ns;
+
+#ifdef DEBUG
+constexpr auto kSHMFileName = u"data.sqlite-shm"_ns;
+#endif
+
+/**
+ * The journal corresponding to kDataFileName, if WAL mode couldn't be enabled.
  * Currently only needed in QuotaClient::InitOrigin and only in DEBUG builds.
  * See the corresponding comment in QuotaClient::InitOrigin.
  */
@@ -341,6 +352,9 @@ const uint32_t kPreparedDatastoreTimeoutMs = 20000;
 // Shadow database Write Ahead Log's maximum size is 512KB
 const uint32_t kShadowMaxWALSize = 512 * 1024;
 
+// Per-origin database Write Ahead Log's maximum size is 512KB as well
+const uint32_t kMaxWALSize = 512 * 1024;
+
 bool IsOnGlobalConnectionThread();
 
 void AssertIsOnGlobalConnectionThread();
@@ -496,6 +510,49 @@ nsresult SetDefaultPragmas(mozIStorageConnection* aConnection) {
   return NS_OK;
 }
 
+nsresult SetJournalMode(mozIStorageConnection* aConnection,
+                        uint32_t aMaxWALSize) {
+  MOZ_ASSERT(IsOnIOThread() || IsOnGlobalConnectionThread());
+  MOZ_ASSERT(aConnection);
+
+  // Try enabling WAL mode. This can fail in various circumstances so we have to
+  // check the results here.
+  constexpr auto journalModeQueryStart = "PRAGMA journal_mode = "_ns;
+  constexpr auto journalModeWAL = "wal"_ns;
+
+  QM_TRY_INSPECT(const auto& stmt,
+                 CreateAndExecuteSingleStepStatement(
+                     *aConnection, journalModeQueryStart + journalModeWAL));
+
+  QM_TRY_INSPECT(const auto& journalMode,
+                 MOZ_TO_RESULT_INVOKE_MEMBER_TYPED(nsAutoCString, *stmt,
+                                                   GetUTF8String, 0));
+
+  if (journalMode.Equals(journalModeWAL)) {
+    // WAL mode successfully enabled. Set limits on its size here.
+
+    // Set the threshold for auto-checkpointing the WAL. We don't want giant
+    // logs slowing down us.
+    QM_TRY_INSPECT(const auto& stmt, CreateAndExecuteSingleStepStatement(
+                                         *aConnection, "PRAGMA page_size;"_ns));
+
+    QM_TRY_INSPECT(const int32_t& pageSize,
+                   MOZ_TO_RESULT_INVOKE_MEMBER(*stmt, GetInt32, 0));
+
+    MOZ_ASSERT(pageSize >= 512 && pageSize <= 65536);
+
+    // Note there is a default journal_size_limit set by mozStorage.
+    QM_TRY(MOZ_TO_RESULT(aConnection->ExecuteSimpleSQL(
+        "PRAGMA wal_autocheckpoint = "_ns +
+        IntToCString(static_cast<int32_t>(aMaxWALSize / pageSize)))));
+  } else {
+    QM_TRY(MOZ_TO_RESULT(
+        aConnection->ExecuteSimpleSQL(journalModeQueryStart + "truncate"_ns)));
+  }
+
+  return NS_OK;
+}
+
 Result<nsCOMPtr<mozIStorageConnection>, nsresult> CreateStorageConnection(
     nsIFile& aDBFile, nsIFile& aUsageFile, const nsACString& aOrigin) {
   MOZ_ASSERT(IsOnIOThread() || IsOnGlobalConnectionThread());
@@ -653,6 +710,11 @@ Result<nsCOMPtr<mozIStorageConnection>, nsresult> CreateStorageConnection(
     }
   }
 
+  // Enable WAL mode only now, the page size of new databases can't be changed
+  // anymore once it is.  The mode is persistent, so connections opened later
+  // by GetStorageConnection use it as well.
+  QM_TRY(MOZ_TO_RESULT(SetJournalMode(connection, kMaxWALSize)));
+
   return connection;
 }
 
@@ -688,7 +750,22 @@ CreateStorageConnectionWithRecovery(
         // database file, which might fail.
         aCorruptedFileHandler();
 
-        // Nuke the database file.
+        // Nuke the database file, and its log, which SQLite would otherwise
+        // apply to the new database.
+        QM_TRY_INSPECT(const auto& walFile,
+                       MOZ_TO_RESULT_INVOKE_MEMBER_TYPED(nsCOMPtr<nsIFile>,
+                                                         aDBFile, Clone));
+
+        QM_TRY(MOZ_TO_RESULT(walFile->SetLeafName(kWALFileName)));
+
+        QM_TRY(QM_OR_ELSE_WARN_IF(
+            // Expression.
+            MOZ_TO_RESULT(walFile->Remove(false)),
+            // Predicate.
+            ([](const nsresult rv) { return rv == NS_ERROR_FILE_NOT_FOUND; }),
+            // Fallback.
+            ErrToDefaultOk<>));
+
         QM_TRY(MOZ_TO_RESULT(aDBFile.Remove(false)));
 
         QM_TRY_RETURN(CreateStorageConnection(aDBFile, aUsageFile, aOrigin));
@@ -798,48 +875,6 @@ Result<nsCOMPtr<nsIFile>, nsresult> GetShadowFile(const nsAString& aBasePath) {
   return archiveFile;
 }
 
-nsresult SetShadowJournalMode(mozIStorageConnection* aConnection) {
-  MOZ_ASSERT(IsOnIOThread() || IsOnGlobalConnectionThread());
-  MOZ_ASSERT(aConnection);
-
-  // Try enabling WAL mode. This can fail in various circumstances so we have to
-  // check the results here.
-  constexpr auto journalModeQueryStart = "PRAGMA journal_mode = "_ns;
-  constexpr auto journalModeWAL = "wal"_ns;
-
-  QM_TRY_INSPECT(const auto& stmt,
-                 CreateAndExecuteSingleStepStatement(
-                     *aConnection, journalModeQueryStart + journalModeWAL));
-
-  QM_TRY_INSPECT(const auto& journalMode,
-                 MOZ_TO_RESULT_INVOKE_MEMBER_TYPED(nsAutoCString, *stmt,
-                                                   GetUTF8String, 0));
-
-  if (journalMode.Equals(journalModeWAL)) {
-    // WAL mode successfully enabled. Set limits on its size here.
-
-    // Set the threshold for auto-checkpointing the WAL. We don't want giant
-    // logs slowing down us.
-    QM_TRY_INSPECT(const auto& stmt, CreateAndExecuteSingleStepStatement(
-                                         *aConnection, "PRAGMA page_size;"_ns));
-
-    QM_TRY_INSPECT(const int32_t& pageSize,
-                   MOZ_TO_RESULT_INVOKE_MEMBER(*stmt, GetInt32, 0));
-
-    MOZ_ASSERT(pageSize >= 512 && pageSize <= 65536);
-
-    // Note there is a default journal_size_limit set by mozStorage.
-    QM_TRY(MOZ_TO_RESULT(aConnection->ExecuteSimpleSQL(
-        "PRAGMA wal_autocheckpoint = "_ns +
-        IntToCString(static_cast<int32_t>(kShadowMaxWALSize / pageSize)))));
-  } else {
-    QM_TRY(MOZ_TO_RESULT(
-        aConnection->ExecuteSimpleSQL(journalModeQueryStart + "truncate"_ns)));
-  }
-
-  return NS_OK;
-}
-
 Result<nsCOMPtr<mozIStorageConnection>, nsresult> CreateShadowStorageConnection(
     const nsAString& aBasePath) {
   MOZ_ASSERT(IsOnIOThread() || IsOnGlobalConnectionThread());
@@ -871,7 +906,7 @@ Result<nsCOMPtr<mozIStorageConnection>, nsresult> CreateShadowStorageConnection(
                 shadowFile, mozIStorageService::CONNECTION_DEFAULT));
           })));
 
-  QM_TRY(MOZ_TO_RESULT(SetShadowJournalMode(connection)));
+  QM_TRY(MOZ_TO_RESULT(SetJournalMode(connection, kShadowMaxWALSize)));
 
   // XXX Depending on whether the *first* call to OpenUnsharedDatabase above
   // failed, we (a) might or (b) might not be dealing with a fresh database
@@ -900,7 +935,7 @@ Result<nsCOMPtr<mozIStorageConnection>, nsresult> CreateShadowStorageConnection(
                                       OpenUnsharedDatabase, shadowFile,
                                       mozIStorageService::CONNECTION_DEFAULT));
 
-        QM_TRY(MOZ_TO_RESULT(SetShadowJournalMode(connection)));
+        QM_TRY(MOZ_TO_RESULT(SetJournalMode(connection, kShadowMaxWALSize)));
 
         QM_TRY(
             MOZ_TO_RESULT(StorageDBUpdater::CreateCurrentSchema(connection)));
@@ -8581,6 +8616,8 @@ Result<UsageInfo, nsresult> QuotaClient::InitOrigin(
                 MOZ_TO_RESULT_INVOKE_MEMBER_TYPED(nsString, file, GetLeafName));
 
             if (leafName.Equals(kDataFileName) ||
+                leafName.Equals(kWALFileName) ||
+                leafName.Equals(kSHMFileName) ||
                 leafName.Equals(kJournalFileName) ||
                 leafName.Equals(kUsageFileName) ||
                 leafName.Equals(kUsageJournalFileName)) {
@@ -17,6 +17,9 @@
 
 namespace mozilla {
 
+// The most consecutive blocks that PerformBlockIOs() writes at once.
+static constexpr size_t kMaxBlocksPerWrite = PR_MAX_IOVECTOR_SIZE;
+
 #undef LOG
 LazyLogModule gFileBlockCacheLog("FileBlockCache");
 #define LOG(x, ...) \
@@ -302,6 +305,50 @@ nsresult FileBlockCache::WriteBlockToFile(int32_t aBlockIndex,
   return NS_OK;
 }
 
+nsresult FileBlockCache::WriteBlocksToFile(
+    int32_t aFirstBlockIndex, const nsTArray<RefPtr<BlockChange>>& aChanges) {
+  LOG("WriteBlocksToFile(index=%u, count=%zu)", aFirstBlockIndex,
+      aChanges.Length());
+
+  mFileMutex.AssertCurrentThreadOwns();
+  MOZ_ASSERT(mFD);
+  MOZ_ASSERT(aChanges.Length() <= kMaxBlocksPerWrite);
+
+  nsresult rv = Seek(BlockIndexToOffset(aFirstBlockIndex));
+  if (NS_FAILED(rv)) return rv;
+
+#ifdef XP_WIN
+  // NSPR doesn't implement PR_Writev() for files on Windows, but the blocks
+  // are consecutive, so at least we don't seek between them.
+  for (const RefPtr<BlockChange>& change : aChanges) {
+    MOZ_ASSERT(change->IsWrite());
+    int32_t amount = PR_Write(mFD, change->mData.get(), BLOCK_SIZE);
+    if (amount < BLOCK_SIZE) {
+      NS_WARNING("Failed to write media cache block!");
+      return NS_ERROR_FAILURE;
+    }
+    mFDCurrentPos += BLOCK_SIZE;
+  }
+#else
+  PRIOVec iov[kMaxBlocksPerWrite];
+  for (size_t i = 0; i < aChanges.Length(); i++) {
+    MOZ_ASSERT(aChanges[i]->IsWrite());
+    iov[i].iov_base = reinterpret_cast<char*>(aChanges[i]->mData.get());
+    iov[i].iov_len = BLOCK_SIZE;
+  }
+  int32_t length = int32_t(aChanges.Length()) * BLOCK_SIZE;
+  int32_t amount = PR_Writev(mFD, iov, int32_t(aChanges.Length()),
+                             PR_INTERVAL_NO_TIMEOUT);
+  if (amount < length) {
+    NS_WARNING("Failed to write media cache blocks!");
+    return NS_ERROR_FAILURE;
+  }
+  mFDCurrentPos += length;
+#endif
+
+  return NS_OK;
+}
+
 nsresult FileBlockCache::MoveBlockInFile(int32_t aSourceBlockIndex,
                                          int32_t aDestBlockIndex) {
   LOG("MoveBlockInFile(src=%u, dest=%u)", aSourceBlockIndex, aDestBlockIndex);
@@ -353,6 +400,22 @@ void FileBlockCache::PerformBlockIOs() {
     MOZ_ASSERT(change,
                "Change index list should only contain entries for blocks "
                "with changes");
+
+    // Media is mostly cached sequentially, so the next changes are often
+    // writes to the blocks that follow this one. Write those along with it,
+    // to save system calls and trips through the mutexes.
+    AutoTArray<RefPtr<BlockChange>, kMaxBlocksPerWrite> writes;
+    if (change->IsWrite()) {
+      writes.AppendElement(change);
+      for (auto it = mChangeIndexList.begin() + 1;
+           it != mChangeIndexList.end() &&
+           writes.Length() < kMaxBlocksPerWrite &&
+           *it == blockIndex + int32_t(writes.Length()) &&
+           mBlockChanges[*it]->IsWrite();
+           ++it) {
+        writes.AppendElement(mBlockChanges[*it]);
+      }
+    }
     {
       MutexAutoUnlock unlock(mDataMutex);
       MutexAutoLock lock(mFileMutex);
@@ -361,18 +424,25 @@ void FileBlockCache::PerformBlockIOs() {
         // don't care anymore about writes.
         return;
       }
-      if (change->IsWrite()) {
-        WriteBlockToFile(blockIndex, change->mData.get());
+      if (!writes.IsEmpty()) {
+        WriteBlocksToFile(blockIndex, writes);
       } else if (change->IsMove()) {
         MoveBlockInFile(change->mSourceBlockIndex, blockIndex);
       }
     }
-    mChangeIndexList.pop_front();  // MonitorAutoUnlock above
-    // If a new change has not been made to the block while we dropped
-    // mDataMutex, clear reference to the old change. Otherwise, the old
-    // reference has been cleared already.
-    if (mBlockChanges[blockIndex] == change) {  // MonitorAutoUnlock above
-      mBlockChanges[blockIndex] = nullptr;      // MonitorAutoUnlock above
+    // Only this function removes indices from the list, so the ones we
+    // handled are still at its front.
+    size_t handled = std::max<size_t>(writes.Length(), 1);
+    for (size_t i = 0; i < handled; i++) {
+      int32_t index = mChangeIndexList.front();
+      const RefPtr<BlockChange>& done = writes.IsEmpty() ? change : writes[i];
+      mChangeIndexList.pop_front();  // MonitorAutoUnlock above
+      // If a new change has not been made to the block while we dropped
+      // mDataMutex, clear reference to the old change. Otherwise, the old
+      // reference has been cleared already.
+      if (mBlockChanges[index] == done) {  // MonitorAutoUnlock above
+        mBlockChanges[index] = nullptr;    // MonitorAutoUnlock above
+      }
     }
   }
 
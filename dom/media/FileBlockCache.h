@@ -149,6 +149,10 @@ class FileBlockCache : public MediaBlockCacheBase {
   nsresult ReadFromFile(int64_t aOffset, uint8_t* aDest, int32_t aBytesToRead,
                         int32_t& aBytesRead);
   nsresult WriteBlockToFile(int32_t aBlockIndex, const uint8_t* aBlockData);
+  // Writes the blocks of aChanges, which must all be writes, to consecutive
+  // blocks starting at aFirstBlockIndex.
+  nsresult WriteBlocksToFile(int32_t aFirstBlockIndex,
+                             const nsTArray<RefPtr<BlockChange>>& aChanges);
   // File descriptor we're writing to. This is created externally, but
   // shutdown by us.
   PRFileDesc* mFD MOZ_PT_GUARDED_BY(mFileMutex);
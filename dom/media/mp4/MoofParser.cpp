@@ -86,6 +86,9 @@ bool MoofParser::RebuildFragmentedIndex(BoxContext& aContext) {
         // Stitch time ranges together in the case of a (hopefully small) time
         // range gap between moofs.
         mMoofs.LastElement().FixRounding(moof);
+        if (moof.mTimeRange.end < mMoofs.LastElement().mTimeRange.end) {
+          mHasOrderedTimeRanges = false;
+        }
       }
 
       mMediaRanges.AppendElement(moof.mRange);
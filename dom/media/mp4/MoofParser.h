@@ -341,6 +341,10 @@ class MoofParser : public DecoderDoctorLifeLogger<MoofParser> {
 
   nsTArray<Moof>& Moofs() { return mMoofs; }
 
+  // Whether the time ranges of the moofs end in increasing order, so that
+  // they can be binary searched by time.
+  bool HasOrderedTimeRanges() const { return mHasOrderedTimeRanges; }
+
  private:
   void ScanForMetadata(mozilla::MediaByteRange& aMoov);
   nsTArray<Moof> mMoofs;
@@ -348,6 +352,7 @@ class MoofParser : public DecoderDoctorLifeLogger<MoofParser> {
   nsTArray<TrackEndCts> mTracksEndCts;
   bool mIsAudio;
   uint64_t mLastDecodeTime;
+  bool mHasOrderedTimeRanges = true;
   // Either a ParseAllTracks if in multitrack mode, or an integer representing
   // the track_id for the track being parsed. If parsing a specific track, mTrex
   // should have an id matching mTrackParseMode.as<uint32_t>(). In this case 0
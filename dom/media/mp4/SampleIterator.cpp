@@ -408,6 +408,36 @@ void SampleIterator::Seek(const TimeUnit& aTime) {
   size_t syncSample = 0;
   mCurrentMoof = 0;
   mCurrentSample = 0;
+  MoofParser* moofParser = mIndex->mMoofParser.get();
+  if (moofParser && moofParser->HasOrderedTimeRanges()) {
+    // Every sample of the moofs that end before aTime starts before it, so
+    // rather than walking them we start from the first moof that doesn't,
+    // and from the last sync sample before it.
+    nsTArray<Moof>& moofs = moofParser->Moofs();
+    size_t lo = 0;
+    size_t hi = moofs.Length();
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (moofs[mid].mTimeRange.end < aTime) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    mCurrentMoof = lo;
+    bool foundSync = false;
+    for (size_t i = lo; i-- > 0 && !foundSync;) {
+      const FallibleTArray<Sample>& samples = moofs[i].mIndex;
+      for (size_t j = samples.Length(); j-- > 0;) {
+        if (samples[j].mSync) {
+          syncMoof = i;
+          syncSample = j;
+          foundSync = true;
+          break;
+        }
+      }
+    }
+  }
   Sample* sample;
   while (!!(sample = Get())) {
     if (sample->mCompositionRange.start > aTime) {
@@ -15,7 +15,7 @@
 #  include "mozilla/SSE.h"
 #  include "AudioNodeEngineGeneric.h"
 #endif
-#if defined(USE_SSE42) && defined(USE_FMA3)
+#if defined(USE_SSE4_2) && defined(USE_FMA3)
 #  include "mozilla/SSE.h"
 #  include "AudioNodeEngineGeneric.h"
 #endif
@@ -78,7 +78,7 @@ void AudioBufferAddWithScale(const float* aInput, float aScale, float* aOutput,
 
 #ifdef USE_SSE2
   if (mozilla::supports_sse2()) {
-#  if defined(USE_SSE42) && defined(USE_FMA3)
+#  if defined(USE_SSE4_2) && defined(USE_FMA3)
     if (mozilla::supports_fma3() && mozilla::supports_sse4_2()) {
       Engine<xsimd::fma3<xsimd::sse4_2>>::AudioBufferAddWithScale(
           aInput, aScale, aOutput, aSize);
@@ -146,7 +146,7 @@ void BufferComplexMultiply(const float* aInput, const float* aScale,
 #endif
 #ifdef USE_SSE2
   if (mozilla::supports_sse()) {
-#  if defined(USE_SSE42) && defined(USE_FMA3)
+#  if defined(USE_SSE4_2) && defined(USE_FMA3)
     if (mozilla::supports_fma3() && mozilla::supports_sse4_2()) {
       Engine<xsimd::fma3<xsimd::sse4_2>>::BufferComplexMultiply(aInput, aScale,
                                                                 aOutput, aSize);
@@ -291,7 +291,7 @@ void AudioBlockPanStereoToStereo(const float aInputL[WEBAUDIO_BLOCK_SIZE],
 
 #ifdef USE_SSE2
   if (mozilla::supports_sse2()) {
-#  if defined(USE_SSE42) && defined(USE_FMA3)
+#  if defined(USE_SSE4_2) && defined(USE_FMA3)
     if (mozilla::supports_fma3() && mozilla::supports_sse4_2()) {
       Engine<xsimd::fma3<xsimd::sse4_2>>::AudioBlockPanStereoToStereo(
           aInputL, aInputR, aGainL, aGainR, aIsOnTheLeft, aOutputL, aOutputR);
@@ -337,9 +337,9 @@ void AudioBlockPanStereoToStereo(const float aInputL[WEBAUDIO_BLOCK_SIZE],
 
 #ifdef USE_SSE2
   if (mozilla::supports_sse2()) {
-#  if defined(USE_SSE42) && defined(USE_FMA3)
+#  if defined(USE_SSE4_2) && defined(USE_FMA3)
     if (mozilla::supports_fma3() && mozilla::supports_sse4_2()) {
-      Engine<xsimd::fma3<xsimd::sse2>>::AudioBlockPanStereoToStereo(
+      Engine<xsimd::fma3<xsimd::sse4_2>>::AudioBlockPanStereoToStereo(
           aInputL, aInputR, aGainL, aGainR, aIsOnTheLeft, aOutputL, aOutputR);
     } else
 #  endif
@@ -372,7 +372,7 @@ float AudioBufferSumOfSquares(const float* aInput, uint32_t aLength) {
 
 #ifdef USE_SSE2
   if (mozilla::supports_sse()) {
-#  if defined(USE_SSE42) && defined(USE_FMA3)
+#  if defined(USE_SSE4_2) && defined(USE_FMA3)
     if (mozilla::supports_fma3() && mozilla::supports_sse4_2()) {
       return Engine<xsimd::fma3<xsimd::sse4_2>>::AudioBufferSumOfSquares(
           aInput, aLength);
@@ -54,6 +54,8 @@ class MediaTransportParent : public dom::PMediaTransportParent {
                                               const string& ufrag,
                                               const string& obfuscatedAddress);
   mozilla::ipc::IPCResult RecvUpdateNetworkState(const bool& online);
+  mozilla::ipc::IPCResult RecvSetKeepReceivedEncryptedPackets(
+      const bool& keep);
   mozilla::ipc::IPCResult RecvGetIceStats(const string& transportId,
                                           const double& now,
                                           GetIceStatsResolver&& aResolve);
@@ -124,6 +124,8 @@ class MediaTransportHandlerSTS : public MediaTransportHandler,
 
   void UpdateNetworkState(bool aOnline) override;
 
+  void SetKeepReceivedEncryptedPackets(bool aKeep) override;
+
   void SendPacket(const std::string& aTransportId,
                   MediaPacket&& aPacket) override;
 
@@ -183,6 +185,7 @@ class MediaTransportHandlerSTS : public MediaTransportHandler,
   uint32_t mMinDtlsVersion = 0;
   uint32_t mMaxDtlsVersion = 0;
   bool mForceNoHost = false;
+  bool mKeepReceivedEncryptedPackets = false;
   Maybe<NrIceCtx::NatSimulatorConfig> mNatConfig;
 
   std::set<std::string> mSignaledAddresses;
@@ -1045,6 +1048,30 @@ void MediaTransportHandlerSTS::UpdateNetworkState(bool aOnline) {
       [](const std::string& aError) {});
 }
 
+void MediaTransportHandlerSTS::SetKeepReceivedEncryptedPackets(bool aKeep) {
+  MOZ_RELEASE_ASSERT(mInitPromise);
+
+  mInitPromise->Then(
+      mStsThread, __func__,
+      [=, self = RefPtr<MediaTransportHandlerSTS>(this)]() {
+        mKeepReceivedEncryptedPackets = aKeep;
+        for (const auto& [id, transport] : mTransports) {
+          for (const RefPtr<TransportFlow>& flow :
+               {transport.mFlow, transport.mRtcpFlow}) {
+            if (!flow) {
+              continue;
+            }
+            // Flows of data channels don't have an SRTP layer.
+            if (auto* srtp = static_cast<TransportLayerSrtp*>(
+                    flow->GetLayer(TransportLayerSrtp::ID()))) {
+              srtp->SetKeepEncryptedPackets(aKeep);
+            }
+          }
+        }
+      },
+      [](const std::string& aError) {});
+}
+
 void MediaTransportHandlerSTS::RemoveTransportsExcept(
     const std::set<std::string>& aTransportIds) {
   MOZ_RELEASE_ASSERT(mInitPromise);
@@ -1529,6 +1556,7 @@ RefPtr<TransportFlow> MediaTransportHandlerSTS::CreateTransportFlow(
   auto ice = MakeUnique<TransportLayerIce>();
   auto dtls = MakeUnique<TransportLayerDtls>();
   auto srtp = MakeUnique<TransportLayerSrtp>(*dtls);
+  srtp->SetKeepEncryptedPackets(mKeepReceivedEncryptedPackets);
   dtls->SetRole(aDtlsClient ? TransportLayerDtls::CLIENT
                             : TransportLayerDtls::SERVER);
 
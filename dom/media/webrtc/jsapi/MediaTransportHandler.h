@@ -118,6 +118,10 @@ class MediaTransportHandler {
 
   virtual void UpdateNetworkState(bool aOnline) = 0;
 
+  // Received packets only keep their encrypted data while somebody dumps
+  // SRTP or SRTCP packets, since it costs a copy of every packet.
+  virtual void SetKeepReceivedEncryptedPackets(bool aKeep) = 0;
+
   virtual RefPtr<dom::RTCStatsPromise> GetIceStats(
       const std::string& aTransportId, DOMHighResTimeStamp aNow) = 0;
 
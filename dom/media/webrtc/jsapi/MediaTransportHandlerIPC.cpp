@@ -350,6 +350,17 @@ void MediaTransportHandlerIPC::UpdateNetworkState(bool aOnline) {
       [](const nsCString& aError) {});
 }
 
+void MediaTransportHandlerIPC::SetKeepReceivedEncryptedPackets(bool aKeep) {
+  mInitPromise->Then(
+      mCallbackThread, __func__,
+      [=, self = RefPtr<MediaTransportHandlerIPC>(this)](bool /*dummy*/) {
+        if (mChild) {
+          mChild->SendSetKeepReceivedEncryptedPackets(aKeep);
+        }
+      },
+      [](const nsCString& aError) {});
+}
+
 RefPtr<dom::RTCStatsPromise> MediaTransportHandlerIPC::GetIceStats(
     const std::string& aTransportId, DOMHighResTimeStamp aNow) {
   using IPCPromise = dom::PMediaTransportChild::GetIceStatsPromise;
@@ -72,6 +72,8 @@ class MediaTransportHandlerIPC final : public MediaTransportHandler {
 
   void UpdateNetworkState(bool aOnline) override;
 
+  void SetKeepReceivedEncryptedPackets(bool aKeep) override;
+
   RefPtr<dom::RTCStatsPromise> GetIceStats(const std::string& aTransportId,
                                            DOMHighResTimeStamp aNow) override;
 
@@ -217,6 +217,12 @@ mozilla::ipc::IPCResult MediaTransportParent::RecvUpdateNetworkState(
   return ipc::IPCResult::Ok();
 }
 
+mozilla::ipc::IPCResult
+MediaTransportParent::RecvSetKeepReceivedEncryptedPackets(const bool& keep) {
+  mImpl->mHandler->SetKeepReceivedEncryptedPackets(keep);
+  return ipc::IPCResult::Ok();
+}
+
 mozilla::ipc::IPCResult MediaTransportParent::RecvGetIceStats(
     const string& transportId, const double& now,
     GetIceStatsResolver&& aResolve) {
@@ -28,7 +28,8 @@ void PacketDumper::Dump(size_t aLevel, dom::mozPacketDumpType aType,
                         bool aSending, const void* aData, size_t aSize) {
   // Optimization; avoids making a copy of the buffer, but we need to lock a
   // mutex and check the flags. Could be optimized further, if we really want to
-  if (!ShouldDumpPacket(aLevel, aType, aSending)) {
+  // Encrypted packets received before dumping was enabled have no data.
+  if (!aSize || !ShouldDumpPacket(aLevel, aType, aSending)) {
     return;
   }
 
@@ -127,6 +128,22 @@ nsresult PacketDumper::DisablePacketDump(unsigned long aLevel,
   return NS_OK;
 }
 
+bool PacketDumper::ShouldDumpReceivedEncryptedPackets() const {
+  if (!mPacketDumpEnabled) {
+    return false;
+  }
+
+  unsigned flags = (1 << (unsigned)dom::mozPacketDumpType::Srtp) |
+                   (1 << (unsigned)dom::mozPacketDumpType::Srtcp);
+  MutexAutoLock lock(mPacketDumpFlagsMutex);
+  for (unsigned levelFlags : mRecvPacketDumpFlags) {
+    if (levelFlags & flags) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool PacketDumper::ShouldDumpPacket(size_t aLevel, dom::mozPacketDumpType aType,
                                     bool aSending) const {
   if (!mPacketDumpEnabled) {
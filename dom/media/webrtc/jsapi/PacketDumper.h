@@ -32,6 +32,9 @@ class PacketDumper {
   nsresult DisablePacketDump(unsigned long aLevel, dom::mozPacketDumpType aType,
                              bool aSending);
 
+  // Whether received SRTP or SRTCP packets are dumped at any level.
+  bool ShouldDumpReceivedEncryptedPackets() const;
+
  private:
   friend class PeerConnectionImpl;
   explicit PacketDumper(const std::string& aPcHandle);
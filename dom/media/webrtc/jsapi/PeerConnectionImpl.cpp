@@ -1960,13 +1960,24 @@ void PeerConnectionImpl::DumpPacket_m(size_t level, dom::mozPacketDumpType type,
 nsresult PeerConnectionImpl::EnablePacketDump(unsigned long level,
                                               dom::mozPacketDumpType type,
                                               bool sending) {
-  return GetPacketDumper()->EnablePacketDump(level, type, sending);
+  nsresult rv = GetPacketDumper()->EnablePacketDump(level, type, sending);
+  UpdateKeepReceivedEncryptedPackets();
+  return rv;
 }
 
 nsresult PeerConnectionImpl::DisablePacketDump(unsigned long level,
                                                dom::mozPacketDumpType type,
                                                bool sending) {
-  return GetPacketDumper()->DisablePacketDump(level, type, sending);
+  nsresult rv = GetPacketDumper()->DisablePacketDump(level, type, sending);
+  UpdateKeepReceivedEncryptedPackets();
+  return rv;
+}
+
+void PeerConnectionImpl::UpdateKeepReceivedEncryptedPackets() {
+  if (mTransportHandler) {
+    mTransportHandler->SetKeepReceivedEncryptedPackets(
+        GetPacketDumper()->ShouldDumpReceivedEncryptedPackets());
+  }
 }
 
 void PeerConnectionImpl::StampTimecard(const char* aEvent) {
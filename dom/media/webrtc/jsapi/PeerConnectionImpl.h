@@ -621,6 +621,9 @@ class PeerConnectionImpl final
 
   nsresult CheckApiState(bool assert_ice_ready) const;
   void StoreFinalStats(UniquePtr<dom::RTCStatsReportInternal>&& report);
+  // Tells the transport whether received packets need to keep their
+  // encrypted data for the packet dumper.
+  void UpdateKeepReceivedEncryptedPackets();
   void CheckThread() const { MOZ_ASSERT(NS_IsMainThread(), "Wrong thread"); }
 
   // test-only: called from AddRIDExtension and AddRIDFilter
@@ -189,8 +189,10 @@ void TransportLayerSrtp::PacketReceived(TransportLayer* layer,
     return;
   }
 
-  // We want to keep the encrypted packet around for packet dumping
-  packet.CopyDataToEncrypted();
+  if (mKeepEncryptedPackets) {
+    // We want to keep the encrypted packet around for packet dumping
+    packet.CopyDataToEncrypted();
+  }
   int outLen;
   nsresult res;
 
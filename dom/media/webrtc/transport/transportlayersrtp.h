@@ -30,6 +30,10 @@ class TransportLayerSrtp final : public TransportLayer {
   void StateChange(TransportLayer* layer, State state);
   void PacketReceived(TransportLayer* layer, MediaPacket& packet);
 
+  // Whether received packets keep a copy of their encrypted data, for
+  // packet dumping.
+  void SetKeepEncryptedPackets(bool aKeep) { mKeepEncryptedPackets = aKeep; }
+
   TRANSPORT_LAYER_ID("srtp")
 
  private:
@@ -37,6 +41,7 @@ class TransportLayerSrtp final : public TransportLayer {
   DISALLOW_COPY_ASSIGN(TransportLayerSrtp);
   RefPtr<SrtpFlow> mSendSrtp;
   RefPtr<SrtpFlow> mRecvSrtp;
+  bool mKeepEncryptedPackets = false;
 };
 
 }  // namespace mozilla
@@ -293,6 +293,15 @@ const char kPrivateBrowsingObserverTopic[] = "last-pb-context-exited";
 
 const int32_t kCacheVersion = 2;
 
+// Values of the `valid` column of the `cache` table.  A journaled cache was
+// left behind by a session which didn't unload quota (e.g. because it
+// crashed), but which marked every origin it accessed as accessed in the
+// `origin` table (see QuotaManager::MarkOriginAccessedInCache), so only those
+// origins need to be initialized from disk again.
+const int32_t kCacheInvalid = 0;
+const int32_t kCacheValid = 1;
+const int32_t kCacheJournaled = 2;
+
 /******************************************************************************
  * SQLite functions
  ******************************************************************************/
@@ -1762,7 +1771,8 @@ QuotaManager::QuotaManager(const nsAString& aBasePath,
       mTemporaryStorageInitializedInternal(false),
       mInitializingAllTemporaryOrigins(false),
       mAllTemporaryOriginsInitialized(false),
-      mCacheUsable(false) {
+      mCacheUsable(false),
+      mCacheJournaled(false) {
   AssertIsOnOwningThread();
   MOZ_ASSERT(!gInstance);
 }
@@ -2681,26 +2691,33 @@ void QuotaManager::UpdateOriginAccessTime(const OriginMetadata& aOriginMetadata,
   AssertIsOnIOThread();
   MOZ_ASSERT(aOriginMetadata.mPersistenceType != PERSISTENCE_TYPE_PERSISTENT);
 
-  MutexAutoLock lock(mQuotaMutex);
+  {
+    MutexAutoLock lock(mQuotaMutex);
 
-  GroupInfoPair* pair;
-  if (!mGroupInfoPairs.Get(aOriginMetadata.mGroup, &pair)) {
-    return;
-  }
+    GroupInfoPair* pair;
+    if (!mGroupInfoPairs.Get(aOriginMetadata.mGroup, &pair)) {
+      return;
+    }
 
-  RefPtr<GroupInfo> groupInfo =
-      pair->LockedGetGroupInfo(aOriginMetadata.mPersistenceType);
-  if (!groupInfo) {
-    return;
-  }
+    RefPtr<GroupInfo> groupInfo =
+        pair->LockedGetGroupInfo(aOriginMetadata.mPersistenceType);
+    if (!groupInfo) {
+      return;
+    }
 
-  RefPtr<OriginInfo> originInfo =
-      groupInfo->LockedGetOriginInfo(aOriginMetadata.mOrigin);
-  if (!originInfo) {
-    return;
+    RefPtr<OriginInfo> originInfo =
+        groupInfo->LockedGetOriginInfo(aOriginMetadata.mOrigin);
+    if (!originInfo) {
+      return;
+    }
+
+    if (!originInfo->LockedUpdateAccessTime(aTimestamp)) {
+      return;
+    }
   }
 
-  originInfo->LockedUpdateAccessTime(aTimestamp);
+  // This is the first access of the origin in this session.
+  MarkOriginAccessedInCache(aOriginMetadata);
 }
 
 void QuotaManager::RemoveQuota() {
@@ -2761,6 +2778,39 @@ nsresult QuotaManager::LoadQuota() {
 
   const auto startTime = recordTimeDeltaHelper->Start();
 
+  // The state of the cache, see kCacheValid.
+  QM_TRY_INSPECT(
+      const int32_t& cacheState, ([this]() -> Result<int32_t, nsresult> {
+        if (mCacheUsable) {
+          QM_TRY_INSPECT(
+              const auto& stmt,
+              CreateAndExecuteSingleStepStatement<
+                  SingleStepResult::ReturnNullIfNoResult>(
+                  *mStorageConnection, "SELECT valid, build_id FROM cache"_ns));
+
+          QM_TRY(OkIf(stmt), Err(NS_ERROR_FILE_CORRUPTED));
+
+          QM_TRY_INSPECT(const int32_t& valid,
+                         MOZ_TO_RESULT_INVOKE_MEMBER(stmt, GetInt32, 0));
+
+          if (valid) {
+            if (!StaticPrefs::dom_quotaManager_caching_checkBuildId()) {
+              return valid;
+            }
+
+            QM_TRY_INSPECT(const auto& buildId,
+                           MOZ_TO_RESULT_INVOKE_MEMBER_TYPED(
+                               nsAutoCString, stmt, GetUTF8String, 1));
+
+            return buildId == *gBuildId ? valid : kCacheInvalid;
+          }
+        }
+
+        return kCacheInvalid;
+      }()));
+
+  const bool cacheJournaled = cacheState == kCacheJournaled;
+
   auto LoadQuotaFromCache = [&]() -> nsresult {
     QM_TRY_INSPECT(
         const auto& stmt,
@@ -2779,7 +2829,7 @@ nsresult QuotaManager::LoadQuota() {
 
     QM_TRY(quota::CollectWhileHasResult(
         *stmt,
-        [this,
+        [this, cacheJournaled,
          &MaybeCollectUnaccessedOrigin](auto& stmt) -> Result<Ok, nsresult> {
           QM_TRY_INSPECT(const int32_t& repositoryId,
                          MOZ_TO_RESULT_INVOKE_MEMBER(stmt, GetInt32, 0));
@@ -2848,6 +2898,20 @@ nsresult QuotaManager::LoadQuota() {
           // ensure consistency is in
           // EnsureTemporaryOriginIsInitializedInternal.)
 
+          if (cacheJournaled) {
+            // Origins which were removed or weren't created on disk yet in
+            // the session which journaled the cache still have a row.
+            QM_TRY_INSPECT(const auto& directory,
+                           GetOriginDirectory(fullOriginMetadata));
+
+            QM_TRY_INSPECT(const bool& exists,
+                           MOZ_TO_RESULT_INVOKE_MEMBER(directory, Exists));
+
+            if (!exists) {
+              return Ok{};
+            }
+          }
+
           if (accessed) {
             QM_TRY_INSPECT(const auto& directory,
                            GetOriginDirectory(fullOriginMetadata));
@@ -2919,47 +2983,21 @@ nsresult QuotaManager::LoadQuota() {
     return NS_OK;
   };
 
-  QM_TRY_INSPECT(
-      const bool& loadQuotaFromCache, ([this]() -> Result<bool, nsresult> {
-        if (mCacheUsable) {
-          QM_TRY_INSPECT(
-              const auto& stmt,
-              CreateAndExecuteSingleStepStatement<
-                  SingleStepResult::ReturnNullIfNoResult>(
-                  *mStorageConnection, "SELECT valid, build_id FROM cache"_ns));
-
-          QM_TRY(OkIf(stmt), Err(NS_ERROR_FILE_CORRUPTED));
-
-          QM_TRY_INSPECT(const int32_t& valid,
-                         MOZ_TO_RESULT_INVOKE_MEMBER(stmt, GetInt32, 0));
-
-          if (valid) {
-            if (!StaticPrefs::dom_quotaManager_caching_checkBuildId()) {
-              return true;
-            }
-
-            QM_TRY_INSPECT(const auto& buildId,
-                           MOZ_TO_RESULT_INVOKE_MEMBER_TYPED(
-                               nsAutoCString, stmt, GetUTF8String, 1));
-
-            return buildId == *gBuildId;
-          }
-        }
-
-        return false;
-      }()));
-
   auto autoRemoveQuota = MakeScopeExit([&] {
     RemoveQuota();
     RemoveTemporaryOrigins();
   });
 
-  if (!loadQuotaFromCache ||
-      !StaticPrefs::dom_quotaManager_loadQuotaFromCache() ||
-      ![&LoadQuotaFromCache] {
+  if (cacheState != kCacheInvalid &&
+      StaticPrefs::dom_quotaManager_loadQuotaFromCache() &&
+      [&LoadQuotaFromCache] {
         QM_WARNONLY_TRY_UNWRAP(auto res, MOZ_TO_RESULT(LoadQuotaFromCache()));
         return static_cast<bool>(res);
       }()) {
+    // The cache has a row for every origin now, so it only needs to be kept
+    // up to date as origins are accessed.
+    mCacheJournaled = StaticPrefs::dom_quotaManager_caching_journal();
+  } else {
     // A keeper to defer the return only in Nightly, so that the telemetry data
     // for whole profile can be collected.
 #ifdef NIGHTLY_BUILD
@@ -3098,7 +3136,8 @@ void QuotaManager::UnloadQuota() {
           "UPDATE cache SET valid = :valid, build_id = :buildId;"_ns),
       QM_VOID);
 
-  QM_TRY(MOZ_TO_RESULT(stmt->BindInt32ByName("valid"_ns, 1)), QM_VOID);
+  QM_TRY(MOZ_TO_RESULT(stmt->BindInt32ByName("valid"_ns, kCacheValid)),
+         QM_VOID);
   QM_TRY(MOZ_TO_RESULT(stmt->BindUTF8StringByName("buildId"_ns, *gBuildId)),
          QM_VOID);
   QM_TRY(MOZ_TO_RESULT(stmt->Execute()), QM_VOID);
@@ -3142,6 +3181,58 @@ void QuotaManager::RemoveOriginFromCache(
   QM_TRY(MOZ_TO_RESULT(transaction.Commit()), QM_VOID);
 }
 
+void QuotaManager::MarkOriginAccessedInCache(
+    const OriginMetadata& aOriginMetadata) {
+  AssertIsOnIOThread();
+  MOZ_ASSERT(mStorageConnection);
+
+  if (!mCacheJournaled) {
+    return;
+  }
+
+  QM_WARNONLY_TRY(
+      ([this, &aOriginMetadata]() -> Result<Ok, nsresult> {
+        QM_TRY_INSPECT(
+            const auto& stmt,
+            MOZ_TO_RESULT_INVOKE_MEMBER_TYPED(
+                nsCOMPtr<mozIStorageStatement>, mStorageConnection,
+                CreateStatement,
+                "INSERT OR REPLACE INTO origin (repository_id, suffix, "
+                "group_, origin, client_usages, usage, last_access_time, "
+                "accessed, persisted) "
+                "VALUES (:repository_id, :suffix, :group_, :origin, "
+                ":client_usages, :usage, :last_access_time, :accessed, "
+                ":persisted)"_ns));
+
+        {
+          MutexAutoLock lock(mQuotaMutex);
+
+          RefPtr<OriginInfo> originInfo = LockedGetOriginInfo(
+              aOriginMetadata.mPersistenceType, aOriginMetadata);
+          if (!originInfo || originInfo->mIsPrivate) {
+            return Ok{};
+          }
+
+          QM_TRY(MOZ_TO_RESULT(originInfo->LockedBindToStatement(stmt)));
+        }
+
+        // The usage in the row may become stale, the origin has to be
+        // initialized from disk if the cache is loaded.
+        QM_TRY(MOZ_TO_RESULT(stmt->BindInt32ByName("accessed"_ns, 1)));
+
+        QM_TRY(MOZ_TO_RESULT(stmt->Execute()));
+
+        return Ok{};
+      }()),
+      ([this](const nsresult) {
+        // The cache can't be trusted anymore if the session doesn't end with
+        // UnloadQuota.
+        mCacheJournaled = false;
+
+        QM_WARNONLY_TRY(InvalidateCache(*mStorageConnection));
+      }));
+}
+
 already_AddRefed<QuotaObject> QuotaManager::GetQuotaObject(
     PersistenceType aPersistenceType, const OriginMetadata& aOriginMetadata,
     Client::Type aClientType, nsIFile* aFile, int64_t aFileSize,
@@ -3309,13 +3400,19 @@ Nullable<bool> QuotaManager::OriginPersisted(
 void QuotaManager::PersistOrigin(const OriginMetadata& aOriginMetadata) {
   AssertIsOnIOThread();
 
-  MutexAutoLock lock(mQuotaMutex);
+  {
+    MutexAutoLock lock(mQuotaMutex);
+
+    RefPtr<OriginInfo> originInfo =
+        LockedGetOriginInfo(PERSISTENCE_TYPE_DEFAULT, aOriginMetadata);
+    if (!originInfo || originInfo->LockedPersisted()) {
+      return;
+    }
 
-  RefPtr<OriginInfo> originInfo =
-      LockedGetOriginInfo(PERSISTENCE_TYPE_DEFAULT, aOriginMetadata);
-  if (originInfo && !originInfo->LockedPersisted()) {
     originInfo->LockedPersist();
   }
+
+  MarkOriginAccessedInCache(aOriginMetadata);
 }
 
 void QuotaManager::AbortOperationsForLocks(
@@ -6576,7 +6673,14 @@ nsresult QuotaManager::InitializeTemporaryStorageInternal() {
     CleanupTemporaryStorage();
   }
 
-  if (mCacheUsable) {
+  if (mCacheJournaled) {
+    QM_WARNONLY_TRY(
+        MOZ_TO_RESULT(mStorageConnection->ExecuteSimpleSQL(
+            "UPDATE cache SET valid = "_ns + IntToCString(kCacheJournaled))),
+        [this](const nsresult) { mCacheJournaled = false; });
+  }
+
+  if (mCacheUsable && !mCacheJournaled) {
     QM_TRY(InvalidateCache(*mStorageConnection));
   }
 
@@ -7061,6 +7165,7 @@ void QuotaManager::ShutdownStorageInternal() {
 
     mStorageConnection = nullptr;
     mCacheUsable = false;
+    mCacheJournaled = false;
   }
 
   mInitializationInfo.ResetFirstInitializationAttempts();
@@ -92,13 +92,16 @@ class OriginInfo final {
 
   UsageInfo LockedGetUsageForClient(Client::Type aClientType);
 
-  void LockedUpdateAccessTime(int64_t aAccessTime) {
+  // Returns true if this is the first access of the origin.
+  bool LockedUpdateAccessTime(int64_t aAccessTime) {
     AssertCurrentThreadOwnsQuotaMutex();
 
     mAccessTime = aAccessTime;
     if (!mAccessed) {
       mAccessed = true;
+      return true;
     }
+    return false;
   }
 
   void LockedPersist();
@@ -3082,6 +3082,7 @@ void ClearClientOp::DeleteFiles(const ClientMetadata& aClientMetadata) {
 
   if (aClientMetadata.mPersistenceType != PERSISTENCE_TYPE_PERSISTENT) {
     mQuotaManager->ResetUsageForClient(aClientMetadata);
+    mQuotaManager->MarkOriginAccessedInCache(aClientMetadata);
   }
 
   mQuotaManager->OriginClearCompleted(
@@ -245,6 +245,10 @@ class QuotaManager final : public BackgroundThreadObject {
 
   void RemoveOriginFromCache(const OriginMetadata& aOriginMetadata);
 
+  // Records in a journaled cache that the origin has been changed in this
+  // session, or does nothing if the cache isn't journaled.
+  void MarkOriginAccessedInCache(const OriginMetadata& aOriginMetadata);
+
   already_AddRefed<QuotaObject> GetQuotaObject(
       PersistenceType aPersistenceType, const OriginMetadata& aOriginMetadata,
       Client::Type aClientType, nsIFile* aFile, int64_t aFileSize = -1,
@@ -1133,6 +1137,9 @@ class QuotaManager final : public BackgroundThreadObject {
   bool mInitializingAllTemporaryOrigins;
   bool mAllTemporaryOriginsInitialized;
   bool mCacheUsable;
+  // Whether the cache stays valid while temporary storage is initialized,
+  // see MarkOriginAccessedInCache.
+  bool mCacheJournaled;
 };
 
 }  // namespace mozilla::dom::quota
@@ -107,6 +107,9 @@ class CompileOrDecodeTask : public mozilla::Task {
   // If the task is already running, this waits for the task to finish.
   void Cancel();
 
+  // Run the task as part of a CompileOrDecodeBatchTask, on its thread.
+  void RunInBatch();
+
  protected:
   // This mutex is locked during running the task or cancelling task.
   mozilla::Mutex mMutex;
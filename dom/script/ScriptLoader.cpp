@@ -79,6 +79,7 @@
 #include "mozilla/Logging.h"
 #include "nsCRT.h"
 #include "nsContentCreatorFunctions.h"
+#include "nsPrintfCString.h"
 #include "nsProxyRelease.h"
 #include "nsQueryObject.h"
 #include "nsINetworkPredictor.h"
@@ -1929,6 +1930,46 @@ class OffThreadCompilationCompleteTask : public Task {
 
 } /* anonymous namespace */
 
+// Runs the compile tasks of several small scripts one after the other, so
+// that they share the cost of dispatching a task to the thread pool and of
+// waking up a thread for it.
+class CompileOrDecodeBatchTask final : public Task {
+ public:
+  CompileOrDecodeBatchTask()
+      : Task(Kind::OffMainThreadOnly, EventQueuePriority::Normal) {}
+
+  void AppendTask(CompileOrDecodeTask* aTask) {
+    MOZ_ASSERT(NS_IsMainThread());
+    mTasks.AppendElement(aTask);
+  }
+
+  TaskResult Run() override {
+    TimeStamp startTime = TimeStamp::Now();
+    for (const RefPtr<CompileOrDecodeTask>& task : mTasks) {
+      task->RunInBatch();
+    }
+
+    PROFILER_MARKER_TEXT(
+        "ScriptCompileBatchOffThread", JS,
+        MarkerTiming::IntervalUntilNowFrom(startTime),
+        nsPrintfCString("%zu scripts", size_t(mTasks.Length())));
+
+    // The requests still hold the tasks, for ProcessOffThreadRequest.
+    mTasks.Clear();
+    return TaskResult::Complete;
+  }
+
+#ifdef MOZ_COLLECTING_RUNNABLE_TELEMETRY
+  bool GetName(nsACString& aName) override {
+    aName.AssignLiteral("ScriptCompileBatchTask");
+    return true;
+  }
+#endif
+
+ private:
+  nsTArray<RefPtr<CompileOrDecodeTask>> mTasks;
+};
+
 // TODO: This uses the same heuristics and the same threshold as the
 //       JS::CanCompileOffThread / JS::CanDecodeOffThread APIs, but the
 //       heuristics needs to be updated to reflect the change regarding the
@@ -1937,8 +1978,13 @@ class OffThreadCompilationCompleteTask : public Task {
 static constexpr size_t OffThreadMinimumTextLength = 5 * 1000;
 static constexpr size_t OffThreadMinimumBytecodeLength = 5 * 1000;
 
+// Smaller scripts are compiled on the main thread even when they are batched,
+// as the compilation doesn't take much longer than preparing it.
+static constexpr size_t OffThreadBatchMinimumTextLength = 1000;
+
 nsresult ScriptLoader::AttemptOffThreadScriptCompile(
-    ScriptLoadRequest* aRequest, bool* aCouldCompileOut) {
+    ScriptLoadRequest* aRequest, bool* aCouldCompileOut,
+    OffThreadCompileBatch* aBatch) {
   // If speculative parsing is enabled, the request may not be ready to run if
   // the element is not yet available.
   MOZ_ASSERT_IF(!SpeculativeOMTParsingEnabled() && !aRequest->IsModuleRequest(),
@@ -1980,7 +2026,9 @@ nsresult ScriptLoader::AttemptOffThreadScriptCompile(
     return rv;
   }
 
-  if (aRequest->IsTextSource()) {
+  if (aBatch) {
+    MOZ_ASSERT(aRequest->IsTextSource());
+  } else if (aRequest->IsTextSource()) {
     if (!StaticPrefs::javascript_options_parallel_parsing() ||
         aRequest->ScriptTextLength() < OffThreadMinimumTextLength) {
       TRACE_FOR_TEST(aRequest, "scriptloader_main_thread_compile");
@@ -2007,10 +2055,18 @@ nsresult ScriptLoader::AttemptOffThreadScriptCompile(
   completeTask->RecordStartTime();
 
   aRequest->GetScriptLoadContext()->mCompileOrDecodeTask = compileOrDecodeTask;
-  completeTask->AddDependency(compileOrDecodeTask);
 
-  TaskController::Get()->AddTask(compileOrDecodeTask.forget());
-  TaskController::Get()->AddTask(completeTask.forget());
+  if (aBatch) {
+    // The batch task has to be added before the tasks depending on it.
+    aBatch->mTask->AppendTask(compileOrDecodeTask);
+    completeTask->AddDependency(aBatch->mTask);
+    aBatch->mCompleteTasks.AppendElement(completeTask.forget());
+  } else {
+    completeTask->AddDependency(compileOrDecodeTask);
+
+    TaskController::Get()->AddTask(compileOrDecodeTask.forget());
+    TaskController::Get()->AddTask(completeTask.forget());
+  }
 
   aRequest->GetScriptLoadContext()->BlockOnload(mDocument);
 
@@ -2035,6 +2091,78 @@ nsresult ScriptLoader::AttemptOffThreadScriptCompile(
   return NS_OK;
 }
 
+bool ScriptLoader::ShouldBatchOffThreadCompile(ScriptLoadRequest* aRequest) {
+  if (!StaticPrefs::dom_script_loader_off_thread_batching_enabled() ||
+      !StaticPrefs::javascript_options_parallel_parsing() ||
+      NumberOfProcessors() <= 1) {
+    return false;
+  }
+
+  ScriptLoadContext* context = aRequest->GetScriptLoadContext();
+  if (aRequest->IsModuleRequest() || context->mIsInline ||
+      !context->IsAsyncScript() || !aRequest->IsTextSource() ||
+      context->mCompileOrDecodeTask || context->CompileStarted()) {
+    return false;
+  }
+
+  size_t length = aRequest->ScriptTextLength();
+  return length >= OffThreadBatchMinimumTextLength &&
+         length < OffThreadMinimumTextLength;
+}
+
+void ScriptLoader::CompileOffThreadBatchOrProcessRequests(
+    nsTArray<RefPtr<ScriptLoadRequest>>& aRequests) {
+  size_t totalLength = 0;
+  for (ScriptLoadRequest* request : aRequests) {
+    totalLength += request->ScriptTextLength();
+  }
+
+  if (aRequests.Length() < 2 || totalLength < OffThreadMinimumTextLength) {
+    for (size_t i = 0; i < aRequests.Length(); i++) {
+      if (!ReadyToExecuteScripts()) {
+        // Running one of the scripts blocked the others, they are processed
+        // with the other loaded async requests once we're unblocked.
+        for (; i < aRequests.Length(); i++) {
+          mLoadedAsyncRequests.AppendElement(aRequests[i]);
+        }
+        break;
+      }
+      CompileOffThreadOrProcessRequest(aRequests[i]);
+    }
+    return;
+  }
+
+  OffThreadCompileBatch batch;
+  batch.mTask = new CompileOrDecodeBatchTask();
+  AutoTArray<RefPtr<ScriptLoadRequest>, 8> notCompiling;
+  for (ScriptLoadRequest* request : aRequests) {
+    bool couldCompile = false;
+    nsresult rv = AttemptOffThreadScriptCompile(request, &couldCompile, &batch);
+    if (NS_FAILED(rv)) {
+      HandleLoadError(request, rv);
+      continue;
+    }
+    if (!couldCompile) {
+      notCompiling.AppendElement(request);
+    }
+  }
+
+  if (!batch.mCompleteTasks.IsEmpty()) {
+    LOG(("ScriptLoader (%p): Compiling %zu scripts off-thread in one task",
+         this, batch.mCompleteTasks.Length()));
+
+    TaskController::Get()->AddTask(batch.mTask.forget());
+    for (RefPtr<Task>& completeTask : batch.mCompleteTasks) {
+      TaskController::Get()->AddTask(completeTask.forget());
+    }
+  }
+
+  // Only run scripts once the batch doesn't depend on our state anymore.
+  for (ScriptLoadRequest* request : notCompiling) {
+    ProcessRequest(request);
+  }
+}
+
 CompileOrDecodeTask::CompileOrDecodeTask()
     : Task(Kind::OffMainThreadOnly, EventQueuePriority::Normal),
       mMutex("CompileOrDecodeTask"),
@@ -2110,6 +2238,8 @@ void CompileOrDecodeTask::Cancel() {
   mIsCancelled = true;
 }
 
+void CompileOrDecodeTask::RunInBatch() { (void)Run(); }
+
 enum class CompilationTarget { Script, Module };
 
 template <CompilationTarget target>
@@ -2293,6 +2423,9 @@ nsresult ScriptLoader::CreateOffThreadTask(
       case JS::DelazificationOption::ConcurrentLargeFirst:
         TRACE_FOR_TEST(aRequest, "delazification_concurrent_large_first");
         break;
+      case JS::DelazificationOption::ConcurrentParallel:
+        TRACE_FOR_TEST(aRequest, "delazification_concurrent_parallel");
+        break;
       case JS::DelazificationOption::ParseEverythingEagerly:
         TRACE_FOR_TEST(aRequest, "delazification_parse_everything_eagerly");
         break;
@@ -2709,6 +2842,17 @@ void ScriptLoader::CalculateBytecodeCacheFlag(ScriptLoadRequest* aRequest) {
       aRequest->MarkSkippedBytecodeEncoding();
       return;
     }
+
+    // Compiling a large script costs much more than encoding it, and the
+    // entry is shared by every process that loads the script later, so don't
+    // wait for it to be fetched a few times.
+    uint32_t eagerLength =
+        StaticPrefs::dom_script_loader_bytecode_cache_eager_source_length();
+    if (hasFetchCountMin && eagerLength && sourceLength >= eagerLength) {
+      LOG(("ScriptLoadRequest (%p): Bytecode-cache: Script is large.",
+           aRequest));
+      hasFetchCountMin = false;
+    }
   }
 
   // Check that we loaded the cache entry a few times before attempting any
@@ -3688,14 +3832,22 @@ void ScriptLoader::ProcessPendingRequests(bool aAllowBypassingParserBlocking) {
     ProcessRequest(request);
   }
 
+  AutoTArray<RefPtr<ScriptLoadRequest>, 8> batchedAsyncRequests;
   while (ReadyToExecuteScripts() && !mLoadedAsyncRequests.isEmpty()) {
     request = mLoadedAsyncRequests.StealFirst();
     if (request->IsModuleRequest()) {
       ProcessRequest(request);
+    } else if (ShouldBatchOffThreadCompile(request)) {
+      // Async scripts may run in any order, so these can wait for the end of
+      // the loop, to see which others are ready.
+      batchedAsyncRequests.AppendElement(std::move(request));
     } else {
       CompileOffThreadOrProcessRequest(request);
     }
   }
+  if (!batchedAsyncRequests.IsEmpty()) {
+    CompileOffThreadBatchOrProcessRequests(batchedAsyncRequests);
+  }
 
   while (ReadyToExecuteScripts() &&
          !mNonAsyncExternalScriptInsertedRequests.isEmpty() &&
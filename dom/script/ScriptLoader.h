@@ -70,6 +70,7 @@ union Utf8Unit;
 namespace dom {
 
 class AutoJSAPI;
+class CompileOrDecodeBatchTask;
 class DocGroup;
 class Document;
 class ModuleLoader;
@@ -648,8 +649,18 @@ class ScriptLoader final : public JS::loader::ScriptLoaderInterface {
     return mReporter;
   }
 
-  nsresult AttemptOffThreadScriptCompile(ScriptLoadRequest* aRequest,
-                                         bool* aCouldCompileOut);
+  // The off-thread compilations started for a set of requests that are run
+  // by a single task.  See CompileOffThreadBatchOrProcessRequests.
+  struct OffThreadCompileBatch {
+    RefPtr<CompileOrDecodeBatchTask> mTask;
+    nsTArray<RefPtr<Task>> mCompleteTasks;
+  };
+
+  // If aBatch is given, the compilation is added to it regardless of the
+  // size of the script.
+  nsresult AttemptOffThreadScriptCompile(
+      ScriptLoadRequest* aRequest, bool* aCouldCompileOut,
+      OffThreadCompileBatch* aBatch = nullptr);
 
   nsresult CreateOffThreadTask(JSContext* aCx, ScriptLoadRequest* aRequest,
                                JS::CompileOptions& aOptions,
@@ -657,6 +668,16 @@ class ScriptLoader final : public JS::loader::ScriptLoaderInterface {
 
   nsresult ProcessRequest(ScriptLoadRequest* aRequest);
   nsresult CompileOffThreadOrProcessRequest(ScriptLoadRequest* aRequest);
+
+  // Whether aRequest is an async script that is only worth compiling off
+  // main thread together with others.
+  bool ShouldBatchOffThreadCompile(ScriptLoadRequest* aRequest);
+
+  // Compiles the scripts in aRequests, which ShouldBatchOffThreadCompile
+  // accepted, in one off-thread task if they are large enough together, and
+  // processes them right away otherwise.
+  void CompileOffThreadBatchOrProcessRequests(
+      nsTArray<RefPtr<ScriptLoadRequest>>& aRequests);
   void FireScriptAvailable(nsresult aResult, ScriptLoadRequest* aRequest);
   // TODO: Convert this to MOZ_CAN_RUN_SCRIPT (bug 1415230)
   MOZ_CAN_RUN_SCRIPT_BOUNDARY void FireScriptEvaluated(
@@ -93,7 +93,7 @@ already_AddRefed<Promise> TransformerAlgorithmsWrapper::TransformCallback(
       global,
       [this, &aChunk, &aController](ErrorResult& aRv)
           MOZ_CAN_RUN_SCRIPT_FOR_DEFINITION {
-            return TransformCallbackImpl(aChunk, aController, aRv);
+            return AsyncTransformCallbackImpl(aChunk, aController, aRv);
           },
       aRv);
 }
@@ -91,6 +91,17 @@ class TransformerAlgorithmsWrapper : public TransformerAlgorithmsBase {
       JS::Handle<JS::Value> aChunk,
       TransformStreamDefaultController& aController, ErrorResult& aRv) = 0;
 
+  // Lets subclasses finish transforming aChunk later, by returning a promise
+  // instead of null.  The stream doesn't transform the next chunk, or flush,
+  // until the promise is settled.
+  MOZ_CAN_RUN_SCRIPT virtual already_AddRefed<Promise>
+  AsyncTransformCallbackImpl(JS::Handle<JS::Value> aChunk,
+                             TransformStreamDefaultController& aController,
+                             ErrorResult& aRv) {
+    TransformCallbackImpl(aChunk, aController, aRv);
+    return nullptr;
+  }
+
   MOZ_CAN_RUN_SCRIPT virtual void FlushCallbackImpl(
       TransformStreamDefaultController& aController, ErrorResult& aRv) {
     // flushAlgorithm is optional, do nothing by default
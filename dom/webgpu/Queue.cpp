@@ -62,6 +62,39 @@ already_AddRefed<dom::Promise> Queue::OnSubmittedWorkDone(ErrorResult& aRv) {
   return promise.forget();
 }
 
+// Writes up to this size are sent in the IPC message. Creating and mapping
+// shared memory for each of them costs more than copying their data.
+static constexpr size_t kMaxInlineWriteSize = 64 * 1024;
+
+void Queue::SendWriteAction(ipc::ByteBuf&& aAction, Span<const uint8_t> aData,
+                            ErrorResult& aRv) {
+  if (!aData.IsEmpty() && aData.Length() <= kMaxInlineWriteSize) {
+    ipc::ByteBuf data;
+    if (!data.Allocate(aData.Length())) {
+      aRv.Throw(NS_ERROR_OUT_OF_MEMORY);
+      return;
+    }
+    memcpy(data.mData, aData.Elements(), aData.Length());
+    mBridge->SendQueueWriteActionInline(mId, mParent->mId, std::move(aAction),
+                                        std::move(data));
+    return;
+  }
+
+  // In the case of a zero-sized write action, the handle stays invalid.
+  mozilla::ipc::MutableSharedMemoryHandle handle;
+  if (!aData.IsEmpty()) {
+    handle = mozilla::ipc::shared_memory::Create(aData.Length());
+    auto mapping = handle.Map();
+    if (!handle || !mapping) {
+      aRv.Throw(NS_ERROR_OUT_OF_MEMORY);
+      return;
+    }
+    memcpy(mapping.DataAs<uint8_t>(), aData.Elements(), aData.Length());
+  }
+  mBridge->SendQueueWriteAction(mId, mParent->mId, std::move(aAction),
+                                std::move(handle));
+}
+
 void Queue::WriteBuffer(
     const Buffer& aBuffer, uint64_t aBufferOffset,
     const dom::MaybeSharedArrayBufferOrMaybeSharedArrayBufferView& aData,
@@ -122,21 +155,9 @@ void Queue::WriteBuffer(
           return;
         }
 
-        mozilla::ipc::MutableSharedMemoryHandle handle;
-        if (size != 0) {
-          handle = mozilla::ipc::shared_memory::Create(size);
-          auto mapping = handle.Map();
-          if (!handle || !mapping) {
-            aRv.Throw(NS_ERROR_OUT_OF_MEMORY);
-            return;
-          }
-
-          memcpy(mapping.DataAs<uint8_t>(), aData.Elements() + offset, size);
-        }
         ipc::ByteBuf bb;
         ffi::wgpu_queue_write_buffer(aBuffer.mId, aBufferOffset, ToFFI(&bb));
-        mBridge->SendQueueWriteAction(mId, mParent->mId, std::move(bb),
-                                      std::move(handle));
+        SendWriteAction(std::move(bb), aData.Subspan(offset, size), aRv);
       });
 }
 
@@ -222,25 +243,12 @@ void Queue::WriteTexture(
       size = 0;
     }
 
-    mozilla::ipc::MutableSharedMemoryHandle handle;
-    if (size != 0) {
-      handle = mozilla::ipc::shared_memory::Create(size);
-      auto mapping = handle.Map();
-      if (!handle || !mapping) {
-        aRv.Throw(NS_ERROR_OUT_OF_MEMORY);
-        return;
-      }
-
-      memcpy(mapping.DataAs<uint8_t>(), aData.Elements() + aDataLayout.mOffset,
-             size);
-    } else {
-      handle = mozilla::ipc::MutableSharedMemoryHandle();
-    }
-
     ipc::ByteBuf bb;
     ffi::wgpu_queue_write_texture(copyView, dataLayout, extent, ToFFI(&bb));
-    mBridge->SendQueueWriteAction(mId, mParent->mId, std::move(bb),
-                                  std::move(handle));
+    SendWriteAction(std::move(bb),
+                    size ? aData.Subspan(aDataLayout.mOffset, size)
+                         : Span<const uint8_t>(),
+                    aRv);
   });
 }
 
@@ -10,6 +10,7 @@
 #include "ObjectModel.h"
 #include "mozilla/dom/BufferSourceBindingFwd.h"
 #include "mozilla/dom/TypedArray.h"
+#include "mozilla/ipc/ByteBuf.h"
 #include "mozilla/webgpu/WebGPUTypes.h"
 
 namespace mozilla {
@@ -68,6 +69,10 @@ class Queue final : public ObjectBase, public ChildOf<Device> {
   virtual ~Queue();
   void Cleanup() {}
 
+  // Sends a write action, along with the data it writes, to the parent.
+  void SendWriteAction(ipc::ByteBuf&& aAction, Span<const uint8_t> aData,
+                       ErrorResult& aRv);
+
   RefPtr<WebGPUChild> mBridge;
 
  public:
@@ -921,6 +921,17 @@ ipc::IPCResult WebGPUParent::RecvQueueWriteAction(
   return IPC_OK();
 }
 
+ipc::IPCResult WebGPUParent::RecvQueueWriteActionInline(
+    RawId aQueueId, RawId aDeviceId, const ipc::ByteBuf& aByteBuf,
+    const ipc::ByteBuf& aData) {
+  ErrorBuffer error;
+  ffi::wgpu_server_queue_write_action(mContext.get(), aQueueId,
+                                      ToFFI(&aByteBuf), aData.mData,
+                                      aData.mLen, error.ToFFI());
+  ForwardError(aDeviceId, error);
+  return IPC_OK();
+}
+
 ipc::IPCResult WebGPUParent::RecvBindGroupLayoutDrop(RawId aBindGroupLayoutId) {
   ffi::wgpu_server_bind_group_layout_drop(mContext.get(), aBindGroupLayoutId);
   return IPC_OK();
@@ -84,6 +84,9 @@ class WebGPUParent final : public PWebGPUParent, public SupportsWeakPtr {
   ipc::IPCResult RecvQueueWriteAction(RawId aQueueId, RawId aDeviceId,
                                       const ipc::ByteBuf& aByteBuf,
                                       ipc::MutableSharedMemoryHandle&& aShmem);
+  ipc::IPCResult RecvQueueWriteActionInline(RawId aQueueId, RawId aDeviceId,
+                                            const ipc::ByteBuf& aByteBuf,
+                                            const ipc::ByteBuf& aData);
   ipc::IPCResult RecvBindGroupLayoutDrop(RawId aBindGroupLayoutId);
   ipc::IPCResult RecvPipelineLayoutDrop(RawId aPipelineLayoutId);
   ipc::IPCResult RecvBindGroupDrop(RawId aBindGroupId);
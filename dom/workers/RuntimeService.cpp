@@ -57,6 +57,7 @@
 #include "mozilla/DebugOnly.h"
 #include "mozilla/Preferences.h"
 #include "mozilla/ScopeExit.h"
+#include "mozilla/StaticPrefs_dom.h"
 #include "mozilla/dom/Navigator.h"
 #include "mozilla/Monitor.h"
 #include "nsContentUtils.h"
@@ -1405,7 +1406,10 @@ bool RuntimeService::ScheduleWorker(WorkerPrivate& aWorkerPrivate) {
 
   const WorkerThreadFriendKey friendKey;
 
-  SafeRefPtr<WorkerThread> thread = WorkerThread::Create(friendKey);
+  SafeRefPtr<WorkerThread> thread = TakeIdleThread();
+  if (!thread) {
+    thread = WorkerThread::Create(friendKey);
+  }
   if (!thread) {
     UnregisterWorker(aWorkerPrivate);
     return false;
@@ -1435,6 +1439,104 @@ bool RuntimeService::ScheduleWorker(WorkerPrivate& aWorkerPrivate) {
   return true;
 }
 
+SafeRefPtr<WorkerThread> RuntimeService::TakeIdleThread() {
+  MutexAutoLock lock(mMutex);
+
+  if (mIdleThreads.IsEmpty()) {
+    return nullptr;
+  }
+
+  // The thread that ran a worker last is the most likely to still have its
+  // stack and allocator caches in memory.
+  return mIdleThreads.PopLastElement().mThread;
+}
+
+void RuntimeService::NoteIdleThread(SafeRefPtr<WorkerThread> aThread) {
+  AssertIsOnMainThread();
+  MOZ_ASSERT(aThread);
+
+  bool scheduleTimer = false;
+  if (!mShuttingDown) {
+    TimeStamp expirationTime =
+        TimeStamp::NowLoRes() +
+        TimeDuration::FromMilliseconds(
+            StaticPrefs::dom_workers_idle_threads_timeout_ms());
+
+    MutexAutoLock lock(mMutex);
+    if (mIdleThreads.Length() < StaticPrefs::dom_workers_idle_threads_max()) {
+      scheduleTimer = mIdleThreads.IsEmpty();
+      mIdleThreads.AppendElement(
+          IdleThreadInfo{std::move(aThread), expirationTime});
+    }
+  }
+
+  if (aThread) {
+    MOZ_ALWAYS_SUCCEEDS(aThread->Shutdown());
+    return;
+  }
+
+  if (scheduleTimer) {
+    if (!mIdleThreadTimer) {
+      mIdleThreadTimer = NS_NewTimer();
+    }
+    if (mIdleThreadTimer) {
+      MOZ_ALWAYS_SUCCEEDS(mIdleThreadTimer->InitWithNamedFuncCallback(
+          ShutdownExpiredIdleThreads, this,
+          StaticPrefs::dom_workers_idle_threads_timeout_ms(),
+          nsITimer::TYPE_ONE_SHOT,
+          "RuntimeService::ShutdownExpiredIdleThreads"));
+    }
+  }
+}
+
+void RuntimeService::ShutdownIdleThreads(bool aExpiredOnly) {
+  AssertIsOnMainThread();
+
+  AutoTArray<SafeRefPtr<WorkerThread>, 4> threads;
+  TimeStamp nextExpirationTime;
+  {
+    MutexAutoLock lock(mMutex);
+
+    TimeStamp now = TimeStamp::NowLoRes();
+    size_t expired = 0;
+    while (expired < mIdleThreads.Length() &&
+           (!aExpiredOnly || mIdleThreads[expired].mExpirationTime <= now)) {
+      threads.AppendElement(std::move(mIdleThreads[expired].mThread));
+      expired++;
+    }
+    mIdleThreads.RemoveElementsAt(0, expired);
+
+    if (!mIdleThreads.IsEmpty()) {
+      nextExpirationTime = mIdleThreads[0].mExpirationTime;
+    }
+  }
+
+  // Shutting down spins the event loop, so don't hold the lock.
+  for (SafeRefPtr<WorkerThread>& thread : threads) {
+    MOZ_ALWAYS_SUCCEEDS(thread->Shutdown());
+  }
+
+  if (!mIdleThreadTimer) {
+    return;
+  }
+  if (nextExpirationTime.IsNull()) {
+    mIdleThreadTimer->Cancel();
+    return;
+  }
+  TimeDuration delay = nextExpirationTime - TimeStamp::NowLoRes();
+  MOZ_ALWAYS_SUCCEEDS(mIdleThreadTimer->InitWithNamedFuncCallback(
+      ShutdownExpiredIdleThreads, this,
+      uint32_t(std::max(delay.ToMilliseconds(), 0.0)), nsITimer::TYPE_ONE_SHOT,
+      "RuntimeService::ShutdownExpiredIdleThreads"));
+}
+
+// static
+void RuntimeService::ShutdownExpiredIdleThreads(nsITimer* aTimer,
+                                                void* aClosure) {
+  static_cast<RuntimeService*>(aClosure)->ShutdownIdleThreads(
+      /* aExpiredOnly = */ true);
+}
+
 nsresult RuntimeService::Init() {
   AssertIsOnMainThread();
 
@@ -1562,6 +1664,10 @@ void RuntimeService::Shutdown() {
     }
   }
 
+  // The threads of the workers finishing from now on are shut down right
+  // away.
+  ShutdownIdleThreads(/* aExpiredOnly = */ false);
+
   sDefaultJSSettings = nullptr;
 }
 
@@ -2044,6 +2150,8 @@ RuntimeService::Observe(nsISupports* aSubject, const char* aTopic,
     return NS_OK;
   }
   if (!strcmp(aTopic, MEMORY_PRESSURE_OBSERVER_TOPIC)) {
+    ShutdownIdleThreads(/* aExpiredOnly = */ false);
+
     nsDependentString data(aData);
     // Don't continue to GC/CC if we are in an ongoing low-memory state since
     // its very slow and it likely won't help us anyway.
@@ -2357,7 +2465,13 @@ WorkerThreadPrimaryRunnable::FinishedRunnable::Run() {
   AssertIsOnMainThread();
 
   SafeRefPtr<WorkerThread> thread = std::move(mThread);
-  if (thread->ShutdownRequired()) {
+  if (!thread->ShutdownRequired()) {
+    return NS_OK;
+  }
+
+  if (RuntimeService* runtime = RuntimeService::GetService()) {
+    runtime->NoteIdleThread(std::move(thread));
+  } else {
     MOZ_ALWAYS_SUCCEEDS(thread->Shutdown());
   }
 
@@ -19,10 +19,13 @@
 #include "mozilla/Atomics.h"
 #include "mozilla/Mutex.h"
 #include "mozilla/StaticPtr.h"
+#include "mozilla/TimeStamp.h"
 #include "nsClassHashtable.h"
+#include "nsCOMPtr.h"
 #include "nsHashKeys.h"
 #include "nsTArray.h"
 
+class nsITimer;
 class nsPIDOMWindowInner;
 
 namespace mozilla::dom {
@@ -60,6 +63,19 @@ class RuntimeService final : public nsIObserver {
   nsClassHashtable<nsCStringHashKey, WorkerDomainInfo> mDomainMap
       MOZ_GUARDED_BY(mMutex);
 
+  // The threads of finished workers, which new workers reuse instead of
+  // starting a thread.
+  struct IdleThreadInfo {
+    SafeRefPtr<WorkerThread> mThread;
+    TimeStamp mExpirationTime;
+  };
+
+  // Protected by mMutex, ordered by expiration time.
+  nsTArray<IdleThreadInfo> mIdleThreads MOZ_GUARDED_BY(mMutex);
+
+  // Only touched on the main thread.
+  nsCOMPtr<nsITimer> mIdleThreadTimer;
+
   // *Not* protected by mMutex.
   nsClassHashtable<nsPtrHashKey<const nsPIDOMWindowInner>,
                    nsTArray<WorkerPrivate*> >
@@ -170,6 +186,10 @@ class RuntimeService final : public nsIObserver {
 
   bool IsShuttingDown() const { return mShuttingDown; }
 
+  // Keeps the thread of a worker that finished running for another worker,
+  // or shuts it down if we have enough idle threads.
+  void NoteIdleThread(SafeRefPtr<WorkerThread> aThread);
+
   void DumpRunningWorkers();
 
   void UpdateWorkersPlaybackState(const nsPIDOMWindowInner& aWindow,
@@ -193,6 +213,13 @@ class RuntimeService final : public nsIObserver {
 
   bool ScheduleWorker(WorkerPrivate& aWorkerPrivate);
 
+  SafeRefPtr<WorkerThread> TakeIdleThread();
+
+  // Shuts down the idle threads, or only those that expired.
+  void ShutdownIdleThreads(bool aExpiredOnly);
+
+  static void ShutdownExpiredIdleThreads(nsITimer* aTimer, void* aClosure);
+
   template <typename Func>
   void BroadcastAllWorkers(const Func& aFunc);
 };
@@ -13,6 +13,7 @@
 #include "mozilla/Logging.h"
 #include "mozilla/PRemoteSpellcheckEngineChild.h"
 #include "mozilla/TextServicesDocument.h"
+#include "nsTHashMap.h"
 #include "nsXULAppAPI.h"
 #include "RemoteSpellCheckEngineChild.h"
 
@@ -123,6 +124,44 @@ nsresult mozSpellChecker::NextMisspelledWord(nsAString& aWord,
 
 RefPtr<mozilla::CheckWordPromise> mozSpellChecker::CheckWords(
     const nsTArray<nsString>& aWords) {
+  // Large pastes repeat the same words a lot, so each distinct word is only
+  // checked once, and sent once to the parent process.
+  nsTArray<nsString> uniqueWords;
+  nsTArray<uint32_t> uniqueIndices(aWords.Length());
+  {
+    nsTHashMap<nsStringHashKey, uint32_t> indices(aWords.Length());
+    for (const auto& word : aWords) {
+      uniqueIndices.AppendElement(indices.LookupOrInsertWith(word, [&] {
+        uniqueWords.AppendElement(word);
+        return uniqueWords.Length() - 1;
+      }));
+    }
+  }
+
+  if (uniqueWords.Length() == aWords.Length()) {
+    return CheckUniqueWords(aWords);
+  }
+
+  return CheckUniqueWords(uniqueWords)
+      ->Then(mozilla::GetCurrentSerialEventTarget(), __func__,
+             [uniqueIndices = std::move(uniqueIndices)](
+                 mozilla::CheckWordPromise::ResolveOrRejectValue&& aValue) {
+               if (aValue.IsReject()) {
+                 return mozilla::CheckWordPromise::CreateAndReject(
+                     aValue.RejectValue(), __func__);
+               }
+               const auto& uniqueMisspells = aValue.ResolveValue();
+               nsTArray<bool> misspells(uniqueIndices.Length());
+               for (uint32_t index : uniqueIndices) {
+                 misspells.AppendElement(uniqueMisspells[index]);
+               }
+               return mozilla::CheckWordPromise::CreateAndResolve(
+                   std::move(misspells), __func__);
+             });
+}
+
+RefPtr<mozilla::CheckWordPromise> mozSpellChecker::CheckUniqueWords(
+    const nsTArray<nsString>& aWords) {
   if (XRE_IsContentProcess()) {
     return mEngine->CheckWords(aWords);
   }
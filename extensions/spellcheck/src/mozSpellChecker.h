@@ -165,6 +165,10 @@ class mozSpellChecker final {
 
   nsresult Init();
 
+  // CheckWords for words without duplicates.
+  RefPtr<mozilla::CheckWordPromise> CheckUniqueWords(
+      const nsTArray<nsString>& aWords);
+
   RefPtr<mozEnglishWordUtils> mConverter;
   RefPtr<mozilla::TextServicesDocument> mTextServicesDocument;
   nsCOMPtr<mozIPersonalDictionary> mPersonalDictionary;
@@ -11,6 +11,7 @@
 #include <string.h>
 
 #include "mozilla/CheckedInt.h"
+#include "mozilla/UniquePtr.h"
 #include "NumericTools.h"
 
 #include "2D.h"
@@ -577,6 +578,120 @@ size_t AlphaBoxBlur::GetSurfaceAllocationSize() const {
   return mSurfaceAllocationSize;
 }
 
+// Blurs with radii of at least kMinDownscaleBlurRadius are done on a copy of
+// the surface that is downscaled by up to kMaxDownscaleFactor, keeping blur
+// radii of at least kMinDownscaledBlurRadius. The result is then scaled back
+// up. The error of the scaling is much smaller than a pixel of the blurred
+// result, but the blur itself touches a fraction of the pixels.
+static const int32_t kMinDownscaleBlurRadius = 32;
+static const int32_t kMinDownscaledBlurRadius = 16;
+static const int32_t kMaxDownscaleFactor = 4;
+
+// Returns, in 1/256ths of a pixel, the position in the downscaled surface of
+// the center of pixel aIndex of the full surface.
+static int32_t DownscaledPosition(int32_t aIndex, int32_t aFactor) {
+  return std::max(0, (2 * aIndex + 1) * 128 / aFactor - 128);
+}
+
+bool AlphaBoxBlur::BlurDownscaled(uint8_t* aData) const {
+  int32_t minRadius = std::min(mBlurRadius.width, mBlurRadius.height);
+  int32_t factor = 1;
+  while (factor < kMaxDownscaleFactor &&
+         minRadius / (factor * 2) >= kMinDownscaledBlurRadius) {
+    factor *= 2;
+  }
+  if (factor == 1) {
+    return false;
+  }
+
+  IntSize size = GetSize();
+  int32_t stride = GetStride();
+
+  AlphaBoxBlur downscaled;
+  downscaled.mRect = IntRect(0, 0, (size.width + factor - 1) / factor,
+                             (size.height + factor - 1) / factor);
+  downscaled.mBlurRadius =
+      IntSize(mBlurRadius.width / factor, mBlurRadius.height / factor);
+  CheckedInt<int32_t> downscaledStride =
+      RoundUpToMultipleOf4(downscaled.mRect.Width());
+  if (!downscaledStride.isValid()) {
+    return false;
+  }
+  downscaled.mStride = downscaledStride.value();
+  downscaled.mSurfaceAllocationSize = BufferSizeFromStrideAndHeight(
+      downscaled.mStride, downscaled.mRect.Height(), 3);
+  if (!downscaled.mSurfaceAllocationSize) {
+    return false;
+  }
+
+  IntSize downscaledSize = downscaled.GetSize();
+  UniquePtr<uint8_t[]> downscaledData(
+      new (std::nothrow) uint8_t[downscaled.mSurfaceAllocationSize]);
+  // For each column of the full surface, the first of the two downscaled
+  // columns it is interpolated from and the weight of the second one.
+  UniquePtr<int32_t[]> columns(new (std::nothrow) int32_t[2 * size.width]);
+  if (!downscaledData || !columns) {
+    return false;
+  }
+  memset(downscaledData.get(), 0, downscaled.mSurfaceAllocationSize);
+
+  // Average each factor x factor block. Like the box blurs do, this treats
+  // the pixels past the edges of the surface as transparent.
+  const int32_t area = factor * factor;
+  for (int32_t dy = 0; dy < downscaledSize.height; dy++) {
+    uint8_t* dest = downscaledData.get() + dy * downscaled.mStride;
+    int32_t yEnd = std::min((dy + 1) * factor, size.height);
+    for (int32_t dx = 0; dx < downscaledSize.width; dx++) {
+      int32_t xEnd = std::min((dx + 1) * factor, size.width);
+      uint32_t sum = 0;
+      for (int32_t y = dy * factor; y < yEnd; y++) {
+        const uint8_t* src = aData + y * stride;
+        for (int32_t x = dx * factor; x < xEnd; x++) {
+          sum += src[x];
+        }
+      }
+      dest[dx] = (sum + area / 2) / area;
+    }
+  }
+
+  downscaled.Blur(downscaledData.get());
+
+  for (int32_t x = 0; x < size.width; x++) {
+    int32_t pos = DownscaledPosition(x, factor);
+    columns[2 * x] = std::min(pos >> 8, downscaledSize.width - 1);
+    columns[2 * x + 1] =
+        columns[2 * x] < downscaledSize.width - 1 ? pos & 0xff : 0;
+  }
+
+  // Scale the result back up with bilinear interpolation, leaving the skip
+  // rect alone.
+  for (int32_t y = 0; y < size.height; y++) {
+    int32_t pos = DownscaledPosition(y, factor);
+    int32_t y0 = std::min(pos >> 8, downscaledSize.height - 1);
+    int32_t y1 = std::min(y0 + 1, downscaledSize.height - 1);
+    uint32_t fy = y0 < y1 ? pos & 0xff : 0;
+    const uint8_t* row0 = downscaledData.get() + y0 * downscaled.mStride;
+    const uint8_t* row1 = downscaledData.get() + y1 * downscaled.mStride;
+
+    int32_t skipStart = mSkipRect.ContainsY(y) ? mSkipRect.X() : size.width;
+    int32_t skipEnd = std::max(skipStart, mSkipRect.XMost());
+    uint8_t* dest = aData + y * stride;
+    for (int32_t x = 0; x < size.width; x++) {
+      if (x == skipStart) {
+        x = skipEnd - 1;
+        continue;
+      }
+      int32_t x0 = columns[2 * x];
+      uint32_t fx = columns[2 * x + 1];
+      int32_t x1 = fx ? x0 + 1 : x0;
+      uint32_t top = row0[x0] * (256 - fx) + row0[x1] * fx;
+      uint32_t bottom = row1[x0] * (256 - fx) + row1[x1] * fx;
+      dest[x] = (top * (256 - fy) + bottom * fy + (1 << 15)) >> 16;
+    }
+  }
+  return true;
+}
+
 void AlphaBoxBlur::Blur(uint8_t* aData) const {
   if (!aData) {
     return;
@@ -608,6 +723,12 @@ void AlphaBoxBlur::Blur(uint8_t* aData) const {
       delete[] tmpData;
     }
 
+    if (std::min(mBlurRadius.width, mBlurRadius.height) >=
+            kMinDownscaleBlurRadius &&
+        BlurDownscaled(aData)) {
+      return;
+    }
+
     int32_t horizontalLobes[3][2];
     ComputeLobes(mBlurRadius.width, horizontalLobes);
     int32_t verticalLobes[3][2];
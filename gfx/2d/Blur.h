@@ -145,6 +145,13 @@ class GFX2D_API AlphaBoxBlur final {
                    uint32_t* aIntegralImage, size_t aIntegralImageStride) const;
 #endif
 
+  /**
+   * Blurs a downscaled copy of the surface and scales the result back up,
+   * for large blur radii. Returns false if the radii aren't large enough, or
+   * on OOM, in which case the surface is left unchanged.
+   */
+  bool BlurDownscaled(uint8_t* aData) const;
+
   static CheckedInt<int32_t> RoundUpToMultipleOf4(int32_t aVal);
 
   /**
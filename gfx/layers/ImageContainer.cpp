@@ -67,28 +67,29 @@ RefPtr<PlanarYCbCrImage> ImageFactory::CreatePlanarYCbCrImage(
 }
 
 BufferRecycleBin::BufferRecycleBin()
-    : mLock("mozilla.layers.BufferRecycleBin.mLock")
-      // This member is only valid when the bin is not empty and will be
-      // properly initialized in RecycleBuffer, but initializing it here avoids
-      // static analysis noise.
-      ,
-      mRecycledBufferSize(0) {}
+    : mLock("mozilla.layers.BufferRecycleBin.mLock"), mRecycledBufferSize(0) {}
 
 void BufferRecycleBin::RecycleBuffer(UniquePtr<uint8_t[]> aBuffer,
                                      uint32_t aSize) {
   MutexAutoLock lock(mLock);
 
-  if (!mRecycledBuffers.IsEmpty() && aSize != mRecycledBufferSize) {
-    mRecycledBuffers.Clear();
+  if (aSize != mRecycledBufferSize) {
+    // The frame size changed since this buffer was allocated. Frames of the
+    // old size are still released for a while after the change, and they
+    // must not flush the buffers of the new size out of the bin.
+    return;
   }
-  mRecycledBufferSize = aSize;
   mRecycledBuffers.AppendElement(std::move(aBuffer));
 }
 
 UniquePtr<uint8_t[]> BufferRecycleBin::GetBuffer(uint32_t aSize) {
   MutexAutoLock lock(mLock);
 
-  if (mRecycledBuffers.IsEmpty() || mRecycledBufferSize != aSize) {
+  if (mRecycledBufferSize != aSize) {
+    mRecycledBuffers.Clear();
+    mRecycledBufferSize = aSize;
+  }
+  if (mRecycledBuffers.IsEmpty()) {
     return UniquePtr<uint8_t[]>(new (fallible) uint8_t[aSize]);
   }
 
@@ -252,7 +252,8 @@ class BufferRecycleBin final {
   // eat excess memory while video is paused...
   nsTArray<mozilla::UniquePtr<uint8_t[]>> mRecycledBuffers
       MOZ_GUARDED_BY(mLock);
-  // This is only valid if mRecycledBuffers is non-empty
+  // The size of the buffers we were last asked for. mRecycledBuffers only
+  // holds buffers of this size.
   uint32_t mRecycledBufferSize MOZ_GUARDED_BY(mLock);
 };
 
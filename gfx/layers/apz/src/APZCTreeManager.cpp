@@ -468,6 +468,8 @@ std::vector<LayersId> APZCTreeManager::UpdateHitTestingTree(
                                  state.mNodesToDestroy.AppendElement(aNode);
                                });
   mRootNode = nullptr;
+  mTargetNodeMapValid = false;
+  mTargetNodeMap.clear();
   mHaveOOPIframes = false;
   Maybe<LayersId> asyncZoomContainerSubtree = Nothing();
   LayersId currentRootContentLayersId{0};
@@ -709,6 +711,8 @@ std::vector<LayersId> APZCTreeManager::UpdateHitTestingTree(
   // We do not support tree structures where the root node has siblings.
   MOZ_ASSERT(!(mRootNode && mRootNode->GetPrevSibling()));
 
+  BuildTargetNodeMap();
+
   {  // scope lock and update our mApzcMap before we destroy all the unused
     // APZC instances
     MutexAutoLock lock(mMapLock);
@@ -2773,6 +2777,8 @@ void APZCTreeManager::ClearTree() {
     nodesToDestroy[i]->Destroy();
   }
   mRootNode = nullptr;
+  mTargetNodeMapValid = false;
+  mTargetNodeMap.clear();
 
   {
     // Also remove references to APZC instances in the map
@@ -3008,9 +3014,34 @@ already_AddRefed<AsyncPanZoomController> APZCTreeManager::GetTargetAPZC(
   return apzc.forget();
 }
 
+void APZCTreeManager::BuildTargetNodeMap() {
+  mTreeLock.AssertCurrentThreadIn();
+  mTargetNodeMap.clear();
+  // Every node of a guid holds the same APZC, so keep the first node in the
+  // order GetTargetNode would have searched the tree.
+  ForEachNodePostOrder<ReverseIterator>(
+      mRootNode.get(), [this](HitTestingTreeNode* aNode) {
+        if (AsyncPanZoomController* apzc = aNode->GetApzc()) {
+          mTargetNodeMap.emplace(apzc->GetGuid(), aNode);
+        }
+      });
+  mTargetNodeMapValid = true;
+}
+
 already_AddRefed<HitTestingTreeNode> APZCTreeManager::GetTargetNode(
     const ScrollableLayerGuid& aGuid, GuidComparator aComparator) const {
   mTreeLock.AssertCurrentThreadIn();
+  if (mTargetNodeMapValid &&
+      (!aComparator ||
+       aComparator == &ScrollableLayerGuid::EqualsIgnoringPresShell)) {
+    auto it = mTargetNodeMap.find(aGuid);
+    if (it == mTargetNodeMap.end() ||
+        (!aComparator && !it->second->GetApzc()->Matches(aGuid))) {
+      return nullptr;
+    }
+    return do_AddRef(it->second);
+  }
+
   RefPtr<HitTestingTreeNode> target =
       DepthFirstSearchPostOrder<ReverseIterator>(
           mRootNode.get(), [&aGuid, &aComparator](HitTestingTreeNode* node) {
@@ -660,6 +660,7 @@ class APZCTreeManager : public IAPZCTreeManager, public APZInputBridge {
       const ScrollableLayerGuid& aGuid);
   already_AddRefed<HitTestingTreeNode> GetTargetNode(
       const ScrollableLayerGuid& aGuid, GuidComparator aComparator) const;
+  void BuildTargetNodeMap() MOZ_REQUIRES(mTreeLock);
   HitTestingTreeNode* FindTargetNode(HitTestingTreeNode* aNode,
                                      const ScrollableLayerGuid& aGuid,
                                      GuidComparator aComparator);
@@ -898,6 +899,17 @@ class APZCTreeManager : public IAPZCTreeManager, public APZInputBridge {
   mutable mozilla::RecursiveMutex mTreeLock;
   RefPtr<HitTestingTreeNode> mRootNode MOZ_GUARDED_BY(mTreeLock);
 
+  /* The node GetTargetNode finds for each APZC guid in the tree rooted at
+   * mRootNode, so that hit-testing doesn't search the whole tree for every
+   * result WebRender returns. It is rebuilt after every tree update, and
+   * only used while mTargetNodeMapValid is set.
+   */
+  std::unordered_map<ScrollableLayerGuid, RefPtr<HitTestingTreeNode>,
+                     ScrollableLayerGuid::HashIgnoringPresShellFn,
+                     ScrollableLayerGuid::EqualIgnoringPresShellFn>
+      mTargetNodeMap MOZ_GUARDED_BY(mTreeLock);
+  bool mTargetNodeMapValid MOZ_GUARDED_BY(mTreeLock) = false;
+
   /*
    * A set of LayersIds for which APZCTM should only send empty
    * MatrixMessages via NotifyLayerTransform().
@@ -49,9 +49,13 @@ WebRenderLayerManager::WebRenderLayerManager(nsIWidget* aWidget)
   if (XRE_IsContentProcess() &&
       StaticPrefs::gfx_webrender_enable_item_cache_AtStartup()) {
     static const size_t kInitialCacheSize = 1024;
-    static const size_t kMaximumCacheSize = 10240;
+    // Cache slots are indexed by 16-bit integers.
+    const size_t maximumCacheSize = std::min(
+        size_t(StaticPrefs::gfx_webrender_item_cache_max_size_AtStartup()),
+        size_t(UINT16_MAX) + 1);
 
-    mDisplayItemCache.SetCapacity(kInitialCacheSize, kMaximumCacheSize);
+    mDisplayItemCache.SetCapacity(
+        std::min(kInitialCacheSize, maximumCacheSize), maximumCacheSize);
   }
 }
 
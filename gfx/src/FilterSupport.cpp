@@ -581,6 +581,15 @@ static void ConvertComponentTransferFunctionToFilter(
     }
 
     case SVG_FECOMPONENTTRANSFER_TYPE_LINEAR: {
+      const nsTArray<float>& slopeIntercept =
+          aFunctionAttributes.mValues[aInChannel];
+      float slope = slopeIntercept[kComponentTransferSlopeIndex];
+      float intercept = slopeIntercept[kComponentTransferInterceptIndex];
+      if (slope == 1.0f && intercept == 0.0f) {
+        // This is the identity function, so no filter is needed.
+        return;
+      }
+
       static const LinearTransferAtts slopeAtt[4] = {
           ATT_LINEAR_TRANSFER_SLOPE_R, ATT_LINEAR_TRANSFER_SLOPE_G,
           ATT_LINEAR_TRANSFER_SLOPE_B, ATT_LINEAR_TRANSFER_SLOPE_A};
@@ -596,16 +605,22 @@ static void ConvertComponentTransferFunctionToFilter(
       }
       filter = aLinearTransfer;
       filter->SetAttribute(disableAtt[aOutChannel], false);
-      const nsTArray<float>& slopeIntercept =
-          aFunctionAttributes.mValues[aInChannel];
-      float slope = slopeIntercept[kComponentTransferSlopeIndex];
-      float intercept = slopeIntercept[kComponentTransferInterceptIndex];
       filter->SetAttribute(slopeAtt[aOutChannel], slope);
       filter->SetAttribute(interceptAtt[aOutChannel], intercept);
       break;
     }
 
     case SVG_FECOMPONENTTRANSFER_TYPE_GAMMA: {
+      const nsTArray<float>& gammaValues =
+          aFunctionAttributes.mValues[aInChannel];
+      float amplitude = gammaValues[kComponentTransferAmplitudeIndex];
+      float exponent = gammaValues[kComponentTransferExponentIndex];
+      float offset = gammaValues[kComponentTransferOffsetIndex];
+      if (amplitude == 1.0f && exponent == 1.0f && offset == 0.0f) {
+        // This is the identity function, so no filter is needed.
+        return;
+      }
+
       static const GammaTransferAtts amplitudeAtt[4] = {
           ATT_GAMMA_TRANSFER_AMPLITUDE_R, ATT_GAMMA_TRANSFER_AMPLITUDE_G,
           ATT_GAMMA_TRANSFER_AMPLITUDE_B, ATT_GAMMA_TRANSFER_AMPLITUDE_A};
@@ -624,11 +639,6 @@ static void ConvertComponentTransferFunctionToFilter(
       }
       filter = aGammaTransfer;
       filter->SetAttribute(disableAtt[aOutChannel], false);
-      const nsTArray<float>& gammaValues =
-          aFunctionAttributes.mValues[aInChannel];
-      float amplitude = gammaValues[kComponentTransferAmplitudeIndex];
-      float exponent = gammaValues[kComponentTransferExponentIndex];
-      float offset = gammaValues[kComponentTransferOffsetIndex];
       filter->SetAttribute(amplitudeAtt[aOutChannel], amplitude);
       filter->SetAttribute(exponentAtt[aOutChannel], exponent);
       filter->SetAttribute(offsetAtt[aOutChannel], offset);
@@ -725,7 +735,8 @@ static already_AddRefed<FilterNode> FilterNodeFromPrimitiveDescription(
     already_AddRefed<FilterNode> operator()(
         const ColorMatrixAttributes& aMatrixAttributes) {
       float colorMatrix[20];
-      if (!ComputeColorMatrix(aMatrixAttributes, colorMatrix)) {
+      if (!ComputeColorMatrix(aMatrixAttributes, colorMatrix) ||
+          PodEqual(colorMatrix, identityMatrix, 20)) {
         RefPtr<FilterNode> filter(mSources[0]);
         return filter.forget();
       }
@@ -830,6 +841,11 @@ static already_AddRefed<FilterNode> FilterNodeFromPrimitiveDescription(
     }
 
     already_AddRefed<FilterNode> operator()(const OpacityAttributes& aOpacity) {
+      if (aOpacity.mOpacity == 1.0f) {
+        RefPtr<FilterNode> filter(mSources[0]);
+        return filter.forget();
+      }
+
       RefPtr<FilterNode> filter = mDT->CreateFilter(FilterType::OPACITY);
       if (!filter) {
         return nullptr;
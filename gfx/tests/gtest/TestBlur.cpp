@@ -0,0 +1,87 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "gtest/MozGTestBench.h"
+#include "mozilla/gfx/Blur.h"
+#include "mozilla/UniquePtr.h"
+
+using namespace mozilla;
+using namespace mozilla::gfx;
+
+// Blurs a surface whose left half is opaque, and checks that the edge
+// follows the Gaussian with the standard deviation of the blur radius. Blur
+// radii of 32 and more blur a downscaled copy of the surface.
+static void CheckBlurredEdge(int32_t aBlurRadius) {
+  AlphaBoxBlur blur(Rect(0, 0, 400, 64), IntSize(0, 0),
+                    IntSize(aBlurRadius, aBlurRadius), nullptr, nullptr);
+  IntSize size = blur.GetSize();
+  int32_t stride = blur.GetStride();
+  size_t allocSize = blur.GetSurfaceAllocationSize();
+  ASSERT_NE(allocSize, 0u);
+
+  UniquePtr<uint8_t[]> data = MakeUnique<uint8_t[]>(allocSize);
+  const int32_t edge = (size.width / 2) & ~3;
+  for (int32_t y = 0; y < size.height; y++) {
+    memset(data.get() + y * stride, 255, edge);
+  }
+
+  blur.Blur(data.get());
+
+  // The middle row is far enough from the top and bottom of the surface to
+  // only depend on the horizontal blur.
+  const uint8_t* row = data.get() + (size.height / 2) * stride;
+  double sigma = AlphaBoxBlur::CalculateBlurSigma(aBlurRadius);
+  for (int32_t x = edge - aBlurRadius; x < edge + aBlurRadius; x++) {
+    double distance = (x + 0.5 - edge) / sigma;
+    double expected = 255 * 0.5 * std::erfc(distance / std::sqrt(2.0));
+    EXPECT_NEAR(row[x], expected, 8) << "x = " << x;
+  }
+}
+
+TEST(Moz2D, BlurEdge)
+{
+  CheckBlurredEdge(24);
+}
+
+TEST(Moz2D, BlurEdgeDownscaled)
+{
+  CheckBlurredEdge(48);
+  CheckBlurredEdge(100);
+}
+
+TEST(Moz2D, BlurDownscaledLeavesSkipRect)
+{
+  Rect rect(0, 0, 400, 400);
+  AlphaBoxBlur blur(rect, IntSize(0, 0), IntSize(48, 48), nullptr, &rect);
+  IntSize size = blur.GetSize();
+  int32_t stride = blur.GetStride();
+  size_t allocSize = blur.GetSurfaceAllocationSize();
+  ASSERT_NE(allocSize, 0u);
+
+  UniquePtr<uint8_t[]> data = MakeUnique<uint8_t[]>(allocSize);
+  memset(data.get(), 255, allocSize);
+  uint8_t* center = data.get() + (size.height / 2) * stride + size.width / 2;
+  *center = 7;
+
+  blur.Blur(data.get());
+
+  EXPECT_EQ(*center, 7);
+}
+
+static void BenchBlur(int32_t aBlurRadius) {
+  AlphaBoxBlur blur(Rect(0, 0, 1024, 1024), IntSize(0, 0),
+                    IntSize(aBlurRadius, aBlurRadius), nullptr, nullptr);
+  UniquePtr<uint8_t[]> data =
+      MakeUnique<uint8_t[]>(blur.GetSurfaceAllocationSize());
+  memset(data.get(), 255, blur.GetSurfaceAllocationSize() / 2);
+  blur.Blur(data.get());
+}
+
+MOZ_GTEST_BENCH(Moz2D, BlurRadius24, [] { BenchBlur(24); });
+MOZ_GTEST_BENCH(Moz2D, BlurRadius100, [] { BenchBlur(100); });
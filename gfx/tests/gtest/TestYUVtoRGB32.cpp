@@ -1,4 +1,5 @@
 #include "gtest/gtest.h"
+#include "gtest/MozGTestBench.h"
 
 #include <array>
 #include <cmath>
@@ -356,3 +357,151 @@ TEST(YCbCrUtils, ConvertYCbCrToRGB32WithIdentityColorSpace)
     IsColorMatched(expectation, RGBX.get(), bufferSize);
   }
 }
+
+// A solid color image in any bit depth and chroma subsampling, like the ones
+// our video decoders produce.
+class YCbCrTestImage {
+ public:
+  YCbCrTestImage(const Color& aRGBColor, gfx::YUVColorSpace aColorSpace,
+                 gfx::ColorDepth aColorDepth,
+                 gfx::ChromaSubsampling aSubsampling,
+                 const gfx::IntSize& aSize) {
+    const Color yuvColor = RGB2YUV(aRGBColor);
+    const int bitDepth = gfx::BitDepthForColorDepth(aColorDepth);
+    const int sampleSize = bitDepth > 8 ? 2 : 1;
+    const gfx::IntSize cbcrSize = gfx::ChromaSize(aSize, aSubsampling);
+
+    mData.mPictureRect = gfx::IntRect({0, 0}, aSize);
+    mData.mYStride = aSize.width * sampleSize;
+    mData.mCbCrStride = cbcrSize.width * sampleSize;
+    mData.mYUVColorSpace = aColorSpace;
+    mData.mColorDepth = aColorDepth;
+    mData.mChromaSubsampling = aSubsampling;
+
+    mData.mYChannel = FillPlane(mY, std::get<0>(yuvColor), bitDepth,
+                                aSize.width * aSize.height);
+    mData.mCbChannel = FillPlane(mCb, std::get<1>(yuvColor), bitDepth,
+                                 cbcrSize.width * cbcrSize.height);
+    mData.mCrChannel = FillPlane(mCr, std::get<2>(yuvColor), bitDepth,
+                                 cbcrSize.width * cbcrSize.height);
+  }
+
+  const layers::PlanarYCbCrData& GetData() const { return mData; }
+
+ private:
+  static uint8_t* FillPlane(nsTArray<uint8_t>& aPlane, uint8_t aValue,
+                            int aBitDepth, size_t aSamples) {
+    if (aBitDepth == 8) {
+      aPlane.SetLength(aSamples);
+      memset(aPlane.Elements(), aValue, aSamples);
+      return aPlane.Elements();
+    }
+    aPlane.SetLength(aSamples * sizeof(uint16_t));
+    auto* samples = reinterpret_cast<uint16_t*>(aPlane.Elements());
+    for (size_t i = 0; i < aSamples; i++) {
+      samples[i] = uint16_t(aValue) << (aBitDepth - 8);
+    }
+    return aPlane.Elements();
+  }
+
+  layers::PlanarYCbCrData mData;
+  nsTArray<uint8_t> mY;
+  nsTArray<uint8_t> mCb;
+  nsTArray<uint8_t> mCr;
+};
+
+void IsColorNear(const Color& aColor, uint8_t* aRGBX, size_t aSize) {
+  const int r = std::get<0>(aColor);
+  const int g = std::get<1>(aColor);
+  const int b = std::get<2>(aColor);
+  for (size_t i = 0; i < aSize; i += 4) {
+    ASSERT_NEAR(r, aRGBX[i], 2);      // R
+    ASSERT_NEAR(g, aRGBX[i + 1], 2);  // G
+    ASSERT_NEAR(b, aRGBX[i + 2], 2);  // B
+  }
+}
+
+TEST(YCbCrUtils, ConvertHighBitDepthYCbCrToRGB32)
+{
+  const gfx::IntSize imgSize(32, 16);
+  const int32_t stride =
+      imgSize.Width() * gfx::BytesPerPixel(gfx::SurfaceFormat::B8G8R8X8);
+  const size_t bufferSize = stride * imgSize.Height();
+
+  const std::array<gfx::YUVColorSpace, 3> colorSpaces{
+      gfx::YUVColorSpace::BT601, gfx::YUVColorSpace::BT709,
+      gfx::YUVColorSpace::BT2020};
+  const std::array<gfx::ColorDepth, 2> colorDepths{gfx::ColorDepth::COLOR_10,
+                                                   gfx::ColorDepth::COLOR_12};
+  const std::array<gfx::ChromaSubsampling, 3> subsamplings{
+      gfx::ChromaSubsampling::FULL, gfx::ChromaSubsampling::HALF_WIDTH,
+      gfx::ChromaSubsampling::HALF_WIDTH_AND_HEIGHT};
+
+  std::unordered_map<uint32_t, std::array<Color, 3>> expectations =
+      GetExpectedConvertedRGB();
+
+  for (const Color& color : COLOR_LIST) {
+    const std::array<Color, 3>& expectedColors = expectations[Hash(color)];
+    for (const gfx::YUVColorSpace& colorSpace : colorSpaces) {
+      for (const gfx::ColorDepth& colorDepth : colorDepths) {
+        for (const gfx::ChromaSubsampling& subsampling : subsamplings) {
+          YCbCrTestImage img(color, colorSpace, colorDepth, subsampling,
+                             imgSize);
+
+          UniquePtr<uint8_t[]> BGRX = MakeUnique<uint8_t[]>(bufferSize);
+          ConvertYCbCrToRGB32(img.GetData(), gfx::SurfaceFormat::B8G8R8X8,
+                              BGRX.get(), stride, nullptr);
+
+          UniquePtr<uint8_t[]> RGBX = MakeUnique<uint8_t[]>(bufferSize);
+          ConvertYCbCrToRGB32(img.GetData(), gfx::SurfaceFormat::R8G8B8X8,
+                              RGBX.get(), stride, nullptr);
+
+          IsColorEqual(BGRX.get(), RGBX.get(), bufferSize);
+
+          Color expectation = expectedColors[static_cast<size_t>(colorSpace)];
+          IsColorNear(expectation, RGBX.get(), bufferSize);
+        }
+      }
+    }
+  }
+}
+
+static void ConvertYCbCrToRGB32Perf(gfx::ColorDepth aColorDepth,
+                                    gfx::ChromaSubsampling aSubsampling) {
+  const gfx::IntSize imgSize(1920, 1080);
+  const int32_t stride =
+      imgSize.Width() * gfx::BytesPerPixel(gfx::SurfaceFormat::B8G8R8X8);
+  YCbCrTestImage img(CHOCOLATE, gfx::YUVColorSpace::BT709, aColorDepth,
+                     aSubsampling, imgSize);
+  UniquePtr<uint8_t[]> BGRX =
+      MakeUnique<uint8_t[]>(stride * imgSize.Height());
+  for (int i = 0; i < 10; i++) {
+    ConvertYCbCrToRGB32(img.GetData(), gfx::SurfaceFormat::B8G8R8X8,
+                        BGRX.get(), stride, nullptr);
+  }
+}
+
+MOZ_GTEST_BENCH(YCbCrUtilsPerf, I420, [] {
+  ConvertYCbCrToRGB32Perf(gfx::ColorDepth::COLOR_8,
+                          gfx::ChromaSubsampling::HALF_WIDTH_AND_HEIGHT);
+});
+MOZ_GTEST_BENCH(YCbCrUtilsPerf, I444, [] {
+  ConvertYCbCrToRGB32Perf(gfx::ColorDepth::COLOR_8,
+                          gfx::ChromaSubsampling::FULL);
+});
+MOZ_GTEST_BENCH(YCbCrUtilsPerf, I010, [] {
+  ConvertYCbCrToRGB32Perf(gfx::ColorDepth::COLOR_10,
+                          gfx::ChromaSubsampling::HALF_WIDTH_AND_HEIGHT);
+});
+MOZ_GTEST_BENCH(YCbCrUtilsPerf, I210, [] {
+  ConvertYCbCrToRGB32Perf(gfx::ColorDepth::COLOR_10,
+                          gfx::ChromaSubsampling::HALF_WIDTH);
+});
+MOZ_GTEST_BENCH(YCbCrUtilsPerf, I410, [] {
+  ConvertYCbCrToRGB32Perf(gfx::ColorDepth::COLOR_10,
+                          gfx::ChromaSubsampling::FULL);
+});
+MOZ_GTEST_BENCH(YCbCrUtilsPerf, I012, [] {
+  ConvertYCbCrToRGB32Perf(gfx::ColorDepth::COLOR_12,
+                          gfx::ChromaSubsampling::HALF_WIDTH_AND_HEIGHT);
+});
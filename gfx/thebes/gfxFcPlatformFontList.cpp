@@ -14,7 +14,9 @@
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/dom/ContentChild.h"
 #include "mozilla/dom/ContentParent.h"
+#include "mozilla/HashFunctions.h"
 #include "mozilla/Preferences.h"
+#include "mozilla/scache/StartupCache.h"
 #include "mozilla/Sprintf.h"
 #include "mozilla/StaticPrefs_gfx.h"
 #include "mozilla/glean/GfxMetrics.h"
@@ -30,6 +32,7 @@
 #include "nsDirectoryServiceDefs.h"
 #include "nsAppDirectoryServiceDefs.h"
 #include "nsCharSeparatedTokenizer.h"
+#include "nsPrintfCString.h"
 #include "nsXULAppAPI.h"
 #include "SharedFontList-impl.h"
 #include "StandardFonts-linux.inc"
@@ -42,6 +45,7 @@
 #include <fontconfig/fontconfig.h>
 #include <harfbuzz/hb.h>
 #include <dlfcn.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #ifdef MOZ_WIDGET_GTK
@@ -1732,6 +1736,191 @@ class FacesData {
   const FaceInitArray& Get() const { return mFaces; }
 };
 
+// The parent stores the family and face records of the shared font list in
+// the startup cache, so that later startups don't have to run fontconfig
+// substitution on and serialize every installed face again. The cache key
+// is a hash of everything the records depend on, so a stale list is never
+// read back; see FontListCacheKey.
+#define FONT_LIST_CACHE_PREFIX "font.fc-shared-list."
+
+static const char kCacheRecordSep = 0x1e;
+static const char kCacheFieldSep = 0x1f;
+
+// A local name table entry added while building the font list, so that a list
+// read from the cache can add the same entries.
+struct CachedLocalName {
+  nsCString mName;
+  fontlist::LocalFaceRec::InitData mData;
+};
+
+// Hashes the fontconfig configuration and the modification times of the font
+// directories it scanned, which is how fontconfig itself notices installed
+// and removed fonts when validating its caches.
+static nsCString FontListCacheKey(FcFontSet* aSystemFonts,
+                                  FcFontSet* aAppFonts, bool aSandboxed) {
+  HashNumber hash = HashGeneric(FcGetVersion(), uint32_t(sFontVisibilityDevice),
+                                aSystemFonts ? aSystemFonts->nfont : 0,
+                                aAppFonts ? aAppFonts->nfont : 0);
+  if (aSandboxed) {
+    // The sandbox policy decides which fonts we skip.
+    nsAutoCString readPaths;
+    Preferences::GetCString("security.sandbox.content.read_path_whitelist",
+                            readPaths);
+    hash = AddToHash(hash, HashString(readPaths));
+  }
+  auto addFiles = [&hash](FcStrList* aList) {
+    while (FcChar8* path = FcStrListNext(aList)) {
+      hash = AddToHash(hash, HashString(ToCharPtr(path)));
+      struct stat st;
+      if (stat(ToCharPtr(path), &st) == 0) {
+        hash = AddToHash(hash, uint64_t(st.st_mtime));
+      }
+    }
+    FcStrListDone(aList);
+  };
+  addFiles(FcConfigGetConfigFiles(nullptr));
+  addFiles(FcConfigGetFontDirs(nullptr));
+  return nsPrintfCString(FONT_LIST_CACHE_PREFIX "%08x", hash);
+}
+
+// Returns false, so that the list isn't cached, if aField contains one of the
+// separators.
+static bool AppendCacheField(nsACString& aBuf, const nsACString& aField) {
+  if (aField.FindChar(kCacheRecordSep) != kNotFound ||
+      aField.FindChar(kCacheFieldSep) != kNotFound) {
+    return false;
+  }
+  aBuf.Append(kCacheFieldSep);
+  aBuf.Append(aField);
+  return true;
+}
+
+static void AppendCacheField(nsACString& aBuf, uint32_t aField) {
+  aBuf.Append(kCacheFieldSep);
+  aBuf.AppendInt(aField);
+}
+
+static bool ParseCacheField(const nsACString& aField, uint32_t* aValue) {
+  nsresult rv;
+  int64_t value = nsAutoCString(aField).ToInteger64(&rv);
+  if (NS_FAILED(rv) || value < 0 || value > UINT32_MAX) {
+    return false;
+  }
+  *aValue = uint32_t(value);
+  return true;
+}
+
+static void WriteFontListCache(
+    const nsCString& aKey,
+    const nsTArray<fontlist::Family::InitData>& aFamilies,
+    const nsClassHashtable<nsCStringHashKey, FacesData>& aFaces,
+    const nsTArray<CachedLocalName>& aLocalNames, size_t aNumBaseFamilies) {
+  auto* cache = scache::StartupCache::GetSingleton();
+  if (!cache) {
+    return;
+  }
+
+  nsAutoCString buf;
+  buf.Append('N');
+  AppendCacheField(buf, uint32_t(aNumBaseFamilies));
+  buf.Append(kCacheRecordSep);
+  for (const auto& family : aFamilies) {
+    buf.Append('F');
+    if (!AppendCacheField(buf, family.mKey) ||
+        !AppendCacheField(buf, family.mName)) {
+      return;
+    }
+    AppendCacheField(buf, uint32_t(family.mVisibility));
+    AppendCacheField(buf, family.mBundled);
+    buf.Append(kCacheRecordSep);
+    for (const auto& face : aFaces.Get(family.mKey)->Get()) {
+      buf.Append('f');
+      if (!AppendCacheField(buf, face.mDescriptor)) {
+        return;
+      }
+      AppendCacheField(buf, face.mIndex);
+      AppendCacheField(buf, face.mSize);
+      AppendCacheField(buf, face.mFixedPitch);
+      AppendCacheField(buf, face.mWeight.AsScalar());
+      AppendCacheField(buf, face.mStretch.AsScalar());
+      AppendCacheField(buf, face.mStyle.AsScalar());
+      buf.Append(kCacheRecordSep);
+    }
+  }
+  for (const auto& localName : aLocalNames) {
+    buf.Append('L');
+    if (!AppendCacheField(buf, localName.mName) ||
+        !AppendCacheField(buf, localName.mData.mFamilyName) ||
+        !AppendCacheField(buf, localName.mData.mFaceDescriptor)) {
+      return;
+    }
+    buf.Append(kCacheRecordSep);
+  }
+
+  cache->PutBuffer(aKey.get(), UniqueFreePtr<char[]>(ToNewCString(buf)),
+                   buf.Length() + 1);
+}
+
+// Returns false if the data is malformed, leaving the out-params partially
+// filled in.
+static bool ReadFontListCache(
+    const nsACString& aBuf, nsTArray<fontlist::Family::InitData>& aFamilies,
+    nsClassHashtable<nsCStringHashKey, FacesData>& aFaces,
+    nsTArray<CachedLocalName>& aLocalNames, size_t* aNumBaseFamilies) {
+  bool haveHeader = false;
+  FacesData* faces = nullptr;
+  for (const auto& record : aBuf.Split(kCacheRecordSep)) {
+    if (record.IsEmpty()) {
+      continue;
+    }
+    AutoTArray<nsDependentCSubstring, 8> fields;
+    for (const auto& field : record.Split(kCacheFieldSep)) {
+      fields.AppendElement(field);
+    }
+    const nsDependentCSubstring& type = fields[0];
+    uint32_t values[6];
+    if (type.EqualsLiteral("N") && fields.Length() == 2) {
+      if (!ParseCacheField(fields[1], &values[0])) {
+        return false;
+      }
+      *aNumBaseFamilies = values[0];
+      haveHeader = true;
+    } else if (type.EqualsLiteral("F") && fields.Length() == 5) {
+      if (!ParseCacheField(fields[3], &values[0]) ||
+          !ParseCacheField(fields[4], &values[1]) ||
+          values[0] >= uint32_t(FontVisibility::Count)) {
+        return false;
+      }
+      aFamilies.AppendElement(fontlist::Family::InitData(
+          fields[1], fields[2], fontlist::Family::kNoIndex,
+          FontVisibility(values[0]), /*bundled*/ values[1],
+          /*badUnderline*/ false));
+      faces = aFaces.GetOrInsertNew(fields[1]);
+    } else if (type.EqualsLiteral("f") && fields.Length() == 8 && faces) {
+      for (uint32_t i = 0; i < 6; i++) {
+        if (!ParseCacheField(fields[i + 2], &values[i])) {
+          return false;
+        }
+      }
+      faces->Add(fontlist::Face::InitData{nsCString(fields[1]),
+                                          uint16_t(values[0]),
+                                          uint16_t(values[1]), bool(values[2]),
+                                          WeightRange::FromScalar(values[3]),
+                                          StretchRange::FromScalar(values[4]),
+                                          SlantStyleRange::FromScalar(
+                                              values[5])},
+                 /* singleName = */ false);
+    } else if (type.EqualsLiteral("L") && fields.Length() == 4) {
+      aLocalNames.AppendElement(CachedLocalName{
+          nsCString(fields[1]),
+          fontlist::LocalFaceRec::InitData(fields[2], fields[3])});
+    } else {
+      return false;
+    }
+  }
+  return haveHeader;
+}
+
 void gfxFcPlatformFontList::InitSharedFontListForPlatform() {
   mLocalNames.Clear();
   mFcSubstituteCache.Clear();
@@ -1788,11 +1977,25 @@ void gfxFcPlatformFontList::InitSharedFontListForPlatform() {
   int fcVersion = FcGetVersion();
   bool fcCharsetParseBug = fcVersion >= 21094 && fcVersion <= 21101;
 
+  // The local name table entries we add, to store them in the cache.
+  nsTArray<CachedLocalName> localNames;
+  auto addLocalName = [this, &localNames](
+                          const nsACString& aName,
+                          fontlist::LocalFaceRec::InitData&& aData) {
+    MOZ_PUSH_IGNORE_THREAD_SAFETY
+    MaybeAddToLocalNameTable(aName, aData);
+    MOZ_POP_THREAD_SAFETY
+    localNames.AppendElement(
+        CachedLocalName{nsCString(aName), std::move(aData)});
+  };
+
   // Returns true if the font was added with FontVisibility::Base.
   // This enables us to count how many known Base fonts are present.
-  auto addPattern = [this, fcCharsetParseBug, &families, &faces](
-                        FcPattern* aPattern, FcChar8*& aLastFamilyName,
-                        nsCString& aFamilyName, bool aAppFont) -> bool {
+  auto addPattern = [this, fcCharsetParseBug, &families, &faces,
+                     &addLocalName](FcPattern* aPattern,
+                                    FcChar8*& aLastFamilyName,
+                                    nsCString& aFamilyName,
+                                    bool aAppFont) -> bool {
     // get canonical name
     uint32_t cIndex = FindCanonicalNameIndex(aPattern, FC_FAMILYLANG);
     FcChar8* canonical = nullptr;
@@ -1889,8 +2092,8 @@ void gfxFcPlatformFontList::InitSharedFontListForPlatform() {
       MOZ_PUSH_IGNORE_THREAD_SAFETY
       if (!psname.IsEmpty()) {
         ToLowerCase(psname);
-        MaybeAddToLocalNameTable(
-            psname, fontlist::LocalFaceRec::InitData(keyName, descriptor));
+        addLocalName(psname,
+                     fontlist::LocalFaceRec::InitData(keyName, descriptor));
       }
       if (!fullname.IsEmpty()) {
         ToLowerCase(fullname);
@@ -1899,8 +2102,8 @@ void gfxFcPlatformFontList::InitSharedFontListForPlatform() {
           // way to name this family. This prevents dubious aliases from
           // clobbering the local name table.
           if (singleName || !mLocalNameTable.Contains(fullname)) {
-            MaybeAddToLocalNameTable(fullname, fontlist::LocalFaceRec::InitData(
-                                                   keyName, descriptor));
+            addLocalName(fullname,
+                         fontlist::LocalFaceRec::InitData(keyName, descriptor));
           }
         }
       }
@@ -1985,19 +2188,64 @@ void gfxFcPlatformFontList::InitSharedFontListForPlatform() {
     return count;
   };
 
+  FcFontSet* appFonts = nullptr;
 #ifdef MOZ_BUNDLED_FONTS
-  // Add bundled fonts before system fonts, to set correct visibility status
-  // for any families that appear in both.
   if (StaticPrefs::gfx_bundled_fonts_activate_AtStartup() != 0) {
-    FcFontSet* appFonts = FcConfigGetFonts(nullptr, FcSetApplication);
-    addFontSetFamilies(appFonts, policy.get(), /* aAppFonts = */ true);
+    appFonts = FcConfigGetFonts(nullptr, FcSetApplication);
   }
 #endif
-
-  // iterate over available fonts
   FcFontSet* systemFonts = FcConfigGetFonts(nullptr, FcSetSystem);
-  auto numBaseFamilies = addFontSetFamilies(systemFonts, policy.get(),
-                                            /* aAppFonts = */ false);
+
+  // The startup cache is only available on the main thread.
+  nsCString cacheKey;
+  if (StaticPrefs::gfx_font_list_fontconfig_cache_enabled_AtStartup() &&
+      NS_IsMainThread()) {
+    AssignFontVisibilityDevice();
+    cacheKey = FontListCacheKey(systemFonts, appFonts, !!policy);
+  }
+
+  size_t numBaseFamilies = 0;
+  bool readFromCache = false;
+  if (!cacheKey.IsEmpty()) {
+    const char* buf;
+    uint32_t length;
+    auto* cache = scache::StartupCache::GetSingleton();
+    if (cache &&
+        NS_SUCCEEDED(cache->GetBuffer(cacheKey.get(), &buf, &length)) &&
+        length > 0) {
+      readFromCache = ReadFontListCache(nsDependentCSubstring(buf, length - 1),
+                                        families, faces, localNames,
+                                        &numBaseFamilies);
+      if (readFromCache) {
+        MOZ_PUSH_IGNORE_THREAD_SAFETY
+        for (const auto& localName : localNames) {
+          MaybeAddToLocalNameTable(localName.mName, localName.mData);
+        }
+        MOZ_POP_THREAD_SAFETY
+      } else {
+        families.Clear();
+        faces.Clear();
+        localNames.Clear();
+        numBaseFamilies = 0;
+      }
+    }
+  }
+
+  if (!readFromCache) {
+    // Add bundled fonts before system fonts, to set correct visibility status
+    // for any families that appear in both.
+    if (appFonts) {
+      addFontSetFamilies(appFonts, policy.get(), /* aAppFonts = */ true);
+    }
+
+    // iterate over available fonts
+    numBaseFamilies = addFontSetFamilies(systemFonts, policy.get(),
+                                         /* aAppFonts = */ false);
+    if (!cacheKey.IsEmpty()) {
+      WriteFontListCache(cacheKey, families, faces, localNames,
+                         numBaseFamilies);
+    }
+  }
   AssignFontVisibilityDevice();
   if (numBaseFamilies < 3 && sFontVisibilityDevice != Device::Linux_Unknown) {
     // If we found fewer than 3 known FontVisibility::Base families in the
@@ -12,6 +12,7 @@
 #include "mozilla/IntegerRange.h"
 #include "mozilla/intl/Segmenter.h"
 #include "mozilla/MathAlgorithms.h"
+#include "mozilla/Monitor.h"
 #include "mozilla/StaticPrefs_gfx.h"
 #include "mozilla/ScopeExit.h"
 #include "mozilla/SVGContextPaint.h"
@@ -19,6 +20,7 @@
 #include "mozilla/Logging.h"
 
 #include "nsITimer.h"
+#include "nsThreadUtils.h"
 
 #include "gfxGlyphExtents.h"
 #include "gfxPlatform.h"
@@ -74,6 +76,33 @@ using mozilla::services::GetObserverService;
 
 gfxFontCache* gfxFontCache::gGlobalCache = nullptr;
 
+struct gfxFontCache::RetiredWordCache {
+  RetiredWordCache(gfxFont* aFont, UniquePtr<gfxFont::WordCache>&& aWords)
+      : mFontEntry(aFont->GetFontEntry()),
+        mStyle(*aFont->GetStyle()),
+        mUnicodeRangeMap(
+            const_cast<gfxCharacterMap*>(aFont->GetUnicodeRangeMap())),
+        mWords(std::move(aWords)) {}
+
+  // Whether aFont would have the same key in the font cache as the font
+  // these words came from.
+  bool Matches(const gfxFont* aFont) const {
+    const gfxCharacterMap* unicodeRangeMap = aFont->GetUnicodeRangeMap();
+    return mFontEntry == aFont->GetFontEntry() &&
+           mStyle.Equals(*aFont->GetStyle()) &&
+           ((!mUnicodeRangeMap && !unicodeRangeMap) ||
+            (mUnicodeRangeMap && unicodeRangeMap &&
+             mUnicodeRangeMap->Equals(unicodeRangeMap)));
+  }
+
+  // Keeps the entry and the map alive, so that a new font can't have the
+  // same pointers for a different face or range.
+  RefPtr<gfxFontEntry> mFontEntry;
+  gfxFontStyle mStyle;
+  RefPtr<gfxCharacterMap> mUnicodeRangeMap;
+  UniquePtr<gfxFont::WordCache> mWords;
+};
+
 #ifdef DEBUG_roc
 #  define DEBUG_TEXT_RUN_STORAGE_METRICS
 #endif
@@ -270,6 +299,15 @@ already_AddRefed<gfxFont> gfxFontCache::MaybeInsert(gfxFont* aFont) {
     // Assert that we can find the entry we just put in (this fails if the key
     // has a NaN float value in it, e.g. 'sizeAdjust').
     MOZ_ASSERT(entry == mFonts.GetEntry(key));
+
+    // Pick up the shaped words of a previous instance of the font.
+    for (size_t i = 0; i < mRetiredWordCaches.Length(); ++i) {
+      if (mRetiredWordCaches[i]->Matches(aFont)) {
+        aFont->AdoptWordCache(std::move(mRetiredWordCaches[i]->mWords));
+        mRetiredWordCaches.RemoveElementAt(i);
+        break;
+      }
+    }
   } else {
     MOZ_ASSERT(entry->mFont != aFont);
     aFont->Destroy();
@@ -346,12 +384,29 @@ void gfxFontCache::DestroyDiscard(nsTArray<gfxFont*>& aDiscard) {
   for (auto& font : aDiscard) {
     NS_ASSERTION(font->GetRefCount() == 0,
                  "Destroying with refs outside cache!");
-    font->ClearCachedWords();
+    RetireWordCache(font);
     font->Destroy();
   }
   aDiscard.Clear();
 }
 
+void gfxFontCache::RetireWordCache(gfxFont* aFont) {
+  UniquePtr<gfxFont::WordCache> words = aFont->TakeWordCache();
+  uint32_t maxCaches =
+      StaticPrefs::gfx_font_rendering_wordcache_retired_fonts();
+  if (!words || words->empty() || !maxCaches) {
+    return;
+  }
+
+  MutexAutoLock lock(mMutex);
+  if (mRetiredWordCaches.Length() >= maxCaches) {
+    mRetiredWordCaches.RemoveElementsAt(
+        0, mRetiredWordCaches.Length() - maxCaches + 1);
+  }
+  mRetiredWordCaches.AppendElement(
+      MakeUnique<RetiredWordCache>(aFont, std::move(words)));
+}
+
 void gfxFontCache::Flush() {
   nsTArray<gfxFont*> discard;
   {
@@ -383,6 +438,7 @@ void gfxFontCache::Flush() {
     mFonts.Clear();
   }
   DestroyDiscard(discard);
+  ClearRetiredWordCaches();
 }
 
 /*static*/
@@ -399,6 +455,10 @@ void gfxFontCache::AgeCachedWords() {
     for (const auto& entry : mFonts) {
       allEmpty = entry.mFont->AgeCachedWords() && allEmpty;
     }
+    mRetiredWordCaches.RemoveElementsBy([](const auto& aRetired) {
+      return gfxFont::AgeWordCache(*aRetired->mWords);
+    });
+    allEmpty = allEmpty && mRetiredWordCaches.IsEmpty();
   }
   if (allEmpty) {
     PauseWordCacheExpirationTimer();
@@ -411,6 +471,7 @@ void gfxFontCache::FlushShapedWordCaches() {
     for (const auto& entry : mFonts) {
       entry.mFont->ClearCachedWords();
     }
+    mRetiredWordCaches.Clear();
   }
   PauseWordCacheExpirationTimer();
 }
@@ -431,6 +492,13 @@ void gfxFontCache::AddSizeOfExcludingThis(MallocSizeOf aMallocSizeOf,
   for (const auto& entry : mFonts) {
     entry.mFont->AddSizeOfExcludingThis(aMallocSizeOf, aSizes);
   }
+  aSizes->mShapedWords +=
+      mRetiredWordCaches.ShallowSizeOfExcludingThis(aMallocSizeOf);
+  for (const auto& retired : mRetiredWordCaches) {
+    aSizes->mShapedWords += aMallocSizeOf(retired.get()) +
+                            gfxFont::SizeOfWordCache(*retired->mWords,
+                                                     aMallocSizeOf);
+  }
 }
 
 void gfxFontCache::AddSizeOfIncludingThis(MallocSizeOf aMallocSizeOf,
@@ -3221,19 +3289,34 @@ gfxFont::RunMetrics gfxFont::Measure(const gfxTextRun* aTextRun,
   return metrics;
 }
 
+/* static */
+bool gfxFont::AgeWordCache(WordCache& aCache) {
+  for (auto it = aCache.modIter(); !it.done(); it.next()) {
+    auto& entry = it.get().value();
+    if (!entry) {
+      NS_ASSERTION(entry, "cache entry has no gfxShapedWord!");
+      it.remove();
+    } else if (entry->IncrementAge() == kShapedWordCacheMaxAge) {
+      it.remove();
+    }
+  }
+  return aCache.empty();
+}
+
+/* static */
+size_t gfxFont::SizeOfWordCache(const WordCache& aCache,
+                                MallocSizeOf aMallocSizeOf) {
+  size_t n = aCache.shallowSizeOfIncludingThis(aMallocSizeOf);
+  for (auto it = aCache.iter(); !it.done(); it.next()) {
+    n += it.get().value()->SizeOfIncludingThis(aMallocSizeOf);
+  }
+  return n;
+}
+
 bool gfxFont::AgeCachedWords() {
   mozilla::AutoWriteLock lock(mLock);
   if (mWordCache) {
-    for (auto it = mWordCache->modIter(); !it.done(); it.next()) {
-      auto& entry = it.get().value();
-      if (!entry) {
-        NS_ASSERTION(entry, "cache entry has no gfxShapedWord!");
-        it.remove();
-      } else if (entry->IncrementAge() == kShapedWordCacheMaxAge) {
-        it.remove();
-      }
-    }
-    return mWordCache->empty();
+    return AgeWordCache(*mWordCache);
   }
   return true;
 }
@@ -3660,6 +3743,164 @@ inline static bool HasSpaces(const char16_t* aString, uint32_t aLen) {
   return false;
 }
 
+namespace {
+
+// A word of a text run that is missing from the word cache.
+struct UncachedWord {
+  uint32_t mOffset;
+  uint32_t mLength;
+  uint32_t mHash;
+  gfx::ShapedTextFlags mFlags;
+};
+
+// The words that gfxFont::PreShapeUncachedWords shapes, shared between the
+// main thread and the background tasks that help it.
+class ParallelShapingJob final {
+ public:
+  NS_INLINE_DECL_THREADSAFE_REFCOUNTING(ParallelShapingJob)
+
+  using ShapeWordFunc = std::function<void(const UncachedWord&)>;
+
+  ParallelShapingJob(nsTArray<UncachedWord>&& aWords,
+                     ShapeWordFunc&& aShapeWord)
+      : mWords(std::move(aWords)), mShapeWord(std::move(aShapeWord)) {}
+
+  // Shapes words until none are left to claim.  Tasks that only start once
+  // all the words are claimed return without touching the font or the text,
+  // so those only have to outlive Wait().
+  void Run() {
+    uint32_t count = mWords.Length();
+    for (uint32_t i = mNext++; i < count; i = mNext++) {
+      mShapeWord(mWords[i]);
+      if (++mDone == count) {
+        MonitorAutoLock lock(mMonitor);
+        lock.Notify();
+      }
+    }
+  }
+
+  // Waits until the words claimed by other threads are shaped.
+  void Wait() {
+    MonitorAutoLock lock(mMonitor);
+    while (mDone < mWords.Length()) {
+      lock.Wait();
+    }
+  }
+
+ private:
+  ~ParallelShapingJob() = default;
+
+  const nsTArray<UncachedWord> mWords;
+  const ShapeWordFunc mShapeWord;
+  Atomic<uint32_t> mNext{0};
+  Atomic<uint32_t> mDone{0};
+  Monitor mMonitor MOZ_UNANNOTATED{"ParallelShapingJob::mMonitor"};
+};
+
+}  // namespace
+
+// The number of uncached words each background task is dispatched for; with
+// fewer words, shaping them on the main thread is cheaper than handing them
+// out.
+static const uint32_t kParallelShapingWordsPerTask = 64;
+static const uint32_t kMaxParallelShapingTasks = 3;
+
+template <typename T>
+void gfxFont::PreShapeUncachedWords(const T* aString, uint32_t aRunLength,
+                                    Script aRunScript, nsAtom* aLanguage,
+                                    bool aVertical,
+                                    int32_t aAppUnitsPerDevUnit,
+                                    ShapedTextFlags aFlags,
+                                    RoundingFlags aRounding) {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  // Graphite shaping is only done on the main thread, so the background
+  // tasks would cache different glyphs.
+  if (FontCanSupportGraphite() && !aVertical &&
+      gfxPlatform::GetPlatform()->UseGraphiteShaping()) {
+    return;
+  }
+
+  uint32_t wordCacheCharLimit =
+      gfxPlatform::GetPlatform()->WordCacheCharLimit();
+  uint32_t wordCacheMaxEntries =
+      gfxPlatform::GetPlatform()->WordCacheMaxEntries();
+
+  // Find the words SplitAndInitTextRun will look up in the word cache, the
+  // same way it does, and collect the ones that aren't there yet.
+  nsTArray<UncachedWord> words;
+  HashSet<WordCacheKey, WordCacheKey::HashPolicy> seen;
+  {
+    AutoReadLock lock(mLock);
+    uint32_t cached = mWordCache ? mWordCache->count() : 0;
+    uint32_t wordStart = 0;
+    uint32_t hash = 0;
+    bool wordIs8Bit = true;
+    T nextCh = aString[0];
+    for (uint32_t i = 0; i <= aRunLength; ++i) {
+      T ch = nextCh;
+      nextCh = (i < aRunLength - 1) ? aString[i + 1] : '\n';
+      bool boundary = IsBoundarySpace(ch, nextCh);
+      if (!boundary && i < aRunLength && !gfxFontGroup::IsInvalidChar(ch)) {
+        if (!IsChar8Bit(ch)) {
+          wordIs8Bit = false;
+        }
+        hash = gfxShapedWord::HashMix(hash, ch);
+        continue;
+      }
+
+      uint32_t length = i - wordStart;
+      if (length > 0 && length <= wordCacheCharLimit) {
+        ShapedTextFlags wordFlags = aFlags;
+        if (sizeof(T) == sizeof(char16_t) && wordIs8Bit) {
+          wordFlags |= ShapedTextFlags::TEXT_IS_8BIT;
+        }
+        WordCacheKey key(aString + wordStart, length, hash, aRunScript,
+                         aLanguage, aAppUnitsPerDevUnit, wordFlags,
+                         aRounding);
+        if (!mWordCache || !mWordCache->has(key)) {
+          auto entry = seen.lookupForAdd(key);
+          if (!entry) {
+            // Don't make the word cache flush itself.
+            if (cached + words.Length() >= wordCacheMaxEntries ||
+                !seen.add(entry, key)) {
+              break;
+            }
+            words.AppendElement(
+                UncachedWord{wordStart, length, hash, wordFlags});
+          }
+        }
+      }
+      hash = 0;
+      wordStart = i + 1;
+      wordIs8Bit = true;
+    }
+  }
+
+  uint32_t taskCount = std::min(
+      uint32_t(words.Length()) / kParallelShapingWordsPerTask,
+      kMaxParallelShapingTasks);
+  if (!taskCount) {
+    return;
+  }
+
+  // The draw target isn't thread-safe, and the shapers don't use it.
+  RefPtr<ParallelShapingJob> job = new ParallelShapingJob(
+      std::move(words), [=](const UncachedWord& aWord) {
+        Unused << ProcessShapedWordInternal(
+            nullptr, aString + aWord.mOffset, aWord.mLength, aWord.mHash,
+            aRunScript, aLanguage, aVertical, aAppUnitsPerDevUnit,
+            aWord.mFlags, aRounding, nullptr, [](gfxShapedWord*) {});
+      });
+  for (uint32_t i = 0; i < taskCount; ++i) {
+    // If this fails, the main thread shapes the words itself.
+    Unused << NS_DispatchBackgroundTask(NS_NewRunnableFunction(
+        "gfxFont::PreShapeUncachedWords", [job] { job->Run(); }));
+  }
+  job->Run();
+  job->Wait();
+}
+
 template <typename T>
 bool gfxFont::SplitAndInitTextRun(
     DrawTarget* aDrawTarget, gfxTextRun* aTextRun,
@@ -3731,6 +3972,14 @@ bool gfxFont::SplitAndInitTextRun(
   bool wordIs8Bit = true;
   int32_t appUnitsPerDevUnit = aTextRun->GetAppUnitsPerDevUnit();
 
+  uint32_t parallelMinLength =
+      StaticPrefs::gfx_font_rendering_wordcache_parallel_shaping_min_length();
+  if (parallelMinLength && aRunLength >= parallelMinLength &&
+      NS_IsMainThread()) {
+    PreShapeUncachedWords(aString, aRunLength, aRunScript, aLanguage, vertical,
+                          appUnitsPerDevUnit, flags, rounding);
+  }
+
   T nextCh = aString[0];
   for (uint32_t i = 0; i <= aRunLength; ++i) {
     T ch = nextCh;
@@ -4728,12 +4977,7 @@ void gfxFont::AddSizeOfExcludingThis(MallocSizeOf aMallocSizeOf,
         mGlyphExtentsArray[i]->SizeOfIncludingThis(aMallocSizeOf);
   }
   if (mWordCache) {
-    aSizes->mShapedWords +=
-        mWordCache->shallowSizeOfIncludingThis(aMallocSizeOf);
-    for (auto it = mWordCache->iter(); !it.done(); it.next()) {
-      aSizes->mShapedWords +=
-          it.get().value()->SizeOfIncludingThis(aMallocSizeOf);
-    }
+    aSizes->mShapedWords += SizeOfWordCache(*mWordCache, aMallocSizeOf);
   }
 }
 
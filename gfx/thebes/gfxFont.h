@@ -413,6 +413,14 @@ class gfxFontCache final
 
   void DestroyDiscard(nsTArray<gfxFont*>& aDiscard);
 
+  // Keeps the shaped words of a font that is being destroyed, so that a new
+  // instance of the same font can reuse them.
+  void RetireWordCache(gfxFont* aFont);
+  void ClearRetiredWordCaches() {
+    mozilla::MutexAutoLock lock(mMutex);
+    mRetiredWordCaches.Clear();
+  }
+
   static gfxFontCache* gGlobalCache;
 
   struct MOZ_STACK_CLASS Key {
@@ -450,6 +458,12 @@ class gfxFontCache final
 
   nsTArray<gfxFont*> mTrackerDiscard MOZ_GUARDED_BY(mMutex);
 
+  // The word caches of destroyed fonts, oldest first.  They are aged by the
+  // word cache expiration timer like the caches of live fonts.
+  struct RetiredWordCache;
+  nsTArray<mozilla::UniquePtr<RetiredWordCache>> mRetiredWordCaches
+      MOZ_GUARDED_BY(mMutex);
+
   static void WordCacheExpirationTimerCallback(nsITimer* aTimer, void* aCache);
 
   nsCOMPtr<nsITimer> mWordCacheExpirationTimer MOZ_GUARDED_BY(mMutex);
@@ -1423,6 +1437,7 @@ struct FontDrawParams;
 struct EmphasisMarkDrawParams;
 
 class gfxFont {
+  friend class gfxFontCache;
   friend class gfxHarfBuzzShaper;
   friend class gfxGraphiteShaper;
 
@@ -1835,6 +1850,16 @@ class gfxFont {
                            nsAtom* aLanguage,
                            mozilla::gfx::ShapedTextFlags aOrientation);
 
+  // Helper for SplitAndInitTextRun: shapes the words of a long run that are
+  // missing from the word cache in parallel, on background threads, so that
+  // building the run only has to copy them from the cache.
+  template <typename T>
+  void PreShapeUncachedWords(const T* aString, uint32_t aRunLength,
+                             Script aRunScript, nsAtom* aLanguage,
+                             bool aVertical, int32_t aAppUnitsPerDevUnit,
+                             mozilla::gfx::ShapedTextFlags aFlags,
+                             RoundingFlags aRounding);
+
   // Get a ShapedWord representing a single space for use in setting up a
   // gfxTextRun.
   bool ProcessSingleSpaceShapedWord(
@@ -2183,13 +2208,33 @@ class gfxFont {
     };
   };
 
-  mozilla::UniquePtr<
-      mozilla::HashMap<WordCacheKey, mozilla::UniquePtr<gfxShapedWord>,
-                       WordCacheKey::HashPolicy>>
-      mWordCache MOZ_GUARDED_BY(mLock);
+  typedef mozilla::HashMap<WordCacheKey, mozilla::UniquePtr<gfxShapedWord>,
+                           WordCacheKey::HashPolicy>
+      WordCache;
+
+  mozilla::UniquePtr<WordCache> mWordCache MOZ_GUARDED_BY(mLock);
 
   static const uint32_t kShapedWordCacheMaxAge = 3;
 
+  // Increments the age of all the words in aCache and removes the expired
+  // ones. Returns true if the cache is now empty.
+  static bool AgeWordCache(WordCache& aCache);
+  static size_t SizeOfWordCache(const WordCache& aCache,
+                                mozilla::MallocSizeOf aMallocSizeOf);
+
+  // Used by gfxFontCache to hand the shaped words of a destroyed font over
+  // to a new instance of it.
+  mozilla::UniquePtr<WordCache> TakeWordCache() {
+    mozilla::AutoWriteLock lock(mLock);
+    return std::move(mWordCache);
+  }
+  void AdoptWordCache(mozilla::UniquePtr<WordCache>&& aCache) {
+    mozilla::AutoWriteLock lock(mLock);
+    if (!mWordCache) {
+      mWordCache = std::move(aCache);
+    }
+  }
+
   nsTArray<mozilla::UniquePtr<gfxGlyphExtents>> mGlyphExtentsArray
       MOZ_GUARDED_BY(mLock);
   mozilla::UniquePtr<nsTHashSet<GlyphChangeObserver*>> mGlyphChangeObservers
@@ -6,8 +6,8 @@
 
 #include "mozilla/StaticPrefs_gfx.h"
 #include "gfxUtils.h"
-#include "mozilla/Mutex.h"
 #include "mozilla/Range.h"
+#include "mozilla/RWLock.h"
 #include "mozilla/gfx/2D.h"
 #include "mozilla/gfx/RectAbsolute.h"
 #include "mozilla/gfx/Logging.h"
@@ -77,7 +77,9 @@ struct FontInstanceData {
   FontInstanceData() : mSize(0), mNumVariations(0) {}
 };
 
-StaticMutex sFontDataTableLock;
+// Blob rasterization runs on every worker of the WebRender thread pool, and
+// only needs to read the tables once the fonts of a blob are resolved.
+StaticRWLock sFontDataTableLock;
 MOZ_RUNINIT std::unordered_map<WrFontKey, FontTemplate> sFontDataTable;
 MOZ_RUNINIT std::unordered_map<WrFontInstanceKey, FontInstanceData>
     sBlobFontTable;
@@ -125,7 +127,7 @@ static struct FontDeleteLog {
 } sFontDeleteLog;
 
 void ClearAllBlobImageResources() {
-  StaticMutexAutoLock lock(sFontDataTableLock);
+  StaticAutoWriteLock lock(sFontDataTableLock);
   sFontDeleteLog.AddAll();
   sBlobFontTable.clear();
   sFontDataTable.clear();
@@ -133,7 +135,7 @@ void ClearAllBlobImageResources() {
 
 extern "C" {
 void ClearBlobImageResources(WrIdNamespace aNamespace) {
-  StaticMutexAutoLock lock(sFontDataTableLock);
+  StaticAutoWriteLock lock(sFontDataTableLock);
   sFontDeleteLog.Add(aNamespace);
   for (auto i = sBlobFontTable.begin(); i != sBlobFontTable.end();) {
     if (i->first.mNamespace == aNamespace) {
@@ -152,13 +154,13 @@ void ClearBlobImageResources(WrIdNamespace aNamespace) {
 }
 
 bool HasFontData(WrFontKey aKey) {
-  StaticMutexAutoLock lock(sFontDataTableLock);
+  StaticAutoReadLock lock(sFontDataTableLock);
   return sFontDataTable.find(aKey) != sFontDataTable.end();
 }
 
 void AddFontData(WrFontKey aKey, const uint8_t* aData, size_t aSize,
                  uint32_t aIndex, const ArcVecU8* aVec) {
-  StaticMutexAutoLock lock(sFontDataTableLock);
+  StaticAutoWriteLock lock(sFontDataTableLock);
   auto i = sFontDataTable.find(aKey);
   if (i == sFontDataTable.end()) {
     FontTemplate& font = sFontDataTable[aKey];
@@ -170,7 +172,7 @@ void AddFontData(WrFontKey aKey, const uint8_t* aData, size_t aSize,
 }
 
 void AddNativeFontHandle(WrFontKey aKey, void* aHandle, uint32_t aIndex) {
-  StaticMutexAutoLock lock(sFontDataTableLock);
+  StaticAutoWriteLock lock(sFontDataTableLock);
   auto i = sFontDataTable.find(aKey);
   if (i == sFontDataTable.end()) {
     FontTemplate& font = sFontDataTable[aKey];
@@ -191,7 +193,7 @@ void AddNativeFontHandle(WrFontKey aKey, void* aHandle, uint32_t aIndex) {
 }
 
 void DeleteFontData(WrFontKey aKey) {
-  StaticMutexAutoLock lock(sFontDataTableLock);
+  StaticAutoWriteLock lock(sFontDataTableLock);
   sFontDeleteLog.Add(aKey);
   auto i = sFontDataTable.find(aKey);
   if (i != sFontDataTable.end()) {
@@ -203,7 +205,7 @@ void AddBlobFont(WrFontInstanceKey aInstanceKey, WrFontKey aFontKey,
                  float aSize, const FontInstanceOptions* aOptions,
                  const FontInstancePlatformOptions* aPlatformOptions,
                  const FontVariation* aVariations, size_t aNumVariations) {
-  StaticMutexAutoLock lock(sFontDataTableLock);
+  StaticAutoWriteLock lock(sFontDataTableLock);
   auto i = sBlobFontTable.find(aInstanceKey);
   if (i == sBlobFontTable.end()) {
     FontInstanceData& font = sBlobFontTable[aInstanceKey];
@@ -226,7 +228,7 @@ void AddBlobFont(WrFontInstanceKey aInstanceKey, WrFontKey aFontKey,
 }
 
 void DeleteBlobFont(WrFontInstanceKey aKey) {
-  StaticMutexAutoLock lock(sFontDataTableLock);
+  StaticAutoWriteLock lock(sFontDataTableLock);
   auto i = sBlobFontTable.find(aKey);
   if (i != sBlobFontTable.end()) {
     sBlobFontTable.erase(i);
@@ -281,7 +283,16 @@ static RefPtr<UnscaledFont> GetUnscaledFont(Translator* aTranslator,
 
 static RefPtr<ScaledFont> GetScaledFont(Translator* aTranslator,
                                         WrFontInstanceKey aKey) {
-  StaticMutexAutoLock lock(sFontDataTableLock);
+  {
+    // Fonts are created once, so tiles usually find them without having to
+    // wait for each other.
+    StaticAutoReadLock lock(sFontDataTableLock);
+    auto i = sBlobFontTable.find(aKey);
+    if (i != sBlobFontTable.end() && i->second.mScaledFont) {
+      return i->second.mScaledFont;
+    }
+  }
+  StaticAutoWriteLock lock(sFontDataTableLock);
   auto i = sBlobFontTable.find(aKey);
   if (i == sBlobFontTable.end()) {
     gfxDevCrash(LogReason::ScaledFontNotFound)
@@ -401,6 +412,9 @@ static bool Moz2DRenderCallback(const Range<const uint8_t> aBlob,
                                  aDirtyRect->width(), aDirtyRect->height()));
   }
 
+  // Items of the tile often share fonts, so only look each one up once.
+  std::unordered_map<WrFontInstanceKey, RefPtr<ScaledFont>> tileFonts;
+
   bool ret = true;
   size_t offset = 0;
   auto absBounds = IntRectAbsolute::FromRect(bounds);
@@ -422,8 +436,10 @@ static bool Moz2DRenderCallback(const Range<const uint8_t> aBlob,
     size_t count = fontReader.ReadSize();
     for (size_t i = 0; i < count; i++) {
       layers::BlobFont blobFont = fontReader.ReadBlobFont();
-      RefPtr<ScaledFont> scaledFont =
-          GetScaledFont(&translator, blobFont.mFontInstanceKey);
+      RefPtr<ScaledFont>& scaledFont = tileFonts[blobFont.mFontInstanceKey];
+      if (!scaledFont) {
+        scaledFont = GetScaledFont(&translator, blobFont.mFontInstanceKey);
+      }
       translator.AddScaledFont(blobFont.mScaledFontPtr, scaledFont);
     }
 
@@ -285,6 +285,35 @@ static nsresult ConvertYCbCrToRGB(const layers::PlanarYCbCrData& aData,
                              aRGB32Type);
 }
 
+// Converts high bit depth data without copying it into 8 bit planes first, if
+// libyuv can. Returns NS_ERROR_NOT_IMPLEMENTED otherwise.
+static nsresult ConvertYCbCr16ToRGB(const layers::PlanarYCbCrData& aData,
+                                    unsigned char* aDestBuffer,
+                                    int32_t aStride,
+                                    YUVType aYUVType,
+                                    RGB32Type aRGB32Type) {
+  if (aData.mColorDepth == ColorDepth::COLOR_8) {
+    return NS_ERROR_NOT_IMPLEMENTED;
+  }
+  return ConvertYCbCr16ToRGB32(
+      reinterpret_cast<const uint16_t*>(aData.mYChannel),
+      reinterpret_cast<const uint16_t*>(aData.mCbChannel),
+      reinterpret_cast<const uint16_t*>(aData.mCrChannel),
+      aDestBuffer,
+      aData.mPictureRect.x,
+      aData.mPictureRect.y,
+      aData.mPictureRect.width,
+      aData.mPictureRect.height,
+      aData.mYStride / 2,
+      aData.mCbCrStride / 2,
+      aStride,
+      aYUVType,
+      BitDepthForColorDepth(aData.mColorDepth),
+      aData.mYUVColorSpace,
+      aData.mColorRange,
+      aRGB32Type);
+}
+
 nsresult ConvertYCbCrToRGB(const layers::PlanarYCbCrData& aData,
                            const SurfaceFormat& aDestFormat,
                            const IntSize& aDestSize, unsigned char* aDestBuffer,
@@ -293,20 +322,28 @@ nsresult ConvertYCbCrToRGB(const layers::PlanarYCbCrData& aData,
   // luma plane is odd sized. Monochrome images have 0-sized CbCr planes
   YUVType yuvtype = GetYUVType(aData);
 
-  YUV8BitData data;
-  nsresult result = data.Init(aData);
-  if (NS_FAILED(result)) {
-    return result;
+  nsresult result = NS_ERROR_NOT_IMPLEMENTED;
+  if (aDestFormat != SurfaceFormat::R5G6B5_UINT16 &&
+      aDestSize == aData.mPictureRect.Size()) {
+    result = ConvertYCbCr16ToRGB(aData, aDestBuffer, aStride, yuvtype,
+                                 RGB32Type::ARGB);
   }
-  const layers::PlanarYCbCrData& srcData = data.Get8BitData();
-
-  // Convert from YCbCr to RGB now, scaling the image if needed.
-  if (aDestSize != srcData.mPictureRect.Size()) {
-    result = ScaleYCbCrToRGB(srcData, aDestFormat, aDestSize, aDestBuffer,
-                             aStride, yuvtype);
-  } else {  // no prescale
-    result = ConvertYCbCrToRGB(srcData, aDestFormat, aDestBuffer, aStride,
-                               yuvtype, RGB32Type::ARGB);
+  if (result == NS_ERROR_NOT_IMPLEMENTED) {
+    YUV8BitData data;
+    result = data.Init(aData);
+    if (NS_FAILED(result)) {
+      return result;
+    }
+    const layers::PlanarYCbCrData& srcData = data.Get8BitData();
+
+    // Convert from YCbCr to RGB now, scaling the image if needed.
+    if (aDestSize != srcData.mPictureRect.Size()) {
+      result = ScaleYCbCrToRGB(srcData, aDestFormat, aDestSize, aDestBuffer,
+                               aStride, yuvtype);
+    } else {  // no prescale
+      result = ConvertYCbCrToRGB(srcData, aDestFormat, aDestBuffer, aStride,
+                                 yuvtype, RGB32Type::ARGB);
+    }
   }
   if (NS_FAILED(result)) {
     return result;
@@ -358,13 +395,6 @@ nsresult ConvertYCbCrToRGB32(const layers::PlanarYCbCrData& aData,
 
   YUVType yuvtype = GetYUVType(aData);
 
-  YUV8BitData data8pp;
-  nsresult result = data8pp.Init(aData);
-  if (NS_FAILED(result)) {
-    return result;
-  }
-  const layers::PlanarYCbCrData& data = data8pp.Get8BitData();
-
   // The order of SurfaceFormat's R, G, B, A is reversed compared to libyuv's
   // order.
   RGB32Type rgb32Type = aDestFormat == SurfaceFormat::B8G8R8A8 ||
@@ -372,14 +402,37 @@ nsresult ConvertYCbCrToRGB32(const layers::PlanarYCbCrData& aData,
                             ? RGB32Type::ARGB
                             : RGB32Type::ABGR;
 
+  bool needAlpha = aDestFormat == SurfaceFormat::B8G8R8A8 ||
+                   aDestFormat == SurfaceFormat::R8G8B8A8;
+  if (!aData.mAlpha || !needAlpha) {
+    nsresult result =
+        ConvertYCbCr16ToRGB(aData, aDestBuffer, aStride, yuvtype, rgb32Type);
+    if (result != NS_ERROR_NOT_IMPLEMENTED) {
+#if MOZ_BIG_ENDIAN()
+      if (NS_SUCCEEDED(result) &&
+          !gfx::SwizzleData(aDestBuffer, aStride, gfx::SurfaceFormat::X8R8G8B8,
+                            aDestBuffer, aStride, gfx::SurfaceFormat::B8G8R8X8,
+                            aData.mPictureRect.Size())) {
+        return NS_ERROR_UNEXPECTED;
+      }
+#endif
+      return result;
+    }
+  }
+
+  YUV8BitData data8pp;
+  nsresult result = data8pp.Init(aData);
+  if (NS_FAILED(result)) {
+    return result;
+  }
+  const layers::PlanarYCbCrData& data = data8pp.Get8BitData();
+
   result = ConvertYCbCrToRGB(data, aDestFormat, aDestBuffer, aStride, yuvtype,
                              rgb32Type);
   if (NS_FAILED(result)) {
     return result;
   }
 
-  bool needAlpha = aDestFormat == SurfaceFormat::B8G8R8A8 ||
-                   aDestFormat == SurfaceFormat::R8G8B8A8;
   if (data.mAlpha && needAlpha) {
     // Alpha stride should be same as the Y stride.
     FillAlphaToRGBA(data.mAlpha->mChannel, data.mYStride, aDestBuffer,
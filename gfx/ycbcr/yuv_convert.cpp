@@ -79,23 +79,9 @@ int GBRPlanarToARGB(const uint8_t* src_y, int y_pitch,
   return 0;
 }
 
-// Convert a frame of YUV to 32 bit ARGB or ABGR.
-nsresult
-ConvertYCbCrToRGB32(const uint8_t* y_buf,
-                    const uint8_t* u_buf,
-                    const uint8_t* v_buf,
-                    uint8_t* rgb_buf,
-                    int pic_x,
-                    int pic_y,
-                    int pic_width,
-                    int pic_height,
-                    int y_pitch,
-                    int uv_pitch,
-                    int rgb_pitch,
-                    YUVType yuv_type,
-                    YUVColorSpace yuv_color_space,
-                    ColorRange color_range,
-                    RGB32Type rgb32_type) {
+static bool
+UseDeprecatedConversion(YUVColorSpace yuv_color_space,
+                        ColorRange color_range) {
   // Deprecated function's conversion is accurate.
   // libyuv converion is a bit inaccurate to get performance. It dynamically
   // calculates RGB from YUV to use simd. In it, signed byte is used for
@@ -110,47 +96,69 @@ ConvertYCbCrToRGB32(const uint8_t* y_buf,
                          color_range == ColorRange::LIMITED);
   // The deprecated function only support BT601.
   // See Bug 1210357.
-  if (yuv_color_space != YUVColorSpace::BT601) {
-    use_deprecated = false;
-  }
-  if (use_deprecated) {
-    return ConvertYCbCrToRGB32_deprecated(
-        y_buf, u_buf, v_buf, rgb_buf, pic_x, pic_y, pic_width, pic_height,
-        y_pitch, uv_pitch, rgb_pitch, yuv_type, rgb32_type);
-  }
-
-  decltype(libyuv::I420ToARGBMatrix)* fConvertYUVToARGB = nullptr;
-  const uint8_t* src_y = nullptr;
-  const uint8_t* src_u = nullptr;
-  const uint8_t* src_v = nullptr;
-  const libyuv::YuvConstants* yuv_constant = nullptr;
-  bool swap_uv = rgb32_type == RGB32Type::ABGR;
+  return use_deprecated && yuv_color_space == YUVColorSpace::BT601;
+}
 
+// Returns null for the Identity color space, which isn't a matrix.
+static const libyuv::YuvConstants*
+GetYuvConstants(YUVColorSpace yuv_color_space,
+                ColorRange color_range,
+                bool swap_uv) {
   switch (yuv_color_space) {
     case YUVColorSpace::BT2020:
-      yuv_constant = color_range == ColorRange::LIMITED
+      return color_range == ColorRange::LIMITED
         ? swap_uv? &libyuv::kYvu2020Constants : &libyuv::kYuv2020Constants
         : swap_uv? &libyuv::kYvuV2020Constants : &libyuv::kYuvV2020Constants;
-      break;
     case YUVColorSpace::BT709:
-      yuv_constant = color_range == ColorRange::LIMITED
+      return color_range == ColorRange::LIMITED
         ? swap_uv? &libyuv::kYvuH709Constants : &libyuv::kYuvH709Constants
         : swap_uv? &libyuv::kYvuF709Constants : &libyuv::kYuvF709Constants;
-      break;
     case YUVColorSpace::Identity:
-      if (yuv_type == YV24) {
-        break;
-      }
-      NS_WARNING("Identity (aka RGB) with chroma subsampling is unsupported");
-      return NS_ERROR_NOT_IMPLEMENTED;
-      // TODO: Consider using BT601 for unsupported input?
+      return nullptr;
     default:
       MOZ_FALLTHROUGH_ASSERT("Unsupported YUVColorSpace");
     case YUVColorSpace::BT601:
-      yuv_constant = color_range == ColorRange::LIMITED
+      return color_range == ColorRange::LIMITED
         ? swap_uv? &libyuv::kYvuI601Constants : &libyuv::kYuvI601Constants
         : swap_uv? &libyuv::kYvuJPEGConstants : &libyuv::kYuvJPEGConstants;
-      break;
+  }
+}
+
+// Convert a frame of YUV to 32 bit ARGB or ABGR.
+nsresult
+ConvertYCbCrToRGB32(const uint8_t* y_buf,
+                    const uint8_t* u_buf,
+                    const uint8_t* v_buf,
+                    uint8_t* rgb_buf,
+                    int pic_x,
+                    int pic_y,
+                    int pic_width,
+                    int pic_height,
+                    int y_pitch,
+                    int uv_pitch,
+                    int rgb_pitch,
+                    YUVType yuv_type,
+                    YUVColorSpace yuv_color_space,
+                    ColorRange color_range,
+                    RGB32Type rgb32_type) {
+  if (UseDeprecatedConversion(yuv_color_space, color_range)) {
+    return ConvertYCbCrToRGB32_deprecated(
+        y_buf, u_buf, v_buf, rgb_buf, pic_x, pic_y, pic_width, pic_height,
+        y_pitch, uv_pitch, rgb_pitch, yuv_type, rgb32_type);
+  }
+
+  decltype(libyuv::I420ToARGBMatrix)* fConvertYUVToARGB = nullptr;
+  const uint8_t* src_y = nullptr;
+  const uint8_t* src_u = nullptr;
+  const uint8_t* src_v = nullptr;
+  bool swap_uv = rgb32_type == RGB32Type::ABGR;
+  const libyuv::YuvConstants* yuv_constant =
+      GetYuvConstants(yuv_color_space, color_range, swap_uv);
+
+  if (yuv_color_space == YUVColorSpace::Identity && yuv_type != YV24) {
+    NS_WARNING("Identity (aka RGB) with chroma subsampling is unsupported");
+    return NS_ERROR_NOT_IMPLEMENTED;
+    // TODO: Consider using BT601 for unsupported input?
   }
 
   switch (yuv_type) {
@@ -210,6 +218,77 @@ ConvertYCbCrToRGB32(const uint8_t* y_buf,
                                       yuv_constant, pic_width, pic_height));
 }
 
+// Convert a frame of 10 or 12 bit YUV to 32 bit ARGB or ABGR, without first
+// reducing the planes to 8 bits.
+nsresult
+ConvertYCbCr16ToRGB32(const uint16_t* y_buf,
+                      const uint16_t* u_buf,
+                      const uint16_t* v_buf,
+                      uint8_t* rgb_buf,
+                      int pic_x,
+                      int pic_y,
+                      int pic_width,
+                      int pic_height,
+                      int y_pitch,
+                      int uv_pitch,
+                      int rgb_pitch,
+                      YUVType yuv_type,
+                      int bit_depth,
+                      YUVColorSpace yuv_color_space,
+                      ColorRange color_range,
+                      RGB32Type rgb32_type) {
+  // Leave the conversions libyuv has no high bit depth functions for, and the
+  // ones ConvertYCbCrToRGB32 does without libyuv, to the 8 bit path.
+  if (yuv_color_space == YUVColorSpace::Identity ||
+      UseDeprecatedConversion(yuv_color_space, color_range)) {
+    return NS_ERROR_NOT_IMPLEMENTED;
+  }
+
+  decltype(libyuv::I010ToARGBMatrix)* fConvertYUVToARGB = nullptr;
+  int x_shift = 0;
+  int y_shift = 0;
+  switch (yuv_type) {
+    case YV24:
+      if (bit_depth == 10) {
+        fConvertYUVToARGB = libyuv::I410ToARGBMatrix;
+      }
+      break;
+    case YV16:
+      if (bit_depth == 10) {
+        fConvertYUVToARGB = libyuv::I210ToARGBMatrix;
+      }
+      x_shift = 1;
+      break;
+    case YV12:
+      if (bit_depth == 10) {
+        fConvertYUVToARGB = libyuv::I010ToARGBMatrix;
+      } else if (bit_depth == 12) {
+        fConvertYUVToARGB = libyuv::I012ToARGBMatrix;
+      }
+      x_shift = 1;
+      y_shift = 1;
+      break;
+    default:
+      break;
+  }
+  if (!fConvertYUVToARGB) {
+    return NS_ERROR_NOT_IMPLEMENTED;
+  }
+
+  bool swap_uv = rgb32_type == RGB32Type::ABGR;
+  const uint16_t* src_y = y_buf + y_pitch * pic_y + pic_x;
+  const uint16_t* src_u =
+      u_buf + uv_pitch * (pic_y >> y_shift) + (pic_x >> x_shift);
+  const uint16_t* src_v =
+      v_buf + uv_pitch * (pic_y >> y_shift) + (pic_x >> x_shift);
+  const uint16_t* u_channel = swap_uv? src_v : src_u;
+  const uint16_t* v_channel = swap_uv? src_u : src_v;
+  return ToNSResult(fConvertYUVToARGB(
+      src_y, y_pitch, u_channel, uv_pitch, v_channel, uv_pitch, rgb_buf,
+      rgb_pitch, GetYuvConstants(yuv_color_space, color_range, swap_uv),
+      pic_width, pic_height));
+}
+
 // Convert a frame of YUV to 32 bit ARGB or ABGR.
 nsresult
 ConvertYCbCrToRGB32_deprecated(const uint8_t* y_buf,
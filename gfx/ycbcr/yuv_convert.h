@@ -70,6 +70,27 @@ ConvertYCbCrToRGB32(const uint8_t* yplane,
                     ColorRange color_range,
                     RGB32Type rgb32_type);
 
+// Convert a frame of 10 or 12 bit YUV, with pitches in samples, to 32 bit
+// ARGB or ABGR.  Returns NS_ERROR_NOT_IMPLEMENTED for the formats it has no
+// fast path for, which callers convert to 8 bit YUV first.
+nsresult
+ConvertYCbCr16ToRGB32(const uint16_t* yplane,
+                      const uint16_t* uplane,
+                      const uint16_t* vplane,
+                      uint8_t* rgbframe,
+                      int pic_x,
+                      int pic_y,
+                      int pic_width,
+                      int pic_height,
+                      int ystride,
+                      int uvstride,
+                      int rgbstride,
+                      YUVType yuv_type,
+                      int bit_depth,
+                      YUVColorSpace yuv_color_space,
+                      ColorRange color_range,
+                      RGB32Type rgb32_type);
+
 nsresult
 ConvertYCbCrToRGB32_deprecated(const uint8_t* yplane,
                                const uint8_t* uplane,
@@ -34,12 +34,15 @@ AnimationFrameRetainedBuffer::AnimationFrameRetainedBuffer(size_t aThreshold,
 bool AnimationFrameRetainedBuffer::InsertInternal(RefPtr<imgFrame>&& aFrame) {
   // We should only insert new frames if we actually asked for them.
   MOZ_ASSERT(!mSizeKnown);
-  MOZ_ASSERT(mFrames.Length() < mThreshold);
+  MOZ_ASSERT(mFrames.Length() - mDuplicates < mThreshold);
 
   ++mSize;
+  if (aFrame->IsDuplicate()) {
+    ++mDuplicates;
+  }
   mFrames.AppendElement(std::move(aFrame));
   MOZ_ASSERT(mSize == mFrames.Length());
-  return mSize < mThreshold;
+  return mSize - mDuplicates < mThreshold;
 }
 
 bool AnimationFrameRetainedBuffer::ResetInternal() {
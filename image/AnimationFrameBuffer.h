@@ -382,6 +382,10 @@ class AnimationFrameRetainedBuffer final : public AnimationFrameBuffer {
 
   // The maximum number of frames we can have before discarding.
   size_t mThreshold;
+
+  // The number of frames which share the surface of the frame before them,
+  // see imgFrame::DuplicateIfUnchanged. They don't count towards mThreshold.
+  size_t mDuplicates = 0;
 };
 
 /**
@@ -294,11 +294,12 @@ bool AnimationSurfaceProvider::CheckForNewFrameAtYield() {
   bool justGotFirstFrame = false;
   bool continueDecoding = false;
 
+  // Try to get the new frame from the decoder.
+  RefPtr<imgFrame> frame = DeduplicateFrame(mDecoder->GetCurrentFrame());
+
   {
     MutexAutoLock lock(mFramesMutex);
 
-    // Try to get the new frame from the decoder.
-    RefPtr<imgFrame> frame = mDecoder->GetCurrentFrame();
     MOZ_ASSERT(mDecoder->HasFrameToTake());
     mDecoder->ClearHasFrameToTake();
 
@@ -362,24 +363,22 @@ bool AnimationSurfaceProvider::CheckForNewFrameAtTerminalState() {
   bool justGotFirstFrame = false;
   bool continueDecoding;
 
+  // The decoder may or may not have a new frame for us at this point. If the
+  // decoder didn't finish a new frame (ie if, after starting the frame, it got
+  // an error and aborted the frame and the rest of the decode) that means it
+  // won't be reporting it to the image or FrameAnimator so we should ignore it
+  // too, that's what HasFrameToTake tracks basically.
+  RefPtr<imgFrame> frame;
+  if (mDecoder->HasFrameToTake()) {
+    frame = DeduplicateFrame(mDecoder->GetCurrentFrame());
+    MOZ_ASSERT(frame);
+    mDecoder->ClearHasFrameToTake();
+  }
+
   {
     MutexAutoLock lock(mFramesMutex);
 
-    // The decoder may or may not have a new frame for us at this point. Avoid
-    // reinserting the same frame again.
-    RefPtr<imgFrame> frame = mDecoder->GetCurrentFrame();
-
-    // If the decoder didn't finish a new frame (ie if, after starting the
-    // frame, it got an error and aborted the frame and the rest of the decode)
-    // that means it won't be reporting it to the image or FrameAnimator so we
-    // should ignore it too, that's what HasFrameToTake tracks basically.
-    if (!mDecoder->HasFrameToTake()) {
-      frame = nullptr;
-    } else {
-      MOZ_ASSERT(frame);
-      mDecoder->ClearHasFrameToTake();
-    }
-
+    // Avoid reinserting the same frame again.
     if (!frame || mFrames->IsLastInsertedFrame(frame)) {
       return mFrames->MarkComplete(mDecoder->GetFirstFrameRefreshArea());
     }
@@ -446,6 +445,42 @@ void AnimationSurfaceProvider::RequestFrameDiscarding() {
   }
 }
 
+already_AddRefed<imgFrame> AnimationSurfaceProvider::DeduplicateFrame(
+    imgFrame* aFrame) {
+  mDecodingMutex.AssertCurrentThreadOwns();
+  mFramesMutex.AssertNotCurrentThreadOwns();
+
+  RefPtr<imgFrame> frame = aFrame;
+  if (!frame || !StaticPrefs::image_animated_deduplicate_frames()) {
+    return frame.forget();
+  }
+
+  RefPtr<imgFrame> previousFrame;
+  {
+    MutexAutoLock lock(mFramesMutex);
+
+    // Once we discard frames, we only keep a few batches of them, and we
+    // would rather recycle their buffers.
+    if (mFrames->MayDiscard()) {
+      return frame.forget();
+    }
+
+    const nsTArray<RefPtr<imgFrame>>& frames =
+        static_cast<AnimationFrameRetainedBuffer*>(mFrames.get())->Frames();
+    if (frames.IsEmpty() || frames.LastElement() == frame) {
+      return frame.forget();
+    }
+    previousFrame = frames.LastElement();
+  }
+
+  // Compare the frames without holding mFramesMutex, which the main thread
+  // needs to advance the animation.
+  if (RefPtr<imgFrame> duplicate = frame->DuplicateIfUnchanged(previousFrame)) {
+    return duplicate.forget();
+  }
+  return frame.forget();
+}
+
 void AnimationSurfaceProvider::AnnounceSurfaceAvailable() {
   mFramesMutex.AssertNotCurrentThreadOwns();
   MOZ_ASSERT(mImage);
@@ -103,6 +103,10 @@ class AnimationSurfaceProvider final : public ISurfaceProvider,
   void FinishDecoding();
   void RequestFrameDiscarding();
 
+  // @returns aFrame, or a frame sharing the surface of the last frame we
+  //          inserted if their pixels are the same.
+  already_AddRefed<imgFrame> DeduplicateFrame(imgFrame* aFrame);
+
   // @returns Whether or not we should continue decoding.
   bool CheckForNewFrameAtYield();
 
@@ -29,6 +29,7 @@
 #include "mozilla/StaticMutex.h"
 #include "mozilla/StaticPrefs_image.h"
 #include "mozilla/StaticPtr.h"
+#include "mozilla/TimeStamp.h"
 
 #include "nsExpirationTracker.h"
 #include "nsHashKeys.h"
@@ -173,6 +174,10 @@ class CachedSurface {
   const SurfaceKey& GetSurfaceKey() const { return mProvider->GetSurfaceKey(); }
   nsExpirationState* GetExpirationState() { return &mExpirationState; }
 
+  // When the surface was last used, or unlocked.
+  TimeStamp LastUsed() const { return mLastUsed; }
+  void SetLastUsed(TimeStamp aNow) { mLastUsed = aNow; }
+
   CostEntry GetCostEntry() {
     return image::CostEntry(WrapNotNull(this), mProvider->LogicalSizeInBytes());
   }
@@ -225,6 +230,7 @@ class CachedSurface {
  private:
   nsExpirationState mExpirationState;
   NotNull<RefPtr<ISurfaceProvider>> mProvider;
+  TimeStamp mLastUsed;
   bool mIsLocked;
 };
 
@@ -829,14 +835,7 @@ class SurfaceCacheImpl final : public nsIMemoryReporter {
       return InsertOutcome::FAILURE;
     }
 
-    // Remove elements in order of cost until we can fit this in the cache. Note
-    // that locked surfaces aren't in mCosts, so we never remove them here.
-    while (cost > mAvailableCost) {
-      MOZ_ASSERT(!mCosts.IsEmpty(),
-                 "Removed everything and it still won't fit");
-      Remove(mCosts.LastElement().Surface(), /* aStopTracking */ true,
-             aAutoLock);
-    }
+    FreeCost(cost, aAutoLock);
 
     // Locate the appropriate per-image cache. If there's not an existing cache
     // for this image, create it.
@@ -913,6 +912,35 @@ class SurfaceCacheImpl final : public nsIMemoryReporter {
     MaybeRemoveEmptyCache(imageKey, cache);
   }
 
+  // Removes unlocked surfaces until aCost fits in the cache, in order of cost.
+  // Surfaces which were used recently, like those of images which were just
+  // scrolled out of view and may well be scrolled back in, only go once
+  // there is nothing else left to remove.
+  void FreeCost(const Cost aCost, const StaticMutexAutoLock& aAutoLock) {
+    const TimeDuration recent = TimeDuration::FromMilliseconds(
+        StaticPrefs::image_mem_surfacecache_recently_used_ms());
+    if (aCost > mAvailableCost && recent) {
+      const TimeStamp now = TimeStamp::Now();
+      size_t i = mCosts.Length();
+      while (aCost > mAvailableCost && i > 0) {
+        --i;
+        NotNull<CachedSurface*> surface = mCosts[i].Surface();
+        if (now - surface->LastUsed() >= recent) {
+          // This only removes mCosts[i], so the entries before it stay put.
+          Remove(surface, /* aStopTracking */ true, aAutoLock);
+        }
+      }
+    }
+
+    // Note that locked surfaces aren't in mCosts, so we never remove them here.
+    while (aCost > mAvailableCost) {
+      MOZ_ASSERT(!mCosts.IsEmpty(),
+                 "Removed everything and it still won't fit");
+      Remove(mCosts.LastElement().Surface(), /* aStopTracking */ true,
+             aAutoLock);
+    }
+  }
+
   bool StartTracking(NotNull<CachedSurface*> aSurface,
                      const StaticMutexAutoLock& aAutoLock) {
     CostEntry costEntry = aSurface->GetCostEntry();
@@ -927,6 +955,7 @@ class SurfaceCacheImpl final : public nsIMemoryReporter {
         mTrackingFailureCount++;
         return false;
       }
+      aSurface->SetLastUsed(TimeStamp::Now());
 
       // This may fail during XPCOM shutdown, so we need to ensure the object is
       // tracked before calling RemoveObject in StopTracking.
@@ -1463,6 +1492,7 @@ class SurfaceCacheImpl final : public nsIMemoryReporter {
       StopTracking(aSurface, /* aIsTracked */ false, aAutoLock);
       return false;
     }
+    aSurface->SetLastUsed(TimeStamp::Now());
     return true;
   }
 
@@ -1268,7 +1268,7 @@ class ADAM7InterpolatingFilter final : public SurfaceFilter {
  private:
   static void InterpolateVertically(uint8_t* aPreviousRow, uint8_t* aCurrentRow,
                                     uint8_t aPass, SurfaceFilter& aNext) {
-    const float* weights = InterpolationWeights(ImportantRowStride(aPass));
+    const int32_t stride = ImportantRowStride(aPass);
 
     // We need to interpolate vertically to generate the rows between the
     // previous important row and the next one. Recall that important rows are
@@ -1276,27 +1276,18 @@ class ADAM7InterpolatingFilter final : public SurfaceFilter {
     // InterpolateHorizontally() for some additional explanation as to what that
     // means. Note that we've already written out the previous important row, so
     // we start the iteration at 1.
-    for (int32_t outRow = 1; outRow < ImportantRowStride(aPass); ++outRow) {
-      const float weight = weights[outRow];
-
+    for (int32_t outRow = 1; outRow < stride; ++outRow) {
       // We iterate through the previous and current important row every time we
       // write out an interpolated row, so we need to copy the pointers.
-      uint8_t* prevRowBytes = aPreviousRow;
-      uint8_t* currRowBytes = aCurrentRow;
+      const uint32_t* prevRowPixels =
+          reinterpret_cast<const uint32_t*>(aPreviousRow);
+      const uint32_t* currRowPixels =
+          reinterpret_cast<const uint32_t*>(aCurrentRow);
 
-      // Write out the interpolated pixels. Interpolation is componentwise.
+      // Write out the interpolated pixels.
       aNext.template WritePixelsToRow<uint32_t>([&] {
-        uint32_t pixel = 0;
-        auto* component = reinterpret_cast<uint8_t*>(&pixel);
-        *component++ =
-            InterpolateByte(*prevRowBytes++, *currRowBytes++, weight);
-        *component++ =
-            InterpolateByte(*prevRowBytes++, *currRowBytes++, weight);
-        *component++ =
-            InterpolateByte(*prevRowBytes++, *currRowBytes++, weight);
-        *component++ =
-            InterpolateByte(*prevRowBytes++, *currRowBytes++, weight);
-        return AsVariant(pixel);
+        return AsVariant(InterpolatePixel(*prevRowPixels++, *currRowPixels++,
+                                          outRow, stride));
       });
     }
   }
@@ -1314,7 +1305,6 @@ class ADAM7InterpolatingFilter final : public SurfaceFilter {
     const size_t finalPixelStrideBytes = finalPixelStride * sizeof(uint32_t);
     const size_t lastFinalPixel = LastFinalPixel(aWidth, aPass);
     const size_t lastFinalPixelBytes = lastFinalPixel * sizeof(uint32_t);
-    const float* weights = InterpolationWeights(finalPixelStride);
 
     // Interpolate blocks of pixels which lie between two final pixels.
     // Horizontal interpolation is done in place, as we'll need the results
@@ -1329,20 +1319,22 @@ class ADAM7InterpolatingFilter final : public SurfaceFilter {
       MOZ_ASSERT(finalPixelB < aRow + aWidth * sizeof(uint32_t),
                  "Running off end of buffer");
 
-      // Interpolate the individual pixels componentwise. Note that we start
-      // iteration at 1 since we don't need to apply any interpolation to the
-      // first pixel in the block, which has its final value.
+      // Interpolate the individual pixels. Note that we start iteration at 1
+      // since we don't need to apply any interpolation to the first pixel in
+      // the block, which has its final value.
+      uint32_t pixelA;
+      uint32_t pixelB;
+      memcpy(&pixelA, finalPixelA, sizeof(pixelA));
+      memcpy(&pixelB, finalPixelB, sizeof(pixelB));
       for (size_t pixelIndex = 1; pixelIndex < finalPixelStride; ++pixelIndex) {
-        const float weight = weights[pixelIndex];
         uint8_t* pixel = aRow + blockBytes + pixelIndex * sizeof(uint32_t);
 
         MOZ_ASSERT(pixel < aRow + aWidth * sizeof(uint32_t),
                    "Running off end of buffer");
 
-        for (size_t component = 0; component < sizeof(uint32_t); ++component) {
-          pixel[component] = InterpolateByte(finalPixelA[component],
-                                             finalPixelB[component], weight);
-        }
+        uint32_t interpolated =
+            InterpolatePixel(pixelA, pixelB, pixelIndex, finalPixelStride);
+        memcpy(pixel, &interpolated, sizeof(interpolated));
       }
     }
 
@@ -1357,9 +1349,31 @@ class ADAM7InterpolatingFilter final : public SurfaceFilter {
     }
   }
 
-  static uint8_t InterpolateByte(uint8_t aByteA, uint8_t aByteB,
-                                 float aWeight) {
-    return uint8_t(aByteA * aWeight + aByteB * (1.0f - aWeight));
+  /**
+   * Interpolates each component of the pixels aPixelA and aPixelB, for a
+   * pixel aDistance pixels away from aPixelA and aStride - aDistance pixels
+   * away from aPixelB. The stride is always a power of 2 no larger than 8, so
+   * the weighted sum of each component fits in 16 bits, and dividing it by
+   * the stride is a shift. This lets us interpolate two components at once,
+   * in the alternate bytes of a word, and gives the same (truncated) results
+   * as computing the weights in floating point would.
+   */
+  static uint32_t InterpolatePixel(uint32_t aPixelA, uint32_t aPixelB,
+                                   uint32_t aDistance, uint32_t aStride) {
+    MOZ_ASSERT(aStride <= 8 && (aStride & (aStride - 1)) == 0, "Bad stride");
+    MOZ_ASSERT(0 < aDistance && aDistance < aStride, "Bad distance");
+
+    const uint32_t shift = aStride == 8 ? 3 : aStride == 4 ? 2 : 1;
+    const uint32_t weightA = aStride - aDistance;
+    const uint32_t weightB = aDistance;
+    const uint32_t mask = 0x00ff00ff;
+
+    uint32_t evenBytes =
+        ((aPixelA & mask) * weightA + (aPixelB & mask) * weightB) >> shift;
+    uint32_t oddBytes = (((aPixelA >> 8) & mask) * weightA +
+                         ((aPixelB >> 8) & mask) * weightB) >>
+                        shift;
+    return (evenBytes & mask) | ((oddBytes & mask) << 8);
   }
 
   static int32_t ImportantRowStride(uint8_t aPass) {
@@ -1409,32 +1423,6 @@ class ADAM7InterpolatingFilter final : public SurfaceFilter {
     return lastColumn - (lastColumn & mask);
   }
 
-  static const float* InterpolationWeights(int32_t aStride) {
-    // Precalculated interpolation weights. These are used to interpolate
-    // between final pixels or between important rows. Although no interpolation
-    // is actually applied to the previous final pixel or important row value,
-    // the arrays still start with 1.0f, which is always skipped, primarily
-    // because otherwise |stride1Weights| would have zero elements.
-    static float stride8Weights[] = {1.0f,     7 / 8.0f, 6 / 8.0f, 5 / 8.0f,
-                                     4 / 8.0f, 3 / 8.0f, 2 / 8.0f, 1 / 8.0f};
-    static float stride4Weights[] = {1.0f, 3 / 4.0f, 2 / 4.0f, 1 / 4.0f};
-    static float stride2Weights[] = {1.0f, 1 / 2.0f};
-    static float stride1Weights[] = {1.0f};
-
-    switch (aStride) {
-      case 8:
-        return stride8Weights;
-      case 4:
-        return stride4Weights;
-      case 2:
-        return stride2Weights;
-      case 1:
-        return stride1Weights;
-      default:
-        MOZ_CRASH();
-    }
-  }
-
   Next mNext;  /// The next SurfaceFilter in the chain.
 
   UniquePtr<uint8_t[]>
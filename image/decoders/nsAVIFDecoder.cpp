@@ -11,6 +11,7 @@
 #include <aom/aomdx.h>
 
 #include "DAV1DDecoder.h"
+#include "DecodePool.h"
 #include "gfxPlatform.h"
 #include "YCbCrUtils.h"
 #include "libyuv.h"
@@ -497,6 +498,22 @@ void AVIFDecodedData::SetCicpValues(
   mMatrixCoefficients = mc;
 }
 
+// By default dav1d starts a thread per core for every context, which for the
+// many images decoded at once on the DecodePool threads only adds threads that
+// compete with each other.  Only images large enough for their tiles and rows
+// to be worth splitting get a few threads of their own.
+static int Dav1dThreadCount(const Maybe<OrientedIntSize>& aSize) {
+  constexpr int64_t kPixelsPerThread = 1024 * 1024;
+  const int64_t pixels =
+      aSize ? int64_t(aSize->width) * int64_t(aSize->height) : 0;
+  const int64_t maxThreads =
+      std::max<int64_t>(std::min<int64_t>(
+                            StaticPrefs::image_avif_dav1d_max_threads(),
+                            DecodePool::NumberOfCores()),
+                        1);
+  return int(std::clamp<int64_t>(pixels / kPixelsPerThread, 1, maxThreads));
+}
+
 class Dav1dDecoder final : AVIFDecoderInterface {
  public:
   ~Dav1dDecoder() {
@@ -514,9 +531,9 @@ class Dav1dDecoder final : AVIFDecoderInterface {
   }
 
   static DecodeResult Create(UniquePtr<AVIFDecoderInterface>& aDecoder,
-                             bool aHasAlpha) {
+                             bool aHasAlpha, int aThreadCount) {
     UniquePtr<Dav1dDecoder> d(new Dav1dDecoder());
-    Dav1dResult r = d->Init(aHasAlpha);
+    Dav1dResult r = d->Init(aHasAlpha, aThreadCount);
     if (r == 0) {
       aDecoder.reset(d.release());
     }
@@ -577,7 +594,7 @@ class Dav1dDecoder final : AVIFDecoderInterface {
     MOZ_LOG(sAVIFLog, LogLevel::Verbose, ("Create Dav1dDecoder=%p", this));
   }
 
-  Dav1dResult Init(bool aHasAlpha) {
+  Dav1dResult Init(bool aHasAlpha, int aThreadCount) {
     MOZ_ASSERT(!mColorContext);
     MOZ_ASSERT(!mAlphaContext);
 
@@ -585,6 +602,7 @@ class Dav1dDecoder final : AVIFDecoderInterface {
     dav1d_default_settings(&settings);
     settings.all_layers = 0;
     settings.max_frame_delay = 1;
+    settings.n_threads = aThreadCount;
     // TODO: tune settings a la DAV1DDecoder for AV1 (Bug 1681816)
 
     Dav1dResult r = dav1d_open(&mColorContext, &settings);
@@ -1269,7 +1287,10 @@ Mp4parseStatus nsAVIFDecoder::CreateParser() {
 nsAVIFDecoder::DecodeResult nsAVIFDecoder::CreateDecoder() {
   if (!mDecoder) {
     DecodeResult r = StaticPrefs::image_avif_use_dav1d()
-                         ? Dav1dDecoder::Create(mDecoder, mHasAlpha)
+                         ? Dav1dDecoder::Create(
+                               mDecoder, mHasAlpha,
+                               Dav1dThreadCount(HasSize() ? Some(Size())
+                                                          : Nothing()))
                          : AOMDecoder::Create(mDecoder, mHasAlpha);
 
     MOZ_LOG(sAVIFLog, LogLevel::Debug,
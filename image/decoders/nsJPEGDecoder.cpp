@@ -23,6 +23,7 @@
 
 #include "gfxPlatform.h"
 #include "mozilla/EndianUtils.h"
+#include "mozilla/StaticPrefs_image.h"
 #include "mozilla/gfx/Types.h"
 
 extern "C" {
@@ -390,6 +391,25 @@ LexerTransition<nsJPEGDecoder::State> nsJPEGDecoder::ReadJPEGData(
       mInfo.buffered_image =
           mDecodeStyle == PROGRESSIVE && jpeg_has_multiple_scans(&mInfo);
 
+      // When decoding to a fraction of the intrinsic size, let libjpeg scale
+      // the image down by up to 8x in its IDCT, which skips most of the work
+      // for the pixels the downscaling filter would throw away, and leaves
+      // the filter only the rest of the scaling.
+      if (StaticPrefs::image_jpeg_idct_scaling_enabled()) {
+        const UnorientedIntSize outputSize =
+            GetOrientation().ToUnoriented(OutputSize());
+        for (unsigned int denom = 8; denom > 1; denom /= 2) {
+          if ((mInfo.image_width + denom - 1) / denom >=
+                  uint32_t(outputSize.width) &&
+              (mInfo.image_height + denom - 1) / denom >=
+                  uint32_t(outputSize.height)) {
+            mInfo.scale_num = 1;
+            mInfo.scale_denom = denom;
+            break;
+          }
+        }
+      }
+
       /* Used to set up image size so arrays can be allocated */
       jpeg_calc_output_dimensions(&mInfo);
 
@@ -400,8 +420,10 @@ LexerTransition<nsJPEGDecoder::State> nsJPEGDecoder::ReadJPEGData(
       qcms_transform* pipeTransform =
           mInfo.out_color_space != JCS_GRAYSCALE ? mTransform : nullptr;
 
+      const OrientedIntSize inputSize = GetOrientation().ToOriented(
+          UnorientedIntSize(mInfo.output_width, mInfo.output_height));
       Maybe<SurfacePipe> pipe = SurfacePipeFactory::CreateReorientSurfacePipe(
-          this, Size(), OutputSize(), SurfaceFormat::OS_RGBX,
+          this, inputSize, OutputSize(), SurfaceFormat::OS_RGBX,
           SurfaceFormat::OS_RGBX, pipeTransform, GetOrientation(),
           SurfacePipeFlags());
       if (!pipe) {
@@ -416,7 +438,7 @@ LexerTransition<nsJPEGDecoder::State> nsJPEGDecoder::ReadJPEGData(
       MOZ_LOG(sJPEGDecoderAccountingLog, LogLevel::Debug,
               ("        JPEGDecoderAccounting: nsJPEGDecoder::"
                "Write -- created image frame with %ux%u pixels",
-               mInfo.image_width, mInfo.image_height));
+               mInfo.output_width, mInfo.output_height));
 
       mState = JPEG_START_DECOMPRESS;
       [[fallthrough]];  // to start decompressing.
@@ -428,9 +450,8 @@ LexerTransition<nsJPEGDecoder::State> nsJPEGDecoder::ReadJPEGData(
                 " JPEG_START_DECOMPRESS case");
       // Step 4: set parameters for decompression
 
-      // FIXME -- Should reset dct_method and dither mode
-      // for final pass of progressive JPEG
-
+      // Progressive JPEGs pick the DCT method for each output pass, see
+      // JPEG_DECOMPRESS_PROGRESSIVE.
       mInfo.dct_method = JDCT_ISLOW;
       mInfo.dither_mode = JDITHER_FS;
       mInfo.do_fancy_upsampling = TRUE;
@@ -536,6 +557,12 @@ LexerTransition<nsJPEGDecoder::State> nsJPEGDecoder::ReadJPEGData(
               scan--;
             }
             MOZ_ASSERT(scan > 0, "scan number to small!");
+
+            // The output of intermediate passes is replaced soon, so it isn't
+            // worth the cost of the accurate IDCT. The final pass, which
+            // starts once all of the input has arrived, uses it again.
+            mInfo.dct_method =
+                jpeg_input_complete(&mInfo) ? JDCT_ISLOW : JDCT_IFAST;
             if (!jpeg_start_output(&mInfo, scan)) {
               MOZ_LOG(sJPEGDecoderAccountingLog, LogLevel::Debug,
                       ("} (I/O suspension after jpeg_start_output() -"
@@ -573,8 +600,11 @@ LexerTransition<nsJPEGDecoder::State> nsJPEGDecoder::ReadJPEGData(
                     State::JPEG_DATA);  // I/O suspension
               }
 
+              // If the last scan arrived during a fast pass, output it once
+              // more with the accurate IDCT.
               if (jpeg_input_complete(&mInfo) &&
-                  (mInfo.input_scan_number == mInfo.output_scan_number)) {
+                  (mInfo.input_scan_number == mInfo.output_scan_number) &&
+                  mInfo.dct_method == JDCT_ISLOW) {
                 mState = JPEG_DONE;
               } else {
                 mInfo.output_scanline = 0;
@@ -997,9 +1027,16 @@ static void cmyk_convert_bgra(uint32_t* aInput, uint32_t* aOutput,
       iK = 255 - iK;
     }
 
-    const uint8_t r = iC * iK / 255;
-    const uint8_t g = iM * iK / 255;
-    const uint8_t b = iY * iK / 255;
+    // The products fit in 16 bits, so we compute R and B together in the two
+    // halves of a word. For such products t, (t + (t >> 8) + 1) >> 8 is
+    // exactly t / 255, and it doesn't carry from one half into the other.
+    uint32_t rb = (iC | (iY << 16)) * iK;
+    rb = ((rb + ((rb >> 8) & 0x00FF00FF) + 0x00010001) >> 8) & 0x00FF00FF;
+    uint32_t gk = iM * iK;
+
+    const uint8_t r = rb & 0xFF;
+    const uint8_t g = (gk + (gk >> 8) + 1) >> 8;
+    const uint8_t b = rb >> 16;
 
     *aOutput++ = (0xFF << mozilla::gfx::SurfaceFormatBit::OS_A) |
                  (r << mozilla::gfx::SurfaceFormatBit::OS_R) |
@@ -132,7 +132,8 @@ imgFrame::imgFrame()
       mDisposalMethod(DisposalMethod::NOT_SPECIFIED),
       mBlendMethod(BlendMethod::OVER),
       mFormat(SurfaceFormat::UNKNOWN),
-      mNonPremult(false) {}
+      mNonPremult(false),
+      mIsDuplicate(false) {}
 
 imgFrame::~imgFrame() {
 #ifdef DEBUG
@@ -599,6 +600,71 @@ uint32_t imgFrame::GetImageDataLength() const {
   return GetImageBytesPerRow() * mImageSize.height;
 }
 
+already_AddRefed<imgFrame> imgFrame::DuplicateIfUnchanged(imgFrame* aPrevious) {
+  MOZ_ASSERT(aPrevious);
+  MOZ_ASSERT(aPrevious != this);
+
+  if (mImageSize != aPrevious->mImageSize || mFormat != aPrevious->mFormat ||
+      mNonPremult != aPrevious->mNonPremult) {
+    return nullptr;
+  }
+
+  // The dirty rect covers every pixel which may differ from the previous
+  // frame, so that is all we need to compare.
+  IntRect dirtyRect = mDirtyRect.Intersect(GetRect());
+  if (!dirtyRect.IsEmpty()) {
+    RawAccessFrameRef ref = RawAccessRef();
+    RawAccessFrameRef previousRef = aPrevious->RawAccessRef();
+    if (!ref || !previousRef) {
+      return nullptr;
+    }
+
+    const size_t bpp = BytesPerPixel(mFormat);
+    const size_t stride = size_t(mImageSize.width) * bpp;
+    const size_t length = size_t(dirtyRect.width) * bpp;
+    for (int32_t y = dirtyRect.y; y < dirtyRect.YMost(); ++y) {
+      const size_t offset = size_t(y) * stride + size_t(dirtyRect.x) * bpp;
+      if (memcmp(ref.Data() + offset, previousRef.Data() + offset, length)) {
+        return nullptr;
+      }
+    }
+  }
+
+  {
+    MonitorAutoLock lock(mMonitor);
+    if (!mFinished || mAborted) {
+      return nullptr;
+    }
+  }
+
+  MonitorAutoLock previousLock(aPrevious->mMonitor);
+  if (!aPrevious->mFinished || aPrevious->mAborted ||
+      !aPrevious->mRawSurface || aPrevious->mOptSurface) {
+    return nullptr;
+  }
+
+  RefPtr<imgFrame> frame = new imgFrame();
+  frame->mImageSize = mImageSize;
+  frame->mBlendRect = mBlendRect;
+  frame->mDirtyRect = mDirtyRect;
+  frame->mTimeout = mTimeout;
+  frame->mDisposalMethod = mDisposalMethod;
+  frame->mBlendMethod = mBlendMethod;
+  frame->mFormat = mFormat;
+  frame->mNonPremult = mNonPremult;
+  frame->mIsDuplicate = true;
+
+  // Recycling either frame would overwrite the pixels of the other one.
+  aPrevious->mShouldRecycle = false;
+
+  MonitorAutoLock lock(frame->mMonitor);
+  frame->mRawSurface = aPrevious->mRawSurface;
+  frame->mBlankRawSurface = aPrevious->mBlankRawSurface;
+  frame->mDecoded = frame->GetRect();
+  frame->mFinished = true;
+  return frame.forget();
+}
+
 void imgFrame::FinalizeSurface() {
   MonitorAutoLock lock(mMonitor);
   FinalizeSurfaceInternal();
@@ -697,7 +763,8 @@ void imgFrame::AddSizeOfExcludingThis(MallocSizeOf aMallocSizeOf,
     mOptSurface->SizeOfExcludingThis(aMallocSizeOf, info);
     metadata.Accumulate(info);
   }
-  if (mRawSurface) {
+  // Duplicates leave their surface to the frame they share it with.
+  if (mRawSurface && !mIsDuplicate) {
     metadata.mHeapBytes += aMallocSizeOf(mRawSurface);
 
     SourceSurface::SizeOfInfo info;
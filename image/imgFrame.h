@@ -167,6 +167,23 @@ class imgFrame {
   const IntRect& GetDirtyRect() const { return mDirtyRect; }
   void SetDirtyRect(const IntRect& aDirtyRect) { mDirtyRect = aDirtyRect; }
 
+  /**
+   * Compares this finished animation frame with aPrevious, the frame before
+   * it. If their pixels are the same, returns a new finished frame with the
+   * animation parameters of this one which shares the surface of aPrevious,
+   * and which neither of them may be recycled into. Otherwise returns null.
+   *
+   * Animations often repeat a frame to hold still for a while, and sharing
+   * the surfaces lets us keep more of their frames buffered.
+   */
+  already_AddRefed<imgFrame> DuplicateIfUnchanged(imgFrame* aPrevious);
+
+  /**
+   * Returns true if this frame was created by DuplicateIfUnchanged(), and
+   * thus shares the surface of the frame before it.
+   */
+  bool IsDuplicate() const { return mIsDuplicate; }
+
   void FinalizeSurface();
   already_AddRefed<SourceSurface> GetSourceSurface();
 
@@ -270,6 +287,9 @@ class imgFrame {
   SurfaceFormat mFormat;
 
   bool mNonPremult;
+
+  //! Whether mRawSurface belongs to the frame before us.
+  bool mIsDuplicate;
 };
 
 /**
@@ -241,6 +241,46 @@ TEST_F(ImageAnimationFrameBuffer, BatchTooBig) {
   EXPECT_EQ(size_t(0), buffer.PendingAdvance());
 }
 
+TEST_F(ImageAnimationFrameBuffer, RetainedDuplicateFrames) {
+  const size_t kThreshold = 3;
+  const size_t kBatch = 1;
+  AnimationFrameRetainedBuffer buffer(kThreshold, kBatch, 0);
+
+  RefPtr<imgFrame> firstFrame = CreateEmptyFrame();
+  AnimationFrameBuffer::InsertStatus status =
+      buffer.Insert(RefPtr<imgFrame>(firstFrame));
+  EXPECT_EQ(AnimationFrameBuffer::InsertStatus::CONTINUE, status);
+
+  // Empty frames have the same pixels, so the second frame can share the
+  // surface of the first one.
+  RefPtr<imgFrame> frame = CreateEmptyFrame();
+  RefPtr<imgFrame> duplicate = frame->DuplicateIfUnchanged(firstFrame);
+  ASSERT_TRUE(duplicate);
+  EXPECT_TRUE(duplicate->IsDuplicate());
+  EXPECT_FALSE(frame->IsDuplicate());
+  EXPECT_TRUE(duplicate->IsFinished());
+  EXPECT_EQ(frame->GetTimeout(), duplicate->GetTimeout());
+  EXPECT_EQ(frame->GetDirtyRect(), duplicate->GetDirtyRect());
+
+  // The shared surface must not be recycled.
+  RawAccessFrameRef firstFrameRef =
+      firstFrame->RawAccessRef(gfx::DataSourceSurface::READ_WRITE);
+  EXPECT_FALSE(ReinitForRecycle(firstFrameRef));
+  firstFrameRef.reset();
+
+  status = buffer.Insert(std::move(duplicate));
+  EXPECT_EQ(AnimationFrameBuffer::InsertStatus::YIELD, status);
+
+  // Advancing asks for another frame.
+  EXPECT_TRUE(buffer.AdvanceTo(1));
+
+  // The duplicate doesn't count towards the threshold, so we don't need to
+  // start discarding frames yet.
+  status = buffer.Insert(CreateEmptyFrame());
+  EXPECT_EQ(AnimationFrameBuffer::InsertStatus::YIELD, status);
+  EXPECT_EQ(size_t(3), buffer.Size());
+}
+
 TEST_F(ImageAnimationFrameBuffer, FinishUnderBatchAndThreshold) {
   const size_t kThreshold = 30;
   const size_t kBatch = 10;
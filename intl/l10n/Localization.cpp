@@ -22,6 +22,16 @@ using namespace mozilla::intl;
 
 static const char* kObservedPrefs[] = {L10N_PSEUDO_PREF, nullptr};
 
+// Returns the id of aKey if it has no arguments.
+static const nsCString* GetIdWithoutArgs(
+    const OwningUTF8StringOrL10nIdArgs& aKey) {
+  if (aKey.IsUTF8String()) {
+    return &aKey.GetAsUTF8String();
+  }
+  const auto& e = aKey.GetAsL10nIdArgs();
+  return e.mArgs.IsNull() ? &e.mId : nullptr;
+}
+
 static nsTArray<ffi::L10nKey> ConvertFromL10nKeys(
     const Sequence<OwningUTF8StringOrL10nIdArgs>& aKeys) {
   nsTArray<ffi::L10nKey> l10nKeys(aKeys.Length());
@@ -238,9 +248,13 @@ void Localization::RegisterObservers() {
   }
 }
 
-void Localization::OnChange() { ffi::localization_on_change(mRaw.get()); }
+void Localization::OnChange() {
+  mFormattedValues.Clear();
+  ffi::localization_on_change(mRaw.get());
+}
 
 void Localization::AddResourceId(const ffi::GeckoResourceId& aResourceId) {
+  mFormattedValues.Clear();
   ffi::localization_add_res_id(mRaw.get(), &aResourceId);
 }
 void Localization::AddResourceId(const nsCString& aResourceId) {
@@ -255,6 +269,7 @@ void Localization::AddResourceId(
 
 uint32_t Localization::RemoveResourceId(
     const ffi::GeckoResourceId& aResourceId) {
+  mFormattedValues.Clear();
   return ffi::localization_remove_res_id(mRaw.get(), &aResourceId);
 }
 uint32_t Localization::RemoveResourceId(const nsCString& aResourceId) {
@@ -269,12 +284,14 @@ uint32_t Localization::RemoveResourceId(
 
 void Localization::AddResourceIds(
     const nsTArray<dom::OwningUTF8StringOrResourceId>& aResourceIds) {
+  mFormattedValues.Clear();
   auto ffiResourceIds{L10nRegistry::ResourceIdsToFFI(aResourceIds)};
   ffi::localization_add_res_ids(mRaw.get(), &ffiResourceIds);
 }
 
 uint32_t Localization::RemoveResourceIds(
     const nsTArray<dom::OwningUTF8StringOrResourceId>& aResourceIds) {
+  mFormattedValues.Clear();
   auto ffiResourceIds{L10nRegistry::ResourceIdsToFFI(aResourceIds)};
   return ffi::localization_remove_res_ids(mRaw.get(), &ffiResourceIds);
 }
@@ -381,12 +398,19 @@ void Localization::FormatValueSync(const nsACString& aId,
   if (aArgs.WasPassed()) {
     const L10nArgs& args = aArgs.Value();
     FluentBundle::ConvertArgs(args, l10nArgs);
+  } else if (const nsCString* value =
+                 mFormattedValues.Lookup(aId).DataPtrOrNull()) {
+    aRetVal = *value;
+    return;
   }
 
   bool rv = ffi::localization_format_value_sync(mRaw.get(), &aId, &l10nArgs,
                                                 &aRetVal, &errors);
 
   if (rv) {
+    if (!aArgs.WasPassed() && errors.IsEmpty()) {
+      mFormattedValues.InsertOrUpdate(aId, aRetVal);
+    }
     MaybeReportErrorsToGecko(errors, aRv, GetParentObject());
   } else {
     aRv.ThrowInvalidStateError(
@@ -397,6 +421,21 @@ void Localization::FormatValueSync(const nsACString& aId,
 void Localization::FormatValuesSync(
     const Sequence<OwningUTF8StringOrL10nIdArgs>& aKeys,
     nsTArray<nsCString>& aRetVal, ErrorResult& aRv) {
+  nsTArray<nsCString> cachedValues(aKeys.Length());
+  for (const auto& entry : aKeys) {
+    const nsCString* id = GetIdWithoutArgs(entry);
+    const nsCString* value =
+        id ? mFormattedValues.Lookup(*id).DataPtrOrNull() : nullptr;
+    if (!value) {
+      break;
+    }
+    cachedValues.AppendElement(*value);
+  }
+  if (cachedValues.Length() == aKeys.Length()) {
+    aRetVal = std::move(cachedValues);
+    return;
+  }
+
   nsTArray<ffi::L10nKey> l10nKeys(aKeys.Length());
   nsTArray<nsCString> errors;
 
@@ -421,6 +460,13 @@ void Localization::FormatValuesSync(
                                                  &aRetVal, &errors);
 
   if (rv) {
+    if (errors.IsEmpty() && aRetVal.Length() == aKeys.Length()) {
+      for (size_t i = 0; i < aKeys.Length(); i++) {
+        if (const nsCString* id = GetIdWithoutArgs(aKeys[i])) {
+          mFormattedValues.InsertOrUpdate(*id, aRetVal[i]);
+        }
+      }
+    }
     MaybeReportErrorsToGecko(errors, aRv, GetParentObject());
   } else {
     aRv.ThrowInvalidStateError(
@@ -469,7 +515,11 @@ void Localization::FormatMessagesSync(
   }
 }
 
-void Localization::SetAsync() { ffi::localization_set_async(mRaw.get()); }
+void Localization::SetAsync() {
+  // The sync methods must throw from now on.
+  mFormattedValues.Clear();
+  ffi::localization_set_async(mRaw.get());
+}
 bool Localization::IsSync() { return ffi::localization_is_sync(mRaw.get()); }
 
 /**
@@ -15,6 +15,7 @@
 #include "nsIScriptError.h"
 #include "nsContentUtils.h"
 #include "nsPIDOMWindow.h"
+#include "nsTHashMap.h"
 #include "mozilla/ErrorResult.h"
 #include "mozilla/dom/Promise.h"
 #include "mozilla/dom/BindingDeclarations.h"
@@ -164,6 +165,12 @@ class Localization : public nsIObserver,
 
   nsCOMPtr<nsIGlobalObject> mGlobal;
   RefPtr<const ffi::LocalizationRc> mRaw;
+
+  // The values of the messages that formatValueSync and formatValuesSync
+  // formatted without arguments or errors, by id.  They only change with the
+  // resources or the locales of this localization, and chrome code formats
+  // the same strings over and over.
+  nsTHashMap<nsCStringHashKey, nsCString> mFormattedValues;
 };
 
 }  // namespace intl
@@ -620,6 +620,44 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
     MOZ_ASSERT(amt_to_write > 0);
 
     const bool intentional_short_write = !iter.Done();
+
+    // If all of the first message fits, fill the remaining iovecs with whole
+    // messages queued after it, so that a backlog of small messages (e.g.
+    // after the pipe was full) is written with one sendmsg() rather than one
+    // each, and read with fewer wakeups on the other side.  Messages with
+    // attachments start a new sendmsg(), as their handles have to be sent
+    // along with their first byte.
+    const size_t first_amt_to_write = amt_to_write;
+    if (!intentional_short_write && num_fds == handles.Length()) {
+      for (size_t i = 1; i < output_queue_.Count(); ++i) {
+        Message* next = output_queue_.ElementAt(i).get();
+#if defined(XP_DARWIN)
+        if (next->num_send_rights()) {
+          break;
+        }
+#endif
+        if (!next->attached_handles_.IsEmpty() ||
+            !PipeBufHasSpaceAfter(amt_to_write + next->CurrentSize())) {
+          break;
+        }
+
+        size_t next_iov_count = iov_count;
+        Pickle::BufferList::IterImpl next_iter(next->Buffers());
+        while (!next_iter.Done() && next_iov_count < kMaxIOVecSize) {
+          iov[next_iov_count].iov_base = next_iter.Data();
+          iov[next_iov_count].iov_len = next_iter.RemainingInSegment();
+          next_iov_count++;
+          next_iter.Advance(next->Buffers(), next_iter.RemainingInSegment());
+        }
+        if (!next_iter.Done()) {
+          break;
+        }
+        next->header()->num_handles = 0;
+        iov_count = next_iov_count;
+        amt_to_write += next->CurrentSize();
+      }
+    }
+
     msgh.msg_iov = iov;
     msgh.msg_iovlen = iov_count;
 
@@ -667,13 +705,13 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
       }
     }
 
-    if (intentional_short_write ||
-        static_cast<size_t>(bytes_written) != amt_to_write) {
+    if (intentional_short_write || bytes_written < 0 ||
+        static_cast<size_t>(bytes_written) < first_amt_to_write) {
       // If write() fails with EAGAIN or EMSGSIZE then bytes_written will be -1.
       if (bytes_written > 0) {
         MOZ_DIAGNOSTIC_ASSERT(intentional_short_write ||
                               static_cast<size_t>(bytes_written) <
-                                  amt_to_write);
+                                  first_amt_to_write);
         partial_write_->iter_.AdvanceAcrossSegments(msg->Buffers(),
                                                     bytes_written);
         partial_write_->handles_ = handles.From(num_fds);
@@ -681,56 +719,87 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
         MOZ_DIAGNOSTIC_ASSERT(!partial_write_->iter_.Done());
       }
 
-      is_blocked_on_write_ = true;
-      if (IOThread().IsOnCurrentThread()) {
-        // If we're on the I/O thread already, tell libevent to call us back
-        // when things are unblocked.
-        MessageLoopForIO::current()->WatchFileDescriptor(
-            pipe_,
-            false,  // One shot
-            MessageLoopForIO::WATCH_WRITE, &write_watcher_, this);
-      } else {
-        // Otherwise, emulate being called back from libevent on the I/O thread,
-        // which will re-try the write, and then potentially start watching if
-        // still necessary.
-        IOThread().Dispatch(mozilla::NewRunnableMethod<int>(
-            "ChannelImpl::ContinueProcessOutgoing", this,
-            &ChannelImpl::OnFileCanWriteWithoutBlocking, -1));
-      }
+      WaitUntilWritable();
       return true;
-    } else {
-      MOZ_ASSERT(partial_write_->handles_.Length() == num_fds,
-                 "not all handles were sent");
-      partial_write_.reset();
+    }
+
+    MOZ_ASSERT(partial_write_->handles_.Length() == num_fds,
+               "not all handles were sent");
+    partial_write_.reset();
 
 #if defined(XP_DARWIN)
-      if (!msg->attached_handles_.IsEmpty()) {
-        pending_fds_.push_back(PendingDescriptors{
-            msg->fd_cookie(), std::move(msg->attached_handles_)});
-      }
+    if (!msg->attached_handles_.IsEmpty()) {
+      pending_fds_.push_back(PendingDescriptors{
+          msg->fd_cookie(), std::move(msg->attached_handles_)});
+    }
 #else
-      if (bytes_written > 0) {
-        msg->attached_handles_.Clear();
-      }
+    if (bytes_written > 0) {
+      msg->attached_handles_.Clear();
+    }
 #endif
 
-      // Message sent OK!
+    // Message sent OK!
 
-      AddIPCProfilerMarker(*msg, other_pid_, MessageDirection::eSending,
-                           MessagePhase::TransferEnd);
+    AddIPCProfilerMarker(*msg, other_pid_, MessageDirection::eSending,
+                         MessagePhase::TransferEnd);
 
 #ifdef IPC_MESSAGE_DEBUG_EXTRA
-      DLOG(INFO) << "sent message @" << msg << " on channel @" << this
-                 << " with type " << msg->type();
+    DLOG(INFO) << "sent message @" << msg << " on channel @" << this
+               << " with type " << msg->type();
 #endif
+    OutputQueuePop();
+    // msg has been destroyed, so clear the dangling reference.
+    msg = nullptr;
+
+    // Now account for the messages written along with the first one.
+    size_t coalesced_written =
+        static_cast<size_t>(bytes_written) - first_amt_to_write;
+    while (coalesced_written > 0) {
+      Message* next = output_queue_.FirstElement().get();
+      AddIPCProfilerMarker(*next, other_pid_, MessageDirection::eSending,
+                           MessagePhase::TransferStart);
+      if (coalesced_written < next->CurrentSize()) {
+        Pickle::BufferList::IterImpl next_iter(next->Buffers());
+        next_iter.AdvanceAcrossSegments(next->Buffers(), coalesced_written);
+        partial_write_.emplace(
+            PartialWrite{next_iter, next->attached_handles_});
+        break;
+      }
+      coalesced_written -= next->CurrentSize();
+      AddIPCProfilerMarker(*next, other_pid_, MessageDirection::eSending,
+                           MessagePhase::TransferEnd);
       OutputQueuePop();
-      // msg has been destroyed, so clear the dangling reference.
-      msg = nullptr;
+    }
+
+    if (static_cast<size_t>(bytes_written) != amt_to_write) {
+      WaitUntilWritable();
+      return true;
     }
   }
   return true;
 }
 
+void Channel::ChannelImpl::WaitUntilWritable() {
+  chan_cap_.NoteLockHeld();
+
+  is_blocked_on_write_ = true;
+  if (IOThread().IsOnCurrentThread()) {
+    // If we're on the I/O thread already, tell libevent to call us back
+    // when things are unblocked.
+    MessageLoopForIO::current()->WatchFileDescriptor(
+        pipe_,
+        false,  // One shot
+        MessageLoopForIO::WATCH_WRITE, &write_watcher_, this);
+  } else {
+    // Otherwise, emulate being called back from libevent on the I/O thread,
+    // which will re-try the write, and then potentially start watching if
+    // still necessary.
+    IOThread().Dispatch(mozilla::NewRunnableMethod<int>(
+        "ChannelImpl::ContinueProcessOutgoing", this,
+        &ChannelImpl::OnFileCanWriteWithoutBlocking, -1));
+  }
+}
+
 bool Channel::ChannelImpl::Send(mozilla::UniquePtr<Message> message) {
   // NOTE: This method may be called on threads other than `IOThread()`.
   mozilla::MutexAutoLock lock(SendMutex());
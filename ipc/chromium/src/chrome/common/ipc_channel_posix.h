@@ -74,6 +74,8 @@ class Channel::ChannelImpl : public MessageLoopForIO::Watcher {
 
   bool ProcessIncomingMessages() MOZ_REQUIRES(IOThread());
   bool ProcessOutgoingMessages() MOZ_REQUIRES(SendMutex());
+  // Retries ProcessOutgoingMessages() once the pipe has room again.
+  void WaitUntilWritable() MOZ_REQUIRES(SendMutex());
 
   // MessageLoopForIO::Watcher implementation.
   virtual void OnFileCanReadWithoutBlocking(int fd) override;
@@ -5,6 +5,9 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "DataPipe.h"
+
+#include <utility>
+
 #include "mozilla/AlreadyAddRefed.h"
 #include "mozilla/Assertions.h"
 #include "mozilla/CheckedInt.h"
@@ -176,6 +179,8 @@ class DataPipeLink : public NodeController::PortObserver {
   nsresult mPeerStatus MOZ_GUARDED_BY(*mMutex) = NS_OK;
   uint32_t mOffset MOZ_GUARDED_BY(*mMutex) = 0;
   uint32_t mAvailable MOZ_GUARDED_BY(*mMutex) = 0;
+  // Bytes we have processed, but not yet sent a CONSUMED message for.
+  uint32_t mUnreported MOZ_GUARDED_BY(*mMutex) = 0;
 
   bool mCallbackClosureOnly MOZ_GUARDED_BY(*mMutex) = false;
   nsCOMPtr<nsIRunnable> mCallback MOZ_GUARDED_BY(*mMutex);
@@ -329,6 +334,7 @@ nsresult DataPipeBase::ProcessSegmentsInternal(
     // the shmem mapped and make sure we can clean up even if we're closed while
     // processing the shmem region.
     link->mProcessingSegment = true;
+    bool stopped = false;
     auto scopeExit = MakeScopeExit([&] {
       mMutex->AssertCurrentThreadOwns();  // should still be held
       AssertSameMutex(link->mMutex);
@@ -343,7 +349,18 @@ nsresult DataPipeBase::ProcessSegmentsInternal(
           link->mOffset = 0;
         }
         link->mAvailable -= totalProcessed;
-        link->SendBytesConsumedOnUnlock(lock, totalProcessed);
+        link->mUnreported += totalProcessed;
+      }
+      // Writers report every segment, so that the reader sees the data right
+      // away.  Readers report their reads in batches of a quarter of the pipe,
+      // so that draining a full pipe doesn't take a CONSUMED message (and a
+      // wakeup of the writer) per read, but no longer once they have read
+      // everything or stopped reading, as the writer may be waiting for room.
+      if (link->mUnreported &&
+          (!link->mReceiverSide || !link->mAvailable || stopped ||
+           link->mUnreported >= link->mCapacity / 4)) {
+        link->SendBytesConsumedOnUnlock(lock,
+                                        std::exchange(link->mUnreported, 0));
       }
       MOZ_LOG(gDataPipeLog, LogLevel::Verbose,
               ("Processed Segment(%u of %zu) %s", totalProcessed, end - start,
@@ -357,6 +374,7 @@ nsresult DataPipeBase::ProcessSegmentsInternal(
         Span segment{iter, end};
         nsresult rv = aProcessSegment(segment, *aProcessedCount, &processed);
         if (NS_FAILED(rv) || processed == 0) {
+          stopped = true;
           return NS_OK;
         }
 
@@ -456,6 +474,7 @@ void DataPipeWrite(IPC::MessageWriter* aWriter, T* aParam) {
   WriteParam(aWriter, aParam->mLink->mPeerStatus);
   WriteParam(aWriter, aParam->mLink->mOffset);
   WriteParam(aWriter, aParam->mLink->mAvailable);
+  WriteParam(aWriter, aParam->mLink->mUnreported);
 
   // Mark our peer as closed so we don't try to send to it when closing.
   aParam->mLink->mPeerStatus = NS_ERROR_NOT_INITIALIZED;
@@ -496,12 +515,15 @@ bool DataPipeRead(IPC::MessageReader* aReader, RefPtr<T>* aResult) {
   nsresult peerStatus = NS_OK;
   uint32_t offset = 0;
   uint32_t available = 0;
+  uint32_t unreported = 0;
   if (!ReadParam(aReader, &capacity) || !ReadParam(aReader, &peerStatus) ||
-      !ReadParam(aReader, &offset) || !ReadParam(aReader, &available)) {
+      !ReadParam(aReader, &offset) || !ReadParam(aReader, &available) ||
+      !ReadParam(aReader, &unreported)) {
     aReader->FatalError("failed to read DataPipe fields");
     return false;
   }
-  if (!capacity || offset >= capacity || available > capacity) {
+  if (!capacity || offset >= capacity || available > capacity ||
+      unreported > capacity - available) {
     aReader->FatalError("received DataPipe state values are inconsistent");
     return false;
   }
@@ -514,10 +536,14 @@ bool DataPipeRead(IPC::MessageReader* aReader, RefPtr<T>* aResult) {
 
   *aResult = new T(std::move(port), std::move(shmemHandle), mapping, capacity,
                    peerStatus, offset, available);
-  if (MOZ_LOG_TEST(gDataPipeLog, LogLevel::Debug)) {
+  if (unreported || MOZ_LOG_TEST(gDataPipeLog, LogLevel::Debug)) {
     DataPipeAutoLock lock(*(*aResult)->mMutex);
     MOZ_LOG(gDataPipeLog, LogLevel::Debug,
             ("IPC Read: %s", (*aResult)->Describe(lock).get()));
+    // Report what the reader we replace processed, which it had held back.
+    if (unreported && (*aResult)->mLink) {
+      (*aResult)->mLink->SendBytesConsumedOnUnlock(lock, unreported);
+    }
   }
   return true;
 }
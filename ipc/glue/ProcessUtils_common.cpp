@@ -44,28 +44,10 @@ bool SharedPreferenceSerializer::SerializeToSharedMemory(
       (StringBeginsWith(aDestinationRemoteType, WEB_REMOTE_TYPE) ||
        StringBeginsWith(aDestinationRemoteType, PREALLOC_REMOTE_TYPE));
 
-  // Serialize the early prefs.
-  nsAutoCStringN<1024> prefs;
-  Preferences::SerializePreferences(prefs, destIsWebContent);
-  auto prefsLength = prefs.Length();
-
-  // Set up the shared memory.
-  auto handle = shared_memory::Create(prefsLength);
-  if (!handle) {
-    NS_ERROR("failed to create shared memory in the parent");
-    return false;
-  }
-  auto mapping = handle.Map();
-  if (!mapping) {
-    NS_ERROR("failed to map shared memory in the parent");
-    return false;
-  }
-
-  // Copy the serialized prefs into the shared memory.
-  memcpy(mapping.DataAs<char>(), prefs.get(), prefsLength);
-
-  mPrefsHandle = std::move(handle).ToReadOnly();
-  return true;
+  // The early prefs, which are shared with other child processes until a pref
+  // changes.
+  mPrefsHandle = Preferences::EnsureSerializedPreferences(destIsWebContent);
+  return !!mPrefsHandle;
 }
 
 void SharedPreferenceSerializer::AddSharedPrefCmdLineArgs(
@@ -51,7 +51,13 @@ bool ParamTraits<JSStructuredCloneData>::Read(MessageReader* aReader,
   // can be revisited in the future if it turns out to be a noticable
   // performance regression. (bug 1783242)
 
+  // Read the data into a single buffer, so that large typed arrays are copied
+  // out of it at once when they're deserialized.
   mozilla::BufferList<js::SystemAllocPolicy> buffers(0, 0, 4096);
+  if (length && !buffers.Init(0, length)) {
+    NS_ABORT_OOM(length);
+    return false;
+  }
   MessageBufferReader bufReader(aReader, length);
   uint32_t read = 0;
   while (read < length) {
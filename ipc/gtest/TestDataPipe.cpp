@@ -188,6 +188,47 @@ TEST(DataPipe, SegmentedPartialRead)
   ASSERT_TRUE(Substring(inputData2, 768).Equals(outputData2));
 }
 
+TEST(DataPipe, BatchedConsumedReports)
+{
+  RefPtr<DataPipeReceiver> reader;
+  RefPtr<DataPipeSender> writer;
+
+  nsresult rv =
+      NewDataPipe(1024, getter_AddRefs(writer), getter_AddRefs(reader));
+  ASSERT_NS_SUCCEEDED(rv);
+
+  nsCString inputData;
+  CreateData(1024, inputData);
+
+  uint32_t numWritten = 0;
+  rv = writer->Write(inputData.BeginReading(), inputData.Length(),
+                     &numWritten);
+  ASSERT_NS_SUCCEEDED(rv);
+  EXPECT_EQ(numWritten, 1024u);
+
+  // The reader holds back reports of small reads while it has data left.
+  nsAutoCString outputData;
+  rv = NS_ReadInputStreamToString(reader, outputData, 100);
+  ASSERT_NS_SUCCEEDED(rv);
+  ASSERT_TRUE(Substring(inputData, 0, 100).Equals(outputData));
+
+  rv = writer->Write(inputData.BeginReading(), inputData.Length(),
+                     &numWritten);
+  ASSERT_EQ(NS_BASE_STREAM_WOULD_BLOCK, rv);
+
+  // Once it has read everything, the writer gets all of the room back.
+  nsAutoCString outputData2;
+  rv = NS_ReadInputStreamToString(reader, outputData2, 924);
+  ASSERT_NS_SUCCEEDED(rv);
+  ASSERT_TRUE(Substring(inputData, 100).Equals(outputData2));
+
+  rv = writer->Write(inputData.BeginReading(), inputData.Length(),
+                     &numWritten);
+  ASSERT_NS_SUCCEEDED(rv);
+  EXPECT_EQ(numWritten, 1024u);
+  ConsumeAndValidateStream(reader, inputData);
+}
+
 TEST(DataPipe, Write_AsyncWait)
 {
   RefPtr<DataPipeReceiver> reader;
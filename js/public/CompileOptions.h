@@ -103,6 +103,13 @@ enum class AsmJSOption : uint8_t {
    */                                                                          \
   _(ConcurrentLargeFirst)                                                      \
                                                                                \
+  /*                                                                           \
+   * Split the script at its top-level function boundaries, and delazify each  \
+   * part depth first on its own helper thread, such that the full parse of a  \
+   * large script is spread over multiple cores.                               \
+   */                                                                          \
+  _(ConcurrentParallel)                                                        \
+                                                                               \
   /*                                                                           \
    * Parse everything eagerly, from the first parse.                           \
    *                                                                           \
@@ -376,13 +383,15 @@ class JS_PUBLIC_API TransitiveCompileOptions {
   bool consumeDelazificationCache() const {
     return eagerDelazificationIsOneOf<
         DelazificationOption::ConcurrentDepthFirst,
-        DelazificationOption::ConcurrentLargeFirst>();
+        DelazificationOption::ConcurrentLargeFirst,
+        DelazificationOption::ConcurrentParallel>();
   }
   bool populateDelazificationCache() const {
     return eagerDelazificationIsOneOf<
         DelazificationOption::CheckConcurrentWithOnDemand,
         DelazificationOption::ConcurrentDepthFirst,
-        DelazificationOption::ConcurrentLargeFirst>();
+        DelazificationOption::ConcurrentLargeFirst,
+        DelazificationOption::ConcurrentParallel>();
   }
   bool waitForDelazificationCache() const {
     return eagerDelazificationIsOneOf<
@@ -823,6 +832,16 @@ class JS_PUBLIC_API ReadOnlyDecodeOptions {
   bool borrowBuffer = false;
   bool usePinnedBytecode = false;
 
+  // Only decode the initial stencil up front, and decode each delazification
+  // stored in the XDR buffer from the buffer the first time the function is
+  // delazified, instead of decoding and instantiating all of them with the
+  // initial stencil. The `usePinnedBytecode` flag must be set if this is set,
+  // given the delazifications are decoded from the buffer until the script
+  // source goes away.
+  //
+  // This is not part of the compile options, and is not copied from them.
+  bool decodeDelazificationsOnDemand = false;
+
  protected:
   JS::ConstUTF8CharsZ introducerFilename_;
 
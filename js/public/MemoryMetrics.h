@@ -505,7 +505,11 @@ struct RuntimeSizes {
   MACRO(_, MallocHeap, uncompressedSourceCache)     \
   MACRO(_, MallocHeap, scriptData)                  \
   MACRO(_, MallocHeap, wasmRuntime)                 \
+  MACRO(_, MallocHeap, wasmModuleCacheData)         \
+  MACRO(_, NonHeap, wasmModuleCacheCode)            \
   MACRO(_, Ignore, wasmGuardPages)                  \
+  MACRO(_, Ignore, wasmHugePages)                   \
+  MACRO(_, Ignore, jitHugePages)                    \
   MACRO(_, MallocHeap, jitLazyLink)
 
   RuntimeSizes() { allScriptSources.emplace(); }
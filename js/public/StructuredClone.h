@@ -560,6 +560,11 @@ class MOZ_NON_MEMMOVABLE JS_PUBLIC_API JSStructuredCloneData {
   // Append new data to the end of the buffer.
   [[nodiscard]] bool AppendBytes(const char* data, size_t size) {
     MOZ_ASSERT(scope() != JS::StructuredCloneScope::Unassigned);
+    if (size > kStandardCapacity) {
+      // Typed array contents and long strings: keep them in one segment, so
+      // that they're written and read with a single copy.
+      return bufList_.WriteBytesContiguous(data, size);
+    }
     return bufList_.WriteBytes(data, size);
   }
 
@@ -1530,7 +1530,12 @@ static bool DelazifyCanonicalScriptedFunctionImpl(JSContext* cx,
   RefPtr<InitialStencilAndDelazifications> stencils =
       lazy->sourceObject()->maybeGetStencils();
 
-  if (stencils && input.get().options.consumeDelazificationCache()) {
+  if (stencils && (input.get().options.consumeDelazificationCache() ||
+                   stencils->hasEncodedDelazifications())) {
+    if (!stencils->maybeDecodeDelazificationFor(fc, input.get().extent())) {
+      return false;
+    }
+
     const CompilationStencil* cached =
         stencils->getDelazificationFor(input.get().extent());
     if (cached) {
@@ -1594,6 +1599,11 @@ static const CompilationStencil* DelazifyCanonicalScriptedFunctionImpl(
     DelazifyFailureReason* failureReason) {
   MOZ_ASSERT(stencils);
 
+  if (!stencils->maybeDecodeDelazificationAt(fc, scriptIndex)) {
+    *failureReason = DelazifyFailureReason::Other;
+    return nullptr;
+  }
+
   const CompilationStencil* cached = stencils->getDelazificationAt(scriptIndex);
   if (cached) {
     return cached;
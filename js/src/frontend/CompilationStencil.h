@@ -1403,6 +1403,15 @@ struct InitialStencilAndDelazifications {
   // uninitialized and unused
   FunctionKeyToScriptIndexMap functionKeyToInitialScriptIndex_;
 
+  // The XDR encoded delazifications which are not yet decoded, when decoded
+  // with JS::DecodeOptions::decodeDelazificationsOnDemand.
+  //
+  // The i-th element is for ScriptIndex(i-1), and is empty if there's no
+  // encoded delazification for the function.  This vector is populated while
+  // decoding the XDR buffer, and is read-only after that.
+  Vector<mozilla::Span<const uint8_t>, 0, js::SystemAllocPolicy>
+      encodedDelazifications_;
+
   mutable mozilla::Atomic<uintptr_t> refCount_{0};
 
  public:
@@ -1459,6 +1468,37 @@ struct InitialStencilAndDelazifications {
   const CompilationStencil* storeDelazification(
       RefPtr<CompilationStencil>&& delazification);
 
+  // Record the XDR encoded delazification for the function, to be decoded by
+  // maybeDecodeDelazificationAt.  The encoded data must stay alive as long as
+  // this instance does.
+  //
+  // This is not thread-safe, and should be called only while decoding.
+  [[nodiscard]] bool setEncodedDelazification(
+      FrontendContext* fc, size_t functionIndex,
+      mozilla::Span<const uint8_t> encoded);
+
+  // Returns true if any delazification was recorded by
+  // setEncodedDelazification.
+  bool hasEncodedDelazifications() const {
+    return !encodedDelazifications_.empty();
+  }
+
+  // Return the XDR encoded delazification for the function, or an empty span
+  // if there's none.
+  mozilla::Span<const uint8_t> getEncodedDelazificationAt(
+      size_t functionIndex) const;
+
+  // Decode and store the encoded delazification for the function if it's not
+  // yet populated.  If the encoded data turns out to be malformed, it's
+  // ignored and the function is delazified from the source instead.
+  //
+  // Returns false if any error happens, and sets exception on the
+  // FrontendContext.
+  [[nodiscard]] bool maybeDecodeDelazificationAt(FrontendContext* fc,
+                                                 size_t functionIndex);
+  [[nodiscard]] bool maybeDecodeDelazificationFor(FrontendContext* fc,
+                                                  const SourceExtent& extent);
+
   // Create single CompilationStencil that reflects the initial stencil
   // and the all delazifications.
   //
@@ -3765,6 +3765,77 @@ const CompilationStencil* InitialStencilAndDelazifications::storeDelazification(
   return delazifications_[functionIndex - 1];
 }
 
+bool InitialStencilAndDelazifications::setEncodedDelazification(
+    FrontendContext* fc, size_t functionIndex,
+    mozilla::Span<const uint8_t> encoded) {
+  MOZ_ASSERT(canLazilyParse());
+  MOZ_ASSERT(functionIndex > 0);
+  MOZ_ASSERT(functionIndex < initial_->scriptData.size());
+
+  if (encodedDelazifications_.empty()) {
+    if (!encodedDelazifications_.resize(delazifications_.length())) {
+      ReportOutOfMemory(fc);
+      return false;
+    }
+  }
+
+  encodedDelazifications_[functionIndex - 1] = encoded;
+  return true;
+}
+
+mozilla::Span<const uint8_t>
+InitialStencilAndDelazifications::getEncodedDelazificationAt(
+    size_t functionIndex) const {
+  MOZ_ASSERT(canLazilyParse());
+  MOZ_ASSERT(functionIndex > 0);
+
+  if (encodedDelazifications_.empty()) {
+    return mozilla::Span<const uint8_t>();
+  }
+  return encodedDelazifications_[functionIndex - 1];
+}
+
+bool InitialStencilAndDelazifications::maybeDecodeDelazificationAt(
+    FrontendContext* fc, size_t functionIndex) {
+  mozilla::Span<const uint8_t> encoded =
+      getEncodedDelazificationAt(functionIndex);
+  if (encoded.IsEmpty() || getDelazificationAt(functionIndex)) {
+    return true;
+  }
+
+  // The encoded data lives in a pinned buffer, see
+  // JS::DecodeOptions::decodeDelazificationsOnDemand.
+  JS::DecodeOptions options;
+  options.borrowBuffer = true;
+  options.usePinnedBytecode = true;
+
+  RefPtr<CompilationStencil> delazification;
+  JS::TranscodeRange range(encoded.data(), encoded.size());
+  JS::TranscodeResult result = DecodeDelazification(
+      fc, options, initial_->source, range, getter_AddRefs(delazification));
+  if (result != JS::TranscodeResult::Ok) {
+    return JS::IsTranscodeFailureResult(result);
+  }
+
+  // Another thread may have delazified the function in the meantime, in which
+  // case the decoded stencil is discarded.
+  storeDelazification(std::move(delazification));
+  return true;
+}
+
+bool InitialStencilAndDelazifications::maybeDecodeDelazificationFor(
+    FrontendContext* fc, const SourceExtent& extent) {
+  if (!hasEncodedDelazifications()) {
+    return true;
+  }
+
+  auto maybeIndex =
+      functionKeyToInitialScriptIndex_.get(extent.toFunctionKey());
+  MOZ_ASSERT(maybeIndex,
+             "The extent parameter should be for a function inside the script");
+  return maybeDecodeDelazificationAt(fc, *maybeIndex);
+}
+
 CompilationStencil* InitialStencilAndDelazifications::getMerged(
     FrontendContext* fc) const {
   MOZ_ASSERT(canLazilyParse());
@@ -3813,7 +3884,10 @@ bool InitialStencilAndDelazifications::instantiateStencils(
     return false;
   }
 
-  if (input.options.populateDelazificationCache()) {
+  // The delazifications which are still encoded are decoded from the
+  // associated stencils when the function is delazified.
+  if (input.options.populateDelazificationCache() ||
+      stencils.hasEncodedDelazifications()) {
     RefPtr<InitialStencilAndDelazifications> stencilsPtr = &stencils;
     ScriptSourceObject* sso = gcOutput.script->sourceObject();
     MOZ_ASSERT(!sso->maybeGetStencils());
@@ -3884,6 +3958,7 @@ size_t InitialStencilAndDelazifications::sizeOfExcludingThis(
   }
 
   size += functionKeyToInitialScriptIndex_.sizeOfExcludingThis(mallocSizeOf);
+  size += encodedDelazifications_.sizeOfExcludingThis(mallocSizeOf);
 
   return size;
 }
@@ -870,10 +870,9 @@ template <XDRMode mode>
   MOZ_TRY(
       XDRSpanContent(xdr, stencil.alloc, stencil.scriptExtra, scriptExtraSize));
 
-  // We don't support coding non-initial CompilationStencil.
-  MOZ_ASSERT(stencil.isInitialStencil());
-
-  if (stencil.scriptExtra[CompilationStencil::TopLevelIndex].isModule()) {
+  // Delazifications have no ScriptStencilExtra, and cannot be modules.
+  if (stencil.isInitialStencil() &&
+      stencil.scriptExtra[CompilationStencil::TopLevelIndex].isModule()) {
     if (mode == XDR_DECODE) {
       stencil.moduleMetadata =
           xdr->fc()->getAllocator()->template new_<StencilModuleMetadata>();
@@ -1427,9 +1426,77 @@ static XDRResult VersionCheck(XDRState<mode>* xdr) {
   return Ok();
 }
 
+XDRResult XDRStencilEncoder::codeDelazifications(
+    const frontend::InitialStencilAndDelazifications* maybeStencils) {
+  uint32_t count = 0;
+  size_t countOffset = buf->cursor();
+  MOZ_TRY(codeUint32(&count));
+
+  if (!maybeStencils || !maybeStencils->canLazilyParse()) {
+    return Ok();
+  }
+
+  size_t scriptCount = maybeStencils->getInitial()->scriptData.size();
+  for (size_t i = 1; i < scriptCount; i++) {
+    const frontend::CompilationStencil* delazification =
+        maybeStencils->getDelazificationAt(i);
+    mozilla::Span<const uint8_t> encoded =
+        maybeStencils->getEncodedDelazificationAt(i);
+    if (!delazification && encoded.IsEmpty()) {
+      continue;
+    }
+
+    uint32_t functionIndex = i;
+    MOZ_TRY(codeUint32(&functionIndex));
+
+    uint32_t length = 0;
+    size_t lengthOffset = buf->cursor();
+    MOZ_TRY(codeUint32(&length));
+
+    // Each delazification is decoded from its own range, which has to be
+    // aligned in the same way as the entire buffer.
+    MOZ_ASSERT(isAligned32());
+    size_t contentOffset = buf->cursor();
+    if (delazification) {
+      MOZ_TRY(frontend::StencilXDR::checkCompilationStencil(
+          this, *delazification));
+      MOZ_TRY(frontend::StencilXDR::codeCompilationStencil(
+          this, const_cast<frontend::CompilationStencil&>(*delazification)));
+    } else {
+      // Not yet decoded, the encoded data can be copied as is.
+      MOZ_TRY(codeBytes(const_cast<uint8_t*>(encoded.data()), encoded.size()));
+    }
+    size_t endOffset = buf->cursor();
+    if (endOffset - contentOffset > UINT32_MAX) {
+      ReportOutOfMemory(fc());
+      return fail(JS::TranscodeResult::Throw);
+    }
+
+    length = endOffset - contentOffset;
+    codeUint32At(&length, lengthOffset);
+    count++;
+  }
+
+  codeUint32At(&count, countOffset);
+  return Ok();
+}
+
 XDRResult XDRStencilEncoder::codeStencil(
     const RefPtr<ScriptSource>& source,
     const frontend::CompilationStencil& stencil) {
+  return codeStencilImpl(source, stencil, nullptr);
+}
+
+XDRResult XDRStencilEncoder::codeStencils(
+    const RefPtr<ScriptSource>& source,
+    const frontend::InitialStencilAndDelazifications& stencils) {
+  return codeStencilImpl(source, *stencils.getInitial(), &stencils);
+}
+
+XDRResult XDRStencilEncoder::codeStencilImpl(
+    const RefPtr<ScriptSource>& source,
+    const frontend::CompilationStencil& stencil,
+    const frontend::InitialStencilAndDelazifications* maybeStencils) {
 #ifdef DEBUG
   auto sanityCheck = mozilla::MakeScopeExit(
       [&] { MOZ_ASSERT(validateResultCode(fc(), resultCode())); });
@@ -1450,6 +1517,7 @@ XDRResult XDRStencilEncoder::codeStencil(
       this, nullptr, const_cast<RefPtr<ScriptSource>&>(source)));
   MOZ_TRY(frontend::StencilXDR::codeCompilationStencil(
       this, const_cast<frontend::CompilationStencil&>(stencil)));
+  MOZ_TRY(codeDelazifications(maybeStencils));
   size_t endOffset = buf->cursor();
 
   if (endOffset > UINT32_MAX) {
@@ -1486,20 +1554,12 @@ static JS::TranscodeResult EncodeStencilImpl(
 JS::TranscodeResult JS::EncodeStencil(JSContext* cx, JS::Stencil* stencil,
                                       JS::TranscodeBuffer& buffer) {
   AutoReportFrontendContext fc(cx);
-
-  const CompilationStencil* initial;
-  UniquePtr<CompilationStencil> merged;
-  if (stencil->canLazilyParse()) {
-    merged.reset(stencil->getMerged(&fc));
-    if (!merged) {
-      return TranscodeResult::Throw;
-    }
-    initial = merged.get();
-  } else {
-    initial = stencil->getInitial();
+  XDRStencilEncoder encoder(&fc, buffer);
+  XDRResult res = encoder.codeStencils(stencil->getInitial()->source, *stencil);
+  if (res.isErr()) {
+    return res.unwrapErr();
   }
-
-  return EncodeStencilImpl(&fc, initial, buffer);
+  return TranscodeResult::Ok;
 }
 
 JS::TranscodeResult js::EncodeStencil(JSContext* cx,
@@ -1509,9 +1569,74 @@ JS::TranscodeResult js::EncodeStencil(JSContext* cx,
   return EncodeStencilImpl(&fc, stencil, buffer);
 }
 
+XDRResult XDRStencilDecoder::codeDelazifications(
+    const frontend::CompilationStencil& initial,
+    frontend::InitialStencilAndDelazifications* maybeStencils) {
+  MOZ_ASSERT_IF(options().decodeDelazificationsOnDemand,
+                options().usePinnedBytecode);
+
+  uint32_t count;
+  MOZ_TRY(codeUint32(&count));
+  if (count && !initial.canLazilyParse) {
+    return fail(JS::TranscodeResult::Failure_BadDecode);
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t functionIndex;
+    MOZ_TRY(codeUint32(&functionIndex));
+    if (functionIndex == 0 || functionIndex >= initial.scriptData.size()) {
+      return fail(JS::TranscodeResult::Failure_BadDecode);
+    }
+
+    uint32_t length;
+    MOZ_TRY(codeUint32(&length));
+
+    const uint8_t* content;
+    MOZ_TRY(readData(&content, length));
+
+    if (!maybeStencils) {
+      continue;
+    }
+
+    if (options().decodeDelazificationsOnDemand) {
+      if (!maybeStencils->setEncodedDelazification(
+              fc(), functionIndex,
+              mozilla::Span<const uint8_t>(content, length))) {
+        return fail(JS::TranscodeResult::Throw);
+      }
+      continue;
+    }
+
+    RefPtr<frontend::CompilationStencil> delazification;
+    JS::TranscodeResult result = js::DecodeDelazification(
+        fc(), options(), initial.source, JS::TranscodeRange(content, length),
+        getter_AddRefs(delazification));
+    if (result != JS::TranscodeResult::Ok) {
+      return fail(result);
+    }
+    maybeStencils->storeDelazification(std::move(delazification));
+  }
+
+  return Ok();
+}
+
 XDRResult XDRStencilDecoder::codeStencil(
     const JS::ReadOnlyDecodeOptions& options,
     frontend::CompilationStencil& stencil) {
+  return codeStencilImpl(options, stencil, nullptr);
+}
+
+XDRResult XDRStencilDecoder::codeStencils(
+    const JS::ReadOnlyDecodeOptions& options,
+    frontend::CompilationStencil& initial,
+    frontend::InitialStencilAndDelazifications& stencils) {
+  return codeStencilImpl(options, initial, &stencils);
+}
+
+XDRResult XDRStencilDecoder::codeStencilImpl(
+    const JS::ReadOnlyDecodeOptions& options,
+    frontend::CompilationStencil& stencil,
+    frontend::InitialStencilAndDelazifications* maybeStencils) {
 #ifdef DEBUG
   auto sanityCheck = mozilla::MakeScopeExit(
       [&] { MOZ_ASSERT(validateResultCode(fc(), resultCode())); });
@@ -1539,6 +1664,30 @@ XDRResult XDRStencilDecoder::codeStencil(
   MOZ_TRY(frontend::StencilXDR::codeSource(this, &options, stencil.source));
   MOZ_TRY(frontend::StencilXDR::codeCompilationStencil(this, stencil));
 
+  if (maybeStencils && !maybeStencils->init(fc(), &stencil)) {
+    return fail(JS::TranscodeResult::Throw);
+  }
+  MOZ_TRY(codeDelazifications(stencil, maybeStencils));
+
+  return Ok();
+}
+
+XDRResult XDRStencilDecoder::codeDelazification(
+    const JS::ReadOnlyDecodeOptions& options,
+    frontend::CompilationStencil& stencil) {
+#ifdef DEBUG
+  auto sanityCheck = mozilla::MakeScopeExit(
+      [&] { MOZ_ASSERT(validateResultCode(fc(), resultCode())); });
+#endif
+
+  auto resetOptions = mozilla::MakeScopeExit([&] { options_ = nullptr; });
+  options_ = &options;
+
+  MOZ_TRY(frontend::StencilXDR::codeCompilationStencil(this, stencil));
+  if (stencil.isInitialStencil()) {
+    return fail(JS::TranscodeResult::Failure_BadDecode);
+  }
+
   return Ok();
 }
 
@@ -1554,20 +1703,24 @@ JS::TranscodeResult JS::DecodeStencil(JS::FrontendContext* fc,
                                       const JS::ReadOnlyDecodeOptions& options,
                                       const JS::TranscodeRange& range,
                                       JS::Stencil** stencilOut) {
-  RefPtr<CompilationStencil> stencil;
-  JS::TranscodeResult result =
-      js::DecodeStencil(fc, options, range, getter_AddRefs(stencil));
-  if (result != TranscodeResult::Ok) {
-    return result;
+  RefPtr<ScriptSource> source = fc->getAllocator()->new_<ScriptSource>();
+  if (!source) {
+    return TranscodeResult::Throw;
+  }
+  RefPtr<CompilationStencil> stencil =
+      fc->getAllocator()->new_<CompilationStencil>(source);
+  if (!stencil) {
+    return TranscodeResult::Throw;
   }
-
   RefPtr stencils =
       fc->getAllocator()->new_<frontend::InitialStencilAndDelazifications>();
   if (!stencils) {
     return TranscodeResult::Throw;
   }
-  if (!stencils->init(fc, stencil.get())) {
-    return TranscodeResult::Throw;
+  XDRStencilDecoder decoder(fc, range);
+  XDRResult res = decoder.codeStencils(options, *stencil, *stencils);
+  if (res.isErr()) {
+    return res.unwrapErr();
   }
   stencils.forget(stencilOut);
   return TranscodeResult::Ok;
@@ -1595,6 +1748,24 @@ JS::TranscodeResult js::DecodeStencil(
   return JS::TranscodeResult::Ok;
 }
 
+JS::TranscodeResult js::DecodeDelazification(
+    JS::FrontendContext* fc, const JS::ReadOnlyDecodeOptions& options,
+    ScriptSource* source, const JS::TranscodeRange& range,
+    frontend::CompilationStencil** stencilOut) {
+  RefPtr<CompilationStencil> stencil =
+      fc->getAllocator()->new_<CompilationStencil>(source);
+  if (!stencil) {
+    return JS::TranscodeResult::Throw;
+  }
+  XDRStencilDecoder decoder(fc, range);
+  XDRResult res = decoder.codeDelazification(options, *stencil);
+  if (res.isErr()) {
+    return res.unwrapErr();
+  }
+  stencil.forget(stencilOut);
+  return JS::TranscodeResult::Ok;
+}
+
 template /* static */ XDRResult StencilXDR::codeCompilationStencil(
     XDRState<XDR_ENCODE>* xdr, CompilationStencil& stencil);
 
@@ -35,6 +35,7 @@ namespace frontend {
 
 struct CompilationStencil;
 struct ExtensibleCompilationStencil;
+struct InitialStencilAndDelazifications;
 struct SharedDataContainer;
 
 // Check that we can copy data to disk and restore it in another instance of
@@ -164,6 +165,11 @@ class StencilXDR {
  * 4. content
  *   a. ScriptSource
  *   b. CompilationStencil
+ *   c. number of delazifications
+ *   d. delazifications, each of them being
+ *     i.   index of the function in the initial CompilationStencil
+ *     ii.  length of the delazification
+ *     iii. CompilationStencil
  */
 
 /*
@@ -184,15 +190,37 @@ class XDRStencilDecoder : public XDRState<XDR_DECODE> {
     MOZ_ASSERT(JS::IsTranscodingBytecodeAligned(range.begin().get()));
   }
 
+  // Decode the initial stencil, ignoring the delazifications.
   XDRResult codeStencil(const JS::ReadOnlyDecodeOptions& options,
                         frontend::CompilationStencil& stencil);
 
+  // Decode the initial stencil into `initial`, and initialize `stencils` with
+  // it and the delazifications.
+  XDRResult codeStencils(const JS::ReadOnlyDecodeOptions& options,
+                         frontend::CompilationStencil& initial,
+                         frontend::InitialStencilAndDelazifications& stencils);
+
+  // Decode one of the delazifications written by
+  // XDRStencilEncoder::codeStencils, the range of the decoder covering only
+  // the delazification's CompilationStencil.
+  XDRResult codeDelazification(const JS::ReadOnlyDecodeOptions& options,
+                               frontend::CompilationStencil& stencil);
+
   const JS::ReadOnlyDecodeOptions& options() {
     MOZ_ASSERT(options_);
     return *options_;
   }
 
  private:
+  XDRResult codeStencilImpl(
+      const JS::ReadOnlyDecodeOptions& options,
+      frontend::CompilationStencil& stencil,
+      frontend::InitialStencilAndDelazifications* maybeStencils);
+
+  XDRResult codeDelazifications(
+      const frontend::CompilationStencil& initial,
+      frontend::InitialStencilAndDelazifications* maybeStencils);
+
   const JS::ReadOnlyDecodeOptions* options_ = nullptr;
 };
 
@@ -212,6 +240,21 @@ class XDRStencilEncoder : public XDRState<XDR_ENCODE> {
                         const frontend::CompilationStencil& stencil);
 
   XDRResult codeStencil(const frontend::CompilationStencil& stencil);
+
+  // Encode the initial stencil, followed by the delazifications, which are
+  // decoded separately.
+  XDRResult codeStencils(
+      const RefPtr<ScriptSource>& source,
+      const frontend::InitialStencilAndDelazifications& stencils);
+
+ private:
+  XDRResult codeStencilImpl(
+      const RefPtr<ScriptSource>& source,
+      const frontend::CompilationStencil& stencil,
+      const frontend::InitialStencilAndDelazifications* maybeStencils);
+
+  XDRResult codeDelazifications(
+      const frontend::InitialStencilAndDelazifications* maybeStencils);
 };
 
 JS::TranscodeResult EncodeStencil(JSContext* cx,
@@ -223,6 +266,13 @@ JS::TranscodeResult DecodeStencil(JS::FrontendContext* fc,
                                   const JS::TranscodeRange& range,
                                   frontend::CompilationStencil** stencilOut);
 
+// Decode one of the delazifications recorded with
+// InitialStencilAndDelazifications::setEncodedDelazification.
+JS::TranscodeResult DecodeDelazification(
+    JS::FrontendContext* fc, const JS::ReadOnlyDecodeOptions& options,
+    ScriptSource* source, const JS::TranscodeRange& range,
+    frontend::CompilationStencil** stencilOut);
+
 } /* namespace js */
 
 #endif /* frontend_StencilXdr_h */
@@ -35,6 +35,8 @@ using namespace js;
 using namespace js::gc;
 
 using mozilla::Maybe;
+using mozilla::TimeDuration;
+using mozilla::TimeStamp;
 
 using JS::SliceBudget;
 
@@ -83,15 +85,35 @@ IncrementalProgress GCRuntime::compactPhase(JS::GCReason reason,
   Arena* relocatedArenas = nullptr;
   while (!zonesToMaybeCompact.ref().isEmpty()) {
     Zone* zone = zonesToMaybeCompact.ref().front();
+
+    CompactZoneAction action = compactZoneAction(zone, reason, sliceBudget,
+                                                 !relocatedZones.isEmpty());
+    if (action == CompactZoneAction::Yield) {
+      break;
+    }
+
     zonesToMaybeCompact.ref().removeFront();
+    if (action == CompactZoneAction::Skip) {
+      continue;
+    }
 
     MOZ_ASSERT(nursery().isEmpty());
     zone->changeGCState(Zone::Finished, Zone::Compact);
 
+    TimeStamp start = TimeStamp::Now();
+    size_t zoneArenas = zone->gcHeapSize.bytes() / ArenaSize;
     if (relocateArenas(zone, reason, relocatedArenas, sliceBudget)) {
       updateZonePointersToRelocatedCells(zone);
       relocatedZones.append(zone);
       zonesCompacted++;
+
+      if (zoneArenas) {
+        TimeDuration perArena =
+            (TimeStamp::Now() - start) / int64_t(zoneArenas);
+        TimeDuration previous = compactTimePerArena;
+        compactTimePerArena =
+            previous ? (previous * 3 + perArena) / 4 : perArena;
+      }
     } else {
       zone->changeGCState(Zone::Compact, Zone::Finished);
     }
@@ -135,6 +157,40 @@ static bool ShouldRelocateAllArenas(JS::GCReason reason) {
   return reason == JS::GCReason::DEBUG_GC;
 }
 
+/*
+ * Compacting a zone can't be split across slices, as every pointer into the
+ * zone's relocated arenas is updated by tracing the whole zone before the
+ * mutator runs again.  Instead, estimate how long compacting |zone| takes from
+ * the previous compactions and keep time budgeted slices within their budget:
+ * yield to the mutator if only a fresh slice has enough time left, and leave
+ * the zone uncompacted if not even that is long enough.  Collections for
+ * memory pressure still compact everything they can.
+ */
+GCRuntime::CompactZoneAction GCRuntime::compactZoneAction(
+    Zone* zone, JS::GCReason reason, SliceBudget& sliceBudget,
+    bool compactedZoneInSlice) const {
+  if (!sliceBudget.isTimeBudget() || IsOOMReason(reason) ||
+      reason == JS::GCReason::MEM_PRESSURE ||
+      ShouldRelocateAllArenas(reason) || !compactTimePerArena.ref()) {
+    return CompactZoneAction::Compact;
+  }
+
+  size_t zoneArenas = zone->gcHeapSize.bytes() / ArenaSize;
+  TimeDuration estimate = compactTimePerArena.ref() * uint64_t(zoneArenas);
+  if (estimate > sliceBudget.timeBudgetDuration()) {
+    return CompactZoneAction::Skip;
+  }
+
+  // Always make progress in a slice, its budget may already be used up by
+  // the time it gets here.
+  if (compactedZoneInSlice &&
+      TimeStamp::Now() + estimate > sliceBudget.deadline()) {
+    return CompactZoneAction::Yield;
+  }
+
+  return CompactZoneAction::Compact;
+}
+
 /*
  * Choose which arenas to relocate all cells from.
  *
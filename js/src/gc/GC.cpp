@@ -239,6 +239,7 @@
 #include "vm/StringType.h"
 #include "vm/SymbolType.h"
 #include "vm/Time.h"
+#include "wasm/WasmModuleCache.h"
 
 #include "gc/Heap-inl.h"
 #include "gc/Nursery-inl.h"
@@ -1809,6 +1810,12 @@ static bool DiscardedCodeRecently(Zone* zone, const TimeStamp& currentTime) {
          currentTime < (zone->lastDiscardedCodeTime() + thirtySeconds);
 }
 
+static bool DiscardingCodeIsOverdue(Zone* zone, const TimeStamp& currentTime) {
+  static const auto fiveMinutes = TimeDuration::FromSeconds(5 * 60);
+  return !zone->lastDiscardedCodeTime().IsNull() &&
+         currentTime >= (zone->lastDiscardedCodeTime() + fiveMinutes);
+}
+
 bool GCRuntime::shouldCompact() {
   // Compact on shrinking GC if enabled.  Skip compacting in incremental GCs
   // if we are currently animating, unless the user is inactive or we're
@@ -2502,6 +2509,7 @@ void GCRuntime::purgeRuntime() {
 
   if (rt->isMainRuntime()) {
     SharedImmutableStringsCache::getSingleton().purge();
+    wasm::PurgeModuleCache(isShrinkingGC());
   }
 
   MOZ_ASSERT(marker().unmarkGrayStack.empty());
@@ -2531,8 +2539,11 @@ bool GCRuntime::shouldPreserveJITCode(Realm* realm,
   }
 
   // The topmost frame of JIT code is in this compartment, and so we should
-  // try to preserve this zone's code.
-  if (isActiveCompartment) {
+  // try to preserve this zone's code. A zone that is running whenever we GC
+  // would otherwise keep the code of the scripts that went cold forever, so
+  // we still discard it every few minutes. Code on the stack is kept.
+  if (isActiveCompartment &&
+      !DiscardingCodeIsOverdue(realm->zone(), currentTime)) {
     return true;
   }
 
@@ -202,7 +202,7 @@ class MarkStack {
   [[nodiscard]] bool ensureSpace(size_t count);
 
   static size_t moveWork(GCMarker* marker, MarkStack& dst, MarkStack& src,
-                         bool allowDistribute);
+                         bool allowDistribute, size_t shares);
 
   size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
 
@@ -381,6 +381,7 @@ class GCMarker {
 
   bool canDonateWork() const;
   bool shouldDonateWork() const;
+  size_t maxDonationRecipients() const;
 
   void start();
   void stop();
@@ -418,7 +419,8 @@ class GCMarker {
   template <uint32_t markingOptions, gc::MarkColor>
   bool markOneColor(JS::SliceBudget& budget);
 
-  static size_t moveWork(GCMarker* dst, GCMarker* src, bool allowDistribute);
+  static size_t moveWork(GCMarker* dst, GCMarker* src, bool allowDistribute,
+                         size_t shares = 2);
 
   [[nodiscard]] bool initStack();
   void resetStackCapacity();
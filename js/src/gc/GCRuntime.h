@@ -967,6 +967,10 @@ class GCRuntime {
   void endCompactPhase();
   void sweepZoneAfterCompacting(MovingTracer* trc, Zone* zone);
   bool canRelocateZone(Zone* zone) const;
+  enum class CompactZoneAction { Compact, Yield, Skip };
+  CompactZoneAction compactZoneAction(Zone* zone, JS::GCReason reason,
+                                      JS::SliceBudget& sliceBudget,
+                                      bool compactedZoneInSlice) const;
   [[nodiscard]] bool relocateArenas(Zone* zone, JS::GCReason reason,
                                     Arena*& relocatedListOut,
                                     JS::SliceBudget& sliceBudget);
@@ -1313,6 +1317,9 @@ class GCRuntime {
   MainThreadData<bool> startedCompacting;
   MainThreadData<ZoneList> zonesToMaybeCompact;
   MainThreadData<size_t> zonesCompacted;
+  // Smoothed time it took to compact a zone, per arena of the zone, used to
+  // keep incremental compacting slices within their budget.
+  MainThreadData<mozilla::TimeDuration> compactTimePerArena;
 #ifdef DEBUG
   GCLockData<Arena*> relocatedArenasToRelease;
 #endif
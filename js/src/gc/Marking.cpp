@@ -1259,11 +1259,13 @@ static gcstats::PhaseKind GrayMarkingPhaseForCurrentPhase(
   }
 }
 
-size_t GCMarker::moveWork(GCMarker* dst, GCMarker* src, bool allowDistribute) {
+size_t GCMarker::moveWork(GCMarker* dst, GCMarker* src, bool allowDistribute,
+                          size_t shares) {
   MOZ_ASSERT(dst->stack.isEmpty());
   MOZ_ASSERT(src->canDonateWork());
 
-  return MarkStack::moveWork(src, dst->stack, src->stack, allowDistribute);
+  return MarkStack::moveWork(src, dst->stack, src->stack, allowDistribute,
+                             shares);
 }
 
 bool GCMarker::initStack() {
@@ -1912,22 +1914,28 @@ MOZ_ALWAYS_INLINE bool MarkStack::indexIsEntryBase(size_t index) const {
 
 /* static */
 size_t MarkStack::moveWork(GCMarker* marker, MarkStack& dst, MarkStack& src,
-                           bool allowDistribute) {
+                           bool allowDistribute, size_t shares) {
   // Move some work from |src| to |dst|. Assumes |dst| is empty.
   //
+  // |shares| is the number of ways the work in |src| is being split. A donor
+  // serving several waiting threads at once moves one share to each of them
+  // in turn, keeping the same amount for itself.
+  //
   // When this method runs during parallel marking, we are on the thread that
   // owns |src|, and the thread that owns |dst| is blocked waiting on the
   // ParallelMarkTask::resumed condition variable.
 
   MOZ_ASSERT(dst.isEmpty());
   MOZ_ASSERT(src.elementsRangesAreValid == dst.elementsRangesAreValid);
+  MOZ_ASSERT(shares >= 2);
 
   // Limit the size of moves to stop threads with work spending too much time
   // donating.
   static const size_t MaxWordsToMove = 4096;
 
   size_t totalWords = src.position();
-  size_t wordsToMove = std::min(totalWords / 2, MaxWordsToMove);
+  size_t wordsToMove =
+      std::clamp(totalWords / shares, size_t(1), MaxWordsToMove);
 
   // Mark stack entries do not represent uniform amounts of marking work (they
   // are either single GC things or arbitrarily large arrays) and when the mark
@@ -1942,9 +1950,9 @@ size_t MarkStack::moveWork(GCMarker* marker, MarkStack& dst, MarkStack& src,
   //
   // This has the effect of reducing the number of donations between threads. It
   // does not decrease average marking time but it does decrease variance of
-  // marking time.
+  // marking time. It only applies to the final two-way split.
   static constexpr size_t MaxWordsToDistribute = 30;
-  if (allowDistribute && totalWords <= MaxWordsToDistribute) {
+  if (allowDistribute && shares == 2 && totalWords <= MaxWordsToDistribute) {
     if (!dst.ensureSpace(totalWords)) {
       return 0;
     }
@@ -2358,12 +2366,19 @@ void GCMarker::leaveParallelMarkingMode() {
 bool GCMarker::canDonateWork() const {
   return stack.position() > ValueRangeWords;
 }
+static constexpr size_t MinDonationWordCount = 12;
+static_assert(MinDonationWordCount >= ValueRangeWords,
+              "We must always leave at least one stack entry.");
+
 bool GCMarker::shouldDonateWork() const {
-  constexpr size_t MinWordCount = 12;
-  static_assert(MinWordCount >= ValueRangeWords,
-                "We must always leave at least one stack entry.");
+  return stack.position() > MinDonationWordCount;
+}
 
-  return stack.position() > MinWordCount;
+// With many markers several of them can be waiting at once. Serve as many of
+// them in one donation as there is worthwhile work for, rather than handing
+// half of the stack to the first and leaving the rest to ask again.
+size_t GCMarker::maxDonationRecipients() const {
+  return std::max(stack.position() / MinDonationWordCount, size_t(1));
 }
 
 template <typename Tracer>
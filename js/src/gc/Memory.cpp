@@ -12,6 +12,7 @@
 
 #include "jit/JitOptions.h"
 #include "js/HeapAPI.h"
+#include "js/Prefs.h"
 #include "js/Utility.h"
 
 #ifdef MOZ_MEMORY
@@ -954,6 +955,26 @@ bool MarkPagesInUseHard(void* region, size_t length) {
 #endif
 }
 
+bool HugePagesEnabled() {
+#if defined(MADV_HUGEPAGE)
+  return JS::Prefs::huge_pages();
+#else
+  return false;
+#endif
+}
+
+void MarkPagesHuge(void* region, size_t length) {
+  MOZ_ASSERT(HugePagesEnabled());
+  MOZ_ASSERT(OffsetFromAligned(region, SystemPageSize()) == 0);
+  MOZ_ASSERT(length % SystemPageSize() == 0);
+
+#if defined(MADV_HUGEPAGE)
+  // This is only advice: it fails if transparent huge pages are disabled
+  // system-wide, and we get normal pages in that case.
+  (void)madvise(region, length, MADV_HUGEPAGE);
+#endif
+}
+
 size_t GetPageFaultCount() {
 #ifdef XP_WIN
   PROCESS_MEMORY_COUNTERS pmc;
@@ -81,6 +81,16 @@ void MarkPagesInUseSoft(void* region, size_t length);
 // are not available.  May make pages read/write.
 [[nodiscard]] bool MarkPagesInUseHard(void* region, size_t length);
 
+// Whether large mappings that stay in use for a long time, such as wasm
+// memories and JIT code, should ask to be backed by huge pages to reduce TLB
+// misses. Only supported on Linux, see the javascript.options.huge_pages pref.
+bool HugePagesEnabled();
+
+// Ask the OS to back the given pages with transparent huge pages where it can.
+// The advice applies to the mapping, so it must be given again if the pages
+// are replaced by a new mapping. Requires HugePagesEnabled().
+void MarkPagesHuge(void* region, size_t length);
+
 // Returns #(hard faults) + #(soft faults)
 size_t GetPageFaultCount();
 
@@ -29,6 +29,7 @@
 #include "gc/Tenuring.h"
 #include "jit/JitFrames.h"
 #include "jit/JitZone.h"
+#include "js/Prefs.h"
 #include "js/Printer.h"
 #include "util/DifferentialTesting.h"
 #include "util/GetPidProvider.h"  // getpid()
@@ -1139,6 +1140,8 @@ void js::Nursery::renderProfileJSON(JSONPrinter& json) const {
   _("Timestamp", 10, "%10.6f", timestamp.ToSeconds()) \
   _("Reason", 20, "%-20.20s", reasonStr)              \
   _("PRate", 6, "%5.1f%%", promotionRatePercent)      \
+  _("PSite", 6, "%5.1f%%", pretenuredSitePercent)     \
+  _("us/MB", 6, "%6.0f", timePerMB)                   \
   _("OldKB", 6, "%6zu", oldSizeKB)                    \
   _("NewKB", 6, "%6zu", newSizeKB)                    \
   _("Dedup", 6, "%6zu", dedupCount)
@@ -1162,6 +1165,11 @@ void js::Nursery::printCollectionProfile(JS::GCReason reason,
   TimeDuration timestamp = collectionStartTime() - stats().creationTime();
   const char* reasonStr = ExplainGCReason(reason);
   double promotionRatePercent = promotionRate * 100;
+  double pretenuredSitePercent = pretenuredSiteFraction() * 100;
+  double usedMB = double(previousGC.nurseryUsedBytes) / double(1024 * 1024);
+  double timePerMB =
+      usedMB ? profileDurations_[ProfileKey::Total].ToMicroseconds() / usedMB
+             : 0.0;
   size_t oldSizeKB = previousGC.nurseryCapacity / 1024;
   size_t newSizeKB = capacity() / 1024;
   size_t dedupCount = stats().getStat(gcstats::STAT_STRINGS_DEDUPLICATED);
@@ -1411,6 +1419,7 @@ void js::Nursery::collect(JS::GCOptions options, JS::GCReason reason) {
   previousGC.nurseryUsedChunkCount = currentChunk() + 1;
   previousGC.tenuredBytes = 0;
   previousGC.tenuredCells = 0;
+  previousGC.pretenuredSiteCells = 0;
   tenuredEverything = true;
 
   // Wait for any previous buffer sweeping to finish. This happens even if the
@@ -1437,21 +1446,25 @@ void js::Nursery::collect(JS::GCOptions options, JS::GCReason reason) {
     previousGC.nurseryUsedChunkCount = currentChunk() + 1;
   }
 
-  // Resize the nursery.
-  maybeResizeNursery(options, reason);
-
-  if (!semispaceEnabled()) {
-    poisonAndInitCurrentChunk();
-  }
-
   bool validPromotionRate;
   const double promotionRate = calcPromotionRate(&validPromotionRate);
 
+  // Pretenure before resizing so the resizing heuristics know which of this
+  // collection's promotions won't happen again.
   startProfile(ProfileKey::Pretenure);
   size_t sitesPretenured = 0;
   sitesPretenured =
       doPretenuring(rt, reason, validPromotionRate, promotionRate);
   endProfile(ProfileKey::Pretenure);
+  previousGC.pretenuredSiteCells =
+      pretenuringNursery.pretenuredSitePromotedCount();
+
+  // Resize the nursery.
+  maybeResizeNursery(options, reason);
+
+  if (!semispaceEnabled()) {
+    poisonAndInitCurrentChunk();
+  }
 
   previousGC.endTime =
       TimeStamp::Now();  // Must happen after maybeResizeNursery.
@@ -2434,6 +2447,14 @@ size_t js::Nursery::targetSize(JS::GCOptions options, JS::GCReason reason) {
   double fractionPromoted =
       double(previousGC.tenuredBytes) / double(previousGC.nurseryCapacity);
 
+  // Cells promoted from sites that this collection switched to tenured
+  // allocation won't be allocated in the nursery again, so growing the nursery
+  // won't let them die there. Leave them out, assuming cells from these sites
+  // are of the average size.
+  if (JS::Prefs::site_based_nursery_sizing()) {
+    fractionPromoted *= 1.0 - pretenuredSiteFraction();
+  }
+
   // Calculate the duty factor, the fraction of time spent collecting the
   // nursery.
   double dutyFactor = 0.0;
@@ -2498,6 +2519,16 @@ size_t js::Nursery::targetSize(JS::GCOptions options, JS::GCReason reason) {
   return roundSize(size_t(smoothedTargetSize));
 }
 
+double js::Nursery::pretenuredSiteFraction() const {
+  if (previousGC.tenuredCells == 0) {
+    return 0.0;
+  }
+
+  double fraction = double(previousGC.pretenuredSiteCells) /
+                    double(previousGC.tenuredCells);
+  return std::min(fraction, 1.0);
+}
+
 void js::Nursery::clearRecentGrowthData() {
   if (js::SupportDifferentialTesting()) {
     return;
@@ -446,6 +446,10 @@ class Nursery {
   // Must only be called if the previousGC data is initialised.
   double calcPromotionRate(bool* validForTenuring) const;
 
+  // The fraction of the cells the last collection promoted that came from
+  // sites it pretenured.
+  double pretenuredSiteFraction() const;
+
   void freeTrailerBlocks(JS::GCOptions options, JS::GCReason reason);
 
   NurseryChunk& chunk(unsigned index) const { return *toSpace.chunks_[index]; }
@@ -708,6 +712,8 @@ class Nursery {
     size_t nurseryUsedChunkCount = 0;
     size_t tenuredBytes = 0;
     size_t tenuredCells = 0;
+    // Promoted cells from sites that were pretenured as a result.
+    size_t pretenuredSiteCells = 0;
     mozilla::TimeStamp endTime;
   };
   PreviousGC previousGC;
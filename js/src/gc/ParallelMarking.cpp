@@ -6,6 +6,8 @@
 
 #include "gc/ParallelMarking.h"
 
+#include <algorithm>
+
 #include "gc/GCInternals.h"
 #include "gc/GCLock.h"
 #include "gc/ParallelWork.h"
@@ -70,16 +72,25 @@ bool ParallelMarker::markOneColor(MarkColor color,
   MOZ_ASSERT(workerCount() <= MaxParallelWorkers);
   mozilla::Maybe<ParallelMarkTask> tasks[MaxParallelWorkers];
 
+  size_t emptyMarkers = 0;
+  for (size_t i = 1; i < workerCount(); i++) {
+    if (!gc->markers[i]->hasEntriesForCurrentColor()) {
+      emptyMarkers++;
+    }
+  }
+
   for (size_t i = 0; i < workerCount(); i++) {
     GCMarker* marker = gc->markers[i].get();
     tasks[i].emplace(this, marker, color, sliceBudget);
 
-    // Attempt to populate empty mark stacks.
-    //
-    // TODO: When tuning for more than two markers we may need to adopt a more
-    // sophisticated approach.
-    if (!marker->hasEntriesForCurrentColor() && gc->marker().canDonateWork()) {
-      GCMarker::moveWork(marker, &gc->marker(), false);
+    // Attempt to populate empty mark stacks, giving each of them an equal
+    // share of the main marker's work rather than halving what is left each
+    // time.
+    if (i != 0 && !marker->hasEntriesForCurrentColor()) {
+      if (gc->marker().canDonateWork()) {
+        GCMarker::moveWork(marker, &gc->marker(), false, emptyMarkers + 1);
+      }
+      emptyMarkers--;
     }
   }
 
@@ -107,6 +118,14 @@ bool ParallelMarker::markOneColor(MarkColor color,
     gc->joinTask(*tasks[i], lock);
   }
 
+  for (size_t i = 0; i < workerCount(); i++) {
+    const ParallelMarkTask& task = *tasks[i];
+    gc->stats().recordParallelMarker(i, task.markTime.ref(),
+                                     task.waitTime.ref(),
+                                     task.donationsReceived.ref(),
+                                     task.wordsReceived.ref());
+  }
+
 #ifdef DEBUG
   MOZ_ASSERT(waitingTasks.ref().isEmpty());
   MOZ_ASSERT(waitingTaskCount == 0);
@@ -132,7 +151,9 @@ ParallelMarkTask::ParallelMarkTask(ParallelMarker* pm, GCMarker* marker,
       pm(pm),
       marker(marker),
       color(*marker, color),
-      budget(budget) {
+      budget(budget),
+      donationsReceived(0),
+      wordsReceived(0) {
   marker->enterParallelMarkingMode(pm);
 }
 
@@ -334,28 +355,45 @@ void ParallelMarker::donateWorkFrom(GCMarker* src) {
     return;
   }
 
-  // Take the first waiting task off the list.
-  ParallelMarkTask* waitingTask = waitingTasks.ref().popFront();
-  waitingTaskCount--;
-
-  // |task| is not running so it's safe to move work to it.
-  MOZ_ASSERT(waitingTask->isWaiting);
+  // Take as many waiting tasks off the list as there is work for.
+  ParallelMarkTask* recipients[MaxParallelWorkers];
+  size_t recipientCount =
+      std::min(size_t(waitingTaskCount), src->maxDonationRecipients());
+  MOZ_ASSERT(recipientCount < MaxParallelWorkers);
+  for (size_t i = 0; i < recipientCount; i++) {
+    recipients[i] = waitingTasks.ref().popFront();
+    waitingTaskCount--;
+
+    // The task is not running so it's safe to move work to it.
+    MOZ_ASSERT(recipients[i]->isWaiting);
+  }
 
   gHelperThreadLock.unlock();
 
-  // Move some work from this thread's mark stack to the waiting task.
-  MOZ_ASSERT(!waitingTask->hasWork());
-  size_t wordsMoved = GCMarker::moveWork(waitingTask->marker, src, true);
+  // Move an equal share of this thread's mark stack to each waiting task,
+  // keeping one share for this thread.
+  size_t wordsMoved = 0;
+  for (size_t i = 0; i < recipientCount; i++) {
+    ParallelMarkTask* waitingTask = recipients[i];
+    MOZ_ASSERT(!waitingTask->hasWork());
+    if (src->canDonateWork()) {
+      size_t words = GCMarker::moveWork(waitingTask->marker, src, true,
+                                        recipientCount - i + 1);
+      waitingTask->donationsReceived.ref()++;
+      waitingTask->wordsReceived.ref() += words;
+      wordsMoved += words;
+    }
+
+    // Resume waiting task. If it didn't get any work it will ask again.
+    waitingTask->resume();
+  }
 
   gc->stats().count(gcstats::COUNT_PARALLEL_MARK_INTERRUPTIONS);
 
   if (profiler.enabled()) {
-    char details[32];
-    SprintfLiteral(details, "words=%zu", wordsMoved);
+    char details[48];
+    SprintfLiteral(details, "words=%zu tasks=%zu", wordsMoved, recipientCount);
     profiler.markEvent("Parallel marking donated work", details,
                        JS::ProfilingCategoryPair::GCCC);
   }
-
-  // Resume waiting task.
-  waitingTask->resume();
 }
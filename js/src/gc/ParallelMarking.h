@@ -33,7 +33,10 @@ class ParallelMarkTask;
 //
 // This uses a work-requesting approach. Threads mark until they run out of
 // work and then add themselves to a list of waiting tasks and block. Running
-// tasks with enough work may donate work to a waiting task and resume it.
+// tasks with enough work may donate work to waiting tasks and resume them. A
+// donation is split between as many waiting tasks as the donor has worthwhile
+// work for, so that with many markers idle threads don't have to queue up for
+// work one at a time.
 class MOZ_STACK_CLASS ParallelMarker {
  public:
   explicit ParallelMarker(GCRuntime* gc);
@@ -117,6 +120,11 @@ class alignas(TypicalCacheLineSize) ParallelMarkTask
   // Length of time this task spent blocked waiting for work.
   MainThreadOrGCTaskData<mozilla::TimeDuration> markTime;
   MainThreadOrGCTaskData<mozilla::TimeDuration> waitTime;
+
+  // Work donated to this task. Updated by the donating thread while this task
+  // is waiting.
+  MainThreadOrGCTaskData<uint32_t> donationsReceived;
+  MainThreadOrGCTaskData<size_t> wordsReceived;
 };
 
 }  // namespace gc
@@ -85,7 +85,10 @@ class ParallelWorker : public GCParallelTask {
   WorkItem item_;
 };
 
-static constexpr size_t MaxParallelWorkers = 8;
+// Upper bound on the number of threads used by parallel GC work, including
+// parallel marking. The number actually used is set by the JSGC_MAX_*_THREADS
+// parameters.
+static constexpr size_t MaxParallelWorkers = 16;
 
 // An RAII class that starts a number of ParallelWorkers and waits for them to
 // finish.
@@ -83,6 +83,7 @@ size_t PretenuringNursery::doPretenuring(GCRuntime* gc, JS::GCReason reason,
 
   // Zero allocation counts.
   totalAllocCount_ = 0;
+  pretenuredSitePromotedCount_ = 0;
   for (ZonesIter zone(gc, SkipAtoms); !zone.done(); zone.next()) {
     for (auto& count : zone->pretenuring.nurseryPromotedCounts) {
       count = 0;
@@ -117,11 +118,13 @@ size_t PretenuringNursery::doPretenuring(GCRuntime* gc, JS::GCReason reason,
     if (site->isNormal()) {
       sitesActive++;
       updateTotalAllocCounts(site);
+      uint32_t promotedCount = site->nurseryPromotedCount;
       auto result =
           site->processSite(gc, NormalSiteAttentionThreshold, reportFilter);
       if (result == AllocSite::WasPretenured ||
           result == AllocSite::WasPretenuredAndInvalidated) {
         sitesPretenured++;
+        pretenuredSitePromotedCount_ += promotedCount;
         if (site->hasScript()) {
           site->script()->realm()->numAllocSitesPretenured++;
         }
@@ -147,9 +150,15 @@ size_t PretenuringNursery::doPretenuring(GCRuntime* gc, JS::GCReason reason,
       if (site.traceKind() == JS::TraceKind::Object) {
         site.processCatchAllSite(reportFilter);
       } else {
-        site.processSite(gc, UnknownSiteAttentionThreshold, reportFilter);
+        // Result checked in Nursery::doPretenuring, which disables nursery
+        // allocation of this trace kind if the site was pretenured.
+        uint32_t promotedCount = site.nurseryPromotedCount;
+        auto result =
+            site.processSite(gc, UnknownSiteAttentionThreshold, reportFilter);
+        if (result == AllocSite::WasPretenured) {
+          pretenuredSitePromotedCount_ += promotedCount;
+        }
       }
-      // Result checked in Nursery::doPretenuring.
     }
     updateTotalAllocCounts(zone->optimizedAllocSite());
     zone->optimizedAllocSite()->processCatchAllSite(reportFilter);
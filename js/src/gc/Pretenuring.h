@@ -410,6 +410,10 @@ class PretenuringNursery {
 
   uint32_t totalAllocCount_ = 0;
 
+  // Number of cells promoted by the last nursery collection from sites that
+  // switched to tenured allocation as a result of it.
+  uint32_t pretenuredSitePromotedCount_ = 0;
+
  public:
   PretenuringNursery() : allocatedSites(AllocSite::EndSentinel) {}
 
@@ -433,6 +437,9 @@ class PretenuringNursery {
   void maybeStopPretenuring(GCRuntime* gc);
 
   uint32_t totalAllocCount() const { return totalAllocCount_; }
+  uint32_t pretenuredSitePromotedCount() const {
+    return pretenuredSitePromotedCount_;
+  }
 
   void* addressOfAllocatedSites() { return &allocatedSites; }
 
@@ -740,6 +740,18 @@ void Statistics::formatJsonDescription(JSONPrinter& json) const {
   if (removedChunks) {
     json.property("removed_chunks", removedChunks);
   }
+  if (!parallelMarkers.empty()) {
+    json.beginListProperty("parallel_markers");
+    for (const ParallelMarkerData& data : parallelMarkers) {
+      json.beginObject();
+      json.property("mark_time", data.markTime, JSONPrinter::MILLISECONDS);
+      json.property("wait_time", data.waitTime, JSONPrinter::MILLISECONDS);
+      json.property("donations_received", data.donationsReceived);
+      json.property("words_received", data.wordsReceived);
+      json.endObject();
+    }
+    json.endList();
+  }
   json.property("major_gc_number", startingMajorGCNumber);
   json.property("minor_gc_number", startingMinorGCNumber);
   json.property("slice_number", startingSliceNumber);
@@ -999,6 +1011,7 @@ void Statistics::printStats() {
 void Statistics::beginGC(JS::GCOptions options, const TimeStamp& currentTime) {
   slices_.clearAndFree();
   sccTimes.clearAndFree();
+  parallelMarkers.clearAndFree();
   gcOptions = options;
   nonincrementalReason_ = GCAbortReason::None;
 
@@ -1573,6 +1586,28 @@ void Statistics::recordParallelPhase(PhaseKind phaseKind,
   maxTime = std::max(maxTime, duration);
 }
 
+void Statistics::recordParallelMarker(size_t index, TimeDuration markTime,
+                                      TimeDuration waitTime,
+                                      uint32_t donationsReceived,
+                                      size_t wordsReceived) {
+  MOZ_ASSERT(CurrentThreadCanAccessRuntime(gc->rt));
+
+  if (aborted) {
+    return;
+  }
+
+  if (index >= parallelMarkers.length() &&
+      !parallelMarkers.resize(index + 1)) {
+    return;
+  }
+
+  ParallelMarkerData& data = parallelMarkers[index];
+  data.markTime += markTime;
+  data.waitTime += waitTime;
+  data.donationsReceived += donationsReceived;
+  data.wordsReceived += wordsReceived;
+}
+
 TimeStamp Statistics::beginSCC() { return TimeStamp::Now(); }
 
 void Statistics::endSCC(unsigned scc, TimeStamp start) {
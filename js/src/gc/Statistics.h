@@ -162,6 +162,12 @@ struct Statistics {
   void endPhase(PhaseKind phaseKind);
   void recordParallelPhase(PhaseKind phaseKind, TimeDuration duration);
 
+  // Record what one of the parallel markers did during a parallel marking
+  // run. These are summed per marker over the whole GC.
+  void recordParallelMarker(size_t index, TimeDuration markTime,
+                            TimeDuration waitTime, uint32_t donationsReceived,
+                            size_t wordsReceived);
+
   // Occasionally, we may be in the middle of something that is tracked by
   // this class, and we need to do something unusual (eg evict the nursery)
   // that doesn't normally nest within the current phase. Suspend the
@@ -426,6 +432,15 @@ struct Statistics {
   /* Sweep times for SCCs of compartments. */
   Vector<TimeDuration, 0, SystemAllocPolicy> sccTimes;
 
+  /* Per-marker totals for parallel marking, indexed by marker. */
+  struct ParallelMarkerData {
+    TimeDuration markTime;
+    TimeDuration waitTime;
+    uint32_t donationsReceived = 0;
+    size_t wordsReceived = 0;
+  };
+  Vector<ParallelMarkerData, 0, SystemAllocPolicy> parallelMarkers;
+
   TimeDuration timeSinceLastGC;
 
   JS::GCSliceCallback sliceCallback;
@@ -566,6 +566,11 @@ js::jit::JitZone* Zone::createJitZone(JSContext* cx) {
   }
 
   jitZone_ = jitZone.release();
+
+  // There is no code to discard yet, so count from now for the GCs that
+  // take the time since code was last discarded into account.
+  lastDiscardedCodeTime_ = mozilla::TimeStamp::Now();
+
   return jitZone_;
 }
 
@@ -517,8 +517,9 @@ class Zone : public js::ZoneAllocator, public js::gc::GraphNodeBase<JS::Zone> {
   // metadata builder.
   js::MainThreadOrIonCompileData<size_t> numRealmsWithAllocMetadataBuilder_{0};
 
-  // Last time at which JIT code was discarded for this zone. This is only set
-  // when JitScripts and Baseline code are discarded as well.
+  // Last time at which JIT code was discarded for this zone, or at which its
+  // JitZone was created. This is only set when JitScripts and Baseline code
+  // are discarded as well.
   js::MainThreadData<mozilla::TimeStamp> lastDiscardedCodeTime_;
 
   js::MainThreadData<bool> gcScheduled_;
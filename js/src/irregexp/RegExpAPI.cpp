@@ -12,6 +12,7 @@
 
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/Casting.h"
+#include "mozilla/HashFunctions.h"
 
 #include "frontend/FrontendContext.h"  // AutoReportFrontendContext
 #include "frontend/TokenStream.h"
@@ -33,6 +34,7 @@
 #include "js/friend/ErrorMessages.h"  // JSMSG_*
 #include "js/friend/StackLimits.h"    // js::ReportOverRecursed
 #include "util/StringBuilder.h"
+#include "util/Text.h"
 #include "vm/MatchPairs.h"
 #include "vm/PlainObject.h"
 #include "vm/RegExpShared.h"
@@ -507,6 +509,92 @@ class RegExpDepthCheck final : public v8::internal::RegExpVisitor {
   static const size_t FRAME_PADDING = 256;
 };
 
+// The bytecode cache of an isolate holds up to MaxCachedBytecodes entries,
+// none of them larger than MaxCachedBytecodeLength bytes, and evicts the
+// oldest one when it is full.
+static const size_t MaxCachedBytecodes = 64;
+static const uint32_t MaxCachedBytecodeLength = 16 * 1024;
+
+static HashNumber BytecodeCacheHash(JSAtom* pattern, JS::RegExpFlags flags,
+                                    bool isLatin1) {
+  return mozilla::AddToHash(pattern->hash(), flags.value(), isLatin1);
+}
+
+static const Isolate::CachedBytecode* LookupCachedBytecode(
+    Isolate* isolate, JSAtom* pattern, JS::RegExpFlags flags, bool isLatin1) {
+  HashNumber hash = BytecodeCacheHash(pattern, flags, isLatin1);
+  size_t length = pattern->length();
+  JS::AutoCheckCannotGC nogc;
+  for (const Isolate::CachedBytecode& entry : isolate->bytecodeCache()) {
+    if (entry.hash != hash || entry.flags != flags ||
+        entry.isLatin1 != isLatin1 || entry.sourceLength != length) {
+      continue;
+    }
+    bool equal = pattern->hasLatin1Chars()
+                     ? EqualChars(pattern->latin1Chars(nogc),
+                                  entry.source.get(), length)
+                     : EqualChars(pattern->twoByteChars(nogc),
+                                  entry.source.get(), length);
+    if (equal) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+// Caching is an optimization, so this fails silently on OOM.
+static void CacheBytecode(Isolate* isolate, JSAtom* pattern,
+                          JS::RegExpFlags flags, bool isLatin1,
+                          ByteArrayData* bytecode, uint32_t numRegisters) {
+  uint32_t length = bytecode->length();
+  if (length > MaxCachedBytecodeLength) {
+    return;
+  }
+
+  Isolate::CachedBytecode entry;
+  entry.hash = BytecodeCacheHash(pattern, flags, isLatin1);
+  entry.flags = flags;
+  entry.isLatin1 = isLatin1;
+  entry.sourceLength = pattern->length();
+  entry.source.reset(js_pod_malloc<char16_t>(entry.sourceLength));
+  if (!entry.source) {
+    return;
+  }
+  CopyChars(entry.source.get(), *pattern);
+
+  size_t allocSize = sizeof(ByteArrayData) + length;
+  entry.bytecode.reset(static_cast<ByteArrayData*>(js_malloc(allocSize)));
+  if (!entry.bytecode) {
+    return;
+  }
+  memcpy(entry.bytecode.get(), bytecode, allocSize);
+  entry.numRegisters = numRegisters;
+
+  Isolate::BytecodeCache& cache = isolate->bytecodeCache();
+  if (cache.length() == MaxCachedBytecodes) {
+    cache.erase(cache.begin());
+  }
+  (void)cache.append(std::move(entry));
+}
+
+[[nodiscard]] static bool UseCachedBytecode(
+    JSContext* cx, MutableHandleRegExpShared re,
+    const Isolate::CachedBytecode& cached, bool isLatin1) {
+  uint32_t length = cached.bytecode->length();
+  size_t allocSize = sizeof(ByteArrayData) + length;
+  auto* bytecode = static_cast<ByteArrayData*>(js_malloc(allocSize));
+  if (!bytecode) {
+    ReportOutOfMemory(cx);
+    return false;
+  }
+  memcpy(bytecode, cached.bytecode.get(), allocSize);
+
+  re->updateMaxRegisters(cached.numRegisters);
+  re->setByteCode(bytecode, isLatin1);
+  js::AddCellMemory(re, length, MemoryUse::RegExpSharedBytecode);
+  return true;
+}
+
 enum class AssembleResult {
   Success,
   TooLarge,
@@ -632,6 +720,9 @@ enum class AssembleResult {
     uint32_t length = bytecode->length();
     re->setByteCode(bytecode.release(), isLatin1);
     js::AddCellMemory(re, length, MemoryUse::RegExpSharedBytecode);
+
+    CacheBytecode(cx->isolate, pattern, re->getFlags(), isLatin1,
+                  re->getByteCode(isLatin1), result.num_registers);
   }
 
   return AssembleResult::Success;
@@ -836,10 +927,21 @@ bool CompilePattern(JSContext* cx, MutableHandleRegExpShared re,
 
   MOZ_ASSERT(re->kind() == RegExpShared::Kind::RegExp);
 
-  RegExpCompiler compiler(cx->isolate, &zone, data.capture_count, flags,
-                          input->hasLatin1Chars());
-
   bool isLatin1 = input->hasLatin1Chars();
+  bool useNativeCode = codeKind == RegExpShared::CodeKind::Jitcode;
+  MOZ_ASSERT_IF(useNativeCode, IsNativeRegExpEnabled());
+
+  // The bytecode doesn't depend on the zone, so another RegExpShared with
+  // the same source and flags may already have assembled it.
+  if (!useNativeCode) {
+    if (const Isolate::CachedBytecode* cached =
+            LookupCachedBytecode(cx->isolate, pattern, flags, isLatin1)) {
+      return UseCachedBytecode(cx, re, *cached, isLatin1);
+    }
+  }
+
+  RegExpCompiler compiler(cx->isolate, &zone, data.capture_count, flags,
+                          isLatin1);
 
   SampleCharacters(input, compiler);
   data.node = compiler.PreprocessRegExp(&data, isLatin1);
@@ -856,9 +958,6 @@ bool CompilePattern(JSContext* cx, MutableHandleRegExpShared re,
     return false;
   }
 
-  bool useNativeCode = codeKind == RegExpShared::CodeKind::Jitcode;
-  MOZ_ASSERT_IF(useNativeCode, IsNativeRegExpEnabled());
-
   switch (Assemble(cx, &compiler, &data, re, pattern, &zone, useNativeCode,
                    isLatin1)) {
     case AssembleResult::TooLarge:
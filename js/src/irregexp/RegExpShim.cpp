@@ -162,6 +162,12 @@ size_t Isolate::sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const {
 
   size += handleArena_.SizeOfExcludingThis(mallocSizeOf);
   size += uniquePtrArena_.SizeOfExcludingThis(mallocSizeOf);
+
+  size += bytecodeCache_.sizeOfExcludingThis(mallocSizeOf);
+  for (const CachedBytecode& entry : bytecodeCache_) {
+    size += mallocSizeOf(entry.source.get());
+    size += mallocSizeOf(entry.bytecode.get());
+  }
   return size;
 }
 
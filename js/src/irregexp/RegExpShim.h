@@ -1269,6 +1269,25 @@ class Isolate {
   uint32_t liveHandles() const { return handleArena_.Length(); }
   uint32_t livePseudoHandles() const { return uniquePtrArena_.Length(); }
 
+  //********** Bytecode cache **********//
+
+  // The bytecode of recently compiled patterns, which CompilePattern reuses
+  // for the RegExpShareds of other zones, and for the ones that are created
+  // again after a GC discarded theirs. Native code can't be shared this way,
+  // because it lives in the zone of its RegExpShared.
+  struct CachedBytecode {
+    js::HashNumber hash;
+    JS::RegExpFlags flags;
+    bool isLatin1;
+    uint32_t sourceLength;
+    JS::UniqueTwoByteChars source;
+    PseudoHandle<ByteArrayData> bytecode;
+    uint32_t numRegisters;
+  };
+  using BytecodeCache = js::Vector<CachedBytecode, 0, js::SystemAllocPolicy>;
+
+  BytecodeCache& bytecodeCache() { return bytecodeCache_; }
+
  private:
   void openHandleScope(HandleScope& scope) {
     scope.level_ = handleArena_.Length();
@@ -1286,6 +1305,7 @@ class Isolate {
   JSContext* cx_;
   RegExpStack* regexpStack_{};
   Counters counters_{};
+  BytecodeCache bytecodeCache_;
 #ifdef DEBUG
  public:
   uint32_t shouldSimulateInterrupt_ = 0;
@@ -2607,6 +2607,21 @@ void DumpNonAOTICStubAndQuit(CacheKind kind, const CacheIRWriter& writer) {
 }
 #endif
 
+#ifdef ENABLE_JS_AOT_ICS
+static void RecordAOTStub(JSRuntime* rt, CacheKind kind,
+                          const CacheIRWriter& writer) {
+  // This can't report OOM, see AttachBaselineCacheIRStub.
+  auto& stubs = rt->recordedAOTStubs.ref();
+  if (!stubs) {
+    stubs = MakeUnique<RecordedAOTStubs>();
+    if (!stubs) {
+      return;
+    }
+  }
+  stubs->record(kind, writer);
+}
+#endif
+
 static constexpr uint32_t StubDataOffset = sizeof(ICCacheIRStub);
 static_assert(StubDataOffset % sizeof(uint64_t) == 0,
               "Stub fields must be aligned");
@@ -2626,6 +2641,9 @@ static bool LookupOrCompileStub(JSContext* cx, CacheKind kind,
       !jitZone->isIncompleteAOTICs()) {
     DumpNonAOTICStubAndQuit(kind, writer);
   }
+  if (JitOptions.enableAOTICReuse && !stubInfo && !isAOTFill) {
+    RecordAOTStub(cx->runtime(), kind, writer);
+  }
 #endif
 
   if (!code && !IsPortableBaselineInterpreterEnabled()) {
@@ -2863,23 +2881,36 @@ ICAttachResult js::jit::AttachBaselineCacheIRStub(
 #    error AOT ICs are only supported (for now) in PBL builds.
 #  endif
 
+static bool FillAOTIC(JSContext* cx, JitZone* zone,
+                      const CacheIRAOTStub& stub) {
+  CacheIRWriter writer(cx, stub);
+  if (writer.failed()) {
+    zone->setIncompleteAOTICs();
+    return false;
+  }
+  CacheIRStubInfo* stubInfo;
+  JitCode* code;
+  (void)LookupOrCompileStub(cx, stub.kind, writer, stubInfo, code, "aot stub",
+                            /* isAOTFill = */ true, zone);
+  (void)stubInfo;
+  (void)code;
+  return true;
+}
+
 void js::jit::FillAOTICs(JSContext* cx, JitZone* zone) {
   if (JitOptions.enableAOTICs) {
     for (auto& stub : GetAOTStubs()) {
-      CacheIRWriter writer(cx, stub);
-      if (writer.failed()) {
-        zone->setIncompleteAOTICs();
+      if (!FillAOTIC(cx, zone, stub)) {
         break;
       }
-      CacheIRStubInfo* stubInfo;
-      JitCode* code;
-      (void)LookupOrCompileStub(cx, stub.kind, writer, stubInfo, code,
-                                "aot stub",
-                                /* isAOTFill = */ true, zone);
-      (void)stubInfo;
-      (void)code;
     }
   }
+
+  const auto& recorded = cx->runtime()->recordedAOTStubs.ref();
+  if (JitOptions.enableAOTICReuse && recorded) {
+    recorded->forEach(
+        [&](const CacheIRAOTStub& stub) { return FillAOTIC(cx, zone, stub); });
+  }
 }
 #endif
 
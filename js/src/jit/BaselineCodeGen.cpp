@@ -1836,8 +1836,8 @@ bool BaselineInterpreterCodeGen::emitWarmUpCounterIncrement() {
     masm.store32(countReg, numQueuedAddr);
 
     // If the queue is now full, trigger a batch compilation.
-    masm.branch32(Assembler::Below, countReg,
-                  Imm32(JitOptions.baselineQueueCapacity), &done);
+    Address capacityAddr(queueReg, BaselineCompileQueue::offsetOfCapacity());
+    masm.branch32(Assembler::Below, countReg, capacityAddr, &done);
 
     masm.bind(&compileBatch);
     prepareVMCall();
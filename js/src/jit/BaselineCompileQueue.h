@@ -7,6 +7,8 @@
 #ifndef jit_BaselineCompileQueue_h
 #define jit_BaselineCompileQueue_h
 
+#include "mozilla/TimeStamp.h"
+
 #include "gc/Barrier.h"
 #include "jit/JitOptions.h"
 
@@ -21,10 +23,19 @@ class BaselineCompileQueue {
 
  private:
   uint32_t numQueued_ = 0;
+
+  // The number of queued scripts that triggers a batch compilation. This
+  // starts at JitOptions.baselineQueueCapacity and adapts to how fast scripts
+  // warm up, see noteDispatch.
+  uint32_t capacity_ = JitOptions.baselineQueueCapacity;
+
+  mozilla::TimeStamp lastDispatch_;
+
   HeapPtr<JSScript*> queue_[MaxCapacity];
 
  public:
   uint32_t numQueued() const { return numQueued_; }
+  uint32_t capacity() const { return capacity_; }
 
   static constexpr size_t offsetOfQueue() {
     return offsetof(BaselineCompileQueue, queue_);
@@ -32,6 +43,9 @@ class BaselineCompileQueue {
   static constexpr size_t offsetOfNumQueued() {
     return offsetof(BaselineCompileQueue, numQueued_);
   }
+  static constexpr size_t offsetOfCapacity() {
+    return offsetof(BaselineCompileQueue, capacity_);
+  }
 
   JSScript* pop() {
     // To keep our invariants simple, we pop from the end of the queue.
@@ -51,8 +65,8 @@ class BaselineCompileQueue {
     // The queue always contains |numQueued| JSScript* pointers,
     // followed by |Capacity - numQueued| null pointers.
 #ifdef DEBUG
-    MOZ_ASSERT(numQueued_ <= JitOptions.baselineQueueCapacity);
-    MOZ_ASSERT(JitOptions.baselineQueueCapacity <= MaxCapacity);
+    MOZ_ASSERT(numQueued_ <= capacity_);
+    MOZ_ASSERT(capacity_ <= MaxCapacity);
     for (uint32_t i = 0; i < numQueued_; i++) {
       MOZ_ASSERT(queue_[i]);
     }
@@ -63,6 +77,10 @@ class BaselineCompileQueue {
   }
   void trace(JSTracer* trc);
   void remove(JSScript* script);
+
+  // Called after |batchSize| queued scripts were taken off the queue to be
+  // compiled, to adjust the size of the next batch.
+  void noteDispatch(uint32_t batchSize);
 };
 
 }  // namespace jit
@@ -271,6 +271,7 @@ static bool DispatchOffThreadBaselineCompile(JSContext* cx,
 bool jit::DispatchOffThreadBaselineBatch(JSContext* cx) {
   BaselineCompileQueue& queue = cx->realm()->baselineCompileQueue();
   MOZ_ASSERT(queue.numQueued() > 0);
+  uint32_t batchSize = queue.numQueued();
 
   auto alloc = cx->make_unique<LifoAlloc>(TempAllocator::PreferredLifoChunkSize,
                                           js::BackgroundMallocArena);
@@ -326,6 +327,8 @@ bool jit::DispatchOffThreadBaselineBatch(JSContext* cx) {
     snapshots.insertFront(offThreadSnapshot);
   }
 
+  queue.noteDispatch(batchSize);
+
   if (snapshots.isEmpty()) {
     return true;
   }
@@ -698,6 +701,27 @@ void BaselineCompileQueue::trace(JSTracer* trc) {
   }
 }
 
+void BaselineCompileQueue::noteDispatch(uint32_t batchSize) {
+  MOZ_ASSERT(isEmpty());
+
+  // Each batch costs a helper thread task dispatch and an interrupt to link
+  // the results, which dominates when many small scripts warm up at once, for
+  // example while a framework starts. Double the batch size while full
+  // batches follow each other closely, and go back towards the default once
+  // scripts have to be dispatched before the queue fills up.
+  const mozilla::TimeDuration burstInterval =
+      mozilla::TimeDuration::FromMilliseconds(10);
+
+  mozilla::TimeStamp now = mozilla::TimeStamp::Now();
+  uint32_t minCapacity = JitOptions.baselineQueueCapacity;
+  if (batchSize < capacity_) {
+    capacity_ = std::max(capacity_ / 2, minCapacity);
+  } else if (lastDispatch_ && now - lastDispatch_ < burstInterval) {
+    capacity_ = std::min(capacity_ * 2, MaxCapacity);
+  }
+  lastDispatch_ = now;
+}
+
 void BaselineCompileQueue::remove(JSScript* script) {
   assertInvariants();
   for (uint32_t i = 0; i < numQueued_; i++) {
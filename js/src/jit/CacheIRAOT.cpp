@@ -8,6 +8,10 @@
 
 #  include "jit/CacheIRAOT.h"
 
+#  include "mozilla/HashFunctions.h"
+
+#  include <string.h>
+
 #  include "jsmath.h"
 #  include "jstypes.h"
 
@@ -143,4 +147,74 @@ CacheIRWriter::CacheIRWriter(JSContext* cx, const CacheIRAOTStub& stub)
   buffer_.writeBytes(stub.data, stub.dataLength);
 }
 
+js::jit::RecordedAOTStubs::Stub::Stub(CacheKind kind,
+                                      const CacheIRWriter& writer)
+    : kind(kind),
+      numOperandIds(writer.numOperandIds()),
+      numInputOperands(writer.numInputOperands()),
+      numInstructions(writer.numInstructions()),
+      typeData(writer.typeData()),
+      stubDataSize(writer.stubDataSize()) {}
+
+js::jit::CacheIRAOTStub js::jit::RecordedAOTStubs::Stub::aotStub() const {
+  return CacheIRAOTStub{kind,
+                        numOperandIds,
+                        numInputOperands,
+                        numInstructions,
+                        typeData,
+                        stubDataSize,
+                        stubFields.begin(),
+                        stubFields.length(),
+                        operandLastUsed.begin(),
+                        data.begin(),
+                        data.length()};
+}
+
+/* static */
+js::HashNumber js::jit::RecordedAOTStubs::StubHasher::hash(const Lookup& l) {
+  return mozilla::AddToHash(mozilla::HashBytes(l.data, l.length),
+                            uint8_t(l.kind));
+}
+
+/* static */
+bool js::jit::RecordedAOTStubs::StubHasher::match(const Stub* stub,
+                                                  const Lookup& l) {
+  return stub->kind == l.kind && stub->data.length() == l.length &&
+         memcmp(stub->data.begin(), l.data, l.length) == 0;
+}
+
+void js::jit::RecordedAOTStubs::record(CacheKind kind,
+                                      const CacheIRWriter& writer) {
+  if (stubs_.length() >= MaxStubs) {
+    return;
+  }
+
+  StubHasher::Lookup lookup{kind, writer.codeStart(), writer.codeLength()};
+  auto p = set_.lookupForAdd(lookup);
+  if (p) {
+    return;
+  }
+
+  auto stub = MakeUnique<Stub>(kind, writer);
+  if (!stub || !stub->data.append(writer.codeStart(), writer.codeLength())) {
+    return;
+  }
+  for (uint32_t i = 0; i < writer.numStubFields(); i++) {
+    if (!stub->stubFields.append(
+            AOTStubFieldData{writer.stubFieldType(i), 0})) {
+      return;
+    }
+  }
+  for (uint32_t i = 0; i < writer.numOperandIds(); i++) {
+    if (!stub->operandLastUsed.append(writer.operandLastUsed(i))) {
+      return;
+    }
+  }
+
+  if (!stubs_.reserve(stubs_.length() + 1) || !set_.add(p, stub.get())) {
+    return;
+  }
+  stubs_.infallibleAppend(std::move(stub));
+}
+
 #endif /* ENABLE_JS_AOT_ICS */
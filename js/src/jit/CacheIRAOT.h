@@ -11,6 +11,10 @@
 
 #include "jit/CacheIR.h"
 #include "jit/CacheIRWriter.h"
+#include "js/AllocPolicy.h"
+#include "js/HashTable.h"
+#include "js/UniquePtr.h"
+#include "js/Vector.h"
 
 struct JSContext;
 
@@ -41,6 +45,63 @@ struct CacheIRAOTStub {
 mozilla::Span<const CacheIRAOTStub> GetAOTStubs();
 void FillAOTICs(JSContext* cx, JitZone* zone);
 
+// The Baseline CacheIR stub bodies compiled by the zones of a runtime. When
+// JitOptions.enableAOTICReuse is set, FillAOTICs also fills the stub code
+// cache of a new zone with them, so that code loaded again in a new global
+// doesn't have to compile the stubs it used last time.
+//
+// Like the ahead-of-time corpus, this only holds CacheIR: stub field values
+// are not kept.
+class RecordedAOTStubs {
+ public:
+  // Bounds the memory used by the recorded stubs.
+  static constexpr size_t MaxStubs = 4096;
+
+  // Record a stub body unless an identical one was already recorded. Failing
+  // to record one is not an error.
+  void record(CacheKind kind, const CacheIRWriter& writer);
+
+  // Call |f| with each recorded stub, in the order they were recorded, until
+  // it returns false.
+  template <typename F>
+  void forEach(F&& f) const {
+    for (const auto& stub : stubs_) {
+      if (!f(stub->aotStub())) {
+        return;
+      }
+    }
+  }
+
+ private:
+  struct Stub {
+    CacheKind kind;
+    uint32_t numOperandIds;
+    uint32_t numInputOperands;
+    uint32_t numInstructions;
+    TypeData typeData;
+    uint32_t stubDataSize;
+    Vector<AOTStubFieldData, 0, SystemAllocPolicy> stubFields;
+    Vector<uint32_t, 0, SystemAllocPolicy> operandLastUsed;
+    Vector<uint8_t, 0, SystemAllocPolicy> data;
+
+    Stub(CacheKind kind, const CacheIRWriter& writer);
+    CacheIRAOTStub aotStub() const;
+  };
+
+  struct StubHasher {
+    struct Lookup {
+      CacheKind kind;
+      const uint8_t* data;
+      size_t length;
+    };
+    static HashNumber hash(const Lookup& l);
+    static bool match(const Stub* stub, const Lookup& l);
+  };
+
+  Vector<UniquePtr<Stub>, 0, SystemAllocPolicy> stubs_;
+  HashSet<Stub*, StubHasher, SystemAllocPolicy> set_;
+};
+
 }  // namespace jit
 }  // namespace js
 
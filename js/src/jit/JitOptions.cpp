@@ -190,6 +190,10 @@ DefaultJitOptions::DefaultJitOptions() {
 #ifdef ENABLE_JS_AOT_ICS
   SET_DEFAULT(enableAOTICs, false);
   SET_DEFAULT(enableAOTICEnforce, false);
+
+  // Whether new zones reuse the IC bodies compiled by earlier zones of the
+  // same runtime.
+  SET_DEFAULT(enableAOTICReuse, false);
 #endif
 
 #ifdef ENABLE_JS_AOT_ICS_FORCE
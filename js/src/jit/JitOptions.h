@@ -129,6 +129,7 @@ struct DefaultJitOptions {
 #ifdef ENABLE_JS_AOT_ICS
   bool enableAOTICs;
   bool enableAOTICEnforce;
+  bool enableAOTICReuse;
 #endif
 
   // Spectre mitigation flags. Each mitigation has its own flag in order to
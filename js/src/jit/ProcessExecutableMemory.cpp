@@ -592,6 +592,12 @@ static unsigned ProtectionSettingToFlags(ProtectionSetting protection) {
     return false;
   }
   MOZ_RELEASE_ASSERT(p == addr);
+  // The new mapping doesn't inherit the huge page advice. Giving it again lets
+  // the kernel merge it with the neighbouring code pages, so that densely
+  // allocated code can be collapsed into huge pages.
+  if (gc::HugePagesEnabled()) {
+    gc::MarkPagesHuge(addr, bytes);
+  }
   return true;
 #  endif
 }
@@ -913,6 +919,10 @@ size_t js::jit::LikelyAvailableExecutableMemory() {
          AlignBytes(execMemory.bytesAllocated(), 0x100000U);
 }
 
+size_t js::jit::HugePageExecutableBytes() {
+  return gc::HugePagesEnabled() ? execMemory.bytesAllocated() : 0;
+}
+
 bool js::jit::CanLikelyAllocateMoreExecutableMemory() {
   // Use a 8 MB buffer.
   static const size_t BufferSize = 8 * 1024 * 1024;
@@ -99,6 +99,10 @@ extern bool CanLikelyAllocateMoreExecutableMemory();
 // the process allocate executable memory.
 extern size_t LikelyAvailableExecutableMemory();
 
+// Returns the number of bytes of executable memory that asked to be backed by
+// huge pages. Zero unless gc::HugePagesEnabled().
+extern size_t HugePageExecutableBytes();
+
 // Returns whether |p| is stored in the executable code buffer.
 extern bool AddressIsInExecutableMemory(const void* p);
 
@@ -0,0 +1,70 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/HashFunctions.h"
+
+#include <string>
+
+#include "js/String.h"
+#include "jsapi-tests/tests.h"
+#include "vm/JSAtomUtils.h"
+#include "vm/StringType.h"
+
+static std::u16string Repeat(const char16_t* pattern, size_t count) {
+  std::u16string result;
+  for (size_t i = 0; i < count; i++) {
+    result += pattern;
+  }
+  return result;
+}
+
+BEGIN_TEST(testAtomizeRope) {
+  // Ropes hash their characters while being flattened for atomization, which
+  // has to give the same atom as atomizing the flat characters.
+  std::u16string latin1 = Repeat(u"abcé", 300);
+  std::u16string twoByte = Repeat(u"xy€", 400);
+
+  CHECK(checkRope(latin1, latin1));
+  CHECK(checkRope(latin1, twoByte));
+  CHECK(checkRope(twoByte, latin1));
+  CHECK(checkRope(twoByte, twoByte));
+
+  // Ropes built by repeated concatenation, used as property keys.
+  EXEC(
+      "var s = 'left'.repeat(64);"
+      "var o = {};"
+      "for (var i = 0; i < 100; i++) {"
+      "  s += 'right' + i;"
+      "  o[s] = i;"
+      "}"
+      "for (var i = 0; i < 100; i++) {"
+      "  if (o[Object.keys(o)[i]] !== i) throw 'bad key ' + i;"
+      "}");
+
+  return true;
+}
+
+bool checkRope(const std::u16string& left, const std::u16string& right) {
+  JS::Rooted<JSString*> leftStr(
+      cx, JS_NewUCStringCopyN(cx, left.data(), left.length()));
+  CHECK(leftStr);
+  JS::Rooted<JSString*> rightStr(
+      cx, JS_NewUCStringCopyN(cx, right.data(), right.length()));
+  CHECK(rightStr);
+
+  JS::Rooted<JSString*> rope(cx, JS_ConcatStrings(cx, leftStr, rightStr));
+  CHECK(rope);
+  CHECK(rope->isRope());
+
+  std::u16string whole = left + right;
+  JS::Rooted<JSAtom*> atom(cx, js::AtomizeString(cx, rope));
+  CHECK(atom);
+  CHECK_EQUAL(atom->hash(), mozilla::HashString(whole.data(), whole.length()));
+
+  JSString* expected = JS_AtomizeUCStringN(cx, whole.data(), whole.length());
+  CHECK(expected);
+  CHECK_EQUAL(static_cast<JSString*>(atom), expected);
+  return true;
+}
+END_TEST(testAtomizeRope)
@@ -6,6 +6,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include <limits>
+#include <string>
 #include <string.h>
 
 #include "js/Array.h"  // JS::IsArrayObject
@@ -16,6 +17,7 @@
 #include "js/Printf.h"
 #include "js/PropertyAndElement.h"  // JS_GetProperty
 #include "jsapi-tests/tests.h"
+#include "vm/NativeObject.h"  // js::NativeObject
 
 using namespace js;
 
@@ -357,3 +359,148 @@ inline bool TryParse(JSContext* cx, const char (&input)[N],
   return true;
 }
 END_TEST(testParseJSON_reviver)
+
+// The tokenizer scans strings and whitespace a vector block at a time.  Put
+// the characters that end a scan at every offset of the first few blocks.
+BEGIN_TEST(testParseJSON_scanBlocks) {
+  static const size_t MaxLength = 72;
+  char input[MaxLength + 8];
+  char expected[MaxLength + 2];
+
+  for (size_t length = 0; length <= MaxLength; length++) {
+    for (size_t pos = 0; pos <= length; pos++) {
+      // A string with an escaped newline at pos.
+      input[0] = '"';
+      memset(input + 1, 'a', length);
+      memcpy(input + 1 + pos, "\\n", 2);
+      memset(input + 1 + pos + 2, 'b', length - pos);
+      input[length + 3] = '"';
+      memcpy(expected, input + 1, pos);
+      expected[pos] = '\n';
+      memcpy(expected + pos + 1, input + 1 + pos + 2, length - pos);
+      CHECK(ParseString(input, length + 4, expected, length + 1));
+
+      // A string without escapes, ended at pos.
+      input[0] = '"';
+      memset(input + 1, 'c', pos);
+      input[pos + 1] = '"';
+      CHECK(ParseString(input, pos + 2, input + 1, pos));
+
+      // A raw control character at pos.
+      memset(input + 1, 'd', length + 1);
+      input[pos + 1] = '\t';
+      input[length + 2] = '"';
+      bool parsed;
+      JS::RootedValue v(cx);
+      CHECK(Parse(input, length + 3, &parsed, &v));
+      CHECK(!parsed);
+
+      // Whitespace runs before and after a value.
+      static const char whitespace[] = " \t\r\n";
+      for (size_t i = 0; i < length; i++) {
+        input[i] = whitespace[i % 4];
+      }
+      input[pos] = '1';
+      for (size_t i = pos + 1; i <= length; i++) {
+        input[i] = whitespace[i % 4];
+      }
+      CHECK(Parses(input, length + 1));
+    }
+  }
+  return true;
+}
+
+// Parses the JSON text as both a Latin-1 and a two-byte string, the two
+// have to agree on whether it is valid.
+bool Parse(const char* input, size_t length, bool* parsed,
+           JS::MutableHandleValue vp) {
+  JS::Rooted<JSString*> latin1(cx, JS_NewStringCopyN(cx, input, length));
+  CHECK(latin1);
+  *parsed = JS_ParseJSON(cx, latin1, vp);
+  if (!*parsed) {
+    CHECK(JS_IsExceptionPending(cx));
+    JS_ClearPendingException(cx);
+  }
+
+  AutoInflatedString twoByte(cx);
+  twoByte = std::string(input, length).c_str();
+  JS::RootedValue v(cx);
+  if (!JS_ParseJSON(cx, twoByte.chars(), twoByte.length(), &v)) {
+    CHECK(!*parsed);
+    JS_ClearPendingException(cx);
+    return true;
+  }
+  CHECK(*parsed);
+  CHECK_SAME(v, vp);
+  return true;
+}
+
+bool Parses(const char* input, size_t length) {
+  JS::RootedValue v(cx);
+  bool parsed;
+  CHECK(Parse(input, length, &parsed, &v));
+  return parsed;
+}
+
+bool ParseString(const char* input, size_t length, const char* expected,
+                 size_t expectedLength) {
+  JS::RootedValue v(cx);
+  bool parsed;
+  CHECK(Parse(input, length, &parsed, &v));
+  CHECK(parsed);
+  CHECK(v.isString());
+  bool match;
+  CHECK(JS_StringEqualsAscii(cx, v.toString(), expected, expectedLength,
+                             &match));
+  CHECK(match);
+  return true;
+}
+END_TEST(testParseJSON_scanBlocks)
+
+// Objects that reuse the shape of an earlier object with the same keys end up
+// with the shape adding their properties one by one gives, and objects with
+// duplicate or integer keys aren't mistaken for them.
+BEGIN_TEST(testParseJSON_recordShapes) {
+  JS::RootedValue v(cx);
+  CHECK(Parse(cx,
+              "[{\"a\":1,\"b\":2},{\"c\":3},{\"d\":4},{\"e\":5},"
+              "{\"f\":6},{\"a\":7,\"b\":8},{\"a\":9,\"a\":10,\"b\":11},"
+              "{\"a\":12,\"b\":13},{\"a\":14,\"0\":15,\"b\":16}]",
+              &v));
+  CHECK(v.isObject());
+  JS::RootedObject array(cx, &v.toObject());
+
+  JS::RootedObject first(cx, Element(array, 0));
+  CHECK(first);
+  CHECK(Element(array, 5)->shape() == first->shape());
+  CHECK(Element(array, 7)->shape() == first->shape());
+
+  JS::RootedObject duplicate(cx, Element(array, 6));
+  CHECK(duplicate->as<NativeObject>().slotSpan() == 2);
+  CHECK(JS_GetProperty(cx, duplicate, "a", &v));
+  CHECK(v.isInt32(10));
+  JS::RootedObject integer(cx, Element(array, 8));
+  CHECK(JS_GetProperty(cx, integer, "0", &v));
+  CHECK(v.isInt32(15));
+  CHECK(JS_GetProperty(cx, integer, "b", &v));
+  CHECK(v.isInt32(16));
+  return true;
+}
+
+JSObject* Element(JS::HandleObject array, uint32_t index) {
+  JS::RootedValue v(cx);
+  if (!JS_GetElement(cx, array, index, &v) || !v.isObject()) {
+    return nullptr;
+  }
+  return &v.toObject();
+}
+
+template <size_t N>
+inline bool Parse(JSContext* cx, const char (&input)[N],
+                  JS::MutableHandleValue vp) {
+  AutoInflatedString str(cx);
+  str = input;
+  CHECK(JS_ParseJSON(cx, str.chars(), str.length(), vp));
+  return true;
+}
+END_TEST(testParseJSON_recordShapes)
@@ -340,3 +340,94 @@ static bool TestGetBuildId(JS::BuildIdCharVector* buildId) {
   return buildId->append(buildid, sizeof(buildid));
 }
 END_TEST(testStencil_TranscodeBorrowing)
+
+BEGIN_TEST(testStencil_DecodeDelazificationsOnDemand) {
+  JS::SetProcessBuildIdOp(TestGetBuildId);
+
+  {
+    const char* chars =
+        "function f() { return 42; }"
+        "function g() { return 43; }"
+        "f();";
+
+    JS::SourceText<mozilla::Utf8Unit> srcBuf;
+    CHECK(srcBuf.init(cx, chars, strlen(chars), JS::SourceOwnership::Borrowed));
+
+    JS::CompileOptions options(cx);
+    RefPtr<JS::Stencil> stencil =
+        JS::CompileGlobalScriptToStencil(cx, options, srcBuf);
+    CHECK(stencil);
+
+    JS::InstantiateOptions instantiateOptions(options);
+    JS::RootedScript script(
+        cx, JS::InstantiateGlobalStencil(cx, instantiateOptions, stencil));
+    CHECK(script);
+
+    bool alreadyStarted;
+    CHECK(JS::StartCollectingDelazifications(cx, script, stencil,
+                                             alreadyStarted));
+    CHECK(!alreadyStarted);
+
+    JS::RootedValue rval(cx);
+    CHECK(JS_ExecuteScript(cx, script, &rval));
+    CHECK(rval.isNumber() && rval.toNumber() == 42);
+
+    // Encode the initial stencil and the delazification of f.
+    CHECK(JS::FinishCollectingDelazifications(cx, script, buffer));
+  }
+
+  // Create a new global
+  CHECK(createGlobal());
+  JSAutoRealm ar(cx, global);
+
+  JS::DecodeOptions decodeOptions;
+  decodeOptions.borrowBuffer = true;
+  decodeOptions.usePinnedBytecode = true;
+  decodeOptions.decodeDelazificationsOnDemand = true;
+
+  RefPtr<JS::Stencil> stencil;
+  JS::TranscodeRange range(buffer.begin(), buffer.length());
+  JS::TranscodeResult res =
+      JS::DecodeStencil(cx, decodeOptions, range, getter_AddRefs(stencil));
+  CHECK(res == JS::TranscodeResult::Ok);
+
+  // Only f has an encoded delazification, and it's not decoded yet.
+  const size_t fIndex = 1;
+  const size_t gIndex = 2;
+  CHECK(stencil->hasEncodedDelazifications());
+  CHECK(!stencil->getEncodedDelazificationAt(fIndex).IsEmpty());
+  CHECK(stencil->getEncodedDelazificationAt(gIndex).IsEmpty());
+  CHECK(!stencil->getDelazificationAt(fIndex));
+
+  JS::InstantiateOptions instantiateOptions;
+  JS::RootedScript script(
+      cx, JS::InstantiateGlobalStencil(cx, instantiateOptions, stencil));
+  CHECK(script);
+  CHECK(!stencil->getDelazificationAt(fIndex));
+
+  // Calling f decodes its delazification from the buffer.
+  JS::RootedValue rval(cx);
+  CHECK(JS_ExecuteScript(cx, script, &rval));
+  CHECK(rval.isNumber() && rval.toNumber() == 42);
+
+  const js::frontend::CompilationStencil* delazification =
+      stencil->getDelazificationAt(fIndex);
+  CHECK(delazification);
+  CHECK(delazification->storageType ==
+        js::frontend::CompilationStencil::StorageType::Borrowed);
+
+  // g is delazified from the source.
+  EVAL("g()", &rval);
+  CHECK(rval.isNumber() && rval.toNumber() == 43);
+
+  return true;
+}
+
+// The bytecode is pinned, and the buffer has to outlive the runtime.
+JS::TranscodeBuffer buffer;
+
+static bool TestGetBuildId(JS::BuildIdCharVector* buildId) {
+  const char buildid[] = "testXDR";
+  return buildId->append(buildid, sizeof(buildid));
+}
+END_TEST(testStencil_DecodeDelazificationsOnDemand)
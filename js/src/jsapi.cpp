@@ -2635,6 +2635,7 @@ void JS::OwningDecodeOptions::release() {
 bool JS::OwningDecodeOptions::copy(JS::FrontendContext* maybeFc,
                                    const JS::ReadOnlyDecodeOptions& rhs) {
   copyPODOptionsFrom(rhs);
+  decodeDelazificationsOnDemand = rhs.decodeDelazificationsOnDemand;
 
   if (rhs.introducerFilename()) {
     MOZ_ASSERT(maybeFc);
@@ -2652,6 +2653,7 @@ bool JS::OwningDecodeOptions::copy(JS::FrontendContext* maybeFc,
 void JS::OwningDecodeOptions::infallibleCopy(
     const JS::ReadOnlyDecodeOptions& rhs) {
   copyPODOptionsFrom(rhs);
+  decodeDelazificationsOnDemand = rhs.decodeDelazificationsOnDemand;
 
   MOZ_ASSERT(!rhs.introducerFilename());
 }
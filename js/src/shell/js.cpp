@@ -12730,6 +12730,9 @@ bool InitOptionParser(OptionParser& op) {
       !op.addBoolOption(
           '\0', "enforce-aot-ics",
           "Enable enforcing only use of ahead-of-time-known ICs") ||
+      !op.addBoolOption('\0', "reuse-aot-ics",
+                        "Prefill the ICs of new zones with the IC bodies "
+                        "compiled by earlier zones") ||
 #endif
       !op.addIntOption(
           '\0', "baseline-warmup-threshold", "COUNT",
@@ -12910,7 +12913,8 @@ bool InitOptionParser(OptionParser& op) {
           '\0', "delazification-mode", "[option]",
           "Select one of the delazification mode for scripts given on the "
           "command line, valid options are: "
-          "'on-demand', 'concurrent-df', 'eager', 'concurrent-df+on-demand'. "
+          "'on-demand', 'concurrent-df', 'concurrent-parallel', 'eager', "
+          "'concurrent-df+on-demand'. "
           "Choosing 'concurrent-df+on-demand' will run both concurrent-df and "
           "on-demand delazification mode, and compare compilation outcome. ") ||
       !op.addBoolOption('\0', "wasm-compile-and-serialize",
@@ -13316,6 +13320,8 @@ bool SetContextOptions(JSContext* cx, const OptionParser& op) {
     } else if (strcmp(mode, "concurrent-df") == 0) {
       defaultDelazificationMode =
           JS::DelazificationOption::ConcurrentDepthFirst;
+    } else if (strcmp(mode, "concurrent-parallel") == 0) {
+      defaultDelazificationMode = JS::DelazificationOption::ConcurrentParallel;
     } else if (strcmp(mode, "eager") == 0) {
       defaultDelazificationMode =
           JS::DelazificationOption::ParseEverythingEagerly;
@@ -13692,6 +13698,9 @@ bool SetContextJITOptions(JSContext* cx, const OptionParser& op) {
   if (op.getBoolOption("enforce-aot-ics")) {
     jit::JitOptions.enableAOTICEnforce = true;
   }
+  if (op.getBoolOption("reuse-aot-ics")) {
+    jit::JitOptions.enableAOTICReuse = true;
+  }
 #endif
 
   if (op.getBoolOption("blinterp")) {
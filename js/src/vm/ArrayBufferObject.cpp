@@ -157,8 +157,14 @@ static Atomic<uint64_t, mozilla::ReleaseAcquire> wasmReservedBytes(0);
 // The number of bytes of wasm memory reserved since the last GC trigger.
 static Atomic<uint64_t, mozilla::ReleaseAcquire> wasmReservedBytesSinceLast(0);
 
+// The number of committed bytes of wasm memories that asked to be backed by
+// huge pages, see gc::HugePagesEnabled.
+static Atomic<uint64_t, mozilla::ReleaseAcquire> wasmHugePageBytes(0);
+
 uint64_t js::WasmReservedBytes() { return wasmReservedBytes; }
 
+uint64_t js::WasmHugePageBytes() { return wasmHugePageBytes; }
+
 [[nodiscard]] static bool CheckArrayBufferTooLarge(JSContext* cx,
                                                    uint64_t nbytes) {
   // Refuse to allocate too large buffers.
@@ -227,6 +233,13 @@ void* js::MapBufferMemory(wasm::AddressType t, size_t mappedSize,
     return nullptr;
   }
 
+  // Advise the whole reservation, the advice survives the mprotect calls that
+  // commit more of it when the memory grows.
+  if (gc::HugePagesEnabled()) {
+    gc::MarkPagesHuge(data, mappedSize);
+    wasmHugePageBytes += uint64_t(initialCommittedSize);
+  }
+
   gc::RecordMemoryAlloc(initialCommittedSize);
 #endif  // !XP_WIN && !__wasi__
 
@@ -256,6 +269,9 @@ bool js::CommitBufferMemory(void* dataEnd, size_t delta) {
   if (mprotect(dataEnd, delta, PROT_READ | PROT_WRITE)) {
     return false;
   }
+  if (gc::HugePagesEnabled()) {
+    wasmHugePageBytes += uint64_t(delta);
+  }
 #endif  // XP_WIN
 
   gc::RecordMemoryAlloc(delta);
@@ -282,6 +298,9 @@ void js::UnmapBufferMemory(wasm::AddressType t, void* base, size_t mappedSize,
 #else
   munmap(base, mappedSize);
   gc::RecordMemoryFree(committedSize);
+  if (gc::HugePagesEnabled()) {
+    wasmHugePageBytes -= uint64_t(committedSize);
+  }
 #endif  // XP_WIN
 
 #if defined(MOZ_VALGRIND) && \
@@ -1582,6 +1601,10 @@ void WasmArrayRawBuffer::discard(size_t byteOffset, size_t byteLen) {
   if (data == MAP_FAILED) {
     MOZ_CRASH("failed to discard wasm memory; memory mappings may be broken");
   }
+  // The new mapping doesn't inherit the huge page advice.
+  if (gc::HugePagesEnabled()) {
+    gc::MarkPagesHuge(addr, byteLen);
+  }
 #endif
 }
 
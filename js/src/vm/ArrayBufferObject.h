@@ -55,6 +55,10 @@ void UnmapBufferMemory(wasm::AddressType t, void* dataStart, size_t mappedSize,
 // Return the number of bytes currently reserved for WebAssembly memory
 uint64_t WasmReservedBytes();
 
+// Return the number of committed bytes of WebAssembly memory that asked to be
+// backed by huge pages.  Zero unless gc::HugePagesEnabled().
+uint64_t WasmHugePageBytes();
+
 // The inheritance hierarchy for the various classes relating to typed arrays
 // is as follows.
 //
@@ -170,21 +170,8 @@ static bool FinishCollectingDelazifications(JSContext* cx,
   sso->unsetCollectingDelazifications();
 
   AutoReportFrontendContext fc(cx);
-  UniquePtr<frontend::CompilationStencil> stencilHolder;
-  const frontend::CompilationStencil* stencil;
-
-  if (stencils->canLazilyParse()) {
-    stencilHolder.reset(stencils->getMerged(&fc));
-    if (!stencilHolder) {
-      return false;
-    }
-    stencil = stencilHolder.get();
-  } else {
-    stencil = stencils->getInitial();
-  }
-
   XDRStencilEncoder encoder(&fc, buffer);
-  XDRResult res = encoder.codeStencil(sso->source(), *stencil);
+  XDRResult res = encoder.codeStencils(sso->source(), *stencils);
   if (res.isErr()) {
     if (JS::IsTranscodeFailureResult(res.unwrapErr())) {
       fc.clearAutoReport();
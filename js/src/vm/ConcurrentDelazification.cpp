@@ -48,6 +48,10 @@ bool DelazifyStrategy::add(FrontendContext* fc,
     }
 
     ScriptIndex innerScriptIndex = index.toFunction();
+    if (innerScriptIndex < rangeBegin_ || innerScriptIndex >= rangeEnd_) {
+      continue;
+    }
+
     ScriptStencilRef innerScriptRef{stencil, innerScriptIndex};
     if (innerScriptRef.scriptData().isGhost() ||
         !innerScriptRef.scriptData().functionFlags.isInterpreted()) {
@@ -141,9 +145,62 @@ bool LargeFirstDelazification::insert(ScriptIndex index,
   return true;
 }
 
+bool js::SplitAtTopLevelFunctions(
+    const frontend::CompilationStencil& initial, size_t maxParts,
+    Vector<DelazificationRange, 0, SystemAllocPolicy>& ranges) {
+  using namespace js::frontend;
+  MOZ_ASSERT(maxParts > 0);
+
+  ScriptStencilRef topLevel{initial, ScriptIndex(0)};
+  size_t offset = topLevel.scriptData().gcThingsOffset.index;
+  size_t length = topLevel.scriptData().gcThingsLength;
+  auto gcThingData = initial.gcThingData.Subspan(offset, length);
+
+  // The top-level functions, in source order, with their source length.
+  Vector<std::pair<ScriptIndex, uint32_t>, 0, SystemAllocPolicy> functions;
+  uint64_t totalLength = 0;
+  for (TaggedScriptThingIndex index : gcThingData) {
+    if (!index.isFunction()) {
+      continue;
+    }
+
+    ScriptIndex scriptIndex = index.toFunction();
+    const SourceExtent& extent = initial.scriptExtra[scriptIndex].extent;
+    uint32_t sourceLength = extent.sourceEnd - extent.sourceStart;
+    if (!functions.append(std::pair(scriptIndex, sourceLength))) {
+      return false;
+    }
+    totalLength += sourceLength;
+  }
+
+  if (functions.empty()) {
+    return true;
+  }
+
+  // Cut the ranges at the first function starting after each multiple of
+  // totalLength / maxParts.  The last range extends to the end of the script
+  // stencils, including the inner functions of the last top-level function.
+  ScriptIndex begin = functions[0].first;
+  uint64_t cumulatedLength = 0;
+  for (const auto& [scriptIndex, sourceLength] : functions) {
+    uint64_t threshold = totalLength * (ranges.length() + 1) / maxParts;
+    if (scriptIndex != begin && cumulatedLength >= threshold) {
+      if (!ranges.append(DelazificationRange(begin, scriptIndex))) {
+        return false;
+      }
+      begin = scriptIndex;
+    }
+    cumulatedLength += sourceLength;
+  }
+
+  return ranges.append(
+      DelazificationRange(begin, ScriptIndex(initial.scriptData.size())));
+}
+
 bool DelazificationContext::init(
     const JS::ReadOnlyCompileOptions& options,
-    frontend::InitialStencilAndDelazifications* stencils) {
+    frontend::InitialStencilAndDelazifications* stencils,
+    const mozilla::Maybe<DelazificationRange>& range) {
   using namespace js::frontend;
 
   stencils_ = stencils;
@@ -180,6 +237,13 @@ bool DelazificationContext::init(
       // largest function first.
       strategy_ = fc_.getAllocator()->make_unique<LargeFirstDelazification>();
       break;
+    case JS::DelazificationOption::ConcurrentParallel:
+      // ConcurrentParallel visit the functions of one range of top-level
+      // functions the same way as ConcurrentDepthFirst, the other ranges
+      // being visited by other tasks.
+      MOZ_ASSERT(range);
+      strategy_ = fc_.getAllocator()->make_unique<DepthFirstDelazification>();
+      break;
     case JS::DelazificationOption::ParseEverythingEagerly:
       // ParseEverythingEagerly parse all functions eagerly, thus leaving no
       // functions to be parsed on demand.
@@ -192,6 +256,10 @@ bool DelazificationContext::init(
     return false;
   }
 
+  if (range) {
+    strategy_->setRange(range->first, range->second);
+  }
+
   // Queue functions from the top-level to be delazify.
   BorrowingCompilationStencil borrow(merger_.getResult());
   ScriptIndex topLevel{0};
@@ -7,9 +7,11 @@
 #ifndef vm_ConcurrentDelazification_h
 #define vm_ConcurrentDelazification_h
 
+#include "mozilla/Maybe.h"            // mozilla::Maybe
 #include "mozilla/MemoryReporting.h"  // mozilla::MallocSizeOf
 
 #include <stddef.h>  // size_t
+#include <stdint.h>  // UINT32_MAX
 #include <utility>   // std::pair
 
 #include "frontend/CompilationStencil.h"  // frontend::{InitialStencilAndDelazifications, CompilationStencil, ScriptStencilRef, CompilationStencilMerger}
@@ -63,8 +65,34 @@ struct DelazifyStrategy {
   [[nodiscard]] bool add(FrontendContext* fc,
                          const frontend::CompilationStencil& stencil,
                          ScriptIndex index);
+
+  // Restrict the functions added by `add` to the ones whose ScriptIndex is in
+  // [begin, end).
+  //
+  // Inner functions are indexed right after their enclosing function, thus a
+  // range starting and ending at top-level function boundaries contains all
+  // the inner functions of the top-level functions it contains.
+  void setRange(ScriptIndex begin, ScriptIndex end) {
+    rangeBegin_ = begin;
+    rangeEnd_ = end;
+  }
+
+ private:
+  ScriptIndex rangeBegin_{0};
+  ScriptIndex rangeEnd_{UINT32_MAX};
 };
 
+// A range of ScriptIndex, see DelazifyStrategy::setRange.
+using DelazificationRange =
+    std::pair<frontend::ScriptIndex, frontend::ScriptIndex>;
+
+// Split the top-level functions of the initial stencil in at most `maxParts`
+// consecutive ranges of similar source length, each of them to be delazified
+// by its own task with the ConcurrentParallel strategy.
+[[nodiscard]] bool SplitAtTopLevelFunctions(
+    const frontend::CompilationStencil& initial, size_t maxParts,
+    Vector<DelazificationRange, 0, SystemAllocPolicy>& ranges);
+
 // Delazify all functions using a Depth First traversal of the function-tree
 // ordered, where each functions is visited in source-order.
 //
@@ -128,7 +156,8 @@ class DelazificationContext {
         stackQuota_(stackQuota) {}
 
   bool init(const JS::ReadOnlyCompileOptions& options,
-            frontend::InitialStencilAndDelazifications* stencils);
+            frontend::InitialStencilAndDelazifications* stencils,
+            const mozilla::Maybe<DelazificationRange>& range);
   bool delazify();
 
   // This function is called by `delazify` function to know whether the
@@ -541,16 +541,21 @@ struct DelazifyTask : public mozilla::LinkedListElement<DelazifyTask>,
   // In case of early failure, no errors are reported, as a DelazifyTask is an
   // optimization and the VM should remain working even without this
   // optimization in place.
+  //
+  // When `range` is set, only the functions in this range are delazified, see
+  // DelazifyStrategy::setRange.
   static UniquePtr<DelazifyTask> Create(
       JSRuntime* maybeRuntime, const JS::ReadOnlyCompileOptions& options,
-      frontend::InitialStencilAndDelazifications* stencils);
+      frontend::InitialStencilAndDelazifications* stencils,
+      const mozilla::Maybe<DelazificationRange>& range);
 
   DelazifyTask(JSRuntime* maybeRuntime,
                const JS::PrefableCompileOptions& initialPrefableOptions);
   ~DelazifyTask();
 
   [[nodiscard]] bool init(const JS::ReadOnlyCompileOptions& options,
-                          frontend::InitialStencilAndDelazifications* stencils);
+                          frontend::InitialStencilAndDelazifications* stencils,
+                          const mozilla::Maybe<DelazificationRange>& range);
 
   bool runtimeMatchesOrNoRuntime(JSRuntime* rt) {
     return !maybeRuntime || maybeRuntime == rt;
@@ -36,6 +36,9 @@
 
 using namespace js;
 
+using mozilla::Maybe;
+using mozilla::Nothing;
+using mozilla::Some;
 using mozilla::TimeDuration;
 
 static void CancelOffThreadWasmCompleteTier2GeneratorLocked(
@@ -1249,6 +1252,45 @@ void GlobalHelperThreadState::submitTask(
   dispatch(locked);
 }
 
+// Maximum number of tasks a script is split into by the ConcurrentParallel
+// strategy. Beyond this, the tasks of one script would compete with the tasks
+// of the other scripts being loaded.
+static constexpr size_t MaxParallelDelazifyTasks = 8;
+
+static void StartOffThreadParallelDelazification(
+    JSRuntime* maybeRuntime, const JS::ReadOnlyCompileOptions& options,
+    frontend::InitialStencilAndDelazifications* stencils) {
+  // Split the script at top-level function boundaries, using the functions
+  // found by the initial syntax-only parse, and delazify each range on its own
+  // helper thread. All tasks record their results in the same `stencils`,
+  // which is shared with the main thread.
+  size_t maxParts =
+      std::clamp(GetHelperThreadCount(), size_t(1), MaxParallelDelazifyTasks);
+  Vector<DelazificationRange, 0, SystemAllocPolicy> ranges;
+  if (!SplitAtTopLevelFunctions(*stencils->getInitial(), maxParts, ranges)) {
+    return;
+  }
+
+  Vector<UniquePtr<DelazifyTask>, 0, SystemAllocPolicy> tasks;
+  for (const DelazificationRange& range : ranges) {
+    UniquePtr<DelazifyTask> task =
+        DelazifyTask::Create(maybeRuntime, options, stencils, Some(range));
+    if (!task) {
+      // The functions of this range are delazified on-demand.
+      continue;
+    }
+    if (!task->done() && !tasks.append(std::move(task))) {
+      return;
+    }
+  }
+
+  // Schedule all tasks at once, to let them start in parallel.
+  AutoLockHelperThreadState lock;
+  for (UniquePtr<DelazifyTask>& task : tasks) {
+    HelperThreadState().submitTask(task.release(), lock);
+  }
+}
+
 void js::StartOffThreadDelazification(
     JSContext* maybeCx, const JS::ReadOnlyCompileOptions& options,
     frontend::InitialStencilAndDelazifications* stencils) {
@@ -1269,8 +1311,14 @@ void js::StartOffThreadDelazification(
   }
 
   JSRuntime* maybeRuntime = maybeCx ? maybeCx->runtime() : nullptr;
+
+  if (strategy == JS::DelazificationOption::ConcurrentParallel) {
+    StartOffThreadParallelDelazification(maybeRuntime, options, stencils);
+    return;
+  }
+
   UniquePtr<DelazifyTask> task;
-  task = DelazifyTask::Create(maybeRuntime, options, stencils);
+  task = DelazifyTask::Create(maybeRuntime, options, stencils, Nothing());
   if (!task) {
     return;
   }
@@ -1284,14 +1332,15 @@ void js::StartOffThreadDelazification(
 
 UniquePtr<DelazifyTask> DelazifyTask::Create(
     JSRuntime* maybeRuntime, const JS::ReadOnlyCompileOptions& options,
-    frontend::InitialStencilAndDelazifications* stencils) {
+    frontend::InitialStencilAndDelazifications* stencils,
+    const Maybe<DelazificationRange>& range) {
   UniquePtr<DelazifyTask> task;
   task.reset(js_new<DelazifyTask>(maybeRuntime, options.prefableOptions()));
   if (!task) {
     return nullptr;
   }
 
-  if (!task->init(options, stencils)) {
+  if (!task->init(options, stencils, range)) {
     // In case of errors, skip this and delazify on-demand.
     return nullptr;
   }
@@ -1313,8 +1362,9 @@ DelazifyTask::~DelazifyTask() {
 }
 
 bool DelazifyTask::init(const JS::ReadOnlyCompileOptions& options,
-                        frontend::InitialStencilAndDelazifications* stencils) {
-  return delazificationCx.init(options, stencils);
+                        frontend::InitialStencilAndDelazifications* stencils,
+                        const Maybe<DelazificationRange>& range) {
+  return delazificationCx.init(options, stencils, range);
 }
 
 size_t DelazifyTask::sizeOfExcludingThis(
@@ -705,7 +705,17 @@ JSAtom* js::AtomizeStringSlow(JSContext* cx, JSString* str) {
     atom = AtomizeAndCopyChars(cx, key.value().string_, key.value().length_,
                                indexValue, mozilla::Some(key.value().hash_));
   } else {
-    JSLinearString* linear = str->ensureLinear(cx);
+    // Compute the hash of ropes while flattening them, instead of reading the
+    // flattened characters a second time.
+    Maybe<HashNumber> hash;
+    JSLinearString* linear;
+    if (str->isRope()) {
+      HashNumber ropeHash;
+      linear = str->asRope().flattenAndHash(cx, &ropeHash);
+      hash.emplace(ropeHash);
+    } else {
+      linear = &str->asLinear();
+    }
     if (!linear) {
       return nullptr;
     }
@@ -713,9 +723,9 @@ JSAtom* js::AtomizeStringSlow(JSContext* cx, JSString* str) {
     JS::AutoCheckCannotGC nogc;
     atom = linear->hasLatin1Chars()
                ? AtomizeAndCopyChars(cx, linear->latin1Chars(nogc),
-                                     linear->length(), indexValue, Nothing())
+                                     linear->length(), indexValue, hash)
                : AtomizeAndCopyChars(cx, linear->twoByteChars(nogc),
-                                     linear->length(), indexValue, Nothing());
+                                     linear->length(), indexValue, hash);
   }
 
   if (!atom) {
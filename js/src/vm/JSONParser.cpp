@@ -6,10 +6,12 @@
 
 #include "vm/JSONParser.h"
 
-#include "mozilla/Assertions.h"  // MOZ_ASSERT
-#include "mozilla/Attributes.h"  // MOZ_STACK_CLASS
-#include "mozilla/Range.h"       // mozilla::Range
-#include "mozilla/RangedPtr.h"   // mozilla::RangedPtr
+#include "mozilla/Assertions.h"      // MOZ_ASSERT
+#include "mozilla/Attributes.h"      // MOZ_STACK_CLASS
+#include "mozilla/HashFunctions.h"   // mozilla::{AddToHash,HashGeneric}
+#include "mozilla/MathAlgorithms.h"  // mozilla::CountTrailingZeroes64
+#include "mozilla/Range.h"           // mozilla::Range
+#include "mozilla/RangedPtr.h"       // mozilla::RangedPtr
 
 #include "mozilla/Sprintf.h"    // SprintfLiteral
 #include "mozilla/TextUtils.h"  // mozilla::AsciiAlphanumericToNumber, mozilla::IsAsciiDigit, mozilla::IsAsciiHexDigit
@@ -18,6 +20,15 @@
 #include <stdint.h>  // uint32_t
 #include <utility>   // std::move
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define JSON_SCAN_SSE2
+#  include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#  define JSON_SCAN_NEON
+#  include <arm_neon.h>
+#endif
+
 #include "jsnum.h"  // ParseDecimalNumber, GetFullInteger, FullStringToDouble
 
 #include "builtin/Array.h"              // NewDenseCopiedArray
@@ -44,8 +55,9 @@
 #include "vm/ErrorReporting.h"   // ReportCompileErrorLatin1, ErrorMetadata
 #include "vm/JSAtomUtils.h"      // AtomizeChars
 #include "vm/JSContext.h"        // JSContext
-#include "vm/PlainObject.h"  // NewPlainObjectWithMaybeDuplicateKeys, NewPlainObjectWithProto
+#include "vm/PlainObject.h"  // NewPlainObjectWithMaybeDuplicateKeys, NewPlainObjectWithProto, NewPlainObjectWithShapeAndValues
 #include "vm/Realm.h"  // JS::Realm
+#include "vm/Shape.h"  // Shape, SharedShape
 #include "vm/StringType.h"  // JSString, JSAtom, JSLinearString, NewStringCopyN, NameToId
 
 #include "vm/JSAtomUtils-inl.h"  // AtomToId
@@ -83,21 +95,182 @@ static inline bool IsJSONWhitespace(char16_t c) {
   return c == '\t' || c == '\r' || c == '\n' || c == ' ';
 }
 
-template <typename CharT, typename ParserT>
-bool JSONTokenizer<CharT, ParserT>::consumeTrailingWhitespaces() {
-  for (; current < end; current++) {
-    if (!IsJSONWhitespace(*current)) {
-      return false;
+static inline bool IsStringLiteralStop(char16_t c) {
+  return c == '"' || c == '\\' || c <= 0x001F;
+}
+
+/*
+ * Strings and whitespace are scanned a vector register at a time where SSE2
+ * or NEON is available.  Each block function returns a mask with the bits of
+ * every character that ends the scan set, ScanMaskBits bits per byte of the
+ * block, so the first such character is found by counting trailing zeroes.
+ */
+#if defined(JSON_SCAN_SSE2)
+
+static constexpr size_t ScanBlockBytes = 16;
+static constexpr size_t ScanMaskBits = 1;
+
+static inline uint64_t StringStopMask(const Latin1Char* p) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  // Characters at or below 0x1F saturate to zero.
+  __m128i control = _mm_cmpeq_epi8(_mm_subs_epu8(v, _mm_set1_epi8(0x1F)),
+                                   _mm_setzero_si128());
+  __m128i stop = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                   _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+      control);
+  return uint32_t(_mm_movemask_epi8(stop));
+}
+
+static inline uint64_t StringStopMask(const char16_t* p) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  __m128i control = _mm_cmpeq_epi16(_mm_subs_epu16(v, _mm_set1_epi16(0x1F)),
+                                    _mm_setzero_si128());
+  __m128i stop = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi16(v, _mm_set1_epi16('"')),
+                   _mm_cmpeq_epi16(v, _mm_set1_epi16('\\'))),
+      control);
+  return uint32_t(_mm_movemask_epi8(stop));
+}
+
+static inline uint64_t WhitespaceStopMask(const Latin1Char* p) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  __m128i ws = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                   _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))),
+      _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')),
+                   _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))));
+  return uint32_t(_mm_movemask_epi8(ws)) ^ 0xFFFF;
+}
+
+static inline uint64_t WhitespaceStopMask(const char16_t* p) {
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  __m128i ws = _mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi16(v, _mm_set1_epi16(' ')),
+                   _mm_cmpeq_epi16(v, _mm_set1_epi16('\n'))),
+      _mm_or_si128(_mm_cmpeq_epi16(v, _mm_set1_epi16('\r')),
+                   _mm_cmpeq_epi16(v, _mm_set1_epi16('\t'))));
+  return uint32_t(_mm_movemask_epi8(ws)) ^ 0xFFFF;
+}
+
+#elif defined(JSON_SCAN_NEON)
+
+static constexpr size_t ScanBlockBytes = 16;
+static constexpr size_t ScanMaskBits = 4;
+
+// NEON has no movemask, narrowing by four bits per byte is the cheapest way
+// to get a scalar mask out of a comparison.
+static inline uint64_t NarrowMask(uint8x16_t stop) {
+  uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(stop), 4);
+  return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+static inline uint64_t NarrowMask(uint16x8_t stop) {
+  return NarrowMask(vreinterpretq_u8_u16(stop));
+}
+
+static inline uint64_t StringStopMask(const Latin1Char* p) {
+  uint8x16_t v = vld1q_u8(p);
+  return NarrowMask(
+      vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8('"')),
+                        vceqq_u8(v, vdupq_n_u8('\\'))),
+               vcltq_u8(v, vdupq_n_u8(0x20))));
+}
+
+static inline uint64_t StringStopMask(const char16_t* p) {
+  uint16x8_t v = vld1q_u16(reinterpret_cast<const uint16_t*>(p));
+  return NarrowMask(
+      vorrq_u16(vorrq_u16(vceqq_u16(v, vdupq_n_u16('"')),
+                          vceqq_u16(v, vdupq_n_u16('\\'))),
+                vcltq_u16(v, vdupq_n_u16(0x20))));
+}
+
+static inline uint64_t WhitespaceStopMask(const Latin1Char* p) {
+  uint8x16_t v = vld1q_u8(p);
+  uint8x16_t ws = vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')),
+                                    vceqq_u8(v, vdupq_n_u8('\n'))),
+                           vorrq_u8(vceqq_u8(v, vdupq_n_u8('\r')),
+                                    vceqq_u8(v, vdupq_n_u8('\t'))));
+  return NarrowMask(vmvnq_u8(ws));
+}
+
+static inline uint64_t WhitespaceStopMask(const char16_t* p) {
+  uint16x8_t v = vld1q_u16(reinterpret_cast<const uint16_t*>(p));
+  uint16x8_t ws = vorrq_u16(vorrq_u16(vceqq_u16(v, vdupq_n_u16(' ')),
+                                      vceqq_u16(v, vdupq_n_u16('\n'))),
+                            vorrq_u16(vceqq_u16(v, vdupq_n_u16('\r')),
+                                      vceqq_u16(v, vdupq_n_u16('\t'))));
+  return NarrowMask(vmvnq_u16(ws));
+}
+
+#endif
+
+#if defined(JSON_SCAN_SSE2) || defined(JSON_SCAN_NEON)
+template <typename CharT>
+static inline size_t FirstStop(uint64_t mask) {
+  MOZ_ASSERT(mask);
+  return mozilla::CountTrailingZeroes64(mask) / (ScanMaskBits * sizeof(CharT));
+}
+#endif
+
+// The number of characters at the start of [start, end) that a string literal
+// holds as they are, i.e. up to the next '"', '\\' or control character.
+template <typename CharT>
+static inline size_t CountPlainStringChars(const CharT* start,
+                                           const CharT* end) {
+  const CharT* p = start;
+#if defined(JSON_SCAN_SSE2) || defined(JSON_SCAN_NEON)
+  constexpr size_t blockLength = ScanBlockBytes / sizeof(CharT);
+  for (; size_t(end - p) >= blockLength; p += blockLength) {
+    if (uint64_t mask = StringStopMask(p)) {
+      return (p - start) + FirstStop<CharT>(mask);
     }
   }
-  return true;
+#endif
+  while (p < end && !IsStringLiteralStop(*p)) {
+    p++;
+  }
+  return p - start;
+}
+
+// The number of JSON whitespace characters at the start of [start, end).
+template <typename CharT>
+static inline size_t CountJSONWhitespace(const CharT* start,
+                                         const CharT* end) {
+  const CharT* p = start;
+#if defined(JSON_SCAN_SSE2) || defined(JSON_SCAN_NEON)
+  constexpr size_t blockLength = ScanBlockBytes / sizeof(CharT);
+  for (; size_t(end - p) >= blockLength; p += blockLength) {
+    if (uint64_t mask = WhitespaceStopMask(p)) {
+      return (p - start) + FirstStop<CharT>(mask);
+    }
+  }
+#endif
+  while (p < end && IsJSONWhitespace(*p)) {
+    p++;
+  }
+  return p - start;
 }
 
 template <typename CharT, typename ParserT>
-JSONToken JSONTokenizer<CharT, ParserT>::advance() {
-  while (current < end && IsJSONWhitespace(*current)) {
+inline void JSONTokenizer<CharT, ParserT>::skipWhitespace() {
+  // Compact JSON has no whitespace between tokens; don't pay for a block
+  // load in that case.
+  if (current < end && IsJSONWhitespace(*current)) {
     current++;
+    current += CountJSONWhitespace(current.get(), end.get());
   }
+}
+
+template <typename CharT, typename ParserT>
+bool JSONTokenizer<CharT, ParserT>::consumeTrailingWhitespaces() {
+  skipWhitespace();
+  return current == end;
+}
+
+template <typename CharT, typename ParserT>
+JSONToken JSONTokenizer<CharT, ParserT>::advance() {
+  skipWhitespace();
   if (current >= end) {
     error("unexpected end of data");
     return token(JSONToken::Error);
@@ -189,9 +362,7 @@ template <typename CharT, typename ParserT>
 JSONToken JSONTokenizer<CharT, ParserT>::advancePropertyName() {
   MOZ_ASSERT(current[-1] == ',');
 
-  while (current < end && IsJSONWhitespace(*current)) {
-    current++;
-  }
+  skipWhitespace();
   if (current >= end) {
     error("end of data when property name was expected");
     return token(JSONToken::Error);
@@ -209,9 +380,7 @@ template <typename CharT, typename ParserT>
 JSONToken JSONTokenizer<CharT, ParserT>::advancePropertyColon() {
   MOZ_ASSERT(current[-1] == '"');
 
-  while (current < end && IsJSONWhitespace(*current)) {
-    current++;
-  }
+  skipWhitespace();
   if (current >= end) {
     error("end of data after property name when ':' was expected");
     return token(JSONToken::Error);
@@ -247,9 +416,7 @@ template <typename CharT, typename ParserT>
 JSONToken JSONTokenizer<CharT, ParserT>::advanceAfterProperty() {
   AssertPastValue(current);
 
-  while (current < end && IsJSONWhitespace(*current)) {
-    current++;
-  }
+  skipWhitespace();
   if (current >= end) {
     error("end of data after property value in object");
     return token(JSONToken::Error);
@@ -273,9 +440,7 @@ template <typename CharT, typename ParserT>
 JSONToken JSONTokenizer<CharT, ParserT>::advanceAfterObjectOpen() {
   MOZ_ASSERT(current[-1] == '{');
 
-  while (current < end && IsJSONWhitespace(*current)) {
-    current++;
-  }
+  skipWhitespace();
   if (current >= end) {
     error("end of data while reading object contents");
     return token(JSONToken::Error);
@@ -298,9 +463,7 @@ template <typename CharT, typename ParserT>
 JSONToken JSONTokenizer<CharT, ParserT>::advanceAfterArrayElement() {
   AssertPastValue(current);
 
-  while (current < end && IsJSONWhitespace(*current)) {
-    current++;
-  }
+  skipWhitespace();
   if (current >= end) {
     error("end of data when ',' or ']' was expected");
     return token(JSONToken::Error);
@@ -370,17 +533,14 @@ JSONToken JSONTokenizer<CharT, ParserT>::readString() {
    * string directly from the source text.
    */
   CharPtr start = current;
-  for (; current < end; current++) {
+  current += CountPlainStringChars(current.get(), end.get());
+  if (current < end) {
     if (*current == '"') {
       size_t length = current - start;
       current++;
       return stringToken<ST>(start, length);
     }
 
-    if (*current == '\\') {
-      break;
-    }
-
     if (*current <= 0x001F) {
       error("bad control character in string literal");
       return token(JSONToken::Error);
@@ -481,11 +641,7 @@ JSONToken JSONTokenizer<CharT, ParserT>::readString() {
     }
 
     start = current;
-    for (; current < end; current++) {
-      if (*current == '"' || *current == '\\' || *current <= 0x001F) {
-        break;
-      }
-    }
+    current += CountPlainStringChars(current.get(), end.get());
   } while (current < end);
 
   error("unterminated string");
@@ -619,7 +775,9 @@ static void ReportJSONSyntaxError(FrontendContext* fc, ErrorMetadata&& metadata,
 // collections then at least half of it will end up tenured.
 
 JSONFullParseHandlerAnyChar::JSONFullParseHandlerAnyChar(JSContext* cx)
-    : cx(cx), gcHeap(cx, 1), freeElements(cx), freeProperties(cx) {}
+    : cx(cx), gcHeap(cx, 1), freeElements(cx), freeProperties(cx) {
+  shapeCache.fill(nullptr);
+}
 
 JSONFullParseHandlerAnyChar::JSONFullParseHandlerAnyChar(
     JSONFullParseHandlerAnyChar&& other) noexcept
@@ -628,7 +786,8 @@ JSONFullParseHandlerAnyChar::JSONFullParseHandlerAnyChar(
       parseType(other.parseType),
       gcHeap(cx, 1),
       freeElements(std::move(other.freeElements)),
-      freeProperties(std::move(other.freeProperties)) {}
+      freeProperties(std::move(other.freeProperties)),
+      shapeCache(other.shapeCache) {}
 
 JSONFullParseHandlerAnyChar::~JSONFullParseHandlerAnyChar() {
   for (size_t i = 0; i < freeElements.length(); i++) {
@@ -691,6 +850,16 @@ inline bool JSONFullParseHandlerAnyChar::finishObjectMember(
   return true;
 }
 
+/* static */
+size_t JSONFullParseHandlerAnyChar::shapeCacheIndex(
+    const PropertyVector& properties) {
+  mozilla::HashNumber hash = mozilla::HashGeneric(properties.length());
+  for (const IdValuePair& prop : properties) {
+    hash = mozilla::AddToHash(hash, prop.id.asRawBits());
+  }
+  return hash % NumShapeCacheEntries;
+}
+
 inline bool JSONFullParseHandlerAnyChar::finishObject(
     Vector<StackEntry, 10>& stack, JS::MutableHandle<JS::Value> vp,
     PropertyVector* properties) {
@@ -701,10 +870,30 @@ inline bool JSONFullParseHandlerAnyChar::finishObject(
     newKind = TenuredObject;
   }
   // properties is traced in the parser; see JSONParser<CharT>::trace()
-  JSObject* obj = NewPlainObjectWithMaybeDuplicateKeys(
-      cx, Handle<IdValueVector>::fromMarkedLocation(properties), newKind);
-  if (!obj) {
-    return false;
+  Handle<IdValueVector> props =
+      Handle<IdValueVector>::fromMarkedLocation(properties);
+
+  PlainObject* obj;
+  size_t index = shapeCacheIndex(*properties);
+  Shape* cached = shapeCache[index];
+  if (cached && PlainObjectShapeMatches(props, &cached->asShared())) {
+    Rooted<SharedShape*> shape(cx, &cached->asShared());
+    obj = NewPlainObjectWithShapeAndValues(cx, shape, props, newKind);
+    if (!obj) {
+      return false;
+    }
+  } else {
+    obj = NewPlainObjectWithMaybeDuplicateKeys(cx, props, newKind);
+    if (!obj) {
+      return false;
+    }
+
+    // Duplicate and integer keys don't end up as one slot per key.
+    if (!properties->empty() && !obj->inDictionaryMode() &&
+        obj->slotSpan() == properties->length() &&
+        obj->getDenseInitializedLength() == 0) {
+      shapeCache[index] = obj->shape();
+    }
   }
 
   vp.setObject(*obj);
@@ -774,6 +963,9 @@ inline void JSONFullParseHandlerAnyChar::freeStackEntry(StackEntry& entry) {
 
 void JSONFullParseHandlerAnyChar::trace(JSTracer* trc) {
   JS::TraceRoot(trc, &v, "JSONFullParseHandlerAnyChar current value");
+  for (Shape*& shape : shapeCache) {
+    TraceNullableRoot(trc, &shape, "JSONFullParseHandlerAnyChar shape cache");
+  }
 }
 
 template <typename CharT>
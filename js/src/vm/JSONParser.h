@@ -7,6 +7,7 @@
 #ifndef vm_JSONParser_h
 #define vm_JSONParser_h
 
+#include "mozilla/Array.h"       // mozilla::Array
 #include "mozilla/Assertions.h"  // MOZ_ASSERT
 #include "mozilla/Attributes.h"  // MOZ_STACK_CLASS
 #include "mozilla/Maybe.h"       // mozilla::{Maybe,Some}
@@ -33,6 +34,7 @@ class JSTracer;
 namespace js {
 
 class FrontendContext;
+class Shape;
 
 enum class JSONToken {
   String,
@@ -132,6 +134,8 @@ class MOZ_STACK_CLASS JSONTokenizer {
   void error(const char* msg);
 
  protected:
+  inline void skipWhitespace();
+
   inline mozilla::Span<const CharT> getSource() const {
     return mozilla::Span<const CharT>(sourceStart.get(), current.get());
   }
@@ -225,6 +229,15 @@ class MOZ_STACK_CLASS JSONFullParseHandlerAnyChar {
   Vector<ElementVector*, 5> freeElements;
   Vector<PropertyVector*, 5> freeProperties;
 
+  // Shapes of the objects created so far, indexed by a hash of their keys.
+  // Objects with the same keys as an earlier one, like the records of an
+  // array, get its shape directly instead of having their properties added
+  // one by one.
+  static constexpr size_t NumShapeCacheEntries = 32;
+  mozilla::Array<Shape*, NumShapeCacheEntries> shapeCache;
+
+  static size_t shapeCacheIndex(const PropertyVector& properties);
+
  public:
   explicit JSONFullParseHandlerAnyChar(JSContext* cx);
   ~JSONFullParseHandlerAnyChar();
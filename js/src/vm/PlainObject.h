@@ -108,6 +108,17 @@ extern PlainObject* NewPlainObjectWithMaybeDuplicateKeys(
     JSContext* cx, Handle<IdValueVector> properties,
     NewObjectKind newKind = GenericObject);
 
+// Whether |shape| has exactly the keys of |properties|, in order, as plain
+// data properties in slots.
+extern bool PlainObjectShapeMatches(Handle<IdValueVector> properties,
+                                    SharedShape* shape);
+
+// Create a plain object with the given properties and a shape known to
+// match them, see PlainObjectShapeMatches.
+extern PlainObject* NewPlainObjectWithShapeAndValues(
+    JSContext* cx, Handle<SharedShape*> shape, Handle<IdValueVector> properties,
+    NewObjectKind newKind = GenericObject);
+
 }  // namespace js
 
 #endif  // vm_PlainObject_h
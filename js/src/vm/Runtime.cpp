@@ -24,8 +24,12 @@
 #include "frontend/ParserAtom.h"  // frontend::WellKnownParserAtoms
 #include "gc/GC.h"
 #include "gc/PublicIterators.h"
+#ifdef ENABLE_JS_AOT_ICS
+#  include "jit/CacheIRAOT.h"
+#endif
 #include "jit/IonCompileTask.h"
 #include "jit/JitRuntime.h"
+#include "jit/ProcessExecutableMemory.h"
 #include "jit/Simulator.h"
 #include "js/AllocationLogging.h"  // JS_COUNT_CTOR, JS_COUNT_DTOR
 #include "js/experimental/JSStencil.h"
@@ -36,12 +40,14 @@
 #include "js/Stack.h"  // JS::NativeStackLimitMin
 #include "js/Wrapper.h"
 #include "js/WrapperCallbacks.h"
+#include "vm/ArrayBufferObject.h"
 #include "vm/DateTime.h"
 #include "vm/JSObject.h"
 #include "vm/JSScript.h"
 #include "vm/PromiseObject.h"  // js::PromiseObject
 #include "vm/SharedImmutableStringsCache.h"
 #include "vm/Warnings.h"  // js::WarnNumberUC
+#include "wasm/WasmModuleCache.h"
 #include "wasm/WasmPI.h"
 #include "wasm/WasmSignalHandlers.h"
 
@@ -343,6 +349,11 @@ void JSRuntime::addSizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf,
     rtSizes->sharedImmutableStringsCache +=
         js::SharedImmutableStringsCache::getSingleton().sizeOfExcludingThis(
             mallocSizeOf);
+    js::wasm::AddSizeOfModuleCache(mallocSizeOf,
+                                   &rtSizes->wasmModuleCacheCode,
+                                   &rtSizes->wasmModuleCacheData);
+    rtSizes->wasmHugePages += js::WasmHugePageBytes();
+    rtSizes->jitHugePages += js::jit::HugePageExecutableBytes();
     rtSizes->atomsTable +=
         js::frontend::WellKnownParserAtoms::getSingleton().sizeOfExcludingThis(
             mallocSizeOf);
@@ -98,6 +98,7 @@ class SourceHook;
 
 namespace jit {
 class JitRuntime;
+class RecordedAOTStubs;
 class JitActivation;
 struct PcScriptCache;
 class CompileRuntime;
@@ -347,6 +348,12 @@ struct JSRuntime {
   }
 #endif
 
+#ifdef ENABLE_JS_AOT_ICS
+  /* IC bodies compiled by this runtime's zones, see JitOptions. */
+  js::MainThreadData<js::UniquePtr<js::jit::RecordedAOTStubs>>
+      recordedAOTStubs;
+#endif
+
   /*
    * If non-null, another runtime guaranteed to outlive this one and whose
    * permanent data may be used by this one where possible.
@@ -230,6 +230,10 @@ void WasmSharedArrayRawBuffer::discard(size_t byteOffset, size_t byteLen) {
   if (data == MAP_FAILED) {
     MOZ_CRASH("failed to discard wasm memory; memory mappings may be broken");
   }
+  // The new mapping doesn't inherit the huge page advice.
+  if (gc::HugePagesEnabled()) {
+    gc::MarkPagesHuge(addr.unwrap(), byteLen);
+  }
 #endif
 }
 
@@ -878,23 +878,17 @@ void JSRope::dumpOwnRepresentationFields(js::JSONPrinter& json) const {
 }
 #endif
 
-namespace js {
-
-template <>
-void CopyChars(char16_t* dest, const JSLinearString& str) {
-  AutoCheckCannotGC nogc;
-  if (str.hasTwoByteChars()) {
-    PodCopy(dest, str.twoByteChars(nogc), str.length());
-  } else {
-    CopyAndInflateChars(dest, str.latin1Chars(nogc), str.length());
-  }
-}
-
-template <>
-void CopyChars(Latin1Char* dest, const JSLinearString& str) {
-  AutoCheckCannotGC nogc;
-  if (str.hasLatin1Chars()) {
-    PodCopy(dest, str.latin1Chars(nogc), str.length());
+// Copy |len| characters from |src| to |dest|, inflating or deflating them
+// when the character types differ. The conversions are vectorized by
+// encoding_rs.
+template <typename DestCharT, typename SrcCharT>
+static MOZ_ALWAYS_INLINE void CopyOrConvertChars(DestCharT* dest,
+                                                 const SrcCharT* src,
+                                                 size_t len) {
+  if constexpr (std::is_same_v<DestCharT, SrcCharT>) {
+    PodCopy(dest, src, len);
+  } else if constexpr (std::is_same_v<DestCharT, char16_t>) {
+    CopyAndInflateChars(dest, src, len);
   } else {
     /*
      * When we flatten a TwoByte rope, we turn child ropes (including Latin1
@@ -904,16 +898,59 @@ void CopyChars(Latin1Char* dest, const JSLinearString& str) {
      * the chars are stored as TwoByte, we know they must be in the Latin1
      * range, so we can safely deflate here.
      */
-    size_t len = str.length();
-    const char16_t* chars = str.twoByteChars(nogc);
-    auto src = Span(chars, len);
-    MOZ_ASSERT(IsUtf16Latin1(src));
-    LossyConvertUtf16toLatin1(src, AsWritableChars(Span(dest, len)));
+    auto srcSpan = Span(src, len);
+    MOZ_ASSERT(IsUtf16Latin1(srcSpan));
+    LossyConvertUtf16toLatin1(srcSpan, AsWritableChars(Span(dest, len)));
+  }
+}
+
+namespace js {
+
+template <typename CharT>
+void CopyChars(CharT* dest, const JSLinearString& str) {
+  AutoCheckCannotGC nogc;
+  if (str.hasLatin1Chars()) {
+    CopyOrConvertChars(dest, str.latin1Chars(nogc), str.length());
+  } else {
+    CopyOrConvertChars(dest, str.twoByteChars(nogc), str.length());
   }
 }
 
+template void CopyChars(char16_t* dest, const JSLinearString& str);
+template void CopyChars(Latin1Char* dest, const JSLinearString& str);
+
 } /* namespace js */
 
+// Copy the characters of |str| to |dest| as CopyChars does, and add them to
+// |*maybeHash| if it is non-null.
+//
+// The hash is computed chunk by chunk, right after each chunk is copied, such
+// that the characters are read again while they are still in the cache, and
+// the copy itself remains vectorized.
+template <typename CharT>
+static MOZ_ALWAYS_INLINE void CopyCharsForFlatten(CharT* dest,
+                                                  const JSLinearString& str,
+                                                  uint32_t* maybeHash) {
+  if (!maybeHash) {
+    CopyChars(dest, str);
+    return;
+  }
+
+  static constexpr size_t ChunkLength = 1024;
+
+  AutoCheckCannotGC nogc;
+  size_t length = str.length();
+  for (size_t start = 0; start < length; start += ChunkLength) {
+    size_t len = std::min(ChunkLength, length - start);
+    if (str.hasLatin1Chars()) {
+      CopyOrConvertChars(dest + start, str.latin1Chars(nogc) + start, len);
+    } else {
+      CopyOrConvertChars(dest + start, str.twoByteChars(nogc) + start, len);
+    }
+    AddStringToHash(maybeHash, dest + start, len);
+  }
+}
+
 template <typename CharT>
 static constexpr uint32_t StringFlagsForCharType(uint32_t baseFlags) {
   if constexpr (std::is_same_v<CharT, char16_t>) {
@@ -994,13 +1031,13 @@ static bool CanReuseLeftmostBuffer(JSString* leftmostChild, size_t wholeLength,
   return true;
 }
 
-JSLinearString* JSRope::flatten(JSContext* maybecx) {
+JSLinearString* JSRope::flatten(JSContext* maybecx, uint32_t* maybeHash) {
   mozilla::Maybe<AutoGeckoProfilerEntry> entry;
   if (maybecx) {
     entry.emplace(maybecx, "JSRope::flatten");
   }
 
-  JSLinearString* str = flattenInternal();
+  JSLinearString* str = flattenInternal(maybeHash);
   if (!str && maybecx) {
     ReportOutOfMemory(maybecx);
   }
@@ -1008,26 +1045,30 @@ JSLinearString* JSRope::flatten(JSContext* maybecx) {
   return str;
 }
 
-JSLinearString* JSRope::flattenInternal() {
+JSLinearString* JSRope::flattenAndHash(JSContext* cx, uint32_t* hash) {
+  return flatten(cx, hash);
+}
+
+JSLinearString* JSRope::flattenInternal(uint32_t* maybeHash) {
   if (zone()->needsIncrementalBarrier()) {
-    return flattenInternal<WithIncrementalBarrier>();
+    return flattenInternal<WithIncrementalBarrier>(maybeHash);
   }
 
-  return flattenInternal<NoBarrier>();
+  return flattenInternal<NoBarrier>(maybeHash);
 }
 
 template <JSRope::UsingBarrier usingBarrier>
-JSLinearString* JSRope::flattenInternal() {
+JSLinearString* JSRope::flattenInternal(uint32_t* maybeHash) {
   if (hasTwoByteChars()) {
-    return flattenInternal<usingBarrier, char16_t>(this);
+    return flattenInternal<usingBarrier, char16_t>(this, maybeHash);
   }
 
-  return flattenInternal<usingBarrier, Latin1Char>(this);
+  return flattenInternal<usingBarrier, Latin1Char>(this, maybeHash);
 }
 
 template <JSRope::UsingBarrier usingBarrier, typename CharT>
 /* static */
-JSLinearString* JSRope::flattenInternal(JSRope* root) {
+JSLinearString* JSRope::flattenInternal(JSRope* root, uint32_t* maybeHash) {
   /*
    * Consider the DAG of JSRopes rooted at |root|, with non-JSRopes as
    * its leaves. Mutate the root JSRope into a JSExtensibleString containing
@@ -1133,6 +1174,10 @@ JSLinearString* JSRope::flattenInternal(JSRope* root) {
   JSRope* str = root;
   CharT* pos = wholeChars;
 
+  if (maybeHash) {
+    *maybeHash = 0;
+  }
+
   JSRope* parent = nullptr;
   uint32_t parentFlag = 0;
 
@@ -1156,7 +1201,10 @@ first_visit_node: {
     goto first_visit_node;
   }
   if (!(reuseLeftmostBuffer && pos == wholeChars)) {
-    CopyChars(pos, left.asLinear());
+    CopyCharsForFlatten(pos, left.asLinear(), maybeHash);
+  } else if (maybeHash) {
+    // The leftmost characters are already in place.
+    AddStringToHash(maybeHash, pos, left.length());
   }
   pos += left.length();
 }
@@ -1170,7 +1218,7 @@ visit_right_child: {
     str = &right.asRope();
     goto first_visit_node;
   }
-  CopyChars(pos, right.asLinear());
+  CopyCharsForFlatten(pos, right.asLinear(), maybeHash);
   pos += right.length();
 }
 
@@ -977,14 +977,14 @@ class JSRope : public JSString {
   enum UsingBarrier : bool { NoBarrier = false, WithIncrementalBarrier = true };
 
   friend class JSString;
-  JSLinearString* flatten(JSContext* maybecx);
+  JSLinearString* flatten(JSContext* maybecx, uint32_t* maybeHash = nullptr);
 
-  JSLinearString* flattenInternal();
+  JSLinearString* flattenInternal(uint32_t* maybeHash = nullptr);
   template <UsingBarrier usingBarrier>
-  JSLinearString* flattenInternal();
+  JSLinearString* flattenInternal(uint32_t* maybeHash);
 
   template <UsingBarrier usingBarrier, typename CharT>
-  static JSLinearString* flattenInternal(JSRope* root);
+  static JSLinearString* flattenInternal(JSRope* root, uint32_t* maybeHash);
 
   template <UsingBarrier usingBarrier>
   static void ropeBarrierDuringFlattening(JSRope* rope);
@@ -1015,6 +1015,12 @@ class JSRope : public JSString {
   // Returns the same value as if this were a linear string being hashed.
   [[nodiscard]] bool hash(uint32_t* outhHash) const;
 
+  // Flatten this rope, and compute the hash of its characters while they are
+  // copied, instead of reading the flattened string again to atomize it.
+  //
+  // |*hash| gets the same value as if the flattened string were hashed.
+  JSLinearString* flattenAndHash(JSContext* cx, uint32_t* hash);
+
   // The process of flattening a rope temporarily overwrites the left pointer of
   // interior nodes in the rope DAG with the parent pointer.
   bool isBeingFlattened() const { return flags() & FLATTEN_MASK; }
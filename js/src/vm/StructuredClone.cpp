@@ -990,12 +990,21 @@ bool SCOutput::writeArray(const T* p, size_t nelems) {
     return true;
   }
 
-  for (size_t i = 0; i < nelems; i++) {
-    T value = NativeEndian::swapToLittleEndian(p[i]);
-    if (!buf.AppendBytes(reinterpret_cast<char*>(&value), sizeof(value))) {
+  if constexpr (MOZ_LITTLE_ENDIAN()) {
+    // The elements are already stored in the order we write them in.
+    if (!buf.AppendBytes(reinterpret_cast<const char*>(p),
+                         nelems * sizeof(T))) {
       ReportOutOfMemory(context());
       return false;
     }
+  } else {
+    for (size_t i = 0; i < nelems; i++) {
+      T value = NativeEndian::swapToLittleEndian(p[i]);
+      if (!buf.AppendBytes(reinterpret_cast<char*>(&value), sizeof(value))) {
+        ReportOutOfMemory(context());
+        return false;
+      }
+    }
   }
 
   // Zero-pad to 8 bytes boundary.
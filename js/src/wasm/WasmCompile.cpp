@@ -41,6 +41,7 @@
 #include "wasm/WasmFeatures.h"
 #include "wasm/WasmGenerator.h"
 #include "wasm/WasmIonCompile.h"
+#include "wasm/WasmModuleCache.h"
 #include "wasm/WasmOpIter.h"
 #include "wasm/WasmProcess.h"
 #include "wasm/WasmSignalHandlers.h"
@@ -885,11 +886,17 @@ void CompilerEnvironment::computeParameters(const ModuleMetadata& moduleMeta) {
   uint32_t codeSectionSize = moduleMeta.codeMeta->codeSectionSize();
 
   // We use lazy tiering if the 'for-all' pref is enabled, or the 'gc-only'
-  // pref is enabled and we're compiling a GC module.  However, forcing
-  // serialization-testing disables lazy tiering.
+  // pref is enabled and we're compiling a GC module, or the module is large
+  // enough that tiering up all of its functions would be wasteful.  However,
+  // forcing serialization-testing disables lazy tiering.
   bool testSerialization = args_->features.testSerialization;
+  uint32_t lazyTieringMinCodeSize =
+      JS::Prefs::wasm_lazy_tiering_min_code_size();
+  bool isLargeModule =
+      lazyTieringMinCodeSize && codeSectionSize >= lazyTieringMinCodeSize;
   bool lazyTiering = (JS::Prefs::wasm_lazy_tiering() ||
-                      (JS::Prefs::wasm_lazy_tiering_for_gc() && isGcModule)) &&
+                      (JS::Prefs::wasm_lazy_tiering_for_gc() && isGcModule) ||
+                      isLargeModule) &&
                      !testSerialization;
 
   if (baselineEnabled && hasSecondTier &&
@@ -971,6 +978,17 @@ SharedModule wasm::CompileBuffer(const CompileArgs& args,
                                  UniqueChars* error,
                                  UniqueCharsVector* warnings,
                                  JS::OptimizedEncodingListener* listener) {
+  // Reuse the module if the same bytecode was already compiled with the same
+  // arguments. Compilations with a listener expect it to be called, and thus
+  // are never cached.
+  ModuleCacheKey cacheKey;
+  bool cacheable = !listener && cacheKey.init(args, bytecode.source());
+  if (cacheable) {
+    if (SharedModule module = LookupCachedModule(cacheKey)) {
+      return module;
+    }
+  }
+
   MutableModuleMetadata moduleMeta = js_new<ModuleMetadata>();
   if (!moduleMeta || !moduleMeta->init(args)) {
     return nullptr;
@@ -1041,7 +1059,14 @@ SharedModule wasm::CompileBuffer(const CompileArgs& args,
     MOZ_RELEASE_ASSERT(envDecoder.done());
   }
 
-  return mg.finishModule(bytecode, *moduleMeta, listener);
+  SharedModule module = mg.finishModule(bytecode, *moduleMeta, listener);
+
+  // Modules with warnings are not cached, as the warnings would only be
+  // reported for the first compilation.
+  if (module && cacheable && (!warnings || warnings->empty())) {
+    CacheModule(cacheKey, *module);
+  }
+  return module;
 }
 
 bool wasm::CompileCompleteTier2(const ShareableBytes* codeSection,
@@ -0,0 +1,198 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * vim: set ts=8 sts=2 et sw=2 tw=80:
+ *
+ * Copyright 2026 Mozilla Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "wasm/WasmModuleCache.h"
+
+#include <string.h>
+
+#include "js/Prefs.h"
+#include "threading/ExclusiveData.h"
+#include "vm/MutexIDs.h"
+
+using namespace js;
+using namespace js::wasm;
+
+// Smaller modules are compiled quickly enough that caching them is not worth
+// the memory.
+static constexpr size_t MinCachedBytecodeLength = 256 * 1024;
+
+// Bound on the number of modules kept alive by the cache.
+static constexpr size_t MaxEntries = 8;
+
+static bool EqualChars(const char* a, const char* b) {
+  if (!a || !b) {
+    return a == b;
+  }
+  return strcmp(a, b) == 0;
+}
+
+static bool EqualFeatures(const FeatureArgs& a, const FeatureArgs& b) {
+#define WASM_FEATURE(NAME, LOWER_NAME, ...) \
+  if (a.LOWER_NAME != b.LOWER_NAME) {       \
+    return false;                           \
+  }
+  JS_FOR_WASM_FEATURES(WASM_FEATURE)
+#undef WASM_FEATURE
+
+  return a.sharedMemory == b.sharedMemory && a.simd == b.simd &&
+         a.isBuiltinModule == b.isBuiltinModule;
+}
+
+bool ModuleCacheKey::init(const CompileArgs& args,
+                          const BytecodeSource& bytecode) {
+  if (!JS::Prefs::wasm_module_cache() ||
+      bytecode.length() < MinCachedBytecodeLength || args.debugEnabled ||
+      args.features.isBuiltinModule ||
+      !args.features.builtinModules.hasNone()) {
+    return false;
+  }
+
+  bytecode.computeHash(&hash_);
+  bytecodeLength_ = bytecode.length();
+  args_ = &args;
+  return true;
+}
+
+bool ModuleCacheKey::operator==(const ModuleCacheKey& other) const {
+  if (memcmp(hash_, other.hash_, sizeof(hash_)) != 0 ||
+      bytecodeLength_ != other.bytecodeLength_) {
+    return false;
+  }
+
+  const CompileArgs& a = *args_;
+  const CompileArgs& b = *other.args_;
+  return EqualChars(a.scriptedCaller.filename.get(),
+                    b.scriptedCaller.filename.get()) &&
+         a.scriptedCaller.filenameIsURL == b.scriptedCaller.filenameIsURL &&
+         a.scriptedCaller.line == b.scriptedCaller.line &&
+         EqualChars(a.sourceMapURL.get(), b.sourceMapURL.get()) &&
+         a.baselineEnabled == b.baselineEnabled &&
+         a.ionEnabled == b.ionEnabled && a.debugEnabled == b.debugEnabled &&
+         a.forceTiering == b.forceTiering &&
+         EqualFeatures(a.features, b.features);
+}
+
+namespace {
+
+struct CacheEntry {
+  ModuleCacheKey key;
+  SharedModule module;
+};
+
+// The most recently used entry is the last one.
+using CacheEntryVector = Vector<CacheEntry, MaxEntries, SystemAllocPolicy>;
+
+}  // namespace
+
+static ExclusiveData<CacheEntryVector>* sModuleCache = nullptr;
+
+bool wasm::InitModuleCache() {
+  MOZ_ASSERT(!sModuleCache);
+  sModuleCache =
+      js_new<ExclusiveData<CacheEntryVector>>(mutexid::WasmModuleCache);
+  return !!sModuleCache;
+}
+
+void wasm::ShutDownModuleCache() {
+  js_delete(sModuleCache);
+  sModuleCache = nullptr;
+}
+
+SharedModule wasm::LookupCachedModule(const ModuleCacheKey& key) {
+  auto entries = sModuleCache->lock();
+  for (size_t i = 0; i < entries->length(); i++) {
+    if ((*entries)[i].key == key) {
+      // Move the entry to the back, as the most recently used one.
+      CacheEntry entry = std::move((*entries)[i]);
+      entries->erase(&(*entries)[i]);
+      SharedModule module = entry.module;
+      entries->infallibleAppend(std::move(entry));
+      return module;
+    }
+  }
+  return nullptr;
+}
+
+void wasm::CacheModule(const ModuleCacheKey& key, const Module& module) {
+  // Release the evicted module outside of the lock, as destroying it takes
+  // other locks.
+  SharedModule evicted;
+
+  auto entries = sModuleCache->lock();
+
+  // A concurrent compilation of the same module may have been cached first, in
+  // which case this one replaces it, for simplicity.
+  for (CacheEntry& entry : *entries) {
+    if (entry.key == key) {
+      evicted = std::move(entry.module);
+      entry.module = &module;
+      return;
+    }
+  }
+
+  if (entries->length() == MaxEntries) {
+    evicted = std::move(entries->begin()->module);
+    entries->erase(entries->begin());
+  }
+
+  // Failing to cache the module is not an error.
+  (void)entries->append(CacheEntry{key, &module});
+}
+
+void wasm::PurgeModuleCache(bool shrinking) {
+  // Release the unused modules outside of the lock. Moving the entries cannot
+  // fail, as `unused` has the same inline capacity as the cache.
+  CacheEntryVector unused;
+
+  auto entries = sModuleCache->lock();
+  size_t kept = 0;
+  for (size_t i = 0; i < entries->length(); i++) {
+    CacheEntry& entry = (*entries)[i];
+
+    // Keep the most recently used module across non-shrinking GCs, as it is
+    // likely to be compiled again soon, e.g. when reloading a page.
+    bool isMostRecent = i + 1 == entries->length();
+    if (entry.module->hasOneRef() && (shrinking || !isMostRecent)) {
+      unused.infallibleAppend(std::move(entry));
+      continue;
+    }
+
+    if (kept != i) {
+      (*entries)[kept] = std::move(entry);
+    }
+    kept++;
+  }
+  entries->shrinkTo(kept);
+}
+
+void wasm::AddSizeOfModuleCache(mozilla::MallocSizeOf mallocSizeOf,
+                                size_t* code, size_t* data) {
+  auto entries = sModuleCache->lock();
+  *data += entries->sizeOfExcludingThis(mallocSizeOf);
+
+  CodeMetadata::SeenSet seenCodeMeta;
+  CodeMetadataForAsmJS::SeenSet seenCodeMetaForAsmJS;
+  Code::SeenSet seenCode;
+  for (const CacheEntry& entry : *entries) {
+    if (entry.module->hasOneRef()) {
+      entry.module->addSizeOfMisc(mallocSizeOf, &seenCodeMeta,
+                                  &seenCodeMetaForAsmJS, &seenCode, code,
+                                  data);
+    }
+  }
+}
@@ -0,0 +1,86 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * vim: set ts=8 sts=2 et sw=2 tw=80:
+ *
+ * Copyright 2026 Mozilla Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef wasm_module_cache_h
+#define wasm_module_cache_h
+
+#include "mozilla/MemoryReporting.h"
+#include "mozilla/SHA1.h"
+
+#include "wasm/WasmModule.h"
+
+namespace js {
+namespace wasm {
+
+// A process-wide cache of compiled modules, keyed by the SHA-1 hash of their
+// bytecode, so that the same module compiled by multiple realms, e.g. a
+// runtime served from a CDN to multiple sites, is compiled only once.
+//
+// The build ID is implicitly part of the key, as the cache does not outlive
+// the process.  All the compile arguments that affect the generated code or
+// that are observable from the module are part of the key too, in particular
+// the URL of the module, which is exposed in stack traces.  Thus a module is
+// only shared with realms which would have compiled exactly the same module
+// from exactly the same resource, and site isolation ensures that the realms
+// sharing a process are allowed to share it.
+//
+// Only large modules, compiled without a debugger and without an optimized
+// encoding listener, are cached.  The cache holds a reference to at most
+// `MaxEntries` modules; the modules that are no longer used by anyone else are
+// dropped by GCs of the main runtime, see PurgeModuleCache.
+
+class ModuleCacheKey {
+  mozilla::SHA1Sum::Hash hash_;
+  size_t bytecodeLength_;
+  SharedCompileArgs args_;
+
+ public:
+  ModuleCacheKey() : hash_{}, bytecodeLength_(0) {}
+
+  // Return false if modules compiled with these arguments should not be
+  // cached.
+  [[nodiscard]] bool init(const CompileArgs& args,
+                          const BytecodeSource& bytecode);
+
+  bool operator==(const ModuleCacheKey& other) const;
+};
+
+// Return the module previously compiled from the bytecode and arguments of
+// `key`, if any.
+SharedModule LookupCachedModule(const ModuleCacheKey& key);
+
+// Record the module compiled from the bytecode and arguments of `key`.
+void CacheModule(const ModuleCacheKey& key, const Module& module);
+
+// Release the modules that only the cache references, except the most recently
+// used one when not `shrinking`.
+void PurgeModuleCache(bool shrinking);
+
+// Called by wasm::Init and wasm::ShutDown.
+[[nodiscard]] bool InitModuleCache();
+void ShutDownModuleCache();
+
+// Measure the modules that only the cache references, as every other module
+// is measured along with the realms using it.
+void AddSizeOfModuleCache(mozilla::MallocSizeOf mallocSizeOf, size_t* code,
+                          size_t* data);
+
+}  // namespace wasm
+}  // namespace js
+
+#endif  // wasm_module_cache_h
@@ -28,6 +28,7 @@
 #include "wasm/WasmBuiltins.h"
 #include "wasm/WasmCode.h"
 #include "wasm/WasmInstance.h"
+#include "wasm/WasmModuleCache.h"
 #include "wasm/WasmModuleTypes.h"
 #include "wasm/WasmStaticTypeDefs.h"
 
@@ -201,6 +202,10 @@ bool wasm::Init() {
 
   sThreadSafeCodeBlockMap = map;
 
+  if (!InitModuleCache()) {
+    oomUnsafe.crash("js::wasm::Init");
+  }
+
   if (!InitTagForJSValue()) {
     oomUnsafe.crash("js::wasm::Init");
   }
@@ -216,6 +221,9 @@ void wasm::ShutDown() {
     return;
   }
 
+  // The cached modules use the code block map and the canonical types.
+  ShutDownModuleCache();
+
   BuiltinModuleFuncs::destroy();
   StaticTypeDefs::destroy();
   PurgeCanonicalTypes();
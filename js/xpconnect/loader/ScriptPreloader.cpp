@@ -48,6 +48,7 @@
 #include "nsProxyRelease.h"
 #include "nsThreadUtils.h"
 #include "nsXULAppAPI.h"
+#include "prsystem.h"
 #include "xpcpublic.h"
 
 #define STARTUP_COMPLETE_TOPIC "browser-delayed-startup-finished"
@@ -286,7 +287,7 @@ void ScriptPreloader::InvalidateCache() {
     // Pending scripts should have been cleared by the above, and the queue
     // should have been reset.
     MOZ_ASSERT(mDecodingScripts.isEmpty());
-    MOZ_ASSERT(!mDecodedStencils);
+    MOZ_ASSERT(!mDecodeState);
 
     mScripts.Clear();
 
@@ -990,22 +991,29 @@ already_AddRefed<JS::Stencil> ScriptPreloader::WaitForCachedStencil(
     JSContext* cx, const JS::ReadOnlyDecodeOptions& options,
     CachedStencil* script) {
   if (!script->mReadyToExecute) {
-    // mReadyToExecute is kept as false only when off-thread decode task was
-    // available (pref is set to true) and the task was successfully created.
+    // mReadyToExecute is kept as false only when off-thread decode tasks were
+    // available (pref is set to true) and were successfully created.
     // See ScriptPreloader::StartDecodeTask methods.
-    MOZ_ASSERT(mDecodedStencils);
+    MOZ_ASSERT(mDecodeState);
 
     // Check for the finished operations that can contain our target.
-    if (mDecodedStencils->AvailableRead() > 0) {
-      FinishOffThreadDecode();
-    }
+    FinishOffThreadDecode();
 
-    if (!script->mReadyToExecute) {
+    if (!TakeDecodedStencil(script)) {
       // Our target is not yet decoded.
 
-      // If script is small enough, we'd rather decode on main-thread than wait
-      // for a decode task to complete.
-      if (script->mSize < MAX_MAINTHREAD_DECODE_SIZE) {
+      if (mDecodeState->Claim(script->mDecodeIndex)) {
+        // No decode task has started on our target yet, and they're busy
+        // with the scripts before it. Decode it on the main thread rather
+        // than wait for them.
+        LOG(Info, "Script isn't being decoded yet, decoding on main thread\n");
+
+        script->mReadyToExecute = true;
+        script->remove();
+        glean::script_preloader::mainthread_recompile.Add(1);
+      } else if (script->mSize < MAX_MAINTHREAD_DECODE_SIZE) {
+        // If script is small enough, we'd rather decode on main-thread than
+        // wait for its decode task to complete.
         LOG(Info, "Script is small enough to recompile on main thread\n");
 
         script->mReadyToExecute = true;
@@ -1016,16 +1024,11 @@ already_AddRefed<JS::Stencil> ScriptPreloader::WaitForCachedStencil(
 
         MonitorAutoLock mal(mMonitor);
 
-        // Process finished tasks until our target is found.
-        while (!script->mReadyToExecute) {
-          if (mDecodedStencils->AvailableRead() > 0) {
-            FinishOffThreadDecode();
-          } else {
-            MOZ_ASSERT(!mDecodingScripts.isEmpty());
-            mWaitingForDecode = true;
-            mal.Wait();
-            mWaitingForDecode = false;
-          }
+        // A decode task is decoding our target, wait until it's done.
+        while (!TakeDecodedStencil(script)) {
+          mWaitingForDecode = true;
+          mal.Wait();
+          mWaitingForDecode = false;
         }
 
         TimeDuration waited = TimeStamp::Now() - start;
@@ -1038,7 +1041,7 @@ already_AddRefed<JS::Stencil> ScriptPreloader::WaitForCachedStencil(
   return script->GetStencil(cx, options);
 }
 
-void ScriptPreloader::onDecodedStencilQueued() {
+void ScriptPreloader::OnDecodedStencil() {
   mMonitor.AssertNotCurrentThreadOwns();
   MonitorAutoLock mal(mMonitor);
 
@@ -1066,74 +1069,85 @@ void ScriptPreloader::OnDecodeTaskFinished() {
   }
 }
 
-void ScriptPreloader::OnDecodeTaskFailed() {
-  // NOTE: nullptr is enqueued to mDecodedStencils, and FinishOffThreadDecode
-  //       handles it as failure.
-  OnDecodeTaskFinished();
-}
-
 void ScriptPreloader::FinishPendingParses(MonitorAutoLock& aMal) {
   mMonitor.AssertCurrentThreadOwns();
 
-  // If off-thread decoding task hasn't been started, nothing to do.
+  // If off-thread decoding tasks haven't been started, nothing to do.
   // This can happen if the javascript.options.parallel_parsing pref was false,
-  // or the decode task fails to start.
-  if (!mDecodedStencils) {
+  // or the decode tasks fail to start.
+  if (!mDecodeState) {
     return;
   }
 
+  // Don't let the decode tasks start on any more scripts.
+  for (CachedStencil* next = mDecodingScripts.getFirst(); next;) {
+    auto* script = next;
+    next = script->getNext();
+
+    if (mDecodeState->Claim(script->mDecodeIndex)) {
+      script->mReadyToExecute = true;
+      script->remove();
+    }
+  }
+
   // Process any pending decodes that are in flight.
-  while (!mDecodingScripts.isEmpty()) {
-    if (mDecodedStencils->AvailableRead() > 0) {
-      FinishOffThreadDecode();
-    } else {
-      mWaitingForDecode = true;
-      aMal.Wait();
-      mWaitingForDecode = false;
+  for (;;) {
+    FinishOffThreadDecode();
+    if (mDecodingScripts.isEmpty()) {
+      break;
     }
+    mWaitingForDecode = true;
+    aMal.Wait();
+    mWaitingForDecode = false;
   }
 }
 
 void ScriptPreloader::DoFinishOffThreadDecode() {
-  // NOTE: mDecodedStencils could already be reset.
-  if (mDecodedStencils && mDecodedStencils->AvailableRead() > 0) {
+  // NOTE: mDecodeState could already be reset.
+  if (mDecodeState) {
     FinishOffThreadDecode();
   }
 }
 
-void ScriptPreloader::FinishOffThreadDecode() {
-  MOZ_ASSERT(mDecodedStencils);
+bool ScriptPreloader::TakeDecodedStencil(CachedStencil* script) {
+  if (!script->isInList()) {
+    return script->mReadyToExecute;
+  }
 
-  while (mDecodedStencils->AvailableRead() > 0) {
-    RefPtr<JS::Stencil> stencil;
-    DebugOnly<int> reads = mDecodedStencils->Dequeue(&stencil, 1);
-    MOZ_ASSERT(reads == 1);
+  // A script that is still in the list with mReadyToExecute set gave up
+  // waiting for its decode task, and is decoded on the main thread. We still
+  // take the stencil once the task is done.
+  MOZ_ASSERT(mDecodeState);
+  uint32_t index = script->mDecodeIndex;
+  if (!mDecodeState->IsDecoded(index)) {
+    return script->mReadyToExecute;
+  }
 
-    if (!stencil) {
-      // DecodeTask failed.
-      // Mark all remaining scripts to be decoded on the main thread.
-      for (CachedStencil* next = mDecodingScripts.getFirst(); next;) {
-        auto* script = next;
-        next = script->getNext();
+  // If the stencil is null, the decode task failed, and the script will be
+  // decoded on the main thread instead.
+  LOG(Debug, "Finished off-thread decode of %s\n", script->mURL.get());
+  if (!script->mStencil) {
+    script->mStencil = std::move(mDecodeState->mStencils[index]);
+  }
+  script->mReadyToExecute = true;
+  script->remove();
+  return true;
+}
 
-        script->mReadyToExecute = true;
-        script->remove();
-      }
+void ScriptPreloader::FinishOffThreadDecode() {
+  MOZ_ASSERT(mDecodeState);
 
+  // The decode tasks finish roughly in the order of mDecodingScripts, so only
+  // look at the scripts at the front of the list. The rest are taken by
+  // WaitForCachedStencil if they're needed sooner.
+  while (CachedStencil* script = mDecodingScripts.getFirst()) {
+    if (!TakeDecodedStencil(script) || script->isInList()) {
       break;
     }
-
-    CachedStencil* script = mDecodingScripts.getFirst();
-    MOZ_ASSERT(script);
-
-    LOG(Debug, "Finished off-thread decode of %s\n", script->mURL.get());
-    script->mStencil = stencil.forget();
-    script->mReadyToExecute = true;
-    script->remove();
   }
 
   if (mDecodingScripts.isEmpty()) {
-    mDecodedStencils.reset();
+    mDecodeState = nullptr;
   }
 }
 
@@ -1143,6 +1157,8 @@ void ScriptPreloader::StartDecodeTask(JS::HandleObject scope) {
 
   Vector<JS::TranscodeSource> decodingSources;
 
+  // The scripts are in the order in which they were first used in the
+  // previous session, see WriteCache.
   size_t size = 0;
   for (CachedStencil* next = mDecodingScripts.getFirst(); next;) {
     auto* script = next;
@@ -1156,6 +1172,7 @@ void ScriptPreloader::StartDecodeTask(JS::HandleObject scope) {
       script->remove();
       continue;
     }
+    script->mDecodeIndex = decodingSources.length();
     if (!decodingSources.emplaceBack(script->Range(), script->mURL.get(), 0)) {
       break;
     }
@@ -1206,56 +1223,86 @@ void ScriptPreloader::StartDecodeTask(JS::HandleObject scope) {
 bool ScriptPreloader::StartDecodeTask(
     const JS::ReadOnlyDecodeOptions& decodeOptions,
     Vector<JS::TranscodeSource>&& decodingSources) {
-  mDecodedStencils.emplace(decodingSources.length());
-  MOZ_ASSERT(mDecodedStencils);
-
-  nsCOMPtr<nsIRunnable> task =
-      new DecodeTask(this, decodeOptions, std::move(decodingSources));
+  RefPtr<DecodeState> state =
+      new DecodeState(decodeOptions, std::move(decodingSources));
+
+  // Leave a processor for the main thread.
+  uint32_t taskCount = std::min<size_t>(
+      {kMaxDecodeTasks,
+       size_t(std::max(PR_GetNumberOfProcessors() - 1, 1)), state->Length()});
+
+  uint32_t started = 0;
+  for (uint32_t i = 0; i < taskCount; i++) {
+    state->mRunningTasks++;
+    nsCOMPtr<nsIRunnable> task = new DecodeTask(this, state);
+    if (NS_FAILED(NS_DispatchBackgroundTask(task.forget()))) {
+      state->mRunningTasks--;
+      break;
+    }
+    started++;
+  }
 
-  nsresult rv = NS_DispatchBackgroundTask(task.forget());
+  if (!started) {
+    return false;
+  }
+  mDecodeState = std::move(state);
+  return true;
+}
 
-  return NS_SUCCEEDED(rv);
+ScriptPreloader::DecodeState::DecodeState(
+    const JS::ReadOnlyDecodeOptions& decodeOptions,
+    Vector<JS::TranscodeSource>&& decodingSources)
+    : mDecodingSources(std::move(decodingSources)),
+      mStencils(MakeUnique<RefPtr<JS::Stencil>[]>(mDecodingSources.length())),
+      mStatus(MakeUnique<Atomic<Status>[]>(mDecodingSources.length())) {
+  mDecodeOptions.infallibleCopy(decodeOptions);
 }
 
 NS_IMETHODIMP ScriptPreloader::DecodeTask::Run() {
-  auto failure = [&]() {
-    RefPtr<JS::Stencil> stencil;
-    DebugOnly<int> writes = mPreloader->mDecodedStencils->Enqueue(stencil);
-    MOZ_ASSERT(writes == 1);
-    mPreloader->OnDecodeTaskFailed();
-  };
-
+  // Without a frontend context, every source this task claims is left to the
+  // main thread.
   JS::FrontendContext* fc = JS::NewFrontendContext();
-  if (!fc) {
-    failure();
-    return NS_OK;
-  }
+  auto cleanup = MakeScopeExit([&]() {
+    if (fc) {
+      JS::DestroyFrontendContext(fc);
+    }
+  });
 
-  auto cleanup = MakeScopeExit([&]() { JS::DestroyFrontendContext(fc); });
+  if (fc) {
+    size_t stackSize = TaskController::GetThreadStackSize();
+    JS::SetNativeStackQuota(fc, JS::ThreadStackQuotaForSize(stackSize));
+  }
 
-  size_t stackSize = TaskController::GetThreadStackSize();
-  JS::SetNativeStackQuota(fc, JS::ThreadStackQuotaForSize(stackSize));
+  for (;;) {
+    size_t index = mState->mNextIndex++;
+    if (index >= mState->Length()) {
+      break;
+    }
+    if (!mState->Claim(index)) {
+      // The main thread decoded it instead.
+      continue;
+    }
 
-  size_t remaining = mDecodingSources.length();
-  for (auto& source : mDecodingSources) {
     RefPtr<JS::Stencil> stencil;
-    auto result = JS::DecodeStencil(fc, mDecodeOptions, source.range,
-                                    getter_AddRefs(stencil));
-    if (result != JS::TranscodeResult::Ok) {
-      failure();
-      return NS_OK;
+    if (fc) {
+      auto result =
+          JS::DecodeStencil(fc, mState->mDecodeOptions,
+                            mState->mDecodingSources[index].range,
+                            getter_AddRefs(stencil));
+      if (result != JS::TranscodeResult::Ok) {
+        stencil = nullptr;
+      }
     }
 
-    DebugOnly<int> writes = mPreloader->mDecodedStencils->Enqueue(stencil);
-    MOZ_ASSERT(writes == 1);
-
-    remaining--;
-    if (remaining) {
-      mPreloader->onDecodedStencilQueued();
-    }
+    mState->mStencils[index] = std::move(stencil);
+    // Publishes the stencil to the main thread.
+    mState->mStatus[index] = DecodeState::Status::Decoded;
+    mPreloader->OnDecodedStencil();
   }
 
-  mPreloader->OnDecodeTaskFinished();
+  if (--mState->mRunningTasks == 0) {
+    mPreloader->OnDecodeTaskFinished();
+  }
   return NS_OK;
 }
 
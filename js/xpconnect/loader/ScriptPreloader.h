@@ -17,8 +17,8 @@
 #include "mozilla/Monitor.h"
 #include "mozilla/Range.h"
 #include "mozilla/Result.h"
-#include "mozilla/SPSCQueue.h"
 #include "mozilla/StaticPtr.h"
+#include "mozilla/UniquePtr.h"
 #include "mozilla/Vector.h"
 #include "mozilla/loader/AutoMemMap.h"
 #include "MainThreadUtils.h"
@@ -166,21 +166,21 @@ class ScriptPreloader : public nsIObserver,
   //  - Read from the cache, and being decoded off thread. In this case:
   //      - mReadyToExecute is false
   //      - mDecodingScripts contains the CachedStencil
-  //      - mDecodedStencils have never contained the stencil
+  //      - mDecodeState hasn't decoded the stencil yet
   //      - mStencil is null
   //
   //  - Off-thread decode for the stencil has finished, but the stencil has not
-  //    yet been dequeued nor executed. In this case:
-  //      - mReadyToExecute is true
+  //    yet been taken nor executed. In this case:
+  //      - mReadyToExecute is false
   //      - mDecodingScripts contains the CachedStencil
-  //      - mDecodedStencils contains the decoded stencil
+  //      - mDecodeState holds the decoded stencil
   //      - mStencil is null
   //
   //  - Off-thread decode for the stencil has finished, and the stencil has
-  //    been dequeued, but has not yet been executed. In this case:
+  //    been taken, but has not yet been executed. In this case:
   //      - mReadyToExecute is true
   //      - mDecodingScripts no longer contains the CachedStencil
-  //      - mDecodedStencils no longer contains the decoded stencil
+  //      - mDecodeState no longer holds the decoded stencil
   //      - mStencil is non-null
   //
   //  - Fully decoded, and ready to be added to the next session's cache
@@ -362,6 +362,10 @@ class ScriptPreloader : public nsIObserver,
     // whenever it is first executed.
     bool mReadyToExecute = false;
 
+    // The index of this script in mDecodeState, while it's in
+    // mDecodingScripts.
+    uint32_t mDecodeIndex = 0;
+
     // True if this script is expected to run once per process. If so, its
     // JSScript instance will be dropped as soon as the script has
     // executed and been encoded into the cache.
@@ -448,29 +452,70 @@ class ScriptPreloader : public nsIObserver,
   bool StartDecodeTask(const JS::ReadOnlyDecodeOptions& decodeOptions,
                        Vector<JS::TranscodeSource>&& decodingSources);
 
+  // The most decode tasks to run in parallel.
+  static constexpr uint32_t kMaxDecodeTasks = 4;
+
+  // The sources of mDecodingScripts, and their decoded stencils, shared by
+  // the decode tasks. The tasks claim the sources in order, so that they are
+  // decoded in the order the previous session first used them, and the main
+  // thread can claim a source no task has started yet to decode it itself.
+  class DecodeState final {
+   public:
+    NS_INLINE_DECL_THREADSAFE_REFCOUNTING(DecodeState)
+
+    enum class Status : uint32_t { Pending, Claimed, Decoded };
+
+    DecodeState(const JS::ReadOnlyDecodeOptions& decodeOptions,
+                Vector<JS::TranscodeSource>&& decodingSources);
+
+    size_t Length() const { return mDecodingSources.length(); }
+
+    // Returns true if the caller should decode the source at aIndex.
+    bool Claim(size_t aIndex) {
+      return mStatus[aIndex].compareExchange(Status::Pending, Status::Claimed);
+    }
+
+    bool IsDecoded(size_t aIndex) const {
+      return mStatus[aIndex] == Status::Decoded;
+    }
+
+    JS::OwningDecodeOptions mDecodeOptions;
+    const Vector<JS::TranscodeSource> mDecodingSources;
+
+    // The stencils of the decoded sources. The stencil of a source whose
+    // decoding failed is null.
+    UniquePtr<RefPtr<JS::Stencil>[]> mStencils;
+    UniquePtr<Atomic<Status>[]> mStatus;
+
+    // The next source for a decode task to claim.
+    Atomic<size_t> mNextIndex{0};
+    Atomic<uint32_t> mRunningTasks{0};
+
+   private:
+    ~DecodeState() = default;
+  };
+
   class DecodeTask : public Runnable {
     ScriptPreloader* mPreloader;
-    JS::OwningDecodeOptions mDecodeOptions;
-    Vector<JS::TranscodeSource> mDecodingSources;
+    RefPtr<DecodeState> mState;
 
    public:
-    DecodeTask(ScriptPreloader* preloader,
-               const JS::ReadOnlyDecodeOptions& decodeOptions,
-               Vector<JS::TranscodeSource>&& decodingSources)
+    DecodeTask(ScriptPreloader* preloader, DecodeState* state)
         : Runnable("ScriptPreloaderDecodeTask"),
           mPreloader(preloader),
-          mDecodingSources(std::move(decodingSources)) {
-      mDecodeOptions.infallibleCopy(decodeOptions);
-    }
+          mState(state) {}
 
     NS_IMETHOD Run() override;
   };
 
   friend class DecodeTask;
 
-  void onDecodedStencilQueued();
+  void OnDecodedStencil();
   void OnDecodeTaskFinished();
-  void OnDecodeTaskFailed();
+
+  // Moves the stencil of aScript out of mDecodeState if it has been decoded,
+  // and returns whether aScript is ready to execute.
+  bool TakeDecodedStencil(CachedStencil* script);
 
  public:
   void FinishOffThreadDecode();
@@ -512,13 +557,11 @@ class ScriptPreloader : public nsIObserver,
   // The list of scripts currently being decoded in a background thread.
   LinkedList<CachedStencil> mDecodingScripts;
 
-  // The result of the decode task.
-  //
-  // This is emplaced when starting the decode task, with the capacity equal
-  // to the number of sources.
+  // The state of the decode tasks.
   //
-  // If the decode task failed, nullptr is enqueued.
-  Maybe<SPSCQueue<RefPtr<JS::Stencil>>> mDecodedStencils;
+  // This is set when starting the decode tasks, and cleared once every
+  // script in mDecodingScripts has been taken.
+  RefPtr<DecodeState> mDecodeState;
 
   // True is main-thread is blocked and we should notify with Monitor. Access
   // only while `mMonitor` is held.
@@ -1935,6 +1935,16 @@ void ReportJSRuntimeExplicitTreeStats(const JS::RuntimeStats& rtStats,
       "Immutable strings (such as JS scripts' source text) shared across all "
       "JSRuntimes.");
 
+  RREPORT_BYTES(rtPath + "runtime/wasm-module-cache/data"_ns, KIND_HEAP,
+                rtStats.runtime.wasmModuleCacheData,
+                "WebAssembly modules kept alive only by the cache of compiled "
+                "modules shared across all JSRuntimes.");
+
+  RREPORT_BYTES(rtPath + "runtime/wasm-module-cache/code"_ns, KIND_NONHEAP,
+                rtStats.runtime.wasmModuleCacheCode,
+                "Machine code of the WebAssembly modules kept alive only by "
+                "the cache of compiled modules shared across all JSRuntimes.");
+
   RREPORT_BYTES(rtPath + "runtime/shared-intl-data"_ns, KIND_HEAP,
                 rtStats.runtime.sharedIntlData,
                 "Shared internationalization data.");
@@ -2348,6 +2358,21 @@ void JSReporter::CollectReports(WindowPaths* windowPaths,
         " to RSS, only vsize.");
   }
 
+  // These are already counted elsewhere, they show how much of the memory
+  // asked to be backed by huge pages, see javascript.options.huge_pages.
+  if (rtStats.runtime.wasmHugePages > 0) {
+    REPORT_BYTES("wasm-huge-pages"_ns, KIND_OTHER,
+                 rtStats.runtime.wasmHugePages,
+                 "Committed wasm memory that asked the OS to back it with "
+                 "transparent huge pages.");
+  }
+  if (rtStats.runtime.jitHugePages > 0) {
+    REPORT_BYTES("jit-huge-pages"_ns, KIND_OTHER,
+                 rtStats.runtime.jitHugePages,
+                 "Committed JIT code memory that asked the OS to back it with "
+                 "transparent huge pages.");
+  }
+
   // Report the numbers for memory outside of realms.
 
   REPORT_BYTES("js-main-runtime/gc-heap/unused-chunks"_ns, KIND_OTHER,
@@ -41,6 +41,34 @@ nsIFrame* DepthOrderedFrameList::PopShallowestRoot() {
   return frame;
 }
 
+nsIFrame* DepthOrderedFrameList::PopShallowestRoot(
+    FunctionRef<bool(nsIFrame*)> aIsPreferred) {
+  const uint32_t depth = mList.LastElement().mDepth;
+  for (size_t i = mList.Length(); i > 0 && mList[i - 1].mDepth == depth;
+       --i) {
+    nsIFrame* frame = mList[i - 1].mFrame;
+    if (aIsPreferred(frame)) {
+      mList.RemoveElementAt(i - 1);
+      return frame;
+    }
+  }
+  return PopShallowestRoot();
+}
+
+nsIFrame* DepthOrderedFrameList::PopShallowestRootIf(
+    FunctionRef<bool(nsIFrame*)> aPredicate) {
+  for (size_t i = mList.Length(); i > 0; --i) {
+    nsIFrame* frame = mList[i - 1].mFrame;
+    if (aPredicate(frame)) {
+      // We don't expect frame to change depths.
+      MOZ_ASSERT(frame->GetDepthInFrameTree() == mList[i - 1].mDepth);
+      mList.RemoveElementAt(i - 1);
+      return frame;
+    }
+  }
+  return nullptr;
+}
+
 bool DepthOrderedFrameList::FrameIsAncestorOfAnyElement(
     nsIFrame* aFrame) const {
   MOZ_ASSERT(aFrame);
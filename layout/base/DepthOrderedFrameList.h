@@ -7,6 +7,7 @@
 #ifndef mozilla_DepthOrderedFrameList_h
 #define mozilla_DepthOrderedFrameList_h
 
+#include "mozilla/FunctionRef.h"
 #include "mozilla/ReverseIterator.h"
 #include "nsTArray.h"
 
@@ -23,6 +24,12 @@ class DepthOrderedFrameList {
   // Remove and return one of the shallowest dirty roots from the list.
   // (If two roots are at the same depth, order is indeterminate.)
   nsIFrame* PopShallowestRoot();
+  // Like PopShallowestRoot(), but picks a root for which aIsPreferred returns
+  // true over the other roots at the same depth.
+  nsIFrame* PopShallowestRoot(FunctionRef<bool(nsIFrame*)> aIsPreferred);
+  // Remove and return one of the shallowest dirty roots for which aPredicate
+  // returns true, or return null if there are none.
+  nsIFrame* PopShallowestRootIf(FunctionRef<bool(nsIFrame*)> aPredicate);
   // Remove all dirty roots.
   void Clear() { mList.Clear(); }
   // Is this frame one of the elements in the list?
@@ -103,6 +103,7 @@
 #include "mozilla/Sprintf.h"
 #include "mozilla/StaticAnalysisFunctions.h"
 #include "mozilla/StaticPrefs_apz.h"
+#include "mozilla/StaticPrefs_docshell.h"
 #include "mozilla/StaticPrefs_dom.h"
 #include "mozilla/StaticPrefs_font.h"
 #include "mozilla/StaticPrefs_image.h"
@@ -4628,7 +4629,9 @@ void PresShell::DoFlushPendingNotifications(mozilla::ChangesToFlush aFlush) {
                         ? FlushType::Layout
                         : FlushType::InterruptibleLayout) &&
       !mIsDestroying) {
-    if (DoFlushLayout(/* aInterruptible = */ flushType < FlushType::Layout)) {
+    const bool interruptible = flushType < FlushType::Layout;
+    if (DoFlushLayout(interruptible,
+                      interruptible ? nullptr : aFlush.mLayoutTarget)) {
       if (mContentToScrollTo) {
         DoScrollContentIntoView();
         if (mContentToScrollTo) {
@@ -4806,6 +4809,29 @@ MOZ_CAN_RUN_SCRIPT_BOUNDARY void PresShell::ContentInserted(
       aChild, nsCSSFrameConstructor::InsertionKind::Async);
 }
 
+MOZ_CAN_RUN_SCRIPT_BOUNDARY void PresShell::ContentRangeInserted(
+    nsIContent* aStartChild, nsIContent* aEndChild) {
+  MOZ_ASSERT(!nsContentUtils::IsSafeToRunScript());
+  MOZ_ASSERT(!mIsDocumentGone, "Unexpected ContentRangeInserted");
+  MOZ_ASSERT(aStartChild->OwnerDoc() == mDocument, "Unexpected document");
+
+  if (!mDidInitialize) {
+    return;
+  }
+
+  nsAutoCauseReflowNotifier crNotifier(this);
+
+  mPresContext->RestyleManager()->ContentRangeInserted(aStartChild, aEndChild);
+
+  // Lazy frame construction only marks the children, so this is cheap, and
+  // unlike a range insertion it is allowed to be async.
+  for (nsIContent* child = aStartChild; child != aEndChild;
+       child = child->GetNextSibling()) {
+    mFrameConstructor->ContentInserted(
+        child, nsCSSFrameConstructor::InsertionKind::Async);
+  }
+}
+
 MOZ_CAN_RUN_SCRIPT_BOUNDARY void PresShell::ContentWillBeRemoved(
     nsIContent* aChild, const BatchRemovalState*) {
   MOZ_ASSERT(!nsContentUtils::IsSafeToRunScript());
@@ -10342,6 +10368,11 @@ void PresShell::Freeze(bool aIncludeSubDocuments) {
   mFrozen = true;
   if (mDocument) {
     UpdateImageLockingState();
+    if (StaticPrefs::docshell_shistory_bfcache_discard_images()) {
+      // We are frozen to go into the bfcache, and our images are unlocked
+      // now.  Images that other documents still lock are kept.
+      mDocument->ImageTracker()->RequestDiscardAll();
+    }
   }
 }
 
@@ -10530,6 +10561,10 @@ bool PresShell::DoReflow(nsIFrame* target, bool aInterruptible,
   // This cache only lives throughout this reflow call.
   SelectionNodeCache cache(*this);
 
+  // The ArenaTArrays of this reflow allocate their buffers from
+  // mReflowArena, which frees them all at once when the reflow is done.
+  AutoTArrayArena reflowArena(mReflowArena);
+
   // Schedule a paint, but don't actually mark this frame as changed for
   // retained DL building purposes. If any child frames get moved, then
   // they will schedule paint again. We could probaby skip this, and just
@@ -10741,7 +10776,48 @@ void PresShell::DoVerifyReflow() {
 // used with Telemetry metrics
 #define NS_LONG_REFLOW_TIME_MS 5000
 
-bool PresShell::ProcessReflowCommands(bool aInterruptible) {
+bool PresShell::IsInViewport(nsIFrame* aFrame) {
+  ScrollContainerFrame* sf = GetRootScrollContainerFrame();
+  if (!sf) {
+    return true;
+  }
+  nsIFrame* scrolledFrame = sf->GetScrolledFrame();
+  if (!nsLayoutUtils::IsProperAncestorFrame(scrolledFrame, aFrame)) {
+    // Fixed-position content, or the root scroll container itself.
+    return true;
+  }
+  if (aFrame->HasAnyStateBits(NS_FRAME_FIRST_REFLOW)) {
+    // We don't know where it goes yet.
+    return true;
+  }
+  // The reflow hasn't positioned aFrame yet, so this uses its last position.
+  nsRect visibleRect(sf->GetScrollPosition(), sf->GetScrollPortRect().Size());
+  return visibleRect.Intersects(
+      nsRect(aFrame->GetOffsetTo(scrolledFrame), aFrame->GetSize()));
+}
+
+/* static */
+bool PresShell::DirtyRootMayAffectFrame(nsIFrame* aRoot, nsIFrame* aFrame) {
+  if (aRoot == aFrame || nsLayoutUtils::IsProperAncestorFrame(aRoot, aFrame) ||
+      nsLayoutUtils::IsProperAncestorFrame(aFrame, aRoot)) {
+    return true;
+  }
+  // Other dirty roots are reflow roots, which keep their size, but their
+  // overflow can still change the scroll range of the scroll containers
+  // around them. That moves aFrame if it's in one of those which isn't
+  // scrolled to the start, and so may get clamped or anchor-adjusted.
+  for (nsIFrame* f = aRoot->GetParent(); f; f = f->GetParent()) {
+    ScrollContainerFrame* sf = do_QueryFrame(f);
+    if (sf && sf->GetScrollPosition() != nsPoint() &&
+        nsLayoutUtils::IsProperAncestorFrame(f, aFrame)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool PresShell::ProcessReflowCommands(bool aInterruptible,
+                                      nsIContent* aTarget) {
   if (mDirtyRoots.IsEmpty() && !mShouldUnsuppressPainting &&
       !mPendingDidDoReflow) {
     // Nothing to do; bail out
@@ -10776,9 +10852,34 @@ bool PresShell::ProcessReflowCommands(bool aInterruptible) {
 
     OverflowChangedTracker overflowTracker;
 
+    const bool visibleRootsFirst =
+        aInterruptible &&
+        StaticPrefs::layout_interruptible_reflow_visible_roots_first();
+
+    MOZ_ASSERT(!aTarget || !aInterruptible,
+               "Selective flushes must run to completion");
+
     do {
       // Send an incremental reflow notification to the target frame.
-      nsIFrame* target = mDirtyRoots.PopShallowestRoot();
+      nsIFrame* target;
+      if (aTarget) {
+        // Reflowing a root may reconstruct or reflow away the frame we're
+        // flushing for, so look it up again every time.
+        nsIFrame* targetFrame = aTarget->GetPrimaryFrame();
+        target = targetFrame
+                     ? mDirtyRoots.PopShallowestRootIf([&](nsIFrame* aRoot) {
+                         return DirtyRootMayAffectFrame(aRoot, targetFrame);
+                       })
+                     : nullptr;
+        if (!target) {
+          break;
+        }
+      } else {
+        target = visibleRootsFirst
+                     ? mDirtyRoots.PopShallowestRoot(
+                           [&](nsIFrame* aRoot) { return IsInViewport(aRoot); })
+                     : mDirtyRoots.PopShallowestRoot();
+      }
 
       if (!target->IsSubtreeDirty()) {
         // It's not dirty anymore, which probably means the notification
@@ -10794,7 +10895,9 @@ bool PresShell::ProcessReflowCommands(bool aInterruptible) {
     } while (!interrupted && !mDirtyRoots.IsEmpty() &&
              (!aInterruptible || PR_IntervalNow() < deadline));
 
-    interrupted = !mDirtyRoots.IsEmpty();
+    // The dirty roots left by a selective flush don't affect its target, and
+    // DidDoReflow() schedules another reflow for them.
+    interrupted = !aTarget && !mDirtyRoots.IsEmpty();
 
     overflowTracker.Flush();
 
@@ -10835,9 +10938,9 @@ bool PresShell::ProcessReflowCommands(bool aInterruptible) {
   return !interrupted;
 }
 
-bool PresShell::DoFlushLayout(bool aInterruptible) {
+bool PresShell::DoFlushLayout(bool aInterruptible, nsIContent* aTarget) {
   mFrameConstructor->RecalcQuotesAndCounters();
-  return ProcessReflowCommands(aInterruptible);
+  return ProcessReflowCommands(aInterruptible, aTarget);
 }
 
 void PresShell::WindowSizeMoveDone() {
@@ -11821,6 +11924,20 @@ void PresShell::AddAnchorPosAnchor(const nsAtom* aName, nsIFrame* aFrame) {
 
   FrameTreeComparator cmp{aFrame};
 
+  // Frames are mostly constructed in tree order, so check whether the frame
+  // goes last before searching the whole array. Otherwise pages with many
+  // anchors of the same name pay for a binary search of tree position
+  // comparisons per anchor.
+  const int32_t lastCmp = cmp(entry.LastElement());
+  if (lastCmp < 0) {
+    entry.AppendElement(aFrame);
+    return;
+  }
+  if (lastCmp == 0) {
+    MOZ_ASSERT_UNREACHABLE("Anchor added already");
+    return;
+  }
+
   size_t matchOrInsertionIdx = entry.Length();
   // If the same element is already in the array,
   // someone forgot to call RemoveAnchorPosAnchor.
@@ -12140,7 +12257,8 @@ void PresShell::AddSizeOfIncludingThis(nsWindowSizes& aSizes) const {
       mApproximatelyVisibleFrames.ShallowSizeOfExcludingThis(mallocSizeOf) +
       mFramesToDirty.ShallowSizeOfExcludingThis(mallocSizeOf) +
       mPendingScrollAnchorSelection.ShallowSizeOfExcludingThis(mallocSizeOf) +
-      mPendingScrollAnchorAdjustment.ShallowSizeOfExcludingThis(mallocSizeOf);
+      mPendingScrollAnchorAdjustment.ShallowSizeOfExcludingThis(mallocSizeOf) +
+      mReflowArena.SizeOfExcludingThis(mallocSizeOf);
 
   aSizes.mLayoutTextRunsSize += SizeOfTextRuns(mallocSizeOf);
 
@@ -15,6 +15,7 @@
 #include "FrameMetrics.h"
 #include "LayoutConstants.h"
 #include "mozilla/ArenaObjectID.h"
+#include "mozilla/ArenaTArray.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/dom/DocumentBinding.h"
 #include "mozilla/FlushType.h"
@@ -396,8 +397,13 @@ class PresShell final : public nsStubDocumentObserver,
    * Updates pending layout, assuming reasonable (up-to-date, or mid-update for
    * container queries) styling of the page. Returns whether a reflow did not
    * get interrupted (and thus layout should be considered fully up-to-date).
+   *
+   * If aTarget is given, only the dirty roots that may affect the geometry of
+   * its primary frame are reflowed, and the other ones are left for the next
+   * refresh driver tick.
    */
-  MOZ_CAN_RUN_SCRIPT_BOUNDARY bool DoFlushLayout(bool aInterruptible);
+  MOZ_CAN_RUN_SCRIPT_BOUNDARY bool DoFlushLayout(bool aInterruptible,
+                                                 nsIContent* aTarget = nullptr);
 
   /**
    * Note that the assumptions that determine whether we need a mobile viewport
@@ -1394,6 +1400,13 @@ class PresShell final : public nsStubDocumentObserver,
   NS_DECL_NSIMUTATIONOBSERVER_CONTENTINSERTED
   NS_DECL_NSIMUTATIONOBSERVER_CONTENTREMOVED
 
+  /**
+   * Like ContentInserted, for the children from aStartChild up to aEndChild
+   * (exclusive), which were inserted one after another before the pres shell
+   * got notified.  See AutoContentRangeInsertion.
+   */
+  void ContentRangeInserted(nsIContent* aStartChild, nsIContent* aEndChild);
+
   NS_DECL_NSIOBSERVER
 
   // Inline methods defined in PresShellInlines.h
@@ -1892,9 +1905,18 @@ class PresShell final : public nsStubDocumentObserver,
 
   friend class ::AutoPointerEventTargetUpdater;
 
+  // Whether aFrame, a dirty root, was last laid out inside the viewport.
+  bool IsInViewport(nsIFrame* aFrame);
+
+  // Whether reflowing aRoot, a dirty root, may change the geometry of aFrame.
+  static bool DirtyRootMayAffectFrame(nsIFrame* aRoot, nsIFrame* aFrame);
+
   // ProcessReflowCommands returns whether we processed all our dirty roots
-  // without interruptions.
-  MOZ_CAN_RUN_SCRIPT bool ProcessReflowCommands(bool aInterruptible);
+  // without interruptions. If aTarget is given, it only processes the ones
+  // that may affect the geometry of its primary frame, and returns true if it
+  // processed all of those.
+  MOZ_CAN_RUN_SCRIPT bool ProcessReflowCommands(bool aInterruptible,
+                                                nsIContent* aTarget = nullptr);
 
   /**
    * Callback handler for whether reflow happened.
@@ -3260,6 +3282,8 @@ class PresShell final : public nsStubDocumentObserver,
 
   using Arena = nsPresArena<8192, ArenaObjectID, eArenaObjectID_COUNT>;
   Arena mFrameArena;
+  // The buffers of the ArenaTArrays of our reflows, freed after each.
+  TArrayArena mReflowArena;
 
   Maybe<nsPoint> mVisualViewportOffset;
 
@@ -84,6 +84,18 @@ void RestyleManager::ContentInserted(nsIContent* aChild) {
   RestyleForInsertOrChange(aChild);
 }
 
+void RestyleManager::ContentRangeInserted(nsIContent* aStartChild,
+                                          nsIContent* aEndChild) {
+  MOZ_ASSERT(aStartChild->GetParentNode());
+  for (nsIContent* child = aStartChild; child != aEndChild;
+       child = child->GetNextSibling()) {
+    if (child->IsElement()) {
+      StyleSet()->MaybeInvalidateForElementInsertion(*child->AsElement());
+    }
+  }
+  RestyleForInsertOrChange(aStartChild, aEndChild);
+}
+
 void RestyleManager::ContentAppended(nsIContent* aFirstNewContent) {
   MOZ_ASSERT(aFirstNewContent->GetParentNode());
 
@@ -206,16 +218,20 @@ void RestyleManager::RestyleForEmptyChange(Element* aContainer) {
 }
 
 void RestyleManager::MaybeRestyleForEdgeChildChange(nsINode* aContainer,
-                                                    nsIContent* aChangedChild) {
+                                                    nsIContent* aStartChild,
+                                                    nsIContent* aEndChild) {
   MOZ_ASSERT(aContainer->GetSelectorFlags() &
              NodeSelectorFlags::HasEdgeChildSelector);
-  MOZ_ASSERT(aChangedChild->GetParent() == aContainer);
-  // restyle the previously-first element child if it is after this node
+  MOZ_ASSERT(aStartChild->GetParent() == aContainer);
+  nsIContent* lastChild =
+      aEndChild ? aEndChild->GetPreviousSibling() : aContainer->GetLastChild();
+  // restyle the previously-first element child if it is after these nodes
   bool passedChild = false;
   for (nsIContent* content = aContainer->GetFirstChild(); content;
        content = content->GetNextSibling()) {
-    if (content == aChangedChild) {
+    if (content == aStartChild) {
       passedChild = true;
+      content = lastChild;
       continue;
     }
     if (content->IsElement()) {
@@ -229,12 +245,13 @@ void RestyleManager::MaybeRestyleForEdgeChildChange(nsINode* aContainer,
       break;
     }
   }
-  // restyle the previously-last element child if it is before this node
+  // restyle the previously-last element child if it is before these nodes
   passedChild = false;
   for (nsIContent* content = aContainer->GetLastChild(); content;
        content = content->GetPreviousSibling()) {
-    if (content == aChangedChild) {
+    if (content == lastChild) {
       passedChild = true;
+      content = aStartChild;
       continue;
     }
     if (content->IsElement()) {
@@ -272,11 +289,18 @@ bool WhitespaceOnlyChangedOnAppend(const CharT* aBuffer, size_t aOldLength,
   return !WhitespaceOnly(aBuffer + aOldLength, aNewLength - aOldLength);
 }
 
-static bool HasAnySignificantSibling(Element* aContainer, nsIContent* aChild) {
-  MOZ_ASSERT(aChild->GetParent() == aContainer);
+// Whether aContainer has significant children other than the ones from
+// aStartChild up to aEndChild (exclusive).
+static bool HasAnySignificantSibling(Element* aContainer,
+                                     nsIContent* aStartChild,
+                                     nsIContent* aEndChild) {
+  MOZ_ASSERT(aStartChild->GetParent() == aContainer);
+  nsIContent* lastChild =
+      aEndChild ? aEndChild->GetPreviousSibling() : aContainer->GetLastChild();
   for (nsIContent* child = aContainer->GetFirstChild(); child;
        child = child->GetNextSibling()) {
-    if (child == aChild) {
+    if (child == aStartChild) {
+      child = lastChild;
       continue;
     }
     // We don't know whether we're testing :empty or :-moz-only-whitespace,
@@ -355,7 +379,8 @@ void RestyleManager::CharacterDataChanged(
   }
 
   if (slowSelectorFlags & NodeSelectorFlags::HasEmptySelector) {
-    if (!HasAnySignificantSibling(parent->AsElement(), aContent)) {
+    if (!HasAnySignificantSibling(parent->AsElement(), aContent,
+                                  aContent->GetNextSibling())) {
       // We used to be empty, restyle the parent.
       RestyleForEmptyChange(parent->AsElement());
       return;
@@ -363,7 +388,8 @@ void RestyleManager::CharacterDataChanged(
   }
 
   if (slowSelectorFlags & NodeSelectorFlags::HasEdgeChildSelector) {
-    MaybeRestyleForEdgeChildChange(parent, aContent);
+    MaybeRestyleForEdgeChildChange(parent, aContent,
+                                   aContent->GetNextSibling());
   }
 }
 
@@ -374,7 +400,12 @@ void RestyleManager::CharacterDataChanged(
 // The comments are written and variables are named in terms of it being
 // a ContentInserted notification.
 void RestyleManager::RestyleForInsertOrChange(nsIContent* aChild) {
-  nsINode* container = aChild->GetParentNode();
+  RestyleForInsertOrChange(aChild, aChild->GetNextSibling());
+}
+
+void RestyleManager::RestyleForInsertOrChange(nsIContent* aStartChild,
+                                              nsIContent* aEndChild) {
+  nsINode* container = aStartChild->GetParentNode();
   MOZ_ASSERT(container);
 
   const auto selectorFlags =
@@ -383,7 +414,7 @@ void RestyleManager::RestyleForInsertOrChange(nsIContent* aChild) {
     return;
   }
 
-  NS_ASSERTION(!aChild->IsRootOfNativeAnonymousSubtree(),
+  NS_ASSERTION(!aStartChild->IsRootOfNativeAnonymousSubtree(),
                "anonymous nodes should not be in child lists");
 
   // The container cannot be a document.
@@ -393,8 +424,8 @@ void RestyleManager::RestyleForInsertOrChange(nsIContent* aChild) {
       container->IsElement()) {
     // See whether we need to restyle the container due to :empty /
     // :-moz-only-whitespace.
-    const bool wasEmpty =
-        !HasAnySignificantSibling(container->AsElement(), aChild);
+    const bool wasEmpty = !HasAnySignificantSibling(container->AsElement(),
+                                                    aStartChild, aEndChild);
     if (wasEmpty) {
       // FIXME(emilio): When coming from CharacterDataChanged this can restyle
       // unnecessarily. Also can restyle unnecessarily if aChild is not
@@ -411,17 +442,19 @@ void RestyleManager::RestyleForInsertOrChange(nsIContent* aChild) {
   }
 
   if (selectorFlags & NodeSelectorFlags::HasSlowSelectorLaterSiblings) {
-    // Restyle all later siblings.
+    // Restyle all later siblings, once for the whole range rather than from
+    // every inserted child in turn.
     if (selectorFlags & NodeSelectorFlags::HasSlowSelectorNthAll) {
       StyleSet()->MaybeInvalidateRelativeSelectorForNthDependencyFromSibling(
-          aChild->GetNextElementSibling(), /* aForceRestyleSiblings = */ true);
+          aStartChild->GetNextElementSibling(),
+          /* aForceRestyleSiblings = */ true);
     } else {
-      RestyleSiblingsStartingWith(aChild->GetNextSibling());
+      RestyleSiblingsStartingWith(aStartChild->GetNextSibling());
     }
   }
 
   if (selectorFlags & NodeSelectorFlags::HasEdgeChildSelector) {
-    MaybeRestyleForEdgeChildChange(container, aChild);
+    MaybeRestyleForEdgeChildChange(container, aStartChild, aEndChild);
   }
 }
 
@@ -1409,6 +1442,33 @@ static nsIContent* NextSiblingWhichMayHaveFrame(nsIContent* aContent) {
   return nullptr;
 }
 
+// Whether aNext, a child that needs frames after aPrev, can be constructed in
+// the same range of children as aPrev.  That's the case if they're adjacent,
+// but also if the siblings between them don't have frames and won't get any,
+// like display: none elements or collapsed whitespace, since frame
+// construction just skips them again.  This keeps a script that appends lots
+// of children, some of them hidden, from constructing them one by one.
+//
+// display: contents siblings don't have a frame, but their children might.
+static bool CanConstructInSameRange(nsIContent* aPrev, nsIContent* aNext) {
+  if (aPrev->GetParent() != aNext->GetParent()) {
+    return false;
+  }
+  for (nsIContent* sibling = NextSiblingWhichMayHaveFrame(aPrev);
+       sibling != aNext; sibling = NextSiblingWhichMayHaveFrame(sibling)) {
+    if (!sibling || sibling->GetPrimaryFrame() ||
+        sibling->HasFlag(NODE_NEEDS_FRAME)) {
+      return false;
+    }
+    if (Element* element = Element::FromNode(sibling)) {
+      if (!element->HasServoData() || element->IsDisplayContents()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 // If |aFrame| is dirty or has dirty children, then we can skip updating
 // overflows since that will happen when it's reflowed.
 static inline bool CanSkipOverflowUpdates(const nsIFrame* aFrame) {
@@ -1617,15 +1677,16 @@ void RestyleManager::ProcessRestyledFrames(nsStyleChangeList& aChangeList) {
   bool didUpdateCursor = false;
 
   for (size_t i = 0; i < aChangeList.Length(); ++i) {
-    // Collect and coalesce adjacent siblings for lazy frame construction.
-    // Eventually it would be even better to make RecreateFramesForContent
-    // accept a range and coalesce all adjacent reconstructs (bug 1344139).
+    // Collect and coalesce siblings for lazy frame construction, see
+    // CanConstructInSameRange.  Eventually it would be even better to make
+    // RecreateFramesForContent accept a range and coalesce all adjacent
+    // reconstructs (bug 1344139).
     size_t lazyRangeStart = i;
     while (i < aChangeList.Length() && aChangeList[i].mContent &&
            aChangeList[i].mContent->HasFlag(NODE_NEEDS_FRAME) &&
            (i == lazyRangeStart ||
-            NextSiblingWhichMayHaveFrame(aChangeList[i - 1].mContent) ==
-                aChangeList[i].mContent)) {
+            CanConstructInSameRange(aChangeList[i - 1].mContent,
+                                    aChangeList[i].mContent))) {
       MOZ_ASSERT(aChangeList[i].mHint & nsChangeHint_ReconstructFrame);
       MOZ_ASSERT(!aChangeList[i].mFrame);
       ++i;
@@ -3173,6 +3234,16 @@ void RestyleManager::ClearSnapshots() {
   }
 }
 
+void RestyleManager::DropUnchangedSnapshots() {
+  for (auto iter = mSnapshots.Iter(); !iter.Done(); iter.Next()) {
+    Element* element = iter.Key();
+    if (iter.Data()->IsUnchanged(*element)) {
+      element->UnsetFlags(ELEMENT_HAS_SNAPSHOT);
+      iter.Remove();
+    }
+  }
+}
+
 ServoElementSnapshot& RestyleManager::SnapshotFor(Element& aElement) {
   MOZ_DIAGNOSTIC_ASSERT(!mInStyleRefresh);
 
@@ -3255,6 +3326,8 @@ void RestyleManager::DoProcessPendingRestyles(ServoTraversalFlags aFlags) {
     aFlags |= ServoTraversalFlags::ForCSSRuleChanges;
   }
 
+  DropUnchangedSnapshots();
+
   while (styleSet->StyleDocument(aFlags)) {
     ClearSnapshots();
     mRestyledAsWholeContainer.Clear();
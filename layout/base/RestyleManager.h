@@ -320,6 +320,9 @@ class RestyleManager {
   }
 
   void ContentInserted(nsIContent* aChild);
+  // Like ContentInserted, for the children from aStartChild up to aEndChild
+  // (exclusive), which were all inserted before we got notified.
+  void ContentRangeInserted(nsIContent* aStartChild, nsIContent* aEndChild);
   void ContentAppended(nsIContent* aFirstNewContent);
 
   // Restyling for a content removal that is about to happen.
@@ -328,6 +331,8 @@ class RestyleManager {
   // Restyling for a ContentInserted (notification after insertion) or
   // for some CharacterDataChanged.
   void RestyleForInsertOrChange(nsIContent* aChild);
+  void RestyleForInsertOrChange(nsIContent* aStartChild,
+                                nsIContent* aEndChild);
 
   // Restyle for a CharacterDataChanged notification. In practice this can only
   // affect :empty / :-moz-only-whitespace / :-moz-first-node / :-moz-last-node.
@@ -510,8 +515,10 @@ class RestyleManager {
   void RestyleSiblingsStartingWith(nsIContent* aStartingSibling);
 
   void RestyleForEmptyChange(Element* aContainer);
+  // aStartChild up to aEndChild (exclusive) are the changed children.
   void MaybeRestyleForEdgeChildChange(nsINode* aContainer,
-                                      nsIContent* aChangedChild);
+                                      nsIContent* aStartChild,
+                                      nsIContent* aEndChild);
 
   bool IsDisconnected() const { return !mPresContext; }
 
@@ -565,6 +572,10 @@ class RestyleManager {
 
   const SnapshotTable& Snapshots() const { return mSnapshots; }
   void ClearSnapshots();
+  // Drops the snapshots of elements whose attributes were changed back to
+  // the values they had when the snapshot was taken, e.g. by a class toggled
+  // twice, so that style invalidation doesn't look at them.
+  void DropUnchangedSnapshots();
   ServoElementSnapshot& SnapshotFor(Element&);
   void TakeSnapshotForAttributeChange(Element&, int32_t aNameSpaceID,
                                       nsAtom* aAttribute);
@@ -2822,6 +2822,43 @@ struct TemporaryDisplayListBuilder {
   RetainedDisplayListMetrics mMetrics;
 };
 
+// A marker for each display list build of PaintFrame, with the item counts of
+// partial builds, for telling which pages spend their paints building display
+// lists.
+struct DisplayListBuildMarker {
+  static constexpr Span<const char> MarkerTypeName() {
+    return MakeStringSpan("DisplayListBuild");
+  }
+  static void StreamJSONMarkerData(baseprofiler::SpliceableJSONWriter& aWriter,
+                                   const ProfilerString8View& aBuild,
+                                   const ProfilerString8View& aFailReason,
+                                   uint32_t aNewItems, uint32_t aReusedItems,
+                                   uint32_t aRebuiltItems,
+                                   uint32_t aRemovedItems) {
+    aWriter.StringProperty("build", aBuild);
+    aWriter.StringProperty("failReason", aFailReason);
+    aWriter.IntProperty("newItems", aNewItems);
+    aWriter.IntProperty("reusedItems", aReusedItems);
+    aWriter.IntProperty("rebuiltItems", aRebuiltItems);
+    aWriter.IntProperty("removedItems", aRemovedItems);
+  }
+  static MarkerSchema MarkerTypeDisplay() {
+    using MS = MarkerSchema;
+    MS schema{MS::Location::MarkerChart, MS::Location::MarkerTable};
+    schema.AddKeyLabelFormat("build", "Build", MS::Format::String);
+    schema.AddKeyLabelFormat("failReason", "Partial build fail reason",
+                             MS::Format::String);
+    schema.AddKeyLabelFormat("newItems", "New items", MS::Format::Integer);
+    schema.AddKeyLabelFormat("reusedItems", "Reused items",
+                             MS::Format::Integer);
+    schema.AddKeyLabelFormat("rebuiltItems", "Rebuilt items",
+                             MS::Format::Integer);
+    schema.AddKeyLabelFormat("removedItems", "Removed items",
+                             MS::Format::Integer);
+    return schema;
+  }
+};
+
 void nsLayoutUtils::PaintFrame(gfxContext* aRenderingContext, nsIFrame* aFrame,
                                const nsRegion& aDirtyRegion, nscolor aBackstop,
                                nsDisplayListBuilderMode aBuilderMode,
@@ -3196,6 +3233,20 @@ void nsLayoutUtils::PaintFrame(gfxContext* aRenderingContext, nsIFrame* aFrame,
 
   const double geckoDLBuildTime =
       (TimeStamp::Now() - startBuildDisplayList).ToMilliseconds();
+  if (profiler_thread_is_being_profiled_for_markers()) {
+    const bool partial =
+        metrics->mPartialUpdateResult != PartialUpdateResult::Failed;
+    profiler_add_marker(
+        "DisplayListBuild", geckoprofiler::category::GRAPHICS,
+        MarkerTiming::IntervalUntilNowFrom(startBuildDisplayList),
+        DisplayListBuildMarker{},
+        ProfilerString8View::WrapNullTerminatedString(partial ? "Partial"
+                                                              : "Full"),
+        ProfilerString8View::WrapNullTerminatedString(
+            partial ? "" : metrics->FailReasonString()),
+        metrics->mNewItems, metrics->mReusedItems, metrics->mRebuiltItems,
+        metrics->mRemovedItems);
+  }
   mozilla::glean::paint::build_displaylist_time.StopAndAccumulate(
       std::move(dlTimerId));
 
@@ -1063,6 +1063,8 @@ void nsPresContext::DetachPresShell() {
   }
 }
 
+// The size of a query container that the styles of its descendants were last
+// computed against.
 struct QueryContainerState {
   nsSize mSize;
   WritingMode mWm;
@@ -1123,17 +1125,20 @@ bool nsPresContext::UpdateContainerQueryStyles() {
                                        frame->GetWritingMode(), type};
     QueryContainerState* oldState = frame->GetProperty(ContainerState());
 
-    const bool changed = !oldState || oldState->Changed(newState);
-
-    // Make sure to update the state regardless. It's cheap and it keeps tracks
-    // of both axes correctly even if only one axis is contained.
-    if (oldState) {
-      *oldState = newState;
-    } else {
-      frame->SetProperty(ContainerState(), new QueryContainerState(newState));
-    }
+    auto updateState = [&] {
+      if (oldState) {
+        *oldState = newState;
+      } else {
+        frame->SetProperty(ContainerState(),
+                           new QueryContainerState(newState));
+      }
+    };
 
-    if (!changed) {
+    if (oldState && !oldState->Changed(newState)) {
+      // Nothing our queries look at changed. Update the state anyway, it's
+      // cheap and it keeps track of both axes correctly even if only one axis
+      // is contained.
+      updateState();
       continue;
     }
 
@@ -1148,17 +1153,21 @@ bool nsPresContext::UpdateContainerQueryStyles() {
 
     if (updatingAncestor) {
       // We're going to update an ancestor container of this frame already,
-      // avoid updating this one too until all our ancestor containers are
-      // updated.
+      // which restyles our descendants against our current size, so avoid
+      // updating this one too until all our ancestor containers are updated.
+      updateState();
       continue;
     }
 
     // To prevent unstable layout, only update once per-element per-flush.
+    // Keep the old state in that case, so that the next flush restyles our
+    // descendants if we're still at a size they weren't styled against.
     if (NS_WARN_IF(!mUpdatedContainerQueryContents.EnsureInserted(
             frame->GetContent()))) {
       continue;
     }
 
+    updateState();
     framesToUpdate.AppendElement(frame);
 
     // TODO(emilio): More fine-grained invalidation rather than invalidating the
@@ -2711,6 +2720,26 @@ bool nsPresContext::CheckForInterrupt(nsIFrame* aFrame) {
   return mHasPendingInterrupt;
 }
 
+bool nsPresContext::CheckForTimeSliceInterrupt(nsIFrame* aFrame) {
+  if (CheckForInterrupt(aFrame)) {
+    return true;
+  }
+
+  uint32_t timeSlice = StaticPrefs::layout_interruptible_reflow_time_slice_ms();
+  if (!mInterruptsEnabled || !timeSlice || IsChrome() ||
+      TimeStamp::Now() - mReflowStartTime <=
+          TimeDuration::FromMilliseconds(timeSlice)) {
+    return false;
+  }
+
+#ifdef NOISY_INTERRUPTIBLE_REFLOW
+  printf("*** Time slice used up (time=%lld)\n", PR_Now());
+#endif /* NOISY_INTERRUPTIBLE_REFLOW */
+  mHasPendingInterrupt = true;
+  mPresShell->FrameNeedsToContinueReflow(aFrame);
+  return true;
+}
+
 nsIFrame* nsPresContext::GetPrimaryFrameFor(nsIContent* aContent) {
   MOZ_ASSERT(aContent, "Don't do that");
   if (GetPresShell() &&
@@ -1014,6 +1014,27 @@ class nsPresContext : public nsISupports, public mozilla::SupportsWeakPtr {
    * PresShell::FrameNeedsToContinueReflow.
    */
   bool CheckForInterrupt(nsIFrame* aFrame);
+  /**
+   * Like CheckForInterrupt, but also interrupts the reflow once it has run
+   * for longer than layout.interruptible-reflow.time-slice-ms. Callers must
+   * only use this once the content they have reflowed reaches below the
+   * viewport, so that the work deferred to the next reflow is off-screen.
+   */
+  bool CheckForTimeSliceInterrupt(nsIFrame* aFrame);
+
+  /**
+   * Counts the lookups in the measurement caches of flex and grid items (see
+   * mozilla::MeasurementCache), for the layout debugger.
+   */
+  void CountMeasurementCacheLookup(bool aHit) {
+    if (aHit) {
+      mMeasurementCacheHits++;
+    } else {
+      mMeasurementCacheMisses++;
+    }
+  }
+  uint32_t MeasurementCacheHits() const { return mMeasurementCacheHits; }
+  uint32_t MeasurementCacheMisses() const { return mMeasurementCacheMisses; }
   /**
    * Returns true if CheckForInterrupt has returned true since the last
    * ReflowStarted call. Cannot itself trigger an interrupt check.
@@ -1296,6 +1317,9 @@ class nsPresContext : public nsISupports, public mozilla::SupportsWeakPtr {
 
   uint32_t mInterruptChecksToSkip;
 
+  uint32_t mMeasurementCacheHits = 0;
+  uint32_t mMeasurementCacheMisses = 0;
+
   // During page load we use slower frame rate.
   uint32_t mNextFrameRateMultiplier;
 
@@ -1442,6 +1442,7 @@ nsRefreshDriver::nsRefreshDriver(nsPresContext* aPresContext)
              "and decrement sRefreshDriverCount.");
   mMostRecentRefresh = TimeStamp::Now();
   mNextThrottledFrameRequestTick = mMostRecentRefresh;
+  mNextReducedRateFrameRequestTick = mMostRecentRefresh;
   mNextRecomputeVisibilityTick = mMostRecentRefresh;
 
   if (!sRegularRateTimerList) {
@@ -2151,6 +2152,25 @@ void nsRefreshDriver::RunVideoAndFrameRequestCallbacks(TimeStamp aNowTime) {
     return false;
   }();
 
+  const bool tickReducedRateFrameRequests = [&] {
+    const TimeDuration defaultInterval =
+        TimeDuration::FromMilliseconds(DefaultInterval());
+    if (!StaticPrefs::layout_reduce_frame_rate_of_inactive_iframes() ||
+        sMostRecentHighRateVsync.IsNull() ||
+        sMostRecentHighRateVsync + defaultInterval < aNowTime) {
+      // We're not ticking faster than the default rate.
+      return true;
+    }
+    if (aNowTime >= mNextReducedRateFrameRequestTick) {
+      // Allow for half a vsync of jitter, so that we tick at the default rate
+      // rather than skip every other tick.
+      mNextReducedRateFrameRequestTick =
+          aNowTime + defaultInterval - sMostRecentHighRate.MultDouble(0.5);
+      return true;
+    }
+    return false;
+  }();
+
   if (NS_WARN_IF(!mPresContext)) {
     return;
   }
@@ -2173,6 +2193,10 @@ void nsRefreshDriver::RunVideoAndFrameRequestCallbacks(TimeStamp aNowTime) {
       skippedAnyThrottledDoc = true;
       return false;
     }
+    if (!tickReducedRateFrameRequests && aDoc->ShouldReduceFrameRequestRate()) {
+      skippedAnyThrottledDoc = true;
+      return false;
+    }
     return true;
   };
   if (ShouldCollect(mPresContext->Document())) {
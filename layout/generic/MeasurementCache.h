@@ -0,0 +1,124 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_MeasurementCache_h
+#define mozilla_MeasurementCache_h
+
+#include "mozilla/ReflowInput.h"
+#include "nsIFrame.h"
+#include "nsPresContext.h"
+#include "nsTArray.h"
+
+namespace mozilla {
+
+/**
+ * The results of the most recent measuring reflows of a flex or grid item,
+ * which their container uses to skip measuring reflows whose result it
+ * already knows.  Without this, measuring reflows of nested flex and grid
+ * containers are exponential in the nesting depth.
+ *
+ * A container's sizing algorithm measures an item under a few different
+ * conditions (e.g. for its min-content and max-content contributions, and
+ * with and without stretching), so the cache keeps the last kCapacity
+ * results, each keyed by the parts of the item's ReflowInput that can
+ * affect it:
+ *   - its available size
+ *   - its percentage basis (the containing block size)
+ *   - its computed size and min/max block size, which reflect the sizing
+ *     constraints of the measurement
+ *   - its baseline padding, which grid containers use for baseline
+ *     alignment
+ *
+ * Like the item's intrinsic sizes, the results must be discarded when the
+ * item's subtree is marked dirty.  Lookups are counted per pres context, and
+ * reported by the layout debugger's reflow stats.
+ */
+class MeasurementCache final {
+ public:
+  struct Key final {
+    Key(const nsIFrame* aFrame, const ReflowInput& aReflowInput)
+        : mAvailableSize(aReflowInput.AvailableSize()),
+          mPercentageBasis(aReflowInput.mContainingBlockSize),
+          mComputedSize(aReflowInput.ComputedSize()),
+          mComputedMinBSize(aReflowInput.ComputedMinBSize()),
+          mComputedMaxBSize(aReflowInput.ComputedMaxBSize()),
+          mBaselinePadding(
+              aFrame->GetProperty(nsIFrame::BBaselinePadProperty())) {}
+
+    bool operator==(const Key& aOther) const {
+      return mAvailableSize == aOther.mAvailableSize &&
+             mPercentageBasis == aOther.mPercentageBasis &&
+             mComputedSize == aOther.mComputedSize &&
+             mComputedMinBSize == aOther.mComputedMinBSize &&
+             mComputedMaxBSize == aOther.mComputedMaxBSize &&
+             mBaselinePadding == aOther.mBaselinePadding;
+    }
+
+    LogicalSize mAvailableSize;
+    LogicalSize mPercentageBasis;
+    LogicalSize mComputedSize;
+    nscoord mComputedMinBSize;
+    nscoord mComputedMaxBSize;
+    nscoord mBaselinePadding;
+  };
+
+  // A measurement, in the item's writing mode.  Callers decide whether they
+  // store border-box or content-box sizes.
+  struct Entry final {
+    Key mKey;
+    nscoord mISize;
+    nscoord mBSize;
+  };
+
+  static constexpr size_t kCapacity = 4;
+
+  /**
+   * Returns the measurement of aFrame for aKey, if there is one and aFrame
+   * hasn't been marked dirty since.
+   */
+  const Entry* Lookup(const nsIFrame* aFrame, const Key& aKey) {
+    const Entry* found = nullptr;
+    if (!aFrame->IsSubtreeDirty()) {
+      for (size_t i = 0; i < mEntries.Length(); ++i) {
+        if (mEntries[i].mKey == aKey) {
+          // Keep the most recently used entry first.
+          if (i != 0) {
+            Entry entry = mEntries[i];
+            mEntries.RemoveElementAt(i);
+            mEntries.InsertElementAt(0, entry);
+          }
+          found = &mEntries[0];
+          break;
+        }
+      }
+    }
+    aFrame->PresContext()->CountMeasurementCacheLookup(!!found);
+    return found;
+  }
+
+  void Insert(const Key& aKey, nscoord aISize, nscoord aBSize) {
+    mEntries.RemoveElementsBy(
+        [&](const Entry& aEntry) { return aEntry.mKey == aKey; });
+    if (mEntries.Length() == kCapacity) {
+      mEntries.RemoveLastElement();
+    }
+    mEntries.InsertElementAt(0, Entry{aKey, aISize, aBSize});
+  }
+
+  // The entry that was inserted or looked up last, if any.
+  const Entry* MostRecent() const {
+    return mEntries.IsEmpty() ? nullptr : &mEntries[0];
+  }
+
+  void Clear() { mEntries.Clear(); }
+
+ private:
+  AutoTArray<Entry, kCapacity> mEntries;
+};
+
+}  // namespace mozilla
+
+#endif  // mozilla_MeasurementCache_h
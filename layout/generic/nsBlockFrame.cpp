@@ -3034,6 +3034,49 @@ bool nsBlockFrame::LinesAreEmpty() const {
   return true;
 }
 
+// Whether aLine, which has just been reflowed, starts below the viewport.
+// Only blocks in the formatting context of the root element can tell: their
+// float manager is translated to their position relative to it.
+static bool IsLineBelowViewport(BlockReflowState& aState,
+                                const nsLineBox* aLine) {
+  if (!StaticPrefs::layout_interruptible_reflow_time_slice_ms() ||
+      aState.mReflowInput.GetWritingMode().IsVertical()) {
+    return false;
+  }
+
+  const nsIFrame* bfcRoot = aState.mBlock;
+  while (!bfcRoot->HasAnyStateBits(NS_BLOCK_BFC)) {
+    bfcRoot = bfcRoot->GetParent();
+    if (!bfcRoot) {
+      return false;
+    }
+  }
+  nsPresContext* presContext = aState.mPresContext;
+  if (bfcRoot->GetContent() != presContext->Document()->GetRootElement()) {
+    return false;
+  }
+
+  ScrollContainerFrame* sf =
+      presContext->PresShell()->GetRootScrollContainerFrame();
+  if (!sf) {
+    return false;
+  }
+  nscoord lineLeft, blockStart;
+  aState.FloatManager()->GetTranslation(lineLeft, blockStart);
+  return blockStart + aLine->BStart() >
+         sf->GetScrollPosition().y + sf->GetScrollPortRect().height;
+}
+
+// Checks for an interrupt after reflowing aLine, allowing time-sliced
+// reflows to stop once they have reached lines below the viewport.
+static bool CheckForInterrupt(BlockReflowState& aState,
+                              const nsLineBox* aLine) {
+  if (IsLineBelowViewport(aState, aLine)) {
+    return aState.mPresContext->CheckForTimeSliceInterrupt(aState.mBlock);
+  }
+  return aState.mPresContext->CheckForInterrupt(aState.mBlock);
+}
+
 bool nsBlockFrame::ReflowDirtyLines(BlockReflowState& aState) {
   bool keepGoing = true;
   bool repositionViews = false;  // should we really need this?
@@ -3435,7 +3478,7 @@ bool nsBlockFrame::ReflowDirtyLines(BlockReflowState& aState) {
       // Now do an interrupt check. We want to do this only in the case when we
       // actually reflow the line, so that if we get back in here we'll get
       // further on the reflow before interrupting.
-      aState.mPresContext->CheckForInterrupt(this);
+      CheckForInterrupt(aState, line);
     } else {
       aState.mOverflowTracker->Skip(line->mFirstChild, aState.mReflowStatus);
       // Nop except for blocks (we don't create overflow container
@@ -3683,7 +3726,7 @@ bool nsBlockFrame::ReflowDirtyLines(BlockReflowState& aState) {
             foundAnyClears = true;
           }
 
-          if (aState.mPresContext->CheckForInterrupt(this)) {
+          if (CheckForInterrupt(aState, line)) {
             MarkLineDirtyForInterrupt(line);
             break;
           }
@@ -15,6 +15,7 @@
 #include "mozilla/ComputedStyle.h"
 #include "mozilla/CSSOrderAwareFrameIterator.h"
 #include "mozilla/Logging.h"
+#include "mozilla/MeasurementCache.h"
 #include "mozilla/PresShell.h"
 #include "mozilla/StaticPrefs_layout.h"
 #include "mozilla/WritingModes.h"
@@ -37,7 +38,6 @@ using FlexItem = nsFlexContainerFrame::FlexItem;
 using FlexLine = nsFlexContainerFrame::FlexLine;
 using FlexboxAxisTracker = nsFlexContainerFrame::FlexboxAxisTracker;
 using StrutInfo = nsFlexContainerFrame::StrutInfo;
-using CachedBAxisMeasurement = nsFlexContainerFrame::CachedBAxisMeasurement;
 using CachedFlexItemData = nsFlexContainerFrame::CachedFlexItemData;
 
 static mozilla::LazyLogModule gFlexContainerLog("FlexContainer");
@@ -1818,97 +1818,47 @@ void nsFlexContainerFrame::ResolveAutoFlexBasisAndMinSize(
 }
 
 /**
- * A cached result for a flex item's block-axis measuring reflow. This cache
- * prevents us from doing exponential reflows in cases of deeply nested flex
- * and scroll frames.
+ * A flex item's block-axis measuring reflows are cached in a
+ * MeasurementCache, which prevents us from doing exponential reflows in cases
+ * of deeply nested flex and scroll frames. Its entries store the item's
+ * content-box BSize.
  *
- * We store the cached value in the flex item's frame property table, for
- * simplicity.
- *
- * Right now, we cache the following as a "key", from the item's ReflowInput:
- *   - its ComputedSize
- *   - its min/max block size (in case its ComputedBSize is unconstrained)
- *   - its AvailableBSize
- * ...and we cache the following as the "value", from the item's ReflowOutput:
- *   - its final content-box BSize
- *
- * The assumption here is that a given flex item measurement from our "value"
- * won't change unless one of the pieces of the "key" change, or the flex
- * item's intrinsic size is marked as dirty (due to a style or DOM change).
- * (The latter will cause the cached value to be discarded, in
+ * The assumption here is that a given flex item measurement won't change
+ * unless one of the pieces of the key change, or the flex item's intrinsic
+ * size is marked as dirty (due to a style or DOM change). (The latter will
+ * cause the cached values to be discarded, in
  * nsIFrame::MarkIntrinsicISizesDirty.)
  *
- * Note that the components of "Key" (mComputed{MinB,MaxB,}Size and
- * mAvailableBSize) are sufficient to catch any changes to the flex container's
- * size that the item may care about for its measuring reflow. Specifically:
+ * Note that the item's computed size, min/max block size and available size
+ * are sufficient to catch any changes to the flex container's size that the
+ * item may care about for its measuring reflow. Specifically:
  *  - If the item cares about the container's size (e.g. if it has a percent
  *    height and the container's height changes, in a horizontal-WM container)
  *    then that'll be detectable via the item's ReflowInput's "ComputedSize()"
- *    differing from the value in our Key.  And the same applies for the
+ *    differing from the value in the key.  And the same applies for the
  *    inline axis.
  *  - If the item is fragmentable (pending bug 939897) and its measured BSize
  *    depends on where it gets fragmented, then that sort of change can be
  *    detected due to the item's ReflowInput's "AvailableBSize()" differing
- *    from the value in our Key.
+ *    from the value in the key.
  *
  * One particular case to consider (& need to be sure not to break when
- * changing this class): the flex item's computed BSize may change between
+ * changing this code): the flex item's computed BSize may change between
  * measuring reflows due to how the mIsFlexContainerMeasuringBSize flag affects
  * size computation (see bug 1336708). This is one reason we need to use the
  * computed BSize as part of the key.
  */
-class nsFlexContainerFrame::CachedBAxisMeasurement {
-  struct Key {
-    const LogicalSize mComputedSize;
-    const nscoord mComputedMinBSize;
-    const nscoord mComputedMaxBSize;
-    const nscoord mAvailableBSize;
-
-    explicit Key(const ReflowInput& aRI)
-        : mComputedSize(aRI.ComputedSize()),
-          mComputedMinBSize(aRI.ComputedMinBSize()),
-          mComputedMaxBSize(aRI.ComputedMaxBSize()),
-          mAvailableBSize(aRI.AvailableBSize()) {}
-
-    bool operator==(const Key& aOther) const {
-      return mComputedSize == aOther.mComputedSize &&
-             mComputedMinBSize == aOther.mComputedMinBSize &&
-             mComputedMaxBSize == aOther.mComputedMaxBSize &&
-             mAvailableBSize == aOther.mAvailableBSize;
-    }
-  };
-
-  const Key mKey;
-
-  // This could/should be const, but it's non-const for now just because it's
-  // assigned via a series of steps in the constructor body:
-  nscoord mBSize;
-
- public:
-  CachedBAxisMeasurement(const ReflowInput& aReflowInput,
-                         const ReflowOutput& aReflowOutput)
-      : mKey(aReflowInput) {
-    // To get content-box bsize, we have to subtract off border & padding
-    // (and floor at 0 in case the border/padding are too large):
-    WritingMode itemWM = aReflowInput.GetWritingMode();
-    nscoord borderBoxBSize = aReflowOutput.BSize(itemWM);
-    mBSize =
-        borderBoxBSize -
-        aReflowInput.ComputedLogicalBorderPadding(itemWM).BStartEnd(itemWM);
-    mBSize = std::max(0, mBSize);
-  }
-
-  /**
-   * Returns true if this cached flex item measurement is valid for (i.e. can
-   * be expected to match the output of) a measuring reflow whose input
-   * parameters are given via aReflowInput.
-   */
-  bool IsValidFor(const ReflowInput& aReflowInput) const {
-    return mKey == Key(aReflowInput);
-  }
-
-  nscoord BSize() const { return mBSize; }
-};
+static nscoord ContentBoxBSizeForMeasurement(
+    const ReflowInput& aReflowInput, const ReflowOutput& aReflowOutput) {
+  // To get content-box bsize, we have to subtract off border & padding
+  // (and floor at 0 in case the border/padding are too large):
+  WritingMode itemWM = aReflowInput.GetWritingMode();
+  nscoord borderBoxBSize = aReflowOutput.BSize(itemWM);
+  return std::max(
+      0, borderBoxBSize -
+             aReflowInput.ComputedLogicalBorderPadding(itemWM).BStartEnd(
+                 itemWM));
+}
 
 /**
  * A cached copy of various metrics from a flex item's most recent final reflow.
@@ -1989,8 +1939,10 @@ class nsFlexContainerFrame::CachedFlexItemData {
   void Update(const ReflowInput& aReflowInput,
               const ReflowOutput& aReflowOutput, FlexItemReflowType aType) {
     if (aType == FlexItemReflowType::Measuring) {
-      mBAxisMeasurement.reset();
-      mBAxisMeasurement.emplace(aReflowInput, aReflowOutput);
+      mBAxisMeasurements.Insert(
+          MeasurementCache::Key(aReflowInput.mFrame, aReflowInput),
+          aReflowOutput.ISize(aReflowInput.GetWritingMode()),
+          ContentBoxBSizeForMeasurement(aReflowInput, aReflowOutput));
       // Clear any cached "last final reflow metrics", too, because now the most
       // recent reflow was *not* a "final reflow".
       mFinalReflowMetrics.reset();
@@ -2021,8 +1973,8 @@ class nsFlexContainerFrame::CachedFlexItemData {
 
   // If the flex container needs a measuring reflow for the flex item, then the
   // resulting block-axis measurements can be cached here.  If no measurement
-  // has been needed so far, then this member will be Nothing().
-  Maybe<CachedBAxisMeasurement> mBAxisMeasurement;
+  // has been needed so far, then this cache will be empty.
+  MeasurementCache mBAxisMeasurements;
 
   // The metrics that the corresponding flex item used in its most recent
   // "final reflow". (Note: the assumption here is that this reflow was this
@@ -2041,26 +1993,26 @@ void nsFlexContainerFrame::MarkCachedFlexMeasurementsDirty(
     nsIFrame* aItemFrame) {
   MOZ_ASSERT(aItemFrame->IsFlexItem());
   if (auto* cache = aItemFrame->GetProperty(CachedFlexItemData::Prop())) {
-    cache->mBAxisMeasurement.reset();
+    cache->mBAxisMeasurements.Clear();
     cache->mFinalReflowMetrics.reset();
   }
 }
 
-const CachedBAxisMeasurement& nsFlexContainerFrame::MeasureBSizeForFlexItem(
+nscoord nsFlexContainerFrame::MeasureBSizeForFlexItem(
     FlexItem& aItem, ReflowInput& aChildReflowInput) {
   auto* cachedData = aItem.Frame()->GetProperty(CachedFlexItemData::Prop());
 
-  if (cachedData && cachedData->mBAxisMeasurement) {
-    if (!aItem.Frame()->IsSubtreeDirty() &&
-        cachedData->mBAxisMeasurement->IsValidFor(aChildReflowInput)) {
+  if (cachedData) {
+    if (const MeasurementCache::Entry* measurement =
+            cachedData->mBAxisMeasurements.Lookup(
+                aItem.Frame(),
+                MeasurementCache::Key(aItem.Frame(), aChildReflowInput))) {
       FLEX_ITEM_LOG(aItem.Frame(),
                     "[perf] Accepted cached measurement: block-size %d",
-                    cachedData->mBAxisMeasurement->BSize());
-      return *(cachedData->mBAxisMeasurement);
+                    measurement->mBSize);
+      return measurement->mBSize;
     }
-    FLEX_ITEM_LOG(aItem.Frame(),
-                  "[perf] Rejected cached measurement: block-size %d",
-                  cachedData->mBAxisMeasurement->BSize());
+    FLEX_ITEM_LOG(aItem.Frame(), "[perf] Rejected cached measurements");
   } else {
     FLEX_ITEM_LOG(aItem.Frame(), "[perf] No cached measurement");
   }
@@ -2106,7 +2058,7 @@ const CachedBAxisMeasurement& nsFlexContainerFrame::MeasureBSizeForFlexItem(
                                         FlexItemReflowType::Measuring);
     aItem.Frame()->SetProperty(CachedFlexItemData::Prop(), cachedData);
   }
-  return *(cachedData->mBAxisMeasurement);
+  return ContentBoxBSizeForMeasurement(aChildReflowInput, childReflowOutput);
 }
 
 /* virtual */
@@ -2149,10 +2101,7 @@ nscoord nsFlexContainerFrame::MeasureFlexItemContentBSize(
     childRIForMeasuringBSize.SetBResizeForPercentages(true);
   }
 
-  const CachedBAxisMeasurement& measurement =
-      MeasureBSizeForFlexItem(aFlexItem, childRIForMeasuringBSize);
-
-  return measurement.BSize();
+  return MeasureBSizeForFlexItem(aFlexItem, childRIForMeasuringBSize);
 }
 
 FlexItem::FlexItem(ReflowInput& aFlexItemReflowInput, float aFlexGrow,
@@ -2368,10 +2317,15 @@ bool FlexItem::IsMinSizeAutoResolutionNeeded() const {
 Maybe<nscoord> FlexItem::MeasuredBSize() const {
   auto* cachedData =
       Frame()->FirstInFlow()->GetProperty(CachedFlexItemData::Prop());
-  if (!cachedData || !cachedData->mBAxisMeasurement) {
+  if (!cachedData) {
+    return Nothing();
+  }
+  const MeasurementCache::Entry* measurement =
+      cachedData->mBAxisMeasurements.MostRecent();
+  if (!measurement) {
     return Nothing();
   }
-  return Some(cachedData->mBAxisMeasurement->BSize());
+  return Some(measurement->mBSize);
 }
 
 nscoord FlexItem::BaselineOffsetFromOuterCrossEdge(
@@ -4578,14 +4532,13 @@ void nsFlexContainerFrame::SizeItemInCrossAxis(ReflowInput& aChildReflowInput,
   }
 
   // Potentially reflow the item, and get the sizing info.
-  const CachedBAxisMeasurement& measurement =
-      MeasureBSizeForFlexItem(aItem, aChildReflowInput);
+  nscoord measuredBSize = MeasureBSizeForFlexItem(aItem, aChildReflowInput);
 
   // Save the sizing info that we learned from this reflow
   // -----------------------------------------------------
 
   // Tentatively store the child's desired content-box cross-size.
-  aItem.SetCrossSize(measurement.BSize());
+  aItem.SetCrossSize(measuredBSize);
 }
 
 void FlexLine::PositionItemsInCrossAxis(
@@ -128,7 +128,6 @@ class nsFlexContainerFrame final : public nsContainerFrame,
   class FlexLine;
   class FlexboxAxisTracker;
   struct StrutInfo;
-  class CachedBAxisMeasurement;
   class CachedFlexItemData;
   struct SharedFlexData;
   struct PerFragmentFlexData;
@@ -410,10 +409,12 @@ class nsFlexContainerFrame final : public nsContainerFrame,
    * does a measuring reflow and caches those measurements.
    *
    * This avoids exponential reflows - see the comment above the
-   * CachedBAxisMeasurement struct.
+   * ContentBoxBSizeForMeasurement function.
+   *
+   * @return the content-box block-size of the item.
    */
-  const CachedBAxisMeasurement& MeasureBSizeForFlexItem(
-      FlexItem& aItem, ReflowInput& aChildReflowInput);
+  nscoord MeasureBSizeForFlexItem(FlexItem& aItem,
+                                  ReflowInput& aChildReflowInput);
 
   /**
    * This method performs a "measuring" reflow to get the content BSize of
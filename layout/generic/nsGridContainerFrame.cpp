@@ -13,6 +13,7 @@
 #include <type_traits>
 #include "fmt/format.h"
 #include "gfxContext.h"
+#include "mozilla/ArenaTArray.h"
 #include "mozilla/AutoRestore.h"
 #include "mozilla/Baseline.h"
 #include "mozilla/ComputedStyle.h"
@@ -21,6 +22,7 @@
 #include "mozilla/dom/GridBinding.h"
 #include "mozilla/IntegerRange.h"
 #include "mozilla/Maybe.h"
+#include "mozilla/MeasurementCache.h"
 #include "mozilla/PodOperations.h"  // for PodZero
 #include "mozilla/PresShell.h"
 #include "mozilla/ScrollContainerFrame.h"
@@ -42,8 +44,6 @@ using namespace mozilla;
 
 using AbsPosReflowFlags = nsAbsoluteContainingBlock::AbsPosReflowFlags;
 using AlignJustifyFlags = CSSAlignUtils::AlignJustifyFlags;
-using GridItemCachedBAxisMeasurement =
-    nsGridContainerFrame::CachedBAxisMeasurement;
 using GridTemplate = StyleGridTemplateComponent;
 using NameList = StyleOwnedSlice<StyleCustomIdent>;
 using SizingConstraint = nsGridContainerFrame::SizingConstraint;
@@ -265,65 +265,13 @@ static Maybe<nscoord> ComputeTransferredSize(
       aAxis, aWM, rdSize, aBoxSizingAdjustment.EnsureAndGet()));
 }
 
-// A cached result for a grid item's block-axis measuring reflow. This
+// The cached results of a grid item's block-axis measuring reflows. This
 // cache prevents us from doing exponential reflows in cases of deeply
 // nested grid frames.
 //
-// We store the cached value in the grid item's frame property table.
-//
-// We cache the following as a "key"
-//   - The size of the grid area in the item's inline axis
-//   - The item's block axis baseline padding
-// ...and we cache the following as the "value",
-//   - The item's border-box BSize
-class nsGridContainerFrame::CachedBAxisMeasurement final {
- public:
-  NS_DECLARE_FRAME_PROPERTY_DELETABLE(Prop, CachedBAxisMeasurement)
-
-  CachedBAxisMeasurement(const nsIFrame* aFrame, const LogicalSize& aCBSize,
-                         const nscoord aBSize)
-      : mKey(aFrame, aCBSize), mBSize(aBSize) {}
-
-  bool IsValidFor(const nsIFrame* aFrame, const LogicalSize& aCBSize) const {
-    if (aFrame->IsSubtreeDirty()) {
-      return false;
-    }
-    return mKey == Key(aFrame, aCBSize);
-  }
-
-  nscoord BSize() const { return mBSize; }
-
-  void Update(const nsIFrame* aFrame, const LogicalSize& aCBSize,
-              const nscoord aBSize) {
-    mKey.Update(aFrame, aCBSize);
-    mBSize = aBSize;
-  }
-
- private:
-  struct Key final {
-    nscoord mCBSizeInItemInlineAxis;
-    nscoord mBaselinePaddingInItemBlockAxis;
-
-    Key(const nsIFrame* aFrame, const LogicalSize& aCBSize) {
-      Update(aFrame, aCBSize);
-    }
-
-    void Update(const nsIFrame* aFrame, const LogicalSize& aCBSize) {
-      mCBSizeInItemInlineAxis = aCBSize.ISize(aFrame->GetWritingMode());
-      mBaselinePaddingInItemBlockAxis =
-          aFrame->GetProperty(nsIFrame::BBaselinePadProperty());
-    }
-
-    bool operator==(const Key& aOther) const {
-      return mCBSizeInItemInlineAxis == aOther.mCBSizeInItemInlineAxis &&
-             mBaselinePaddingInItemBlockAxis ==
-                 aOther.mBaselinePaddingInItemBlockAxis;
-    }
-  };
-
-  Key mKey;
-  nscoord mBSize;
-};
+// The entries store the item's border-box size.
+NS_DECLARE_FRAME_PROPERTY_DELETABLE(GridItemMeasurementCacheProperty,
+                                    MeasurementCache)
 
 // The input sizes for calculating the number of repeat(auto-fill/fit) tracks.
 // https://drafts.csswg.org/css-grid-2/#auto-repeat
@@ -2346,7 +2294,7 @@ struct nsGridContainerFrame::Tracks {
    * Calculate baseline offsets for the given set of items.
    * Helper for InitialzeItemBaselines.
    */
-  void CalculateItemBaselines(nsTArray<ItemBaselineData>& aBaselineItems,
+  void CalculateItemBaselines(ArenaTArray<ItemBaselineData>& aBaselineItems,
                               BaselineSharingGroup aBaselineGroup);
 
   /**
@@ -2393,8 +2341,8 @@ struct nsGridContainerFrame::Tracks {
       GridReflowInput& aGridRI, nsTArray<GridItemInfo>& aGridItems,
       BaselineAlignmentSet aSet, const nsSize& aContainerSize,
       nsTArray<nscoord>& aTrackSizes,
-      nsTArray<ItemBaselineData>& aFirstBaselineItems,
-      nsTArray<ItemBaselineData>& aLastBaselineItems);
+      ArenaTArray<ItemBaselineData>& aFirstBaselineItems,
+      ArenaTArray<ItemBaselineData>& aLastBaselineItems);
 
   /**
    * Apply the additional alignment needed to align the baseline-aligned subtree
@@ -5724,21 +5672,23 @@ static nscoord MeasuringReflow(nsIFrame* aChild,
       nsIFrame::ReflowChildFlags::NoSizeView |
       nsIFrame::ReflowChildFlags::NoDeleteNextInFlowChild;
 
-  // Reflowing the child might invalidate the cache, so we declare the variable
-  // inside the if-statement to ensure it isn't accessed after it may have
-  // become invalid.
-  if (const GridItemCachedBAxisMeasurement* cachedMeasurement =
-          aChild->GetProperty(GridItemCachedBAxisMeasurement::Prop());
-      cachedMeasurement && cachedMeasurement->IsValidFor(aChild, aCBSize)) {
-    childSize.BSize(wm) = cachedMeasurement->BSize();
-    childSize.ISize(wm) = aChild->ISize(wm);
-    nsContainerFrame::FinishReflowChild(aChild, pc, childSize, &childRI, wm,
-                                        LogicalPoint(wm), nsSize(), flags);
-    GRID_LOG(
-        "[perf] MeasuringReflow accepted cached value=%d, child=%p, "
-        "aCBSize.ISize=%d",
-        cachedMeasurement->BSize(), aChild, aCBSize.ISize(wm));
-    return cachedMeasurement->BSize();
+  // Reflowing the child might invalidate the cache, so we only look entries
+  // up before reflowing it.
+  const MeasurementCache::Key key(aChild, childRI);
+  if (MeasurementCache* cache =
+          aChild->GetProperty(GridItemMeasurementCacheProperty())) {
+    if (const MeasurementCache::Entry* cachedMeasurement =
+            cache->Lookup(aChild, key)) {
+      childSize.ISize(wm) = cachedMeasurement->mISize;
+      childSize.BSize(wm) = cachedMeasurement->mBSize;
+      nsContainerFrame::FinishReflowChild(aChild, pc, childSize, &childRI, wm,
+                                          LogicalPoint(wm), nsSize(), flags);
+      GRID_LOG(
+          "[perf] MeasuringReflow accepted cached value=%d, child=%p, "
+          "aCBSize.ISize=%d",
+          cachedMeasurement->mBSize, aChild, aCBSize.ISize(wm));
+      return cachedMeasurement->mBSize;
+    }
   }
 
   parent->ReflowChild(aChild, pc, childSize, childRI, wm, LogicalPoint(wm),
@@ -5749,23 +5699,17 @@ static nscoord MeasuringReflow(nsIFrame* aChild,
   parent->RemoveProperty(nsContainerFrame::DebugReflowingWithInfiniteISize());
 #endif
 
-  if (GridItemCachedBAxisMeasurement* cachedMeasurement =
-          aChild->GetProperty(GridItemCachedBAxisMeasurement::Prop())) {
-    cachedMeasurement->Update(aChild, aCBSize, childSize.BSize(wm));
-    GRID_LOG(
-        "[perf] MeasuringReflow rejected but updated cached value=%d, "
-        "child=%p, aCBSize.ISize=%d",
-        cachedMeasurement->BSize(), aChild, aCBSize.ISize(wm));
-  } else {
-    cachedMeasurement = new GridItemCachedBAxisMeasurement(aChild, aCBSize,
-                                                           childSize.BSize(wm));
-    aChild->SetProperty(GridItemCachedBAxisMeasurement::Prop(),
-                        cachedMeasurement);
-    GRID_LOG(
-        "[perf] MeasuringReflow created new cached value=%d, child=%p, "
-        "aCBSize.ISize=%d",
-        cachedMeasurement->BSize(), aChild, aCBSize.ISize(wm));
+  // Reflowing the child may have replaced or removed its cache.
+  MeasurementCache* cache =
+      aChild->GetProperty(GridItemMeasurementCacheProperty());
+  if (!cache) {
+    cache = new MeasurementCache();
+    aChild->SetProperty(GridItemMeasurementCacheProperty(), cache);
   }
+  cache->Insert(key, childSize.ISize(wm), childSize.BSize(wm));
+  GRID_LOG(
+      "[perf] MeasuringReflow cached value=%d, child=%p, aCBSize.ISize=%d",
+      childSize.BSize(wm), aChild, aCBSize.ISize(wm));
 
   return childSize.BSize(wm);
 }
@@ -6246,7 +6190,7 @@ void nsGridContainerFrame::Tracks::ResolveIntrinsicSizeForNonSpanningItems(
 }
 
 void nsGridContainerFrame::Tracks::CalculateItemBaselines(
-    nsTArray<ItemBaselineData>& aBaselineItems,
+    ArenaTArray<ItemBaselineData>& aBaselineItems,
     BaselineSharingGroup aBaselineGroup) {
   if (aBaselineItems.IsEmpty()) {
     return;
@@ -6312,8 +6256,8 @@ void nsGridContainerFrame::Tracks::InitializeItemBaselines(
     return;
   }
 
-  nsTArray<ItemBaselineData> firstBaselineItems;
-  nsTArray<ItemBaselineData> lastBaselineItems;
+  ArenaTArray<ItemBaselineData> firstBaselineItems;
+  ArenaTArray<ItemBaselineData> lastBaselineItems;
   const WritingMode containerWM = aGridRI.mWM;
   ComputedStyle* containerStyle = aGridRI.mFrame->Style();
 
@@ -6577,8 +6521,8 @@ void nsGridContainerFrame::Tracks::InitializeItemBaselinesInMasonryAxis(
     GridReflowInput& aGridRI, nsTArray<GridItemInfo>& aGridItems,
     BaselineAlignmentSet aSet, const nsSize& aContainerSize,
     nsTArray<nscoord>& aTrackSizes,
-    nsTArray<ItemBaselineData>& aFirstBaselineItems,
-    nsTArray<ItemBaselineData>& aLastBaselineItems) {
+    ArenaTArray<ItemBaselineData>& aFirstBaselineItems,
+    ArenaTArray<ItemBaselineData>& aLastBaselineItems) {
   MOZ_ASSERT(mIsMasonry);
   WritingMode wm = aGridRI.mWM;
   ComputedStyle* containerSC = aGridRI.mFrame->Style();
@@ -8831,8 +8775,8 @@ nscoord nsGridContainerFrame::MasonryLayout(GridReflowInput& aGridRI,
   };
 
   // Apply baseline alignment to items belonging to the given set.
-  nsTArray<Tracks::ItemBaselineData> firstBaselineItems;
-  nsTArray<Tracks::ItemBaselineData> lastBaselineItems;
+  ArenaTArray<Tracks::ItemBaselineData> firstBaselineItems;
+  ArenaTArray<Tracks::ItemBaselineData> lastBaselineItems;
   auto applyBaselineAlignment = [&](BaselineAlignmentSet aSet) {
     firstBaselineItems.ClearAndRetainStorage();
     lastBaselineItems.ClearAndRetainStorage();
@@ -8841,8 +8785,8 @@ nscoord nsGridContainerFrame::MasonryLayout(GridReflowInput& aGridRI,
         firstBaselineItems, lastBaselineItems);
 
     bool didBaselineAdjustment = false;
-    nsTArray<Tracks::ItemBaselineData>* baselineItems[] = {&firstBaselineItems,
-                                                           &lastBaselineItems};
+    ArenaTArray<Tracks::ItemBaselineData>* baselineItems[] = {
+        &firstBaselineItems, &lastBaselineItems};
     for (const auto* items : baselineItems) {
       for (const auto& data : *items) {
         GridItemInfo* item = data.mGridItem;
@@ -10578,7 +10522,7 @@ nsGridContainerFrame* nsGridContainerFrame::GetGridFrameWithComputedInfo(
 void nsGridContainerFrame::MarkCachedGridMeasurementsDirty(
     nsIFrame* aItemFrame) {
   MOZ_ASSERT(aItemFrame->IsGridItem());
-  aItemFrame->RemoveProperty(CachedBAxisMeasurement::Prop());
+  aItemFrame->RemoveProperty(GridItemMeasurementCacheProperty());
 }
 
 // TODO: This is a rather dumb implementation of nsILineIterator, but it's
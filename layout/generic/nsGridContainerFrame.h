@@ -312,7 +312,6 @@ class nsGridContainerFrame final : public nsContainerFrame,
    */
   static void MarkCachedGridMeasurementsDirty(nsIFrame* aItemFrame);
 
-  class CachedBAxisMeasurement;
   struct Subgrid;
   struct UsedTrackSizes;
   struct TrackSize;
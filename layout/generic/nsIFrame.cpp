@@ -803,14 +803,27 @@ void nsIFrame::HandlePrimaryFrameStyleChange(ComputedStyle* aOldStyle) {
   if (handleAnchorPosAnchorNameChange &&
       !HasAnyStateBits(NS_FRAME_IS_NONDISPLAY)) {
     // TODO: Add invalidation.
-    // TODO: Only remove/add the necessary names below.
+    // Only touch the names that changed, so that the position of this frame
+    // in the lists of the names it keeps doesn't need to be searched again.
+    auto hasName = [](const nsStyleDisplay* aDisp, const nsAtom* aName) {
+      for (auto& name : aDisp->mAnchorName.AsSpan()) {
+        if (name.AsAtom() == aName) {
+          return true;
+        }
+      }
+      return false;
+    };
     if (oldDisp && oldDisp->HasAnchorName()) {
       for (auto& name : oldDisp->mAnchorName.AsSpan()) {
-        PresShell()->RemoveAnchorPosAnchor(name.AsAtom(), this);
+        if (!hasName(disp, name.AsAtom())) {
+          PresShell()->RemoveAnchorPosAnchor(name.AsAtom(), this);
+        }
       }
     }
     for (auto& name : disp->mAnchorName.AsSpan()) {
-      PresShell()->AddAnchorPosAnchor(name.AsAtom(), this);
+      if (!oldDisp || !hasName(oldDisp, name.AsAtom())) {
+        PresShell()->AddAnchorPosAnchor(name.AsAtom(), this);
+      }
     }
   }
 
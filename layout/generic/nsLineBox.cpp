@@ -48,8 +48,6 @@ nsLineBox::nsLineBox(nsIFrame* aFrame, int32_t aCount, bool aIsBlock)
   // as to ensure that no parts are missed.
   static_assert(sizeof(mFrames) >= sizeof(mChildCount), "nsLineBox init #1");
   static_assert(sizeof(mAllFlags) >= sizeof(mFlags), "nsLineBox init #2");
-  static_assert(sizeof(mData) >= sizeof(mBlockData), "nsLineBox init #3");
-  static_assert(sizeof(mData) >= sizeof(mInlineData), "nsLineBox init #4");
 
   MOZ_COUNT_CTOR(nsLineBox);
 #ifdef DEBUG
@@ -91,6 +89,14 @@ void nsLineBox::AddSizeOfExcludingThis(nsWindowSizes& aSizes) const {
     aSizes.mLayoutFramePropertiesSize +=
         mFrames->ShallowSizeOfIncludingThis(aSizes.mState.mMallocSizeOf);
   }
+  if (mData) {
+    aSizes.mLayoutLineBoxDataSize += aSizes.mState.mMallocSizeOf(mData);
+    if (mFlags.mHasFullData && IsInline()) {
+      aSizes.mLayoutLineBoxDataSize +=
+          InlineData()->mFloats.ShallowSizeOfExcludingThis(
+              aSizes.mState.mMallocSizeOf);
+    }
+  }
 }
 
 void nsLineBox::StealHashTableFrom(nsLineBox* aFromLine,
@@ -160,15 +166,45 @@ void nsLineBox::Destroy(PresShell* aPresShell) {
   aPresShell->FreeByObjectID(eArenaObjectID_nsLineBox, this);
 }
 
-void nsLineBox::Cleanup() {
-  if (mData) {
-    if (IsBlock()) {
-      delete mBlockData;
-    } else {
-      delete mInlineData;
-    }
-    mData = nullptr;
+void nsLineBox::Cleanup() { FreeData(); }
+
+void nsLineBox::FreeData() {
+  if (!mData) {
+    return;
+  }
+  if (!mFlags.mHasFullData) {
+    delete mData;
+  } else if (IsBlock()) {
+    delete BlockData();
+  } else {
+    delete InlineData();
+  }
+  mData = nullptr;
+  mFlags.mHasFullData = false;
+}
+
+nsLineBox::ExtraBlockData* nsLineBox::EnsureBlockData() {
+  MOZ_ASSERT(IsBlock());
+  if (!mFlags.mHasFullData) {
+    auto* data =
+        new ExtraBlockData(mData ? *mData : ExtraData(GetPhysicalBounds()));
+    delete mData;
+    mData = data;
+    mFlags.mHasFullData = true;
   }
+  return BlockData();
+}
+
+nsLineBox::ExtraInlineData* nsLineBox::EnsureInlineData() {
+  MOZ_ASSERT(IsInline());
+  if (!mFlags.mHasFullData) {
+    auto* data =
+        new ExtraInlineData(mData ? *mData : ExtraData(GetPhysicalBounds()));
+    delete mData;
+    mData = data;
+    mFlags.mHasFullData = true;
+  }
+  return InlineData();
 }
 
 #ifdef DEBUG_FRAME_DUMP
@@ -247,10 +283,11 @@ void nsLineBox::List(FILE* out, const char* aPrefix,
                              nsIFrame::ConvertToString(vo, aFlags).c_str(),
                              nsIFrame::ConvertToString(so, aFlags).c_str());
     }
-    if (mData->mInFlowChildBounds) {
+    if (const ExtraFullData* data = FullData();
+        data && data->mInFlowChildBounds) {
       str += nsPrintfCString(
           "in-flow-scr-overflow=%s ",
-          nsIFrame::ConvertToString(*mData->mInFlowChildBounds, aFlags)
+          nsIFrame::ConvertToString(*data->mInFlowChildBounds, aFlags)
               .c_str());
     }
   }
@@ -267,7 +304,7 @@ void nsLineBox::List(FILE* out, const char* aPrefix,
 
   if (HasFloats()) {
     fprintf_stderr(out, "%s> floats <\n", aPrefix);
-    ListFloats(out, pfx.get(), mInlineData->mFloats,
+    ListFloats(out, pfx.get(), Floats(),
                aFlags.contains(nsIFrame::ListFlag::OnlyListDeterministicInfo));
   }
   fprintf_stderr(out, "%s>\n", aPrefix);
@@ -437,22 +474,20 @@ bool nsLineBox::RFindLineContaining(nsIFrame* aFrame,
 
 CollapsingMargin nsLineBox::GetCarriedOutBEndMargin() const {
   NS_ASSERTION(IsBlock(), "GetCarriedOutBEndMargin called on non-block line.");
-  return (IsBlock() && mBlockData) ? mBlockData->mCarriedOutBEndMargin
-                                   : CollapsingMargin();
+  return (IsBlock() && BlockData()) ? BlockData()->mCarriedOutBEndMargin
+                                    : CollapsingMargin();
 }
 
 bool nsLineBox::SetCarriedOutBEndMargin(CollapsingMargin aValue) {
   bool changed = false;
   if (IsBlock()) {
     if (!aValue.IsZero()) {
-      if (!mBlockData) {
-        mBlockData = new ExtraBlockData(GetPhysicalBounds());
-      }
-      changed = aValue != mBlockData->mCarriedOutBEndMargin;
-      mBlockData->mCarriedOutBEndMargin = aValue;
-    } else if (mBlockData) {
-      changed = aValue != mBlockData->mCarriedOutBEndMargin;
-      mBlockData->mCarriedOutBEndMargin = aValue;
+      ExtraBlockData* data = EnsureBlockData();
+      changed = aValue != data->mCarriedOutBEndMargin;
+      data->mCarriedOutBEndMargin = aValue;
+    } else if (ExtraBlockData* data = BlockData()) {
+      changed = aValue != data->mCarriedOutBEndMargin;
+      data->mCarriedOutBEndMargin = aValue;
       MaybeFreeData();
     }
   }
@@ -463,24 +498,25 @@ void nsLineBox::MaybeFreeData() {
   nsRect bounds = GetPhysicalBounds();
   // If we have space allocated for additional data but no additional data to
   // represent, just delete it.
-  if (mData && mData->mOverflowAreas == OverflowAreas(bounds, bounds) &&
-      !mData->mInFlowChildBounds) {
-    if (IsInline()) {
-      if (mInlineData->mFloats.IsEmpty()) {
-        delete mInlineData;
-        mInlineData = nullptr;
-      }
-    } else if (mBlockData->mCarriedOutBEndMargin.IsZero()) {
-      delete mBlockData;
-      mBlockData = nullptr;
+  if (!mData || !(mData->mOverflowAreas == OverflowAreas(bounds, bounds))) {
+    return;
+  }
+  if (mFlags.mHasFullData) {
+    if (FullData()->mInFlowChildBounds) {
+      return;
+    }
+    if (IsInline() ? !InlineData()->mFloats.IsEmpty()
+                   : !BlockData()->mCarriedOutBEndMargin.IsZero()) {
+      return;
     }
   }
+  FreeData();
 }
 
 void nsLineBox::ClearFloats() {
   MOZ_ASSERT(IsInline(), "block line can't have floats");
-  if (IsInline() && mInlineData) {
-    mInlineData->mFloats.Clear();
+  if (IsInline() && InlineData()) {
+    InlineData()->mFloats.Clear();
     MaybeFreeData();
   }
 }
@@ -491,20 +527,15 @@ void nsLineBox::AppendFloats(nsTArray<nsIFrame*>&& aFloats) {
     return;
   }
   if (!aFloats.IsEmpty()) {
-    if (mInlineData) {
-      mInlineData->mFloats.AppendElements(std::move(aFloats));
-    } else {
-      mInlineData = new ExtraInlineData(GetPhysicalBounds());
-      mInlineData->mFloats = std::move(aFloats);
-    }
+    EnsureInlineData()->mFloats.AppendElements(std::move(aFloats));
   }
 }
 
 bool nsLineBox::RemoveFloat(nsIFrame* aFrame) {
   MOZ_ASSERT(IsInline(), "block line can't have floats");
   MOZ_ASSERT(aFrame);
-  if (IsInline() && mInlineData) {
-    if (mInlineData->mFloats.RemoveElement(aFrame)) {
+  if (IsInline() && InlineData()) {
+    if (InlineData()->mFloats.RemoveElement(aFrame)) {
       // Note: the placeholder is part of the line's child list
       // and will be removed later.
       MaybeFreeData();
@@ -516,18 +547,16 @@ bool nsLineBox::RemoveFloat(nsIFrame* aFrame) {
 
 void nsLineBox::SetFloatEdges(nscoord aStart, nscoord aEnd) {
   MOZ_ASSERT(IsInline(), "block line can't have float edges");
-  if (!mInlineData) {
-    mInlineData = new ExtraInlineData(GetPhysicalBounds());
-  }
-  mInlineData->mFloatEdgeIStart = aStart;
-  mInlineData->mFloatEdgeIEnd = aEnd;
+  ExtraInlineData* data = EnsureInlineData();
+  data->mFloatEdgeIStart = aStart;
+  data->mFloatEdgeIEnd = aEnd;
 }
 
 void nsLineBox::ClearFloatEdges() {
   MOZ_ASSERT(IsInline(), "block line can't have float edges");
-  if (mInlineData) {
-    mInlineData->mFloatEdgeIStart = nscoord_MIN;
-    mInlineData->mFloatEdgeIEnd = nscoord_MIN;
+  if (ExtraInlineData* data = InlineData()) {
+    data->mFloatEdgeIStart = nscoord_MIN;
+    data->mFloatEdgeIEnd = nscoord_MIN;
   }
 }
 
@@ -545,11 +574,7 @@ void nsLineBox::SetOverflowAreas(const OverflowAreas& aOverflowAreas) {
   if (!aOverflowAreas.InkOverflow().IsEqualInterior(bounds) ||
       !aOverflowAreas.ScrollableOverflow().IsEqualEdges(bounds)) {
     if (!mData) {
-      if (IsInline()) {
-        mInlineData = new ExtraInlineData(bounds);
-      } else {
-        mBlockData = new ExtraBlockData(bounds);
-      }
+      mData = new ExtraData(bounds);
     }
     mData->mOverflowAreas = aOverflowAreas;
   } else if (mData) {
@@ -562,26 +587,22 @@ void nsLineBox::SetOverflowAreas(const OverflowAreas& aOverflowAreas) {
 
 void nsLineBox::SetInFlowChildBounds(const Maybe<nsRect>& aInFlowChildBounds) {
   if (aInFlowChildBounds) {
-    if (!mData) {
-      nsRect bounds = GetPhysicalBounds();
-      if (IsInline()) {
-        mInlineData = new ExtraInlineData(bounds);
-      } else {
-        mBlockData = new ExtraBlockData(bounds);
-      }
-    }
-    mData->mInFlowChildBounds = aInFlowChildBounds;
-  } else if (mData) {
-    mData->mInFlowChildBounds = Nothing{};
+    ExtraFullData* data = IsInline()
+                              ? static_cast<ExtraFullData*>(EnsureInlineData())
+                              : EnsureBlockData();
+    data->mInFlowChildBounds = aInFlowChildBounds;
+  } else if (ExtraFullData* data = FullData()) {
+    data->mInFlowChildBounds = Nothing{};
     MaybeFreeData();
   }
 }
 
 Maybe<nsRect> nsLineBox::GetInFlowChildBounds() const {
-  if (!mData) {
+  const ExtraFullData* data = FullData();
+  if (!data) {
     return Nothing{};
   }
-  return mData->mInFlowChildBounds;
+  return data->mInFlowChildBounds;
 }
 
 //----------------------------------------------------------------------
@@ -269,11 +269,11 @@ class nsLineBox final : public nsLineLink {
 
   // mFloats
   bool HasFloats() const {
-    return (IsInline() && mInlineData) && !mInlineData->mFloats.IsEmpty();
+    return IsInline() && InlineData() && !InlineData()->mFloats.IsEmpty();
   }
   const nsTArray<nsIFrame*>& Floats() const {
     MOZ_ASSERT(HasFloats());
-    return mInlineData->mFloats;
+    return InlineData()->mFloats;
   }
   // Append aFloats to mFloat. aFloats will be empty.
   void AppendFloats(nsTArray<nsIFrame*>&& aFloats);
@@ -325,8 +325,8 @@ class nsLineBox final : public nsLineLink {
       for (const auto otype : mozilla::AllOverflowTypes()) {
         mData->mOverflowAreas.Overflow(otype) += physicalDelta;
       }
-      if (mData->mInFlowChildBounds) {
-        *mData->mInFlowChildBounds += physicalDelta;
+      if (ExtraFullData* data = FullData(); data && data->mInFlowChildBounds) {
+        *data->mInFlowChildBounds += physicalDelta;
       }
     }
   }
@@ -345,8 +345,8 @@ class nsLineBox final : public nsLineLink {
       for (const auto otype : mozilla::AllOverflowTypes()) {
         mData->mOverflowAreas.Overflow(otype) += physicalDelta;
       }
-      if (mData->mInFlowChildBounds) {
-        *mData->mInFlowChildBounds += physicalDelta;
+      if (ExtraFullData* data = FullData(); data && data->mInFlowChildBounds) {
+        *data->mInFlowChildBounds += physicalDelta;
       }
     }
     return delta;
@@ -525,15 +525,26 @@ class nsLineBox final : public nsLineLink {
     // Note: This bit is unrelated to CSS break-after property because it is all
     // about line break-after for inline-level boxes.
     bool mHasForcedLineBreakAfter : 1;
+    // Whether mData is an ExtraBlockData or ExtraInlineData, depending on
+    // mBlock, rather than a plain ExtraData.
+    bool mHasFullData : 1;
     // mFloatClearType indicates that there's a float clearance before a block
     // line, or after an inline line.
     mozilla::UsedClear mFloatClearType;
   };
 
+  // The data of lines whose overflow areas differ from their bounds.  Most
+  // of them don't need anything else (e.g. lines of text whose glyphs
+  // overflow), so they only get this, and the other kinds are only
+  // allocated when needed, see mFlags.mHasFullData.
   struct ExtraData {
     explicit ExtraData(const nsRect& aBounds)
         : mOverflowAreas(aBounds, aBounds) {}
     mozilla::OverflowAreas mOverflowAreas;
+  };
+
+  struct ExtraFullData : public ExtraData {
+    explicit ExtraFullData(const ExtraData& aData) : ExtraData(aData) {}
     // Union of the margin-boxes of our in-flow children (only children,
     // *not* their descendants). This is part of a special contribution to
     // the scrollable overflow of a scrolled block; as such, this is only
@@ -542,14 +553,14 @@ class nsLineBox final : public nsLineLink {
     mozilla::Maybe<nsRect> mInFlowChildBounds;
   };
 
-  struct ExtraBlockData : public ExtraData {
-    explicit ExtraBlockData(const nsRect& aBounds) : ExtraData(aBounds) {}
+  struct ExtraBlockData : public ExtraFullData {
+    explicit ExtraBlockData(const ExtraData& aData) : ExtraFullData(aData) {}
     mozilla::CollapsingMargin mCarriedOutBEndMargin;
   };
 
-  struct ExtraInlineData : public ExtraData {
-    explicit ExtraInlineData(const nsRect& aBounds)
-        : ExtraData(aBounds),
+  struct ExtraInlineData : public ExtraFullData {
+    explicit ExtraInlineData(const ExtraData& aData)
+        : ExtraFullData(aData),
           mFloatEdgeIStart(nscoord_MIN),
           mFloatEdgeIEnd(nscoord_MIN) {}
     nscoord mFloatEdgeIStart;
@@ -559,9 +570,10 @@ class nsLineBox final : public nsLineLink {
 
   bool GetFloatEdges(nscoord* aStart, nscoord* aEnd) const {
     MOZ_ASSERT(IsInline(), "block line can't have float edges");
-    if (mInlineData && mInlineData->mFloatEdgeIStart != nscoord_MIN) {
-      *aStart = mInlineData->mFloatEdgeIStart;
-      *aEnd = mInlineData->mFloatEdgeIEnd;
+    const ExtraInlineData* data = InlineData();
+    if (data && data->mFloatEdgeIStart != nscoord_MIN) {
+      *aStart = data->mFloatEdgeIStart;
+      *aEnd = data->mFloatEdgeIEnd;
       return true;
     }
     return false;
@@ -578,13 +590,25 @@ class nsLineBox final : public nsLineLink {
     FlagBits mFlags;
   };
 
-  union {
-    ExtraData* mData;
-    ExtraBlockData* mBlockData;
-    ExtraInlineData* mInlineData;
-  };
+  ExtraData* mData;
+
+  ExtraFullData* FullData() const {
+    return mFlags.mHasFullData ? static_cast<ExtraFullData*>(mData) : nullptr;
+  }
+  ExtraBlockData* BlockData() const {
+    MOZ_ASSERT(IsBlock());
+    return static_cast<ExtraBlockData*>(FullData());
+  }
+  ExtraInlineData* InlineData() const {
+    MOZ_ASSERT(IsInline());
+    return static_cast<ExtraInlineData*>(FullData());
+  }
+  // These replace a plain ExtraData, keeping its overflow areas.
+  ExtraBlockData* EnsureBlockData();
+  ExtraInlineData* EnsureInlineData();
 
   void Cleanup();
+  void FreeData();
   void MaybeFreeData();
 };
 
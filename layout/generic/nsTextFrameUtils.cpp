@@ -16,6 +16,14 @@
 #include "nsUnicodeProperties.h"
 #include <algorithm>
 
+#if defined(MOZ_TEXT_TRANSFORM_SSE2)
+#  include "mozilla/SSE.h"
+#  include "nsTextFrameUtilsGenericFwd.h"
+#elif defined(MOZ_TEXT_TRANSFORM_NEON)
+#  include "mozilla/arm.h"
+#  include "nsTextFrameUtilsGenericFwd.h"
+#endif
+
 using namespace mozilla;
 using namespace mozilla::dom;
 using namespace mozilla::unicode;
@@ -56,6 +64,32 @@ static bool IsSpaceOrTabOrSegmentBreak(char16_t aCh) {
   return IsSpaceOrTab(aCh) || IsSegmentBreak(aCh);
 }
 
+// Copies the run of plain characters at the start of aText, which TransformText
+// keeps as they are whatever the compression mode: characters above U+0020
+// that aren't discardable, and aren't Arabic (which TransformText tracks for
+// INCOMING_ARABICCHAR).  Only whole SIMD batches are copied, so this returns
+// 0 for short runs, which are handled one character at a time.
+template <class CharT>
+static uint32_t CopyPlainText(const CharT* aText, uint32_t aLength,
+                              CharT*& aOutput, gfxSkipChars* aSkipChars) {
+  size_t count = 0;
+#if defined(MOZ_TEXT_TRANSFORM_SSE2)
+  if (mozilla::supports_sse2()) {
+    count = mozilla::SkipPlainTextBatches<xsimd::sse2>(aText, aLength);
+  }
+#elif defined(MOZ_TEXT_TRANSFORM_NEON)
+  if (mozilla::supports_neon()) {
+    count = mozilla::SkipPlainTextBatches<xsimd::neon>(aText, aLength);
+  }
+#endif
+  if (count) {
+    memcpy(aOutput, aText, count * sizeof(CharT));
+    aOutput += count;
+    aSkipChars->KeepChars(count);
+  }
+  return count;
+}
+
 template <typename CharT>
 /* static */
 bool nsTextFrameUtils::IsSkippableCharacterForTransformText(CharT aChar) {
@@ -221,12 +255,27 @@ CharT* nsTextFrameUtils::TransformText(
       aCompression == COMPRESS_NONE_TRANSFORM_TO_SPACE) {
     // Skip discardables.
     uint32_t i;
+    // Whether the previous character wasn't plain, see CopyPlainText.
+    bool atPlainRunStart = true;
     for (i = 0; i < aLength; ++i) {
+      if (atPlainRunStart) {
+        atPlainRunStart = false;
+        if (uint32_t count =
+                CopyPlainText(aText + i, aLength - i, aOutput, aSkipChars)) {
+          lastCharArabic = false;
+          i += count;
+          if (i == aLength) {
+            break;
+          }
+        }
+      }
       CharT ch = aText[i];
       if (IsDiscardable(ch, &flags)) {
         aSkipChars->SkipChar();
+        atPlainRunStart = true;
       } else {
         aSkipChars->KeepChar();
+        atPlainRunStart = ch <= ' ';
         if (ch > ' ') {
           lastCharArabic = IS_ARABIC_CHAR(ch);
         } else if (aCompression == COMPRESS_NONE_TRANSFORM_TO_SPACE) {
@@ -266,7 +315,21 @@ CharT* nsTextFrameUtils::TransformText(
     }();
     bool inWhitespace = (*aIncomingFlags & INCOMING_WHITESPACE) != 0;
     uint32_t i;
+    // Whether the previous character wasn't plain, see CopyPlainText.
+    bool atPlainRunStart = true;
     for (i = 0; i < aLength; ++i) {
+      if (atPlainRunStart) {
+        atPlainRunStart = false;
+        if (uint32_t count =
+                CopyPlainText(aText + i, aLength - i, aOutput, aSkipChars)) {
+          lastCharArabic = false;
+          inWhitespace = false;
+          i += count;
+          if (i == aLength) {
+            break;
+          }
+        }
+      }
       CharT ch = aText[i];
       // CSS Text 3 - 4.1. The White Space Processing Rules
       // White space processing in CSS affects only the document white space
@@ -319,11 +382,13 @@ CharT* nsTextFrameUtils::TransformText(
           j++;
         }
         i = j - 1;
+        atPlainRunStart = true;
         continue;
       }
       // Process characters other than the document white space characters.
       if (IsDiscardable(ch, &flags)) {
         aSkipChars->SkipChar();
+        atPlainRunStart = true;
       } else {
         *aOutput++ = ch;
         aSkipChars->KeepChar();
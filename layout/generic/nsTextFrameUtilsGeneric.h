@@ -0,0 +1,44 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef nsTextFrameUtilsGeneric_h__
+#define nsTextFrameUtilsGeneric_h__
+
+#include "nsTextFrameUtilsGenericFwd.h"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace mozilla {
+
+template <class Arch, class CharT>
+size_t SkipPlainTextBatches(const CharT* aText, size_t aLength) {
+  using UnsignedT = std::conditional_t<sizeof(CharT) == 1, uint8_t, uint16_t>;
+  using batch = xsimd::batch<UnsignedT, Arch>;
+  const size_t numCharsPerVector = batch::size;
+  const auto* text = reinterpret_cast<const UnsignedT*>(aText);
+
+  const batch space(static_cast<UnsignedT>(' '));
+  const batch shy(static_cast<UnsignedT>(0xAD));
+
+  size_t i = 0;
+  for (; i + numCharsPerVector <= aLength; i += numCharsPerVector) {
+    const batch vect = batch::load_unaligned(text + i);
+    auto plain = (vect > space) & (vect != shy);
+    if constexpr (sizeof(CharT) > 1) {
+      // Arabic characters start at U+0600, and bidi controls after them.
+      plain = plain & (vect < batch(static_cast<UnsignedT>(0x600)));
+    }
+    if (!xsimd::all(plain)) {
+      break;
+    }
+  }
+  return i;
+}
+
+}  // namespace mozilla
+
+#endif
@@ -1510,13 +1510,26 @@ Loader::Completed Loader::ParseSheet(
   }
   AUTO_PROFILER_LABEL_CATEGORY_PAIR_RELEVANT_FOR_JS(LAYOUT_CSSParsing);
 
+  StyleSheet* sheet = loadData->mSheet;
+  MOZ_ASSERT(sheet);
+
+  // If we're revalidating an expired sheet and got the same text again, the
+  // contents of the cached sheet are still good. Errors need a real parse to
+  // be reported, though.
+  if (loadData->mURI && mSheets && !loadData->mRecordErrors &&
+      StaticPrefs::layout_css_reuse_unchanged_sheets_enabled()) {
+    if (StyleSheet* unchanged = mSheets->LookupUnchanged(*loadData, aBytes)) {
+      sheet->CopyContentsFrom(*unchanged);
+      SheetComplete(*loadData, NS_OK);
+      return Completed::Yes;
+    }
+    sheet->SetSourceText(aBytes);
+  }
+
   ++mParsedSheetCount;
 
   loadData->mIsBeingParsed = true;
 
-  StyleSheet* sheet = loadData->mSheet;
-  MOZ_ASSERT(sheet);
-
   // Some cases, like inline style and UA stylesheets, need to be parsed
   // synchronously. The former may trigger child loads, the latter must not.
   if (loadData->mSyncLoad || aAllowAsync == AllowAsyncParse::No) {
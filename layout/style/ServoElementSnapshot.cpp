@@ -82,6 +82,31 @@ void ServoElementSnapshot::AddAttrs(const Element& aElement,
   }
 }
 
+bool ServoElementSnapshot::IsUnchanged(const Element& aElement) const {
+  if (HasAny(~(Flags::Attributes | Flags::Id | Flags::MaybeClass))) {
+    return false;
+  }
+
+  // Attributes that were removed and set again are appended, so they don't
+  // count as unchanged.
+  if (mAttrs.Length() != aElement.GetAttrCount()) {
+    return false;
+  }
+  for (uint32_t i = 0; i < mAttrs.Length(); ++i) {
+    const BorrowedAttrInfo info = aElement.GetAttrInfoAt(i);
+    if (!mAttrs[i].mName.Equals(*info.mName) ||
+        !mAttrs[i].mValue.Equals(*info.mValue)) {
+      return false;
+    }
+  }
+
+  const nsAttrValue* classValue = aElement.GetClasses();
+  if (HasAny(Flags::MaybeClass)) {
+    return classValue && mClass.Equals(*classValue);
+  }
+  return !classValue;
+}
+
 void ServoElementSnapshot::AddCustomStates(Element& aElement) {
   if (mContains & Flags::CustomState) {
     return;
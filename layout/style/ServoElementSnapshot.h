@@ -71,6 +71,13 @@ class ServoElementSnapshot {
     return HasAny(Flags::OtherPseudoClassState);
   }
 
+  /**
+   * Whether this is a snapshot of attributes only, and aElement's attributes
+   * are still the same as the ones captured, so that selectors match the
+   * same way they did before.
+   */
+  bool IsUnchanged(const Element&) const;
+
   /**
    * Captures the given state (if not previously captured).
    */
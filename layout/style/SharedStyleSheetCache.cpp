@@ -101,6 +101,41 @@ void SharedStyleSheetCache::InsertIfNeeded(css::SheetLoadData& aData) {
   Insert(aData);
 }
 
+StyleSheet* SharedStyleSheetCache::LookupUnchanged(
+    const css::SheetLoadData& aData, const nsACString& aText) {
+  MOZ_ASSERT(aData.mURI);
+  auto lookup = mComplete.Lookup(SheetLoadDataHashKey(aData));
+  if (!lookup) {
+    return nullptr;
+  }
+
+  StyleSheet* cached = lookup.Data().mResource;
+  if (cached->HasModifiedRules() || !cached->WasParsedFrom(aText) ||
+      cached->HasImportRules()) {
+    return nullptr;
+  }
+
+  // The URL data of the new sheet may still differ, e.g. if the load was
+  // redirected somewhere else this time.
+  const StyleSheet& sheet = *aData.mSheet;
+  bool equal = false;
+  if (NS_FAILED(cached->GetBaseURI()->Equals(sheet.GetBaseURI(), &equal)) ||
+      !equal) {
+    return nullptr;
+  }
+  if (NS_FAILED(cached->GetReferrerInfo()->Equals(sheet.GetReferrerInfo(),
+                                                  &equal)) ||
+      !equal) {
+    return nullptr;
+  }
+  if (!cached->Principal()->Equals(sheet.Principal())) {
+    return nullptr;
+  }
+  LOG("  Found unchanged sheet in the shared cache: %s",
+      aData.mURI->GetSpecOrDefault().get());
+  return cached;
+}
+
 void SharedStyleSheetCache::LoadCompletedInternal(
     SharedStyleSheetCache* aCache, css::SheetLoadData& aData,
     nsTArray<RefPtr<css::SheetLoadData>>& aDatasToNotify) {
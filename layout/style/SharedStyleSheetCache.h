@@ -96,6 +96,11 @@ class SharedStyleSheetCache final
     principalMap.InsertOrUpdate(aBuffer, std::move(aSheet));
   }
 
+  // Returns the complete sheet of an earlier load like aData, even if it has
+  // expired, if aData's sheet can copy its contents instead of parsing aText.
+  StyleSheet* LookupUnchanged(const css::SheetLoadData& aData,
+                              const nsACString& aText);
+
  protected:
   void InsertIfNeeded(css::SheetLoadData&);
 
@@ -436,6 +436,7 @@ size_t StyleSheetInfo::SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) const {
   n += Servo_StyleSheet_SizeOfIncludingThis(
       ServoStyleSheetMallocSizeOf, ServoStyleSheetMallocEnclosingSizeOf,
       mContents);
+  n += mSourceText.SizeOfExcludingThisIfUnshared(aMallocSizeOf);
 
   return n;
 }
@@ -1196,6 +1197,42 @@ void StyleSheet::FixUpAfterInnerClone() {
   }
 }
 
+bool StyleSheet::HasImportRules() const {
+  RefPtr<StyleLockedCssRules> rules =
+      Servo_StyleSheet_GetRules(Inner().mContents.get()).Consume();
+  size_t len = Servo_CssRules_GetRuleCount(rules.get());
+  for (size_t i = 0; i < len; ++i) {
+    switch (Servo_CssRules_GetRuleTypeAt(rules, i)) {
+      case StyleCssRuleType::Import:
+        return true;
+      case StyleCssRuleType::LayerStatement:
+        break;
+      default:
+        // See FixUpAfterInnerClone.
+        return false;
+    }
+  }
+  return false;
+}
+
+void StyleSheet::CopyContentsFrom(const StyleSheet& aSheet) {
+  MOZ_ASSERT(!IsComplete());
+  MOZ_ASSERT(HasUniqueInner());
+  MOZ_ASSERT(Inner().mChildren.IsEmpty());
+  MOZ_ASSERT(!aSheet.HasImportRules());
+
+  StyleSheetInfo& info = Inner();
+  info.mContents = Servo_StyleSheet_Clone(aSheet.RawContents()).Consume();
+  // The contents refer to the URL data of aSheet, which is equivalent to
+  // ours.
+  info.mURLData = aSheet.URLData();
+  info.mSourceText = aSheet.Inner().mSourceText;
+  if (const StyleUseCounters* counters = aSheet.GetStyleUseCounters()) {
+    info.mUseCounters.reset(Servo_UseCounters_Create());
+    Servo_UseCounters_Merge(info.mUseCounters.get(), counters);
+  }
+}
+
 already_AddRefed<StyleSheet> StyleSheet::CreateEmptyChildSheet(
     already_AddRefed<dom::MediaList> aMediaList) const {
   auto child =
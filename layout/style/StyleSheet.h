@@ -163,6 +163,23 @@ class StyleSheet final : public nsICSSLoaderObserver, public nsWrapperCache {
 
   URLExtraData* URLData() const { return Inner().mURLData; }
 
+  // Keeps the text the sheet is about to be parsed from, see
+  // SharedStyleSheetCache::LookupUnchanged.
+  void SetSourceText(const nsACString& aText) {
+    Inner().mSourceText = aText;
+  }
+  bool WasParsedFrom(const nsACString& aText) const {
+    return !Inner().mSourceText.IsEmpty() && Inner().mSourceText == aText;
+  }
+
+  // Whether the sheet has @import rules, which need child sheets.
+  bool HasImportRules() const;
+
+  // Gives this sheet, which is being loaded, a copy of the contents of
+  // aSheet instead of parsing them.  aSheet must have been parsed from the
+  // same text with the same URL data, and not have @import rules.
+  void CopyContentsFrom(const StyleSheet& aSheet);
+
   // nsICSSLoaderObserver interface
   NS_IMETHOD StyleSheetLoaded(StyleSheet* aSheet, bool aWasDeferred,
                               nsresult aStatus) final;
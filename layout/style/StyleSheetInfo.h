@@ -73,6 +73,11 @@ struct StyleSheetInfo final {
 
   UniquePtr<StyleUseCounters> mUseCounters;
 
+  // The text mContents were parsed from, for external sheets that the
+  // SharedStyleSheetCache may reuse when their text didn't change.  Clones
+  // don't copy it, since their contents may diverge from the text.
+  nsCString mSourceText;
+
   // XXX We already have mSheetURI, mBaseURI, and mPrincipal.
   //
   // Can we somehow replace them with URLExtraData directly? The issue
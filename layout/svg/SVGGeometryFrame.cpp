@@ -236,6 +236,15 @@ nsIFrame* SVGGeometryFrame::GetFrameForPoint(const gfxPoint& aPoint) {
     isHit = path->ContainsPoint(ToPoint(aPoint), {});
   }
   if (!isHit && (hitTestFlags & SVG_HIT_TEST_STROKE)) {
+    // Testing the stroke outlines the whole path, so first reject the points
+    // that are farther from the path than the stroke can extend.
+    gfxRect strokeExtents = SVGUtils::PathExtentsToMaxStrokeExtents(
+        ThebesRect(path->GetBounds()), this, gfxMatrix());
+    if (aPoint.x < strokeExtents.X() || aPoint.x > strokeExtents.XMost() ||
+        aPoint.y < strokeExtents.Y() || aPoint.y > strokeExtents.YMost()) {
+      return nullptr;
+    }
+
     Point point = ToPoint(aPoint);
     SVGContentUtils::AutoStrokeOptions stroke;
     SVGContentUtils::GetStrokeOptions(&stroke, content, Style(), nullptr);
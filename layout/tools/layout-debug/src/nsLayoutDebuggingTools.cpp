@@ -18,6 +18,7 @@
 
 #include "nsCounterManager.h"
 #include "nsCSSFrameConstructor.h"
+#include "nsPresContext.h"
 #include "nsViewManager.h"
 #include "nsIFrame.h"
 
@@ -326,6 +327,12 @@ nsLayoutDebuggingTools::DumpComputedStyles() {
 NS_IMETHODIMP
 nsLayoutDebuggingTools::DumpReflowStats() {
   NS_ENSURE_TRUE(mDocShell, NS_ERROR_NOT_INITIALIZED);
+  if (PresShell* presShell = GetPresShell(mDocShell)) {
+    nsPresContext* presContext = presShell->GetPresContext();
+    printf("Flex/grid measurement cache: %u hits, %u misses\n",
+           presContext->MeasurementCacheHits(),
+           presContext->MeasurementCacheMisses());
+  }
 #ifdef DEBUG
   if (RefPtr<PresShell> presShell = GetPresShell(mDocShell)) {
 #  ifdef MOZ_REFLOW_PERF
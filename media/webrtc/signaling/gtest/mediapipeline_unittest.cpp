@@ -220,6 +220,8 @@ class LoopbackTransport : public MediaTransportHandler {
 
   void UpdateNetworkState(bool aOnline) override {}
 
+  void SetKeepReceivedEncryptedPackets(bool aKeep) override {}
+
   RefPtr<dom::RTCStatsPromise> GetIceStats(const std::string& aTransportId,
                                            DOMHighResTimeStamp aNow) override {
     return nullptr;
@@ -338,6 +338,14 @@ void pages_decommit(void* aAddr, size_t aSize) {
     pages_size = std::min(aSize, kChunkSize);
   }
 #else
+#  ifdef MALLOC_HUGE_PAGES
+  // Replacing the pages with a new mapping would split the huge page they are
+  // part of.  They stay accessible but read back as zeroes.
+  if (opt_huge_pages) {
+    madvise(aAddr, aSize, MADV_DONTNEED);
+    return;
+  }
+#  endif
   if (mmap(aAddr, aSize, PROT_NONE, MAP_FIXED | MAP_PRIVATE | MAP_ANON, -1,
            0) == MAP_FAILED) {
     // We'd like to report the OOM for our tooling, but we can't allocate
@@ -375,6 +383,12 @@ void pages_decommit(void* aAddr, size_t aSize) {
     pages_size = std::min(aSize, kChunkSize);
   }
 #else
+#  ifdef MALLOC_HUGE_PAGES
+  // pages_decommit() left the pages mapped.
+  if (opt_huge_pages) {
+    return true;
+  }
+#  endif
   if (mmap(aAddr, aSize, PROT_READ | PROT_WRITE,
            MAP_FIXED | MAP_PRIVATE | MAP_ANON, -1, 0) == MAP_FAILED) {
     return false;
@@ -500,12 +514,27 @@ static RedBlackTree<extent_node_t, ExtentTreeTrait> gChunksByAddress
 // The current amount of recycled bytes, updated atomically.
 Atomic<size_t> gRecycledSize;
 
+#ifdef MALLOC_HUGE_PAGES
+// Free chunks whose huge page region still holds a chunk in use.  Purging
+// them would split the huge page, so they keep their contents until the
+// other chunk is freed too, or they are reused.  Each node is one chunk, they
+// are never coalesced.  They also count in gRecycledSize.
+static RedBlackTree<extent_node_t, ExtentTreeTrait> gDirtyChunks
+    MOZ_GUARDED_BY(chunks_mtx);
+
+// The bytes in gDirtyChunks, updated atomically.
+Atomic<size_t> gDirtyChunksSize;
+#endif
+
 void chunks_init() {
   // Initialize chunks data.
   chunks_mtx.Init();
   MOZ_PUSH_IGNORE_THREAD_SAFETY
   gChunksBySize.Init();
   gChunksByAddress.Init();
+#ifdef MALLOC_HUGE_PAGES
+  gDirtyChunks.Init();
+#endif
   MOZ_POP_THREAD_SAFETY
 }
 
@@ -533,10 +562,20 @@ void chunk_assert_zero(void* aPtr, size_t aSize) {
 }
 #endif
 
+#ifdef MALLOC_HUGE_PAGES
+static void chunk_record_huge_pages(void* aChunk, size_t aSize);
+#endif
+
 static void chunk_record(void* aChunk, size_t aSize, ChunkType aType) {
   extent_node_t key;
 
   if (aType != ZEROED_CHUNK) {
+#ifdef MALLOC_HUGE_PAGES
+    if (opt_huge_pages) {
+      chunk_record_huge_pages(aChunk, aSize);
+      return;
+    }
+#endif
     if (pages_purge(aChunk, aSize, aType == HUGE_CHUNK)) {
       aType = ZEROED_CHUNK;
     }
@@ -607,6 +646,160 @@ static void chunk_record(void* aChunk, size_t aSize, ChunkType aType) {
   gRecycledSize += aSize;
 }
 
+#ifdef MALLOC_HUGE_PAGES
+// Whether the chunk at aChunk is in the trees of recycled chunks.
+static bool chunk_is_recycled(void* aChunk) MOZ_REQUIRES(chunks_mtx) {
+  extent_node_t key;
+  key.mAddr = aChunk;
+  extent_node_t* node = gChunksByAddress.SearchOrNext(&key);
+  if (node && node->mAddr == aChunk) {
+    return true;
+  }
+  node = node ? gChunksByAddress.Prev(node) : gChunksByAddress.Last();
+  return node && uintptr_t(node->mAddr) + node->mSize > uintptr_t(aChunk);
+}
+
+// Decides what to do with a free chunk whose buddy, the other chunk of its
+// huge page region, is at aBuddy.  Returns whether the chunk should be kept in
+// gDirtyChunks, which is the case while its buddy is in use.  If the buddy
+// was in gDirtyChunks its node is removed and returned in aClaimed, the caller
+// must purge it with the chunk.
+static bool chunk_keep_dirty(void* aBuddy, bool aCanKeep,
+                             UniqueBaseNode& aClaimed)
+    MOZ_REQUIRES(chunks_mtx) {
+  extent_node_t key;
+  key.mAddr = aBuddy;
+  extent_node_t* node = gDirtyChunks.Search(&key);
+  if (node) {
+    gDirtyChunks.Remove(node);
+    gDirtyChunksSize -= kChunkSize;
+    gRecycledSize -= kChunkSize;
+    aClaimed.reset(node);
+    return false;
+  }
+  return aCanKeep && !chunk_is_recycled(aBuddy) &&
+         gDirtyChunksSize + kChunkSize <= kHugePageDirtyLimit;
+}
+
+// chunk_record() for chunks of huge page regions.  The range is only purged
+// where that frees whole huge pages: a chunk at either end of it whose buddy
+// is in use is kept in gDirtyChunks instead.
+static void chunk_record_huge_pages(void* aChunk, size_t aSize) {
+  uintptr_t begin = uintptr_t(aChunk);
+  uintptr_t end = begin + aSize;
+
+  // Allocate the nodes before acquiring chunks_mtx, see chunk_record().
+  UniqueBaseNode head(ExtentAlloc::alloc());
+  UniqueBaseNode tail(ExtentAlloc::alloc());
+  UniqueBaseNode head_buddy;
+  UniqueBaseNode tail_buddy;
+
+  {
+    MutexAutoLock lock(chunks_mtx);
+    if (begin & kHugePageSizeMask) {
+      if (chunk_keep_dirty((void*)(begin - kChunkSize), !!head, head_buddy)) {
+        head->mAddr = (void*)begin;
+        head->mSize = kChunkSize;
+        head->mChunkType = RECYCLED_CHUNK;
+        gDirtyChunks.Insert(head.release());
+        gDirtyChunksSize += kChunkSize;
+        gRecycledSize += kChunkSize;
+        begin += kChunkSize;
+      } else if (head_buddy) {
+        begin -= kChunkSize;
+      }
+    }
+    if (end > begin && (end & kHugePageSizeMask)) {
+      if (chunk_keep_dirty((void*)end, !!tail, tail_buddy)) {
+        tail->mAddr = (void*)(end - kChunkSize);
+        tail->mSize = kChunkSize;
+        tail->mChunkType = RECYCLED_CHUNK;
+        gDirtyChunks.Insert(tail.release());
+        gDirtyChunksSize += kChunkSize;
+        gRecycledSize += kChunkSize;
+        end -= kChunkSize;
+      } else if (tail_buddy) {
+        end += kChunkSize;
+      }
+    }
+  }
+
+  if (end > begin) {
+    pages_decommit((void*)begin, end - begin);
+    chunk_record((void*)begin, end - begin, ZEROED_CHUNK);
+  }
+}
+
+// Takes a chunk from gDirtyChunks for reuse.
+static void* chunk_recycle_dirty() {
+  extent_node_t* node;
+  {
+    MutexAutoLock lock(chunks_mtx);
+    node = gDirtyChunks.First();
+    if (!node) {
+      return nullptr;
+    }
+    gDirtyChunks.Remove(node);
+    gDirtyChunksSize -= kChunkSize;
+    gRecycledSize -= kChunkSize;
+  }
+
+  void* ret = node->mAddr;
+  ExtentAlloc::dealloc(node);
+  // The pages are resident, clearing them is cheaper than faulting in new
+  // ones.
+  memset(ret, 0, kChunkSize);
+  return ret;
+}
+
+void chunks_purge_dirty() {
+  while (true) {
+    extent_node_t* node;
+    {
+      MutexAutoLock lock(chunks_mtx);
+      node = gDirtyChunks.First();
+      if (!node) {
+        return;
+      }
+      gDirtyChunks.Remove(node);
+      gDirtyChunksSize -= kChunkSize;
+      gRecycledSize -= kChunkSize;
+    }
+
+    void* chunk = node->mAddr;
+    ExtentAlloc::dealloc(node);
+    pages_decommit(chunk, kChunkSize);
+    chunk_record(chunk, kChunkSize, ZEROED_CHUNK);
+  }
+}
+
+// Maps chunks for chunk_alloc() in huge page mode.  The mapping is rounded up
+// to whole huge page regions and the chunk left over at its end is recycled,
+// so the next chunk completes the region.
+static void* chunk_alloc_huge_pages(size_t aSize, size_t aAlignment) {
+  size_t size = (aSize + kHugePageSizeMask) & ~kHugePageSizeMask;
+  // Beware size_t wrap-around.
+  if (size < aSize) {
+    return nullptr;
+  }
+  void* ret = chunk_alloc_mmap(size, std::max(aAlignment, kHugePageSize));
+  if (!ret) {
+    return nullptr;
+  }
+  madvise(ret, size, MADV_HUGEPAGE);
+
+  if (size != aSize) {
+    void* rest = (void*)(uintptr_t(ret) + aSize);
+    if (gRecycledSize + (size - aSize) <= gRecycleLimit) {
+      chunk_record(rest, size - aSize, ZEROED_CHUNK);
+    } else {
+      pages_unmap(rest, size - aSize);
+    }
+  }
+  return ret;
+}
+#endif
+
 void chunk_dealloc(void* aChunk, size_t aSize, ChunkType aType) {
   MOZ_ASSERT(aChunk);
   MOZ_ASSERT(GetChunkOffsetForPtr(aChunk) == 0);
@@ -639,6 +832,15 @@ void chunk_dealloc(void* aChunk, size_t aSize, ChunkType aType) {
 static void* chunk_recycle(size_t aSize, size_t aAlignment) {
   extent_node_t key;
 
+#ifdef MALLOC_HUGE_PAGES
+  if (opt_huge_pages && aSize == kChunkSize) {
+    void* ret = chunk_recycle_dirty();
+    if (ret) {
+      return ret;
+    }
+  }
+#endif
+
   size_t alloc_size = aSize + aAlignment - kChunkSize;
   // Beware size_t wrap-around.
   if (alloc_size < aSize) {
@@ -730,7 +932,12 @@ void* chunk_alloc(size_t aSize, size_t aAlignment, bool aBase) {
     ret = chunk_recycle(aSize, aAlignment);
   }
   if (!ret) {
+#ifdef MALLOC_HUGE_PAGES
+    ret = (opt_huge_pages && !aBase) ? chunk_alloc_huge_pages(aSize, aAlignment)
+                                     : chunk_alloc_mmap(aSize, aAlignment);
+#else
     ret = chunk_alloc_mmap(aSize, aAlignment);
+#endif
   }
   if (ret && !aBase) {
     if (!gChunkRTree.Set(ret, ret)) {
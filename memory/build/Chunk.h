@@ -191,6 +191,13 @@ void chunk_assert_zero(void* aPtr, size_t aSize);
 
 extern mozilla::Atomic<size_t> gRecycledSize;
 
+#ifdef MALLOC_HUGE_PAGES
+// Purges the free chunks kept resident to avoid splitting their huge page.
+void chunks_purge_dirty();
+
+extern mozilla::Atomic<size_t> gDirtyChunksSize;
+#endif
+
 extern AddressRadixTree<(sizeof(void*) << 3) - LOG2(kChunkSize)> gChunkRTree;
 
 #endif /* ! CHUNK_H */
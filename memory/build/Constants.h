@@ -42,6 +42,18 @@
 #  define MALLOC_DECOMMIT
 #endif
 
+// Small allocations of the default arena go through per-thread caches, see
+// ThreadCache.  Giving the cached regions back when a thread exits needs a
+// thread-specific data destructor, which we only use with pthreads.
+#ifndef XP_WIN
+#  define MALLOC_THREAD_CACHE
+#endif
+
+// Chunks can be grouped into transparent huge pages, see opt_huge_pages.
+#ifdef XP_LINUX
+#  define MALLOC_HUGE_PAGES
+#endif
+
 #ifndef XP_WIN
 // Newer Linux systems support MADV_FREE, but we're not supporting
 // that properly. bug #1406304.
@@ -112,11 +124,37 @@ static constexpr size_t kNumQuantumClasses =
 static constexpr size_t kNumQuantumWideClasses =
     (kMaxQuantumWideClass + kQuantumWide - kMinQuantumWideClass) / kQuantumWide;
 
+#ifdef MALLOC_THREAD_CACHE
+// Thread caches only hold tiny and quantum-spaced classes, which have the same
+// bin indices in every arena.
+static constexpr size_t kNumThreadCacheBins =
+    kNumTinyClasses + kNumQuantumClasses;
+
+// The most regions, and roughly the most bytes, a thread caches per class.
+static constexpr size_t kThreadCacheBinMaxSlots = 32;
+static constexpr size_t kThreadCacheBinMaxBytes = 2_KiB;
+#endif
+
 // Size and alignment of memory chunks that are allocated by the OS's virtual
 // memory system.
 static constexpr size_t kChunkSize = 1_MiB;
 static constexpr size_t kChunkSizeMask = kChunkSize - 1;
 
+// Size and alignment of the regions chunks are grouped into when they are
+// backed by transparent huge pages.  Each region holds two chunks.
+static constexpr size_t kHugePageSize = 2_MiB;
+static constexpr size_t kHugePageSizeMask = kHugePageSize - 1;
+static_assert(kHugePageSize == 2 * kChunkSize);
+
+// With huge pages, free chunks stay resident while the other chunk of their
+// region is in use, up to this many bytes.
+static constexpr size_t kHugePageDirtyLimit = 16_MiB;
+
+// With huge pages, arenas allow 1 << kHugePageDirtyShift times as many dirty
+// pages before purging, since purging part of a chunk splits its huge page.
+// That lets the default arena hold about a huge page of dirty pages.
+static constexpr size_t kHugePageDirtyShift = 4;
+
 // Maximum size of L1 cache line.  This is used to avoid cache line aliasing,
 // so over-estimates are okay (up to a point), but under-estimates will
 // negatively affect performance.
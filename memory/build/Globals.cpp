@@ -66,4 +66,12 @@ size_t opt_poison_size = OPT_POISON_SIZE_DEFAULT;
 
 bool opt_randomize_small = true;
 
+#ifdef MALLOC_THREAD_CACHE
+bool opt_thread_cache = true;
+#endif
+
+#ifdef MALLOC_HUGE_PAGES
+bool opt_huge_pages = false;
+#endif
+
 }  // namespace mozilla
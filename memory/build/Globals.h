@@ -180,6 +180,16 @@ static_assert((opt_poison_size % kCacheLineSize) == 0);
 
 extern bool opt_randomize_small;
 
+#ifdef MALLOC_THREAD_CACHE
+extern bool opt_thread_cache;
+#endif
+
+#ifdef MALLOC_HUGE_PAGES
+extern bool opt_huge_pages;
+#else
+constexpr bool opt_huge_pages = false;
+#endif
+
 }  // namespace mozilla
 
 #endif  // ! GLOBALS_H
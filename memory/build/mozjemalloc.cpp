@@ -736,6 +736,22 @@ struct arena_t {
   [[nodiscard]] arena_chunk_t* DallocLarge(arena_chunk_t* aChunk, void* aPtr)
       MOZ_REQUIRES(mLock);
 
+#ifdef MALLOC_THREAD_CACHE
+  // Allocate up to aCount regions from the bin with the given index, taking the
+  // lock only once.  Used to refill thread caches.  Returns the number of
+  // regions stored in aPtrs.
+  size_t MallocSmallBatch(size_t aBinIndex, void** aPtrs, size_t aCount)
+      MOZ_EXCLUDES(mLock);
+
+  // Free small regions of this arena, taking the lock only once.  Used to
+  // flush thread caches.
+  void DallocSmallBatch(void** aPtrs, size_t aCount) MOZ_EXCLUDES(mLock);
+
+  bool RandomizesSmallAllocations() const {
+    return mRandomizeSmallAllocations;
+  }
+#endif
+
   void* Ralloc(void* aPtr, size_t aSize, size_t aOldSize) MOZ_EXCLUDES(mLock);
 
   void UpdateMaxDirty() MOZ_EXCLUDES(mLock);
@@ -1209,11 +1225,26 @@ static detail::ThreadLocal<arena_t*, detail::ThreadLocalKeyStorage>
     thread_arena;
 #endif
 
+#ifdef MALLOC_THREAD_CACHE
+struct ThreadCache;
+
+// The cache of small regions of the current thread, see ThreadCache.
+#  if !defined(XP_DARWIN)
+static MOZ_THREAD_LOCAL(ThreadCache*) thread_cache;
+#  else
+static detail::ThreadLocal<ThreadCache*, detail::ThreadLocalKeyStorage>
+    thread_cache;
+#  endif
+#endif
+
 // ***************************************************************************
 // Begin forward declarations.
 
 static void huge_dalloc(void* aPtr, arena_t* aArena);
 static bool malloc_init_hard();
+#ifdef MALLOC_THREAD_CACHE
+static void thread_cache_disable();
+#endif
 
 #ifndef XP_WIN
 #  ifdef XP_DARWIN
@@ -1280,6 +1311,10 @@ static inline arena_t* thread_local_arena(bool enabled) {
   arena_t* arena;
 
   if (enabled) {
+#ifdef MALLOC_THREAD_CACHE
+    // The thread cache only holds regions of the default arena.
+    thread_cache_disable();
+#endif
     // The arena will essentially be leaked if this function is
     // called with `false`, but it doesn't matter at the moment.
     // because in practice nothing actually calls this function
@@ -1582,8 +1617,13 @@ void arena_t::InitChunk(arena_chunk_t* aChunk, size_t aMinCommittedPages) {
   }
   mStats.committed += gChunkHeaderNumPages - 1;
 
-  // Decommit the last header page (=leading page) as a guard.
-  pages_decommit((void*)(uintptr_t(aChunk) + (i << gPageSize2Pow)), gPageSize);
+  // Decommit the last header page (=leading page) as a guard.  Not with huge
+  // pages, where the guard pages would split them and can't be made
+  // inaccessible anyway.  They are still never used.
+  if (!opt_huge_pages) {
+    pages_decommit((void*)(uintptr_t(aChunk) + (i << gPageSize2Pow)),
+                   gPageSize);
+  }
   aChunk->map[i++].bits = CHUNK_MAP_DECOMMITTED;
 
   // If MALLOC_DECOMMIT is enabled then commit only the pages we're about to
@@ -1615,8 +1655,10 @@ void arena_t::InitChunk(arena_chunk_t* aChunk, size_t aMinCommittedPages) {
   // If MALLOC_DECOMMIT is defined, then this will decommit the remainder of the
   // chunk plus the last page which is a guard page, if it is not defined it
   // will only decommit the guard page.
-  pages_decommit((void*)(uintptr_t(aChunk) + (i << gPageSize2Pow)),
-                 (gChunkNumPages - i) << gPageSize2Pow);
+  if (!opt_huge_pages) {
+    pages_decommit((void*)(uintptr_t(aChunk) + (i << gPageSize2Pow)),
+                   (gChunkNumPages - i) << gPageSize2Pow);
+  }
   for (; i < gChunkNumPages; i++) {
     aChunk->map[i].bits = CHUNK_MAP_DECOMMITTED;
   }
@@ -2542,37 +2584,38 @@ void arena_t::InitPRNG() {
   mIsPRNGInitializing = false;
 }
 
-void* arena_t::MallocSmall(size_t aSize, bool aZero) {
-  void* ret;
-  arena_bin_t* bin;
-  arena_run_t* run;
-  SizeClass sizeClass(aSize);
-  aSize = sizeClass.Size();
+// The index in arena_t::mBins of the bin for the given small size class.
+static inline size_t GetBinIndex(SizeClass aSizeClass) {
+  size_t size = aSizeClass.Size();
 
-  switch (sizeClass.Type()) {
+  switch (aSizeClass.Type()) {
     case SizeClass::Tiny:
-      bin = &mBins[FloorLog2(aSize / kMinTinyClass)];
-      break;
+      return FloorLog2(size / kMinTinyClass);
     case SizeClass::Quantum:
       // Although we divide 2 things by kQuantum, the compiler will
       // reduce `kMinQuantumClass / kQuantum` and `kNumTinyClasses` to a
       // single constant.
-      bin = &mBins[kNumTinyClasses + (aSize / kQuantum) -
-                   (kMinQuantumClass / kQuantum)];
-      break;
+      return kNumTinyClasses + (size / kQuantum) -
+             (kMinQuantumClass / kQuantum);
     case SizeClass::QuantumWide:
-      bin =
-          &mBins[kNumTinyClasses + kNumQuantumClasses + (aSize / kQuantumWide) -
-                 (kMinQuantumWideClass / kQuantumWide)];
-      break;
+      return kNumTinyClasses + kNumQuantumClasses + (size / kQuantumWide) -
+             (kMinQuantumWideClass / kQuantumWide);
     case SizeClass::SubPage:
-      bin =
-          &mBins[kNumTinyClasses + kNumQuantumClasses + kNumQuantumWideClasses +
-                 (FloorLog2(aSize) - LOG2(kMinSubPageClass))];
-      break;
+      return kNumTinyClasses + kNumQuantumClasses + kNumQuantumWideClasses +
+             (FloorLog2(size) - LOG2(kMinSubPageClass));
     default:
       MOZ_MAKE_COMPILER_ASSUME_IS_UNREACHABLE("Unexpected size class type");
   }
+}
+
+void* arena_t::MallocSmall(size_t aSize, bool aZero) {
+  void* ret;
+  arena_bin_t* bin;
+  arena_run_t* run;
+  SizeClass sizeClass(aSize);
+  aSize = sizeClass.Size();
+
+  bin = &mBins[GetBinIndex(sizeClass)];
   MOZ_DIAGNOSTIC_ASSERT(aSize == bin->mSizeClass);
 
   size_t num_dirty_before, num_dirty_after;
@@ -2624,6 +2667,43 @@ void* arena_t::MallocSmall(size_t aSize, bool aZero) {
   return ret;
 }
 
+#ifdef MALLOC_THREAD_CACHE
+size_t arena_t::MallocSmallBatch(size_t aBinIndex, void** aPtrs,
+                                 size_t aCount) {
+  size_t count = 0;
+  size_t num_dirty_before, num_dirty_after;
+  {
+    MaybeMutexAutoLock lock(mLock);
+    arena_bin_t* bin = &mBins[aBinIndex];
+
+    // Thread caches aren't used while small allocations are randomized, so we
+    // don't need to initialize mPRNG here.
+    num_dirty_before = mNumDirty;
+    while (count < aCount) {
+      arena_run_t* run = GetNonFullBinRun(bin);
+      if (MOZ_UNLIKELY(!run)) {
+        break;
+      }
+      MOZ_DIAGNOSTIC_ASSERT(run->mMagic == ARENA_RUN_MAGIC);
+      MOZ_DIAGNOSTIC_ASSERT(run->mNumFree > 0);
+      void* ret = ArenaRunRegAlloc(run, bin);
+      MOZ_DIAGNOSTIC_ASSERT(ret);
+      run->mNumFree--;
+      aPtrs[count++] = ret;
+    }
+    num_dirty_after = mNumDirty;
+
+    mStats.allocated_small += count * bin->mSizeClass;
+    mStats.operations += count;
+  }
+  if (num_dirty_after < num_dirty_before) {
+    NotifySignificantReuse();
+  }
+
+  return count;
+}
+#endif
+
 void* arena_t::MallocLarge(size_t aSize, bool aZero) {
   void* ret;
 
@@ -3098,6 +3178,39 @@ arena_chunk_t* arena_t::DallocLarge(arena_chunk_t* aChunk, void* aPtr) {
   return DallocRun((arena_run_t*)aPtr, true);
 }
 
+#ifdef MALLOC_THREAD_CACHE
+void arena_t::DallocSmallBatch(void** aPtrs, size_t aCount) {
+  MOZ_ASSERT(aCount <= kThreadCacheBinMaxSlots);
+
+  // Each region freed can at most release one chunk.
+  arena_chunk_t* dealloc_chunks[kThreadCacheBinMaxSlots];
+  size_t num_dealloc_chunks = 0;
+  purge_action_t purge_action;
+  {
+    MaybeMutexAutoLock lock(mLock);
+    for (size_t i = 0; i < aCount; i++) {
+      arena_chunk_t* chunk = GetChunkForPtr(aPtrs[i]);
+      MOZ_DIAGNOSTIC_ASSERT(chunk->arena == this);
+      size_t pageind =
+          (uintptr_t(aPtrs[i]) - uintptr_t(chunk)) >> gPageSize2Pow;
+      arena_chunk_map_t* mapelm = &chunk->map[pageind];
+      MOZ_DIAGNOSTIC_ASSERT((mapelm->bits & CHUNK_MAP_LARGE) == 0);
+      if (arena_chunk_t* dealloc = DallocSmall(chunk, aPtrs[i], mapelm)) {
+        dealloc_chunks[num_dealloc_chunks++] = dealloc;
+      }
+    }
+
+    purge_action = ShouldStartPurge();
+  }
+
+  for (size_t i = 0; i < num_dealloc_chunks; i++) {
+    chunk_dealloc((void*)dealloc_chunks[i], kChunkSize, ARENA_CHUNK);
+  }
+
+  MayDoOrQueuePurge(purge_action, "DallocSmallBatch");
+}
+#endif
+
 static inline void arena_dalloc(void* aPtr, size_t aOffset, arena_t* aArena) {
   MOZ_ASSERT(aPtr);
   MOZ_ASSERT(aOffset != 0);
@@ -3207,6 +3320,319 @@ inline void arena_t::NotifySignificantReuse() {
   mLastSignificantReuseNS = GetTimestampNS();
 }
 
+#ifdef MALLOC_THREAD_CACHE
+// ***************************************************************************
+// Begin thread cache.
+
+// Most small allocations are made from the default arena, by many threads at
+// once, and they all contend on its lock.  So every thread keeps a few free
+// regions of each tiny and quantum-spaced class of the default arena.  An
+// allocation that finds its class empty refills half of it, and a free that
+// finds it full flushes the older half, each taking the arena lock only once.
+// The regions go back to the arena when the thread exits, or calls
+// jemalloc_thread_local_arena(true) or jemalloc_free_dirty_pages().
+//
+// Cached regions still count as allocated in the arena.  The caches are not
+// used while the default arena randomizes small allocations, since handing
+// freed regions out again in LIFO order would defeat the randomization.
+// Content processes don't randomize them.
+struct ThreadCache {
+  struct Bin {
+    uint16_t mSize;
+    uint8_t mCount;
+    uint8_t mCapacity;
+    void* mSlots[kThreadCacheBinMaxSlots];
+  };
+
+  arena_t* mArena;
+
+  // Links in gThreadCaches.
+  ThreadCache* mPrev;
+  ThreadCache* mNext;
+
+  // Only written by the owning thread, also read by jemalloc_stats.
+  Atomic<size_t, Relaxed> mBytes;
+  Atomic<size_t, Relaxed> mHits;
+  Atomic<size_t, Relaxed> mMisses;
+
+  Bin mBins[kNumThreadCacheBins];
+
+  explicit ThreadCache(arena_t* aArena);
+
+  // The cache of the current thread for allocations from aArena, created on
+  // first use.  Returns null if they must go to the arena.
+  static inline ThreadCache* Get(arena_t* aArena);
+
+  // The pthread key destructor.  Flushes and releases the cache.
+  static void Destroy(void* aCache);
+
+  // Returns null if the bin can't be refilled.
+  inline void* Malloc(size_t aBinIndex);
+  inline void Free(size_t aBinIndex, void* aPtr);
+  void FlushAll();
+
+ private:
+  static ThreadCache* Create(arena_t* aArena);
+
+  void Flush(Bin& aBin, size_t aCount);
+
+  // This thread is the only writer, so the counters don't need atomic
+  // read-modify-writes.
+  static void Add(Atomic<size_t, Relaxed>& aCounter, size_t aValue) {
+    aCounter = aCounter + aValue;
+  }
+  static void Sub(Atomic<size_t, Relaxed>& aCounter, size_t aValue) {
+    aCounter = aCounter - aValue;
+  }
+};
+
+// thread_cache is set to this while a thread must not use a cache: while its
+// cache is being created, and after it was destroyed.
+static constexpr uintptr_t kThreadCacheDisabled = 1;
+
+static inline ThreadCache* ThreadCacheDisabled() {
+  return reinterpret_cast<ThreadCache*>(kThreadCacheDisabled);
+}
+
+// Guards the list of caches and the counters of the threads that exited.
+static Mutex gThreadCachesLock;
+static ThreadCache* gThreadCaches MOZ_GUARDED_BY(gThreadCachesLock);
+static size_t gExitedThreadCacheHits MOZ_GUARDED_BY(gThreadCachesLock);
+static size_t gExitedThreadCacheMisses MOZ_GUARDED_BY(gThreadCachesLock);
+
+// Calls ThreadCache::Destroy when a thread with a cache exits.
+static pthread_key_t gThreadCacheKey;
+
+ThreadCache::ThreadCache(arena_t* aArena)
+    : mArena(aArena),
+      mPrev(nullptr),
+      mNext(nullptr),
+      mBytes(0),
+      mHits(0),
+      mMisses(0) {
+  for (size_t i = 0; i < kNumThreadCacheBins; i++) {
+    size_t size = i < kNumTinyClasses
+                      ? kMinTinyClass << i
+                      : kMinQuantumClass + (i - kNumTinyClasses) * kQuantum;
+    MOZ_ASSERT(GetBinIndex(SizeClass(size)) == i);
+    mBins[i].mSize = size;
+    mBins[i].mCount = 0;
+    mBins[i].mCapacity = std::max(
+        size_t(2), std::min(kThreadCacheBinMaxSlots,
+                            kThreadCacheBinMaxBytes / size));
+  }
+}
+
+/* static */
+inline ThreadCache* ThreadCache::Get(arena_t* aArena) {
+  ThreadCache* cache = thread_cache.get();
+  if (MOZ_UNLIKELY(uintptr_t(cache) <= kThreadCacheDisabled)) {
+    if (cache || !opt_thread_cache || aArena != gArenas.GetDefault() ||
+        aArena->RandomizesSmallAllocations()) {
+      return nullptr;
+    }
+
+    // The allocations made while we create the cache go to the arena.
+    thread_cache.set(ThreadCacheDisabled());
+    cache = Create(aArena);
+    thread_cache.set(cache ? cache : ThreadCacheDisabled());
+    return cache;
+  }
+
+  if (cache->mArena != aArena || aArena->RandomizesSmallAllocations()) {
+    return nullptr;
+  }
+  return cache;
+}
+
+/* static */
+ThreadCache* ThreadCache::Create(arena_t* aArena) {
+  ThreadCache* cache = TypedBaseAlloc<ThreadCache>::alloc();
+  if (!cache) {
+    return nullptr;
+  }
+  new (cache) ThreadCache(aArena);
+
+  if (pthread_setspecific(gThreadCacheKey, cache) != 0) {
+    cache->~ThreadCache();
+    TypedBaseAlloc<ThreadCache>::dealloc(cache);
+    return nullptr;
+  }
+
+  MutexAutoLock lock(gThreadCachesLock);
+  cache->mNext = gThreadCaches;
+  if (gThreadCaches) {
+    gThreadCaches->mPrev = cache;
+  }
+  gThreadCaches = cache;
+  return cache;
+}
+
+/* static */
+void ThreadCache::Destroy(void* aCache) {
+  auto* cache = static_cast<ThreadCache*>(aCache);
+
+  // The frees made by the destructors that run after this one go to the
+  // arena.
+  thread_cache.set(ThreadCacheDisabled());
+  cache->FlushAll();
+
+  {
+    MutexAutoLock lock(gThreadCachesLock);
+    if (cache->mPrev) {
+      cache->mPrev->mNext = cache->mNext;
+    } else {
+      MOZ_ASSERT(gThreadCaches == cache);
+      gThreadCaches = cache->mNext;
+    }
+    if (cache->mNext) {
+      cache->mNext->mPrev = cache->mPrev;
+    }
+    gExitedThreadCacheHits += cache->mHits;
+    gExitedThreadCacheMisses += cache->mMisses;
+  }
+
+  cache->~ThreadCache();
+  TypedBaseAlloc<ThreadCache>::dealloc(cache);
+}
+
+inline void* ThreadCache::Malloc(size_t aBinIndex) {
+  Bin& bin = mBins[aBinIndex];
+  if (MOZ_UNLIKELY(bin.mCount == 0)) {
+    Add(mMisses, 1);
+    bin.mCount = static_cast<uint8_t>(
+        mArena->MallocSmallBatch(aBinIndex, bin.mSlots, bin.mCapacity / 2));
+    if (!bin.mCount) {
+      return nullptr;
+    }
+    Add(mBytes, bin.mCount * bin.mSize);
+  } else {
+    Add(mHits, 1);
+  }
+
+  bin.mCount--;
+  Sub(mBytes, bin.mSize);
+  return bin.mSlots[bin.mCount];
+}
+
+inline void ThreadCache::Free(size_t aBinIndex, void* aPtr) {
+  Bin& bin = mBins[aBinIndex];
+#ifdef MOZ_DIAGNOSTIC_ASSERT_ENABLED
+  for (size_t i = 0; i < bin.mCount; i++) {
+    MOZ_DIAGNOSTIC_ASSERT(bin.mSlots[i] != aPtr, "Double-free?");
+  }
+#endif
+
+  if (bin.mCount == bin.mCapacity) {
+    Flush(bin, bin.mCapacity / 2);
+  }
+  bin.mSlots[bin.mCount++] = aPtr;
+  Add(mBytes, bin.mSize);
+}
+
+void ThreadCache::Flush(Bin& aBin, size_t aCount) {
+  MOZ_ASSERT(aCount <= aBin.mCount);
+  if (!aCount) {
+    return;
+  }
+
+  // Give back the regions freed first, the most recent ones are more likely
+  // to still be in the CPU caches.
+  mArena->DallocSmallBatch(aBin.mSlots, aCount);
+  memmove(aBin.mSlots, aBin.mSlots + aCount,
+          (aBin.mCount - aCount) * sizeof(void*));
+  aBin.mCount -= aCount;
+  Sub(mBytes, aCount * aBin.mSize);
+}
+
+void ThreadCache::FlushAll() {
+  for (Bin& bin : mBins) {
+    Flush(bin, bin.mCount);
+  }
+}
+
+// Free aPtr into the current thread's cache, if it has one that can take it.
+// Returns whether it did.
+static inline bool thread_cache_free(void* aPtr, size_t aOffset) {
+  ThreadCache* cache = thread_cache.get();
+  if (uintptr_t(cache) <= kThreadCacheDisabled) {
+    return false;
+  }
+
+  auto chunk = (arena_chunk_t*)((uintptr_t)aPtr - aOffset);
+  if (chunk->arena != cache->mArena ||
+      cache->mArena->RandomizesSmallAllocations()) {
+    return false;
+  }
+
+  // The map entries of the pages of a small run don't change while any of its
+  // regions is allocated, so we can read them without the arena lock.
+  size_t bits = chunk->map[aOffset >> gPageSize2Pow].bits;
+  MOZ_RELEASE_ASSERT(
+      (bits & (CHUNK_MAP_FRESH_MADVISED_OR_DECOMMITTED | CHUNK_MAP_ZEROED)) ==
+          0,
+      "Freeing in a page with bad bits.");
+  MOZ_RELEASE_ASSERT((bits & CHUNK_MAP_ALLOCATED) != 0, "Double-free?");
+  if (bits & CHUNK_MAP_LARGE) {
+    return false;
+  }
+
+  auto run = (arena_run_t*)(bits & ~gPageSizeMask);
+  MOZ_DIAGNOSTIC_ASSERT(run->mMagic == ARENA_RUN_MAGIC);
+  size_t size = run->mBin->mSizeClass;
+  if (size > kMaxQuantumClass) {
+    return false;
+  }
+
+  if (opt_poison) {
+    MaybePoison(aPtr, size);
+  }
+  cache->Free(GetBinIndex(SizeClass(size)), aPtr);
+  return true;
+}
+
+static void thread_cache_disable() {
+  ThreadCache* cache = thread_cache.get();
+  if (uintptr_t(cache) > kThreadCacheDisabled) {
+    pthread_setspecific(gThreadCacheKey, nullptr);
+    ThreadCache::Destroy(cache);
+  }
+  thread_cache.set(ThreadCacheDisabled());
+}
+
+static void thread_cache_flush() {
+  ThreadCache* cache = thread_cache.get();
+  if (uintptr_t(cache) > kThreadCacheDisabled) {
+    cache->FlushAll();
+  }
+}
+
+// End thread cache.
+// ***************************************************************************
+#endif  // MALLOC_THREAD_CACHE
+
+// Allocate from aArena, through the current thread's cache if aArena was
+// picked by choose_arena() rather than given by the caller.
+static inline void* arena_malloc(arena_t* aArena, bool aChosen, size_t aSize,
+                                 bool aZero) {
+#ifdef MALLOC_THREAD_CACHE
+  if (aChosen && aSize <= kMaxQuantumClass) {
+    if (ThreadCache* cache = ThreadCache::Get(aArena)) {
+      SizeClass sizeClass(aSize);
+      if (void* ret = cache->Malloc(GetBinIndex(sizeClass))) {
+        if (!aZero) {
+          ApplyZeroOrJunk(ret, sizeClass.Size());
+        } else {
+          memset(ret, 0, sizeClass.Size());
+        }
+        return ret;
+      }
+    }
+  }
+#endif
+  return aArena->Malloc(aSize, aZero);
+}
+
 void arena_t::RallocShrinkLarge(arena_chunk_t* aChunk, void* aPtr, size_t aSize,
                                 size_t aOldSize) {
   MOZ_ASSERT(aSize < aOldSize);
@@ -3444,6 +3870,9 @@ arena_t::arena_t(arena_params_t* aParams, bool aIsPrivate) {
   // of opt_dirty_max.
   mMaxDirtyBase = (aParams && aParams->mMaxDirty) ? aParams->mMaxDirty
                                                   : (opt_dirty_max / 8);
+  if (opt_huge_pages) {
+    mMaxDirtyBase <<= kHugePageDirtyShift;
+  }
   UpdateMaxDirty();
 
   mRunsAvail.Init();
@@ -3794,6 +4223,11 @@ static bool malloc_init_hard() {
   if (!thread_arena.init()) {
     return true;
   }
+#ifdef MALLOC_THREAD_CACHE
+  if (!thread_cache.init()) {
+    opt_thread_cache = false;
+  }
+#endif
 
   // Get page size and number of CPUs
   const size_t page_size = GetKernelPageSize();
@@ -3890,6 +4324,22 @@ static bool malloc_init_hard() {
         case 'R':
           opt_randomize_small = true;
           break;
+#ifdef MALLOC_HUGE_PAGES
+        case 'h':
+          opt_huge_pages = false;
+          break;
+        case 'H':
+          opt_huge_pages = true;
+          break;
+#endif
+#ifdef MALLOC_THREAD_CACHE
+        case 't':
+          opt_thread_cache = false;
+          break;
+        case 'T':
+          opt_thread_cache = true;
+          break;
+#endif
         default: {
           char cbuf[2];
 
@@ -3921,6 +4371,15 @@ static bool malloc_init_hard() {
   // Assign the default arena to the initial thread.
   thread_arena.set(gArenas.GetDefault());
 
+#ifdef MALLOC_THREAD_CACHE
+  if (!gThreadCachesLock.Init()) {
+    return false;
+  }
+  if (pthread_key_create(&gThreadCacheKey, ThreadCache::Destroy) != 0) {
+    opt_thread_cache = false;
+  }
+#endif
+
   if (!gChunkRTree.Init()) {
     return false;
   }
@@ -3983,7 +4442,7 @@ inline void* BaseAllocator::malloc(size_t aSize) {
   // If mArena is non-null, it must not be in the first page.
   MOZ_DIAGNOSTIC_ASSERT_IF(mArena, (size_t)mArena >= gPageSize);
   arena = mArena ? mArena : choose_arena(aSize);
-  ret = arena->Malloc(aSize, /* aZero = */ false);
+  ret = arena_malloc(arena, !mArena, aSize, /* aZero = */ false);
 
 RETURN:
   if (!ret) {
@@ -4020,7 +4479,7 @@ inline void* BaseAllocator::calloc(size_t aNum, size_t aSize) {
         allocSize = 1;
       }
       arena_t* arena = mArena ? mArena : choose_arena(allocSize);
-      ret = arena->Malloc(allocSize, /* aZero = */ true);
+      ret = arena_malloc(arena, !mArena, allocSize, /* aZero = */ true);
     } else {
       ret = nullptr;
     }
@@ -4054,7 +4513,7 @@ inline void* BaseAllocator::realloc(void* aPtr, size_t aSize) {
       ret = nullptr;
     } else {
       arena_t* arena = mArena ? mArena : choose_arena(aSize);
-      ret = arena->Malloc(aSize, /* aZero = */ false);
+      ret = arena_malloc(arena, !mArena, aSize, /* aZero = */ false);
     }
   }
 
@@ -4071,6 +4530,11 @@ inline void BaseAllocator::free(void* aPtr) {
   offset = GetChunkOffsetForPtr(aPtr);
   if (offset != 0) {
     MOZ_RELEASE_ASSERT(malloc_initialized);
+#ifdef MALLOC_THREAD_CACHE
+    if (!mArena && thread_cache_free(aPtr, offset)) {
+      return;
+    }
+#endif
     arena_dalloc(aPtr, offset, mArena);
   } else if (aPtr) {
     MOZ_RELEASE_ASSERT(malloc_initialized);
@@ -4153,6 +4617,15 @@ inline void MozJemalloc::jemalloc_stats_internal(
   aStats->pages_madvised = 0;
   aStats->bookkeeping = 0;
   aStats->bin_unused = 0;
+  aStats->thread_caches = 0;
+  aStats->thread_cache_bytes = 0;
+  aStats->thread_cache_hits = 0;
+  aStats->thread_cache_misses = 0;
+#ifdef MALLOC_HUGE_PAGES
+  aStats->chunks_dirty = gDirtyChunksSize;
+#else
+  aStats->chunks_dirty = 0;
+#endif
 
   non_arena_mapped = 0;
 
@@ -4263,6 +4736,20 @@ inline void MozJemalloc::jemalloc_stats_internal(
   }
   gArenas.mLock.Unlock();
 
+#ifdef MALLOC_THREAD_CACHE
+  {
+    MutexAutoLock lock(gThreadCachesLock);
+    aStats->thread_cache_hits = gExitedThreadCacheHits;
+    aStats->thread_cache_misses = gExitedThreadCacheMisses;
+    for (ThreadCache* cache = gThreadCaches; cache; cache = cache->mNext) {
+      aStats->thread_caches++;
+      aStats->thread_cache_bytes += cache->mBytes;
+      aStats->thread_cache_hits += cache->mHits;
+      aStats->thread_cache_misses += cache->mMisses;
+    }
+  }
+#endif
+
   // Account for arena chunk headers in bookkeeping rather than waste.
   chunk_header_size =
       ((aStats->mapped / aStats->chunksize) * (gChunkHeaderNumPages - 1))
@@ -4382,7 +4869,14 @@ inline void MozJemalloc::jemalloc_purge_freed_pages() {
 
 inline void MozJemalloc::jemalloc_free_dirty_pages(void) {
   if (malloc_initialized) {
+#ifdef MALLOC_THREAD_CACHE
+    // Other threads' caches can only be flushed by their own thread.
+    thread_cache_flush();
+#endif
     gArenas.MayPurgeAll(PurgeUnconditional, __func__);
+#ifdef MALLOC_HUGE_PAGES
+    chunks_purge_dirty();
+#endif
   }
 }
 
@@ -4661,6 +5155,9 @@ static pid_t gForkingProcess;
 FORK_HOOK
 void _malloc_prefork(void) MOZ_NO_THREAD_SAFETY_ANALYSIS {
   // Acquire all mutexes in a safe order.
+#  ifdef MALLOC_THREAD_CACHE
+  gThreadCachesLock.Lock();
+#  endif
   gArenas.mLock.Lock();
   gForkingThread = pthread_self();
 #  ifdef XP_DARWIN
@@ -4696,6 +5193,9 @@ void _malloc_postfork_parent(void) MOZ_NO_THREAD_SAFETY_ANALYSIS {
   }
 
   gArenas.mLock.Unlock();
+#  ifdef MALLOC_THREAD_CACHE
+  gThreadCachesLock.Unlock();
+#  endif
 }
 
 FORK_HOOK
@@ -4717,6 +5217,21 @@ void _malloc_postfork_child(void) {
   MOZ_POP_THREAD_SAFETY
 
   gArenas.mLock.Init();
+
+#  ifdef MALLOC_THREAD_CACHE
+  // Only the forking thread is left, the caches of the others are leaked.
+  gThreadCachesLock.Init();
+  MOZ_PUSH_IGNORE_THREAD_SAFETY
+  ThreadCache* cache = thread_cache.get();
+  if (uintptr_t(cache) > kThreadCacheDisabled) {
+    cache->mPrev = nullptr;
+    cache->mNext = nullptr;
+    gThreadCaches = cache;
+  } else {
+    gThreadCaches = nullptr;
+  }
+  MOZ_POP_THREAD_SAFETY
+#  endif
 }
 
 #  ifdef XP_DARWIN
@@ -134,6 +134,16 @@ typedef struct {
                           // operations.  Which internal operations (eg in place
                           // or move, or different size classes) require
                           // different internal operations is unspecified.
+
+  // Per-thread caches of small allocations, zero where they aren't supported.
+  size_t thread_caches;        // The number of threads with a cache.
+  size_t thread_cache_bytes;   // Bytes of 'allocated' held by the caches.
+  size_t thread_cache_hits;    // Allocations served by a cache.
+  size_t thread_cache_misses;  // Allocations that refilled a cache.
+
+  // Bytes of free chunks kept resident because releasing them would split
+  // the huge page they share with a chunk in use.  Not part of 'mapped'.
+  size_t chunks_dirty;
 } jemalloc_stats_t;
 
 typedef struct {
@@ -16,6 +16,8 @@
 
 #include "gtest/gtest.h"
 
+#include <thread>
+
 #ifdef MOZ_PHC
 #  include "PHC.h"
 #endif
@@ -866,3 +868,37 @@ TEST(Jemalloc, StatsLite)
 
   moz_dispose_arena(my_arena);
 }
+
+#ifndef XP_WIN
+TEST(Jemalloc, ThreadCache)
+{
+  jemalloc_stats_t before;
+  jemalloc_stats(&before);
+
+  // Thread caches are only used while small allocations aren't randomized.
+  bool randomize = before.opt_randomize_small;
+  jemalloc_reset_small_alloc_randomization(false);
+
+  // The cache is flushed and released when the thread exits, before join()
+  // returns, but its counters are kept.
+  std::thread thread([] {
+    AutoDisablePHCOnCurrentThread disable;
+    for (size_t i = 0; i < 1000; i++) {
+      void* ptr = malloc(64);
+      ASSERT_TRUE(ptr);
+      free(ptr);
+    }
+  });
+  thread.join();
+
+  jemalloc_stats_t after;
+  jemalloc_stats(&after);
+  jemalloc_reset_small_alloc_randomization(randomize);
+
+  // Only the first allocation of the thread misses, other threads may have
+  // used their caches meanwhile.
+  EXPECT_GE(after.thread_cache_hits - before.thread_cache_hits, 999u);
+  EXPECT_GE(after.thread_cache_misses - before.thread_cache_misses, 1u);
+  EXPECT_LE(after.thread_cache_bytes, after.allocated);
+}
+#endif
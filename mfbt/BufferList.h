@@ -328,6 +328,14 @@ class BufferList : private AllocPolicy {
   // bytes may be split across multiple buffers. Size() is increased by aSize.
   [[nodiscard]] inline bool WriteBytes(const char* aData, size_t aSize);
 
+  // Like WriteBytes, but the bytes that don't fit in the last buffer are
+  // copied into a single new buffer of their size (rounded up to
+  // kSegmentAlignment) instead of buffers of the standard capacity. This is
+  // for large writes, which this keeps contiguous for readers and saves
+  // allocations.
+  [[nodiscard]] inline bool WriteBytesContiguous(const char* aData,
+                                                 size_t aSize);
+
   // Allocates a buffer of at most |aMaxBytes| bytes and, if successful, returns
   // that buffer, and places its size in |aSize|. If unsuccessful, returns null
   // and leaves |aSize| undefined.
@@ -451,6 +459,40 @@ template <typename AllocPolicy>
   return true;
 }
 
+template <typename AllocPolicy>
+[[nodiscard]] bool BufferList<AllocPolicy>::WriteBytesContiguous(
+    const char* aData, size_t aSize) {
+  MOZ_RELEASE_ASSERT(mOwning);
+
+  // Fill the last buffer first, since every buffer but the last one has to
+  // be full.
+  size_t copied = 0;
+  if (!mSegments.empty()) {
+    Segment& lastSegment = mSegments.back();
+    copied = std::min(aSize, lastSegment.mCapacity - lastSegment.mSize);
+    memcpy(lastSegment.mData + lastSegment.mSize, aData, copied);
+    lastSegment.mSize += copied;
+    mSize += copied;
+  }
+
+  size_t remaining = aSize - copied;
+  if (!remaining) {
+    return true;
+  }
+
+  if (remaining > SIZE_MAX - (kSegmentAlignment - 1)) {
+    return false;
+  }
+  size_t capacity =
+      (remaining + kSegmentAlignment - 1) & ~(kSegmentAlignment - 1);
+  char* data = AllocateSegment(remaining, capacity);
+  if (!data) {
+    return false;
+  }
+  memcpy(data, aData + copied, remaining);
+  return true;
+}
+
 template <typename AllocPolicy>
 char* BufferList<AllocPolicy>::AllocateBytes(size_t aMaxSize, size_t* aSize) {
   MOZ_RELEASE_ASSERT(mOwning);
@@ -178,6 +178,45 @@ int main(void) {
       unsigned(*iter.Data()) ==
       (kTotalSize - kLastSegmentSize - kInitialSize - kSmallWrite) % 37);
 
+  // Contiguous writes fill the last segment, and put the rest in one segment.
+
+  {
+    const size_t kContiguousWrite = 100;
+    char toWriteContiguous[kContiguousWrite];
+    for (unsigned i = 0; i < kContiguousWrite; i++) {
+      toWriteContiguous[i] = i % 41;
+    }
+
+    BufferList blc(0, kInitialCapacity, kStandardCapacity);
+    MOZ_ALWAYS_TRUE(blc.WriteBytes(toWrite, kSmallWrite));
+    MOZ_ALWAYS_TRUE(blc.WriteBytesContiguous(toWriteContiguous,
+                                             kContiguousWrite));
+    MOZ_RELEASE_ASSERT(blc.Size() == kSmallWrite + kContiguousWrite);
+
+    iter = blc.Iter();
+    MOZ_RELEASE_ASSERT(iter.RemainingInSegment() == kInitialCapacity);
+    iter.Advance(blc, kInitialCapacity);
+    MOZ_RELEASE_ASSERT(iter.RemainingInSegment() ==
+                       kSmallWrite + kContiguousWrite - kInitialCapacity);
+
+    char toReadContiguous[kContiguousWrite];
+    iter = blc.Iter();
+    MOZ_RELEASE_ASSERT(iter.AdvanceAcrossSegments(blc, kSmallWrite));
+    MOZ_RELEASE_ASSERT(
+        blc.ReadBytes(iter, toReadContiguous, kContiguousWrite));
+    MOZ_RELEASE_ASSERT(
+        memcmp(toReadContiguous, toWriteContiguous, kContiguousWrite) == 0);
+    MOZ_RELEASE_ASSERT(iter.Done());
+
+    // The new segment's capacity is rounded up to the segment alignment, and
+    // later writes use it up first.
+    MOZ_ALWAYS_TRUE(blc.WriteBytes(toWrite, 4));
+    iter = blc.Iter();
+    MOZ_RELEASE_ASSERT(iter.AdvanceAcrossSegments(blc, kInitialCapacity));
+    MOZ_RELEASE_ASSERT(iter.RemainingInSegment() ==
+                       kSmallWrite + kContiguousWrite + 4 - kInitialCapacity);
+  }
+
   // Clear.
 
   bl.Clear();
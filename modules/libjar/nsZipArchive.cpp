@@ -427,8 +427,8 @@ nsresult nsZipArchive::Test(const nsACString& aEntryName) {
   }
 
   // test all items in archive
-  for (auto* item : mFiles) {
-    for (currItem = item; currItem; currItem = currItem->next) {
+  for (uint32_t i = 0; i < mFilesLength; ++i) {
+    for (currItem = mFiles[i]; currItem; currItem = currItem->next) {
       //-- don't test (synthetic) directory items
       if (currItem->IsDirectory()) continue;
       nsresult rv = ExtractFile(currItem, 0, 0);
@@ -457,7 +457,7 @@ nsZipItem* nsZipArchive::GetItem(const nsACString& aEntryName) {
       }
     }
     MMAP_FAULT_HANDLER_BEGIN_HANDLE(mFd)
-    nsZipItem* item = mFiles[HashName(aEntryName.BeginReading(), len)];
+    nsZipItem* item = mFiles[Slot(aEntryName.BeginReading(), len)];
     while (item) {
       if ((len == item->nameLength) &&
           (!memcmp(aEntryName.BeginReading(), item->Name(), len))) {
@@ -589,7 +589,7 @@ nsresult nsZipFind::FindNext(const char** aResult, uint16_t* aNameLen) {
   *aNameLen = 0;
   MMAP_FAULT_HANDLER_BEGIN_HANDLE(mArchive->GetFD())
   // we start from last match, look for next
-  while (mSlot < ZIP_TABSIZE) {
+  while (mSlot < mArchive->mFilesLength) {
     // move to next in current chain, or move to new slot
     mItem = mItem ? mItem->next : mArchive->mFiles[mSlot];
 
@@ -677,7 +677,11 @@ nsresult nsZipArchive::BuildFileList(PRFileDesc* aFd)
     return NS_ERROR_FILE_CORRUPTED;
   }
 
-  //-- Read the central directory headers
+  //-- Read the central directory headers, and size the file table for them
+  //-- once we know how many there are.
+  nsZipItem* firstItem = nullptr;
+  nsZipItem** lastItem = &firstItem;
+  uint32_t itemCount = 0;
   uint32_t sig = 0;
   while ((buf + int32_t(sizeof(uint32_t)) > buf) &&
          (buf + int32_t(sizeof(uint32_t)) <= endp) &&
@@ -715,14 +719,10 @@ nsresult nsZipArchive::BuildFileList(PRFileDesc* aFd)
     item->nameLength = namelen;
     item->isSynthetic = false;
 
-    // Add item to file table
-#ifdef DEBUG
-    nsDependentCSubstring name(item->Name(), namelen);
-    LOG(("   %s", PromiseFlatCString(name).get()));
-#endif
-    uint32_t hash = HashName(item->Name(), namelen);
-    item->next = mFiles[hash];
-    mFiles[hash] = item;
+    item->next = nullptr;
+    *lastItem = item;
+    lastItem = &item->next;
+    itemCount++;
 
     sig = 0;
   } /* while reading central directory records */
@@ -731,10 +731,38 @@ nsresult nsZipArchive::BuildFileList(PRFileDesc* aFd)
     return NS_ERROR_FILE_CORRUPTED;
   }
 
+  while (mFilesLength < itemCount) {
+    mFilesLength *= 2;
+  }
+  if (mFilesLength > ZIP_TABSIZE) {
+    mFiles = mozilla::MakeUnique<nsZipItem*[]>(mFilesLength);
+  }
+
+  // Add the items to the file table, in the order of the central directory
+  // so that later duplicates shadow earlier ones.
+  for (nsZipItem* item = firstItem; item;) {
+    nsZipItem* next = item->next;
+#ifdef DEBUG
+    nsDependentCSubstring name(item->Name(), item->nameLength);
+    LOG(("   %s", PromiseFlatCString(name).get()));
+#endif
+    uint32_t slot = Slot(item->Name(), item->nameLength);
+    item->next = mFiles[slot];
+    mFiles[slot] = item;
+    item = next;
+  }
+
   MMAP_FAULT_HANDLER_CATCH(NS_ERROR_FAILURE)
   return NS_OK;
 }
 
+//---------------------------------------------
+//  nsZipArchive::Slot
+//---------------------------------------------
+uint32_t nsZipArchive::Slot(const char* aName, uint16_t aLen) const {
+  return HashName(aName, aLen) & (mFilesLength - 1);
+}
+
 //---------------------------------------------
 //  nsZipArchive::BuildSynthetics
 //---------------------------------------------
@@ -747,8 +775,8 @@ nsresult nsZipArchive::BuildSynthetics() {
   MMAP_FAULT_HANDLER_BEGIN_HANDLE(mFd)
   // Create synthetic entries for any missing directories.
   // Do this when all ziptable has scanned to prevent double entries.
-  for (auto* item : mFiles) {
-    for (; item != nullptr; item = item->next) {
+  for (uint32_t i = 0; i < mFilesLength; ++i) {
+    for (nsZipItem* item = mFiles[i]; item != nullptr; item = item->next) {
       if (item->isSynthetic) continue;
 
       //-- add entries for directories in the current item's path
@@ -769,9 +797,9 @@ nsresult nsZipArchive::BuildSynthetics() {
         if (name[dirlen] == '/') continue;
 
         // Is the directory already in the file table?
-        uint32_t hash = HashName(item->Name(), dirlen);
+        uint32_t slot = Slot(item->Name(), dirlen);
         bool found = false;
-        for (nsZipItem* zi = mFiles[hash]; zi != nullptr; zi = zi->next) {
+        for (nsZipItem* zi = mFiles[slot]; zi != nullptr; zi = zi->next) {
           if ((dirlen == zi->nameLength) &&
               (0 == memcmp(item->Name(), zi->Name(), dirlen))) {
             // we've already added this dir and all its parents
@@ -793,8 +821,8 @@ nsresult nsZipArchive::BuildSynthetics() {
         diritem->isSynthetic = true;
 
         // add diritem to the file table
-        diritem->next = mFiles[hash];
-        mFiles[hash] = diritem;
+        diritem->next = mFiles[slot];
+        mFiles[slot] = diritem;
       } /* end processing of dirs in item's name */
     }
   }
@@ -886,9 +914,12 @@ int64_t nsZipArchive::SizeOfMapping() { return mFd ? mFd->SizeOfMapping() : 0; }
 
 nsZipArchive::nsZipArchive(nsZipHandle* aZipHandle, PRFileDesc* aFd,
                            nsresult& aRv)
-    : mRefCnt(0), mFd(aZipHandle), mUseZipLog(false), mBuiltSynthetics(false) {
-  // initialize the table to nullptr
-  memset(mFiles, 0, sizeof(mFiles));
+    : mRefCnt(0),
+      mFd(aZipHandle),
+      mUseZipLog(false),
+      mFilesLength(ZIP_TABSIZE),
+      mFiles(mozilla::MakeUnique<nsZipItem*[]>(ZIP_TABSIZE)),
+      mBuiltSynthetics(false) {
   MOZ_DIAGNOSTIC_ASSERT(aZipHandle);
 
   //-- get table of contents for archive
@@ -995,7 +1026,7 @@ static uint32_t HashName(const char* aName, uint16_t len) {
     val = val * 37 + *p++;
   }
 
-  return (val % ZIP_TABSIZE);
+  return val;
 }
 
 /*
@@ -8,7 +8,7 @@
 
 #include "mozilla/Attributes.h"
 
-#define ZIP_TABSIZE 256
+#define ZIP_TABSIZE 256 /* The minimum number of buckets of the item table */
 #define ZIP_BUFLEN \
   (4 * 1024) /* Used as output buffer when deflating items to a file */
 
@@ -198,10 +198,14 @@ class nsZipArchive final {
   // variable avoids grabbing zipLog's lock when not necessary.
   // Effectively const after constructor
   bool mUseZipLog;
+  // The number of buckets of mFiles, a power of two that is at least the
+  // number of entries, so that lookups rarely walk a chain.
+  // Effectively const after constructor
+  uint32_t mFilesLength;
 
   mozilla::Mutex mLock{"nsZipArchive"};
   // all of the following members are guarded by mLock:
-  nsZipItem* mFiles[ZIP_TABSIZE] MOZ_GUARDED_BY(mLock);
+  mozilla::UniquePtr<nsZipItem*[]> mFiles MOZ_GUARDED_BY(mLock);
   mozilla::ArenaAllocator<1024, sizeof(void*)> mArena MOZ_GUARDED_BY(mLock);
   // Whether we synthesized the directory entries
   bool mBuiltSynthetics MOZ_GUARDED_BY(mLock);
@@ -211,6 +215,8 @@ class nsZipArchive final {
   nsZipItem* CreateZipItem() MOZ_REQUIRES(mLock);
   nsresult BuildFileList(PRFileDesc* aFd = nullptr);
   nsresult BuildSynthetics();
+  // Returns the bucket of mFiles for the given entry name.
+  uint32_t Slot(const char* aName, uint16_t aLen) const;
 
   nsZipArchive& operator=(const nsZipArchive& rhs) = delete;
   nsZipArchive(const nsZipArchive& rhs) = delete;
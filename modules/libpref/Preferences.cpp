@@ -557,6 +557,21 @@ struct PrefsSizes {
 
 static StaticRefPtr<SharedPrefMap> gSharedMap;
 
+// Incremented whenever the dynamic preferences may have changed, so that the
+// serialized preferences shared with new child processes can be reused until
+// then.  Main thread only.
+static uint64_t gPrefsGeneration = 0;
+
+struct SerializedPrefs {
+  uint64_t mGeneration;
+  mozilla::ipc::ReadOnlySharedMemoryHandle mHandle;
+};
+
+// The last serialized preferences for web content processes, and for other
+// processes.
+static StaticAutoPtr<SerializedPrefs> gSerializedWebContentPrefs;
+static StaticAutoPtr<SerializedPrefs> gSerializedPrefs;
+
 // Arena for Pref names.
 // Never access sPrefNameArena directly, always use PrefNameArena()
 // because it must only be accessed on the Main Thread
@@ -1846,6 +1861,9 @@ static nsresult pref_SetPref(const nsCString& aPrefName, PrefType aType,
     return NS_ERROR_OUT_OF_MEMORY;
   }
 
+  // Even if no value changes, flags like stickiness may.
+  gPrefsGeneration++;
+
   Pref* pref = nullptr;
   if (gSharedMap) {
     auto result =
@@ -1933,6 +1951,10 @@ static CallbackNode* pref_RemoveCallbackNode(CallbackNode* aNode,
 
 static void NotifyCallbacks(const nsCString& aPrefName,
                             const PrefWrapper* aPref) {
+  if (NS_IsMainThread()) {
+    gPrefsGeneration++;
+  }
+
   bool reentered = gCallbacksInProgress;
 
   gCallbackPref = aPref;
@@ -3804,6 +3826,8 @@ Preferences::~Preferences() {
 #endif
 
   gSharedMap = nullptr;
+  gSerializedWebContentPrefs = nullptr;
+  gSerializedPrefs = nullptr;
 
   PrefNameArena().Clear();
 }
@@ -3829,6 +3853,48 @@ void Preferences::SerializePreferences(nsCString& aStr,
   aStr.Append('\0');
 }
 
+/* static */
+mozilla::ipc::ReadOnlySharedMemoryHandle
+Preferences::EnsureSerializedPreferences(bool aIsDestinationWebContentProcess) {
+  MOZ_ASSERT(XRE_IsParentProcess());
+  MOZ_ASSERT(NS_IsMainThread());
+
+  // Otherwise we'd serialize the prefs the snapshot is going to contain.
+  MOZ_ASSERT(gSharedMap, "EnsureSnapshot should be called first");
+
+  StaticAutoPtr<SerializedPrefs>& cached = aIsDestinationWebContentProcess
+                                               ? gSerializedWebContentPrefs
+                                               : gSerializedPrefs;
+  if (cached && cached->mGeneration == gPrefsGeneration) {
+    return cached->mHandle.Clone();
+  }
+
+  nsAutoCStringN<1024> prefs;
+  SerializePreferences(prefs, aIsDestinationWebContentProcess);
+  auto prefsLength = prefs.Length();
+
+  auto handle = ipc::shared_memory::Create(prefsLength);
+  if (!handle) {
+    NS_ERROR("failed to create shared memory in the parent");
+    return nullptr;
+  }
+  auto mapping = handle.Map();
+  if (!mapping) {
+    NS_ERROR("failed to map shared memory in the parent");
+    return nullptr;
+  }
+
+  memcpy(mapping.DataAs<char>(), prefs.get(), prefsLength);
+
+  if (!cached) {
+    cached = new SerializedPrefs();
+  }
+  cached->mGeneration = gPrefsGeneration;
+  cached->mHandle = std::move(handle).ToReadOnly();
+
+  return cached->mHandle.Clone();
+}
+
 /* static */
 void Preferences::DeserializePreferences(const char* aStr, size_t aPrefsLen) {
   MOZ_ASSERT(!XRE_IsParentProcess());
@@ -3876,6 +3942,7 @@ mozilla::ipc::ReadOnlySharedMemoryHandle Preferences::EnsureSnapshot() {
     StaticPrefs::RegisterOncePrefs(builder);
 
     gSharedMap = new SharedPrefMap(std::move(builder));
+    gPrefsGeneration++;
 
     // Once we've built a snapshot of the database, there's no need to continue
     // storing dynamic copies of the preferences it contains. Once we reset the
@@ -4008,6 +4075,7 @@ Preferences::ResetPrefs() {
 
   HashTable()->clearAndCompact();
   Unused << HashTable()->reserve(kHashTableInitialLengthParent);
+  gPrefsGeneration++;
 
   PrefNameArena().Clear();
 
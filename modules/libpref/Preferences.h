@@ -410,6 +410,12 @@ class Preferences final : public nsIPrefService,
                                    bool aIsDestinationWebContentProcess);
   static void DeserializePreferences(const char* aStr, size_t aPrefsLen);
 
+  // Returns shared memory holding the output of SerializePreferences.  The
+  // same memory is handed to every child process launched until a pref
+  // changes.
+  static mozilla::ipc::ReadOnlySharedMemoryHandle EnsureSerializedPreferences(
+      bool aIsDestinationWebContentProcess);
+
   static mozilla::ipc::ReadOnlySharedMemoryHandle EnsureSnapshot();
   static void InitSnapshot(const mozilla::ipc::ReadOnlySharedMemoryHandle&);
 
@@ -254,7 +254,11 @@ class MOZ_RAII AutoProfilerStats {
                                                                              \
     MACRO(27, "flows", Flows,                                                \
           "Include all flow-related markers. These markers show the program" \
-          "better but can cause more overhead in some places than normal.")
+          "better but can cause more overhead in some places than normal.") \
+                                                                             \
+    MACRO(28, "hwcounters", HardwareCounters,                                \
+          "Record the CPU cycles, instructions, cache misses and branch "    \
+          "misses of the main thread with each sample")
 
 // *** Synchronize with lists in ProfilerState.h and geckoProfiler.json ***
 
@@ -45,6 +45,20 @@ static PRInt32 NetworkDataCountWrite(PRFileDesc* fd, const void* buf,
   return NetworkDataCountSend(fd, buf, amount, 0, PR_INTERVAL_NO_WAIT);
 }
 
+static PRInt32 NetworkDataCountWritev(PRFileDesc* fd, const PRIOVec* iov,
+                                      PRInt32 size, PRIntervalTime timeout) {
+  MOZ_RELEASE_ASSERT(fd->identity == sNetworkDataCountLayerIdentity);
+
+  NetworkDataCountSecret* secret =
+      reinterpret_cast<NetworkDataCountSecret*>(fd->secret);
+
+  PRInt32 rv = (fd->lower->methods->writev)(fd->lower, iov, size, timeout);
+  if (rv > 0) {
+    secret->mSentBytes += rv;
+  }
+  return rv;
+}
+
 static PRInt32 NetworkDataCountRecv(PRFileDesc* fd, void* buf, PRInt32 amount,
                                     PRIntn flags, PRIntervalTime timeout) {
   MOZ_RELEASE_ASSERT(fd->identity == sNetworkDataCountLayerIdentity);
@@ -89,6 +103,7 @@ nsresult AttachNetworkDataCountLayer(PRFileDesc* fd) {
     sNetworkDataCountLayerMethods = *PR_GetDefaultIOMethods();
     sNetworkDataCountLayerMethods.send = NetworkDataCountSend;
     sNetworkDataCountLayerMethods.write = NetworkDataCountWrite;
+    sNetworkDataCountLayerMethods.writev = NetworkDataCountWritev;
     sNetworkDataCountLayerMethods.recv = NetworkDataCountRecv;
     sNetworkDataCountLayerMethods.read = NetworkDataCountRead;
     sNetworkDataCountLayerMethods.close = NetworkDataCountClose;
@@ -134,5 +149,10 @@ void NetworkDataCountReceived(PRFileDesc* fd, uint64_t& receivedBytes) {
   receivedBytes = secret->mReceivedBytes;
 }
 
+bool IsNetworkDataCountLayer(PRFileDesc* fd) {
+  return sNetworkDataCountLayerMethodsPtr &&
+         fd->identity == sNetworkDataCountLayerIdentity;
+}
+
 }  // namespace net
 }  // namespace mozilla
@@ -22,6 +22,10 @@ void NetworkDataCountSent(PRFileDesc* fd, uint64_t& sentBytes);
 // Get amount of received bytes.
 void NetworkDataCountReceived(PRFileDesc* fd, uint64_t& receivedBytes);
 
+// Whether fd is the layer AttachNetworkDataCountLayer() pushed.  Its writev
+// counts the sent bytes too.
+bool IsNetworkDataCountLayer(PRFileDesc* fd);
+
 }  // namespace net
 }  // namespace mozilla
 
@@ -6,8 +6,10 @@
 #include <algorithm>
 
 #include "Predictor.h"
+#include "PredictorOriginModel.h"
 
 #include "nsAppDirectoryServiceDefs.h"
+#include "nsDirectoryServiceUtils.h"
 #include "nsICacheStorage.h"
 #include "nsICachingChannel.h"
 #include "nsICancelable.h"
@@ -102,6 +104,20 @@ static nsresult ExtractOrigin(nsIURI* uri, nsIURI** originUri) {
   return NS_NewURI(originUri, s);
 }
 
+// The key of a top-level origin in the origin model, origin attributes
+// included so containers don't learn from each other.
+static nsresult OriginModelKey(nsIURI* uri,
+                               const OriginAttributes& originAttributes,
+                               nsACString& key) {
+  nsresult rv = nsContentUtils::GetWebExposedOriginSerialization(uri, key);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  nsAutoCString suffix;
+  originAttributes.CreateSuffix(suffix);
+  key.Append(suffix);
+  return NS_OK;
+}
+
 // All URIs we get passed *must* be http or https if they're not null. This
 // helps ensure that.
 static bool IsNullOrHttp(nsIURI* uri) {
@@ -382,6 +398,18 @@ nsresult Predictor::Init() {
   mDnsService = mozilla::components::DNS::Service(&rv);
   NS_ENSURE_SUCCESS(rv, rv);
 
+  if (StaticPrefs::network_predictor_origin_model_enabled()) {
+    nsCOMPtr<nsIFile> modelFile;
+    if (NS_SUCCEEDED(NS_GetSpecialDirectory(NS_APP_USER_PROFILE_50_DIR,
+                                            getter_AddRefs(modelFile))) &&
+        NS_SUCCEEDED(modelFile->AppendNative("predictor-origins.txt"_ns))) {
+      mOriginModel = PredictorOriginModel::Create(modelFile);
+      if (mOriginModel) {
+        mOriginModel->Load();
+      }
+    }
+  }
+
   mInitialized = true;
 
   return rv;
@@ -435,6 +463,11 @@ void Predictor::Shutdown() {
 
   RemoveObserver();
 
+  if (mOriginModel) {
+    mOriginModel->Save();
+    mOriginModel = nullptr;
+  }
+
   mInitialized = false;
 }
 
@@ -568,6 +601,12 @@ Predictor::PredictNative(nsIURI* targetURI, nsIURI* sourceURI,
       return NS_ERROR_INVALID_ARG;
   }
 
+  if (reason == nsINetworkPredictor::PREDICT_LOAD && mOriginModel) {
+    // Doesn't need the cache, so these connections start before the
+    // predictions below.
+    PredictForOriginModel(targetURI, originAttributes, verifier);
+  }
+
   Predictor::Reason argReason{};
   argReason.mPredict = reason;
 
@@ -1213,6 +1252,70 @@ bool Predictor::RunPredictions(nsIURI* referrer,
   return predicted;
 }
 
+void Predictor::PredictForOriginModel(nsIURI* targetURI,
+                                      const OriginAttributes& originAttributes,
+                                      nsINetworkPredictorVerifier* verifier) {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  PREDICTOR_LOG(("Predictor::PredictForOriginModel"));
+
+  nsAutoCString key;
+  if (NS_FAILED(OriginModelKey(targetURI, originAttributes, key))) {
+    return;
+  }
+
+  nsTArray<nsCString> origins;
+  mOriginModel->Predict(
+      key, StaticPrefs::network_predictor_origin_model_min_confidence(),
+      StaticPrefs::network_predictor_origin_model_max_preconnects(), origins);
+
+  for (const nsCString& origin : origins) {
+    nsCOMPtr<nsIURI> uri;
+    if (NS_FAILED(NS_NewURI(getter_AddRefs(uri), origin))) {
+      continue;
+    }
+    PREDICTOR_LOG(("    preconnecting to %s", origin.get()));
+    nsCOMPtr<nsIPrincipal> principal =
+        BasePrincipal::CreateContentPrincipal(uri, originAttributes);
+    mSpeculativeService->SpeculativeConnect(uri, principal, this, false);
+    if (verifier) {
+      verifier->OnPredictPreconnect(uri);
+    }
+  }
+}
+
+void Predictor::LearnForOriginModel(nsIURI* targetURI, nsIURI* sourceURI,
+                                    PredictorLearnReason reason,
+                                    const OriginAttributes& originAttributes) {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  nsAutoCString key;
+  switch (reason) {
+    case nsINetworkPredictor::LEARN_LOAD_TOPLEVEL:
+      if (NS_SUCCEEDED(OriginModelKey(targetURI, originAttributes, key))) {
+        mOriginModel->NoteNavigation(key);
+      }
+      break;
+    case nsINetworkPredictor::LEARN_LOAD_SUBRESOURCE: {
+      nsAutoCString origin, sourceOrigin;
+      if (NS_FAILED(nsContentUtils::GetWebExposedOriginSerialization(
+              targetURI, origin)) ||
+          NS_FAILED(nsContentUtils::GetWebExposedOriginSerialization(
+              sourceURI, sourceOrigin)) ||
+          origin.Equals(sourceOrigin)) {
+        // The navigation already connects to its own origin.
+        break;
+      }
+      if (NS_SUCCEEDED(OriginModelKey(sourceURI, originAttributes, key))) {
+        mOriginModel->NoteSubresource(key, origin);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
 // Find out if a top-level page is likely to redirect.
 bool Predictor::WouldRedirect(nsICacheEntry* entry, uint32_t loadCount,
                               uint32_t lastLoad, int32_t globalDegradation,
@@ -1327,6 +1430,10 @@ Predictor::LearnNative(nsIURI* targetURI, nsIURI* sourceURI,
       return NS_ERROR_INVALID_ARG;
   }
 
+  if (mOriginModel) {
+    LearnForOriginModel(targetURI, sourceURI, reason, originAttributes);
+  }
+
   uint32_t learnAttempts = 1;
   Predictor::Reason argReason{};
   argReason.mLearn = reason;
@@ -1747,6 +1854,10 @@ Predictor::Reset() {
     return NS_OK;
   }
 
+  if (mOriginModel) {
+    mOriginModel->Clear();
+  }
+
   RefPtr<Predictor::Resetter> reset = new Predictor::Resetter(this);
   PREDICTOR_LOG(("    created a resetter"));
   mCacheStorageService->AsyncVisitAllStorages(reset, true);
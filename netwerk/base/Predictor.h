@@ -36,6 +36,7 @@ namespace net {
 
 class nsHttpRequestHead;
 class nsHttpResponseHead;
+class PredictorOriginModel;
 
 class Predictor final : public nsINetworkPredictor,
                         public nsIObserver,
@@ -426,6 +427,14 @@ class Predictor final : public nsINetworkPredictor,
   // Gets the pref value and clamps it within the acceptable range.
   uint32_t ClampedPrefetchRollingLoadCount();
 
+  // Feed and query the learned per origin model, see PredictorOriginModel.
+  void LearnForOriginModel(nsIURI* targetURI, nsIURI* sourceURI,
+                           PredictorLearnReason reason,
+                           const OriginAttributes& originAttributes);
+  void PredictForOriginModel(nsIURI* targetURI,
+                             const OriginAttributes& originAttributes,
+                             nsINetworkPredictorVerifier* verifier);
+
   // Our state
   bool mInitialized{false};
 
@@ -445,6 +454,8 @@ class Predictor final : public nsINetworkPredictor,
 
   RefPtr<DNSListener> mDNSListener;
 
+  RefPtr<PredictorOriginModel> mOriginModel;
+
   nsTArray<nsCOMPtr<nsIURI>> mPrefetches;
   nsTArray<nsCOMPtr<nsIURI>> mPreconnects;
   nsTArray<nsCOMPtr<nsIURI>> mPreresolves;
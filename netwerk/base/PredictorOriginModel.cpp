@@ -0,0 +1,409 @@
+/* vim: set ts=2 sts=2 et sw=2: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <algorithm>
+
+#include "PredictorOriginModel.h"
+
+#include "nsIFile.h"
+#include "nsIInputStream.h"
+#include "nsIOutputStream.h"
+#include "nsISafeOutputStream.h"
+#include "nsNetUtil.h"
+#include "nsReadableUtils.h"
+#include "nsThreadUtils.h"
+#include "mozilla/Logging.h"
+#include "mozilla/glean/NetwerkProtocolHttpMetrics.h"
+
+namespace mozilla {
+namespace net {
+
+static LazyLogModule gPredictorModelLog("NetworkPredictor");
+
+#define MODEL_LOG(args) \
+  MOZ_LOG(gPredictorModelLog, mozilla::LogLevel::Debug, args)
+
+// Top-level origins we remember, the least recently loaded one goes first.
+static const uint32_t kModelMaxEntries = 500;
+// Subresource origins remembered per top-level origin.
+static const uint32_t kModelMaxSubresources = 16;
+// Once a top-level origin was loaded this often all counts are halved, so
+// what a site stopped loading from fades out.
+static const uint32_t kModelMaxLoads = 32;
+// Navigations between two writes of the file.
+static const uint32_t kModelSaveInterval = 10;
+// Anything slower than this isn't on the critical path of the page.
+static const uint32_t kModelMaxFirstUseMs = 60000;
+
+static const char kModelFileVersion[] = "v1";
+
+already_AddRefed<PredictorOriginModel> PredictorOriginModel::Create(
+    nsIFile* aFile) {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  RefPtr<PredictorOriginModel> model = new PredictorOriginModel(aFile);
+  nsresult rv = NS_CreateBackgroundTaskQueue(
+      "PredictorOriginModel", getter_AddRefs(model->mIOQueue));
+  if (NS_FAILED(rv)) {
+    return nullptr;
+  }
+  return model.forget();
+}
+
+void PredictorOriginModel::Load() {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  RefPtr<PredictorOriginModel> self = this;
+  uint32_t generation = mGeneration;
+  mIOQueue->Dispatch(NS_NewRunnableFunction(
+      "PredictorOriginModel::Load", [self, generation]() {
+        nsCOMPtr<nsIInputStream> stream;
+        nsresult rv = NS_NewLocalFileInputStream(getter_AddRefs(stream),
+                                                 self->mFile);
+        if (NS_FAILED(rv)) {
+          // Most likely there is no file yet.
+          return;
+        }
+
+        nsCString data;
+        rv = NS_ReadInputStreamToString(stream, data, -1);
+        stream->Close();
+        if (NS_FAILED(rv)) {
+          return;
+        }
+
+        NS_DispatchToMainThread(NS_NewRunnableFunction(
+            "PredictorOriginModel::Merge",
+            [self, generation, data = std::move(data)]() {
+              if (self->mGeneration == generation) {
+                self->Merge(data);
+              }
+            }));
+      }));
+}
+
+void PredictorOriginModel::Save() {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  if (!mDirty) {
+    return;
+  }
+  mDirty = false;
+  mNavigationsSinceSave = 0;
+
+  nsCString data;
+  Serialize(data);
+
+  nsCOMPtr<nsIFile> file = mFile;
+  mIOQueue->Dispatch(NS_NewRunnableFunction(
+      "PredictorOriginModel::Save", [file, data = std::move(data)]() {
+        nsCOMPtr<nsIOutputStream> stream;
+        nsresult rv =
+            NS_NewAtomicFileOutputStream(getter_AddRefs(stream), file);
+        if (NS_FAILED(rv)) {
+          return;
+        }
+
+        uint32_t written;
+        rv = stream->Write(data.get(), data.Length(), &written);
+        if (NS_FAILED(rv) || written != data.Length()) {
+          MODEL_LOG(("PredictorOriginModel: writing failed rv=%" PRIx32,
+                     static_cast<uint32_t>(rv)));
+          stream->Close();
+          return;
+        }
+
+        nsCOMPtr<nsISafeOutputStream> safeStream = do_QueryInterface(stream);
+        if (safeStream) {
+          safeStream->Finish();
+        }
+      }));
+}
+
+void PredictorOriginModel::Clear() {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  mEntries.Clear();
+  mDirty = false;
+  mNavigationsSinceSave = 0;
+  ++mGeneration;
+
+  nsCOMPtr<nsIFile> file = mFile;
+  mIOQueue->Dispatch(NS_NewRunnableFunction(
+      "PredictorOriginModel::Clear", [file]() { file->Remove(false); }));
+}
+
+void PredictorOriginModel::NoteNavigation(const nsACString& aKey) {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  UniquePtr<Entry>& entry = mEntries.LookupOrInsertWith(
+      aKey, [] { return MakeUnique<Entry>(); });
+
+  if (entry->mLoads >= kModelMaxLoads) {
+    entry->mLoads /= 2;
+    for (Subresource& sub : entry->mSubresources) {
+      sub.mHits = std::min((sub.mHits + 1) / 2, entry->mLoads);
+      sub.mLastLoad = 0;
+    }
+  }
+
+  ++entry->mLoads;
+  entry->mLastLoadTime = static_cast<uint32_t>(PR_Now() / PR_USEC_PER_SEC);
+  entry->mNavigationStart = TimeStamp::Now();
+
+  MODEL_LOG(("PredictorOriginModel::NoteNavigation %s loads=%u",
+             PromiseFlatCString(aKey).get(), entry->mLoads));
+
+  EvictIfNeeded();
+
+  mDirty = true;
+  if (++mNavigationsSinceSave >= kModelSaveInterval) {
+    Save();
+  }
+}
+
+void PredictorOriginModel::NoteSubresource(const nsACString& aKey,
+                                           const nsACString& aOrigin) {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  auto entryPtr = mEntries.Lookup(aKey);
+  if (!entryPtr) {
+    // We only learn for top-level origins we saw the navigation of.
+    return;
+  }
+  Entry& entry = **entryPtr;
+
+  uint32_t elapsed = 0;
+  if (!entry.mNavigationStart.IsNull()) {
+    elapsed = static_cast<uint32_t>(std::min<double>(
+        (TimeStamp::Now() - entry.mNavigationStart).ToMilliseconds(),
+        kModelMaxFirstUseMs));
+  }
+
+  Subresource* sub = nullptr;
+  for (Subresource& candidate : entry.mSubresources) {
+    if (candidate.mOrigin.Equals(aOrigin)) {
+      sub = &candidate;
+      break;
+    }
+  }
+
+  if (sub && sub->mLastLoad == entry.mLoads) {
+    // Already counted for this page load.
+    return;
+  }
+
+  if (entry.mPredicting) {
+    auto index = entry.mPredicted.IndexOf(aOrigin);
+    if (index != nsTArray<nsCString>::NoIndex) {
+      entry.mPredictedUsed[index] = true;
+    } else {
+      ++entry.mNotPredicted;
+    }
+  }
+
+  if (sub) {
+    ++sub->mHits;
+    sub->mLastLoad = entry.mLoads;
+    sub->mFirstUseMs = (sub->mFirstUseMs * 3 + elapsed) / 4;
+  } else {
+    Subresource added{nsCString(aOrigin), 1, elapsed, entry.mLoads};
+    if (entry.mSubresources.Length() < kModelMaxSubresources) {
+      entry.mSubresources.AppendElement(std::move(added));
+    } else {
+      // Replace the least used origin, unless it was used on this page load
+      // as well.
+      auto victim = std::min_element(
+          entry.mSubresources.begin(), entry.mSubresources.end(),
+          [](const Subresource& aA, const Subresource& aB) {
+            return aA.mHits < aB.mHits;
+          });
+      if (victim->mLastLoad == entry.mLoads) {
+        return;
+      }
+      *victim = std::move(added);
+    }
+  }
+
+  mDirty = true;
+}
+
+void PredictorOriginModel::Predict(const nsACString& aKey,
+                                   uint32_t aMinConfidence, uint32_t aMax,
+                                   nsTArray<nsCString>& aOrigins) {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  auto entryPtr = mEntries.Lookup(aKey);
+  if (!entryPtr) {
+    return;
+  }
+  Entry& entry = **entryPtr;
+
+  ReportAccuracy(entry);
+  if (!entry.mLoads) {
+    return;
+  }
+
+  nsTArray<const Subresource*> candidates;
+  for (const Subresource& sub : entry.mSubresources) {
+    uint32_t confidence = sub.mHits * 100 / entry.mLoads;
+    if (confidence >= aMinConfidence) {
+      candidates.AppendElement(&sub);
+    }
+  }
+
+  // The origins the page needs first are on its critical path, connect to
+  // those first.
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const Subresource* aA, const Subresource* aB) {
+                     return aA->mFirstUseMs < aB->mFirstUseMs;
+                   });
+  if (candidates.Length() > aMax) {
+    candidates.TruncateLength(aMax);
+  }
+
+  for (const Subresource* sub : candidates) {
+    MODEL_LOG(("PredictorOriginModel::Predict %s -> %s hits=%u/%u first=%ums",
+               PromiseFlatCString(aKey).get(), sub->mOrigin.get(), sub->mHits,
+               entry.mLoads, sub->mFirstUseMs));
+    aOrigins.AppendElement(sub->mOrigin);
+  }
+
+  entry.mPredicted = aOrigins.Clone();
+  entry.mPredictedUsed.SetLength(aOrigins.Length());
+  for (bool& used : entry.mPredictedUsed) {
+    used = false;
+  }
+  entry.mNotPredicted = 0;
+  entry.mPredicting = true;
+}
+
+void PredictorOriginModel::ReportAccuracy(Entry& aEntry) {
+  if (!aEntry.mPredicting) {
+    return;
+  }
+
+  uint32_t used = 0;
+  for (bool wasUsed : aEntry.mPredictedUsed) {
+    if (wasUsed) {
+      ++used;
+    }
+  }
+  uint32_t unused = aEntry.mPredictedUsed.Length() - used;
+
+  if (used) {
+    glean::networking::predictor_origin_model.Get("used"_ns).Add(used);
+  }
+  if (unused) {
+    glean::networking::predictor_origin_model.Get("unused"_ns).Add(unused);
+  }
+  if (aEntry.mNotPredicted) {
+    glean::networking::predictor_origin_model.Get("not_predicted"_ns)
+        .Add(aEntry.mNotPredicted);
+  }
+
+  aEntry.mPredicted.Clear();
+  aEntry.mPredictedUsed.Clear();
+  aEntry.mNotPredicted = 0;
+  aEntry.mPredicting = false;
+}
+
+void PredictorOriginModel::EvictIfNeeded() {
+  while (mEntries.Count() > kModelMaxEntries) {
+    nsAutoCString oldest;
+    uint32_t oldestTime = UINT32_MAX;
+    for (auto iter = mEntries.Iter(); !iter.Done(); iter.Next()) {
+      if (iter.Data()->mLastLoadTime < oldestTime) {
+        oldestTime = iter.Data()->mLastLoadTime;
+        oldest = iter.Key();
+      }
+    }
+    mEntries.Remove(oldest);
+  }
+}
+
+// The file is a version line followed by one line per top-level origin:
+//   key \t loads \t lastLoadTime [\t origin hits firstUseMs]*
+void PredictorOriginModel::Serialize(nsACString& aData) {
+  aData.Assign(kModelFileVersion);
+  aData.Append('\n');
+
+  for (const auto& entry : mEntries) {
+    const Entry& data = *entry.GetData();
+    if (!data.mLoads) {
+      continue;
+    }
+
+    aData.Append(entry.GetKey());
+    aData.AppendPrintf("\t%u\t%u", data.mLoads, data.mLastLoadTime);
+    for (const Subresource& sub : data.mSubresources) {
+      aData.Append('\t');
+      aData.Append(sub.mOrigin);
+      aData.AppendPrintf(" %u %u", sub.mHits, sub.mFirstUseMs);
+    }
+    aData.Append('\n');
+  }
+}
+
+void PredictorOriginModel::Merge(const nsACString& aData) {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  nsTArray<nsCString> lines;
+  ParseString(aData, '\n', lines);
+  if (lines.IsEmpty() || !lines[0].EqualsASCII(kModelFileVersion)) {
+    MODEL_LOG(("PredictorOriginModel: ignoring file of unknown version"));
+    return;
+  }
+
+  uint32_t merged = 0;
+  for (uint32_t i = 1; i < lines.Length(); ++i) {
+    nsTArray<nsCString> fields;
+    ParseString(lines[i], '\t', fields);
+    if (fields.Length() < 3) {
+      continue;
+    }
+
+    // What was learned since startup wins over the file.
+    if (mEntries.Contains(fields[0])) {
+      continue;
+    }
+
+    nsresult rv1, rv2;
+    auto entry = MakeUnique<Entry>();
+    entry->mLoads = static_cast<uint32_t>(fields[1].ToInteger(&rv1));
+    entry->mLastLoadTime = static_cast<uint32_t>(fields[2].ToInteger(&rv2));
+    if (NS_FAILED(rv1) || NS_FAILED(rv2) || !entry->mLoads ||
+        entry->mLoads > kModelMaxLoads) {
+      continue;
+    }
+
+    for (uint32_t f = 3; f < fields.Length() &&
+                         entry->mSubresources.Length() < kModelMaxSubresources;
+         ++f) {
+      nsTArray<nsCString> parts;
+      ParseString(fields[f], ' ', parts);
+      if (parts.Length() != 3) {
+        continue;
+      }
+      uint32_t hits = static_cast<uint32_t>(parts[1].ToInteger(&rv1));
+      uint32_t firstUse = static_cast<uint32_t>(parts[2].ToInteger(&rv2));
+      if (NS_FAILED(rv1) || NS_FAILED(rv2) || !hits) {
+        continue;
+      }
+      entry->mSubresources.AppendElement(
+          Subresource{parts[0], std::min(hits, entry->mLoads),
+                      std::min(firstUse, kModelMaxFirstUseMs), 0});
+    }
+
+    mEntries.InsertOrUpdate(fields[0], std::move(entry));
+    ++merged;
+  }
+
+  MODEL_LOG(("PredictorOriginModel: loaded %u top-level origins", merged));
+  EvictIfNeeded();
+}
+
+}  // namespace net
+}  // namespace mozilla
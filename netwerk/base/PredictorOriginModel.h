@@ -0,0 +1,105 @@
+/* vim: set ts=2 sts=2 et sw=2: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_net_PredictorOriginModel_h
+#define mozilla_net_PredictorOriginModel_h
+
+#include "mozilla/TimeStamp.h"
+#include "mozilla/UniquePtr.h"
+#include "nsCOMPtr.h"
+#include "nsISupportsImpl.h"
+#include "nsString.h"
+#include "nsTArray.h"
+#include "nsTHashMap.h"
+
+class nsIFile;
+class nsISerialEventTarget;
+
+namespace mozilla {
+namespace net {
+
+// A compact per top-level origin model of the origins its pages load
+// subresources from, kept in a small file in the profile instead of the
+// predictor metadata of cache entries, so it doesn't go away with the cache.
+// Predictor uses it to preconnect to the origins a page is likely to need as
+// soon as the navigation starts, the ones needed earliest first.
+//
+// The top-level key includes the origin attributes suffix so containers
+// don't share what they learned.  Only private browsing windows are never
+// learned from, see Predictor::LearnNative.
+//
+// Main thread only, apart from the file IO done on background tasks.
+class PredictorOriginModel final {
+ public:
+  NS_INLINE_DECL_THREADSAFE_REFCOUNTING(PredictorOriginModel)
+
+  // Returns null when no IO queue could be created.
+  static already_AddRefed<PredictorOriginModel> Create(nsIFile* aFile);
+
+  // Reads the file in the background, learning can start right away.
+  void Load();
+  // Writes the model in the background if it changed.
+  void Save();
+  // Forgets everything and removes the file.
+  void Clear();
+
+  // A navigation to aKey started.  Closes the accuracy bookkeeping of the
+  // previous navigation to it.
+  void NoteNavigation(const nsACString& aKey);
+  // A page of aKey loaded a subresource from aOrigin.
+  void NoteSubresource(const nsACString& aKey, const nsACString& aOrigin);
+  // The origins to preconnect to for a navigation to aKey, at most aMax of
+  // them, ordered by how early the page needed them.
+  void Predict(const nsACString& aKey, uint32_t aMinConfidence, uint32_t aMax,
+               nsTArray<nsCString>& aOrigins);
+
+ private:
+  explicit PredictorOriginModel(nsIFile* aFile) : mFile(aFile) {}
+  ~PredictorOriginModel() = default;
+
+  struct Subresource {
+    nsCString mOrigin;
+    // Page loads of the top-level origin that used this origin.
+    uint32_t mHits;
+    // Smoothed time from the start of the navigation to the first load
+    // from this origin.
+    uint32_t mFirstUseMs;
+    // mLoads of the top-level entry at the last hit, counts an origin only
+    // once per page load.  Not persisted.
+    uint32_t mLastLoad;
+  };
+
+  struct Entry {
+    uint32_t mLoads{0};
+    uint32_t mLastLoadTime{0};
+    nsTArray<Subresource> mSubresources;
+
+    // Bookkeeping of the current navigation, not persisted.
+    TimeStamp mNavigationStart;
+    nsTArray<nsCString> mPredicted;
+    nsTArray<bool> mPredictedUsed;
+    uint32_t mNotPredicted{0};
+    bool mPredicting{false};
+  };
+
+  void ReportAccuracy(Entry& aEntry);
+  void EvictIfNeeded();
+  void Merge(const nsACString& aData);
+  void Serialize(nsACString& aData);
+
+  nsCOMPtr<nsIFile> mFile;
+  // Serializes the reads, writes and removals of mFile.
+  nsCOMPtr<nsISerialEventTarget> mIOQueue;
+  nsTHashMap<nsCStringHashKey, UniquePtr<Entry>> mEntries;
+  bool mDirty{false};
+  uint32_t mNavigationsSinceSave{0};
+  // Bumped by Clear() so a load still in flight is dropped.
+  uint32_t mGeneration{0};
+};
+
+}  // namespace net
+}  // namespace mozilla
+
+#endif  // mozilla_net_PredictorOriginModel_h
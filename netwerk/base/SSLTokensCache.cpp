@@ -6,11 +6,20 @@
 
 #include "CertVerifier.h"
 #include "CommonSocketControl.h"
+#include "ScopedNSSTypes.h"
 #include "TransportSecurityInfo.h"
 #include "mozilla/ArrayAlgorithm.h"
 #include "mozilla/Logging.h"
 #include "mozilla/Preferences.h"
+#include "nsAppDirectoryServiceDefs.h"
+#include "nsDirectoryServiceUtils.h"
+#include "nsIFile.h"
 #include "nsIOService.h"
+#include "nsISocketProvider.h"
+#include "nsThreadUtils.h"
+#include "pk11pub.h"
+#include "pk11sdr.h"
+#include "prio.h"
 #include "ssl.h"
 #include "sslexp.h"
 
@@ -24,6 +33,143 @@ static LazyLogModule gSSLTokensCacheLog("SSLTokensCache");
 #define LOG5_ENABLED() \
   MOZ_LOG_TEST(mozilla::net::gSSLTokensCacheLog, mozilla::LogLevel::Verbose)
 
+// The file of the profile directory that the persisted records are written
+// to.  Resumption tokens are meant to be used once, so it is removed as soon
+// as it is read.
+constexpr auto kPersistenceFileName = u"ssl_tokens_cache.bin"_ns;
+
+// Bump this whenever the serialized form of the records changes.  The files
+// of other versions are ignored.
+constexpr uint32_t kPersistenceVersion = 1;
+
+// Larger files can't have been written by us.
+constexpr int64_t kMaxPersistenceFileSize = 64 * 1024 * 1024;
+
+namespace {
+
+// The records are only read back on the machine that wrote them, so integers
+// are written in native byte order.
+class RecordWriter final {
+ public:
+  explicit RecordWriter(nsTArray<uint8_t>& aData) : mData(aData) {}
+
+  void WriteUint32(uint32_t aValue) {
+    mData.AppendElements(reinterpret_cast<const uint8_t*>(&aValue),
+                         sizeof(aValue));
+  }
+
+  void WriteBytes(const uint8_t* aBytes, uint32_t aLength) {
+    WriteUint32(aLength);
+    mData.AppendElements(aBytes, aLength);
+  }
+
+  void WriteBytes(const nsTArray<uint8_t>& aBytes) {
+    WriteBytes(aBytes.Elements(), aBytes.Length());
+  }
+
+  void WriteCertChain(const Maybe<nsTArray<nsTArray<uint8_t>>>& aChain) {
+    WriteUint32(aChain.isSome());
+    if (aChain) {
+      WriteUint32(aChain->Length());
+      for (const auto& cert : *aChain) {
+        WriteBytes(cert);
+      }
+    }
+  }
+
+ private:
+  nsTArray<uint8_t>& mData;
+};
+
+class RecordReader final {
+ public:
+  explicit RecordReader(const nsTArray<uint8_t>& aData) : mData(aData) {}
+
+  bool IsDone() const { return mOffset == mData.Length(); }
+
+  [[nodiscard]] bool ReadUint32(uint32_t* aValue) {
+    if (mData.Length() - mOffset < sizeof(*aValue)) {
+      return false;
+    }
+    memcpy(aValue, mData.Elements() + mOffset, sizeof(*aValue));
+    mOffset += sizeof(*aValue);
+    return true;
+  }
+
+  [[nodiscard]] bool ReadBytes(nsTArray<uint8_t>& aBytes) {
+    uint32_t length;
+    if (!ReadUint32(&length) || mData.Length() - mOffset < length) {
+      return false;
+    }
+    aBytes.Clear();
+    aBytes.AppendElements(mData.Elements() + mOffset, length);
+    mOffset += length;
+    return true;
+  }
+
+  [[nodiscard]] bool ReadCertChain(
+      Maybe<nsTArray<nsTArray<uint8_t>>>& aChain) {
+    uint32_t present;
+    if (!ReadUint32(&present)) {
+      return false;
+    }
+    aChain.reset();
+    if (!present) {
+      return true;
+    }
+    uint32_t count;
+    if (!ReadUint32(&count)) {
+      return false;
+    }
+    aChain.emplace();
+    for (uint32_t i = 0; i < count; i++) {
+      nsTArray<uint8_t> cert;
+      if (!ReadBytes(cert)) {
+        return false;
+      }
+      aChain->AppendElement(std::move(cert));
+    }
+    return true;
+  }
+
+ private:
+  const nsTArray<uint8_t>& mData;
+  size_t mOffset = 0;
+};
+
+}  // namespace
+
+// The tokens let their holder resume a session with the server, so they are
+// only written to disk encrypted with the key of the profile's key database.
+// If a primary password protects the key and hasn't been entered, nothing is
+// persisted or loaded rather than prompting for it.
+static bool CanUseSDRKey() {
+  UniquePK11SlotInfo slot(PK11_GetInternalKeySlot());
+  return slot && !PK11_NeedUserInit(slot.get()) &&
+         (!PK11_NeedLogin(slot.get()) || PK11_IsLoggedIn(slot.get(), nullptr));
+}
+
+static nsresult SDRCrypt(bool aEncrypt, const nsTArray<uint8_t>& aInput,
+                         nsTArray<uint8_t>& aOutput) {
+  SECItem request = {siBuffer, const_cast<uint8_t*>(aInput.Elements()),
+                     static_cast<unsigned int>(aInput.Length())};
+  ScopedAutoSECItem reply;
+  SECStatus srv;
+  if (aEncrypt) {
+    // Use the default key.
+    SECItem keyid = {siBuffer, nullptr, 0};
+    srv = PK11SDR_Encrypt(&keyid, &request, &reply, nullptr);
+  } else {
+    srv = PK11SDR_Decrypt(&request, &reply, nullptr);
+  }
+  if (srv != SECSuccess) {
+    return NS_ERROR_FAILURE;
+  }
+  aOutput.Clear();
+  aOutput.AppendElements(reply.data, reply.len);
+  return NS_OK;
+}
+
 class ExpirationComparator {
  public:
   bool Equals(SSLTokensCache::TokenCacheRecord* a,
@@ -309,6 +455,10 @@ nsresult SSLTokensCache::Put(const nsACString& aKey, const uint8_t* aToken,
     }
   }
 
+  bool persistable = !(aSocketControl->GetProviderFlags() &
+                       nsISocketProvider::NO_PERMANENT_STORAGE) &&
+                     !aSocketControl->GetOriginAttributes().IsPrivateBrowsing();
+
   auto makeUniqueRecord = [&]() {
     auto rec = MakeUnique<TokenCacheRecord>();
     rec->mKey = aKey;
@@ -329,34 +479,40 @@ nsresult SSLTokensCache::Put(const nsACString& aKey, const uint8_t* aToken,
     rec->mSessionCacheInfo.mOverridableErrorCategory = overridableErrorCategory;
     rec->mSessionCacheInfo.mFailedCertChainBytes =
         std::move(failedCertChainBytes);
+    rec->mPersistable = persistable;
     return rec;
   };
 
+  gInstance->InsertRecordLocked(makeUniqueRecord());
+
+  gInstance->LogStats();
+
+  gInstance->EvictIfNecessary();
+
+  return NS_OK;
+}
+
+void SSLTokensCache::InsertRecordLocked(UniquePtr<TokenCacheRecord>&& aRecord) {
+  sLock.AssertCurrentThreadOwns();
+
+  const nsCString key = aRecord->mKey;
   TokenCacheEntry* const cacheEntry =
-      gInstance->mTokenCacheRecords.WithEntryHandle(aKey, [&](auto&& entry) {
+      mTokenCacheRecords.WithEntryHandle(key, [&](auto&& entry) {
         if (!entry) {
-          auto rec = makeUniqueRecord();
           auto cacheEntry = MakeUnique<TokenCacheEntry>();
-          cacheEntry->AddRecord(std::move(rec), gInstance->mExpirationArray);
+          cacheEntry->AddRecord(std::move(aRecord), mExpirationArray);
           entry.Insert(std::move(cacheEntry));
         } else {
           // To make sure the cache size is synced, we take away the size of
           // whole entry and add it back later.
-          gInstance->mCacheSize -= entry.Data()->Size();
-          entry.Data()->AddRecord(makeUniqueRecord(),
-                                  gInstance->mExpirationArray);
+          mCacheSize -= entry.Data()->Size();
+          entry.Data()->AddRecord(std::move(aRecord), mExpirationArray);
         }
 
         return entry->get();
       });
 
-  gInstance->mCacheSize += cacheEntry->Size();
-
-  gInstance->LogStats();
-
-  gInstance->EvictIfNecessary();
-
-  return NS_OK;
+  mCacheSize += cacheEntry->Size();
 }
 
 // static
@@ -564,5 +720,212 @@ void SSLTokensCache::Clear() {
   gInstance->mCacheSize = 0;
 }
 
+// static
+already_AddRefed<nsIFile> SSLTokensCache::GetPersistenceFile() {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  nsCOMPtr<nsIFile> file;
+  if (NS_FAILED(NS_GetSpecialDirectory(NS_APP_USER_PROFILE_50_DIR,
+                                       getter_AddRefs(file))) ||
+      NS_FAILED(file->Append(kPersistenceFileName))) {
+    return nullptr;
+  }
+  return file.forget();
+}
+
+// static
+void SSLTokensCache::Persist() {
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(XRE_IsParentProcess());
+
+  if (!StaticPrefs::network_ssl_tokens_cache_persist()) {
+    return;
+  }
+
+  nsTArray<uint8_t> data;
+  {
+    StaticMutexAutoLock lock(sLock);
+    if (!gInstance || gInstance->mPersisted) {
+      return;
+    }
+    gInstance->mPersisted = true;
+    if (!gInstance->SerializeLocked(data)) {
+      return;
+    }
+  }
+
+  LOG(("SSLTokensCache::Persist [size=%zu]", data.Length()));
+
+  nsCOMPtr<nsIFile> file = GetPersistenceFile();
+  nsTArray<uint8_t> encrypted;
+  if (!file || !CanUseSDRKey() || NS_FAILED(SDRCrypt(true, data, encrypted))) {
+    LOG(("  cannot encrypt the tokens"));
+    return;
+  }
+
+  PRFileDesc* fd;
+  nsresult rv = file->OpenNSPRFileDesc(
+      PR_WRONLY | PR_CREATE_FILE | PR_TRUNCATE, 0600, &fd);
+  if (NS_FAILED(rv)) {
+    return;
+  }
+  int32_t written = PR_Write(fd, encrypted.Elements(), encrypted.Length());
+  PR_Close(fd);
+  if (written != int32_t(encrypted.Length())) {
+    LOG(("  cannot write the tokens"));
+    file->Remove(false);
+  }
+}
+
+// static
+void SSLTokensCache::LoadPersisted() {
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(XRE_IsParentProcess());
+
+  nsCOMPtr<nsIFile> file = GetPersistenceFile();
+  if (!file) {
+    return;
+  }
+
+  // Even when the pref is unset, so that stale tokens are removed.
+  NS_DispatchBackgroundTask(
+      NS_NewRunnableFunction("SSLTokensCache::LoadPersisted",
+                             [file] { LoadPersistedFrom(file); }),
+      NS_DISPATCH_EVENT_MAY_BLOCK);
+}
+
+// static
+void SSLTokensCache::LoadPersistedFrom(nsIFile* aFile) {
+  bool exists = false;
+  if (NS_FAILED(aFile->Exists(&exists)) || !exists) {
+    return;
+  }
+
+  nsTArray<uint8_t> encrypted;
+  int64_t size = 0;
+  PRFileDesc* fd;
+  if (NS_SUCCEEDED(aFile->GetFileSize(&size)) && size > 0 &&
+      size <= kMaxPersistenceFileSize &&
+      NS_SUCCEEDED(aFile->OpenNSPRFileDesc(PR_RDONLY, 0, &fd))) {
+    encrypted.SetLength(size);
+    int32_t read = PR_Read(fd, encrypted.Elements(), encrypted.Length());
+    PR_Close(fd);
+    if (read != int32_t(encrypted.Length())) {
+      encrypted.Clear();
+    }
+  }
+  aFile->Remove(false);
+
+  nsTArray<uint8_t> data;
+  if (encrypted.IsEmpty() || !StaticPrefs::network_ssl_tokens_cache_persist() ||
+      !CanUseSDRKey() || NS_FAILED(SDRCrypt(false, encrypted, data))) {
+    return;
+  }
+
+  StaticMutexAutoLock lock(sLock);
+  if (!gInstance) {
+    return;
+  }
+  gInstance->DeserializeLocked(data);
+}
+
+uint32_t SSLTokensCache::SerializeLocked(nsTArray<uint8_t>& aData) const {
+  sLock.AssertCurrentThreadOwns();
+
+  RecordWriter writer(aData);
+  writer.WriteUint32(kPersistenceVersion);
+
+  uint32_t count = 0;
+  for (const TokenCacheRecord* rec : mExpirationArray) {
+    if (!rec->mPersistable) {
+      continue;
+    }
+    const SessionCacheInfo& info = rec->mSessionCacheInfo;
+    writer.WriteBytes(reinterpret_cast<const uint8_t*>(rec->mKey.get()),
+                      rec->mKey.Length());
+    writer.WriteBytes(rec->mToken);
+    writer.WriteUint32(uint32_t(info.mEVStatus));
+    writer.WriteUint32(info.mCertificateTransparencyStatus);
+    writer.WriteBytes(info.mServerCertBytes);
+    writer.WriteCertChain(info.mSucceededCertChainBytes);
+    writer.WriteUint32(info.mIsBuiltCertChainRootBuiltInRoot
+                           ? 1 + *info.mIsBuiltCertChainRootBuiltInRoot
+                           : 0);
+    writer.WriteUint32(uint32_t(info.mOverridableErrorCategory));
+    writer.WriteCertChain(info.mFailedCertChainBytes);
+    count++;
+  }
+  return count;
+}
+
+void SSLTokensCache::DeserializeLocked(const nsTArray<uint8_t>& aData) {
+  sLock.AssertCurrentThreadOwns();
+
+  RecordReader reader(aData);
+  uint32_t version;
+  if (!reader.ReadUint32(&version) || version != kPersistenceVersion) {
+    LOG(("SSLTokensCache::DeserializeLocked - unknown version"));
+    return;
+  }
+
+  PRTime now = PR_Now();
+  uint32_t count = 0;
+  while (!reader.IsDone()) {
+    auto rec = MakeUnique<TokenCacheRecord>();
+    SessionCacheInfo& info = rec->mSessionCacheInfo;
+    nsTArray<uint8_t> key;
+    uint32_t evStatus, ctStatus, builtInRoot, errorCategory;
+    if (!reader.ReadBytes(key) || !reader.ReadBytes(rec->mToken) ||
+        !reader.ReadUint32(&evStatus) || !reader.ReadUint32(&ctStatus) ||
+        !reader.ReadBytes(info.mServerCertBytes) ||
+        !reader.ReadCertChain(info.mSucceededCertChainBytes) ||
+        !reader.ReadUint32(&builtInRoot) ||
+        !reader.ReadUint32(&errorCategory) ||
+        !reader.ReadCertChain(info.mFailedCertChainBytes) ||
+        errorCategory >
+            uint32_t(nsITransportSecurityInfo::OverridableErrorCategory::
+                         ERROR_TIME)) {
+      LOG(("SSLTokensCache::DeserializeLocked - corrupt record"));
+      break;
+    }
+
+    // Like Put(), take the expiration time from the token itself.  This also
+    // drops the tokens of HTTP/3 connections, whose expiration time we only
+    // keep truncated, since NSS doesn't parse them.
+    SSLResumptionTokenInfo tokenInfo;
+    if (SSL_GetResumptionTokenInfo(rec->mToken.Elements(),
+                                   rec->mToken.Length(), &tokenInfo,
+                                   sizeof(tokenInfo)) != SECSuccess) {
+      continue;
+    }
+    PRTime expirationTime = tokenInfo.expirationTime;
+    SSL_DestroyResumptionTokenInfo(&tokenInfo);
+    if (expirationTime <= now) {
+      continue;
+    }
+
+    rec->mKey.Assign(reinterpret_cast<const char*>(key.Elements()),
+                     key.Length());
+    rec->mExpirationTime = PRUint32(expirationTime);
+    info.mEVStatus = evStatus ? psm::EVStatus::EV : psm::EVStatus::NotEV;
+    info.mCertificateTransparencyStatus = uint16_t(ctStatus);
+    if (builtInRoot) {
+      info.mIsBuiltCertChainRootBuiltInRoot.emplace(builtInRoot == 2);
+    }
+    info.mOverridableErrorCategory =
+        nsITransportSecurityInfo::OverridableErrorCategory(errorCategory);
+    rec->mId = ++sRecordId;
+    rec->mPersistable = true;
+    InsertRecordLocked(std::move(rec));
+    count++;
+  }
+
+  LOG(("SSLTokensCache::DeserializeLocked [count=%u]", count));
+
+  LogStats();
+
+  EvictIfNecessary();
+}
+
 }  // namespace net
 }  // namespace mozilla
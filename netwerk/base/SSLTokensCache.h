@@ -18,6 +18,7 @@
 #include "nsXULAppAPI.h"
 
 class CommonSocketControl;
+class nsIFile;
 
 namespace mozilla {
 namespace net {
@@ -56,6 +57,13 @@ class SSLTokensCache : public nsIMemoryReporter {
   static nsresult RemoveAll(const nsACString& aKey);
   static void Clear();
 
+  // When network.ssl_tokens_cache.persist is set, Persist() writes the
+  // records that may outlive the session to the profile, and LoadPersisted()
+  // reads them back after a restart.  Both must be called on the main thread
+  // of the parent process, while NSS is initialized.
+  static void Persist();
+  static void LoadPersisted();
+
  private:
   SSLTokensCache();
   virtual ~SSLTokensCache();
@@ -65,6 +73,15 @@ class SSLTokensCache : public nsIMemoryReporter {
   nsresult GetLocked(const nsACString& aKey, nsTArray<uint8_t>& aToken,
                      SessionCacheInfo& aResult, uint64_t* aTokenId);
 
+  class TokenCacheRecord;
+  void InsertRecordLocked(UniquePtr<TokenCacheRecord>&& aRecord);
+
+  static already_AddRefed<nsIFile> GetPersistenceFile();
+  static void LoadPersistedFrom(nsIFile* aFile);
+  // Returns the number of records written to aData.
+  uint32_t SerializeLocked(nsTArray<uint8_t>& aData) const;
+  void DeserializeLocked(const nsTArray<uint8_t>& aData);
+
   void EvictIfNecessary();
   void LogStats();
 
@@ -75,6 +92,7 @@ class SSLTokensCache : public nsIMemoryReporter {
   static uint64_t sRecordId;
 
   uint32_t mCacheSize{0};  // Actual cache size in bytes
+  bool mPersisted = false;
 
   class TokenCacheRecord {
    public:
@@ -90,6 +108,9 @@ class SSLTokensCache : public nsIMemoryReporter {
     // An unique id to identify the record. Mostly used when we want to remove a
     // record from TokenCacheEntry.
     uint64_t mId = 0;
+    // False for the records of private browsing connections, which must not
+    // be written to disk.
+    bool mPersistable = false;
   };
 
   class TokenCacheEntry {
@@ -0,0 +1,411 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "nsSocketTransportService2.h"
+#include "SocketPollBackend.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <unistd.h>
+
+#include "prerror.h"
+#include "private/pprio.h"
+
+namespace mozilla {
+namespace net {
+
+// Which PR_Poll() flag a readable/writable system event stands for, the
+// same bookkeeping NSPR does for layers that need the opposite direction
+// (e.g. TLS wanting to read during a handshake the caller waits to write).
+static const uint8_t kReadSysRead = 1 << 0;
+static const uint8_t kReadSysWrite = 1 << 1;
+static const uint8_t kWriteSysRead = 1 << 2;
+static const uint8_t kWriteSysWrite = 1 << 3;
+
+// How many iterations in a row may only see events for files we don't know
+// about before we give up on the backend.
+static const uint32_t kMaxStrayIterations = 16;
+
+static const uint32_t kMinEvents = 16;
+static const uint32_t kMaxEvents = 1024;
+
+// static
+const char* SocketPollBackend::Name() {
+#if defined(XP_DARWIN)
+  return "kqueue";
+#else
+  return "epoll";
+#endif
+}
+
+// static
+UniquePtr<SocketPollBackend> SocketPollBackend::Create() {
+  UniquePtr<SocketPollBackend> backend(new SocketPollBackend());
+  if (!backend->Setup()) {
+    return nullptr;
+  }
+
+  return backend;
+}
+
+bool SocketPollBackend::Setup() {
+#if defined(XP_DARWIN)
+  mPollFD = kqueue();
+#else
+  mPollFD = epoll_create1(EPOLL_CLOEXEC);
+#endif
+  if (mPollFD < 0) {
+    SOCKET_LOG(("SocketPollBackend::Setup() - %s unavailable [errno=%d]",
+                Name(), errno));
+    return false;
+  }
+
+  SOCKET_LOG(("SocketPollBackend::Setup() - using %s [this=%p]", Name(),
+              this));
+  return true;
+}
+
+SocketPollBackend::~SocketPollBackend() {
+  if (mPollFD >= 0) {
+    close(mPollFD);
+  }
+}
+
+#if defined(XP_DARWIN)
+
+static bool ApplyChange(int aPollFD, int aFD, int16_t aFilter,
+                        uint16_t aFlags, uint32_t aIndex) {
+  struct kevent change;
+  EV_SET(&change, aFD, aFilter, aFlags, 0, 0,
+         reinterpret_cast<void*>(static_cast<uintptr_t>(aIndex)));
+  int rv;
+  do {
+    rv = kevent(aPollFD, &change, 1, nullptr, 0, nullptr);
+  } while (rv < 0 && errno == EINTR);
+  return rv >= 0 || ((aFlags & EV_DELETE) && errno == ENOENT);
+}
+
+bool SocketPollBackend::Register(int aFD, uint32_t aIndex, uint8_t aInterest,
+                                 Registration* aOld) {
+  // kqueue has no separate exceptional condition filter for sockets,
+  // kExcept is only asked for together with kRead and rides on it.
+  static const struct {
+    uint8_t mInterest;
+    int16_t mFilter;
+  } kFilters[] = {{kRead, EVFILT_READ}, {kWrite, EVFILT_WRITE}};
+
+  for (const auto& filter : kFilters) {
+    bool wanted = aInterest & filter.mInterest;
+    bool had = aOld && (aOld->mInterest & filter.mInterest);
+    if (wanted && (!had || aOld->mIndex != aIndex)) {
+      // EV_ADD on an existing registration just updates udata.
+      if (!ApplyChange(mPollFD, aFD, filter.mFilter, EV_ADD, aIndex)) {
+        return false;
+      }
+    } else if (!wanted && had) {
+      ApplyChange(mPollFD, aFD, filter.mFilter, EV_DELETE, aIndex);
+    }
+  }
+  return true;
+}
+
+void SocketPollBackend::Unregister(int aFD, uint8_t aInterest) {
+  if (aInterest & kRead) {
+    ApplyChange(mPollFD, aFD, EVFILT_READ, EV_DELETE, 0);
+  }
+  if (aInterest & kWrite) {
+    ApplyChange(mPollFD, aFD, EVFILT_WRITE, EV_DELETE, 0);
+  }
+}
+
+int32_t SocketPollBackend::Wait(PRIntervalTime aTimeout) {
+  struct timespec timeout;
+  struct timespec* timeoutPtr = nullptr;
+  if (aTimeout != PR_INTERVAL_NO_TIMEOUT) {
+    uint32_t ms = PR_IntervalToMilliseconds(aTimeout);
+    timeout.tv_sec = ms / 1000;
+    timeout.tv_nsec = (ms % 1000) * 1000000;
+    timeoutPtr = &timeout;
+  }
+  return kevent(mPollFD, nullptr, 0, mEvents.Elements(), mEvents.Length(),
+                timeoutPtr);
+}
+
+#else
+
+bool SocketPollBackend::Register(int aFD, uint32_t aIndex, uint8_t aInterest,
+                                 Registration* aOld) {
+  struct epoll_event event;
+  event.events = ((aInterest & kRead) ? EPOLLIN : 0) |
+                 ((aInterest & kWrite) ? EPOLLOUT : 0) |
+                 ((aInterest & kExcept) ? EPOLLPRI : 0);
+  event.data.u64 = (static_cast<uint64_t>(aFD) << 32) | aIndex;
+
+  int op = aOld ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+  if (epoll_ctl(mPollFD, op, aFD, &event) == 0) {
+    return true;
+  }
+
+  // The file behind the descriptor number changed since we last saw it: a
+  // closed socket loses its registration, a reused number may still have
+  // one when we were not told about the close.
+  if (op == EPOLL_CTL_MOD && errno == ENOENT) {
+    op = EPOLL_CTL_ADD;
+  } else if (op == EPOLL_CTL_ADD && errno == EEXIST) {
+    op = EPOLL_CTL_MOD;
+  } else {
+    return false;
+  }
+  return epoll_ctl(mPollFD, op, aFD, &event) == 0;
+}
+
+void SocketPollBackend::Unregister(int aFD, uint8_t aInterest) {
+  // Fails harmlessly when the socket was closed already.  Older kernels want
+  // a non-null event even though it is ignored.
+  struct epoll_event event = {};
+  epoll_ctl(mPollFD, EPOLL_CTL_DEL, aFD, &event);
+}
+
+int32_t SocketPollBackend::Wait(PRIntervalTime aTimeout) {
+  int timeout = aTimeout == PR_INTERVAL_NO_TIMEOUT
+                    ? -1
+                    : static_cast<int>(PR_IntervalToMilliseconds(aTimeout));
+  return epoll_wait(mPollFD, mEvents.Elements(), mEvents.Length(), timeout);
+}
+
+#endif
+
+int32_t SocketPollBackend::Poll(PRPollDesc* aDescs, uint32_t aCount,
+                                PRIntervalTime aTimeout) {
+  MOZ_ASSERT(!mFailed);
+
+  ++mIteration;
+  mLastChanges = 0;
+  mNativeFDs.SetLength(aCount);
+  mSysFlags.SetLength(aCount);
+
+  int32_t ready = 0;
+  for (uint32_t i = 0; i < aCount; ++i) {
+    PRPollDesc& desc = aDescs[i];
+    desc.out_flags = 0;
+    mNativeFDs[i] = -1;
+    mSysFlags[i] = 0;
+    if (!desc.fd) {
+      continue;
+    }
+
+    int16_t inRead = 0;
+    int16_t inWrite = 0;
+    int16_t outRead = 0;
+    int16_t outWrite = 0;
+    if (desc.in_flags & PR_POLL_READ) {
+      inRead = desc.fd->methods->poll(
+          desc.fd, static_cast<int16_t>(desc.in_flags & ~PR_POLL_WRITE),
+          &outRead);
+    }
+    if (desc.in_flags & PR_POLL_WRITE) {
+      inWrite = desc.fd->methods->poll(
+          desc.fd, static_cast<int16_t>(desc.in_flags & ~PR_POLL_READ),
+          &outWrite);
+    }
+
+    int native = PR_FileDesc2NativeHandle(desc.fd);
+    if (native < 0) {
+      desc.out_flags = PR_POLL_NVAL;
+      ++ready;
+      continue;
+    }
+    mNativeFDs[i] = native;
+
+    auto registration = mRegistrations.Lookup(native);
+    if ((inRead & outRead) || (inWrite & outWrite)) {
+      // A layer has something for us right now, report only that like
+      // PR_Poll() does, but keep the registration for the next iteration.
+      desc.out_flags = static_cast<int16_t>(outRead | outWrite);
+      ++ready;
+      if (registration) {
+        registration->mIteration = mIteration;
+      }
+      continue;
+    }
+
+    uint8_t sys = 0;
+    uint8_t interest = 0;
+    if (inRead & PR_POLL_READ) {
+      sys |= kReadSysRead;
+      interest |= kRead;
+    }
+    if (inRead & PR_POLL_WRITE) {
+      sys |= kReadSysWrite;
+      interest |= kWrite;
+    }
+    if (inWrite & PR_POLL_READ) {
+      sys |= kWriteSysRead;
+      interest |= kRead;
+    }
+    if (inWrite & PR_POLL_WRITE) {
+      sys |= kWriteSysWrite;
+      interest |= kWrite;
+    }
+    if (desc.in_flags & PR_POLL_EXCEPT) {
+      interest |= kExcept;
+    }
+    if (!interest) {
+      continue;
+    }
+    mSysFlags[i] = sys;
+
+    if (registration && registration->mFD == desc.fd &&
+        registration->mIndex == i && registration->mInterest == interest) {
+      registration->mIteration = mIteration;
+      continue;
+    }
+
+    if (!Register(native, i, interest,
+                  registration ? &registration.Data() : nullptr)) {
+      SOCKET_LOG(("SocketPollBackend::Poll() - registering fd %d failed "
+                  "[this=%p, errno=%d]",
+                  native, this, errno));
+      PR_SetError(PR_UNKNOWN_ERROR, errno);
+      mFailed = true;
+      return -1;
+    }
+    mRegistrations.InsertOrUpdate(
+        native, Registration{desc.fd, i, mIteration, interest});
+    ++mLastChanges;
+  }
+
+  // Sockets that were detached or moved to the idle list.
+  for (auto iter = mRegistrations.Iter(); !iter.Done(); iter.Next()) {
+    if (iter.Data().mIteration != mIteration) {
+      Unregister(static_cast<int>(iter.Key()), iter.Data().mInterest);
+      iter.Remove();
+      ++mLastChanges;
+    }
+  }
+
+  uint32_t wanted = std::clamp(aCount, kMinEvents, kMaxEvents);
+  if (mEvents.Length() < wanted) {
+    mEvents.SetLength(wanted);
+  }
+
+  // Don't block when a layer already reported something, but still pick up
+  // what the kernel has ready.
+  int32_t n = Wait(ready ? PR_INTERVAL_NO_WAIT : aTimeout);
+  if (n < 0) {
+    if (errno == EINTR) {
+      return ready;
+    }
+    SOCKET_LOG(("SocketPollBackend::Poll() - wait failed [this=%p, errno=%d]",
+                this, errno));
+    PR_SetError(PR_UNKNOWN_ERROR, errno);
+    mFailed = true;
+    return -1;
+  }
+
+  uint32_t strays = 0;
+  for (int32_t e = 0; e < n; ++e) {
+#if defined(XP_DARWIN)
+    const struct kevent& event = mEvents[e];
+    int fd = static_cast<int>(event.ident);
+    uint32_t index =
+        static_cast<uint32_t>(reinterpret_cast<uintptr_t>(event.udata));
+    bool in = event.filter == EVFILT_READ;
+    bool out = event.filter == EVFILT_WRITE;
+    bool pri = false;
+    bool err = event.flags & EV_ERROR;
+    bool hup = event.flags & EV_EOF;
+#else
+    const struct epoll_event& event = mEvents[e];
+    int fd = static_cast<int>(event.data.u64 >> 32);
+    uint32_t index = static_cast<uint32_t>(event.data.u64);
+    bool in = event.events & EPOLLIN;
+    bool out = event.events & EPOLLOUT;
+    bool pri = event.events & EPOLLPRI;
+    bool err = event.events & EPOLLERR;
+    bool hup = event.events & EPOLLHUP;
+#endif
+
+    if (index >= aCount || mNativeFDs[index] != fd) {
+      // Only possible for a file that outlived its socket because the
+      // descriptor was duplicated, try to get rid of it.
+      if (!mRegistrations.Contains(fd)) {
+        Unregister(fd, kRead | kWrite | kExcept);
+      }
+      ++strays;
+      continue;
+    }
+
+    uint8_t sys = mSysFlags[index];
+    if (!sys && !(aDescs[index].in_flags & PR_POLL_EXCEPT)) {
+      // Reported by a layer already.
+      continue;
+    }
+
+    int16_t flags = 0;
+    if (in) {
+      if (sys & kReadSysRead) {
+        flags |= PR_POLL_READ;
+      }
+      if (sys & kWriteSysRead) {
+        flags |= PR_POLL_WRITE;
+      }
+    }
+    if (out) {
+      if (sys & kReadSysWrite) {
+        flags |= PR_POLL_READ;
+      }
+      if (sys & kWriteSysWrite) {
+        flags |= PR_POLL_WRITE;
+      }
+    }
+    if (pri) {
+      flags |= PR_POLL_EXCEPT;
+    }
+    if (err) {
+      flags |= PR_POLL_ERR;
+    }
+    if (hup) {
+      flags |= PR_POLL_HUP;
+    }
+
+    PRPollDesc& desc = aDescs[index];
+    if (flags && !desc.out_flags) {
+      ++ready;
+    }
+    desc.out_flags |= flags;
+  }
+
+  if (strays && !ready) {
+    if (++mStrayIterations > kMaxStrayIterations) {
+      SOCKET_LOG(("SocketPollBackend::Poll() - giving up after too many "
+                  "events for unknown files [this=%p]",
+                  this));
+      mFailed = true;
+    }
+  } else {
+    mStrayIterations = 0;
+  }
+
+  return ready;
+}
+
+void SocketPollBackend::Forget(PRFileDesc* aFD) {
+  if (!aFD) {
+    return;
+  }
+
+  int native = PR_FileDesc2NativeHandle(aFD);
+  if (native < 0) {
+    return;
+  }
+
+  if (auto registration = mRegistrations.Lookup(native)) {
+    Unregister(native, registration->mInterest);
+    registration.Remove();
+  }
+}
+
+}  // namespace net
+}  // namespace mozilla
@@ -0,0 +1,114 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SocketPollBackend_h__
+#define SocketPollBackend_h__
+
+#include "mozilla/UniquePtr.h"
+#include "nsTArray.h"
+#include "nsTHashMap.h"
+#include "prio.h"
+
+#if defined(XP_DARWIN)
+#  include <sys/event.h>
+#elif defined(XP_LINUX)
+#  include <sys/epoll.h>
+#endif
+
+namespace mozilla {
+namespace net {
+
+// A drop-in replacement for PR_Poll() on the socket thread that keeps the
+// sockets registered with epoll (Linux, Android) or kqueue (Darwin) across
+// poll iterations.  PR_Poll() hands the whole descriptor array to the kernel
+// on every call, here only the sockets whose interest changed since the
+// previous iteration cost a system call and the wait itself only reports the
+// ready ones.
+//
+// The registrations are level-triggered.  Our socket handlers don't read or
+// write until EAGAIN, so edge-triggered notifications would get lost for
+// sockets that are only partially drained.
+//
+// Only built when MOZ_SOCKET_POLL_BACKEND is defined.  Only ever used on the
+// socket thread, there is no locking.  Include this from .cpp files only, it
+// pulls in the system headers.
+class SocketPollBackend final {
+ public:
+  // Returns null when the kernel facility isn't available, e.g. blocked by
+  // a sandbox policy.
+  static UniquePtr<SocketPollBackend> Create();
+
+  ~SocketPollBackend();
+
+  // Same contract as PR_Poll(): fills out_flags of every entry of aDescs and
+  // returns the number of entries with non-zero out_flags, or -1 on failure.
+  // Layered descriptors (e.g. TLS) are asked through their poll method first
+  // exactly the way PR_Poll() does it, so data already buffered by a layer is
+  // reported without waiting.
+  int32_t Poll(PRPollDesc* aDescs, uint32_t aCount, PRIntervalTime aTimeout);
+
+  // Drops the registration of aFD.  Must be called before a socket that may
+  // still be registered is closed, otherwise the kernel can keep reporting a
+  // file that a dup()ed descriptor keeps open.
+  void Forget(PRFileDesc* aFD);
+
+  // True after an unrecoverable error, the caller should go back to
+  // PR_Poll() for good.
+  bool Failed() const { return mFailed; }
+
+  // Number of registration changes issued by the last Poll() call.
+  uint32_t LastChanges() const { return mLastChanges; }
+
+  static const char* Name();
+
+ private:
+  SocketPollBackend() = default;
+
+  bool Setup();
+
+  enum Interest : uint8_t {
+    kRead = 1 << 0,
+    kWrite = 1 << 1,
+    kExcept = 1 << 2,
+  };
+
+  struct Registration {
+    // A different PRFileDesc behind the same number means the old socket got
+    // closed without Forget() and the kernel dropped its registration.
+    PRFileDesc* mFD;
+    uint32_t mIndex;
+    uint32_t mIteration;
+    uint8_t mInterest;
+  };
+
+  bool Register(int aFD, uint32_t aIndex, uint8_t aInterest,
+                Registration* aOld);
+  void Unregister(int aFD, uint8_t aInterest);
+  int32_t Wait(PRIntervalTime aTimeout);
+
+  int mPollFD{-1};
+  bool mFailed{false};
+  uint32_t mIteration{0};
+  uint32_t mLastChanges{0};
+  // Consecutive iterations that only returned events for unknown files.
+  uint32_t mStrayIterations{0};
+
+  // Keyed by the native descriptor.
+  nsTHashMap<nsUint32HashKey, Registration> mRegistrations;
+
+  // Per Poll() call scratch, indexed like aDescs.
+  nsTArray<int> mNativeFDs;
+  nsTArray<uint8_t> mSysFlags;
+
+#if defined(XP_DARWIN)
+  nsTArray<struct kevent> mEvents;
+#elif defined(XP_LINUX)
+  nsTArray<struct epoll_event> mEvents;
+#endif
+};
+
+}  // namespace net
+}  // namespace mozilla
+
+#endif
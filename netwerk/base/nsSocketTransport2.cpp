@@ -529,7 +529,7 @@ void nsSocketOutputStream::OnSocketReady(nsresult condition) {
 }
 
 NS_IMPL_QUERY_INTERFACE(nsSocketOutputStream, nsIOutputStream,
-                        nsIAsyncOutputStream)
+                        nsIAsyncOutputStream, nsIGatherOutputStream)
 
 NS_IMETHODIMP_(MozExternalRefCountType)
 nsSocketOutputStream::AddRef() {
@@ -584,12 +584,25 @@ nsSocketOutputStream::Write(const char* buf, uint32_t count,
 
   SOCKET_LOG(("  PR_Write returned [n=%d]\n", n));
 
+  Span<const char> segment(buf, count);
+  return OnWritten(fd, Span(&segment, 1), n, countWritten);
+}
+
+nsresult nsSocketOutputStream::OnWritten(
+    PRFileDesc* fd, Span<const Span<const char>> aSegments, int32_t n,
+    uint32_t* countWritten) {
   nsresult rv = NS_OK;
   {
     MutexAutoLock lock(mTransport->mLock);
 
 #ifdef ENABLE_SOCKET_TRACING
-    if (n > 0) mTransport->TraceOutBuf(buf, n);
+    int32_t traced = 0;
+    for (const auto& segment : aSegments) {
+      if (traced >= n) break;
+      int32_t length = std::min<int32_t>(segment.Length(), n - traced);
+      mTransport->TraceOutBuf(segment.Elements(), length);
+      traced += length;
+    }
 #endif
 
     mTransport->ReleaseFD_Locked(fd);
@@ -615,6 +628,114 @@ nsSocketOutputStream::Write(const char* buf, uint32_t count,
   return rv;
 }
 
+// Whether PR_Writev() can be used on fd.  Most layers only have their own
+// write and send methods, the default writev of a layer passes the data to
+// the layer below without going through them, and the TLS layer has none.
+static bool CanWritev(PRFileDesc* fd) {
+  const PRIOMethods* defaults = PR_GetDefaultIOMethods();
+  for (PRFileDesc* layer = fd; layer; layer = layer->lower) {
+    if (layer->identity == PR_NSPR_IO_LAYER) {
+      return true;
+    }
+    if (IsNetworkDataCountLayer(layer)) {
+      continue;
+    }
+    if (layer->methods->write != defaults->write ||
+        layer->methods->send != defaults->send ||
+        layer->methods->writev != defaults->writev) {
+      return false;
+    }
+  }
+  return false;
+}
+
+NS_IMETHODIMP
+nsSocketOutputStream::WriteGathered(Span<const Span<const char>> aSegments,
+                                    uint32_t* countWritten) {
+  SOCKET_LOG(("nsSocketOutputStream::WriteGathered [this=%p segments=%zu]\n",
+              this, aSegments.Length()));
+
+  *countWritten = 0;
+
+  if (aSegments.IsEmpty()) {
+    return NS_OK;
+  }
+  if (aSegments.Length() == 1) {
+    return Write(aSegments[0].Elements(), aSegments[0].Length(), countWritten);
+  }
+
+  PRFileDesc* fd = nullptr;
+  {
+    MutexAutoLock lock(mTransport->mLock);
+
+    if (NS_FAILED(mCondition)) return mCondition;
+
+    fd = mTransport->GetFD_Locked();
+    if (!fd) return NS_BASE_STREAM_WOULD_BLOCK;
+
+    if (!mWritev) {
+      mWritev = Some(CanWritev(fd));
+    }
+    if (!*mWritev) {
+      mTransport->ReleaseFD_Locked(fd);
+      fd = nullptr;
+    }
+  }
+
+  if (!fd) {
+    return WriteCoalesced(aSegments, countWritten);
+  }
+
+  aSegments = aSegments.First(
+      std::min<size_t>(aSegments.Length(), PR_MAX_IOVECTOR_SIZE));
+  PRIOVec iov[PR_MAX_IOVECTOR_SIZE];
+  for (size_t i = 0; i < aSegments.Length(); ++i) {
+    iov[i].iov_base = const_cast<char*>(aSegments[i].Elements());
+    iov[i].iov_len = aSegments[i].Length();
+  }
+
+  SOCKET_LOG(("  calling PR_Writev [count=%zu]\n", aSegments.Length()));
+
+  // the kernel takes the data straight from the buffers of the segments, they
+  // are only released by the caller once we return.
+  int32_t n = PR_Writev(fd, iov, static_cast<int32_t>(aSegments.Length()),
+                        PR_INTERVAL_NO_WAIT);
+
+  SOCKET_LOG(("  PR_Writev returned [n=%d]\n", n));
+
+  return OnWritten(fd, aSegments, n, countWritten);
+}
+
+nsresult nsSocketOutputStream::WriteCoalesced(
+    Span<const Span<const char>> aSegments, uint32_t* countWritten) {
+  // Without writev the segments would go out one write, and with TLS one
+  // record, each.  Small ones are copied together first so that the request
+  // headers and the start of the body still go out at once, as they did when
+  // nsHttpTransaction buffered the request stream itself (bug 137155).
+  static constexpr uint32_t kCoalesceSize = 16384;
+
+  const Span<const char>& first = aSegments[0];
+  if (first.Length() >= kCoalesceSize) {
+    return Write(first.Elements(), first.Length(), countWritten);
+  }
+
+  if (!mCoalesceBuffer) {
+    mCoalesceBuffer = MakeUnique<char[]>(kCoalesceSize);
+  }
+
+  uint32_t length = 0;
+  for (const auto& segment : aSegments) {
+    uint32_t n = std::min<uint32_t>(segment.Length(), kCoalesceSize - length);
+    memcpy(mCoalesceBuffer.get() + length, segment.Elements(), n);
+    length += n;
+    if (length == kCoalesceSize) {
+      break;
+    }
+  }
+
+  return Write(mCoalesceBuffer.get(), length, countWritten);
+}
+
 NS_IMETHODIMP
 nsSocketOutputStream::WriteSegments(nsReadSegmentFun reader, void* closure,
                                     uint32_t count, uint32_t* countRead) {
@@ -11,7 +11,9 @@
 
 #include <functional>
 
+#include "mozilla/Maybe.h"
 #include "mozilla/Mutex.h"
+#include "mozilla/UniquePtr.h"
 #include "nsSocketTransportService2.h"
 #include "nsString.h"
 #include "nsCOMPtr.h"
@@ -20,6 +22,7 @@
 #include "nsISocketTransport.h"
 #include "nsIAsyncInputStream.h"
 #include "nsIAsyncOutputStream.h"
+#include "nsIGatherOutputStream.h"
 #include "nsIDNSListener.h"
 #include "nsIDNSRecord.h"
 #include "nsIClassInfo.h"
@@ -460,15 +463,21 @@ class nsSocketInputStream : public nsIAsyncInputStream {
   nsCOMPtr<nsIInputStreamCallback> mCallback MOZ_GUARDED_BY(mTransport->mLock);
   uint32_t mCallbackFlags MOZ_GUARDED_BY(mTransport->mLock){0};
   uint64_t mByteCount MOZ_GUARDED_BY(mTransport->mLock){0};
+  // Whether PR_Writev() can be used, checked on the first WriteGathered().
+  Maybe<bool> mWritev MOZ_GUARDED_BY(mTransport->mLock);
+  // For WriteCoalesced(), only allocated once it's needed.
+  UniquePtr<char[]> mCoalesceBuffer;
 };
 
 //-----------------------------------------------------------------------------
 
-class nsSocketOutputStream : public nsIAsyncOutputStream {
+class nsSocketOutputStream : public nsIAsyncOutputStream,
+                             public nsIGatherOutputStream {
  public:
   NS_DECL_ISUPPORTS_INHERITED
   NS_DECL_NSIOUTPUTSTREAM
   NS_DECL_NSIASYNCOUTPUTSTREAM
+  NS_DECL_NSIGATHEROUTPUTSTREAM
 
   explicit nsSocketOutputStream(nsSocketTransport*);
   virtual ~nsSocketOutputStream() = default;
@@ -495,6 +504,14 @@ class nsSocketOutputStream : public nsIAsyncOutputStream {
                                     uint32_t offset, uint32_t count,
                                     uint32_t* countRead);
 
+  // Called with the result of the PR_Write() or PR_Writev() of aSegments
+  // to fd.  Releases fd.
+  nsresult OnWritten(PRFileDesc* fd, Span<const Span<const char>> aSegments,
+                     int32_t n, uint32_t* countWritten);
+  // WriteGathered() for the sockets PR_Writev() can't be used on.
+  nsresult WriteCoalesced(Span<const Span<const char>> aSegments,
+                          uint32_t* countWritten);
+
   nsSocketTransport* mTransport;
   ThreadSafeAutoRefCnt mWriterRefCnt{0};
 
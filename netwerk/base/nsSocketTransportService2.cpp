@@ -33,6 +33,8 @@
 #include "prerror.h"
 #include "prnetdb.h"
 
+#include "SocketPollBackend.h"
+
 namespace mozilla {
 namespace net {
 
@@ -437,6 +439,13 @@ nsresult nsSocketTransportService::DetachSocket(SocketContextList& listHead,
   MOZ_ASSERT((&listHead == &mActiveList) || (&listHead == &mIdleList),
              "DetachSocket invalid head");
 
+#ifdef MOZ_SOCKET_POLL_BACKEND
+  if (mPollBackend) {
+    // The handler likely closes the socket.
+    mPollBackend->Forget(sock->mFD);
+  }
+#endif
+
   {
     // inform the handler that this socket is going away
     sock->mHandler->OnSocketDetached(sock->mFD);
@@ -668,24 +677,44 @@ int32_t nsSocketTransportService::Poll(TimeDuration* pollDuration,
     }
 #endif
 
-    n = PR_Poll(firstPollEntry, pollCount, pollTimeout);
+#ifdef MOZ_SOCKET_POLL_BACKEND
+    if (mPollBackend) {
+      n = mPollBackend->Poll(firstPollEntry, pollCount, pollTimeout);
+      if (mPollBackend->Failed()) {
+        NS_WARNING("Socket poll backend failed, falling back to PR_Poll");
+        mPollBackend = nullptr;
+      }
+    } else
+#endif
+    {
+      n = PR_Poll(firstPollEntry, pollCount, pollTimeout);
+    }
 
 #ifdef MOZ_GECKO_PROFILER
     if (pollTimeout != PR_INTERVAL_NO_WAIT) {
       profiler_thread_wake();
     }
     if (profiler_thread_is_being_profiled_for_markers()) {
-      PROFILER_MARKER_TEXT(
-          "SocketTransportService::Poll", NETWORK,
-          MarkerTiming::IntervalUntilNowFrom(startTime),
-          pollTimeout == PR_INTERVAL_NO_TIMEOUT
-              ? nsPrintfCString("Poll count: %u, Poll timeout: NO_TIMEOUT",
-                                pollCount)
-          : pollTimeout == PR_INTERVAL_NO_WAIT
-              ? nsPrintfCString("Poll count: %u, Poll timeout: NO_WAIT",
-                                pollCount)
-              : nsPrintfCString("Poll count: %u, Poll timeout: %ums", pollCount,
-                                PR_IntervalToMilliseconds(pollTimeout)));
+      nsAutoCString text;
+      text.AppendPrintf("Poll count: %u, ", pollCount);
+      if (pollTimeout == PR_INTERVAL_NO_TIMEOUT) {
+        text.AppendLiteral("Poll timeout: NO_TIMEOUT");
+      } else if (pollTimeout == PR_INTERVAL_NO_WAIT) {
+        text.AppendLiteral("Poll timeout: NO_WAIT");
+      } else {
+        text.AppendPrintf("Poll timeout: %ums",
+                          PR_IntervalToMilliseconds(pollTimeout));
+      }
+#  ifdef MOZ_SOCKET_POLL_BACKEND
+      if (mPollBackend) {
+        text.AppendPrintf(", Backend: %s, Changes: %u, Ready: %d",
+                          SocketPollBackend::Name(),
+                          mPollBackend->LastChanges(), n);
+      }
+#  endif
+      PROFILER_MARKER_TEXT("SocketTransportService::Poll", NETWORK,
+                           MarkerTiming::IntervalUntilNowFrom(startTime),
+                           text);
     }
 #endif
   }
@@ -1125,6 +1154,12 @@ nsSocketTransportService::Run() {
     mPollList[0] = entry;
   }
 
+#ifdef MOZ_SOCKET_POLL_BACKEND
+  if (StaticPrefs::network_sts_poll_backend_enabled()) {
+    mPollBackend = SocketPollBackend::Create();
+  }
+#endif
+
   mRawThread = NS_GetCurrentThread();
 
   // Ensure a call to GetCurrentSerialEventTarget() returns this event target.
@@ -1255,6 +1290,7 @@ nsSocketTransportService::Run() {
 
   // detach all sockets, including locals
   Reset(false);
+  mPollBackend = nullptr;
 
   // We don't clear gSocketThread so that OnSocketThread() won't be a false
   // alarm for events generated by stopping the SSL threads during shutdown.
@@ -1878,6 +1914,11 @@ void nsSocketTransportService::TryRepairPollableEvent() MOZ_REQUIRES(mLock) {
   }
 
   NS_WARNING("Trying to repair mPollableEvent");
+#ifdef MOZ_SOCKET_POLL_BACKEND
+  if (mPollBackend) {
+    mPollBackend->Forget(mPollList[0].fd);
+  }
+#endif
   mPollableEvent.reset(pollable);
   if (!mPollableEvent->Valid()) {
     mPollableEvent = nullptr;
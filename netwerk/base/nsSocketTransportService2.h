@@ -54,6 +54,8 @@ extern LazyLogModule gUDPSocketLog;
 
 #define NS_SOCKET_POLL_TIMEOUT PR_INTERVAL_NO_TIMEOUT
 
+class SocketPollBackend;
+
 //-----------------------------------------------------------------------------
 
 // These maximums are borrowed from the linux kernel.
@@ -255,6 +257,10 @@ class nsSocketTransportService final : public nsPISocketTransportService,
 
   nsTArray<PRPollDesc> mPollList;
 
+  // Keeps mPollList registered with epoll/kqueue between iterations, null
+  // when PR_Poll() is used.
+  UniquePtr<SocketPollBackend> mPollBackend;
+
   PRIntervalTime PollTimeout(
       PRIntervalTime now);  // computes ideal poll timeout
   nsresult DoPollIteration(TimeDuration* pollDuration);
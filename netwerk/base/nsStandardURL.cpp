@@ -87,6 +87,31 @@ const char nsStandardURL::gHostLimitDigits[] = {'/', '\\', '?', '#', 0};
 // nsStandardURL::nsSegmentEncoder
 //----------------------------------------------------------------------------
 
+// The characters besides the ASCII alphanumerics that NS_EscapeURL() never
+// escapes for aMask, see the EscapeChars table in nsEscape.cpp.  Segments made
+// only of them are scanned with net_SkipURLSafeChars() instead.  Returns
+// null for the masks it doesn't know, which keep going through NS_EscapeURL().
+static const char* UnescapedSegmentChars(int16_t aMask) {
+  // '%' is only escaped with esc_Forced.
+  switch (aMask) {
+    case esc_Username:
+    case esc_Password:
+      return "!$&()*+,-_~%'.";
+    case esc_Directory:
+      return "!$&()*+,-_~%'./:;=@[]|";
+    case esc_FileBaseName:
+      return "!$&()*+,-_~%'.:;=@[]|";
+    case esc_FileExtension:
+      return "!$&()*+,-_~%':;=@[]|";
+    case esc_Query:
+      return "!$&()*+,-_~%./:;=?@[\\]^`{|}";
+    case esc_Ref:
+      return "!$&()*+,-_~%#'./:;=?@[\\]^{|}";
+    default:
+      return nullptr;
+  }
+}
+
 nsStandardURL::nsSegmentEncoder::nsSegmentEncoder(const Encoding* encoding)
     : mEncoding(encoding) {
   if (mEncoding == UTF_8_ENCODING) {
@@ -172,6 +197,15 @@ int32_t nsStandardURL::nsSegmentEncoder::EncodeSegmentCount(
     }
   }
 
+  // Most segments need no escaping at all, find out with a vectorized scan.
+  if (const char* unescaped = UnescapedSegmentChars(aMask)) {
+    if (net_SkipURLSafeChars(span.Elements(), span.Length(), unescaped,
+                             strlen(unescaped)) == span.Length()) {
+      aAppended = false;
+      return span.Length() + aExtraLen;
+    }
+  }
+
   if (NS_EscapeURLSpan(span, aMask, aOut)) {
     aAppended = true;
     // Difference between original and current output
@@ -8,6 +8,7 @@
 #include "nsIChannel.h"
 #include "nsError.h"
 #include "mozilla/ProfilerLabels.h"
+#include "mozilla/Unused.h"
 
 #include <limits>
 
@@ -80,6 +81,10 @@ nsStreamLoader::OnStopRequest(nsIRequest* request, nsresult aStatus) {
   if (mObserver) {
     // provide nsIStreamLoader::request during call to OnStreamComplete
     mRequest = request;
+    // Observers usually adopt the buffer, e.g. as the contents of an
+    // ArrayBuffer, which only accounts for its length: give back the
+    // capacity that growing it left unused.  Large buffers shrink in place.
+    Unused << mData.shrinkStorageToFit();
     size_t length = mData.length();
     uint8_t* elems = mData.extractOrCopyRawBuffer();
     nsresult rv =
@@ -30,6 +30,14 @@
 #include "mozilla/net/rust_helper.h"
 #include "mozilla/net/DNS.h"
 
+#if defined(MOZ_URL_SCAN_SSE2)
+#  include "mozilla/SSE.h"
+#  include "nsURLScanGenericFwd.h"
+#elif defined(MOZ_URL_SCAN_NEON)
+#  include "mozilla/arm.h"
+#  include "nsURLScanGenericFwd.h"
+#endif
+
 using namespace mozilla;
 
 //----------------------------------------------------------------------------
@@ -603,6 +611,50 @@ repeat:
   return (char*)iter;
 }
 
+uint32_t net_SkipURLSafeChars(const char* str, uint32_t len, const char* extra,
+                              uint32_t extraLen) {
+  size_t i = 0;
+#if defined(MOZ_URL_SCAN_SSE2)
+  if (mozilla::supports_sse2()) {
+    i = mozilla::net::SkipURLSafeBatches<xsimd::sse2>(str, len, extra,
+                                                      extraLen);
+  }
+#elif defined(MOZ_URL_SCAN_NEON)
+  if (mozilla::supports_neon()) {
+    i = mozilla::net::SkipURLSafeBatches<xsimd::neon>(str, len, extra,
+                                                      extraLen);
+  }
+#endif
+  for (; i < len; ++i) {
+    char c = str[i];
+    if (!IsAsciiAlphanumeric(c) && !memchr(extra, c, extraLen)) {
+      break;
+    }
+  }
+  return i;
+}
+
+const char* net_FindFirstOf(const char* iter, const char* stop,
+                            const char* set, uint32_t setLen) {
+#if defined(MOZ_URL_SCAN_SSE2)
+  if (mozilla::supports_sse2()) {
+    iter += mozilla::net::FindFirstOfBatches<xsimd::sse2>(iter, stop - iter,
+                                                          set, setLen);
+  }
+#elif defined(MOZ_URL_SCAN_NEON)
+  if (mozilla::supports_neon()) {
+    iter += mozilla::net::FindFirstOfBatches<xsimd::neon>(iter, stop - iter,
+                                                          set, setLen);
+  }
+#endif
+  for (; iter != stop; ++iter) {
+    if (memchr(set, *iter, setLen)) {
+      break;
+    }
+  }
+  return iter;
+}
+
 #define HTTP_LWS " \t"
 
 // Return the index of the closing quote of the string, if any
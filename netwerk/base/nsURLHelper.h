@@ -142,6 +142,23 @@ char* net_FindCharNotInSet(const char* iter, const char* stop, const char* set);
 char* net_RFindCharNotInSet(const char* stop, const char* iter,
                             const char* set);
 
+/**
+ * returns the length of the prefix of |str| made of ASCII alphanumerics and
+ * the |extraLen| characters of |extra|.  uses SSE2 or NEON when available,
+ * for the long paths and queries the URL parser and escaper go through.
+ */
+uint32_t net_SkipURLSafeChars(const char* str, uint32_t len, const char* extra,
+                              uint32_t extraLen);
+
+/**
+ * returns pointer to first character of |str| that is one of the |setLen|
+ * characters of |set|, or |stop| if there is none.  unlike net_FindCharInSet,
+ * doesn't stop at a null byte unless |set| contains it.  uses SSE2 or NEON
+ * when available.
+ */
+const char* net_FindFirstOf(const char* iter, const char* stop,
+                            const char* set, uint32_t setLen);
+
 /**
  * Parses a content-type header and returns the content type and
  * charset (if any).  aCharset is not modified if no charset is
@@ -201,21 +201,19 @@ nsBaseURLParser::ParsePath(const char* path, int32_t pathLen,
 
   // path = [/]<segment1>/<segment2>/<...>/<segmentN>?<query>#<ref>
 
-  // XXX PL_strnpbrk would be nice, but it's buggy
-
   // search for first occurrence of either ? or #
   const char *query_beg = nullptr, *query_end = nullptr;
   const char* ref_beg = nullptr;
-  const char* p = nullptr;
-  for (p = path; p < path + pathLen; ++p) {
-    // only match the query string if it precedes the reference fragment
-    if (!ref_beg && !query_beg && *p == '?') {
-      query_beg = p + 1;
-    } else if (*p == '#') {
-      ref_beg = p + 1;
-      if (query_beg) query_end = p;
-      break;
-    }
+  const char* stop = path + pathLen;
+  const char* p = net_FindFirstOf(path, stop, "?#", 2);
+  // only match the query string if it precedes the reference fragment
+  if (p < stop && *p == '?') {
+    query_beg = p + 1;
+    p = net_FindFirstOf(query_beg, stop, "#", 1);
+  }
+  if (p < stop) {
+    ref_beg = p + 1;
+    if (query_beg) query_end = p;
   }
 
   if (query_beg) {
@@ -586,10 +584,7 @@ void nsAuthURLParser::ParseAfterScheme(const char* spec, int32_t specLen,
 
   // search for the end of the authority section
   const char* end = spec + specLen;
-  const char* p;
-  for (p = spec + nslash; p < end; ++p) {
-    if (*p == '/' || *p == '?' || *p == '#') break;
-  }
+  const char* p = net_FindFirstOf(spec + nslash, end, "/?#", 3);
   if (p < end) {
     // spec = [/]<auth><path>
     SET_RESULT(auth, nslash, p - (spec + nslash));
@@ -614,10 +609,8 @@ void nsStdURLParser::ParseAfterScheme(const char* spec, int32_t specLen,
 
   // search for the end of the authority section
   const char* end = spec + specLen;
-  const char* p;
-  for (p = spec + nslash; p < end; ++p) {
-    if (strchr("/?#;", *p)) break;
-  }
+  // A null byte ends it too, as strchr() used to match the terminator.
+  const char* p = net_FindFirstOf(spec + nslash, end, "/?#;", 5);
   switch (nslash) {
     case 0:
     case 2:
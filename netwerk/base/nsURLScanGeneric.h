@@ -0,0 +1,69 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef nsURLScanGeneric_h__
+#define nsURLScanGeneric_h__
+
+#include "nsURLScanGenericFwd.h"
+
+namespace mozilla {
+namespace net {
+
+template <class Arch>
+size_t SkipURLSafeBatches(const char* aStr, size_t aLen, const char* aExtra,
+                          size_t aExtraLen) {
+  using batch = xsimd::batch<uint8_t, Arch>;
+  const size_t numCharsPerVector = batch::size;
+  const auto* str = reinterpret_cast<const uint8_t*>(aStr);
+
+  const batch caseBit(static_cast<uint8_t>(0x20));
+  const batch lowerA(static_cast<uint8_t>('a'));
+  const batch lowerZ(static_cast<uint8_t>('z'));
+  const batch digit0(static_cast<uint8_t>('0'));
+  const batch digit9(static_cast<uint8_t>('9'));
+
+  size_t i = 0;
+  for (; i + numCharsPerVector <= aLen; i += numCharsPerVector) {
+    const batch vect = batch::load_unaligned(str + i);
+    // Setting the case bit maps only 'A'-'Z' onto 'a'-'z'.
+    const batch lower = vect | caseBit;
+    auto safe = ((lower >= lowerA) & (lower <= lowerZ)) |
+                ((vect >= digit0) & (vect <= digit9));
+    for (size_t e = 0; e < aExtraLen; ++e) {
+      safe = safe | (vect == batch(static_cast<uint8_t>(aExtra[e])));
+    }
+    if (!xsimd::all(safe)) {
+      break;
+    }
+  }
+  return i;
+}
+
+template <class Arch>
+size_t FindFirstOfBatches(const char* aStr, size_t aLen, const char* aSet,
+                          size_t aSetLen) {
+  using batch = xsimd::batch<uint8_t, Arch>;
+  const size_t numCharsPerVector = batch::size;
+  const auto* str = reinterpret_cast<const uint8_t*>(aStr);
+
+  size_t i = 0;
+  for (; i + numCharsPerVector <= aLen; i += numCharsPerVector) {
+    const batch vect = batch::load_unaligned(str + i);
+    auto found = vect == batch(static_cast<uint8_t>(aSet[0]));
+    for (size_t s = 1; s < aSetLen; ++s) {
+      found = found | (vect == batch(static_cast<uint8_t>(aSet[s])));
+    }
+    if (xsimd::any(found)) {
+      break;
+    }
+  }
+  return i;
+}
+
+}  // namespace net
+}  // namespace mozilla
+
+#endif
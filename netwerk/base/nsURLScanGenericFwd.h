@@ -0,0 +1,31 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef nsURLScanGenericFwd_h__
+#define nsURLScanGenericFwd_h__
+
+#include <cstddef>
+#include <xsimd/xsimd.hpp>
+
+namespace mozilla {
+namespace net {
+
+// See net_SkipURLSafeChars() and net_FindFirstOf() in nsURLHelper.h.  Both
+// only look at whole batches and return the offset of the first batch with a
+// match, the caller finishes the scan one character at a time.
+
+template <class Arch>
+size_t SkipURLSafeBatches(const char* aStr, size_t aLen, const char* aExtra,
+                          size_t aExtraLen);
+
+template <class Arch>
+size_t FindFirstOfBatches(const char* aStr, size_t aLen, const char* aSet,
+                          size_t aSetLen);
+
+}  // namespace net
+}  // namespace mozilla
+
+#endif
@@ -0,0 +1,16 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "nsURLScanGeneric.h"
+
+namespace mozilla {
+namespace net {
+template size_t SkipURLSafeBatches<xsimd::neon>(const char*, size_t,
+                                                const char*, size_t);
+template size_t FindFirstOfBatches<xsimd::neon>(const char*, size_t,
+                                                const char*, size_t);
+}  // namespace net
+}  // namespace mozilla
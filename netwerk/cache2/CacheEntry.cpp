@@ -1698,6 +1698,32 @@ bool CacheEntry::Purge(uint32_t aWhat) {
   return false;
 }
 
+bool CacheEntry::Compress() {
+  LOG(("CacheEntry::Compress [this=%p]", this));
+
+  MOZ_ASSERT(CacheStorageService::IsOnManagementThread());
+
+  if (mUseDisk) {
+    // Disk backed entries can simply reload their data.
+    return false;
+  }
+
+  {
+    mozilla::MutexAutoLock lock(mLock);
+
+    if (mState != READY) {
+      LOG(("  state=%s", StateString(mState)));
+      return false;
+    }
+  }
+
+  if (NS_FAILED(mFileStatus)) {
+    return false;
+  }
+
+  return mFile->CompressIdleChunks() > 0;
+}
+
 void CacheEntry::PurgeAndDoom() {
   LOG(("CacheEntry::PurgeAndDoom [this=%p]", this));
 
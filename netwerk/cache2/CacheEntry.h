@@ -138,6 +138,9 @@ class CacheEntry final : public nsIRunnable,
 
   bool DeferOrBypassRemovalOnPinStatus(bool aPinned);
   bool Purge(uint32_t aWhat);
+  // Compresses the idle data of a memory-only entry to relieve the memory
+  // pool without purging the entry.  Returns true if anything got compressed.
+  bool Compress();
   void PurgeAndDoom();
   void DoomAlreadyRemoved();
 
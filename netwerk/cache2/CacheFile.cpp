@@ -14,6 +14,7 @@
 #include "CacheIndex.h"
 #include "CacheLog.h"
 #include "mozilla/DebugOnly.h"
+#include "mozilla/StaticPrefs_browser.h"
 #include "mozilla/glean/NetwerkCache2Metrics.h"
 #include "mozilla/TelemetryHistogramEnums.h"
 #include "nsComponentManagerUtils.h"
@@ -202,6 +203,7 @@ nsresult CacheFile::Init(const nsACString& aKey, bool aCreateNew,
   // available bytes but would not be available later during call to
   // CacheFileInputStream::Read().
   mPreloadChunkCount = CacheObserver::PreloadChunkCount();
+  mReadAheadChunkCount = mPreloadChunkCount;
 
   LOG(
       ("CacheFile::Init() [this=%p, key=%s, createNew=%d, memoryOnly=%d, "
@@ -1094,6 +1096,26 @@ nsresult CacheFile::ThrowMemoryCachedData() {
   return NS_OK;
 }
 
+uint32_t CacheFile::CompressIdleChunks() {
+  CacheFileAutoLock lock(this);
+
+  LOG(("CacheFile::CompressIdleChunks() [this=%p]", this));
+
+  if (!mMemoryOnly || mOpeningFile || NS_FAILED(mStatus)) {
+    return 0;
+  }
+
+  // Chunks in mChunks are used by streams, only the cached ones are idle.
+  uint32_t compressed = 0;
+  for (auto iter = mCachedChunks.Iter(); !iter.Done(); iter.Next()) {
+    if (NS_SUCCEEDED(iter.Data()->Compress())) {
+      ++compressed;
+    }
+  }
+
+  return compressed;
+}
+
 nsresult CacheFile::GetElement(const char* aKey, char** _retval) {
   CacheFileAutoLock lock(this);
   MOZ_ASSERT(mMetadata);
@@ -1395,6 +1417,9 @@ nsresult CacheFile::GetChunkLocked(uint32_t aIndex, ECallerType aCaller,
   // Preload chunks from disk when this is disk backed entry and the listener
   // is reader.
   bool preload = !mMemoryOnly && (aCaller == READER);
+  if (preload) {
+    UpdateReadAhead(aIndex);
+  }
 
   nsresult rv;
 
@@ -1438,6 +1463,11 @@ nsresult CacheFile::GetChunkLocked(uint32_t aIndex, ECallerType aCaller,
     // Preloader calls this method to preload only non-loaded chunks.
     MOZ_ASSERT(aCaller != PRELOADER, "Unexpected!");
 
+    rv = chunk->EnsureDecompressed();
+    if (NS_FAILED(rv)) {
+      return rv;
+    }
+
     mChunks.InsertOrUpdate(aIndex, RefPtr{chunk});
     mCachedChunks.Remove(aIndex);
     chunk->mFile = this;
@@ -1593,7 +1623,7 @@ nsresult CacheFile::GetChunkLocked(uint32_t aIndex, ECallerType aCaller,
 void CacheFile::PreloadChunks(uint32_t aIndex) {
   AssertOwnsLock();
 
-  uint32_t limit = aIndex + mPreloadChunkCount;
+  uint32_t limit = aIndex + mReadAheadChunkCount;
 
   for (uint32_t i = aIndex; i < limit; ++i) {
     int64_t off = i * static_cast<int64_t>(kChunkSize);
@@ -1619,6 +1649,43 @@ void CacheFile::PreloadChunks(uint32_t aIndex) {
   }
 }
 
+void CacheFile::UpdateReadAhead(uint32_t aIndex) {
+  AssertOwnsLock();
+
+  uint32_t maxCount =
+      StaticPrefs::browser_cache_disk_max_readahead_chunk_count();
+  if (mPreloadChunkCount == 0 || maxCount <= mPreloadChunkCount) {
+    mReadAheadChunkCount = mPreloadChunkCount;
+    mLastReadChunk = aIndex;
+    return;
+  }
+
+  if (aIndex == mLastReadChunk) {
+    return;
+  }
+
+  uint32_t count = mPreloadChunkCount;
+  if (aIndex == mLastReadChunk + 1) {
+    // A sequential reader, the window doubles with every chunk it consumes.
+    count = std::min(mReadAheadChunkCount * 2, maxCount);
+  }
+
+  // The read-ahead chunks compete for memory with the chunks of entries being
+  // written, don't grow the window beyond what fits into their limit.
+  if (count > mPreloadChunkCount &&
+      !CacheFileChunk::CanReadAhead(mPriority, count * kChunkSize)) {
+    count = mPreloadChunkCount;
+  }
+
+  if (count != mReadAheadChunkCount) {
+    LOG(("CacheFile::UpdateReadAhead() - read-ahead %u -> %u chunks "
+         "[this=%p, idx=%u]",
+         mReadAheadChunkCount, count, this, aIndex));
+    mReadAheadChunkCount = count;
+  }
+  mLastReadChunk = aIndex;
+}
+
 bool CacheFile::ShouldCacheChunk(uint32_t aIndex) {
   AssertOwnsLock();
 
@@ -1664,12 +1731,12 @@ bool CacheFile::MustKeepCachedChunk(uint32_t aIndex) {
   int64_t maxPos = static_cast<int64_t>(aIndex + 1) * kChunkSize - 1;
 
   // minPos is the position of the first byte in a chunk that precedes the given
-  // chunk by mPreloadChunkCount chunks
+  // chunk by mReadAheadChunkCount chunks
   int64_t minPos;
-  if (mPreloadChunkCount >= aIndex) {
+  if (mReadAheadChunkCount >= aIndex) {
     minPos = 0;
   } else {
-    minPos = static_cast<int64_t>(aIndex - mPreloadChunkCount) * kChunkSize;
+    minPos = static_cast<int64_t>(aIndex - mReadAheadChunkCount) * kChunkSize;
   }
 
   for (uint32_t i = 0; i < mInputs.Length(); ++i) {
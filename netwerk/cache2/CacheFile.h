@@ -92,6 +92,10 @@ class MOZ_CAPABILITY("mutex") CacheFile final
 
   void Kill() { mKill = true; }
   nsresult ThrowMemoryCachedData();
+  // Compresses the data of the idle chunks of a memory-only entry.  They are
+  // decompressed again in GetChunkLocked() when a stream reaches them.
+  // Returns the number of chunks that have been compressed.
+  uint32_t CompressIdleChunks();
 
   nsresult GetAltDataSize(int64_t* aSize);
   nsresult GetAltDataType(nsACString& aType);
@@ -161,6 +165,9 @@ class MOZ_CAPABILITY("mutex") CacheFile final
                           CacheFileChunk** _retval);
 
   void PreloadChunks(uint32_t aIndex);
+  // Grows the read-ahead window while the reader consumes chunks one after
+  // another and resets it on a seek or under memory pressure.
+  void UpdateReadAhead(uint32_t aIndex);
   bool ShouldCacheChunk(uint32_t aIndex);
   bool MustKeepCachedChunk(uint32_t aIndex);
 
@@ -213,6 +220,12 @@ class MOZ_CAPABILITY("mutex") CacheFile final
   bool mWritingMetadata MOZ_GUARDED_BY(this){false};
   bool mPreloadWithoutInputStreams MOZ_GUARDED_BY(this){true};
   uint32_t mPreloadChunkCount MOZ_GUARDED_BY(this){0};
+  // Number of chunks preloaded ahead of the reader, never smaller than
+  // mPreloadChunkCount.  Only mPreloadChunkCount is used to compute available
+  // bytes, so this one is free to shrink again.
+  uint32_t mReadAheadChunkCount MOZ_GUARDED_BY(this){0};
+  // Index of the chunk last requested by a reader.
+  uint32_t mLastReadChunk MOZ_GUARDED_BY(this){UINT32_MAX};
   nsresult mStatus MOZ_GUARDED_BY(this){NS_OK};
   // Size of the whole data including eventual alternative data represenation.
   int64_t mDataSize MOZ_GUARDED_BY(this){-1};
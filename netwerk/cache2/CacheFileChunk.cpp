@@ -10,6 +10,8 @@
 
 #include "mozilla/IntegerPrintfMacros.h"
 
+#include "zlib.h"
+
 namespace mozilla::net {
 
 #define kMinBufSize 512
@@ -20,7 +22,8 @@ CacheFileChunkBuffer::CacheFileChunkBuffer(CacheFileChunk* aChunk)
       mBufSize(0),
       mDataSize(0),
       mReadHandlesCount(0),
-      mWriteHandleExists(false) {}
+      mWriteHandleExists(false),
+      mCompressed(false) {}
 
 CacheFileChunkBuffer::~CacheFileChunkBuffer() {
   if (mBuf) {
@@ -72,6 +75,7 @@ nsresult CacheFileChunkBuffer::FillInvalidRanges(
 
 [[nodiscard]] nsresult CacheFileChunkBuffer::EnsureBufSize(uint32_t aBufSize) {
   AssertOwnsLock();
+  MOZ_RELEASE_ASSERT(!mCompressed);
 
   if (mBufSize >= aBufSize) {
     return NS_OK;
@@ -122,6 +126,72 @@ void CacheFileChunkBuffer::SetDataSize(uint32_t aDataSize) {
   mDataSize = aDataSize;
 }
 
+nsresult CacheFileChunkBuffer::Compress() {
+  AssertOwnsLock();
+  MOZ_RELEASE_ASSERT(!mCompressed);
+  MOZ_RELEASE_ASSERT(!mReadHandlesCount && !mWriteHandleExists);
+
+  if (!mDataSize) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+
+  uLongf compressedSize = compressBound(mDataSize);
+  char* compressedBuf = static_cast<char*>(malloc(compressedSize));
+  if (!compressedBuf) {
+    return NS_ERROR_OUT_OF_MEMORY;
+  }
+
+  int zerr = compress2(reinterpret_cast<Bytef*>(compressedBuf), &compressedSize,
+                       reinterpret_cast<const Bytef*>(mBuf), mDataSize,
+                       Z_BEST_SPEED);
+
+  // It's not worth paying for the decompression when we don't save at least
+  // a quarter of the memory, this is typically already compressed media.
+  if (zerr != Z_OK || compressedSize > mDataSize - mDataSize / 4) {
+    free(compressedBuf);
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+
+  char* shrunkBuf = static_cast<char*>(realloc(compressedBuf, compressedSize));
+  if (shrunkBuf) {
+    compressedBuf = shrunkBuf;
+  }
+
+  CacheFileUtils::FreeBuffer(mBuf);
+  mChunk->BuffersAllocationChanged(mBufSize, compressedSize);
+  mBuf = compressedBuf;
+  mBufSize = compressedSize;
+  mCompressed = true;
+
+  return NS_OK;
+}
+
+nsresult CacheFileChunkBuffer::Decompress() {
+  AssertOwnsLock();
+  MOZ_RELEASE_ASSERT(mCompressed);
+
+  char* dataBuf = static_cast<char*>(malloc(mDataSize));
+  if (!dataBuf) {
+    return NS_ERROR_OUT_OF_MEMORY;
+  }
+
+  uLongf dataSize = mDataSize;
+  int zerr = uncompress(reinterpret_cast<Bytef*>(dataBuf), &dataSize,
+                        reinterpret_cast<const Bytef*>(mBuf), mBufSize);
+  if (zerr != Z_OK || dataSize != mDataSize) {
+    free(dataBuf);
+    return NS_ERROR_FILE_CORRUPTED;
+  }
+
+  CacheFileUtils::FreeBuffer(mBuf);
+  mChunk->BuffersAllocationChanged(mBufSize, mDataSize);
+  mBuf = dataBuf;
+  mBufSize = mDataSize;
+  mCompressed = false;
+
+  return NS_OK;
+}
+
 void CacheFileChunkBuffer::AssertOwnsLock() const { mChunk->AssertOwnsLock(); }
 
 void CacheFileChunkBuffer::RemoveReadHandle() {
@@ -168,6 +238,7 @@ uint32_t CacheFileChunkHandle::Offset() {
 
 CacheFileChunkReadHandle::CacheFileChunkReadHandle(CacheFileChunkBuffer* aBuf) {
   mBuf = aBuf;
+  MOZ_RELEASE_ASSERT(!mBuf->mCompressed);
   mBuf->mReadHandlesCount++;
 }
 
@@ -182,6 +253,7 @@ CacheFileChunkWriteHandle::CacheFileChunkWriteHandle(
   mBuf = aBuf;
   if (mBuf) {
     MOZ_ASSERT(!mBuf->mWriteHandleExists);
+    MOZ_RELEASE_ASSERT(!mBuf->mCompressed);
     mBuf->mWriteHandleExists = true;
   }
 }
@@ -759,6 +831,43 @@ CacheFileChunkWriteHandle CacheFileChunk::GetWriteHandle(
   return CacheFileChunkWriteHandle(mBuf);
 }
 
+nsresult CacheFileChunk::Compress() {
+  AssertOwnsLock();
+
+  if (mState != READY || NS_FAILED(mStatus) || mBuf->IsCompressed() ||
+      mBuf->ReadHandlesCount() || mBuf->WriteHandleExists() ||
+      !mOldBufs.IsEmpty()) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+
+  uint32_t oldBuffersSize = mBuffersSize;
+  nsresult rv = mBuf->Compress();
+  if (NS_FAILED(rv)) {
+    return rv;
+  }
+
+  LOG(("CacheFileChunk::Compress() - compressed [this=%p, %u -> %u]", this,
+       oldBuffersSize, mBuffersSize));
+  return NS_OK;
+}
+
+nsresult CacheFileChunk::EnsureDecompressed() {
+  AssertOwnsLock();
+
+  if (!mBuf->IsCompressed()) {
+    return NS_OK;
+  }
+
+  LOG(("CacheFileChunk::EnsureDecompressed() [this=%p]", this));
+
+  nsresult rv = mBuf->Decompress();
+  if (NS_FAILED(rv)) {
+    SetError(rv);
+  }
+
+  return rv;
+}
+
 // Memory reporting
 
 size_t CacheFileChunk::SizeOfExcludingThis(
@@ -832,9 +941,26 @@ void CacheFileChunk::BuffersAllocationChanged(uint32_t aFreed,
 
 mozilla::Atomic<uint32_t, ReleaseAcquire>& CacheFileChunk::ChunksMemoryUsage()
     const {
+  return ChunksMemoryUsage(mIsPriority);
+}
+
+// static
+mozilla::Atomic<uint32_t, ReleaseAcquire>& CacheFileChunk::ChunksMemoryUsage(
+    bool aPriority) {
   static mozilla::Atomic<uint32_t, ReleaseAcquire> chunksMemoryUsage(0);
   static mozilla::Atomic<uint32_t, ReleaseAcquire> prioChunksMemoryUsage(0);
-  return mIsPriority ? prioChunksMemoryUsage : chunksMemoryUsage;
+  return aPriority ? prioChunksMemoryUsage : chunksMemoryUsage;
+}
+
+// static
+bool CacheFileChunk::CanReadAhead(bool aPriority, uint32_t aSize) {
+  int64_t limit = CacheObserver::MaxDiskChunksMemoryUsage(aPriority);
+  if (limit == 0) {
+    return true;
+  }
+
+  limit <<= 10;
+  return int64_t(ChunksMemoryUsage(aPriority)) + aSize <= limit;
 }
 
 }  // namespace mozilla::net
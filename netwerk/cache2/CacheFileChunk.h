@@ -39,6 +39,13 @@ class CacheFileChunkBuffer {
   uint32_t ReadHandlesCount() const { return mReadHandlesCount; }
   bool WriteHandleExists() const { return mWriteHandleExists; }
 
+  // Replaces the data with its deflated form and back.  While compressed,
+  // mBuf holds the deflated bytes and mDataSize the size of the original
+  // data.  No handle can exist for a compressed buffer.
+  nsresult Compress();
+  nsresult Decompress();
+  bool IsCompressed() const { return mCompressed; }
+
  private:
   friend class CacheFileChunkHandle;
   friend class CacheFileChunkReadHandle;
@@ -61,6 +68,7 @@ class CacheFileChunkBuffer {
   uint32_t mDataSize;
   uint32_t mReadHandlesCount;
   bool mWriteHandleExists;
+  bool mCompressed;
 };
 
 class CacheFileChunkHandle {
@@ -163,6 +171,17 @@ class CacheFileChunk final : public CacheFileIOListener,
   CacheFileChunkReadHandle GetReadHandle();
   CacheFileChunkWriteHandle GetWriteHandle(uint32_t aEnsuredBufSize);
 
+  // Compresses the data of an idle chunk of a memory-only entry.  Fails when
+  // the chunk is in use, already compressed or doesn't compress well.
+  nsresult Compress();
+  // Must be called before a compressed chunk is handed out to a consumer.
+  nsresult EnsureDecompressed();
+
+  // Whether aSize bytes of read-ahead fit into the limit for disk chunks
+  // memory usage.  Chunks read from the disk are not accounted, so this is
+  // only a hint used to size the read-ahead window.
+  static bool CanReadAhead(bool aPriority, uint32_t aSize);
+
   // Memory reporting
   size_t SizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
   size_t SizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
@@ -185,6 +204,8 @@ class CacheFileChunk final : public CacheFileIOListener,
   void BuffersAllocationChanged(uint32_t aFreed, uint32_t aAllocated);
 
   mozilla::Atomic<uint32_t, ReleaseAcquire>& ChunksMemoryUsage() const;
+  static mozilla::Atomic<uint32_t, ReleaseAcquire>& ChunksMemoryUsage(
+      bool aPriority);
 
   enum EState { INITIAL = 0, READING = 1, WRITING = 2, READY = 3 };
 
@@ -19,6 +19,7 @@
 #include "nsIDirectoryEnumerator.h"
 #include "mozilla/Base64.h"
 #include "mozilla/IntegerPrintfMacros.h"
+#include "mozilla/StaticPrefs_network.h"
 #include "nsContentUtils.h"
 #include "nsNetUtil.h"
 
@@ -596,6 +597,7 @@ void CacheFileContextEvictor::EvictEntries() {
 
   while (true) {
     if (CacheObserver::ShuttingDown()) {
+      RemoveBatchedEntries();
       LOG(
           ("CacheFileContextEvictor::EvictEntries() - Stopping evicting due to "
            "shutdown."));
@@ -606,6 +608,7 @@ void CacheFileContextEvictor::EvictEntries() {
     }
 
     if (CacheIOThread::YieldAndRerun()) {
+      RemoveBatchedEntries();
       LOG(
           ("CacheFileContextEvictor::EvictEntries() - Breaking loop for higher "
            "level events."));
@@ -631,6 +634,8 @@ void CacheFileContextEvictor::EvictEntries() {
           ("CacheFileContextEvictor::EvictEntries() - No more entries left in "
            "iterator. [iterator=%p, info=%p]",
            mEntries[0]->mIterator.get(), mEntries[0]->mInfo.get()));
+      // The eviction info must stay on disk until all entries are gone.
+      RemoveBatchedEntries();
       RemoveEvictInfoFromDisk(mEntries[0]->mInfo, mEntries[0]->mPinned,
                               mEntries[0]->mOrigin, mEntries[0]->mBaseDomain);
       mEntries.RemoveElementAt(0);
@@ -642,6 +647,7 @@ void CacheFileContextEvictor::EvictEntries() {
            "provide next hash (shutdown?), keeping eviction info on disk."
            " [iterator=%p, info=%p]",
            mEntries[0]->mIterator.get(), mEntries[0]->mInfo.get()));
+      RemoveBatchedEntries();
       mEntries.RemoveElementAt(0);
       continue;
     }
@@ -818,12 +824,46 @@ void CacheFileContextEvictor::EvictEntries() {
       continue;
     }
 
-    LOG(("CacheFileContextEvictor::EvictEntries - Removing entry."));
-    file->Remove(false);
-    CacheIndex::RemoveEntry(&hash);
+    uint32_t batchSize =
+        StaticPrefs::network_cache_context_eviction_batch_size();
+    if (batchSize <= 1) {
+      LOG(("CacheFileContextEvictor::EvictEntries - Removing entry."));
+      file->Remove(false);
+      CacheIndex::RemoveEntry(&hash);
+      continue;
+    }
+
+    CacheFileContextEvictorBatchedEntry* batched =
+        mBatchedEntries.AppendElement();
+    memcpy(batched->mHash, hash, sizeof(SHA1Sum::Hash));
+    batched->mFile = std::move(file);
+    if (mBatchedEntries.Length() >= batchSize) {
+      RemoveBatchedEntries();
+    }
   }
 
   MOZ_ASSERT_UNREACHABLE("We should never get here");
 }
 
+void CacheFileContextEvictor::RemoveBatchedEntries() {
+  MOZ_ASSERT(CacheFileIOManager::IsOnIOThread());
+
+  if (mBatchedEntries.IsEmpty()) {
+    return;
+  }
+
+  LOG(("CacheFileContextEvictor::RemoveBatchedEntries() - Removing %zu "
+       "entries.",
+       mBatchedEntries.Length()));
+
+  nsTArray<const SHA1Sum::Hash*> hashes(mBatchedEntries.Length());
+  for (const auto& entry : mBatchedEntries) {
+    entry.mFile->Remove(false);
+    hashes.AppendElement(&entry.mHash);
+  }
+  CacheIndex::RemoveEntries(hashes);
+
+  mBatchedEntries.Clear();
+}
+
 }  // namespace mozilla::net
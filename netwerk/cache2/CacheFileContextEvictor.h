@@ -5,6 +5,7 @@
 #ifndef CacheFileContextEvictor__h__
 #define CacheFileContextEvictor__h__
 
+#include "mozilla/SHA1.h"
 #include "mozilla/UniquePtr.h"
 #include "nsCOMPtr.h"
 #include "nsString.h"
@@ -18,6 +19,12 @@ namespace net {
 
 class CacheIndexIterator;
 
+// An entry found to be evicted, see CacheFileContextEvictor::EvictEntries().
+struct CacheFileContextEvictorBatchedEntry {
+  SHA1Sum::Hash mHash;
+  nsCOMPtr<nsIFile> mFile;
+};
+
 struct CacheFileContextEvictorEntry {
   nsCOMPtr<nsILoadContextInfo> mInfo;
   bool mPinned = false;
@@ -82,6 +89,10 @@ class CacheFileContextEvictor {
   void CloseIterators();
   void StartEvicting();
   void EvictEntries();
+  // Deletes the files of the entries collected by EvictEntries() and removes
+  // them from the index.  Must be called before EvictEntries() gives up the
+  // IO thread, a new handle could be created for a collected entry otherwise.
+  void RemoveBatchedEntries();
 
   // Whether eviction is in progress
   bool mEvicting{false};
@@ -97,6 +108,8 @@ class CacheFileContextEvictor {
   nsTArray<UniquePtr<CacheFileContextEvictorEntry>> mEntries;
   nsCOMPtr<nsIFile> mCacheDirectory;
   nsCOMPtr<nsIFile> mEntriesDir;
+  // Entries found to be evicted that are removed in the next batch.
+  nsTArray<CacheFileContextEvictorBatchedEntry> mBatchedEntries;
 };
 
 }  // namespace net
@@ -2,6 +2,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <algorithm>
 #include <limits>
 #include "CacheLog.h"
 #include "CacheFileIOManager.h"
@@ -36,6 +37,10 @@
 #include "nsNetUtil.h"
 #include "mozilla/glean/NetwerkMetrics.h"
 
+#ifdef MOZ_CACHE_IO_URING
+#  include "CacheFileIOUring.h"
+#endif
+
 #ifdef MOZ_BACKGROUNDTASKS
 #  include "mozilla/BackgroundTasksRunner.h"
 #  include "nsIBackgroundTasks.h"
@@ -729,6 +734,10 @@ class ReadEvent : public Runnable, public IOPerfReportEvent {
                                                        mCount);
       if (NS_SUCCEEDED(rv)) {
         Report(CacheFileIOManager::gInstance->mIOThread);
+        if (!mStartTime.IsNull()) {
+          glean::network::cache_read_latency.Get("sync"_ns)
+              .AccumulateRawDuration(TimeStamp::Now() - mStartTime);
+        }
       }
     }
 
@@ -1288,6 +1297,10 @@ void CacheFileIOManager::ShutdownInternal() {
     mContextEvictor->Shutdown();
     mContextEvictor = nullptr;
   }
+
+#ifdef MOZ_CACHE_IO_URING
+  mIOUring = nullptr;
+#endif
 }
 
 // static
@@ -1960,6 +1973,14 @@ nsresult CacheFileIOManager::Read(CacheFileHandle* aHandle, int64_t aOffset,
     return NS_ERROR_NOT_INITIALIZED;
   }
 
+#ifdef MOZ_CACHE_IO_URING
+  if (StaticPrefs::network_cache_io_uring_enabled() &&
+      !aHandle->IsSpecialFile()) {
+    return ioMan->DispatchBatchedRead(aHandle, aOffset, aBuf, aCount,
+                                      aCallback);
+  }
+#endif
+
   RefPtr<ReadEvent> ev =
       new ReadEvent(aHandle, aOffset, aBuf, aCount, aCallback);
   rv = ioMan->mIOThread->Dispatch(ev, aHandle->IsPriority()
@@ -1977,6 +1998,25 @@ nsresult CacheFileIOManager::ReadInternal(CacheFileHandle* aHandle,
        ", count=%d]",
        aHandle, aOffset, aCount));
 
+  CacheIOThread::Cancelable cancelable(!aHandle->IsSpecialFile());
+
+  nsresult rv = PrepareHandleForRead(aHandle);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  int64_t offset = PR_Seek64(aHandle->mFD, aOffset, PR_SEEK_SET);
+  if (offset == -1) {
+    return NS_ERROR_FAILURE;
+  }
+
+  int32_t bytesRead = PR_Read(aHandle->mFD, aBuf, aCount);
+  if (bytesRead != aCount) {
+    return NS_ERROR_FAILURE;
+  }
+
+  return NS_OK;
+}
+
+nsresult CacheFileIOManager::PrepareHandleForRead(CacheFileHandle* aHandle) {
   nsresult rv;
 
   if (CacheObserver::ShuttingDown()) {
@@ -1989,8 +2029,6 @@ nsresult CacheFileIOManager::ReadInternal(CacheFileHandle* aHandle,
     return NS_ERROR_NOT_AVAILABLE;
   }
 
-  CacheIOThread::Cancelable cancelable(!aHandle->IsSpecialFile());
-
   if (!aHandle->mFD) {
     rv = OpenNSPRHandle(aHandle);
     NS_ENSURE_SUCCESS(rv, rv);
@@ -2004,19 +2042,148 @@ nsresult CacheFileIOManager::ReadInternal(CacheFileHandle* aHandle,
     return NS_ERROR_NOT_AVAILABLE;
   }
 
-  int64_t offset = PR_Seek64(aHandle->mFD, aOffset, PR_SEEK_SET);
-  if (offset == -1) {
-    return NS_ERROR_FAILURE;
+  return NS_OK;
+}
+
+#ifdef MOZ_CACHE_IO_URING
+nsresult CacheFileIOManager::DispatchBatchedRead(
+    CacheFileHandle* aHandle, int64_t aOffset, char* aBuf, int32_t aCount,
+    CacheFileIOListener* aCallback) {
+  bool priority = aHandle->IsPriority();
+  bool needsFlush;
+  {
+    MutexAutoLock lock(mBatchedReadsLock);
+    nsTArray<BatchedRead>& reads = mBatchedReads[priority];
+    needsFlush = reads.IsEmpty();
+    reads.AppendElement(BatchedRead{aHandle, aOffset, aBuf, aCount, aCallback,
+                                    TimeStamp::Now()});
+  }
+
+  if (!needsFlush) {
+    // The read will be picked up by the flush event already in the queue.
+    return NS_OK;
   }
 
-  int32_t bytesRead = PR_Read(aHandle->mFD, aBuf, aCount);
-  if (bytesRead != aCount) {
-    return NS_ERROR_FAILURE;
+  nsresult rv = mIOThread->Dispatch(
+      NewRunnableMethod<bool>("net::CacheFileIOManager::FlushBatchedReads",
+                              this, &CacheFileIOManager::FlushBatchedReads,
+                              priority),
+      priority ? CacheIOThread::READ_PRIORITY : CacheIOThread::READ);
+  if (NS_FAILED(rv)) {
+    // Nothing else could have been appended since no flush is pending, the
+    // caller gets the error instead of a callback.
+    MutexAutoLock lock(mBatchedReadsLock);
+    mBatchedReads[priority].Clear();
+    return rv;
   }
 
   return NS_OK;
 }
 
+bool CacheFileIOManager::EnsureIOUring() {
+  MOZ_ASSERT(mIOThread->IsCurrentThread());
+
+  if (!mIOUring && !mIOUringFailed) {
+    // Keep the ring well below kOpenHandlesLimit so that opening the handles
+    // for one submission never closes an NSPR handle used by the same
+    // submission.
+    uint32_t entries = std::clamp<uint32_t>(
+        StaticPrefs::network_cache_io_uring_queue_depth(), 1,
+        kOpenHandlesLimit / 2);
+    mIOUring = CacheFileIOUring::Create(entries);
+    mIOUringFailed = !mIOUring;
+  }
+
+  return !!mIOUring;
+}
+
+void CacheFileIOManager::FlushBatchedReads(bool aPriority) {
+  MOZ_ASSERT(mIOThread->IsCurrentThread());
+
+  nsTArray<BatchedRead> reads;
+  {
+    MutexAutoLock lock(mBatchedReadsLock);
+    reads = std::move(mBatchedReads[aPriority]);
+  }
+
+  LOG(("CacheFileIOManager::FlushBatchedReads() [priority=%d, count=%zu]",
+       aPriority, reads.Length()));
+
+  nsTArray<nsresult> results;
+  results.SetLength(reads.Length());
+
+  CacheIOThread::Cancelable cancelable(true);
+
+  bool ringUsable = EnsureIOUring();
+  uint32_t batchSize = ringUsable ? mIOUring->Capacity() : 1;
+  AutoTArray<CacheFileIOUring::Request, 32> requests;
+  AutoTArray<size_t, 32> requestIndexes;
+
+  for (size_t start = 0; start < reads.Length(); start += batchSize) {
+    size_t end = std::min(reads.Length(), start + batchSize);
+
+    requests.ClearAndRetainStorage();
+    requestIndexes.ClearAndRetainStorage();
+    for (size_t i = start; i < end; ++i) {
+      BatchedRead& read = reads[i];
+      if (read.mHandle->IsClosed() || read.mCallback->IsKilled()) {
+        results[i] = NS_ERROR_NOT_INITIALIZED;
+        continue;
+      }
+
+      results[i] = PrepareHandleForRead(read.mHandle);
+      if (NS_FAILED(results[i])) {
+        continue;
+      }
+
+      requests.AppendElement(CacheFileIOUring::Request{
+          PR_FileDesc2NativeHandle(read.mHandle->mFD), read.mOffset,
+          read.mBuf, read.mCount, 0});
+      requestIndexes.AppendElement(i);
+    }
+
+    if (requests.IsEmpty()) {
+      continue;
+    }
+
+    if (ringUsable && NS_FAILED(mIOUring->ReadBatch(requests))) {
+      // Don't trust the ring anymore, continue with blocking reads.
+      mIOUring = nullptr;
+      mIOUringFailed = true;
+      ringUsable = false;
+    }
+
+    if (ringUsable) {
+      glean::network::cache_io_uring_batch_size.AccumulateSingleSample(
+          requests.Length());
+    }
+
+    for (size_t j = 0; j < requests.Length(); ++j) {
+      BatchedRead& read = reads[requestIndexes[j]];
+      nsresult& rv = results[requestIndexes[j]];
+      if (ringUsable && requests[j].mResult == read.mCount) {
+        rv = NS_OK;
+        glean::network::cache_read_latency.Get("io_uring"_ns)
+            .AccumulateRawDuration(TimeStamp::Now() - read.mStartTime);
+        continue;
+      }
+
+      // Short reads and kernels without IORING_OP_READ end up here.
+      rv = ReadInternal(read.mHandle, read.mOffset, read.mBuf, read.mCount);
+      if (NS_SUCCEEDED(rv)) {
+        glean::network::cache_read_latency.Get("sync"_ns)
+            .AccumulateRawDuration(TimeStamp::Now() - read.mStartTime);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < reads.Length(); ++i) {
+    reads[i].mCallback->OnDataRead(reads[i].mHandle, reads[i].mBuf,
+                                   results[i]);
+  }
+}
+#endif
+
 // static
 nsresult CacheFileIOManager::Write(CacheFileHandle* aHandle, int64_t aOffset,
                                    const char* aBuf, int32_t aCount,
@@ -13,6 +13,7 @@
 #include "nsITimer.h"
 #include "nsCOMPtr.h"
 #include "mozilla/Atomics.h"
+#include "mozilla/Mutex.h"
 #include "mozilla/SHA1.h"
 #include "mozilla/StaticPtr.h"
 #include "mozilla/TimeStamp.h"
@@ -33,6 +34,9 @@ namespace net {
 
 class CacheFile;
 class CacheFileIOListener;
+#ifdef MOZ_CACHE_IO_URING
+class CacheFileIOUring;
+#endif
 
 #ifdef DEBUG_HANDLES
 class CacheFileHandlesEntry;
@@ -385,6 +389,15 @@ class CacheFileIOManager final : public nsITimerCallback, public nsINamed {
   void CloseHandleInternal(CacheFileHandle* aHandle);
   nsresult ReadInternal(CacheFileHandle* aHandle, int64_t aOffset, char* aBuf,
                         int32_t aCount);
+  // Makes sure aHandle has an open NSPR handle it can be read from.
+  nsresult PrepareHandleForRead(CacheFileHandle* aHandle);
+#ifdef MOZ_CACHE_IO_URING
+  nsresult DispatchBatchedRead(CacheFileHandle* aHandle, int64_t aOffset,
+                               char* aBuf, int32_t aCount,
+                               CacheFileIOListener* aCallback);
+  void FlushBatchedReads(bool aPriority);
+  bool EnsureIOUring();
+#endif
   nsresult WriteInternal(CacheFileHandle* aHandle, int64_t aOffset,
                          const char* aBuf, int32_t aCount, bool aValidate,
                          bool aTruncate);
@@ -486,6 +499,27 @@ class CacheFileIOManager final : public nsITimerCallback, public nsINamed {
   nsTArray<nsCString> mFailedTrashDirs;
   RefPtr<CacheFileContextEvictor> mContextEvictor;
   TimeStamp mLastSmartSizeTime;
+
+#ifdef MOZ_CACHE_IO_URING
+  struct BatchedRead {
+    RefPtr<CacheFileHandle> mHandle;
+    int64_t mOffset;
+    char* mBuf;
+    int32_t mCount;
+    nsCOMPtr<CacheFileIOListener> mCallback;
+    TimeStamp mStartTime;
+  };
+
+  // Reads waiting for the next io_uring submission.  Index 1 holds reads of
+  // priority handles which are flushed at the READ_PRIORITY level, index 0
+  // the rest flushed at the READ level.  A flush event is pending on the IO
+  // thread whenever the respective array is not empty.
+  Mutex mBatchedReadsLock{"CacheFileIOManager::mBatchedReadsLock"};
+  nsTArray<BatchedRead> mBatchedReads[2] MOZ_GUARDED_BY(mBatchedReadsLock);
+  // Only accessed on the IO thread.
+  UniquePtr<CacheFileIOUring> mIOUring;
+  bool mIOUringFailed{false};
+#endif
 };
 
 }  // namespace net
@@ -0,0 +1,195 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "CacheLog.h"
+#include "CacheFileIOUring.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <string.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Older kernel headers may not know the syscall numbers yet.  They are the
+// same on every architecture we build for.
+#ifndef __NR_io_uring_setup
+#  define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#  define __NR_io_uring_enter 426
+#endif
+
+namespace mozilla::net {
+
+static int IOUringSetup(unsigned aEntries, io_uring_params* aParams) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, aEntries, aParams));
+}
+
+static int IOUringEnter(int aFD, unsigned aToSubmit, unsigned aMinComplete,
+                        unsigned aFlags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, aFD, aToSubmit,
+                                  aMinComplete, aFlags, nullptr, 0));
+}
+
+// static
+UniquePtr<CacheFileIOUring> CacheFileIOUring::Create(uint32_t aEntries) {
+  UniquePtr<CacheFileIOUring> ring(new CacheFileIOUring());
+  if (!ring->Setup(aEntries)) {
+    return nullptr;
+  }
+
+  return ring;
+}
+
+bool CacheFileIOUring::Setup(uint32_t aEntries) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+
+  mRingFD = IOUringSetup(aEntries, &params);
+  if (mRingFD < 0) {
+    LOG(("CacheFileIOUring::Setup() - io_uring_setup failed [errno=%d]",
+         errno));
+    return false;
+  }
+
+  mEntries = params.sq_entries;
+
+  mSQRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  mCQRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (singleMmap) {
+    mSQRingSize = mCQRingSize = std::max(mSQRingSize, mCQRingSize);
+  }
+
+  mSQRing = mmap(nullptr, mSQRingSize, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, mRingFD, IORING_OFF_SQ_RING);
+  if (mSQRing == MAP_FAILED) {
+    mSQRing = nullptr;
+    return false;
+  }
+
+  if (singleMmap) {
+    mCQRing = mSQRing;
+  } else {
+    mCQRing = mmap(nullptr, mCQRingSize, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, mRingFD, IORING_OFF_CQ_RING);
+    if (mCQRing == MAP_FAILED) {
+      mCQRing = nullptr;
+      return false;
+    }
+  }
+
+  mSQEsSize = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = mmap(nullptr, mSQEsSize, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, mRingFD, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    return false;
+  }
+  mSQEs = static_cast<io_uring_sqe*>(sqes);
+
+  char* sq = static_cast<char*>(mSQRing);
+  mSQTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+  mSQMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+  mSQArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+  char* cq = static_cast<char*>(mCQRing);
+  mCQHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+  mCQTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+  mCQMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+  mCQEs = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+  LOG(("CacheFileIOUring::Setup() - ring created [this=%p, entries=%u]", this,
+       mEntries));
+  return true;
+}
+
+CacheFileIOUring::~CacheFileIOUring() {
+  if (mSQEs) {
+    munmap(mSQEs, mSQEsSize);
+  }
+  if (mCQRing && mCQRing != mSQRing) {
+    munmap(mCQRing, mCQRingSize);
+  }
+  if (mSQRing) {
+    munmap(mSQRing, mSQRingSize);
+  }
+  if (mRingFD >= 0) {
+    close(mRingFD);
+  }
+}
+
+nsresult CacheFileIOUring::ReadBatch(Span<Request> aRequests) {
+  while (!aRequests.IsEmpty()) {
+    size_t count = std::min<size_t>(aRequests.Length(), mEntries);
+    nsresult rv = SubmitAndWait(aRequests.To(count));
+    if (NS_FAILED(rv)) {
+      return rv;
+    }
+    aRequests = aRequests.From(count);
+  }
+
+  return NS_OK;
+}
+
+nsresult CacheFileIOUring::SubmitAndWait(Span<Request> aRequests) {
+  MOZ_ASSERT(aRequests.Length() <= mEntries);
+
+  // We are the only producer of the submission queue, so the tail doesn't
+  // need an acquire load.  The kernel only reads it after our release store.
+  unsigned tail = *mSQTail;
+  unsigned mask = *mSQMask;
+  for (size_t i = 0; i < aRequests.Length(); ++i) {
+    Request& req = aRequests[i];
+    unsigned index = tail & mask;
+
+    io_uring_sqe* sqe = &mSQEs[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = req.mFD;
+    sqe->off = static_cast<uint64_t>(req.mOffset);
+    sqe->addr = reinterpret_cast<uint64_t>(req.mBuf);
+    sqe->len = static_cast<uint32_t>(req.mCount);
+    sqe->user_data = i;
+
+    mSQArray[index] = index;
+    req.mResult = -ECANCELED;
+    ++tail;
+  }
+  __atomic_store_n(mSQTail, tail, __ATOMIC_RELEASE);
+
+  unsigned toSubmit = aRequests.Length();
+  size_t completed = 0;
+  while (completed < aRequests.Length()) {
+    int ret = IOUringEnter(mRingFD, toSubmit, 1, IORING_ENTER_GETEVENTS);
+    if (ret < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+        continue;
+      }
+      LOG(("CacheFileIOUring::SubmitAndWait() - io_uring_enter failed "
+           "[this=%p, errno=%d]",
+           this, errno));
+      return NS_ERROR_FAILURE;
+    }
+    toSubmit -= std::min<unsigned>(toSubmit, ret);
+
+    unsigned head = *mCQHead;
+    unsigned cqTail = __atomic_load_n(mCQTail, __ATOMIC_ACQUIRE);
+    unsigned cqMask = *mCQMask;
+    while (head != cqTail) {
+      io_uring_cqe* cqe = &mCQEs[head & cqMask];
+      if (cqe->user_data < aRequests.Length()) {
+        aRequests[cqe->user_data].mResult = cqe->res;
+        ++completed;
+      }
+      ++head;
+    }
+    __atomic_store_n(mCQHead, head, __ATOMIC_RELEASE);
+  }
+
+  return NS_OK;
+}
+
+}  // namespace mozilla::net
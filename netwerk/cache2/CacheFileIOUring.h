@@ -0,0 +1,78 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef CacheFileIOUring__h__
+#define CacheFileIOUring__h__
+
+#include "nsError.h"
+#include "mozilla/Span.h"
+#include "mozilla/UniquePtr.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace mozilla {
+namespace net {
+
+// A minimal io_uring submission/completion ring that lets the cache IO thread
+// keep several positional reads in flight with a single io_uring_enter()
+// call instead of one blocking PR_Seek/PR_Read pair per chunk.  Talks to the
+// kernel directly through syscalls so no liburing dependency is needed.
+//
+// Only ever used on the cache IO thread, there is no locking.
+class CacheFileIOUring final {
+ public:
+  struct Request {
+    int mFD;
+    int64_t mOffset;
+    char* mBuf;
+    int32_t mCount;
+    // Set on completion to the number of bytes read or to a negative errno.
+    int32_t mResult;
+  };
+
+  // Returns null when the kernel doesn't support io_uring or the ring could
+  // not be mapped (e.g. blocked by a seccomp policy).
+  static UniquePtr<CacheFileIOUring> Create(uint32_t aEntries);
+
+  ~CacheFileIOUring();
+
+  // How many requests can be in flight for a single submission.
+  uint32_t Capacity() const { return mEntries; }
+
+  // Submits all requests in aRequests, at most Capacity() at a time, and
+  // blocks until every one of them has completed.  A failure of a single
+  // request is reported through its mResult, a failure of the return value
+  // means the ring is unusable and no mResult can be trusted.
+  nsresult ReadBatch(Span<Request> aRequests);
+
+ private:
+  CacheFileIOUring() = default;
+
+  bool Setup(uint32_t aEntries);
+  nsresult SubmitAndWait(Span<Request> aRequests);
+
+  int mRingFD{-1};
+  uint32_t mEntries{0};
+
+  void* mSQRing{nullptr};
+  size_t mSQRingSize{0};
+  void* mCQRing{nullptr};
+  size_t mCQRingSize{0};
+  io_uring_sqe* mSQEs{nullptr};
+  size_t mSQEsSize{0};
+
+  unsigned* mSQTail{nullptr};
+  unsigned* mSQMask{nullptr};
+  unsigned* mSQArray{nullptr};
+  unsigned* mCQHead{nullptr};
+  unsigned* mCQTail{nullptr};
+  unsigned* mCQMask{nullptr};
+  io_uring_cqe* mCQEs{nullptr};
+};
+
+}  // namespace net
+}  // namespace mozilla
+
+#endif
@@ -18,13 +18,21 @@
 #include "nsIFile.h"
 #include "nsITimer.h"
 #include "mozilla/AutoRestore.h"
+#include "mozilla/Monitor.h"
 #include <algorithm>
 #include "mozilla/StaticPrefs_network.h"
 #include "mozilla/glean/NetwerkCache2Metrics.h"
 #include "mozilla/Unused.h"
 
 #define kMinUnwrittenChanges 300
+// Rewriting the index costs O(records), so on big indexes we also wait until
+// at least 1/kMinUnwrittenChangesFraction of the records changed.  That keeps
+// the amortized writeback cost per changed record constant.
+#define kMinUnwrittenChangesFraction 16
 #define kMinDumpInterval 20000  // in milliseconds
+// How many entry files BuildIndex()/UpdateIndex() collect per reader thread
+// before reading their metadata in parallel.
+#define kMetadataReadsPerThread 16
 #define kMaxBufSize 16384
 #define kIndexVersion 0x0000000A
 #define kUpdateIndexStartDelay 50000  // in milliseconds
@@ -871,81 +879,111 @@ nsresult CacheIndex::RemoveEntry(const SHA1Sum::Hash* aHash) {
     return NS_ERROR_NOT_AVAILABLE;
   }
 
-  {
-    CacheIndexEntryAutoManage entryMng(aHash, index, lock);
+  index->RemoveEntryLocked(aHash, lock);
+  index->StartUpdatingIndexIfNeeded(lock);
+  index->WriteIndexToDiskIfNeeded(lock);
 
-    CacheIndexEntry* entry = index->mIndex.GetEntry(*aHash);
-    bool entryRemoved = entry && entry->IsRemoved();
+  return NS_OK;
+}
 
-    if (index->mState == READY || index->mState == UPDATING ||
-        index->mState == BUILDING) {
-      MOZ_ASSERT(index->mPendingUpdates.Count() == 0);
+// static
+nsresult CacheIndex::RemoveEntries(
+    const nsTArray<const SHA1Sum::Hash*>& aHashes) {
+  LOG(("CacheIndex::RemoveEntries() [count=%zu]", aHashes.Length()));
 
-      if (!entry || entryRemoved) {
-        if (entryRemoved && entry->IsFresh()) {
-          // This could happen only if somebody copies files to the entries
-          // directory while FF is running.
-          LOG(
-              ("CacheIndex::RemoveEntry() - Cache file was added outside FF "
-               "process! Update is needed."));
-          index->mIndexNeedsUpdate = true;
-        } else if (index->mState == READY ||
-                   (entryRemoved && !entry->IsFresh())) {
-          // Removed non-fresh entries can be present as a result of
-          // MergeJournal()
-          LOG(
-              ("CacheIndex::RemoveEntry() - Didn't find entry that should exist"
-               ", update is needed"));
-          index->mIndexNeedsUpdate = true;
-        }
-      } else {
-        if (entry) {
-          if (!entry->IsDirty() && entry->IsFileEmpty()) {
-            index->mIndex.RemoveEntry(entry);
-            entry = nullptr;
-          } else {
-            entry->MarkRemoved();
-            entry->MarkDirty();
-            entry->MarkFresh();
-          }
-        }
-      }
-    } else {  // WRITING, READING
-      CacheIndexEntryUpdate* updated = index->mPendingUpdates.GetEntry(*aHash);
-      bool updatedRemoved = updated && updated->IsRemoved();
+  MOZ_ASSERT(CacheFileIOManager::IsOnIOThread());
 
-      if (updatedRemoved || (!updated && entryRemoved && entry->IsFresh())) {
-        // Fresh information about missing entry found. This could happen only
-        // if somebody copies files to the entries directory while FF is
-        // running.
+  StaticMutexAutoLock lock(sLock);
+
+  RefPtr<CacheIndex> index = gInstance;
+
+  if (!index) {
+    return NS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (!index->IsIndexUsable()) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+
+  for (const SHA1Sum::Hash* hash : aHashes) {
+    index->RemoveEntryLocked(hash, lock);
+  }
+
+  index->StartUpdatingIndexIfNeeded(lock);
+  index->WriteIndexToDiskIfNeeded(lock);
+
+  return NS_OK;
+}
+
+void CacheIndex::RemoveEntryLocked(const SHA1Sum::Hash* aHash,
+                                   const StaticMutexAutoLock& aProofOfLock) {
+  CacheIndexEntryAutoManage entryMng(aHash, this, aProofOfLock);
+
+  CacheIndexEntry* entry = mIndex.GetEntry(*aHash);
+  bool entryRemoved = entry && entry->IsRemoved();
+
+  if (mState == READY || mState == UPDATING || mState == BUILDING) {
+    MOZ_ASSERT(mPendingUpdates.Count() == 0);
+
+    if (!entry || entryRemoved) {
+      if (entryRemoved && entry->IsFresh()) {
+        // This could happen only if somebody copies files to the entries
+        // directory while FF is running.
         LOG(
-            ("CacheIndex::RemoveEntry() - Cache file was added outside FF "
-             "process! Update is needed."));
-        index->mIndexNeedsUpdate = true;
-      } else if (!updated && (!entry || entryRemoved)) {
-        if (index->mState == WRITING) {
-          LOG(
-              ("CacheIndex::RemoveEntry() - Didn't find entry that should exist"
-               ", update is needed"));
-          index->mIndexNeedsUpdate = true;
+            ("CacheIndex::RemoveEntryLocked() - Cache file was added outside "
+             "FF process! Update is needed."));
+        mIndexNeedsUpdate = true;
+      } else if (mState == READY || (entryRemoved && !entry->IsFresh())) {
+        // Removed non-fresh entries can be present as a result of
+        // MergeJournal()
+        LOG(
+            ("CacheIndex::RemoveEntryLocked() - Didn't find entry that should "
+             "exist, update is needed"));
+        mIndexNeedsUpdate = true;
+      }
+    } else {
+      if (entry) {
+        if (!entry->IsDirty() && entry->IsFileEmpty()) {
+          mIndex.RemoveEntry(entry);
+          entry = nullptr;
+        } else {
+          entry->MarkRemoved();
+          entry->MarkDirty();
+          entry->MarkFresh();
         }
-        // Ignore if state is READING since the index information is partial
       }
+    }
+  } else {  // WRITING, READING
+    CacheIndexEntryUpdate* updated = mPendingUpdates.GetEntry(*aHash);
+    bool updatedRemoved = updated && updated->IsRemoved();
 
-      if (!updated) {
-        updated = index->mPendingUpdates.PutEntry(*aHash);
-        updated->InitNew();
+    if (updatedRemoved || (!updated && entryRemoved && entry->IsFresh())) {
+      // Fresh information about missing entry found. This could happen only
+      // if somebody copies files to the entries directory while FF is
+      // running.
+      LOG(
+          ("CacheIndex::RemoveEntryLocked() - Cache file was added outside "
+           "FF process! Update is needed."));
+      mIndexNeedsUpdate = true;
+    } else if (!updated && (!entry || entryRemoved)) {
+      if (mState == WRITING) {
+        LOG(
+            ("CacheIndex::RemoveEntryLocked() - Didn't find entry that should "
+             "exist, update is needed"));
+        mIndexNeedsUpdate = true;
       }
+      // Ignore if state is READING since the index information is partial
+    }
 
-      updated->MarkRemoved();
-      updated->MarkDirty();
-      updated->MarkFresh();
+    if (!updated) {
+      updated = mPendingUpdates.PutEntry(*aHash);
+      updated->InitNew();
     }
-  }
-  index->StartUpdatingIndexIfNeeded(lock);
-  index->WriteIndexToDiskIfNeeded(lock);
 
-  return NS_OK;
+    updated->MarkRemoved();
+    updated->MarkDirty();
+    updated->MarkFresh();
+  }
 }
 
 // static
@@ -1689,7 +1727,10 @@ bool CacheIndex::WriteIndexToDiskIfNeeded(
     return false;
   }
 
-  if (mIndexStats.Dirty() < kMinUnwrittenChanges) {
+  uint32_t minChanges = std::max<uint32_t>(
+      kMinUnwrittenChanges,
+      mIndexStats.ActiveEntriesCount() / kMinUnwrittenChangesFraction);
+  if (mIndexStats.Dirty() < minChanges) {
     return false;
   }
 
@@ -2754,11 +2795,23 @@ void CacheIndex::BuildIndex(const StaticMutexAutoLock& aProofOfLock) {
     }
   }
 
+  nsTArray<MetadataRead> reads;
+  uint32_t batchSize =
+      std::max(1U, StaticPrefs::network_cache_index_build_threads()) *
+      kMetadataReadsPerThread;
+
   while (true) {
+    if (reads.Length() >= batchSize &&
+        !ProcessMetadataReads(reads, false, aProofOfLock)) {
+      return;
+    }
+
     if (CacheIOThread::YieldAndRerun()) {
       LOG((
           "CacheIndex::BuildIndex() - Breaking loop for higher level events."));
-      mUpdateEventPending = true;
+      if (ProcessMetadataReads(reads, false, aProofOfLock)) {
+        mUpdateEventPending = true;
+      }
       return;
     }
 
@@ -2779,7 +2832,9 @@ void CacheIndex::BuildIndex(const StaticMutexAutoLock& aProofOfLock) {
       return;
     }
     if (!file) {
-      FinishUpdate(NS_SUCCEEDED(rv), aProofOfLock);
+      if (ProcessMetadataReads(reads, false, aProofOfLock)) {
+        FinishUpdate(NS_SUCCEEDED(rv), aProofOfLock);
+      }
       return;
     }
 
@@ -2844,55 +2899,10 @@ void CacheIndex::BuildIndex(const StaticMutexAutoLock& aProofOfLock) {
 
     MOZ_ASSERT(!handle);
 
-    RefPtr<CacheFileMetadata> meta = new CacheFileMetadata();
-    int64_t size = 0;
-
-    {
-      // Do not do IO under the lock.
-      StaticMutexAutoUnlock unlock(sLock);
-      rv = meta->SyncReadMetadata(file);
-
-      if (NS_SUCCEEDED(rv)) {
-        rv = file->GetFileSize(&size);
-        if (NS_FAILED(rv)) {
-          LOG(
-              ("CacheIndex::BuildIndex() - Cannot get filesize of file that was"
-               " successfully parsed. [name=%s]",
-               leaf.get()));
-        }
-      }
-    }
-    if (mState == SHUTDOWN) {
-      return;
-    }
-
-    // Nobody could add the entry while the lock was released since we modify
-    // the index only on IO thread and this loop is executed on IO thread too.
-    entry = mIndex.GetEntry(hash);
-    MOZ_ASSERT(!entry || entry->IsRemoved());
-
-    if (NS_FAILED(rv)) {
-      LOG(
-          ("CacheIndex::BuildIndex() - CacheFileMetadata::SyncReadMetadata() "
-           "failed, removing file. [name=%s]",
-           leaf.get()));
-      file->Remove(false);
-    } else {
-      CacheIndexEntryAutoManage entryMng(&hash, this, aProofOfLock);
-      entry = mIndex.PutEntry(hash);
-      if (NS_FAILED(InitEntryFromDiskData(entry, meta, size))) {
-        LOG(
-            ("CacheIndex::BuildIndex() - CacheFile::InitEntryFromDiskData() "
-             "failed, removing file. [name=%s]",
-             leaf.get()));
-        file->Remove(false);
-        entry->MarkRemoved();
-      } else {
-        LOG(("CacheIndex::BuildIndex() - Added entry to index. [name=%s]",
-             leaf.get()));
-        entry->Log();
-      }
-    }
+    MetadataRead* read = reads.AppendElement();
+    read->mFile = file;
+    read->mLeaf = leaf;
+    memcpy(read->mHash, hash, sizeof(SHA1Sum::Hash));
   }
 
   MOZ_ASSERT_UNREACHABLE("We should never get here");
@@ -2996,12 +3006,24 @@ void CacheIndex::UpdateIndex(const StaticMutexAutoLock& aProofOfLock) {
     }
   }
 
+  nsTArray<MetadataRead> reads;
+  uint32_t batchSize =
+      std::max(1U, StaticPrefs::network_cache_index_build_threads()) *
+      kMetadataReadsPerThread;
+
   while (true) {
+    if (reads.Length() >= batchSize &&
+        !ProcessMetadataReads(reads, true, aProofOfLock)) {
+      return;
+    }
+
     if (CacheIOThread::YieldAndRerun()) {
       LOG(
           ("CacheIndex::UpdateIndex() - Breaking loop for higher level "
            "events."));
-      mUpdateEventPending = true;
+      if (ProcessMetadataReads(reads, true, aProofOfLock)) {
+        mUpdateEventPending = true;
+      }
       return;
     }
 
@@ -3021,7 +3043,9 @@ void CacheIndex::UpdateIndex(const StaticMutexAutoLock& aProofOfLock) {
       return;
     }
     if (!file) {
-      FinishUpdate(NS_SUCCEEDED(rv), aProofOfLock);
+      if (ProcessMetadataReads(reads, true, aProofOfLock)) {
+        FinishUpdate(NS_SUCCEEDED(rv), aProofOfLock);
+      }
       return;
     }
 
@@ -3118,68 +3142,183 @@ void CacheIndex::UpdateIndex(const StaticMutexAutoLock& aProofOfLock) {
       }
     }
 
-    RefPtr<CacheFileMetadata> meta = new CacheFileMetadata();
-    int64_t size = 0;
+    MetadataRead* read = reads.AppendElement();
+    read->mFile = file;
+    read->mLeaf = leaf;
+    memcpy(read->mHash, hash, sizeof(SHA1Sum::Hash));
+  }
 
-    {
-      // Do not do IO under the lock.
-      StaticMutexAutoUnlock unlock(sLock);
-      rv = meta->SyncReadMetadata(file);
+  MOZ_ASSERT_UNREACHABLE("We should never get here");
+}
 
-      if (NS_SUCCEEDED(rv)) {
-        rv = file->GetFileSize(&size);
-        if (NS_FAILED(rv)) {
-          LOG(
-              ("CacheIndex::UpdateIndex() - Cannot get filesize of file that "
-               "was successfully parsed. [name=%s]",
-               leaf.get()));
-        }
+// static
+void CacheIndex::ReadMetadataInParallel(nsTArray<MetadataRead>& aReads,
+                                        uint32_t aThreads) {
+  auto readOne = [](MetadataRead& aRead) {
+    aRead.mMetadata = new CacheFileMetadata();
+    aRead.mResult = aRead.mMetadata->SyncReadMetadata(aRead.mFile);
+    if (NS_SUCCEEDED(aRead.mResult)) {
+      aRead.mResult = aRead.mFile->GetFileSize(&aRead.mSize);
+      if (NS_FAILED(aRead.mResult)) {
+        LOG(
+            ("CacheIndex::ReadMetadataInParallel() - Cannot get filesize of "
+             "file that was successfully parsed. [name=%s]",
+             aRead.mLeaf.get()));
       }
     }
-    if (mState == SHUTDOWN) {
-      return;
+  };
+
+  uint32_t tasks = std::min<size_t>(aThreads, aReads.Length());
+  if (tasks <= 1) {
+    for (auto& read : aReads) {
+      readOne(read);
+    }
+    return;
+  }
+
+  // Shared with the background tasks, which can outlive this stack frame by
+  // the time it takes to release the monitor.
+  struct State {
+    NS_INLINE_DECL_THREADSAFE_REFCOUNTING(State)
+
+    explicit State(nsTArray<MetadataRead>& aReads)
+        : mReads(aReads), mRunning(0) {}
+
+    void Run(const std::function<void(MetadataRead&)>& aReadOne) {
+      for (size_t i; (i = mNext++) < mReads.Length();) {
+        aReadOne(mReads[i]);
+      }
+
+      MonitorAutoLock lock(mMonitor);
+      if (--mRunning == 0) {
+        lock.Notify();
+      }
+    }
+
+    nsTArray<MetadataRead>& mReads;
+    Atomic<size_t> mNext{0};
+    Monitor mMonitor{"CacheIndex::ReadMetadataInParallel"};
+    uint32_t mRunning MOZ_GUARDED_BY(mMonitor);
+
+   private:
+    ~State() = default;
+  };
+
+  RefPtr<State> state = new State(aReads);
+  {
+    MonitorAutoLock lock(state->mMonitor);
+    state->mRunning = tasks;
+  }
+
+  for (uint32_t i = 1; i < tasks; ++i) {
+    nsresult rv = NS_DispatchBackgroundTask(
+        NS_NewRunnableFunction("CacheIndex::ReadMetadataInParallel",
+                               [state, readOne]() { state->Run(readOne); }),
+        NS_DISPATCH_EVENT_MAY_BLOCK);
+    if (NS_FAILED(rv)) {
+      MonitorAutoLock lock(state->mMonitor);
+      --state->mRunning;
     }
+  }
 
+  state->Run(readOne);
+
+  MonitorAutoLock lock(state->mMonitor);
+  while (state->mRunning) {
+    lock.Wait();
+  }
+}
+
+bool CacheIndex::ProcessMetadataReads(nsTArray<MetadataRead>& aReads,
+                                      bool aUpdate,
+                                      const StaticMutexAutoLock& aProofOfLock) {
+  sLock.AssertCurrentThreadOwns();
+
+  if (aReads.IsEmpty()) {
+    return true;
+  }
+
+  {
+    // Do not do IO under the lock.
+    StaticMutexAutoUnlock unlock(sLock);
+    ReadMetadataInParallel(aReads,
+                           StaticPrefs::network_cache_index_build_threads());
+  }
+  if (mState == SHUTDOWN) {
+    return false;
+  }
+
+  const char* caller = aUpdate ? "UpdateIndex" : "BuildIndex";
+  for (auto& read : aReads) {
     // Nobody could add the entry while the lock was released since we modify
     // the index only on IO thread and this loop is executed on IO thread too.
-    entry = mIndex.GetEntry(hash);
-    MOZ_ASSERT(!entry || !entry->IsFresh());
+    CacheIndexEntry* entry = mIndex.GetEntry(read.mHash);
+    MOZ_ASSERT(!entry || (aUpdate ? !entry->IsFresh() : entry->IsRemoved()));
 
-    CacheIndexEntryAutoManage entryMng(&hash, this, aProofOfLock);
+    if (aUpdate) {
+      // An update also needs to mark entries that are no longer valid.
+      CacheIndexEntryAutoManage entryMng(&read.mHash, this, aProofOfLock);
 
-    if (NS_FAILED(rv)) {
-      LOG(
-          ("CacheIndex::UpdateIndex() - CacheFileMetadata::SyncReadMetadata() "
-           "failed, removing file. [name=%s]",
-           leaf.get()));
-    } else {
-      entry = mIndex.PutEntry(hash);
-      rv = InitEntryFromDiskData(entry, meta, size);
+      nsresult rv = read.mResult;
       if (NS_FAILED(rv)) {
         LOG(
-            ("CacheIndex::UpdateIndex() - CacheIndex::InitEntryFromDiskData "
+            ("CacheIndex::%s() - CacheFileMetadata::SyncReadMetadata() "
              "failed, removing file. [name=%s]",
-             leaf.get()));
+             caller, read.mLeaf.get()));
+      } else {
+        entry = mIndex.PutEntry(read.mHash);
+        rv = InitEntryFromDiskData(entry, read.mMetadata, read.mSize);
+        if (NS_FAILED(rv)) {
+          LOG(
+              ("CacheIndex::%s() - CacheIndex::InitEntryFromDiskData "
+               "failed, removing file. [name=%s]",
+               caller, read.mLeaf.get()));
+        }
       }
+
+      if (NS_FAILED(rv)) {
+        read.mFile->Remove(false);
+        if (entry) {
+          entry->MarkRemoved();
+          entry->MarkFresh();
+          entry->MarkDirty();
+        }
+      } else {
+        LOG(
+            ("CacheIndex::%s() - Added/updated entry to/in index. "
+             "[name=%s]",
+             caller, read.mLeaf.get()));
+        entry->Log();
+      }
+      continue;
     }
 
-    if (NS_FAILED(rv)) {
-      file->Remove(false);
-      if (entry) {
+    if (NS_FAILED(read.mResult)) {
+      LOG(
+          ("CacheIndex::%s() - CacheFileMetadata::SyncReadMetadata() "
+           "failed, removing file. [name=%s]",
+           caller, read.mLeaf.get()));
+      read.mFile->Remove(false);
+    } else {
+      CacheIndexEntryAutoManage entryMng(&read.mHash, this, aProofOfLock);
+      entry = mIndex.PutEntry(read.mHash);
+      if (NS_FAILED(InitEntryFromDiskData(entry, read.mMetadata, read.mSize))) {
+        LOG(
+            ("CacheIndex::%s() - CacheFile::InitEntryFromDiskData() "
+             "failed, removing file. [name=%s]",
+             caller, read.mLeaf.get()));
+        read.mFile->Remove(false);
         entry->MarkRemoved();
-        entry->MarkFresh();
-        entry->MarkDirty();
+      } else {
+        LOG(("CacheIndex::%s() - Added entry to index. [name=%s]", caller,
+             read.mLeaf.get()));
+        entry->Log();
       }
-    } else {
-      LOG(
-          ("CacheIndex::UpdateIndex() - Added/updated entry to/in index. "
-           "[name=%s]",
-           leaf.get()));
-      entry->Log();
     }
   }
 
-  MOZ_ASSERT_UNREACHABLE("We should never get here");
+  aReads.Clear();
+  return true;
 }
 
 void CacheIndex::FinishUpdate(bool aSucceeded,
@@ -730,6 +730,10 @@ class CacheIndex final : public CacheFileIOListener, public nsIRunnable {
   // Remove entry from index. The entry should be present in index.
   static nsresult RemoveEntry(const SHA1Sum::Hash* aHash);
 
+  // Same as RemoveEntry(), but removes all given entries under a single lock
+  // and checks whether the index needs to be written only once.
+  static nsresult RemoveEntries(const nsTArray<const SHA1Sum::Hash*>& aHashes);
+
   // Update some information in entry. The entry MUST be present in index and
   // MUST be initialized. Call to AddEntry() or EnsureEntryExists() and to
   // InitEntry() must precede the call to this method.
@@ -811,6 +815,23 @@ class CacheIndex final : public CacheFileIOListener, public nsIRunnable {
   static size_t SizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf);
   static size_t SizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf);
 
+  // A metadata read of a single entry file found by BuildIndex() or
+  // UpdateIndex().
+  struct MetadataRead {
+    nsCOMPtr<nsIFile> mFile;
+    nsCString mLeaf;
+    SHA1Sum::Hash mHash;
+    RefPtr<CacheFileMetadata> mMetadata;
+    int64_t mSize = 0;
+    nsresult mResult = NS_OK;
+  };
+
+  // Synchronously reads the metadata of all files in aReads, spread across
+  // aThreads background tasks with the calling thread taking part too.
+  // Returns once every read has finished.  Public for benchmarking only.
+  static void ReadMetadataInParallel(nsTArray<MetadataRead>& aReads,
+                                     uint32_t aThreads);
+
  private:
   friend class CacheIndexEntryAutoManage;
   friend class FileOpenHelper;
@@ -856,6 +877,11 @@ class CacheIndex final : public CacheFileIOListener, public nsIRunnable {
                               const uint8_t* aContentType,
                               const uint32_t* aSize);
 
+  // Removes a single entry, shared by RemoveEntry() and RemoveEntries().
+  void RemoveEntryLocked(const SHA1Sum::Hash* aHash,
+                         const StaticMutexAutoLock& aProofOfLock)
+      MOZ_REQUIRES(sLock);
+
   // Merge all pending operations from mPendingUpdates into mIndex.
   void ProcessPendingOperations(const StaticMutexAutoLock& aProofOfLock)
       MOZ_REQUIRES(sLock);
@@ -990,6 +1016,12 @@ class CacheIndex final : public CacheFileIOListener, public nsIRunnable {
   // during this session and theirs last modified time is newer than timestamp
   // in the index header. Parses the files and adds the entries to the index.
   void UpdateIndex(const StaticMutexAutoLock& aProofOfLock) MOZ_REQUIRES(sLock);
+  // Reads the metadata of the files collected in aReads by BuildIndex() or
+  // UpdateIndex() without holding the lock and adds the entries to the index.
+  // Returns false when the index was shut down in the meantime.
+  bool ProcessMetadataReads(nsTArray<MetadataRead>& aReads, bool aUpdate,
+                            const StaticMutexAutoLock& aProofOfLock)
+      MOZ_REQUIRES(sLock);
   // Finalizes update or build process.
   void FinishUpdate(bool aSucceeded, const StaticMutexAutoLock& aProofOfLock)
       MOZ_REQUIRES(sLock);
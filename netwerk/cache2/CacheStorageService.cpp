@@ -1505,6 +1505,30 @@ Result<size_t, nsresult> CacheStorageService::MemoryPool::PurgeByFrecency(
   }
   mayPurgeSorted.Sort();
 
+  if (mType == EType::MEMORY &&
+      StaticPrefs::network_cache_memory_compression_enabled()) {
+    // Compressing the coldest entries first may already free enough memory
+    // to keep all of them.  Entries compressed earlier are skipped cheaply.
+    size_t numCompressed = 0;
+    for (auto& checkCompress : mayPurgeSorted) {
+      if (mMemorySize <= memoryLimit) {
+        LOG(("MemoryPool::PurgeByFrecency done by compressing"));
+        return 0;
+      }
+
+      if (checkCompress.mEntry->Compress()) {
+        numCompressed++;
+        LOG(("  compressed, entry=%p, frecency=%1.10f",
+             checkCompress.mEntry.get(), checkCompress.mFrecency));
+      }
+
+      if (numCompressed >= minprogress && CacheIOThread::YieldAndRerun()) {
+        LOG(("MemoryPool::PurgeByFrecency interrupted while compressing"));
+        return 0;
+      }
+    }
+  }
+
   size_t numPurged = 0;
 
   for (auto& checkPurge : mayPurgeSorted) {
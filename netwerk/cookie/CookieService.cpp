@@ -411,16 +411,21 @@ CookieService::GetCookieStringFromHttp(nsIURI* aHostURI, nsIChannel* aChannel,
   }
 
   AutoTArray<RefPtr<Cookie>, 8> foundCookieList;
+  nsCString cachedHeader = VoidCString();
   GetCookiesForURI(
       aHostURI, aChannel, result.contains(ThirdPartyAnalysis::IsForeign),
       result.contains(ThirdPartyAnalysis::IsThirdPartyTrackingResource),
       result.contains(ThirdPartyAnalysis::IsThirdPartySocialTrackingResource),
       result.contains(ThirdPartyAnalysis::IsStorageAccessPermissionGranted),
       rejectedReason, isSafeTopLevelNav, isSameSiteForeign,
-      hadCrossSiteRedirects, true, false, originAttributesList,
-      foundCookieList);
+      hadCrossSiteRedirects, true, false, originAttributesList, foundCookieList,
+      &cachedHeader);
 
-  CookieCommons::ComposeCookieString(foundCookieList, aCookieString);
+  if (!cachedHeader.IsVoid()) {
+    aCookieString.Assign(cachedHeader);
+  } else {
+    CookieCommons::ComposeCookieString(foundCookieList, aCookieString);
+  }
 
   if (!aCookieString.IsEmpty()) {
     COOKIE_LOGSUCCESS(GET_COOKIE, aHostURI, aCookieString, nullptr, false);
@@ -914,7 +919,7 @@ void CookieService::GetCookiesForURI(
     bool aHadCrossSiteRedirects, bool aHttpBound,
     bool aAllowSecureCookiesToInsecureOrigin,
     const nsTArray<OriginAttributes>& aOriginAttrsList,
-    nsTArray<RefPtr<Cookie>>& aCookieList) {
+    nsTArray<RefPtr<Cookie>>& aCookieList, nsACString* aCookieHeader) {
   NS_ASSERTION(aHostURI, "null host!");
 
   if (!CookieCommons::IsSchemeSupported(aHostURI)) {
@@ -933,6 +938,15 @@ void CookieService::GetCookiesForURI(
   nsCOMPtr<nsILoadInfo> loadInfo = aChannel ? aChannel->LoadInfo() : nullptr;
   const bool on3pcdException = loadInfo && loadInfo->GetIsOn3PCBExceptionList();
 
+  // Only the partitioning and SameSite checks below depend on the channel.
+  // Without them the cookies of a request only depend on its host and path,
+  // which the storage caches.
+  const bool useHeaderCache =
+      StaticPrefs::network_cookie_header_cache_enabled() && !aIsForeign &&
+      !(aHttpBound && aIsSameSiteForeign);
+  const CookieEntry::HeaderCacheEntry* cachedList = nullptr;
+  uint32_t listCount = 0;
+
   for (const auto& attrs : aOriginAttrsList) {
     CookieStorage* storage = PickStorage(attrs);
 
@@ -1014,6 +1028,30 @@ void CookieService::GetCookiesForURI(
     int64_t currentTime = currentTimeInUsec / PR_USEC_PER_SEC;
     bool stale = false;
 
+    if (useHeaderCache) {
+      const CookieEntry::HeaderCacheEntry* cached =
+          storage->GetCookiesForRequest(
+              baseDomain, attrs, hostFromURI, pathFromURI,
+              potentiallyTrustworthy || aAllowSecureCookiesToInsecureOrigin,
+              aHttpBound, currentTime);
+      if (!cached || cached->mCookies.IsEmpty()) {
+        continue;
+      }
+
+      aCookieList.AppendElements(cached->mCookies);
+      cachedList = cached->mHeader.IsEmpty() ? nullptr : cached;
+      ++listCount;
+      for (Cookie* cookie : cached->mCookies) {
+        if (cookie->IsStale()) {
+          stale = true;
+        }
+      }
+      if (stale) {
+        storage->StaleCookies(aCookieList, currentTimeInUsec);
+      }
+      continue;
+    }
+
     nsTArray<RefPtr<Cookie>> cookies;
     storage->GetCookiesFromHost(baseDomain, attrs, cookies);
     if (cookies.IsEmpty()) {
@@ -1118,6 +1156,14 @@ void CookieService::GetCookiesForURI(
   // some.
   NotifyAccepted(aChannel);
 
+  // A single cached list is already sorted and composed.
+  if (cachedList && listCount == 1) {
+    if (aCookieHeader) {
+      aCookieHeader->Assign(cachedList->mHeader);
+    }
+    return;
+  }
+
   // return cookies in order of path length; longest to shortest.
   // this is required per RFC2109.  if cookies match in length,
   // then sort by creation time (see bug 236772).
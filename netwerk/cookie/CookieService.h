@@ -81,6 +81,9 @@ class CookieService final : public nsICookieService,
       const int aNumOfCookies, const OriginAttributes& aOriginAttrs,
       uint32_t* aRejectedReason);
 
+  // When aCookieHeader is given and aCookieList came from a single cached
+  // list, aCookieHeader is set to the header composed from it, sharing the
+  // cached buffer.  Otherwise aCookieHeader is left untouched.
   void GetCookiesForURI(nsIURI* aHostURI, nsIChannel* aChannel, bool aIsForeign,
                         bool aIsThirdPartyTrackingResource,
                         bool aIsThirdPartySocialTrackingResource,
@@ -90,7 +93,8 @@ class CookieService final : public nsICookieService,
                         bool aHttpBound,
                         bool aAllowSecureCookiesToInsecureOrigin,
                         const nsTArray<OriginAttributes>& aOriginAttrsList,
-                        nsTArray<RefPtr<Cookie>>& aCookieList);
+                        nsTArray<RefPtr<Cookie>>& aCookieList,
+                        nsACString* aCookieHeader = nullptr);
 
   /**
    * This method is a helper that allows calling nsICookieManager::Remove()
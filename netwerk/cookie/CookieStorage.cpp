@@ -117,6 +117,15 @@ size_t CookieEntry::SizeOfExcludingThis(MallocSizeOf aMallocSizeOf) const {
     amount += mCookies[i]->SizeOfIncludingThis(aMallocSizeOf);
   }
 
+  amount += mHeaderCache.ShallowSizeOfExcludingThis(aMallocSizeOf);
+  for (const HeaderCacheEntry& cached : mHeaderCache) {
+    amount += cached.mHost.SizeOfExcludingThisIfUnshared(aMallocSizeOf);
+    amount += cached.mPathPrefix.SizeOfExcludingThisIfUnshared(aMallocSizeOf);
+    amount += cached.mCookies.ShallowSizeOfExcludingThis(aMallocSizeOf);
+    amount += cached.mHeader.SizeOfExcludingThisIfUnshared(aMallocSizeOf);
+  }
+  amount += mCookiePaths.ShallowSizeOfExcludingThis(aMallocSizeOf);
+
   return amount;
 }
 
@@ -124,6 +133,18 @@ bool CookieEntry::IsPartitioned() const {
   return !mOriginAttributes.mPartitionKey.IsEmpty();
 }
 
+const nsTArray<nsCString>& CookieEntry::CookiePaths() {
+  if (!mCookiePathsValid) {
+    for (const RefPtr<Cookie>& cookie : mCookies) {
+      if (!mCookiePaths.Contains(cookie->Path())) {
+        mCookiePaths.AppendElement(cookie->Path());
+      }
+    }
+    mCookiePathsValid = true;
+  }
+  return mCookiePaths;
+}
+
 // ---------------------------------------------------------------------------
 // CookieStorage
 
@@ -292,6 +313,70 @@ void CookieStorage::GetCookiesFromHost(
   aCookies = entry->GetCookies().Clone();
 }
 
+// Per base domain, enough for the hosts and paths of a typical site.
+static const uint32_t kMaxHeaderCacheEntries = 8;
+
+const CookieEntry::HeaderCacheEntry* CookieStorage::GetCookiesForRequest(
+    const nsACString& aBaseDomain, const OriginAttributes& aOriginAttributes,
+    const nsACString& aHost, const nsACString& aPath, bool aSecure,
+    bool aHttpBound, int64_t aCurrentTime) {
+  CookieEntry* entry =
+      mHostTable.GetEntry(CookieKey(aBaseDomain, aOriginAttributes));
+  if (!entry) {
+    return nullptr;
+  }
+
+  // The cookie paths matching aPath are all prefixes of each other, so the
+  // longest one decides which cookies match.
+  const nsCString* pathPrefix = &EmptyCString();
+  for (const nsCString& path : entry->CookiePaths()) {
+    if (path.Length() > pathPrefix->Length() &&
+        CookieCommons::PathMatches(path, aPath)) {
+      pathPrefix = &path;
+    }
+  }
+
+  nsTArray<CookieEntry::HeaderCacheEntry>& cache = entry->HeaderCache();
+  for (CookieEntry::IndexType i = 0; i < cache.Length(); ++i) {
+    CookieEntry::HeaderCacheEntry& cached = cache[i];
+    if (cached.mSecure != aSecure || cached.mHttpBound != aHttpBound ||
+        !cached.mPathPrefix.Equals(*pathPrefix) ||
+        !cached.mHost.Equals(aHost)) {
+      continue;
+    }
+    if (cached.mValidUntil > aCurrentTime) {
+      return &cached;
+    }
+    cache.RemoveElementAt(i);
+    break;
+  }
+
+  CookieEntry::HeaderCacheEntry fresh{nsCString(aHost), *pathPrefix, aSecure,
+                                      aHttpBound, INT64_MAX};
+  if (!pathPrefix->IsEmpty()) {
+    for (Cookie* cookie : entry->GetCookies()) {
+      if (!CookieCommons::DomainMatches(cookie, aHost) ||
+          (cookie->IsSecure() && !aSecure) ||
+          (cookie->IsHttpOnly() && !aHttpBound) ||
+          !CookieCommons::PathMatches(cookie, aPath) ||
+          cookie->Expiry() <= aCurrentTime) {
+        continue;
+      }
+      fresh.mCookies.AppendElement(cookie);
+      if (cookie->Expiry() < fresh.mValidUntil) {
+        fresh.mValidUntil = cookie->Expiry();
+      }
+    }
+    fresh.mCookies.Sort(CompareCookiesForSending());
+    CookieCommons::ComposeCookieString(fresh.mCookies, fresh.mHeader);
+  }
+
+  if (cache.Length() >= kMaxHeaderCacheEntries) {
+    cache.RemoveElementAt(0);
+  }
+  return cache.AppendElement(std::move(fresh));
+}
+
 void CookieStorage::GetCookiesWithOriginAttributes(
     const OriginAttributesPattern& aPattern, const nsACString& aBaseDomain,
     bool aSorted, nsTArray<RefPtr<nsICookie>>& aResult) {
@@ -900,6 +985,7 @@ void CookieStorage::AddCookieToList(const nsACString& aBaseDomain,
   NS_ASSERTION(entry, "can't insert element into a null entry!");
 
   entry->GetCookies().AppendElement(aCookie);
+  entry->InvalidateHeaderCache();
   ++mCookieCount;
 
   // keep track of the oldest cookie, for when it comes time to purge
@@ -1096,6 +1182,7 @@ void CookieStorage::RemoveCookieFromListInternal(const CookieListIter& aIter) {
   } else {
     // just remove the element from the list
     aIter.entry->GetCookies().RemoveElementAt(aIter.index);
+    aIter.entry->InvalidateHeaderCache();
   }
 
   --mCookieCount;
@@ -34,6 +34,23 @@ class CookieEntry : public CookieKey {
   using ArrayType = nsTArray<RefPtr<Cookie>>;
   using IndexType = ArrayType::index_type;
 
+  // The cookies a same-site, first-party request to mHost whose path
+  // path-matches mPathPrefix sends, sorted for sending, and the header
+  // composed from them.  See CookieStorage::GetCookiesForRequest().
+  struct HeaderCacheEntry {
+    nsCString mHost;
+    // The longest cookie path of the entry matching the request path, every
+    // request path with the same one matches the same cookies.  Empty when
+    // no cookie path matches.
+    nsCString mPathPrefix;
+    bool mSecure;
+    bool mHttpBound;
+    // The earliest expiry of mCookies, in seconds.
+    int64_t mValidUntil;
+    ArrayType mCookies;
+    nsCString mHeader;
+  };
+
   explicit CookieEntry(KeyTypePointer aKey) : CookieKey(aKey) {}
 
   CookieEntry(const CookieEntry& toCopy) {
@@ -44,15 +61,29 @@ class CookieEntry : public CookieKey {
 
   ~CookieEntry() = default;
 
+  // Callers that change the list must call InvalidateHeaderCache().
   inline ArrayType& GetCookies() { return mCookies; }
   inline const ArrayType& GetCookies() const { return mCookies; }
 
+  inline nsTArray<HeaderCacheEntry>& HeaderCache() { return mHeaderCache; }
+  // The distinct paths of mCookies.
+  const nsTArray<nsCString>& CookiePaths();
+  void InvalidateHeaderCache() {
+    mHeaderCache.Clear();
+    mCookiePaths.Clear();
+    mCookiePathsValid = false;
+  }
+
   size_t SizeOfExcludingThis(MallocSizeOf aMallocSizeOf) const;
 
   bool IsPartitioned() const;
 
  private:
   ArrayType mCookies;
+
+  nsTArray<HeaderCacheEntry> mHeaderCache;
+  nsTArray<nsCString> mCookiePaths;
+  bool mCookiePathsValid{false};
 };
 
 // stores the CookieEntry entryclass and an index into the cookie array within
@@ -102,6 +133,19 @@ class CookieStorage : public nsIObserver, public nsSupportsWeakReference {
                           const OriginAttributes& aOriginAttributes,
                           nsTArray<RefPtr<Cookie>>& aCookies);
 
+  // Returns the cookies of aBaseDomain a request to aHost and aPath sends,
+  // sorted for sending, along with the header composed from them.  Only the
+  // domain, path, secure, httpOnly and expiry checks are done, so this is only
+  // for requests whose cookies don't depend on the channel, i.e. first-party
+  // and same-site ones.  Computed once per host and cookie path and reused
+  // until the cookies of aBaseDomain change or one of them expires.  Returns
+  // null when aBaseDomain has no cookies.  The result is only valid until the
+  // next change to the storage.
+  const CookieEntry::HeaderCacheEntry* GetCookiesForRequest(
+      const nsACString& aBaseDomain, const OriginAttributes& aOriginAttributes,
+      const nsACString& aHost, const nsACString& aPath, bool aSecure,
+      bool aHttpBound, int64_t aCurrentTime);
+
   void GetCookiesWithOriginAttributes(const OriginAttributesPattern& aPattern,
                                       const nsACString& aBaseDomain,
                                       bool aSorted,
@@ -518,7 +518,39 @@ nsresult TRRService::DispatchTRRRequestInternal(TRR* aTrrRequest,
   }
 
   RefPtr<TRR> trr = aTrrRequest;
-  return thread->Dispatch(trr.forget());
+  // When the caller already holds mLock we can't batch.
+  if (!aWithLock || !StaticPrefs::network_trr_batch_requests()) {
+    return thread->Dispatch(trr.forget());
+  }
+
+  MutexAutoLock lock(mLock);
+  mBatchedRequests.AppendElement(trr);
+  if (mBatchedRequests.Length() > 1) {
+    return NS_OK;
+  }
+
+  // Dispatched with the lock held so that a request batched by another
+  // thread in the meantime can't be left without a runnable.
+  nsresult rv = thread->Dispatch(
+      NewRunnableMethod("TRRService::SendBatchedRequests", this,
+                        &TRRService::SendBatchedRequests));
+  if (NS_FAILED(rv)) {
+    mBatchedRequests.Clear();
+  }
+  return rv;
+}
+
+void TRRService::SendBatchedRequests() {
+  nsTArray<RefPtr<TRR>> requests;
+  {
+    MutexAutoLock lock(mLock);
+    requests = std::move(mBatchedRequests);
+  }
+
+  LOG(("TRRService::SendBatchedRequests %zu requests", requests.Length()));
+  for (const auto& trr : requests) {
+    trr->Run();
+  }
 }
 
 already_AddRefed<nsIThread> TRRService::MainThreadOrTRRThread(bool aWithLock) {
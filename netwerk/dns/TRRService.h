@@ -128,6 +128,8 @@ class TRRService : public TRRServiceBase,
   void RebuildSuffixList(nsTArray<nsCString>&& aSuffixList);
 
   nsresult DispatchTRRRequestInternal(TRR* aTrrRequest, bool aWithLock);
+  // Runs the requests collected in mBatchedRequests, on the TRR thread.
+  void SendBatchedRequests();
   already_AddRefed<nsIThread> TRRThread_locked();
   already_AddRefed<nsIThread> MainThreadOrTRRThread(bool aWithLock = true);
 
@@ -146,6 +148,10 @@ class TRRService : public TRRServiceBase,
   nsCString mPrivateCred;  // main thread only
   nsCString mConfirmationNS MOZ_GUARDED_BY(mLock){"example.com"_ns};
   nsCString mBootstrapAddr MOZ_GUARDED_BY(mLock);
+  // Requests dispatched while a SendBatchedRequests() runnable is already
+  // waiting on the TRR thread, so a burst of lookups opens its channels in a
+  // single event and they go out together on the DoH connection.
+  nsTArray<RefPtr<TRR>> mBatchedRequests MOZ_GUARDED_BY(mLock);
 
   Atomic<bool, Relaxed> mCaptiveIsPassed{
       false};  // set when captive portal check is passed
@@ -83,7 +83,10 @@ NS_IMPL_ISUPPORTS0(nsHostRecord)
 nsHostRecord::nsHostRecord(const nsHostKey& key)
     : nsHostKey(key), mTRRQuery("nsHostRecord.mTRRQuery") {}
 
-void nsHostRecord::Invalidate() { mDoomed = true; }
+void nsHostRecord::Invalidate() {
+  mDoomed = true;
+  ++mResultGeneration;
+}
 
 void nsHostRecord::Cancel() {
   RefPtr<TRRQuery> query;
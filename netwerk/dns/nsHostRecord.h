@@ -236,6 +236,11 @@ class nsHostRecord : public mozilla::LinkedListElement<RefPtr<nsHostRecord>>,
   // Explicitly expired
   bool mDoomed = false;
 
+  // Bumped whenever the result of the record changes or the record is
+  // invalidated, so nsHostResolver's hit cache can tell whether the copy it
+  // holds is still current without taking nsHostResolver::mLock.
+  mozilla::Atomic<uint32_t, mozilla::ReleaseAcquire> mResultGeneration{0};
+
   // Whether this is resolved by TRR successfully or not.
   bool mTRRSuccess = false;
 
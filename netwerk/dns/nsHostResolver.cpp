@@ -270,6 +270,8 @@ void nsHostResolver::ClearPendingQueue(
 // right now, so we need to mark them to get re-resolved on completion!
 
 void nsHostResolver::FlushCache(bool aTrrToo) {
+  ClearHitCache();
+
   MutexAutoLock lock(mLock);
 
   mQueue.FlushEvictionQ(mRecordDB, lock);
@@ -332,6 +334,7 @@ void nsHostResolver::Shutdown() {
     }
     // empty host database
     mRecordDB.Clear();
+    ClearHitCache();
 
     mNCS = nullptr;
   }
@@ -511,6 +514,23 @@ nsresult nsHostResolver::ResolveHost(const nsACString& aHost,
     return NS_ERROR_UNKNOWN_HOST;
   }
 
+  // The key as the caller asked for it, before any of the adjustments below.
+  // Only used for the hit cache.
+  nsHostKey hitCacheKey(host, aTrrServer, type, flags, af,
+                        aOriginAttributes.IsPrivateBrowsing(), originSuffix);
+  bool useHitCache =
+      StaticPrefs::network_dns_hit_cache_enabled() && IS_ADDR_TYPE(type) &&
+      !(flags & (nsIDNSService::RESOLVE_BYPASS_CACHE |
+                 nsIDNSService::RESOLVE_REFRESH_CACHE));
+  if (useHitCache) {
+    if (RefPtr<nsHostRecord> rec = LookupHitCache(hitCacheKey)) {
+      LOG(("  Using hit cache record for host [%s].\n", host.get()));
+      glean::dns::lookup_method.AccumulateSingleSample(METHOD_HIT);
+      aCallback->OnResolveHostComplete(this, rec, NS_OK);
+      return NS_OK;
+    }
+  }
+
   RefPtr<nsResolveHostCallback> callback(aCallback);
   // if result is set inside the lock, then we need to issue the
   // callback before returning.
@@ -593,6 +613,9 @@ nsresult nsHostResolver::ResolveHost(const nsACString& aHost,
     if (!(flags & nsIDNSService::RESOLVE_BYPASS_CACHE) &&
         rec->HasUsableResult(TimeStamp::NowLoRes(), flags)) {
       result = FromCache(rec, host, type, status, lock);
+      if (useHitCache && addrRec && NS_SUCCEEDED(status)) {
+        MaybeAddToHitCache(hitCacheKey, rec);
+      }
     } else if (addrRec && addrRec->addr) {
       // if the host name is an IP address literal and has been
       // parsed, go ahead and use it.
@@ -698,6 +721,48 @@ nsresult nsHostResolver::ResolveHost(const nsACString& aHost,
   return rv;
 }
 
+already_AddRefed<nsHostRecord> nsHostResolver::LookupHitCache(
+    const nsHostKey& aKey) {
+  HitCacheShard& shard = HitCacheShardFor(aKey);
+  RefPtr<nsHostRecord> rec;
+  {
+    AutoReadLock lock(shard.mLock);
+    auto entry = shard.mEntries.Lookup(aKey);
+    if (!entry || entry->mGeneration != entry->mRecord->mResultGeneration ||
+        TimeStamp::NowLoRes() >= entry->mGraceStart) {
+      return nullptr;
+    }
+    rec = entry->mRecord;
+  }
+  return rec.forget();
+}
+
+void nsHostResolver::MaybeAddToHitCache(const nsHostKey& aKey,
+                                        nsHostRecord* aRec) {
+  // A record in its grace period is being renewed, the next hit has to go
+  // through mRecordDB to pick up the new result.
+  if (aRec->negative ||
+      aRec->CheckExpiration(TimeStamp::NowLoRes()) != nsHostRecord::EXP_VALID) {
+    return;
+  }
+
+  HitCacheShard& shard = HitCacheShardFor(aKey);
+  AutoWriteLock lock(shard.mLock);
+  if (shard.mEntries.Count() >= kHitCacheShardCapacity &&
+      !shard.mEntries.Contains(aKey)) {
+    shard.mEntries.Clear();
+  }
+  shard.mEntries.InsertOrUpdate(
+      aKey, HitCacheEntry{aRec, aRec->mResultGeneration, aRec->mGraceStart});
+}
+
+void nsHostResolver::ClearHitCache() {
+  for (auto& shard : mHitCache) {
+    AutoWriteLock lock(shard.mLock);
+    shard.mEntries.Clear();
+  }
+}
+
 already_AddRefed<nsHostRecord> nsHostResolver::FromCache(
     nsHostRecord* aRec, const nsACString& aHost, uint16_t aType,
     nsresult& aStatus, const MutexAutoLock& aLock) {
@@ -1517,6 +1582,7 @@ nsHostResolver::LookupStatus nsHostResolver::CompleteLookupLocked(
 
   MOZ_ASSERT(addrRec->mResolving);
   addrRec->mResolving--;
+  ++addrRec->mResultGeneration;
   LOG((
       "nsHostResolver::CompleteLookup %s %p %X resolver=%d stillResolving=%d\n",
       addrRec->host.get(), aNewRRSet, (unsigned int)status, (int)type,
@@ -18,11 +18,14 @@
 #include "HostRecordQueue.h"
 #include "mozilla/net/DNS.h"
 #include "mozilla/net/DashboardTypes.h"
+#include "mozilla/Array.h"
 #include "mozilla/Atomics.h"
+#include "mozilla/RWLock.h"
 #include "mozilla/TimeStamp.h"
 #include "mozilla/UniquePtr.h"
 #include "nsHostRecord.h"
 #include "nsRefPtrHashtable.h"
+#include "nsTHashMap.h"
 #include "nsIThreadPool.h"
 #include "mozilla/net/NetworkConnectivityService.h"
 #include "mozilla/net/DNSByTypeRecord.h"
@@ -299,6 +302,38 @@ class nsHostResolver : public nsISupports, public AHostResolver {
   mozilla::Atomic<uint32_t> mActiveTaskCount MOZ_GUARDED_BY(mLock){0};
   mozilla::Atomic<uint32_t> mActiveAnyThreadCount MOZ_GUARDED_BY(mLock){0};
 
+  // The hit cache maps the keys of recent lookups that were answered from
+  // mRecordDB to the fresh positive address record they got. It is split in
+  // shards with a read/write lock each, so a cache hit only takes the read
+  // lock of one shard instead of mLock, which the resolver threads hold while
+  // they complete lookups. An entry is only used while the record hasn't
+  // reached its grace period and its mResultGeneration hasn't changed,
+  // everything else goes through mRecordDB.
+  static const uint32_t kHitCacheShardCount = 16;
+  static const uint32_t kHitCacheShardCapacity = 64;
+
+  struct HitCacheEntry {
+    RefPtr<nsHostRecord> mRecord;
+    uint32_t mGeneration;
+    mozilla::TimeStamp mGraceStart;
+  };
+
+  struct HitCacheShard {
+    mozilla::RWLock mLock{"nsHostResolver.HitCacheShard"};
+    nsTHashMap<nsGenericHashKey<nsHostKey>, HitCacheEntry> mEntries
+        MOZ_GUARDED_BY(mLock);
+  };
+
+  HitCacheShard& HitCacheShardFor(const nsHostKey& aKey) {
+    return mHitCache[aKey.Hash() % kHitCacheShardCount];
+  }
+  already_AddRefed<nsHostRecord> LookupHitCache(const nsHostKey& aKey);
+  void MaybeAddToHitCache(const nsHostKey& aKey, nsHostRecord* aRec)
+      MOZ_REQUIRES(mLock);
+  void ClearHitCache();
+
+  mozilla::Array<HitCacheShard, kHitCacheShardCount> mHitCache;
+
   // Set the expiration time stamps appropriately.
   void PrepareRecordExpirationAddrRecord(AddrHostRecord* rec) const;
 
@@ -16,9 +16,12 @@
 #include "Http2Compression.h"
 #include "Http2HuffmanIncoming.h"
 #include "Http2HuffmanOutgoing.h"
+#include "mozilla/StaticMutex.h"
+#include "mozilla/StaticPrefs_network.h"
 #include "mozilla/StaticPtr.h"
 #include "mozilla/glean/NetwerkProtocolHttpMetrics.h"
 #include "nsCharSeparatedTokenizer.h"
+#include "nsTHashMap.h"
 #include "nsIMemoryReporter.h"
 #include "nsHttpHandler.h"
 
@@ -87,12 +90,113 @@ NS_IMPL_ISUPPORTS(HpackDynamicTableReporter, nsIMemoryReporter)
 
 StaticRefPtr<HpackStaticTableReporter> gStaticReporter;
 
+// The number of origins we keep the compressor warm state for. The table is
+// simply dropped when it gets full.
+static const uint32_t kMaxWarmStateOrigins = 128;
+
+static StaticMutex sWarmStateLock MOZ_UNANNOTATED;
+static StaticAutoPtr<nsTHashMap<nsCStringHashKey, nsTArray<nsCString>>>
+    gWarmStates;
+
 void Http2CompressionCleanup() {
   // this happens after the socket thread has been destroyed
   delete gStaticHeaders;
   gStaticHeaders = nullptr;
   UnregisterStrongMemoryReporter(gStaticReporter);
   gStaticReporter = nullptr;
+  delete gHuffmanDecodeTable;
+  gHuffmanDecodeTable = nullptr;
+
+  StaticMutexAutoLock lock(sWarmStateLock);
+  gWarmStates = nullptr;
+}
+
+// The multi-symbol Huffman decoder looks up this many bits of input at once.
+// Any symbol with a code of up to that length is decoded by a single lookup,
+// two of them in a row if they both fit in the lookahead.
+static const uint32_t kHuffmanLookaheadBits = 12;
+static const uint32_t kHuffmanMaxCodeLength = 30;
+static const uint16_t kHuffmanEOS = 256;
+
+struct HuffmanDecodeEntry {
+  uint8_t mSymbols[2];
+  // The code length of the first symbol, 0 when the code is longer than the
+  // lookahead.
+  uint8_t mFirstLength;
+  // The code length of all the symbols of the entry, more than mFirstLength
+  // when there is a second symbol.
+  uint8_t mLength;
+};
+
+struct HuffmanDecodeTable {
+  HuffmanDecodeEntry mEntries[1 << kHuffmanLookaheadBits];
+
+  // The HPACK code is canonical: the codes of a given length are consecutive
+  // and ordered by symbol, so the codes longer than the lookahead are decoded
+  // from the first code and the number of codes of each length.
+  uint32_t mFirstCode[kHuffmanMaxCodeLength + 1];
+  uint16_t mCodeCount[kHuffmanMaxCodeLength + 1];
+  uint16_t mFirstSymbol[kHuffmanMaxCodeLength + 1];
+  uint16_t mSymbols[kHuffmanEOS + 1];
+};
+
+static HuffmanDecodeTable* gHuffmanDecodeTable = nullptr;
+
+static void InitializeHuffmanDecodeTable() {
+  auto* table = new HuffmanDecodeTable();
+
+  uint16_t count = 0;
+  for (uint32_t len = 1; len <= kHuffmanMaxCodeLength; ++len) {
+    table->mFirstSymbol[len] = count;
+    for (uint16_t sym = 0; sym <= kHuffmanEOS; ++sym) {
+      if (HuffmanOutgoing[sym].mLength != len) {
+        continue;
+      }
+      if (!table->mCodeCount[len]) {
+        table->mFirstCode[len] = HuffmanOutgoing[sym].mValue;
+      }
+      MOZ_ASSERT(HuffmanOutgoing[sym].mValue ==
+                 table->mFirstCode[len] + table->mCodeCount[len]);
+      ++table->mCodeCount[len];
+      table->mSymbols[count++] = sym;
+    }
+  }
+  MOZ_ASSERT(count == kHuffmanEOS + 1);
+
+  for (uint16_t sym = 0; sym < kHuffmanEOS; ++sym) {
+    uint32_t len = HuffmanOutgoing[sym].mLength;
+    if (len > kHuffmanLookaheadBits) {
+      continue;
+    }
+    uint32_t first = HuffmanOutgoing[sym].mValue
+                     << (kHuffmanLookaheadBits - len);
+    uint32_t last = first + (1 << (kHuffmanLookaheadBits - len));
+    for (uint32_t idx = first; idx < last; ++idx) {
+      HuffmanDecodeEntry& entry = table->mEntries[idx];
+      entry.mSymbols[0] = static_cast<uint8_t>(sym);
+      entry.mFirstLength = static_cast<uint8_t>(len);
+      entry.mLength = static_cast<uint8_t>(len);
+    }
+  }
+
+  // Now that every entry knows its first symbol, the bits after it tell
+  // whether a second one fits.
+  const uint32_t mask = (1 << kHuffmanLookaheadBits) - 1;
+  for (uint32_t idx = 0; idx <= mask; ++idx) {
+    HuffmanDecodeEntry& entry = table->mEntries[idx];
+    if (!entry.mFirstLength) {
+      continue;
+    }
+    const HuffmanDecodeEntry& next =
+        table->mEntries[(idx << entry.mFirstLength) & mask];
+    if (next.mFirstLength &&
+        next.mFirstLength <= kHuffmanLookaheadBits - entry.mFirstLength) {
+      entry.mSymbols[1] = next.mSymbols[0];
+      entry.mLength = entry.mFirstLength + next.mFirstLength;
+    }
+  }
+
+  gHuffmanDecodeTable = table;
 }
 
 static void AddStaticElement(const nsCString& name, const nsCString& value) {
@@ -110,6 +214,7 @@ static void InitializeStaticHeaders() {
     gStaticHeaders = new nsDeque<nvPair>();
     gStaticReporter = new HpackStaticTableReporter();
     RegisterStrongMemoryReporter(gStaticReporter);
+    InitializeHuffmanDecodeTable();
     AddStaticElement(":authority"_ns);
     AddStaticElement(":method"_ns, "GET"_ns);
     AddStaticElement(":method"_ns, "POST"_ns);
@@ -775,6 +880,10 @@ nsresult Http2Decompressor::CopyHuffmanStringFromInput(uint32_t bytes,
     return NS_ERROR_FAILURE;
   }
 
+  if (StaticPrefs::network_http_http2_hpack_multi_symbol_huffman()) {
+    return DecodeHuffmanString(bytes, val);
+  }
+
   uint32_t bytesRead = 0;
   uint8_t bitsLeft = 0;
   nsAutoCString buf;
@@ -832,6 +941,97 @@ nsresult Http2Decompressor::CopyHuffmanStringFromInput(uint32_t bytes,
   return NS_OK;
 }
 
+nsresult Http2Decompressor::DecodeHuffmanString(uint32_t bytes,
+                                                nsACString& val) {
+  MOZ_ASSERT(mOffset + bytes <= mDataLen);
+  const HuffmanDecodeTable* table = gHuffmanDecodeTable;
+
+  // The shortest code is 5 bits long, so this is the most we can decode.
+  nsAutoCString buf;
+  if (!buf.SetLength(static_cast<uint64_t>(bytes) * 8 / 5, fallible)) {
+    return NS_ERROR_OUT_OF_MEMORY;
+  }
+  char* start = buf.BeginWriting();
+  char* out = start;
+
+  const uint8_t* in = mData + mOffset;
+  const uint8_t* end = in + bytes;
+
+  // The input not decoded yet, most significant bit first.
+  uint64_t bits = 0;
+  uint32_t bitCount = 0;
+
+  while (true) {
+    while (bitCount <= 56 && in < end) {
+      bits |= static_cast<uint64_t>(*in++) << (56 - bitCount);
+      bitCount += 8;
+    }
+
+    if (in == end && bitCount < 8) {
+      // What's left has to be padding, the most significant bits of EOS. No
+      // other code of up to 7 bits is all ones, so this can't be a symbol.
+      uint64_t padding = bitCount ? bits >> (64 - bitCount) : 0;
+      if (padding == (static_cast<uint64_t>(1) << bitCount) - 1) {
+        break;
+      }
+    }
+
+    const HuffmanDecodeEntry& entry =
+        table->mEntries[bits >> (64 - kHuffmanLookaheadBits)];
+    if (entry.mFirstLength) {
+      // Near the end of the input the lookahead includes bits we don't have,
+      // only the symbols from the bits we actually got count.
+      if (entry.mLength <= bitCount) {
+        *out++ = static_cast<char>(entry.mSymbols[0]);
+        if (entry.mLength != entry.mFirstLength) {
+          *out++ = static_cast<char>(entry.mSymbols[1]);
+        }
+        bits <<= entry.mLength;
+        bitCount -= entry.mLength;
+        continue;
+      }
+      if (entry.mFirstLength <= bitCount) {
+        *out++ = static_cast<char>(entry.mSymbols[0]);
+        bits <<= entry.mFirstLength;
+        bitCount -= entry.mFirstLength;
+        continue;
+      }
+      LOG(("DecodeHuffmanString ran out of data in the middle of a symbol"));
+      return NS_ERROR_FAILURE;
+    }
+
+    uint16_t sym = kHuffmanEOS + 1;
+    uint32_t len = kHuffmanLookaheadBits + 1;
+    for (; len <= kHuffmanMaxCodeLength && len <= bitCount; ++len) {
+      uint32_t code = static_cast<uint32_t>(bits >> (64 - len));
+      if (code >= table->mFirstCode[len] &&
+          code - table->mFirstCode[len] < table->mCodeCount[len]) {
+        sym = table->mSymbols[table->mFirstSymbol[len] + code -
+                              table->mFirstCode[len]];
+        break;
+      }
+    }
+    if (sym > kHuffmanEOS) {
+      LOG(("DecodeHuffmanString ran out of data in the middle of a symbol"));
+      return NS_ERROR_FAILURE;
+    }
+    if (sym == kHuffmanEOS) {
+      LOG(("DecodeHuffmanString found an actual EOS"));
+      return NS_ERROR_FAILURE;
+    }
+    *out++ = static_cast<char>(sym);
+    bits <<= len;
+    bitCount -= len;
+  }
+
+  MOZ_ASSERT(out <= start + buf.Length());
+  buf.SetLength(out - start);
+  val = buf;
+  mOffset += bytes;
+  LOG(("DecodeHuffmanString decoded a full string!"));
+  return NS_OK;
+}
+
 nsresult Http2Decompressor::DoIndexed() {
   // this starts with a 1 bit pattern
   MOZ_ASSERT(mData[mOffset] & 0x80);
@@ -1060,6 +1260,77 @@ Http2Compressor::~Http2Compressor() {
   if (mPeakCount) {
     glean::hpack::peak_count_compressor.AccumulateSingleSample(mPeakCount);
   }
+
+  if (mStaticTableHits) {
+    glean::hpack::compressor_headers.Get("static_index"_ns)
+        .Add(mStaticTableHits);
+  }
+  if (mDynamicTableHits) {
+    glean::hpack::compressor_headers.Get("dynamic_index"_ns)
+        .Add(mDynamicTableHits);
+  }
+  if (mLiterals) {
+    glean::hpack::compressor_headers.Get("literal"_ns).Add(mLiterals);
+  }
+  if (mWarmStateSkips) {
+    glean::hpack::compressor_headers.Get("warm_state_literal"_ns)
+        .Add(mWarmStateSkips);
+  }
+
+  SaveWarmState();
+}
+
+void Http2Compressor::LoadWarmState(const nsACString& aOrigin) {
+  mWarmStateLoaded = true;
+  if (!StaticPrefs::network_http_http2_hpack_warm_state() ||
+      aOrigin.IsEmpty()) {
+    return;
+  }
+
+  mWarmStateOrigin = aOrigin;
+
+  StaticMutexAutoLock lock(sWarmStateLock);
+  if (!gWarmStates) {
+    return;
+  }
+
+  if (auto names = gWarmStates->Lookup(aOrigin)) {
+    for (const auto& name : *names) {
+      mOneOffNames.Insert(name);
+    }
+    LOG(("Http2Compressor %p loaded warm state for %s [names=%zu]", this,
+         mWarmStateOrigin.get(), names->Length()));
+  }
+}
+
+void Http2Compressor::SaveWarmState() {
+  if (mWarmStateOrigin.IsEmpty()) {
+    return;
+  }
+
+  nsTArray<nsCString> oneOffNames;
+  for (const auto& name : mIndexedNames) {
+    if (!mReusedNames.Contains(name)) {
+      oneOffNames.AppendElement(name);
+    }
+  }
+  // Names we didn't index this time because of the previous warm state and
+  // that didn't repeat either stay one-off.
+  for (const auto& name : mOneOffNames) {
+    if (!mIndexedNames.Contains(name)) {
+      oneOffNames.AppendElement(name);
+    }
+  }
+
+  StaticMutexAutoLock lock(sWarmStateLock);
+  if (!gWarmStates) {
+    gWarmStates = new nsTHashMap<nsCStringHashKey, nsTArray<nsCString>>();
+  }
+  if (gWarmStates->Count() >= kMaxWarmStateOrigins &&
+      !gWarmStates->Contains(mWarmStateOrigin)) {
+    gWarmStates->Clear();
+  }
+  gWarmStates->InsertOrUpdate(mWarmStateOrigin, std::move(oneOffNames));
 }
 
 nsresult Http2Compressor::EncodeHeaderBlock(
@@ -1082,6 +1353,10 @@ nsresult Http2Compressor::EncodeHeaderBlock(
     mBufferSizeChangeWaiting = false;
   }
 
+  if (!mWarmStateLoaded) {
+    LoadWarmState(host);
+  }
+
   // colon headers first
   if (!simpleConnectForm) {
     ProcessHeader(nvPair(":method"_ns, method), false, false);
@@ -1415,12 +1690,27 @@ void Http2Compressor::ProcessHeader(const nvPair inputPair, bool noLocalIndex,
 
   // We need to emit a new literal
   if (!match || noLocalIndex || neverIndex) {
+    mLiterals++;
+
     if (neverIndex) {
       DoOutput(kNeverIndexedLiteral, &inputPair, nameReference);
       DumpState("Compressor state after literal never index");
       return;
     }
 
+    if (!noLocalIndex && mOneOffNames.Contains(inputPair.mName)) {
+      nsAutoCString pair(inputPair.mName);
+      pair.Append('\n');
+      pair.Append(inputPair.mValue);
+      if (mSkippedPairs.EnsureInserted(pair)) {
+        mWarmStateSkips++;
+        noLocalIndex = true;
+      } else {
+        // It repeats after all, index it from now on.
+        mOneOffNames.Remove(inputPair.mName);
+      }
+    }
+
     if (noLocalIndex || (newSize > (mMaxBuffer / 2)) || (mMaxBuffer < 128)) {
       DoOutput(kPlainLiteral, &inputPair, nameReference);
       DumpState("Compressor state after literal without index");
@@ -1433,12 +1723,23 @@ void Http2Compressor::ProcessHeader(const nvPair inputPair, bool noLocalIndex,
     DoOutput(kIndexedLiteral, &inputPair, nameReference);
 
     mHeaderTable.AddElement(inputPair.mName, inputPair.mValue);
+    if (!mWarmStateOrigin.IsEmpty()) {
+      mIndexedNames.Insert(inputPair.mName);
+    }
     LOG(("HTTP compressor %p new literal placed at index 0\n", this));
     DumpState("Compressor state after literal with index");
     return;
   }
 
   // emit an index
+  if (matchedIndex < mHeaderTable.StaticLength()) {
+    mStaticTableHits++;
+  } else {
+    mDynamicTableHits++;
+    if (!mWarmStateOrigin.IsEmpty()) {
+      mReusedNames.Insert(inputPair.mName);
+    }
+  }
   DoOutput(kIndex, &inputPair, matchedIndex);
 
   DumpState("Compressor state after index");
@@ -12,6 +12,7 @@
 #include "mozilla/Attributes.h"
 #include "nsDeque.h"
 #include "nsString.h"
+#include "nsTHashSet.h"
 #include "mozilla/Mutex.h"
 
 namespace mozilla {
@@ -136,6 +137,9 @@ class Http2Decompressor final : public Http2BaseCompressor {
       uint8_t& bitsLeft);
   [[nodiscard]] nsresult DecodeFinalHuffmanCharacter(
       const HuffmanIncomingTable* table, uint8_t& c, uint8_t& bitsLeft);
+  // Decodes up to two symbols per table lookup instead of walking the
+  // HuffmanIncoming tables one byte at a time.
+  [[nodiscard]] nsresult DecodeHuffmanString(uint32_t bytes, nsACString& val);
 
   nsCString mHeaderStatus;
   nsCString mHeaderHost;
@@ -185,9 +189,30 @@ class Http2Compressor final : public Http2BaseCompressor {
   void HuffmanAppend(const nsCString& value);
   void EncodeTableSizeChange(uint32_t newMaxSize);
 
+  // The warm state remembers, per origin, which header names previous
+  // sessions put into the dynamic table without ever referencing them again.
+  // Those are sent as literals without indexing, so they don't evict the
+  // entries later requests can actually reuse.
+  void LoadWarmState(const nsACString& aOrigin);
+  void SaveWarmState();
+
   int64_t mParsedContentLength{-1};
   bool mBufferSizeChangeWaiting{false};
   uint32_t mLowestBufferSizeWaiting{0};
+
+  bool mWarmStateLoaded{false};
+  nsCString mWarmStateOrigin;
+  nsTHashSet<nsCString> mOneOffNames;
+  nsTHashSet<nsCString> mIndexedNames;
+  nsTHashSet<nsCString> mReusedNames;
+  // name + value of the literals sent without indexing because of the warm
+  // state, a repeated one brings its name back to the dynamic table.
+  nsTHashSet<nsCString> mSkippedPairs;
+
+  uint32_t mStaticTableHits{0};
+  uint32_t mDynamicTableHits{0};
+  uint32_t mLiterals{0};
+  uint32_t mWarmStateSkips{0};
 };
 
 }  // namespace net
@@ -0,0 +1,336 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// HttpLog.h should generally be included first
+#include "HttpLog.h"
+
+#include "Http3BatchIO.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include "mozilla/glean/NetwerkProtocolHttpMetrics.h"
+
+// Older headers may not know about UDP GSO/GRO yet.
+#ifndef UDP_SEGMENT
+#  define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#  define UDP_GRO 104
+#endif
+
+namespace mozilla::net {
+
+// The same as nsUDPSocket::RecvWithAddr() reads at most.
+static const uint32_t kMaxDatagramSize = 9216;
+static const uint32_t kRecvBatch = 16;
+// A GRO buffer can hold up to 64k of coalesced datagrams, keep fewer of them
+// around.
+static const uint32_t kGROBufferSize = 65535;
+static const uint32_t kGROBatch = 4;
+
+static const uint32_t kSendBatch = 32;
+// Queue() flushes on its own beyond this.
+static const uint32_t kMaxQueued = 128;
+// UDP_MAX_SEGMENTS and what fits into a single IP packet before
+// segmentation.
+static const uint32_t kMaxGSOSegments = 64;
+static const uint32_t kMaxGSOBytes = 65000;
+
+static nsresult ErrorForErrno(int aErrno) {
+  switch (aErrno) {
+    case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+    case EWOULDBLOCK:
+#endif
+      return NS_BASE_STREAM_WOULD_BLOCK;
+    case ECONNRESET:
+      return NS_ERROR_NET_RESET;
+    case ECONNREFUSED:
+    case ENETUNREACH:
+    case EHOSTUNREACH:
+    case EADDRNOTAVAIL:
+    case EACCES:
+      return NS_ERROR_CONNECTION_REFUSED;
+    case ENOBUFS:
+    case ENOMEM:
+      return NS_ERROR_OUT_OF_MEMORY;
+    default:
+      return NS_ERROR_FAILURE;
+  }
+}
+
+static bool SockaddrToNetAddr(const sockaddr_storage& aSockaddr,
+                              NetAddr* aAddr) {
+  if (aSockaddr.ss_family == AF_INET) {
+    const auto& sin = reinterpret_cast<const sockaddr_in&>(aSockaddr);
+    aAddr->inet.family = AF_INET;
+    aAddr->inet.port = sin.sin_port;
+    aAddr->inet.ip = sin.sin_addr.s_addr;
+    return true;
+  }
+  if (aSockaddr.ss_family == AF_INET6) {
+    const auto& sin6 = reinterpret_cast<const sockaddr_in6&>(aSockaddr);
+    aAddr->inet6.family = AF_INET6;
+    aAddr->inet6.port = sin6.sin6_port;
+    aAddr->inet6.flowinfo = sin6.sin6_flowinfo;
+    memcpy(&aAddr->inet6.ip.u8, &sin6.sin6_addr, sizeof(aAddr->inet6.ip.u8));
+    aAddr->inet6.scope_id = sin6.sin6_scope_id;
+    return true;
+  }
+  return false;
+}
+
+static bool NetAddrToSockaddr(const NetAddr& aAddr, sockaddr_storage* aSockaddr,
+                              socklen_t* aLength) {
+  memset(aSockaddr, 0, sizeof(*aSockaddr));
+  if (aAddr.raw.family == AF_INET) {
+    auto* sin = reinterpret_cast<sockaddr_in*>(aSockaddr);
+    sin->sin_family = AF_INET;
+    sin->sin_port = aAddr.inet.port;
+    sin->sin_addr.s_addr = aAddr.inet.ip;
+    *aLength = sizeof(*sin);
+    return true;
+  }
+  if (aAddr.raw.family == AF_INET6) {
+    auto* sin6 = reinterpret_cast<sockaddr_in6*>(aSockaddr);
+    sin6->sin6_family = AF_INET6;
+    sin6->sin6_port = aAddr.inet6.port;
+    sin6->sin6_flowinfo = aAddr.inet6.flowinfo;
+    memcpy(&sin6->sin6_addr, &aAddr.inet6.ip.u8, sizeof(sin6->sin6_addr));
+    sin6->sin6_scope_id = aAddr.inet6.scope_id;
+    *aLength = sizeof(*sin6);
+    return true;
+  }
+  return false;
+}
+
+// static
+UniquePtr<Http3BatchIO> Http3BatchIO::Create(int64_t aFD) {
+  if (aFD < 0) {
+    return nullptr;
+  }
+
+  UniquePtr<Http3BatchIO> io(new Http3BatchIO(static_cast<int>(aFD)));
+  io->Setup();
+  return io;
+}
+
+void Http3BatchIO::Setup() {
+  int one = 1;
+  mGRO = setsockopt(mFD, IPPROTO_UDP, UDP_GRO, &one, sizeof(one)) == 0;
+
+  int segment = 0;
+  socklen_t length = sizeof(segment);
+  mGSO = getsockopt(mFD, IPPROTO_UDP, UDP_SEGMENT, &segment, &length) == 0;
+
+  mRecvBuffer.SetLength(mGRO ? kGROBufferSize * kGROBatch
+                             : kMaxDatagramSize * kRecvBatch);
+
+  LOG(("Http3BatchIO::Setup [this=%p fd=%d gro=%d gso=%d]", this, mFD, mGRO,
+       mGSO));
+}
+
+nsresult Http3BatchIO::Receive() {
+  mReceived.Clear();
+
+  uint32_t count = mGRO ? kGROBatch : kRecvBatch;
+  uint32_t size = mGRO ? kGROBufferSize : kMaxDatagramSize;
+
+  mmsghdr msgs[kRecvBatch];
+  iovec iovs[kRecvBatch];
+  sockaddr_storage addrs[kRecvBatch];
+  alignas(cmsghdr) char control[kRecvBatch][CMSG_SPACE(sizeof(int))];
+  memset(msgs, 0, sizeof(msgs));
+  for (uint32_t i = 0; i < count; ++i) {
+    iovs[i].iov_base = mRecvBuffer.Elements() + i * size;
+    iovs[i].iov_len = size;
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    if (mGRO) {
+      msgs[i].msg_hdr.msg_control = control[i];
+      msgs[i].msg_hdr.msg_controllen = sizeof(control[i]);
+    }
+  }
+
+  int n;
+  do {
+    n = recvmmsg(mFD, msgs, count, MSG_DONTWAIT, nullptr);
+  } while (n < 0 && errno == EINTR);
+  glean::http3::udp_io_syscalls.Get("recv"_ns).Add(1);
+
+  if (n <= 0) {
+    return n < 0 ? ErrorForErrno(errno) : NS_BASE_STREAM_WOULD_BLOCK;
+  }
+
+  uint64_t bytes = 0;
+  for (int i = 0; i < n; ++i) {
+    const msghdr& hdr = msgs[i].msg_hdr;
+    NetAddr addr;
+    if ((hdr.msg_flags & MSG_TRUNC) || !SockaddrToNetAddr(addrs[i], &addr)) {
+      continue;
+    }
+
+    uint32_t length = msgs[i].msg_len;
+    uint32_t segment = length;
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg;
+         cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&hdr), cmsg)) {
+      if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO) {
+        int gro;
+        memcpy(&gro, CMSG_DATA(cmsg), sizeof(gro));
+        if (gro > 0) {
+          segment = static_cast<uint32_t>(gro);
+        }
+      }
+    }
+
+    bytes += length;
+    uint32_t base = i * size;
+    for (uint32_t offset = 0; offset < length; offset += segment) {
+      mReceived.AppendElement(Datagram{
+          addr, base + offset, std::min(segment, length - offset)});
+    }
+  }
+
+  glean::http3::udp_io_batch_size.Get("recv"_ns).AccumulateSingleSample(
+      mReceived.Length());
+  glean::http3::udp_io_bytes.Get("recv"_ns).Add(static_cast<int32_t>(bytes));
+  LOG(("Http3BatchIO::Receive [this=%p messages=%d datagrams=%zu]", this, n,
+       mReceived.Length()));
+  return NS_OK;
+}
+
+nsresult Http3BatchIO::Queue(const NetAddr& aAddr, const uint8_t* aData,
+                             uint32_t aLength) {
+  nsresult rv = NS_OK;
+  if (mQueued.Length() >= kMaxQueued) {
+    rv = Flush(nullptr);
+  }
+
+  mQueued.AppendElement(
+      Datagram{aAddr, static_cast<uint32_t>(mSendBuffer.Length()), aLength});
+  mSendBuffer.AppendElements(aData, aLength);
+  // A would block of the flush doesn't affect queuing more packets.
+  return rv == NS_BASE_STREAM_WOULD_BLOCK ? NS_OK : rv;
+}
+
+nsresult Http3BatchIO::Flush(uint32_t* aBytesSent) {
+  nsresult rv = NS_OK;
+  uint32_t next = 0;
+  while (NS_SUCCEEDED(rv) && next < mQueued.Length()) {
+    rv = SendQueued(next, &next);
+  }
+
+  if (aBytesSent) {
+    *aBytesSent = mBytesSent;
+    mBytesSent = 0;
+  }
+  mQueued.ClearAndRetainStorage();
+  mSendBuffer.ClearAndRetainStorage();
+  return rv;
+}
+
+nsresult Http3BatchIO::SendQueued(uint32_t aFirst, uint32_t* aNext) {
+  mmsghdr msgs[kSendBatch];
+  iovec iovs[kSendBatch];
+  sockaddr_storage addrs[kSendBatch];
+  alignas(cmsghdr) char control[kSendBatch][CMSG_SPACE(sizeof(uint16_t))];
+  uint32_t firsts[kSendBatch];
+  uint32_t ends[kSendBatch];
+  memset(msgs, 0, sizeof(msgs));
+
+  uint32_t count = 0;
+  uint32_t next = aFirst;
+  while (next < mQueued.Length() && count < kSendBatch) {
+    const Datagram& first = mQueued[next];
+    uint32_t end = next + 1;
+    uint32_t bytes = first.mLength;
+    if (mGSO) {
+      // All segments but the last one have to have the same size.
+      while (end < mQueued.Length() && end - next < kMaxGSOSegments &&
+             mQueued[end - 1].mLength == first.mLength &&
+             mQueued[end].mLength <= first.mLength &&
+             bytes + mQueued[end].mLength <= kMaxGSOBytes &&
+             mQueued[end].mAddr == first.mAddr) {
+        bytes += mQueued[end].mLength;
+        ++end;
+      }
+    }
+
+    msghdr& hdr = msgs[count].msg_hdr;
+    socklen_t nameLength;
+    if (!NetAddrToSockaddr(first.mAddr, &addrs[count], &nameLength)) {
+      next = end;
+      continue;
+    }
+    iovs[count].iov_base = mSendBuffer.Elements() + first.mOffset;
+    iovs[count].iov_len = bytes;
+    hdr.msg_name = &addrs[count];
+    hdr.msg_namelen = nameLength;
+    hdr.msg_iov = &iovs[count];
+    hdr.msg_iovlen = 1;
+    if (end - next > 1) {
+      hdr.msg_control = control[count];
+      hdr.msg_controllen = sizeof(control[count]);
+      cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+      cmsg->cmsg_level = IPPROTO_UDP;
+      cmsg->cmsg_type = UDP_SEGMENT;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+      uint16_t segment = static_cast<uint16_t>(first.mLength);
+      memcpy(CMSG_DATA(cmsg), &segment, sizeof(segment));
+    }
+    firsts[count] = next;
+    ends[count] = end;
+    ++count;
+    next = end;
+  }
+  *aNext = next;
+
+  uint32_t done = 0;
+  while (done < count) {
+    int n;
+    do {
+      n = sendmmsg(mFD, msgs + done, count - done, MSG_DONTWAIT);
+    } while (n < 0 && errno == EINTR);
+    glean::http3::udp_io_syscalls.Get("send"_ns).Add(1);
+
+    if (n > 0) {
+      uint32_t bytes = 0;
+      for (uint32_t i = done; i < done + n; ++i) {
+        bytes += iovs[i].iov_len;
+      }
+      mBytesSent += bytes;
+      glean::http3::udp_io_bytes.Get("send"_ns).Add(
+          static_cast<int32_t>(bytes));
+      glean::http3::udp_io_batch_size.Get("send"_ns).AccumulateSingleSample(
+          ends[done + n - 1] - firsts[done]);
+      done += n;
+      continue;
+    }
+
+    int error = n < 0 ? errno : EAGAIN;
+    if (error == EIO && msgs[done].msg_hdr.msg_controllen) {
+      // The device can't do the segmentation, send the remaining packets
+      // one by one from now on.
+      LOG(("Http3BatchIO::SendQueued disabling GSO [this=%p]", this));
+      mGSO = false;
+      *aNext = firsts[done];
+      return NS_OK;
+    }
+
+    // Drop the rest of the batch, like the packets PR_SendTo() fails for.
+    *aNext = mQueued.Length();
+    LOG(("Http3BatchIO::SendQueued failed [this=%p errno=%d]", this, error));
+    return ErrorForErrno(error);
+  }
+
+  return NS_OK;
+}
+
+}  // namespace mozilla::net
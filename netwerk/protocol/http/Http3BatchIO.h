@@ -0,0 +1,81 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef Http3BatchIO_h__
+#define Http3BatchIO_h__
+
+#include "mozilla/net/DNS.h"
+#include "mozilla/Span.h"
+#include "mozilla/UniquePtr.h"
+#include "nsError.h"
+#include "nsTArray.h"
+
+namespace mozilla::net {
+
+// Batched UDP IO for Http3Session when neqo's own socket code isn't used
+// (network.http.http3.use_nspr_for_io).  Instead of one PR_RecvFrom() or
+// PR_SendTo() per QUIC packet, datagrams are read with a single recvmmsg()
+// and queued packets are written with a single sendmmsg().  When the kernel
+// supports it, received datagrams are coalesced with UDP GRO and equally
+// sized packets to the same peer are sent as one UDP GSO buffer.
+//
+// Only built when MOZ_HTTP3_BATCH_IO is defined (Linux, Android).  Only
+// ever used on the socket thread, there is no locking.
+class Http3BatchIO final {
+ public:
+  struct Datagram {
+    NetAddr mAddr;
+    uint32_t mOffset;
+    uint32_t mLength;
+  };
+
+  // Returns null when aFD isn't a usable native socket.  Enables GRO on the
+  // socket when possible.
+  static UniquePtr<Http3BatchIO> Create(int64_t aFD);
+
+  // Reads the datagrams a single recvmmsg() call returns, see Received().
+  // Returns NS_BASE_STREAM_WOULD_BLOCK when nothing was queued.
+  nsresult Receive();
+
+  // The datagrams of the last Receive() call, GRO buffers already split.
+  const nsTArray<Datagram>& Received() const { return mReceived; }
+  Span<const uint8_t> Data(const Datagram& aDatagram) const {
+    return Span<const uint8_t>(mRecvBuffer)
+        .Subspan(aDatagram.mOffset, aDatagram.mLength);
+  }
+
+  // Copies a packet into the send queue, flushing it first when full.  An
+  // error of the flush is returned here.
+  nsresult Queue(const NetAddr& aAddr, const uint8_t* aData, uint32_t aLength);
+
+  // Sends all queued packets.  Packets the kernel refuses with EAGAIN are
+  // dropped, the same as when PR_SendTo() would block, QUIC recovers them.
+  // aBytesSent is the number of bytes handed to the kernel since the last
+  // call, including the flushes done by Queue().
+  nsresult Flush(uint32_t* aBytesSent);
+
+  bool HasQueued() const { return !mQueued.IsEmpty(); }
+
+ private:
+  explicit Http3BatchIO(int aFD) : mFD(aFD) {}
+
+  void Setup();
+  // Sends one sendmmsg() batch starting at mQueued[aFirst].
+  nsresult SendQueued(uint32_t aFirst, uint32_t* aNext);
+
+  int mFD;
+  bool mGSO{false};
+  bool mGRO{false};
+
+  nsTArray<uint8_t> mRecvBuffer;
+  nsTArray<Datagram> mReceived;
+
+  nsTArray<uint8_t> mSendBuffer;
+  nsTArray<Datagram> mQueued;
+  uint32_t mBytesSent{0};
+};
+
+}  // namespace mozilla::net
+
+#endif
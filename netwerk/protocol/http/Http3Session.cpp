@@ -5,6 +5,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "ASpdySession.h"  // because of SoftStreamError()
+#include "Http3BatchIO.h"
 #include "Http3Session.h"
 #include "Http3Stream.h"
 #include "Http3StreamBase.h"
@@ -173,6 +174,12 @@ nsresult Http3Session::Init(const nsHttpConnectionInfo* aConnInfo,
     return rv;
   }
 
+#ifdef MOZ_HTTP3_BATCH_IO
+  if (mUseNSPRForIO && StaticPrefs::network_http_http3_batch_udp_io()) {
+    mBatchIO = Http3BatchIO::Create(socket->GetFileDescriptor());
+  }
+#endif
+
   nsAutoCString peerId;
   mSocketControl->GetPeerId(peerId);
   nsTArray<uint8_t> token;
@@ -409,6 +416,12 @@ nsresult Http3Session::ProcessInput(nsIUDPSocket* socket) {
   LOG(("Http3Session::ProcessInput writer=%p [this=%p state=%d]",
        mUdpConn.get(), this, mState));
 
+#ifdef MOZ_HTTP3_BATCH_IO
+  if (mBatchIO) {
+    return ProcessInputBatched(socket);
+  }
+#endif
+
   if (mUseNSPRForIO) {
     while (true) {
       nsTArray<uint8_t> data;
@@ -941,6 +954,12 @@ nsresult Http3Session::ProcessOutput(nsIUDPSocket* socket) {
   LOG(("Http3Session::ProcessOutput reader=%p, [this=%p]", mUdpConn.get(),
        this));
 
+#ifdef MOZ_HTTP3_BATCH_IO
+  if (mBatchIO) {
+    return ProcessOutputBatched(socket);
+  }
+#endif
+
   if (mUseNSPRForIO) {
     mSocket = socket;
     nsresult rv = mHttp3Connection->ProcessOutputAndSendUseNSPRForIO(
@@ -1010,6 +1029,79 @@ nsresult Http3Session::ProcessOutput(nsIUDPSocket* socket) {
   return NS_OK;
 }
 
+#ifdef MOZ_HTTP3_BATCH_IO
+nsresult Http3Session::ProcessInputBatched(nsIUDPSocket* socket) {
+  uint32_t received = 0;
+  nsTArray<uint8_t> data;
+  nsresult rv = NS_OK;
+  while (NS_SUCCEEDED(rv) && NS_SUCCEEDED(mBatchIO->Receive())) {
+    for (const auto& datagram : mBatchIO->Received()) {
+      data.ClearAndRetainStorage();
+      data.AppendElements(mBatchIO->Data(datagram));
+      rv = mHttp3Connection->ProcessInputUseNSPRForIO(datagram.mAddr, data);
+      MOZ_ALWAYS_SUCCEEDS(rv);
+      if (NS_FAILED(rv)) {
+        break;
+      }
+      received += datagram.mLength;
+    }
+  }
+
+  LOG(("Http3Session::ProcessInputBatched received=%u", received));
+  mTotalBytesRead += static_cast<int64_t>(received);
+  socket->AddInputBytes(received);
+  return NS_OK;
+}
+
+nsresult Http3Session::ProcessOutputBatched(nsIUDPSocket* socket) {
+  nsresult rv = mHttp3Connection->ProcessOutputAndSendUseNSPRForIO(
+      this,
+      [](void* aContext, uint16_t aFamily, const uint8_t* aAddr,
+         uint16_t aPort, const uint8_t* aData, uint32_t aLength) {
+        Http3Session* self = (Http3Session*)aContext;
+
+        NetAddr addr;
+        if (NS_FAILED(RawBytesToNetAddr(aFamily, aAddr, aPort, &addr))) {
+          return NS_OK;
+        }
+
+        // The same check nsUDPSocket::SendWithAddress does.
+        nsresult rv = NS_OK;
+        if (StaticPrefs::network_http_http3_block_loopback_ipv6_addr() &&
+            addr.raw.family == AF_INET6 && addr.IsLoopbackAddr()) {
+          rv = NS_ERROR_CONNECTION_REFUSED;
+        } else {
+          rv = self->mBatchIO->Queue(addr, aData, aLength);
+        }
+        if (NS_FAILED(rv)) {
+          self->mSocketError = rv;
+          return rv;
+        }
+        return NS_OK;
+      },
+      [](void* aContext, uint64_t timeout) {
+        Http3Session* self = (Http3Session*)aContext;
+        self->SetupTimer(timeout);
+      });
+
+  uint32_t written = 0;
+  nsresult flushRv = mBatchIO->Flush(&written);
+  LOG(("Http3Session::ProcessOutputBatched written=%u rv=%d [this=%p]",
+       written, static_cast<int32_t>(flushRv), this));
+  if (written) {
+    mTotalBytesWritten += written;
+    mLastWriteTime = PR_IntervalNow();
+    socket->AddOutputBytes(written);
+  }
+  if (NS_SUCCEEDED(rv) && NS_FAILED(flushRv) &&
+      flushRv != NS_BASE_STREAM_WOULD_BLOCK) {
+    mSocketError = flushRv;
+    rv = flushRv;
+  }
+  return rv;
+}
+#endif
+
 // This is only called when timer expires.
 // It is called by HttpConnectionUDP::OnQuicTimeout.
 // If tihs function returns an error OnQuicTimeout will handle the error
@@ -102,6 +102,7 @@
 namespace mozilla::net {
 
 class HttpConnectionUDP;
+class Http3BatchIO;
 class Http3StreamBase;
 class QuicSocketControl;
 class Http3WebTransportSession;
@@ -231,6 +232,8 @@ class Http3Session final : public nsAHttpTransaction, public nsAHttpConnection {
 
   nsresult ProcessOutput(nsIUDPSocket* socket);
   nsresult ProcessInput(nsIUDPSocket* socket);
+  nsresult ProcessOutputBatched(nsIUDPSocket* socket);
+  nsresult ProcessInputBatched(nsIUDPSocket* socket);
   nsresult ProcessEvents();
 
   nsresult ProcessTransactionRead(uint64_t stream_id);
@@ -317,6 +320,9 @@ class Http3Session final : public nsAHttpTransaction, public nsAHttpConnection {
 
   // True if this http3 session uses NSPR for UDP IO.
   bool mUseNSPRForIO{true};
+  // recvmmsg/sendmmsg in place of the NSPR calls, see
+  // network.http.http3.batch_udp_io.  Only set when mUseNSPRForIO is.
+  UniquePtr<Http3BatchIO> mBatchIO;
 
   RefPtr<HttpConnectionUDP> mUdpConn;
 
@@ -215,11 +215,45 @@ IPCResult HttpBackgroundChannelChild::RecvOnTransportAndData(
     const uint64_t& aOffset, const uint32_t& aCount, const nsACString& aData,
     const bool& aDataFromSocketProcess,
     const TimeStamp& aOnDataAvailableStart) {
+  RunOrQueueOnTransportAndData(
+      aOffset, aCount, aDataFromSocketProcess,
+      [aChannelStatus, aTransportStatus, aOffset, aCount,
+       data = nsCString(aData),
+       aOnDataAvailableStart](HttpChannelChild* aChannelChild) {
+        aChannelChild->ProcessOnTransportAndData(
+            aChannelStatus, aTransportStatus, aOffset, aCount, data,
+            aOnDataAvailableStart);
+      });
+  return IPC_OK();
+}
+
+IPCResult HttpBackgroundChannelChild::RecvOnTransportAndDataShared(
+    const nsresult& aChannelStatus, const nsresult& aTransportStatus,
+    const uint64_t& aOffset, const uint32_t& aCount,
+    mozilla::ipc::BigBuffer&& aData, const TimeStamp& aOnDataAvailableStart) {
+  if (aData.Size() < aCount) {
+    return IPC_FAIL(this, "Shared data is shorter than the ODA count");
+  }
+
+  // The data stays mapped until the last event referring to it has run.
+  RefPtr<SharedODAData> data = new SharedODAData(std::move(aData));
+  RunOrQueueOnTransportAndData(
+      aOffset, aCount, false,
+      [aChannelStatus, aTransportStatus, aOffset, aCount, data,
+       aOnDataAvailableStart](HttpChannelChild* aChannelChild) {
+        aChannelChild->ProcessOnTransportAndDataShared(
+            aChannelStatus, aTransportStatus, aOffset, aCount, data,
+            aOnDataAvailableStart);
+      });
+  return IPC_OK();
+}
+
+void HttpBackgroundChannelChild::RunOrQueueOnTransportAndData(
+    uint64_t aOffset, uint32_t aCount, bool aDataFromSocketProcess,
+    std::function<void(HttpChannelChild*)>&& aProcess) {
   RefPtr<HttpBackgroundChannelChild> self = this;
   std::function<void()> callProcessOnTransportAndData =
-      [self, aChannelStatus, aTransportStatus, aOffset, aCount,
-       data = nsCString(aData), aDataFromSocketProcess,
-       aOnDataAvailableStart]() {
+      [self, aDataFromSocketProcess, process = std::move(aProcess)]() {
         LOG(
             ("HttpBackgroundChannelChild::RecvOnTransportAndData [this=%p, "
              "aDataFromSocketProcess=%d, mFirstODASource=%d]\n",
@@ -246,9 +280,7 @@ IPCResult HttpBackgroundChannelChild::RecvOnTransportAndData(
           return;
         }
 
-        self->mChannelChild->ProcessOnTransportAndData(
-            aChannelStatus, aTransportStatus, aOffset, aCount, data,
-            aOnDataAvailableStart);
+        process(self->mChannelChild);
       };
 
   // Bug 1641336: Race only happens if the data is from socket process.
@@ -260,11 +292,10 @@ IPCResult HttpBackgroundChannelChild::RecvOnTransportAndData(
     mQueuedRunnables.AppendElement(NS_NewRunnableFunction(
         "HttpBackgroundChannelChild::RecvOnTransportAndData",
         std::move(callProcessOnTransportAndData)));
-    return IPC_OK();
+    return;
   }
 
   callProcessOnTransportAndData();
-  return IPC_OK();
 }
 
 IPCResult HttpBackgroundChannelChild::RecvOnStopRequest(
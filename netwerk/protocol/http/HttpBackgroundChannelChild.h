@@ -68,6 +68,11 @@ class HttpBackgroundChannelChild final : public PHttpBackgroundChannelChild {
                                    const bool& aDataFromSocketProcess,
                                    const TimeStamp& aOnDataAvailableStart);
 
+  IPCResult RecvOnTransportAndDataShared(
+      const nsresult& aChannelStatus, const nsresult& aTransportStatus,
+      const uint64_t& aOffset, const uint32_t& aCount,
+      mozilla::ipc::BigBuffer&& aData, const TimeStamp& aOnDataAvailableStart);
+
   IPCResult RecvOnStopRequest(
       const nsresult& aChannelStatus, const ResourceTimingStructArgs& aTiming,
       const TimeStamp& aLastActiveTabOptHit,
@@ -117,6 +122,12 @@ class HttpBackgroundChannelChild final : public PHttpBackgroundChannelChild {
   // are invoked.
   bool IsWaitingOnStartRequest();
 
+  // Runs aProcess with the associated HttpChannelChild if the data should be
+  // delivered, or queues it until OnStartRequest has been handled.
+  void RunOrQueueOnTransportAndData(
+      uint64_t aOffset, uint32_t aCount, bool aDataFromSocketProcess,
+      std::function<void(HttpChannelChild*)>&& aProcess);
+
   // Associated HttpChannelChild for handling the channel events.
   // Will be removed while failed to create background channel,
   // destruction of the background channel, or explicitly dissociation
@@ -235,6 +235,40 @@ bool HttpBackgroundChannelParent::OnTransportAndData(
   return nsHttp::SendDataInChunks(aData, aOffset, aCount, sendFunc);
 }
 
+bool HttpBackgroundChannelParent::OnTransportAndDataShared(
+    const nsresult& aChannelStatus, const nsresult& aTransportStatus,
+    const uint64_t& aOffset, const uint32_t& aCount,
+    mozilla::ipc::BigBuffer&& aData, TimeStamp aOnDataAvailableStart) {
+  LOG(("HttpBackgroundChannelParent::OnTransportAndDataShared [this=%p]\n",
+       this));
+  AssertIsInMainProcess();
+
+  if (NS_WARN_IF(!mIPCOpened)) {
+    return false;
+  }
+
+  if (!IsOnBackgroundThread()) {
+    MutexAutoLock lock(mBgThreadMutex);
+    nsresult rv = mBackgroundThread->Dispatch(
+        NewRunnableMethod<const nsresult, const nsresult, const uint64_t,
+                          const uint32_t, mozilla::ipc::BigBuffer&&,
+                          TimeStamp>(
+            "net::HttpBackgroundChannelParent::OnTransportAndDataShared", this,
+            &HttpBackgroundChannelParent::OnTransportAndDataShared,
+            aChannelStatus, aTransportStatus, aOffset, aCount,
+            std::move(aData), aOnDataAvailableStart),
+        NS_DISPATCH_NORMAL);
+
+    MOZ_DIAGNOSTIC_ASSERT(NS_SUCCEEDED(rv));
+
+    return NS_SUCCEEDED(rv);
+  }
+
+  return SendOnTransportAndDataShared(aChannelStatus, aTransportStatus,
+                                      aOffset, aCount, std::move(aData),
+                                      aOnDataAvailableStart);
+}
+
 bool HttpBackgroundChannelParent::OnStopRequest(
     const nsresult& aChannelStatus, const ResourceTimingStructArgs& aTiming,
     const nsHttpHeaderArray& aResponseTrailers,
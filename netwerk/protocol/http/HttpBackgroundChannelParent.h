@@ -54,6 +54,14 @@ class HttpBackgroundChannelParent final : public PHttpBackgroundChannelParent {
                           const nsCString& aData,
                           TimeStamp aOnDataAvailableStart);
 
+  // To send OnTransportAndDataShared message over background channel.
+  bool OnTransportAndDataShared(const nsresult& aChannelStatus,
+                                const nsresult& aTransportStatus,
+                                const uint64_t& aOffset,
+                                const uint32_t& aCount,
+                                mozilla::ipc::BigBuffer&& aData,
+                                TimeStamp aOnDataAvailableStart);
+
   // To send OnStopRequest message over background channel.
   bool OnStopRequest(const nsresult& aChannelStatus,
                      const ResourceTimingStructArgs& aTiming,
@@ -12,6 +12,7 @@
 #include "mozilla/StaticPrefsBase.h"
 #include "mozilla/UniquePtr.h"
 #include "mozilla/extensions/StreamFilterParent.h"
+#include "mozilla/ipc/BigBuffer.h"
 #include "mozilla/net/HttpBaseChannel.h"
 #include "mozilla/net/NeckoTargetHolder.h"
 #include "mozilla/net/PHttpChannelChild.h"
@@ -45,6 +46,26 @@ namespace mozilla::net {
 
 class HttpBackgroundChannelChild;
 
+// An OnDataAvailable payload the parent handed over in shared memory.  Holding
+// a reference keeps the region mapped, so the data can be fed to the listener
+// without copying it out first.
+class SharedODAData final {
+ public:
+  NS_INLINE_DECL_THREADSAFE_REFCOUNTING(SharedODAData)
+
+  explicit SharedODAData(mozilla::ipc::BigBuffer&& aData)
+      : mData(std::move(aData)) {}
+
+  Span<const char> AsSpan() const {
+    return Span(reinterpret_cast<const char*>(mData.Data()), mData.Size());
+  }
+
+ private:
+  ~SharedODAData() = default;
+
+  const mozilla::ipc::BigBuffer mData;
+};
+
 class HttpChannelChild final : public PHttpChannelChild,
                                public HttpBaseChannel,
                                public HttpAsyncAborter<HttpChannelChild>,
@@ -226,6 +247,10 @@ class HttpChannelChild final : public PHttpChannelChild,
                                  const uint32_t& aCount,
                                  const nsACString& aData,
                                  const TimeStamp& aOnDataAvailableStartTime);
+  void ProcessOnTransportAndDataShared(
+      const nsresult& aChannelStatus, const nsresult& aTransportStatus,
+      const uint64_t& aOffset, const uint32_t& aCount, SharedODAData* aData,
+      const TimeStamp& aOnDataAvailableStartTime);
   void ProcessOnStopRequest(const nsresult& aChannelStatus,
                             const ResourceTimingStructArgs& aTiming,
                             const nsHttpHeaderArray& aResponseTrailers,
@@ -426,7 +451,7 @@ class HttpChannelChild final : public PHttpChannelChild,
                       const HttpChannelOnStartRequestArgs& aArgs);
   void OnTransportAndData(const nsresult& channelStatus, const nsresult& status,
                           const uint64_t& offset, const uint32_t& count,
-                          const nsACString& data);
+                          Span<const char> data);
   void OnStopRequest(const nsresult& channelStatus,
                      const ResourceTimingStructArgs& timing,
                      const nsHttpHeaderArray& aResponseTrailers);
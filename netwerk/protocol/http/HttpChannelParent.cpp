@@ -27,6 +27,7 @@
 #include "mozilla/Preferences.h"
 #include "mozilla/ProfilerLabels.h"
 #include "mozilla/ProfilerMarkers.h"
+#include "mozilla/StaticPrefs_network.h"
 #include "mozilla/StoragePrincipalHelper.h"
 #include "mozilla/UniquePtr.h"
 #include "mozilla/Unused.h"
@@ -1522,20 +1523,46 @@ HttpChannelParent::OnDataAvailable(nsIRequest* aRequest,
     onDataAvailableStart = httpChannelImpl->GetDataAvailableStartTime();
   }
 
-  nsCString data;
-  nsresult rv = NS_ReadInputStreamToString(aInputStream, data, aCount);
-  if (NS_FAILED(rv)) {
-    return rv;
-  }
-
   // Either IPC channel is closed or background channel
   // is ready to send OnTransportAndData.
   MOZ_ASSERT(mIPCClosed || mBgParent);
 
-  if (mIPCClosed || !mBgParent ||
-      !mBgParent->OnTransportAndData(channelStatus, transportStatus, aOffset,
-                                     aCount, data, onDataAvailableStart)) {
-    return NS_ERROR_UNEXPECTED;
+  if (transportStatus == NS_NET_STATUS_READING &&
+      aCount >= mozilla::ipc::BigBuffer::kShmemThreshold &&
+      StaticPrefs::network_http_shmem_cache_data_enabled()) {
+    // Read the cache chunks straight into shared memory the child maps, this
+    // saves the copy into a string here and the one out of the IPC message
+    // in the child.
+    mozilla::ipc::BigBuffer data(aCount);
+    void* dest = data.Data();
+    uint64_t written = 0;
+    nsresult rv =
+        NS_ReadInputStreamToBuffer(aInputStream, &dest, aCount, &written);
+    if (NS_FAILED(rv)) {
+      return rv;
+    }
+    if (written != aCount) {
+      return NS_ERROR_UNEXPECTED;
+    }
+
+    if (mIPCClosed || !mBgParent ||
+        !mBgParent->OnTransportAndDataShared(channelStatus, transportStatus,
+                                             aOffset, aCount, std::move(data),
+                                             onDataAvailableStart)) {
+      return NS_ERROR_UNEXPECTED;
+    }
+  } else {
+    nsCString data;
+    nsresult rv = NS_ReadInputStreamToString(aInputStream, data, aCount);
+    if (NS_FAILED(rv)) {
+      return rv;
+    }
+
+    if (mIPCClosed || !mBgParent ||
+        !mBgParent->OnTransportAndData(channelStatus, transportStatus, aOffset,
+                                       aCount, data, onDataAvailableStart)) {
+      return NS_ERROR_UNEXPECTED;
+    }
   }
 
   int32_t count = static_cast<int32_t>(aCount);
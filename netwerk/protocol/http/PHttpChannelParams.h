@@ -90,7 +90,7 @@ struct ParamTraits<mozilla::net::nsHttpHeaderArray::nsEntry> {
     if (aParam.headerNameOriginal.IsEmpty()) {
       WriteParam(aWriter, aParam.header);
     } else {
-      WriteParam(aWriter, aParam.headerNameOriginal);
+      WriteParam(aWriter, aParam.headerNameOriginal.AsString());
     }
     WriteParam(aWriter, aParam.value);
     switch (aParam.variety) {
@@ -5,6 +5,7 @@
 #ifndef nsAHttpTransaction_h__
 #define nsAHttpTransaction_h__
 
+#include "mozilla/Span.h"
 #include "nsTArray.h"
 #include "nsWeakReference.h"
 #include "nsIRequest.h"
@@ -270,6 +271,31 @@ class nsAHttpSegmentReader {
                                                uint32_t count,
                                                uint32_t* countRead) = 0;
 
+  // Like OnReadSegment() for consecutive segments of the request stream,
+  // countRead counts across all of them.  The default reads them one by
+  // one, nsHttpConnection writes them to the socket at once.
+  [[nodiscard]] virtual nsresult OnReadSegments(
+      mozilla::Span<const mozilla::Span<const char>> segments,
+      uint32_t* countRead) {
+    *countRead = 0;
+    for (const auto& segment : segments) {
+      uint32_t read = 0;
+      nsresult rv = OnReadSegment(segment.Elements(), segment.Length(), &read);
+      *countRead += read;
+      if (NS_FAILED(rv)) {
+        return *countRead ? NS_OK : rv;
+      }
+      if (read < segment.Length()) {
+        break;
+      }
+    }
+    return NS_OK;
+  }
+
+  // Whether OnReadSegments() writes several segments at once.  Request
+  // streams are buffered for the readers that don't.
+  virtual bool ReadsGatheredSegments() { return false; }
+
   // Ask the segment reader to commit to accepting size bytes of
   // data from subsequent OnReadSegment() calls or throw hard
   // (i.e. not wouldblock) exceptions. Implementations
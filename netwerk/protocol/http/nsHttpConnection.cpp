@@ -27,6 +27,7 @@
 #include "nsHttpRequestHead.h"
 #include "nsHttpResponseHead.h"
 #include "nsIClassOfService.h"
+#include "nsIGatherOutputStream.h"
 #include "nsIOService.h"
 #include "nsISocketTransport.h"
 #include "nsISupportsPriority.h"
@@ -1623,15 +1624,45 @@ nsresult nsHttpConnection::OnReadSegment(const char* buf, uint32_t count,
   }
 
   nsresult rv = mSocketOut->Write(buf, count, countRead);
+  return OnSocketWritten(rv, *countRead);
+}
+
+nsresult nsHttpConnection::OnReadSegments(Span<const Span<const char>> segments,
+                                          uint32_t* countRead) {
+  nsCOMPtr<nsIGatherOutputStream> gatherOut = do_QueryInterface(mSocketOut);
+  if (!gatherOut || segments.Length() < 2) {
+    return nsAHttpSegmentReader::OnReadSegments(segments, countRead);
+  }
+
+  LOG(("nsHttpConnection::OnReadSegments [this=%p segments=%zu]\n", this,
+       segments.Length()));
+
+  // See OnReadSegment().
+  if (mTlsHandshaker->EarlyDataAvailable() && !CheckCanWrite0RTTData()) {
+    MOZ_DIAGNOSTIC_ASSERT(mTlsHandshaker->TlsHandshakeComplitionPending());
+    *countRead = 0;
+    return NS_BASE_STREAM_WOULD_BLOCK;
+  }
+
+  nsresult rv = gatherOut->WriteGathered(segments, countRead);
+  return OnSocketWritten(rv, *countRead);
+}
+
+bool nsHttpConnection::ReadsGatheredSegments() {
+  nsCOMPtr<nsIGatherOutputStream> gatherOut = do_QueryInterface(mSocketOut);
+  return !!gatherOut;
+}
+
+nsresult nsHttpConnection::OnSocketWritten(nsresult rv, uint32_t countWritten) {
   if (NS_FAILED(rv)) {
     mSocketOutCondition = rv;
-  } else if (*countRead == 0) {
+  } else if (countWritten == 0) {
     mSocketOutCondition = NS_BASE_STREAM_CLOSED;
   } else {
     mLastWriteTime = PR_IntervalNow();
     mSocketOutCondition = NS_OK;  // reset condition
     if (!TunnelSetupInProgress()) {
-      mTotalBytesWritten += *countRead;
+      mTotalBytesWritten += countWritten;
       mExperienceState |= ConnectionExperienceState::First_Request_Sent;
     }
   }
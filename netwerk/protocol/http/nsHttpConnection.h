@@ -72,6 +72,10 @@ class nsHttpConnection final : public HttpConnectionBase,
 
   nsHttpConnection();
 
+  [[nodiscard]] nsresult OnReadSegments(
+      Span<const Span<const char>> segments, uint32_t* countRead) override;
+  bool ReadsGatheredSegments() override;
+
   // Initialize the connection:
   //  info        - specifies the connection parameters.
   //  maxHangTime - limits the amount of time this connection can spend on a
@@ -256,6 +260,8 @@ class nsHttpConnection final : public HttpConnectionBase,
   [[nodiscard]] nsresult DisableTCPKeepalives();
 
   bool CheckCanWrite0RTTData();
+  // Updates mSocketOutCondition after a write to mSocketOut.
+  nsresult OnSocketWritten(nsresult rv, uint32_t countWritten);
   void PostProcessNPNSetup(bool handshakeSucceeded, bool hasSecurityInfo,
                            bool earlyDataUsed);
   void Reset0RttForSpdy();
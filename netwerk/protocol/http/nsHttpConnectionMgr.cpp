@@ -221,6 +221,48 @@ class ConnEvent : public Runnable {
   RefPtr<ARefBase> mVParam;
 };
 
+class ConnEventBatch final : public Runnable {
+ public:
+  explicit ConnEventBatch(nsHttpConnectionMgr* mgr)
+      : Runnable("net::ConnEventBatch"), mMgr(mgr) {}
+
+  void Append(nsConnEventHandler handler, int32_t iparam, ARefBase* vparam) {
+    mMgr->mReentrantMonitor.AssertCurrentThreadIn();
+    mEvents.AppendElement(Event{handler, iparam, vparam});
+  }
+
+  NS_IMETHOD Run() override {
+    nsTArray<Event> events;
+    {
+      ReentrantMonitorAutoEnter mon(mMgr->mReentrantMonitor);
+      if (mMgr->mOpenEventBatch == this) {
+        mMgr->mOpenEventBatch = nullptr;
+      }
+      events = std::move(mEvents);
+    }
+
+    LOG(("ConnEventBatch::Run [this=%p events=%zu]\n", this,
+         events.Length()));
+    for (auto& event : events) {
+      (mMgr->*event.mHandler)(event.mIParam, event.mVParam);
+    }
+    return NS_OK;
+  }
+
+ private:
+  virtual ~ConnEventBatch() = default;
+
+  struct Event {
+    nsConnEventHandler mHandler;
+    int32_t mIParam;
+    RefPtr<ARefBase> mVParam;
+  };
+
+  RefPtr<nsHttpConnectionMgr> mMgr;
+  // Only accessed with the manager's mReentrantMonitor held.
+  nsTArray<Event> mEvents;
+};
+
 nsresult nsHttpConnectionMgr::PostEvent(nsConnEventHandler handler,
                                         int32_t iparam, ARefBase* vparam) {
   Unused << EnsureSocketThreadTarget();
@@ -229,6 +271,8 @@ nsresult nsHttpConnectionMgr::PostEvent(nsConnEventHandler handler,
   {
     ReentrantMonitorAutoEnter mon(mReentrantMonitor);
     target = mSocketThreadTarget;
+    // Events batched after this one must run after it too.
+    mOpenEventBatch = nullptr;
   }
 
   if (!target) {
@@ -240,6 +284,38 @@ nsresult nsHttpConnectionMgr::PostEvent(nsConnEventHandler handler,
   return target->Dispatch(event, NS_DISPATCH_NORMAL);
 }
 
+nsresult nsHttpConnectionMgr::PostBatchedEvent(nsConnEventHandler handler,
+                                               int32_t iparam,
+                                               ARefBase* vparam) {
+  if (!StaticPrefs::network_http_batch_transaction_events()) {
+    return PostEvent(handler, iparam, vparam);
+  }
+
+  Unused << EnsureSocketThreadTarget();
+
+  ReentrantMonitorAutoEnter mon(mReentrantMonitor);
+  if (!mSocketThreadTarget) {
+    NS_WARNING("cannot post event if not initialized");
+    return NS_ERROR_NOT_INITIALIZED;
+  }
+
+  if (mOpenEventBatch) {
+    mOpenEventBatch->Append(handler, iparam, vparam);
+    return NS_OK;
+  }
+
+  // Dispatch while holding the monitor, otherwise an event posted after this
+  // one by another thread could reach the socket thread first.
+  RefPtr<ConnEventBatch> batch = new ConnEventBatch(this);
+  batch->Append(handler, iparam, vparam);
+  nsresult rv = mSocketThreadTarget->Dispatch(do_AddRef(batch),
+                                              NS_DISPATCH_NORMAL);
+  if (NS_SUCCEEDED(rv)) {
+    mOpenEventBatch = std::move(batch);
+  }
+  return rv;
+}
+
 void nsHttpConnectionMgr::PruneDeadConnectionsAfter(uint32_t timeInSeconds) {
   LOG(("nsHttpConnectionMgr::PruneDeadConnectionsAfter\n"));
 
@@ -337,8 +413,8 @@ nsresult nsHttpConnectionMgr::AddTransaction(HttpTransactionShell* trans,
   LOG(("nsHttpConnectionMgr::AddTransaction [trans=%p %d]\n", trans, priority));
   // Make sure a transaction is not in a pending queue.
   CheckTransInPendingQueue(trans->AsHttpTransaction());
-  return PostEvent(&nsHttpConnectionMgr::OnMsgNewTransaction, priority,
-                   trans->AsHttpTransaction());
+  return PostBatchedEvent(&nsHttpConnectionMgr::OnMsgNewTransaction, priority,
+                          trans->AsHttpTransaction());
 }
 
 class NewTransactionData : public ARefBase {
@@ -372,16 +448,16 @@ nsresult nsHttpConnectionMgr::AddTransactionWithStickyConn(
   RefPtr<NewTransactionData> data =
       new NewTransactionData(trans->AsHttpTransaction(), priority,
                              transWithStickyConn->AsHttpTransaction());
-  return PostEvent(&nsHttpConnectionMgr::OnMsgNewTransactionWithStickyConn, 0,
-                   data);
+  return PostBatchedEvent(
+      &nsHttpConnectionMgr::OnMsgNewTransactionWithStickyConn, 0, data);
 }
 
 nsresult nsHttpConnectionMgr::RescheduleTransaction(HttpTransactionShell* trans,
                                                     int32_t priority) {
   LOG(("nsHttpConnectionMgr::RescheduleTransaction [trans=%p %d]\n", trans,
        priority));
-  return PostEvent(&nsHttpConnectionMgr::OnMsgReschedTransaction, priority,
-                   trans->AsHttpTransaction());
+  return PostBatchedEvent(&nsHttpConnectionMgr::OnMsgReschedTransaction,
+                          priority, trans->AsHttpTransaction());
 }
 
 void nsHttpConnectionMgr::UpdateClassOfServiceOnTransaction(
@@ -398,6 +474,7 @@ void nsHttpConnectionMgr::UpdateClassOfServiceOnTransaction(
   {
     ReentrantMonitorAutoEnter mon(mReentrantMonitor);
     target = mSocketThreadTarget;
+    mOpenEventBatch = nullptr;
   }
 
   if (!target) {
@@ -418,8 +495,9 @@ nsresult nsHttpConnectionMgr::CancelTransaction(HttpTransactionShell* trans,
                                                 nsresult reason) {
   LOG(("nsHttpConnectionMgr::CancelTransaction [trans=%p reason=%" PRIx32 "]\n",
        trans, static_cast<uint32_t>(reason)));
-  return PostEvent(&nsHttpConnectionMgr::OnMsgCancelTransaction,
-                   static_cast<int32_t>(reason), trans->AsHttpTransaction());
+  return PostBatchedEvent(&nsHttpConnectionMgr::OnMsgCancelTransaction,
+                          static_cast<int32_t>(reason),
+                          trans->AsHttpTransaction());
 }
 
 nsresult nsHttpConnectionMgr::PruneDeadConnections() {
@@ -556,6 +634,7 @@ nsresult nsHttpConnectionMgr::ReclaimConnection(HttpConnectionBase* conn) {
   {
     ReentrantMonitorAutoEnter mon(mReentrantMonitor);
     target = mSocketThreadTarget;
+    mOpenEventBatch = nullptr;
   }
 
   if (!target) {
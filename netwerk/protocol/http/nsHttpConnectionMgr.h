@@ -37,6 +37,7 @@ struct Http3ConnectionStatsParams;
 
 // message handlers have this signature
 class nsHttpConnectionMgr;
+class ConnEventBatch;
 using nsConnEventHandler = void (nsHttpConnectionMgr::*)(int32_t, ARefBase*);
 
 class nsHttpConnectionMgr final : public HttpConnectionMgrShell,
@@ -213,6 +214,7 @@ class nsHttpConnectionMgr final : public HttpConnectionMgrShell,
   void DecrementActiveConnCount(HttpConnectionBase*);
 
  private:
+  friend class ConnEventBatch;
   friend class DnsAndConnectSocket;
   friend class PendingTransactionInfo;
 
@@ -225,6 +227,9 @@ class nsHttpConnectionMgr final : public HttpConnectionMgrShell,
   // dispatched.
   nsCOMPtr<nsIEventTarget> mSocketThreadTarget
       MOZ_GUARDED_BY(mReentrantMonitor);
+  // The batch of transaction events that has been dispatched to the socket
+  // thread but not run yet, see PostBatchedEvent().
+  RefPtr<ConnEventBatch> mOpenEventBatch MOZ_GUARDED_BY(mReentrantMonitor);
 
   Atomic<bool, mozilla::Relaxed> mIsShuttingDown{false};
 
@@ -316,6 +321,12 @@ class nsHttpConnectionMgr final : public HttpConnectionMgrShell,
   [[nodiscard]] nsresult PostEvent(nsConnEventHandler handler,
                                    int32_t iparam = 0,
                                    ARefBase* vparam = nullptr);
+  // Like PostEvent(), but appends to the batch of events already waiting for
+  // the socket thread when there is one, so a burst of new, rescheduled and
+  // canceled transactions is handled by a single runnable. Events still run
+  // in the order they were posted, any other event closes the batch.
+  [[nodiscard]] nsresult PostBatchedEvent(nsConnEventHandler handler,
+                                          int32_t iparam, ARefBase* vparam);
 
   void OnMsgReclaimConnection(HttpConnectionBase*);
 
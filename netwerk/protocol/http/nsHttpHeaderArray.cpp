@@ -287,9 +287,7 @@ nsresult nsHttpHeaderArray::GetOriginalHeader(const nsHttpAtom& aHeader,
         continue;
       }
 
-      const nsCString& hdr = entry.headerNameOriginal.IsEmpty()
-                                 ? entry.header.val()
-                                 : entry.headerNameOriginal;
+      nsDependentCString hdr = entry.HeaderName();
 
       rv = NS_OK;
       if (NS_FAILED(aVisitor->VisitHeader(hdr, entry.value))) {
@@ -331,9 +329,7 @@ nsresult nsHttpHeaderArray::VisitHeaders(
       continue;
     }
 
-    const nsCString& hdr = entry.headerNameOriginal.IsEmpty()
-                               ? entry.header.val()
-                               : entry.headerNameOriginal;
+    nsDependentCString hdr = entry.HeaderName();
     rv = visitor->VisitHeader(hdr, entry.value);
     if (NS_FAILED(rv)) {
       return rv;
@@ -428,11 +424,7 @@ void nsHttpHeaderArray::Flatten(nsACString& buf, bool pruneProxyHeaders,
       continue;
     }
 
-    if (entry.headerNameOriginal.IsEmpty()) {
-      buf.Append(entry.header.val());
-    } else {
-      buf.Append(entry.headerNameOriginal);
-    }
+    buf.Append(entry.HeaderName());
     buf.AppendLiteral(": ");
     buf.Append(entry.value);
     buf.AppendLiteral("\r\n");
@@ -448,11 +440,7 @@ void nsHttpHeaderArray::FlattenOriginalHeader(nsACString& buf) {
       continue;
     }
 
-    if (entry.headerNameOriginal.IsEmpty()) {
-      buf.Append(entry.header.val());
-    } else {
-      buf.Append(entry.headerNameOriginal);
-    }
+    buf.Append(entry.HeaderName());
 
     buf.AppendLiteral(": ");
     buf.Append(entry.value);
@@ -465,7 +453,7 @@ const char* nsHttpHeaderArray::PeekHeaderAt(
   const nsEntry& entry = mHeaders[index];
 
   header = entry.header;
-  headerNameOriginal = entry.headerNameOriginal;
+  entry.headerNameOriginal.ToString(headerNameOriginal);
   return entry.value.get();
 }
 
@@ -7,6 +7,7 @@
 #ifndef nsHttpHeaderArray_h__
 #define nsHttpHeaderArray_h__
 
+#include "nsCompactString.h"
 #include "nsHttp.h"
 #include "nsTArray.h"
 #include "nsString.h"
@@ -125,10 +126,18 @@ class nsHttpHeaderArray {
   // Must be copy-constructable and assignable
   struct nsEntry {
     nsHttpAtom header;
-    nsCString headerNameOriginal;
+    // Most header names are short enough to be stored inline.
+    nsCompactCString headerNameOriginal;
     nsCString value;
     HeaderVariety variety = eVarietyUnknown;
 
+    // The name of the header as it was given.
+    nsDependentCString HeaderName() const {
+      return headerNameOriginal.IsEmpty()
+                 ? nsDependentCString(header.val().get(), header.val().Length())
+                 : headerNameOriginal.AsString();
+    }
+
     struct MatchHeader {
       bool Equals(const nsEntry& aEntry, const nsHttpAtom& aHeader) const {
         return aEntry.header == aHeader;
@@ -276,7 +285,8 @@ inline bool nsHttpHeaderArray::IsIgnoreMultipleHeader(
     entry->variety = eVarietyResponseNetOriginal;
     // Copy entry->headerNameOriginal because in SetHeader_internal we are going
     // to a new one and a realocation can happen.
-    nsCString headerNameOriginal = entry->headerNameOriginal;
+    nsCString headerNameOriginal;
+    entry->headerNameOriginal.ToString(headerNameOriginal);
     nsresult rv = SetHeader_internal(header, headerNameOriginal, newValue,
                                      eVarietyResponse);
     if (NS_FAILED(rv)) {
@@ -42,6 +42,7 @@
 #include "nsIDNSRecord.h"
 #include "nsIDNSService.h"
 #include "nsIEventTarget.h"
+#include "nsIGatherInputStream.h"
 #include "nsIHttpActivityObserver.h"
 #include "nsIHttpAuthenticator.h"
 #include "nsIInputStream.h"
@@ -270,6 +271,7 @@ nsresult nsHttpTransaction::Init(
 
   requestContentLength += mReqHeaderBuf.Length();
 
+  nsCOMPtr<nsIThrottledInputChannel> throttled = do_QueryInterface(eventsink);
   if (mHasRequestBody) {
     // wrap the headers and request body in a multiplexed input stream.
     RefPtr<nsMultiplexInputStream> multi = new nsMultiplexInputStream();
@@ -280,18 +282,28 @@ nsresult nsHttpTransaction::Init(
     rv = multi->AppendStream(requestBody);
     if (NS_FAILED(rv)) return rv;
 
-    // wrap the multiplexed input stream with a buffered input stream, so
-    // that we write data in the largest chunks possible.  this is actually
-    // necessary to workaround some common server bugs (see bug 137155).
-    rv = NS_NewBufferedInputStream(getter_AddRefs(mRequestStream),
-                                   multi.forget(),
-                                   nsIOService::gDefaultSegmentSize);
-    if (NS_FAILED(rv)) return rv;
+    nsCOMPtr<nsIGatherInputStream> gather = do_QueryObject(multi);
+    if (StaticPrefs::network_http_upload_gather_segments() && gather &&
+        !throttled) {
+      // ReadSegments() hands the segments of the headers and the body to an
+      // HTTP/1 connection all at once, it writes them with a single writev()
+      // or copies them together when it can't.  The stream is only wrapped
+      // for the other connections.
+      mRequestStream = multi.forget();
+      mRequestStreamUnbuffered = true;
+    } else {
+      // wrap the multiplexed input stream with a buffered input stream, so
+      // that we write data in the largest chunks possible.  this is actually
+      // necessary to workaround some common server bugs (see bug 137155).
+      rv = NS_NewBufferedInputStream(getter_AddRefs(mRequestStream),
+                                     multi.forget(),
+                                     nsIOService::gDefaultSegmentSize);
+      if (NS_FAILED(rv)) return rv;
+    }
   } else {
     mRequestStream = headers;
   }
 
-  nsCOMPtr<nsIThrottledInputChannel> throttled = do_QueryInterface(eventsink);
   if (throttled) {
     nsCOMPtr<nsIInputChannelThrottleQueue> queue;
     rv = throttled->GetThrottleQueue(getter_AddRefs(queue));
@@ -655,8 +667,8 @@ void nsHttpTransaction::OnTransportStatus(nsITransport* transport,
       MOZ_ASSERT(
           !mRequestStream,
           "mRequestStream should be tellable as it was wrapped in "
-          "nsBufferedInputStream, which provides the tellable interface even "
-          "when wrapping non-tellable streams.");
+          "nsBufferedInputStream or nsMultiplexInputStream, which provide "
+          "the tellable interface even when wrapping non-tellable streams.");
       progress = 0;
     } else {
       int64_t prog = 0;
@@ -707,6 +719,23 @@ nsresult nsHttpTransaction::ReadRequestSegment(nsIInputStream* stream,
   return NS_OK;
 }
 
+nsresult nsHttpTransaction::ReadRequestSegments(
+    nsIInputStream* stream, void* closure,
+    Span<const Span<const char>> segments, uint32_t* countRead) {
+  nsHttpTransaction* trans = (nsHttpTransaction*)closure;
+  nsresult rv = trans->mReader->OnReadSegments(segments, countRead);
+  if (NS_FAILED(rv)) {
+    trans->MaybeRefreshSecurityInfo();
+    return rv;
+  }
+
+  LOG(("nsHttpTransaction::ReadRequestSegments %p read=%u", trans,
+       *countRead));
+
+  trans->mSentData = true;
+  return NS_OK;
+}
+
 nsresult nsHttpTransaction::ReadSegments(nsAHttpSegmentReader* reader,
                                          uint32_t count, uint32_t* countRead) {
   LOG(("nsHttpTransaction::ReadSegments %p", this));
@@ -728,9 +757,25 @@ nsresult nsHttpTransaction::ReadSegments(nsAHttpSegmentReader* reader,
   }
 
   mDeferredSendProgress = false;
+  if (mRequestStreamUnbuffered && !reader->ReadsGatheredSegments()) {
+    mRequestStreamUnbuffered = false;
+    nsCOMPtr<nsIInputStream> buffered;
+    if (NS_SUCCEEDED(NS_NewBufferedInputStream(
+            getter_AddRefs(buffered), do_AddRef(mRequestStream),
+            nsIOService::gDefaultSegmentSize))) {
+      mRequestStream = std::move(buffered);
+    }
+  }
+
   mReader = reader;
-  nsresult rv =
-      mRequestStream->ReadSegments(ReadRequestSegment, this, count, countRead);
+  nsresult rv;
+  nsCOMPtr<nsIGatherInputStream> gather = do_QueryInterface(mRequestStream);
+  if (gather) {
+    rv = gather->ReadGathered(ReadRequestSegments, this, count, countRead);
+  } else {
+    rv = mRequestStream->ReadSegments(ReadRequestSegment, this, count,
+                                      countRead);
+  }
   mReader = nullptr;
 
   if (m0RTTInProgress && (mEarlyDataDisposition == EARLY_NONE) &&
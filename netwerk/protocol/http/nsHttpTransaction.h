@@ -213,6 +213,8 @@ class nsHttpTransaction final : public nsAHttpTransaction,
   [[nodiscard]] static nsresult ReadRequestSegment(nsIInputStream*, void*,
                                                    const char*, uint32_t,
                                                    uint32_t, uint32_t*);
+  [[nodiscard]] static nsresult ReadRequestSegments(
+      nsIInputStream*, void*, Span<const Span<const char>>, uint32_t*);
   [[nodiscard]] static nsresult WritePipeSegment(nsIOutputStream*, void*, char*,
                                                  uint32_t, uint32_t, uint32_t*);
 
@@ -442,6 +444,9 @@ class nsHttpTransaction final : public nsAHttpTransaction,
   bool mReceivedData{false};
   bool mStatusEventPending{false};
   bool mHasRequestBody{false};
+  // mRequestStream is the multiplexed stream of the headers and the body,
+  // not yet wrapped in a buffered stream.  See ReadSegments().
+  bool mRequestStreamUnbuffered{false};
   bool mProxyConnectFailed{false};
   bool mHttpResponseMatched{false};
   bool mPreserveStream{false};
@@ -0,0 +1,157 @@
+#include "gtest/gtest.h"
+#include "gtest/MozGTestBench.h"  // For MOZ_GTEST_BENCH
+
+#include "CacheFileMetadata.h"
+#include "CacheHashUtils.h"
+#include "CacheIndex.h"
+#include "nsAppDirectoryServiceDefs.h"
+#include "nsDirectoryServiceUtils.h"
+#include "nsIFile.h"
+#include "nsPrintfCString.h"
+#include "mozilla/EndianUtils.h"
+#include "prio.h"
+
+using namespace mozilla;
+using namespace mozilla::net;
+
+// Writes an entry file without data, just the metadata trailer:
+// [hash][header][key\0][offset of the metadata]
+static void WriteEntryFile(nsIFile* aDir, uint32_t aIndex) {
+  nsCOMPtr<nsIFile> file;
+  ASSERT_EQ(aDir->Clone(getter_AddRefs(file)), NS_OK);
+  ASSERT_EQ(file->AppendNative(nsPrintfCString("%08X", aIndex)), NS_OK);
+
+  nsPrintfCString key(":http://example.com/resource/%u", aIndex);
+
+  CacheFileMetadataHeader hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.mVersion = kCacheEntryVersion;
+  hdr.mFetchCount = 1;
+  hdr.mExpirationTime = nsICacheEntry::NO_EXPIRATION_TIME;
+  hdr.mKeySize = key.Length();
+
+  nsTArray<char> buf;
+  buf.SetLength(sizeof(uint32_t) + sizeof(hdr) + key.Length() + 1 +
+                sizeof(uint32_t));
+  char* p = buf.Elements() + sizeof(uint32_t);
+  hdr.WriteToBuf(p);
+  p += sizeof(hdr);
+  memcpy(p, key.get(), key.Length() + 1);
+  p += key.Length() + 1;
+  NetworkEndian::writeUint32(
+      buf.Elements(), CacheHash::Hash(buf.Elements() + sizeof(uint32_t),
+                                      p - buf.Elements() - sizeof(uint32_t)));
+  NetworkEndian::writeUint32(p, 0);
+
+  PRFileDesc* fd;
+  ASSERT_EQ(file->OpenNSPRFileDesc(PR_WRONLY | PR_CREATE_FILE | PR_TRUNCATE,
+                                   0600, &fd),
+            NS_OK);
+  ASSERT_EQ(PR_Write(fd, buf.Elements(), buf.Length()),
+            static_cast<int32_t>(buf.Length()));
+  PR_Close(fd);
+}
+
+class CacheIndexBuild : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_EQ(NS_GetSpecialDirectory(NS_OS_TEMP_DIR, getter_AddRefs(mDir)),
+              NS_OK);
+    ASSERT_EQ(mDir->AppendNative("cache2-index-build"_ns), NS_OK);
+    ASSERT_EQ(mDir->CreateUnique(nsIFile::DIRECTORY_TYPE, 0700), NS_OK);
+  }
+
+  void TearDown() override { mDir->Remove(true); }
+
+  void CreateEntries(uint32_t aCount) {
+    for (uint32_t i = 0; i < aCount; ++i) {
+      WriteEntryFile(mDir, i);
+    }
+  }
+
+  void CollectReads(nsTArray<CacheIndex::MetadataRead>& aReads,
+                    uint32_t aCount) {
+    for (uint32_t i = 0; i < aCount; ++i) {
+      CacheIndex::MetadataRead* read = aReads.AppendElement();
+      mDir->Clone(getter_AddRefs(read->mFile));
+      read->mLeaf = nsPrintfCString("%08X", i);
+      read->mFile->AppendNative(read->mLeaf);
+    }
+  }
+
+  // Reads the metadata of the first aCount entries.
+  void Rebuild(uint32_t aCount, uint32_t aThreads) {
+    nsTArray<CacheIndex::MetadataRead> reads;
+    CollectReads(reads, aCount);
+    CacheIndex::ReadMetadataInParallel(reads, aThreads);
+    for (const auto& read : reads) {
+      ASSERT_EQ(read.mResult, NS_OK);
+    }
+  }
+
+  nsCOMPtr<nsIFile> mDir;
+};
+
+TEST_F(CacheIndexBuild, ParallelMatchesSerial)
+{
+  CreateEntries(200);
+
+  nsTArray<CacheIndex::MetadataRead> serial;
+  CollectReads(serial, 200);
+  CacheIndex::ReadMetadataInParallel(serial, 1);
+
+  nsTArray<CacheIndex::MetadataRead> parallel;
+  CollectReads(parallel, 200);
+  CacheIndex::ReadMetadataInParallel(parallel, 4);
+
+  for (uint32_t i = 0; i < 200; ++i) {
+    ASSERT_EQ(serial[i].mResult, NS_OK);
+    ASSERT_EQ(parallel[i].mResult, NS_OK);
+    ASSERT_EQ(serial[i].mSize, parallel[i].mSize);
+    ASSERT_EQ(serial[i].mMetadata->GetFrecency(),
+              parallel[i].mMetadata->GetFrecency());
+    ASSERT_TRUE(serial[i].mMetadata->GetKey().Equals(
+        parallel[i].mMetadata->GetKey()));
+  }
+}
+
+TEST_F(CacheIndexBuild, CorruptedEntry)
+{
+  CreateEntries(3);
+
+  nsCOMPtr<nsIFile> file;
+  mDir->Clone(getter_AddRefs(file));
+  file->AppendNative("00000001"_ns);
+  file->Remove(false);
+  PRFileDesc* fd;
+  ASSERT_EQ(file->OpenNSPRFileDesc(PR_WRONLY | PR_CREATE_FILE, 0600, &fd),
+            NS_OK);
+  PR_Write(fd, "garbage", 7);
+  PR_Close(fd);
+
+  nsTArray<CacheIndex::MetadataRead> reads;
+  CollectReads(reads, 3);
+  CacheIndex::ReadMetadataInParallel(reads, 4);
+
+  ASSERT_EQ(reads[0].mResult, NS_OK);
+  ASSERT_TRUE(NS_FAILED(reads[1].mResult));
+  ASSERT_EQ(reads[2].mResult, NS_OK);
+}
+
+// Only the metadata reads are measured, not the creation of the entries.
+#define CACHE_INDEX_BUILD_BENCH(count, threads)                            \
+  TEST_F(CacheIndexBuild,                                                  \
+         DISABLED_Rebuild_##count##_Entries_##threads##_Threads)           \
+  {                                                                        \
+    CreateEntries(count);                                                  \
+    mozilla::GTestBench("CacheIndexBuild",                                 \
+                        "Rebuild_" #count "_Entries_" #threads "_Threads", \
+                        [this] { Rebuild(count, threads); });              \
+  }
+
+CACHE_INDEX_BUILD_BENCH(1000, 1)
+CACHE_INDEX_BUILD_BENCH(1000, 4)
+CACHE_INDEX_BUILD_BENCH(10000, 1)
+CACHE_INDEX_BUILD_BENCH(10000, 4)
+CACHE_INDEX_BUILD_BENCH(50000, 1)
+CACHE_INDEX_BUILD_BENCH(50000, 4)
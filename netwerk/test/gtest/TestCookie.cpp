@@ -1225,3 +1225,51 @@ TEST(TestCookie, MaxAgeParser)
   GetACookie(cookieService, "http://maxage.net/", cookieStr);
   EXPECT_TRUE(CheckResult(cookieStr.get(), MUST_EQUAL, ""));
 }
+
+TEST(TestCookie, HeaderCache)
+{
+  Preferences::SetBool("network.cookie.header_cache.enabled", true);
+
+  nsresult rv;
+  nsCOMPtr<nsICookieManager> cookieMgr =
+      do_GetService(NS_COOKIEMANAGER_CONTRACTID, &rv);
+  ASSERT_NS_SUCCEEDED(rv);
+
+  EXPECT_NS_SUCCEEDED(cookieMgr->RemoveAll());
+
+  nsCOMPtr<nsICookieService> cookieService =
+      do_GetService(kCookieServiceCID, &rv);
+  ASSERT_NS_SUCCEEDED(rv);
+
+  nsCString cookie;
+  SetACookie(cookieService, "http://headercache.test/", "a=1");
+  GetACookie(cookieService, "http://headercache.test/", cookie);
+  EXPECT_TRUE(CheckResult(cookie.get(), MUST_EQUAL, "a=1"));
+
+  // Adding a cookie drops what was cached for the base domain.
+  SetACookie(cookieService, "http://headercache.test/", "b=2; path=/foo");
+  GetACookie(cookieService, "http://headercache.test/foo/bar", cookie);
+  EXPECT_TRUE(CheckResult(cookie.get(), MUST_EQUAL, "b=2; a=1"));
+  GetACookie(cookieService, "http://headercache.test/foo", cookie);
+  EXPECT_TRUE(CheckResult(cookie.get(), MUST_EQUAL, "b=2; a=1"));
+
+  // Paths sharing the cookie path as a string prefix don't path-match it.
+  GetACookie(cookieService, "http://headercache.test/foobar", cookie);
+  EXPECT_TRUE(CheckResult(cookie.get(), MUST_EQUAL, "a=1"));
+  GetACookie(cookieService, "http://headercache.test/", cookie);
+  EXPECT_TRUE(CheckResult(cookie.get(), MUST_EQUAL, "a=1"));
+
+  // Other hosts of the base domain are cached separately.
+  GetACookie(cookieService, "http://www.headercache.test/foo", cookie);
+  EXPECT_TRUE(CheckResult(cookie.get(), MUST_BE_NULL));
+
+  // So does removing one.
+  SetACookie(cookieService, "http://headercache.test/", "a=1; max-age=-1");
+  GetACookie(cookieService, "http://headercache.test/foo/bar", cookie);
+  EXPECT_TRUE(CheckResult(cookie.get(), MUST_EQUAL, "b=2"));
+  GetACookie(cookieService, "http://headercache.test/", cookie);
+  EXPECT_TRUE(CheckResult(cookie.get(), MUST_BE_NULL));
+
+  EXPECT_NS_SUCCEEDED(cookieMgr->RemoveAll());
+  Preferences::ClearUser("network.cookie.header_cache.enabled");
+}
@@ -0,0 +1,224 @@
+#include "gtest/gtest.h"
+#include "gtest/MozGTestBench.h"  // For MOZ_GTEST_BENCH
+
+#include "Http2Compression.h"
+#include "Http2HuffmanOutgoing.h"
+#include "mozilla/Preferences.h"
+#include "mozilla/Unused.h"
+#include "nsSocketTransportService2.h"
+#include "nsTArray.h"
+#include "nsThreadUtils.h"
+
+using namespace mozilla;
+using namespace mozilla::net;
+
+static const char kMultiSymbolPref[] =
+    "network.http.http2.hpack_multi_symbol_huffman";
+
+// Response headers as sent by a few popular sites, the long ones are the
+// reason the decoder shows up in profiles.
+static const char* const kResponseHeaders[][2] = {
+    {"content-type", "text/html; charset=utf-8"},
+    {"cache-control", "private, max-age=0, must-revalidate, no-transform"},
+    {"date", "Tue, 13 Oct 2026 09:41:27 GMT"},
+    {"server", "nginx/1.25.3"},
+    {"vary", "Accept-Encoding, Origin, Sec-Fetch-Dest, Sec-Fetch-Mode"},
+    {"strict-transport-security", "max-age=63072000; includeSubDomains; "
+                                  "preload"},
+    {"set-cookie", "session_id=8f2c0a4e9b7d4c1fa3e6b5d2c8f1a7e4; Path=/; "
+                   "Domain=.example.com; Expires=Wed, 13 Oct 2027 09:41:27 "
+                   "GMT; Secure; HttpOnly; SameSite=Lax"},
+    {"set-cookie", "_ga=GA1.2.1234567890.1697190087; Path=/; Max-Age=63072000;"
+                   " Secure; SameSite=None"},
+    {"content-security-policy",
+     "default-src 'self'; script-src 'self' 'nonce-r4nd0mN0nc3Va1ue' "
+     "https://www.googletagmanager.com https://cdn.jsdelivr.net; style-src "
+     "'self' 'unsafe-inline' https://fonts.googleapis.com; img-src 'self' "
+     "data: blob: https://*.example-cdn.com; font-src 'self' "
+     "https://fonts.gstatic.com; connect-src 'self' wss://live.example.com "
+     "https://api.example.com; frame-ancestors 'none'; base-uri 'self'; "
+     "form-action 'self'; upgrade-insecure-requests; report-uri "
+     "/csp-report?v=2"},
+    {"link", "<https://cdn.example.com/static/css/main.4f2a8c1e.css>; "
+             "rel=preload; as=style, <https://cdn.example.com/static/js/"
+             "runtime.7b3e9d0f.js>; rel=preload; as=script, "
+             "<https://fonts.gstatic.com>; rel=preconnect; crossorigin"},
+    {"link", "<https://cdn.example.com/static/js/vendor.1c5d7e2a.js>; "
+             "rel=modulepreload, </api/v2/bootstrap?locale=en-US>; "
+             "rel=preload; as=fetch; crossorigin=anonymous"},
+    {"permissions-policy", "accelerometer=(), camera=(), geolocation=(self "
+                           "\"https://maps.example.com\"), gyroscope=(), "
+                           "magnetometer=(), microphone=(), payment=(), "
+                           "usb=(), interest-cohort=()"},
+    {"x-request-id", "6e0b4f3a-2c9d-4b7e-8a1f-5d3c2b1a0f9e"},
+    {"etag", "W/\"5f3a-18b2c7d4e9f\""},
+    {"last-modified", "Mon, 12 Oct 2026 22:03:51 GMT"},
+    {"accept-ranges", "bytes"},
+    {"alt-svc", "h3=\":443\"; ma=86400, h3-29=\":443\"; ma=86400"},
+    {"x-content-type-options", "nosniff"},
+    {"referrer-policy", "strict-origin-when-cross-origin"},
+    {"report-to", "{\"group\":\"csp-endpoint\",\"max_age\":10886400,"
+                  "\"endpoints\":[{\"url\":\"https://report.example.com/csp\""
+                  "}],\"include_subdomains\":true}"},
+};
+
+static void AppendInteger(nsACString& aOut, uint8_t aFirst, uint32_t aPrefix,
+                          uint32_t aValue) {
+  uint32_t max = (1 << aPrefix) - 1;
+  if (aValue < max) {
+    aOut.Append(static_cast<char>(aFirst | aValue));
+    return;
+  }
+  aOut.Append(static_cast<char>(aFirst | max));
+  aValue -= max;
+  while (aValue >= 0x80) {
+    aOut.Append(static_cast<char>(0x80 | (aValue & 0x7f)));
+    aValue >>= 7;
+  }
+  aOut.Append(static_cast<char>(aValue));
+}
+
+static void AppendHuffmanString(nsACString& aOut, const nsACString& aValue) {
+  nsAutoCString encoded;
+  uint64_t bits = 0;
+  uint32_t bitCount = 0;
+  for (uint32_t i = 0; i < aValue.Length(); ++i) {
+    uint8_t c = aValue[i];
+    bits = (bits << HuffmanOutgoing[c].mLength) | HuffmanOutgoing[c].mValue;
+    bitCount += HuffmanOutgoing[c].mLength;
+    while (bitCount >= 8) {
+      bitCount -= 8;
+      encoded.Append(static_cast<char>(bits >> bitCount));
+    }
+  }
+  if (bitCount) {
+    // Pad with the most significant bits of EOS.
+    encoded.Append(static_cast<char>((bits << (8 - bitCount)) |
+                                     ((1 << (8 - bitCount)) - 1)));
+  }
+  AppendInteger(aOut, 0x80, 7, encoded.Length());
+  aOut.Append(encoded);
+}
+
+// A header block of literals without indexing, with both the names and the
+// values Huffman encoded.
+static nsCString BuildHeaderBlock() {
+  nsCString block;
+  for (const auto& header : kResponseHeaders) {
+    AppendInteger(block, 0x00, 4, 0);
+    AppendHuffmanString(block, nsDependentCString(header[0]));
+    AppendHuffmanString(block, nsDependentCString(header[1]));
+  }
+  return block;
+}
+
+static void RunOnSocketThread(std::function<void()>&& aFunc) {
+  nsCOMPtr<nsISocketTransportService> service =
+      do_GetService("@mozilla.org/network/socket-transport-service;1");
+  ASSERT_TRUE(service);
+  NS_DispatchAndSpinEventLoopUntilComplete(
+      "TestHpackHuffman"_ns, gSocketTransportService,
+      NS_NewRunnableFunction("TestHpackHuffman", std::move(aFunc)));
+}
+
+static nsresult Decode(const nsACString& aBlock, bool aMultiSymbol,
+                       nsACString& aOutput) {
+  Preferences::SetBool(kMultiSymbolPref, aMultiSymbol);
+  nsresult rv = NS_ERROR_UNEXPECTED;
+  RunOnSocketThread([&]() {
+    Http2Decompressor decompressor;
+    rv = decompressor.DecodeHeaderBlock(
+        reinterpret_cast<const uint8_t*>(aBlock.BeginReading()),
+        aBlock.Length(), aOutput, false);
+  });
+  return rv;
+}
+
+static void ExpectSameResult(const nsACString& aBlock) {
+  nsAutoCString legacy;
+  nsresult legacyRv = Decode(aBlock, false, legacy);
+  nsAutoCString multi;
+  nsresult multiRv = Decode(aBlock, true, multi);
+  Preferences::ClearUser(kMultiSymbolPref);
+
+  ASSERT_EQ(legacyRv, multiRv);
+  if (NS_SUCCEEDED(legacyRv)) {
+    ASSERT_TRUE(legacy.Equals(multi));
+  }
+}
+
+TEST(TestHpackHuffman, ResponseHeaders)
+{
+  nsCString block = BuildHeaderBlock();
+  nsAutoCString output;
+  ASSERT_EQ(Decode(block, true, output), NS_OK);
+  Preferences::ClearUser(kMultiSymbolPref);
+  ASSERT_NE(output.Find("report-uri /csp-report?v=2"), kNotFound);
+
+  ExpectSameResult(block);
+}
+
+TEST(TestHpackHuffman, AllSymbols)
+{
+  nsAutoCString value;
+  for (uint32_t i = 0; i < 256; ++i) {
+    value.Append(static_cast<char>(i));
+  }
+
+  // Shift the codes to every possible bit offset.
+  for (uint32_t i = 0; i < 8; ++i) {
+    nsAutoCString block;
+    AppendInteger(block, 0x00, 4, 0);
+    AppendHuffmanString(block, "x"_ns);
+    AppendHuffmanString(block, nsAutoCString(Substring(value, 0, i) + value));
+    ExpectSameResult(block);
+  }
+}
+
+TEST(TestHpackHuffman, InvalidEncodings)
+{
+  const uint8_t kEOS[] = {0xff, 0xff, 0xff, 0xfc};
+  // 'a' is 00011, this is padded with 8 bits.
+  const uint8_t kLongPadding[] = {0x1f, 0xff};
+  // 'a' followed by padding that isn't all ones.
+  const uint8_t kBadPadding[] = {0x1e};
+  // The start of a 30 bit code.
+  const uint8_t kTruncated[] = {0xff, 0xff, 0xff};
+
+  for (const auto& encoded :
+       {Span<const uint8_t>(kEOS), Span<const uint8_t>(kLongPadding),
+        Span<const uint8_t>(kBadPadding), Span<const uint8_t>(kTruncated)}) {
+    nsAutoCString block;
+    AppendInteger(block, 0x00, 4, 0);
+    AppendHuffmanString(block, "x"_ns);
+    AppendInteger(block, 0x80, 7, encoded.Length());
+    block.Append(reinterpret_cast<const char*>(encoded.Elements()),
+                 encoded.Length());
+
+    nsAutoCString output;
+    ASSERT_TRUE(NS_FAILED(Decode(block, true, output)));
+    ExpectSameResult(block);
+  }
+}
+
+// Decodes the header block 1000 times, only on the socket thread.
+static void BenchDecode(bool aMultiSymbol) {
+  nsCString block = BuildHeaderBlock();
+  Preferences::SetBool(kMultiSymbolPref, aMultiSymbol);
+  RunOnSocketThread([&]() {
+    Http2Decompressor decompressor;
+    nsAutoCString output;
+    for (uint32_t i = 0; i < 1000; ++i) {
+      Unused << decompressor.DecodeHeaderBlock(
+          reinterpret_cast<const uint8_t*>(block.BeginReading()),
+          block.Length(), output, false);
+    }
+  });
+  Preferences::ClearUser(kMultiSymbolPref);
+}
+
+MOZ_GTEST_BENCH(TestHpackHuffman, DISABLED_DecodeLegacy,
+                [] { BenchDecode(false); });
+
+MOZ_GTEST_BENCH(TestHpackHuffman, DISABLED_DecodeMultiSymbol,
+                [] { BenchDecode(true); });
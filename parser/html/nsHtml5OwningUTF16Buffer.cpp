@@ -55,3 +55,10 @@ Span<char16_t> nsHtml5OwningUTF16Buffer::TailAsSpan(int32_t aBufferSize) {
 void nsHtml5OwningUTF16Buffer::AdvanceEnd(int32_t aNumberOfCodeUnits) {
   setEnd(getEnd() + aNumberOfCodeUnits);
 }
+
+void nsHtml5OwningUTF16Buffer::Reset() {
+  MOZ_ASSERT(!key, "Parser key placeholders aren't reused");
+  setStart(0);
+  setEnd(0);
+  next = nullptr;
+}
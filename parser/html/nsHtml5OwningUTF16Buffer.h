@@ -59,6 +59,17 @@ class nsHtml5OwningUTF16Buffer : public nsHtml5UTF16Buffer {
    * Add the argument to `end`.
    */
   void AdvanceEnd(int32_t aNumberOfCodeUnits);
+
+  /**
+   * Whether the caller holds the only reference to this buffer, so that
+   * nothing can read it anymore.
+   */
+  bool HasOneRef() const { return mRefCnt == 1; }
+
+  /**
+   * Empty this buffer and drop its `next` buffer, for reuse.
+   */
+  void Reset();
 };
 
 #endif  // nsHtml5OwningUTF16Buffer_h
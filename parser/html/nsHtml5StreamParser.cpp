@@ -863,6 +863,33 @@ inline void nsHtml5StreamParser::OnContentComplete() {
   }
 }
 
+// The most buffers to keep for reuse. The tokenizer usually keeps up with the
+// network, so only a few buffers are ever waiting to be tokenized.
+static const size_t kMaxSpareBuffers = 8;
+
+already_AddRefed<nsHtml5OwningUTF16Buffer>
+nsHtml5StreamParser::TakeReadBuffer() {
+  NS_ASSERTION(IsParserThread(), "Wrong thread!");
+  if (!mSpareBuffers.IsEmpty()) {
+    return mSpareBuffers.PopLastElement().forget();
+  }
+  return nsHtml5OwningUTF16Buffer::FalliblyCreate(READ_BUFFER_SIZE);
+}
+
+void nsHtml5StreamParser::RecycleReadBuffer(
+    RefPtr<nsHtml5OwningUTF16Buffer>&& aBuffer) {
+  NS_ASSERTION(IsParserThread(), "Wrong thread!");
+  RefPtr<nsHtml5OwningUTF16Buffer> buffer = std::move(aBuffer);
+  // Speculations and the meta charset scan keep references to the buffers
+  // they may have to tokenize again.
+  if (!buffer->HasOneRef() || buffer == mLastBuffer ||
+      mSpareBuffers.Length() == kMaxSpareBuffers) {
+    return;
+  }
+  buffer->Reset();
+  mSpareBuffers.AppendElement(std::move(buffer));
+}
+
 nsresult nsHtml5StreamParser::WriteStreamBytes(
     Span<const uint8_t> aFromSegment) {
   NS_ASSERTION(IsParserThread(), "Wrong thread!");
@@ -893,8 +920,7 @@ nsresult nsHtml5StreamParser::WriteStreamBytes(
     totalRead += read;
     mLastBuffer->AdvanceEnd(written);
     if (result == kOutputFull) {
-      RefPtr<nsHtml5OwningUTF16Buffer> newBuf =
-          nsHtml5OwningUTF16Buffer::FalliblyCreate(READ_BUFFER_SIZE);
+      RefPtr<nsHtml5OwningUTF16Buffer> newBuf = TakeReadBuffer();
       if (!newBuf) {
         MarkAsBroken(NS_ERROR_OUT_OF_MEMORY);
         return NS_ERROR_OUT_OF_MEMORY;
@@ -1317,8 +1343,7 @@ void nsHtml5StreamParser::DoStopRequest() {
     MOZ_ASSERT(read == 0, "How come an empty span was read form?");
     mLastBuffer->AdvanceEnd(written);
     if (result == kOutputFull) {
-      RefPtr<nsHtml5OwningUTF16Buffer> newBuf =
-          nsHtml5OwningUTF16Buffer::FalliblyCreate(READ_BUFFER_SIZE);
+      RefPtr<nsHtml5OwningUTF16Buffer> newBuf = TakeReadBuffer();
       if (!newBuf) {
         MarkAsBroken(NS_ERROR_OUT_OF_MEMORY);
         return;
@@ -2485,7 +2510,9 @@ void nsHtml5StreamParser::ParseAvailableData() {
             return;
         }
       }
-      mFirstBuffer = mFirstBuffer->next;
+      RefPtr<nsHtml5OwningUTF16Buffer> consumed = std::move(mFirstBuffer);
+      mFirstBuffer = consumed->next;
+      RecycleReadBuffer(std::move(consumed));
       continue;
     }
 
@@ -400,6 +400,20 @@ class nsHtml5StreamParser final : public nsISupports {
    *                machine state.
    * @param aFromSegment The current network buffer
    */
+  /**
+   * Returns an empty buffer of READ_BUFFER_SIZE to decode into, reusing one
+   * that the tokenizer is done with if possible.
+   */
+  already_AddRefed<nsHtml5OwningUTF16Buffer> TakeReadBuffer()
+      MOZ_REQUIRES(mTokenizerMutex);
+
+  /**
+   * Keeps aBuffer, which the tokenizer is done with, for TakeReadBuffer() to
+   * reuse if nothing else references it.
+   */
+  void RecycleReadBuffer(RefPtr<nsHtml5OwningUTF16Buffer>&& aBuffer)
+      MOZ_REQUIRES(mTokenizerMutex);
+
   nsresult SetupDecodingAndWriteSniffingBufferAndCurrentSegment(
       mozilla::Span<const uint8_t> aPrefix,
       mozilla::Span<const uint8_t> aFromSegment) MOZ_REQUIRES(mTokenizerMutex);
@@ -597,6 +611,13 @@ class nsHtml5StreamParser final : public nsISupports {
    */
   RefPtr<nsHtml5OwningUTF16Buffer> mFirstBufferOfMetaScan;
 
+  /**
+   * Buffers of READ_BUFFER_SIZE that the tokenizer is done with, and which
+   * nothing else references, to decode into instead of allocating new ones.
+   * Only used on the parser thread.
+   */
+  nsTArray<RefPtr<nsHtml5OwningUTF16Buffer>> mSpareBuffers;
+
   /**
    * The tree operation executor
    */
@@ -111,7 +111,9 @@ nsHtml5String nsHtml5String::FromBuffer(char16_t* aBuffer, int32_t aLength,
   // StringBuffer and to make sure the allocation strategy matches
   // nsAttrValue::GetStringBuffer, so that it doesn't need to reallocate and
   // copy.
-  RefPtr<StringBuffer> buffer = StringBuffer::Create(aBuffer, aLength);
+  RefPtr<StringBuffer> buffer =
+      aTreeBuilder ? aTreeBuilder->CreateStringBuffer(aBuffer, aLength)
+                   : StringBuffer::Create(aBuffer, aLength);
   if (MOZ_UNLIKELY(!buffer)) {
     if (!aTreeBuilder) {
       MOZ_CRASH("Out of memory.");
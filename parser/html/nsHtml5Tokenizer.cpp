@@ -482,6 +482,7 @@ stateloop:
           if (reconsume) {
             reconsume = false;
           } else {
+            pos = P::skipPlainChars(this, buf, pos, endPos, '<');
             if (++pos == endPos) {
               NS_HTML5_BREAK(stateloop);
             }
@@ -909,6 +910,11 @@ stateloop:
           if (reconsume) {
             reconsume = false;
           } else {
+            int32_t plainEnd = P::skipPlainChars(this, buf, pos, endPos, '\"');
+            if (plainEnd != pos) {
+              appendStrBuf(buf, pos + 1, plainEnd - pos);
+              pos = plainEnd;
+            }
             if (++pos == endPos) {
               NS_HTML5_BREAK(stateloop);
             }
@@ -1947,6 +1953,11 @@ stateloop:
           if (reconsume) {
             reconsume = false;
           } else {
+            int32_t plainEnd = P::skipPlainChars(this, buf, pos, endPos, '\'');
+            if (plainEnd != pos) {
+              appendStrBuf(buf, pos + 1, plainEnd - pos);
+              pos = plainEnd;
+            }
             if (++pos == endPos) {
               NS_HTML5_BREAK(stateloop);
             }
@@ -2516,6 +2527,7 @@ stateloop:
           if (reconsume) {
             reconsume = false;
           } else {
+            pos = P::skipPlainChars(this, buf, pos, endPos, '<');
             if (++pos == endPos) {
               NS_HTML5_BREAK(stateloop);
             }
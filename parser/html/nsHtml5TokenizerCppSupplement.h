@@ -5,6 +5,14 @@
 #include "mozilla/CheckedInt.h"
 #include "mozilla/Likely.h"
 
+#if defined(MOZ_HTML5_TOKENIZER_SCAN_SSE2)
+#  include "mozilla/SSE.h"
+#  include "nsHtml5TokenizerScanGenericFwd.h"
+#elif defined(MOZ_HTML5_TOKENIZER_SCAN_NEON)
+#  include "mozilla/arm.h"
+#  include "nsHtml5TokenizerScanGenericFwd.h"
+#endif
+
 // INT32_MAX is (2^31)-1. Therefore, the highest power-of-two that fits
 // is 2^30. Note that this is counting char16_t units. The underlying
 // bytes will be twice that, but they fit even in 32-bit size_t even
@@ -61,6 +69,27 @@ bool nsHtml5Tokenizer::EnsureBufferSpace(int32_t aLength) {
   return true;
 }
 
+int32_t nsHtml5Tokenizer::SkipPlainTextBatches(const char16_t* aBuf,
+                                               int32_t aStart, int32_t aEnd,
+                                               char16_t aQuote) {
+  if (aStart >= aEnd) {
+    return 0;
+  }
+  size_t skipped = 0;
+#if defined(MOZ_HTML5_TOKENIZER_SCAN_SSE2)
+  if (mozilla::supports_sse2()) {
+    skipped = mozilla::SkipTokenizerTextBatches<xsimd::sse2>(
+        aBuf + aStart, aEnd - aStart, aQuote);
+  }
+#elif defined(MOZ_HTML5_TOKENIZER_SCAN_NEON)
+  if (mozilla::supports_neon()) {
+    skipped = mozilla::SkipTokenizerTextBatches<xsimd::neon>(
+        aBuf + aStart, aEnd - aStart, aQuote);
+  }
+#endif
+  return int32_t(skipped);
+}
+
 bool nsHtml5Tokenizer::TemplatePushedOrHeadPopped() {
   if (encodingDeclarationHandler) {
     return encodingDeclarationHandler->TemplatePushedOrHeadPopped();
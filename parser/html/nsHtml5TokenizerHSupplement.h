@@ -33,6 +33,16 @@ inline nsHtml5HtmlAttributes* GetAttributes() { return attributes; }
  */
 bool EnsureBufferSpace(int32_t aLength);
 
+/**
+ * Returns how many of the UTF-16 code units of aBuf from aStart to aEnd the
+ * data, RCDATA and quoted attribute value states can skip without looking at
+ * them one at a time, because none of them is `<`, `&`, aQuote, CR, LF, NUL
+ * or a low surrogate (which the column count skips). Only whole SIMD batches
+ * are skipped, so this returns 0 on platforms without SSE2 or NEON.
+ */
+static int32_t SkipPlainTextBatches(const char16_t* aBuf, int32_t aStart,
+                                    int32_t aEnd, char16_t aQuote);
+
 bool TemplatePushedOrHeadPopped();
 
 void RememberGt(int32_t aPos);
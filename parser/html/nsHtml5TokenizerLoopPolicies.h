@@ -28,6 +28,17 @@ struct nsHtml5FastestPolicy {
   }
 
   static void silentLineFeed(nsHtml5Tokenizer* aTokenizer) {}
+
+  /**
+   * Returns the position of the last of the characters after pos that
+   * nsHtml5Tokenizer::SkipPlainTextBatches() skips, as if checkChar() had
+   * been called for each of them, or pos if it skips none.
+   */
+  static int32_t skipPlainChars(nsHtml5Tokenizer* aTokenizer, char16_t* buf,
+                                int32_t pos, int32_t endPos, char16_t aQuote) {
+    return pos + nsHtml5Tokenizer::SkipPlainTextBatches(buf, pos + 1, endPos,
+                                                        aQuote);
+  }
 };
 
 /**
@@ -88,6 +99,20 @@ struct nsHtml5LineColPolicy {
   static void silentLineFeed(nsHtml5Tokenizer* aTokenizer) {
     aTokenizer->nextCharOnNewLine = true;
   }
+
+  static int32_t skipPlainChars(nsHtml5Tokenizer* aTokenizer, char16_t* buf,
+                                int32_t pos, int32_t endPos, char16_t aQuote) {
+    if (MOZ_UNLIKELY(aTokenizer->nextCharOnNewLine)) {
+      // Let checkChar() move to the next line first.
+      return pos;
+    }
+    // None of the skipped characters is a low surrogate, so each of them
+    // counts as a column.
+    int32_t skipped = nsHtml5Tokenizer::SkipPlainTextBatches(buf, pos + 1,
+                                                             endPos, aQuote);
+    aTokenizer->col += skipped;
+    return pos + skipped;
+  }
 };
 
 /**
@@ -118,6 +143,12 @@ struct nsHtml5ViewSourcePolicy {
   static void silentLineFeed(nsHtml5Tokenizer* aTokenizer) {
     aTokenizer->line++;
   }
+
+  static int32_t skipPlainChars(nsHtml5Tokenizer* aTokenizer, char16_t* buf,
+                                int32_t pos, int32_t endPos, char16_t aQuote) {
+    return pos + nsHtml5Tokenizer::SkipPlainTextBatches(buf, pos + 1, endPos,
+                                                        aQuote);
+  }
 };
 
 #endif  // nsHtml5TokenizerLoopPolicies_h
@@ -0,0 +1,45 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef nsHtml5TokenizerScanGeneric_h__
+#define nsHtml5TokenizerScanGeneric_h__
+
+#include "nsHtml5TokenizerScanGenericFwd.h"
+
+namespace mozilla {
+
+template <class Arch>
+size_t SkipTokenizerTextBatches(const char16_t* aBuf, size_t aLength,
+                                char16_t aQuote) {
+  using batch = xsimd::batch<uint16_t, Arch>;
+  const size_t numCharsPerVector = batch::size;
+  const auto* buf = reinterpret_cast<const uint16_t*>(aBuf);
+
+  const batch lt(static_cast<uint16_t>('<'));
+  const batch amp(static_cast<uint16_t>('&'));
+  const batch quote(static_cast<uint16_t>(aQuote));
+  const batch cr(static_cast<uint16_t>('\r'));
+  const batch lf(static_cast<uint16_t>('\n'));
+  const batch nul(static_cast<uint16_t>(0));
+  const batch surrogateMask(static_cast<uint16_t>(0xFC00));
+  const batch lowSurrogate(static_cast<uint16_t>(0xDC00));
+
+  size_t i = 0;
+  for (; i + numCharsPerVector <= aLength; i += numCharsPerVector) {
+    const batch vect = batch::load_unaligned(buf + i);
+    const auto special = (vect == lt) | (vect == amp) | (vect == quote) |
+                         (vect == cr) | (vect == lf) | (vect == nul) |
+                         ((vect & surrogateMask) == lowSurrogate);
+    if (xsimd::any(special)) {
+      break;
+    }
+  }
+  return i;
+}
+
+}  // namespace mozilla
+
+#endif
@@ -0,0 +1,24 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef nsHtml5TokenizerScanGenericFwd_h__
+#define nsHtml5TokenizerScanGenericFwd_h__
+
+#include <cstddef>
+#include <xsimd/xsimd.hpp>
+
+namespace mozilla {
+
+// See nsHtml5Tokenizer::SkipPlainTextBatches().  This only looks at whole
+// batches and returns the offset of the first batch with a character that
+// isn't plain, the tokenizer handles the rest one character at a time.
+template <class Arch>
+size_t SkipTokenizerTextBatches(const char16_t* aBuf, size_t aLength,
+                                char16_t aQuote);
+
+}  // namespace mozilla
+
+#endif
@@ -15,6 +15,7 @@
 #include "mozilla/dom/ShadowRootBinding.h"
 #include "mozilla/glean/ParserHtmlMetrics.h"
 #include "mozilla/CheckedInt.h"
+#include "mozilla/HashFunctions.h"
 #include "mozilla/Likely.h"
 #include "mozilla/StaticPrefs_dom.h"
 #include "mozilla/StaticPrefs_network.h"
@@ -1142,6 +1143,9 @@ void nsHtml5TreeBuilder::start(bool fragment) {
 
 void nsHtml5TreeBuilder::end() {
   mOpQueue.Clear();
+  for (RefPtr<mozilla::StringBuffer>& buffer : mSharedStringBuffers) {
+    buffer = nullptr;
+  }
 #ifdef DEBUG
   mActive = false;
 #endif
@@ -1619,6 +1623,22 @@ void nsHtml5TreeBuilder::MarkAsBroken(nsresult aRv) {
   mOpQueue.AppendElement()->Init(mozilla::AsVariant(operation));
 }
 
+already_AddRefed<mozilla::StringBuffer> nsHtml5TreeBuilder::CreateStringBuffer(
+    const char16_t* aBuffer, int32_t aLength) {
+  if (aLength > kMaxSharedStringBufferLength) {
+    return mozilla::StringBuffer::Create(aBuffer, aLength);
+  }
+  RefPtr<mozilla::StringBuffer>& shared =
+      mSharedStringBuffers[mozilla::HashString(aBuffer, aLength) %
+                           kSharedStringBuffersLength];
+  if (!shared ||
+      shared->StorageSize() != (aLength + 1) * sizeof(char16_t) ||
+      memcmp(shared->Data(), aBuffer, aLength * sizeof(char16_t))) {
+    shared = mozilla::StringBuffer::Create(aBuffer, aLength);
+  }
+  return do_AddRef(shared);
+}
+
 void nsHtml5TreeBuilder::MarkAsBrokenFromPortability(nsresult aRv) {
   if (mBuilder) {
     MarkAsBrokenAndRequestSuspensionWithBuilder(aRv);
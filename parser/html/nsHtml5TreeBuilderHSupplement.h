@@ -52,6 +52,15 @@ bool mHasSeenImportMap;
 bool mActive;
 #endif
 
+/**
+ * The buffers of recently created short strings, by the hash of their
+ * characters, so that the attribute values of similar elements, like the
+ * cells of a table, share their buffer in the DOM too.
+ */
+static constexpr uint32_t kSharedStringBuffersLength = 64;
+static constexpr int32_t kMaxSharedStringBufferLength = 32;
+RefPtr<mozilla::StringBuffer> mSharedStringBuffers[kSharedStringBuffersLength];
+
 // DocumentModeHandler
 /**
  * Tree builder uses this to report quirkiness of the document
@@ -297,6 +306,13 @@ void errListUnclosedStartTags(int32_t aIgnored);
 
 void MarkAsBroken(nsresult aRv);
 
+/**
+ * Returns an exactly-sized buffer holding aBuffer, which may be shared with
+ * the strings created before.  Returns null on OOM.
+ */
+already_AddRefed<mozilla::StringBuffer> CreateStringBuffer(
+    const char16_t* aBuffer, int32_t aLength);
+
 /**
  * Checks if this parser is broken. Returns a non-NS_OK (i.e. non-0)
  * value if broken.
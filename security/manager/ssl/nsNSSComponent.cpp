@@ -1569,6 +1569,8 @@ nsresult nsNSSComponent::InitializeNSS() {
 
   MOZ_LOG(gPIPNSSLog, LogLevel::Debug, ("NSS Initialization done\n"));
 
+  mozilla::net::SSLTokensCache::LoadPersisted();
+
   {
     MutexAutoLock lock(mMutex);
 
@@ -1613,6 +1615,9 @@ void nsNSSComponent::PrepareForShutdown() {
   MOZ_LOG(gPIPNSSLog, LogLevel::Debug, ("nsNSSComponent::PrepareForShutdown"));
   MOZ_RELEASE_ASSERT(NS_IsMainThread());
 
+  // Encrypting the tokens needs the key database.
+  mozilla::net::SSLTokensCache::Persist();
+
   PK11_SetPasswordFunc((PK11PasswordFunc) nullptr);
 
   Preferences::RemoveObserver(this, "security.");
@@ -509,6 +509,23 @@ NS_INTERFACE_MAP_END
 NS_IMPL_CYCLE_COLLECTING_ADDREF(MatchPattern)
 NS_IMPL_CYCLE_COLLECTING_RELEASE(MatchPattern)
 
+MatchPatternSetCore::MatchPatternSetCore(ArrayType&& aPatterns)
+    : mPatterns(std::move(aPatterns)) {
+  if (mPatterns.Length() < kMinIndexedPatterns) {
+    return;
+  }
+
+  mDomainIndex = MakeUnique<DomainIndex>();
+  for (const auto& pattern : mPatterns) {
+    if (pattern->mDomain.IsEmpty()) {
+      mDomainIndex->mWithoutDomain.AppendElement(pattern);
+    } else {
+      mDomainIndex->mByDomain.LookupOrInsert(pattern->mDomain)
+          .AppendElement(pattern);
+    }
+  }
+}
+
 bool MatchPatternSetCore::Matches(const nsAString& aURL, bool aExplicit,
                                   ErrorResult& aRv) const {
   nsCOMPtr<nsIURI> uri;
@@ -522,12 +539,40 @@ bool MatchPatternSetCore::Matches(const nsAString& aURL, bool aExplicit,
 }
 
 bool MatchPatternSetCore::Matches(const URLInfo& aURL, bool aExplicit) const {
-  for (const auto& pattern : mPatterns) {
+  if (!mDomainIndex) {
+    for (const auto& pattern : mPatterns) {
+      if (pattern->Matches(aURL, aExplicit)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  for (const auto* pattern : mDomainIndex->mWithoutDomain) {
     if (pattern->Matches(aURL, aExplicit)) {
       return true;
     }
   }
-  return false;
+
+  // A pattern with a domain only matches hosts that are its domain or, if it
+  // matches subdomains, end with a dot followed by its domain.
+  const nsCString& host = aURL.Host();
+  for (int32_t offset = 0;;) {
+    if (const auto* patterns =
+            mDomainIndex->mByDomain.Lookup(Substring(host, offset))
+                .DataPtrOrNull()) {
+      for (const auto* pattern : *patterns) {
+        if (pattern->Matches(aURL, aExplicit)) {
+          return true;
+        }
+      }
+    }
+    int32_t dot = host.FindChar('.', offset);
+    if (dot == kNotFound) {
+      return false;
+    }
+    offset = dot + 1;
+  }
 }
 
 bool MatchPatternSetCore::MatchesAllWebUrls() const {
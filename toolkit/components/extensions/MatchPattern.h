@@ -18,9 +18,11 @@
 #include "mozilla/Likely.h"
 #include "mozilla/Maybe.h"
 #include "mozilla/RefCounted.h"
+#include "mozilla/UniquePtr.h"
 #include "nsCOMPtr.h"
 #include "nsCycleCollectionParticipant.h"
 #include "nsTArray.h"
+#include "nsTHashMap.h"
 #include "nsAtom.h"
 #include "nsICookie.h"
 #include "nsISupports.h"
@@ -187,6 +189,8 @@ class MatchPatternCore final {
   void GetPattern(nsAString& aPattern) const { aPattern = mPattern; }
 
  private:
+  friend class MatchPatternSetCore;
+
   ~MatchPatternCore() = default;
 
   // The normalized match pattern string that this object represents.
@@ -294,8 +298,7 @@ class MatchPatternSetCore final {
 
   using ArrayType = nsTArray<RefPtr<MatchPatternCore>>;
 
-  explicit MatchPatternSetCore(ArrayType&& aPatterns)
-      : mPatterns(std::move(aPatterns)) {}
+  explicit MatchPatternSetCore(ArrayType&& aPatterns);
 
   static already_AddRefed<MatchPatternSet> Constructor(
       dom::GlobalObject& aGlobal,
@@ -329,7 +332,21 @@ class MatchPatternSetCore final {
 
   ~MatchPatternSetCore() = default;
 
+  // Sets with fewer patterns are cheaper to match one pattern at a time.
+  static constexpr size_t kMinIndexedPatterns = 16;
+
+  // The patterns of a large set, by the domain they match, so that matching a
+  // URL only checks the patterns for its host and its parent domains, and the
+  // ones without a domain, like "*://*/*".  Webextensions that filter their
+  // webRequest listeners with long lists of hosts check every request against
+  // every pattern otherwise.
+  struct DomainIndex {
+    nsTHashMap<nsCStringHashKey, nsTArray<MatchPatternCore*>> mByDomain;
+    nsTArray<MatchPatternCore*> mWithoutDomain;
+  };
+
   ArrayType mPatterns;
+  UniquePtr<DomainIndex> mDomainIndex;
 };
 
 class MatchPatternSet final : public nsISupports, public nsWrapperCache {
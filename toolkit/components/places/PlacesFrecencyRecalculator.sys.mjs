@@ -83,6 +83,12 @@ const DEFERRED_TASK_INTERVAL_MS = 2 * 60000;
 const DEFERRED_TASK_MAX_IDLE_WAIT_MS = 5 * 60000;
 // Number of entries to update at once.
 const DEFAULT_CHUNK_SIZE = 50;
+// Bounds of the number of entries the deferred task updates at once. The task
+// adapts its chunk size so that a chunk takes about CHUNK_TIME_BUDGET_MS, as
+// the writes of a chunk delay any other query on the Places connection.
+const MIN_CHUNK_SIZE = 10;
+const MAX_CHUNK_SIZE = 500;
+const CHUNK_TIME_BUDGET_MS = 50;
 // Threshold used to evaluate whether the number of Places events from the last
 // recalculation is high enough to deserve a recalculation rate increase.
 const ACCELERATION_EVENTS_THRESHOLD = 250;
@@ -104,6 +110,11 @@ export class PlacesFrecencyRecalculator {
    */
   #alternativeFrecencyHelper = null;
 
+  /**
+   * Number of entries the deferred task updates at once.
+   */
+  #chunkSize = DEFAULT_CHUNK_SIZE;
+
   /**
    * Tracks whether the recalculator was finalized, usually due to shutdown.
    * We use this explicit boolean rather than checking for a null `#task`
@@ -190,8 +201,12 @@ export class PlacesFrecencyRecalculator {
     }
     let timerId = Glean.places.frecencyRecalcChunkTime.start();
     try {
-      if (await this.recalculateSomeFrecencies()) {
+      let startTime = Cu.now();
+      if (
+        await this.recalculateSomeFrecencies({ chunkSize: this.#chunkSize })
+      ) {
         Glean.places.frecencyRecalcChunkTime.stopAndAccumulate(timerId);
+        this.#updateChunkSize(Cu.now() - startTime);
       } else {
         Glean.places.frecencyRecalcChunkTime.cancel(timerId);
       }
@@ -202,6 +217,20 @@ export class PlacesFrecencyRecalculator {
     }
   }
 
+  /**
+   * Grows the chunk size while chunks are well within the time budget, and
+   * shrinks it when they are over it, e.g. on slow disks or large histories.
+   *
+   * @param {number} elapsedMs the time it took to recalculate the last chunk.
+   */
+  #updateChunkSize(elapsedMs) {
+    if (elapsedMs > CHUNK_TIME_BUDGET_MS) {
+      this.#chunkSize = Math.max(MIN_CHUNK_SIZE, this.#chunkSize >> 1);
+    } else if (elapsedMs < CHUNK_TIME_BUDGET_MS / 2) {
+      this.#chunkSize = Math.min(MAX_CHUNK_SIZE, this.#chunkSize * 2);
+    }
+  }
+
   #finalize() {
     lazy.logger.trace("Finalizing frecency recalculator");
     // We don't mind about tasks completiion, since we can execute them in the
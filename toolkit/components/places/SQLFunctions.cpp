@@ -489,13 +489,20 @@ MatchAutoCompleteFunction::OnFunctionCall(mozIStorageValueArray* aArguments,
   // Obtain our search function.
   searchFunctionPtr searchFunction = getSearchFunction(matchBehavior);
 
-  // Clean up our URI spec and prepare it for searching.
+  // Clean up our URI spec and prepare it for searching only once a token has
+  // to be searched in it, most rows are rejected or matched by their titles
+  // and tags first.
   nsCString fixedUrlBuf;
-  nsDependentCSubstring fixedUrl =
-      fixupURISpec(url, matchBehavior, fixedUrlBuf);
-  // Limit the number of chars we search through.
-  const nsDependentCSubstring& trimmedUrl =
-      Substring(fixedUrl, 0, MAX_CHARS_TO_SEARCH_THROUGH);
+  Maybe<nsDependentCSubstring> trimmedUrl;
+  auto urlMatches = [&](const nsDependentCSubstring& aToken) {
+    if (!trimmedUrl) {
+      nsDependentCSubstring fixedUrl =
+          fixupURISpec(url, matchBehavior, fixedUrlBuf);
+      // Limit the number of chars we search through.
+      trimmedUrl.emplace(Substring(fixedUrl, 0, MAX_CHARS_TO_SEARCH_THROUGH));
+    }
+    return searchFunction(aToken, *trimmedUrl);
+  };
 
   nsDependentCString title = getSharedUTF8String(aArguments, kArgIndexTitle);
   // Limit the number of chars we search through.
@@ -521,18 +528,17 @@ MatchAutoCompleteFunction::OnFunctionCall(mozIStorageValueArray* aArguments,
       matches = (searchFunction(token, trimmedTitle) ||
                  searchFunction(token, trimmedFallbackTitle) ||
                  searchFunction(token, tags)) &&
-                searchFunction(token, trimmedUrl);
+                urlMatches(token);
     } else if (HAS_BEHAVIOR(TITLE)) {
       matches = searchFunction(token, trimmedTitle) ||
                 searchFunction(token, trimmedFallbackTitle) ||
                 searchFunction(token, tags);
     } else if (HAS_BEHAVIOR(URL)) {
-      matches = searchFunction(token, trimmedUrl);
+      matches = urlMatches(token);
     } else {
       matches = searchFunction(token, trimmedTitle) ||
                 searchFunction(token, trimmedFallbackTitle) ||
-                searchFunction(token, tags) ||
-                searchFunction(token, trimmedUrl);
+                searchFunction(token, tags) || urlMatches(token);
     }
   }
 
@@ -8,6 +8,7 @@
 #include "mozilla/ProcInfo_linux.h"
 #include "mozilla/Sprintf.h"
 #include "mozilla/Logging.h"
+#include "mozilla/Maybe.h"
 #include "mozilla/ScopeExit.h"
 #include "mozilla/ipc/GeckoChildProcessHost.h"
 #include "nsMemoryReporterManager.h"
@@ -207,6 +208,35 @@ nsresult GetGpuTimeSinceProcessStartInMs(uint64_t* aResult) {
   return NS_ERROR_NOT_IMPLEMENTED;
 }
 
+// Returns the memory only mapped by aPid, from the private pages of
+// /proc/<pid>/smaps_rollup.  Unlike resident - shared in statm, this doesn't
+// count the copy-on-write pages that processes forked by the fork server
+// still share with it, which statm considers anonymous and thus unshared.
+static Maybe<uint64_t> GetPrivateMemory(base::ProcessId aPid) {
+  FILE* f = fopen(nsPrintfCString("/proc/%u/smaps_rollup", aPid).get(), "r");
+  if (!f) {
+    // Linux before 4.14.
+    return Nothing();
+  }
+  auto cleanup = MakeScopeExit([&] { fclose(f); });
+
+  uint64_t privateKb = 0;
+  bool found = false;
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    unsigned long kb;
+    if (sscanf(line, "Private_Clean: %lu kB", &kb) == 1 ||
+        sscanf(line, "Private_Dirty: %lu kB", &kb) == 1) {
+      privateKb += kb;
+      found = true;
+    }
+  }
+  if (!found) {
+    return Nothing();
+  }
+  return Some(privateKb * 1024);
+}
+
 ProcInfoPromise::ResolveOrRejectValue GetProcInfoSync(
     nsTArray<ProcInfoRequest>&& aRequests) {
   ProcInfoPromise::ResolveOrRejectValue result;
@@ -235,18 +265,23 @@ ProcInfoPromise::ResolveOrRejectValue GetProcInfoSync(
       }
     }
 
-    // The 'Memory' value displayed in the system monitor is resident -
-    // shared. statm contains more fields, but we're only interested in
-    // the first three.
-    static const int MAX_FIELD = 3;
-    size_t VmSize, resident, shared;
     info.memory = 0;
-    FILE* f = fopen(nsPrintfCString("/proc/%u/statm", request.pid).get(), "r");
-    if (f) {
-      int nread = fscanf(f, "%zu %zu %zu", &VmSize, &resident, &shared);
-      fclose(f);
-      if (nread == MAX_FIELD) {
-        info.memory = (resident - shared) * getpagesize();
+    if (Maybe<uint64_t> privateMemory = GetPrivateMemory(request.pid)) {
+      info.memory = *privateMemory;
+    } else {
+      // The 'Memory' value displayed in the system monitor is resident -
+      // shared. statm contains more fields, but we're only interested in
+      // the first three.
+      static const int MAX_FIELD = 3;
+      size_t VmSize, resident, shared;
+      FILE* f =
+          fopen(nsPrintfCString("/proc/%u/statm", request.pid).get(), "r");
+      if (f) {
+        int nread = fscanf(f, "%zu %zu %zu", &VmSize, &resident, &shared);
+        fclose(f);
+        if (nread == MAX_FIELD) {
+          info.memory = (resident - shared) * getpagesize();
+        }
       }
     }
 
@@ -17,11 +17,18 @@
 #include "mozilla/Logging.h"
 #include "mozilla/SyncRunnable.h"
 #include "mozilla/Base64.h"
+#include "mozilla/StaticPrefs_urlclassifier.h"
 #include "mozilla/Unused.h"
 #include "mozilla/UniquePtr.h"
 #include "nsUrlClassifierDBService.h"
 #include "nsUrlClassifierUtils.h"
 
+#if defined(XP_WIN)
+#  include <windows.h>
+#elif defined(XP_UNIX)
+#  include <unistd.h>
+#endif
+
 // MOZ_LOG=UrlClassifierDbService:5
 extern mozilla::LazyLogModule gUrlClassifierDbServiceLog;
 #define LOG(args) \
@@ -1068,6 +1075,21 @@ nsresult Classifier::ActiveTables(nsTArray<nsCString>& aTables) const {
   return NS_OK;
 }
 
+void Classifier::GetMappedPrefixSets(MappedPrefixSetMap& aSets) {
+  for (const auto& table : mActiveTablesCache) {
+    RefPtr<LookupCache> cache = GetLookupCache(table);
+    LookupCacheV4* cacheV4 = LookupCache::Cast<LookupCacheV4>(cache);
+    if (!cacheV4) {
+      continue;
+    }
+
+    RefPtr<MappedPrefixSet> set = cacheV4->OpenMappedPrefixSet();
+    if (set) {
+      aSets.InsertOrUpdate(table, std::move(set));
+    }
+  }
+}
+
 nsresult Classifier::CleanToDelete() {
   bool exists;
   nsresult rv = mToDeleteDirectory->Exists(&exists);
@@ -1086,8 +1108,51 @@ nsresult Classifier::CleanToDelete() {
  * Before copying a file, it checks ::ShouldAbort and returns
  * NS_ERROR_ABORT if the flag is set.
  */
+// Files of the store are never modified in place, they are always replaced
+// as a whole through a safe output stream.  So instead of copying them for an
+// update, they can be hard linked, the update then only writes the files of
+// the tables it changes and the in-use files stay untouched.
+static bool LinkFileToDirectory(nsIFile* aSource, nsIFile* aDestDir) {
+  nsCOMPtr<nsIFile> dest;
+  if (NS_FAILED(aDestDir->Clone(getter_AddRefs(dest)))) {
+    return false;
+  }
+
+#if defined(XP_WIN)
+  nsAutoString leaf, sourcePath, destPath;
+  if (NS_FAILED(aSource->GetLeafName(leaf)) || NS_FAILED(dest->Append(leaf)) ||
+      NS_FAILED(aSource->GetPath(sourcePath)) ||
+      NS_FAILED(dest->GetPath(destPath))) {
+    return false;
+  }
+  return CreateHardLinkW(destPath.get(), sourcePath.get(), nullptr);
+#elif defined(XP_UNIX)
+  nsAutoCString leaf, sourcePath, destPath;
+  if (NS_FAILED(aSource->GetNativeLeafName(leaf)) ||
+      NS_FAILED(dest->AppendNative(leaf)) ||
+      NS_FAILED(aSource->GetNativePath(sourcePath)) ||
+      NS_FAILED(dest->GetNativePath(destPath))) {
+    return false;
+  }
+  return link(sourcePath.get(), destPath.get()) == 0;
+#else
+  return false;
+#endif
+}
+
 nsresult Classifier::CopyDirectoryInterruptible(nsCOMPtr<nsIFile>& aDestDir,
                                                 nsCOMPtr<nsIFile>& aSourceDir) {
+  // Links need the destination directory to exist.
+  bool linkFiles = StaticPrefs::urlclassifier_update_link_store_files();
+  if (linkFiles) {
+    bool exist;
+    if (NS_FAILED(aDestDir->Exists(&exist)) ||
+        (!exist &&
+         NS_FAILED(aDestDir->Create(nsIFile::DIRECTORY_TYPE, 0755)))) {
+      linkFiles = false;
+    }
+  }
+
   nsCOMPtr<nsIDirectoryEnumerator> entries;
   nsresult rv = aSourceDir->GetDirectoryEntries(getter_AddRefs(entries));
   NS_ENSURE_SUCCESS(rv, rv);
@@ -1118,7 +1183,8 @@ nsresult Classifier::CopyDirectoryInterruptible(nsCOMPtr<nsIFile>& aDestDir,
 
       rv = CopyDirectoryInterruptible(dest, source);
       NS_ENSURE_SUCCESS(rv, rv);
-    } else {
+    } else if (!linkFiles || !LinkFileToDirectory(source, aDestDir)) {
+      // Not supported by the file system, copy instead.
       rv = source->CopyToNative(aDestDir, ""_ns);
       NS_ENSURE_SUCCESS(rv, rv);
     }
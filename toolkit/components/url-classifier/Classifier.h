@@ -10,6 +10,7 @@
 #include "HashStore.h"
 #include "ProtocolParser.h"
 #include "LookupCache.h"
+#include "MappedPrefixSet.h"
 #include "mozilla/Atomics.h"
 #include "nsCOMPtr.h"
 #include "nsString.h"
@@ -57,6 +58,11 @@ class Classifier {
    */
   nsresult ActiveTables(nsTArray<nsCString>& aTables) const;
 
+  /*
+   * Get the mapped prefix sets of the active V4 tables that have one.
+   */
+  void GetMappedPrefixSets(MappedPrefixSetMap& aSets);
+
   /**
    * Check URL fragments against a specified table.
    * The fragments should be generated by |LookupCache::GetLookupFragments|
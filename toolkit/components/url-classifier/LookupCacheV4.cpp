@@ -6,8 +6,11 @@
 #include "LookupCacheV4.h"
 #include "HashStore.h"
 #include "mozilla/glean/UrlClassifierMetrics.h"
+#include "mozilla/StaticPrefs_urlclassifier.h"
 #include "mozilla/Unused.h"
 #include "nsCheckSummedOutputStream.h"
+#include "nsISafeOutputStream.h"
+#include "nsNetUtil.h"
 #include "nsUrlClassifierDBService.h"
 #include "crc32c.h"
 #include <string>
@@ -20,6 +23,8 @@ extern mozilla::LazyLogModule gUrlClassifierDbServiceLog;
   MOZ_LOG_TEST(gUrlClassifierDbServiceLog, mozilla::LogLevel::Debug)
 
 #define METADATA_SUFFIX ".metadata"_ns
+#define MAPPED_PREFIXSET_SUFFIX ".vlpmap"_ns
+#define DELTA_LOG_SUFFIX ".vlpdelta"_ns
 
 namespace mozilla {
 namespace safebrowsing {
@@ -89,6 +94,86 @@ class VLPrefixSet {
   uint32_t mCount;
 };
 
+static void AppendUint32(nsACString& aOut, uint32_t aValue) {
+  aOut.Append(reinterpret_cast<const char*>(&aValue), sizeof(aValue));
+}
+
+static bool ReadUint32(const char*& aCursor, const char* aEnd,
+                       uint32_t* aValue) {
+  if (static_cast<size_t>(aEnd - aCursor) < sizeof(*aValue)) {
+    return false;
+  }
+  memcpy(aValue, aCursor, sizeof(*aValue));
+  aCursor += sizeof(*aValue);
+  return true;
+}
+
+// A delta log record is, in native byte order:
+//   uint32 removal count, uint32 removal indices[]
+//   uint32 prefix size count, {uint32 prefix size, uint32 length, prefixes}[]
+//   uint32 SHA256 length, the SHA256 of the prefixes after the update
+// The SHA256 is appended once the update was merged.
+static void AppendDeltaRecord(const TableUpdateV4& aTableUpdate,
+                              nsACString& aRecord) {
+  const TableUpdateV4::RemovalIndiceArray& removals =
+      aTableUpdate.RemovalIndices();
+  AppendUint32(aRecord, removals.Length());
+  for (int32_t index : removals) {
+    AppendUint32(aRecord, static_cast<uint32_t>(index));
+  }
+
+  AppendUint32(aRecord, aTableUpdate.Prefixes().Count());
+  for (const auto& entry : aTableUpdate.Prefixes()) {
+    AppendUint32(aRecord, entry.GetKey());
+    AppendUint32(aRecord, entry.GetData()->Length());
+    aRecord.Append(*entry.GetData());
+  }
+}
+
+static nsresult ReadDeltaRecord(const char*& aCursor, const char* aEnd,
+                                TableUpdateV4* aTableUpdate) {
+  uint32_t count;
+  if (!ReadUint32(aCursor, aEnd, &count) ||
+      static_cast<size_t>(aEnd - aCursor) / sizeof(uint32_t) < count) {
+    return NS_ERROR_FILE_CORRUPTED;
+  }
+  // The records aren't aligned.
+  nsTArray<uint32_t> removals;
+  if (!removals.SetLength(count, fallible)) {
+    return NS_ERROR_OUT_OF_MEMORY;
+  }
+  memcpy(removals.Elements(), aCursor, count * sizeof(uint32_t));
+  aCursor += count * sizeof(uint32_t);
+  nsresult rv = aTableUpdate->NewRemovalIndices(removals.Elements(), count);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  if (!ReadUint32(aCursor, aEnd, &count)) {
+    return NS_ERROR_FILE_CORRUPTED;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t size, length;
+    if (!ReadUint32(aCursor, aEnd, &size) ||
+        !ReadUint32(aCursor, aEnd, &length) || size < PREFIX_SIZE ||
+        size > COMPLETE_SIZE || length % size != 0 ||
+        static_cast<size_t>(aEnd - aCursor) < length ||
+        aTableUpdate->Prefixes().Contains(size)) {
+      return NS_ERROR_FILE_CORRUPTED;
+    }
+    aTableUpdate->NewPrefixes(size, Substring(aCursor, length));
+    aCursor += length;
+  }
+
+  uint32_t length;
+  if (!ReadUint32(aCursor, aEnd, &length) || !length ||
+      static_cast<size_t>(aEnd - aCursor) < length) {
+    return NS_ERROR_FILE_CORRUPTED;
+  }
+  aTableUpdate->SetSHA256(std::string(aCursor, length));
+  aCursor += length;
+
+  return NS_OK;
+}
+
 nsresult LookupCacheV4::Has(const Completion& aCompletion, bool* aHas,
                             uint32_t* aMatchLength, bool* aConfirmed) {
   *aHas = *aConfirmed = false;
@@ -270,6 +355,287 @@ nsresult LookupCacheV4::SanityCheck(const Header& aHeader) {
 
 nsCString LookupCacheV4::GetPrefixSetSuffix() const { return ".vlpset"_ns; }
 
+nsresult LookupCacheV4::GetMappedPrefixSetFile(nsIFile** aFile) const {
+  nsCOMPtr<nsIFile> file;
+  nsresult rv = mStoreDirectory->Clone(getter_AddRefs(file));
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  rv = file->AppendNative(mTableName + MAPPED_PREFIXSET_SUFFIX);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  file.forget(aFile);
+  return NS_OK;
+}
+
+nsresult LookupCacheV4::GetDeltaLogFile(nsIFile** aFile) const {
+  nsCOMPtr<nsIFile> file;
+  nsresult rv = mStoreDirectory->Clone(getter_AddRefs(file));
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  rv = file->AppendNative(mTableName + DELTA_LOG_SUFFIX);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  file.forget(aFile);
+  return NS_OK;
+}
+
+void LookupCacheV4::ClearPendingDeltas() {
+  mPendingDeltas.Truncate();
+  mPendingDeltaCount = 0;
+  mNeedsFullStore = false;
+}
+
+nsresult LookupCacheV4::Open() {
+  nsresult rv = LookupCache::Open();
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  return ReplayDeltaLog();
+}
+
+nsresult LookupCacheV4::ReadDeltaLog(nsIFile* aFile, nsACString& aRecords,
+                                     uint32_t* aCount) const {
+  int64_t fileSize;
+  nsresult rv = aFile->GetFileSize(&fileSize);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  const uint32_t headerSize = 3 * sizeof(uint32_t);
+  if (fileSize < headerSize + nsCrc32CheckSumedOutputStream::CHECKSUM_SIZE ||
+      fileSize > UINT32_MAX) {
+    return NS_ERROR_FILE_CORRUPTED;
+  }
+
+  nsCOMPtr<nsIInputStream> in;
+  rv = NS_NewLocalFileInputStream(getter_AddRefs(in), aFile);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  nsAutoCString data;
+  rv = NS_ReadInputStreamToString(in, data, fileSize);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  uint32_t dataLength =
+      data.Length() - nsCrc32CheckSumedOutputStream::CHECKSUM_SIZE;
+  uint32_t crc32;
+  memcpy(&crc32, data.BeginReading() + dataLength, sizeof(crc32));
+  if (crc32 != ComputeCrc32c(~0, reinterpret_cast<const uint8_t*>(
+                                     data.BeginReading()),
+                             dataLength)) {
+    LOG(("[%s] Delta log checksum mismatch", mTableName.get()));
+    return NS_ERROR_FILE_CORRUPTED;
+  }
+
+  const char* cursor = data.BeginReading();
+  const char* end = cursor + dataLength;
+  uint32_t magic, version;
+  ReadUint32(cursor, end, &magic);
+  ReadUint32(cursor, end, &version);
+  ReadUint32(cursor, end, aCount);
+  if (magic != DELTA_MAGIC || version != DELTA_VERSION) {
+    return NS_ERROR_FILE_CORRUPTED;
+  }
+
+  aRecords.Assign(Substring(cursor, end));
+  return NS_OK;
+}
+
+nsresult LookupCacheV4::ReplayDeltaLog() {
+  ClearPendingDeltas();
+
+  nsCOMPtr<nsIFile> file;
+  nsresult rv = GetDeltaLogFile(getter_AddRefs(file));
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  bool exists;
+  rv = file->Exists(&exists);
+  NS_ENSURE_SUCCESS(rv, rv);
+  if (!exists) {
+    return NS_OK;
+  }
+
+  // A log without the prefix file it applies to is as good as corrupted.
+  nsAutoCString records;
+  uint32_t count = 0;
+  rv = mPrimed ? ReadDeltaLog(file, records, &count) : NS_ERROR_FILE_CORRUPTED;
+  if (NS_FAILED(rv)) {
+    LOG(("[%s] Unusable delta log", mTableName.get()));
+    return NS_ERROR_FILE_CORRUPTED;
+  }
+
+  PrefixStringMap prefixes1, prefixes2;
+  PrefixStringMap* input = &prefixes1;
+  PrefixStringMap* output = &prefixes2;
+  rv = GetPrefixes(*input);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  // Every record carries the SHA256 of the prefixes it results in, so a log
+  // that doesn't belong to the prefix file fails here too.
+  const char* cursor = records.BeginReading();
+  const char* end = records.EndReading();
+  for (uint32_t i = 0; i < count; i++) {
+    RefPtr<TableUpdateV4> update = new TableUpdateV4(mTableName);
+    rv = ReadDeltaRecord(cursor, end, update);
+    if (NS_SUCCEEDED(rv)) {
+      output->Clear();
+      rv = MergeUpdate(update, *input, *output);
+    }
+    if (NS_FAILED(rv)) {
+      LOG(("[%s] Failed to replay delta log record %u", mTableName.get(), i));
+      return NS_ERROR_FILE_CORRUPTED;
+    }
+    std::swap(input, output);
+  }
+  if (cursor != end) {
+    return NS_ERROR_FILE_CORRUPTED;
+  }
+
+  rv = Build(*input);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  LOG(("[%s] Replayed %u delta log records", mTableName.get(), count));
+  return NS_OK;
+}
+
+nsresult LookupCacheV4::StoreDeltaLog(nsIFile* aPrefixFile,
+                                      nsIFile* aDeltaFile, bool* aStored) {
+  *aStored = false;
+
+  bool exists;
+  nsresult rv = aPrefixFile->Exists(&exists);
+  NS_ENSURE_SUCCESS(rv, rv);
+  if (!exists) {
+    return NS_OK;
+  }
+
+  int64_t prefixFileSize;
+  rv = aPrefixFile->GetFileSize(&prefixFileSize);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  nsAutoCString records;
+  uint32_t count = 0;
+  rv = aDeltaFile->Exists(&exists);
+  NS_ENSURE_SUCCESS(rv, rv);
+  if (exists) {
+    rv = ReadDeltaLog(aDeltaFile, records, &count);
+    NS_ENSURE_SUCCESS(rv, rv);
+  }
+
+  count += mPendingDeltaCount;
+  if (count > DELTA_MAX_RECORDS ||
+      records.Length() + mPendingDeltas.Length() >
+          prefixFileSize / DELTA_MAX_SIZE_RATIO) {
+    LOG(("[%s] Compacting the delta log", mTableName.get()));
+    return NS_OK;
+  }
+
+  nsCOMPtr<nsIOutputStream> localOutFile;
+  rv = NS_NewSafeLocalFileOutputStream(
+      getter_AddRefs(localOutFile), aDeltaFile,
+      PR_WRONLY | PR_TRUNCATE | PR_CREATE_FILE);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  nsCOMPtr<nsIOutputStream> out;
+  rv = NS_NewCrc32OutputStream(getter_AddRefs(out), localOutFile.forget(),
+                               MAX_BUFFER_SIZE);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  nsAutoCString data;
+  AppendUint32(data, DELTA_MAGIC);
+  AppendUint32(data, DELTA_VERSION);
+  AppendUint32(data, count);
+  data.Append(records);
+  data.Append(mPendingDeltas);
+
+  uint32_t written;
+  rv = out->Write(data.BeginReading(), data.Length(), &written);
+  NS_ENSURE_SUCCESS(rv, rv);
+  NS_ENSURE_TRUE(written == data.Length(), NS_ERROR_FAILURE);
+
+  nsCOMPtr<nsISafeOutputStream> safeOut = do_QueryInterface(out, &rv);
+  NS_ENSURE_SUCCESS(rv, rv);
+  rv = safeOut->Finish();
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  LOG(("[%s] Storing %u delta log records successful", mTableName.get(),
+       count));
+  *aStored = true;
+  return NS_OK;
+}
+
+nsresult LookupCacheV4::StoreToFile(nsCOMPtr<nsIFile>& aFile) {
+  nsCOMPtr<nsIFile> deltaFile;
+  nsresult rv = GetDeltaLogFile(getter_AddRefs(deltaFile));
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  nsCOMPtr<nsIFile> file;
+  rv = GetMappedPrefixSetFile(getter_AddRefs(file));
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  if (!mNeedsFullStore && mPendingDeltaCount &&
+      StaticPrefs::urlclassifier_update_delta_log_enabled()) {
+    bool stored;
+    rv = StoreDeltaLog(aFile, deltaFile, &stored);
+    Unused << NS_WARN_IF(NS_FAILED(rv));
+    if (NS_SUCCEEDED(rv) && stored) {
+      // Out of date now, OpenMappedPrefixSet() uses the prefixes in memory.
+      Unused << file->Remove(false);
+      ClearPendingDeltas();
+      return NS_OK;
+    }
+  }
+
+  // The log must not be replayed over the rewritten prefix file.
+  bool exists;
+  rv = deltaFile->Exists(&exists);
+  NS_ENSURE_SUCCESS(rv, rv);
+  if (exists) {
+    rv = deltaFile->Remove(false);
+    NS_ENSURE_SUCCESS(rv, rv);
+  }
+
+  rv = LookupCache::StoreToFile(aFile);
+  NS_ENSURE_SUCCESS(rv, rv);
+  ClearPendingDeltas();
+
+  // Content processes only use the prefixes of the last update, so a file
+  // left from before the pref was turned off mustn't stay around.
+  if (!StaticPrefs::urlclassifier_shared_prefix_sets_enabled()) {
+    Unused << file->Remove(false);
+    return NS_OK;
+  }
+
+  PrefixStringMap prefixes;
+  rv = mVLPrefixSet->GetPrefixes(prefixes);
+  if (NS_SUCCEEDED(rv)) {
+    rv = MappedPrefixSet::WriteFile(file, prefixes);
+  }
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    // Not fatal, OpenMappedPrefixSet() falls back to the prefixes in memory.
+    LOG(("[%s] Failed to store the mapped prefix set", mTableName.get()));
+    Unused << file->Remove(false);
+  }
+  return NS_OK;
+}
+
+already_AddRefed<MappedPrefixSet> LookupCacheV4::OpenMappedPrefixSet() const {
+  if (!mPrimed) {
+    return nullptr;
+  }
+
+  nsCOMPtr<nsIFile> file;
+  nsresult rv = GetMappedPrefixSetFile(getter_AddRefs(file));
+  NS_ENSURE_SUCCESS(rv, nullptr);
+
+  bool exists;
+  if (NS_SUCCEEDED(file->Exists(&exists)) && exists) {
+    return MappedPrefixSet::CreateFromFile(file);
+  }
+
+  PrefixStringMap prefixes;
+  if (NS_FAILED(mVLPrefixSet->GetPrefixes(prefixes))) {
+    return nullptr;
+  }
+  return MappedPrefixSet::CreateFromPrefixes(prefixes);
+}
+
 static nsresult AppendPrefixToMap(PrefixStringMap& prefixes,
                                   const nsACString& prefix) {
   uint32_t len = prefix.Length();
@@ -308,9 +674,36 @@ static void UpdateSHA256(nsICryptoHash* aCrypto, const nsACString& aPrefix) {
       aPrefix.Length());
 }
 
+nsresult LookupCacheV4::ApplyUpdate(RefPtr<TableUpdateV4> aTableUpdate,
+                                    PrefixStringMap& aInputMap,
+                                    PrefixStringMap& aOutputMap) {
+  // The update is cleared once merged, keep what the log needs first.
+  nsAutoCString record;
+  if (!aTableUpdate->IsFullUpdate()) {
+    AppendDeltaRecord(*aTableUpdate, record);
+  }
+
+  nsresult rv = MergeUpdate(aTableUpdate, aInputMap, aOutputMap);
+  if (NS_FAILED(rv)) {
+    return rv;
+  }
+
+  if (aTableUpdate->IsFullUpdate()) {
+    ClearPendingDeltas();
+    mNeedsFullStore = true;
+  } else {
+    AppendUint32(record, aTableUpdate->SHA256().Length());
+    record.Append(aTableUpdate->SHA256());
+    mPendingDeltas.Append(record);
+    mPendingDeltaCount++;
+  }
+
+  return NS_OK;
+}
+
 // Please see https://bug1287058.bmoattachments.org/attachment.cgi?id=8795366
 // for detail about partial update algorithm.
-nsresult LookupCacheV4::ApplyUpdate(RefPtr<TableUpdateV4> aTableUpdate,
+nsresult LookupCacheV4::MergeUpdate(RefPtr<TableUpdateV4> aTableUpdate,
                                     PrefixStringMap& aInputMap,
                                     PrefixStringMap& aOutputMap) {
   MOZ_ASSERT(aOutputMap.IsEmpty());
@@ -465,9 +858,12 @@ nsresult LookupCacheV4::WriteMetadata(
   rv = metaFile->AppendNative(mTableName + METADATA_SUFFIX);
   NS_ENSURE_SUCCESS(rv, rv);
 
+  // The file may be a hard link to the one in use, see
+  // Classifier::CopyDirectoryInterruptible(), it must not be truncated.
   nsCOMPtr<nsIOutputStream> outputStream;
-  rv = NS_NewLocalFileOutputStream(getter_AddRefs(outputStream), metaFile,
-                                   PR_WRONLY | PR_TRUNCATE | PR_CREATE_FILE);
+  rv = NS_NewSafeLocalFileOutputStream(
+      getter_AddRefs(outputStream), metaFile,
+      PR_WRONLY | PR_TRUNCATE | PR_CREATE_FILE);
   NS_ENSURE_SUCCESS(rv, rv);
 
   // Write the state.
@@ -478,7 +874,9 @@ nsresult LookupCacheV4::WriteMetadata(
   rv = WriteValue(outputStream, aTableUpdate->SHA256());
   NS_ENSURE_SUCCESS(rv, rv);
 
-  return rv;
+  nsCOMPtr<nsISafeOutputStream> safeOut = do_QueryInterface(outputStream, &rv);
+  NS_ENSURE_SUCCESS(rv, rv);
+  return safeOut->Finish();
 }
 
 nsresult LookupCacheV4::LoadMetadata(nsACString& aState, nsACString& aSHA256) {
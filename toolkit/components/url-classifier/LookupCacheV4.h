@@ -7,6 +7,7 @@
 #define LookupCacheV4_h__
 
 #include "LookupCache.h"
+#include "MappedPrefixSet.h"
 
 namespace mozilla {
 namespace safebrowsing {
@@ -21,6 +22,9 @@ class LookupCacheV4 final : public LookupCache {
                          nsCOMPtr<nsIFile>& aStoreFile)
       : LookupCache(aTableName, aProvider, aStoreFile) {}
 
+  // Also replays the delta log of the table, see StoreToFile().
+  virtual nsresult Open() override;
+
   virtual nsresult Has(const Completion& aCompletion, bool* aHas,
                        uint32_t* aMatchLength, bool* aConfirmed) override;
 
@@ -32,7 +36,7 @@ class LookupCacheV4 final : public LookupCache {
                                        uint32_t* aOutPrefix) const;
 
   // ApplyUpdate will merge data stored in aTableUpdate with prefixes in
-  // aInputMap.
+  // aInputMap.  Partial updates are also kept for the delta log.
   nsresult ApplyUpdate(RefPtr<TableUpdateV4> aTableUpdate,
                        PrefixStringMap& aInputMap, PrefixStringMap& aOutputMap);
 
@@ -43,25 +47,62 @@ class LookupCacheV4 final : public LookupCache {
 
   virtual nsresult LoadMozEntries() override;
 
+  // When only partial updates were applied since the table was loaded, they
+  // are appended to the .vlpdelta log of the table and aFile is left alone,
+  // until the log gets too long compared to aFile.  Otherwise aFile is
+  // rewritten, the log removed and the MappedPrefixSet of the table written.
+  virtual nsresult StoreToFile(nsCOMPtr<nsIFile>& aFile) override;
+
+  // The MappedPrefixSet of the prefixes in use, built from the prefixes in
+  // memory when no up to date file was written.  Null if the table isn't
+  // loaded.
+  already_AddRefed<MappedPrefixSet> OpenMappedPrefixSet() const;
+
   static constexpr int VER = 4;
   static constexpr uint32_t MAX_METADATA_VALUE_LENGTH = 256;
   static constexpr uint32_t VLPSET_MAGIC = 1;
   static constexpr uint32_t VLPSET_VERSION = 0x36044a35;
+  static constexpr uint32_t DELTA_MAGIC = 0x44504c56;  // "VLPD"
+  static constexpr uint32_t DELTA_VERSION = 1;
+  // The delta log is folded into the prefix file once it has more records
+  // than this, or is larger than 1 / DELTA_MAX_SIZE_RATIO of the prefix file.
+  static constexpr uint32_t DELTA_MAX_RECORDS = 32;
+  static constexpr uint32_t DELTA_MAX_SIZE_RATIO = 4;
 
  protected:
   virtual nsCString GetPrefixSetSuffix() const override;
   nsCString GetMetadataSuffix() const;
+  nsresult GetMappedPrefixSetFile(nsIFile** aFile) const;
+  nsresult GetDeltaLogFile(nsIFile** aFile) const;
 
  private:
   ~LookupCacheV4() = default;
 
   virtual int Ver() const override { return VER; }
 
+  nsresult MergeUpdate(RefPtr<TableUpdateV4> aTableUpdate,
+                       PrefixStringMap& aInputMap, PrefixStringMap& aOutputMap);
+
+  nsresult ReadDeltaLog(nsIFile* aFile, nsACString& aRecords,
+                        uint32_t* aCount) const;
+  nsresult ReplayDeltaLog();
+  // Sets aStored to false when the log needs to be compacted instead.
+  nsresult StoreDeltaLog(nsIFile* aPrefixFile, nsIFile* aDeltaFile,
+                         bool* aStored);
+  void ClearPendingDeltas();
+
   virtual nsresult LoadLegacyFile() override;
   virtual nsresult ClearLegacyFile() override;
 
   virtual void GetHeader(Header& aHeader) override;
   virtual nsresult SanityCheck(const Header& aHeader) override;
+
+  // The delta log records of the partial updates applied since the table was
+  // loaded or stored.
+  nsCString mPendingDeltas;
+  uint32_t mPendingDeltaCount = 0;
+  // A full update was applied since, the prefix file has to be rewritten.
+  bool mNeedsFullStore = false;
 };
 
 }  // namespace safebrowsing
@@ -0,0 +1,275 @@
+//* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "MappedPrefixSet.h"
+
+#include "mozilla/ClearOnShutdown.h"
+#include "mozilla/dom/ContentParent.h"
+#include "mozilla/Logging.h"
+#include "mozilla/StaticPtr.h"
+#include "nsIFile.h"
+#include "nsIInputStream.h"
+#include "nsIOutputStream.h"
+#include "nsISafeOutputStream.h"
+#include "nsNetUtil.h"
+
+// MOZ_LOG=UrlClassifierDbService:5
+extern mozilla::LazyLogModule gUrlClassifierDbServiceLog;
+#define LOG(args) \
+  MOZ_LOG(gUrlClassifierDbServiceLog, mozilla::LogLevel::Debug, args)
+
+namespace mozilla {
+namespace safebrowsing {
+
+static StaticAutoPtr<MappedPrefixSetMap> sSharedPrefixSets;
+
+static nsresult WriteBytes(nsIOutputStream* aOut, const void* aData,
+                           uint32_t aLength) {
+  uint32_t written;
+  nsresult rv =
+      aOut->Write(reinterpret_cast<const char*>(aData), aLength, &written);
+  NS_ENSURE_SUCCESS(rv, rv);
+  NS_ENSURE_TRUE(written == aLength, NS_ERROR_FAILURE);
+  return NS_OK;
+}
+
+/* static */
+nsresult MappedPrefixSet::GetLayout(const PrefixStringMap& aPrefixes,
+                                    nsTArray<uint32_t>& aSizes, Header& aHeader,
+                                    nsTArray<Section>& aSections,
+                                    uint32_t* aTotalSize) {
+  // Sorted by prefix size so the same prefixes give the same file.
+  for (const auto& entry : aPrefixes) {
+    if (entry.GetKey() < PREFIX_SIZE || entry.GetKey() > COMPLETE_SIZE ||
+        entry.GetData()->Length() % entry.GetKey() != 0) {
+      return NS_ERROR_FAILURE;
+    }
+    if (!entry.GetData()->IsEmpty()) {
+      aSizes.AppendElement(entry.GetKey());
+    }
+  }
+  aSizes.Sort();
+
+  aHeader = Header{MAGIC, VERSION, static_cast<uint32_t>(aSizes.Length())};
+  uint64_t offset = sizeof(Header) + aSizes.Length() * sizeof(Section);
+  for (uint32_t size : aSizes) {
+    uint32_t length = aPrefixes.Get(size)->Length();
+    aSections.AppendElement(
+        Section{size, static_cast<uint32_t>(offset), length});
+    offset += length;
+  }
+  if (offset > UINT32_MAX) {
+    return NS_ERROR_FAILURE;
+  }
+
+  *aTotalSize = static_cast<uint32_t>(offset);
+  return NS_OK;
+}
+
+/* static */
+nsresult MappedPrefixSet::WriteFile(nsIFile* aFile,
+                                    const PrefixStringMap& aPrefixes) {
+  NS_ENSURE_ARG_POINTER(aFile);
+
+  nsTArray<uint32_t> sizes;
+  Header header;
+  nsTArray<Section> sections;
+  uint32_t totalSize;
+  nsresult rv = GetLayout(aPrefixes, sizes, header, sections, &totalSize);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  nsCOMPtr<nsIOutputStream> out;
+  rv = NS_NewSafeLocalFileOutputStream(
+      getter_AddRefs(out), aFile, PR_WRONLY | PR_TRUNCATE | PR_CREATE_FILE);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  rv = WriteBytes(out, &header, sizeof(header));
+  NS_ENSURE_SUCCESS(rv, rv);
+  rv = WriteBytes(out, sections.Elements(),
+                  sections.Length() * sizeof(Section));
+  NS_ENSURE_SUCCESS(rv, rv);
+  for (uint32_t size : sizes) {
+    const nsCString* prefixes = aPrefixes.Get(size);
+    rv = WriteBytes(out, prefixes->BeginReading(), prefixes->Length());
+    NS_ENSURE_SUCCESS(rv, rv);
+  }
+
+  nsCOMPtr<nsISafeOutputStream> safeOut = do_QueryInterface(out, &rv);
+  NS_ENSURE_SUCCESS(rv, rv);
+  return safeOut->Finish();
+}
+
+/* static */
+already_AddRefed<MappedPrefixSet> MappedPrefixSet::CreateFromPrefixes(
+    const PrefixStringMap& aPrefixes) {
+  MOZ_ASSERT(XRE_IsParentProcess());
+
+  nsTArray<uint32_t> sizes;
+  Header header;
+  nsTArray<Section> sections;
+  uint32_t totalSize;
+  if (NS_FAILED(GetLayout(aPrefixes, sizes, header, sections, &totalSize))) {
+    return nullptr;
+  }
+
+  auto handle = ipc::shared_memory::CreateFreezable(totalSize);
+  if (!handle) {
+    return nullptr;
+  }
+  auto map = std::move(handle).Map();
+  if (!map) {
+    return nullptr;
+  }
+
+  char* buffer = map.DataAs<char>();
+  memcpy(buffer, &header, sizeof(header));
+  memcpy(buffer + sizeof(header), sections.Elements(),
+         sections.Length() * sizeof(Section));
+  for (const Section& section : sections) {
+    memcpy(buffer + section.mOffset,
+           aPrefixes.Get(section.mPrefixSize)->BeginReading(),
+           section.mLength);
+  }
+
+  return Create(std::move(map).Freeze());
+}
+
+/* static */
+already_AddRefed<MappedPrefixSet> MappedPrefixSet::CreateFromFile(
+    nsIFile* aFile) {
+  MOZ_ASSERT(XRE_IsParentProcess());
+
+  int64_t fileSize;
+  if (NS_FAILED(aFile->GetFileSize(&fileSize)) ||
+      fileSize < static_cast<int64_t>(sizeof(Header)) ||
+      fileSize > UINT32_MAX) {
+    return nullptr;
+  }
+
+  nsCOMPtr<nsIInputStream> in;
+  if (NS_FAILED(NS_NewLocalFileInputStream(getter_AddRefs(in), aFile))) {
+    return nullptr;
+  }
+
+  auto handle = ipc::shared_memory::CreateFreezable(fileSize);
+  if (!handle) {
+    return nullptr;
+  }
+  auto map = std::move(handle).Map();
+  if (!map) {
+    return nullptr;
+  }
+
+  char* buffer = map.DataAs<char>();
+  uint32_t total = 0;
+  while (total < fileSize) {
+    uint32_t read;
+    if (NS_FAILED(in->Read(buffer + total, fileSize - total, &read)) ||
+        !read) {
+      return nullptr;
+    }
+    total += read;
+  }
+
+  return Create(std::move(map).Freeze());
+}
+
+/* static */
+already_AddRefed<MappedPrefixSet> MappedPrefixSet::Create(
+    const ipc::ReadOnlySharedMemoryHandle& aHandle) {
+  RefPtr<MappedPrefixSet> set = new MappedPrefixSet();
+  set->mHandle = aHandle.Clone();
+  set->mMapping = set->mHandle.Map();
+  if (!set->mMapping || !set->Validate()) {
+    LOG(("MappedPrefixSet: rejecting a malformed prefix set"));
+    return nullptr;
+  }
+  return set.forget();
+}
+
+bool MappedPrefixSet::Validate() const {
+  size_t size = mMapping.Size();
+  if (size < sizeof(Header)) {
+    return false;
+  }
+
+  const Header* header = mMapping.DataAs<Header>();
+  if (header->mMagic != MAGIC || header->mVersion != VERSION ||
+      header->mSectionCount > COMPLETE_SIZE - PREFIX_SIZE + 1 ||
+      sizeof(Header) + header->mSectionCount * sizeof(Section) > size) {
+    return false;
+  }
+
+  for (const Section& section : Sections()) {
+    if (section.mPrefixSize < PREFIX_SIZE ||
+        section.mPrefixSize > COMPLETE_SIZE ||
+        section.mLength % section.mPrefixSize != 0 ||
+        uint64_t(section.mOffset) + section.mLength > size) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Span<const MappedPrefixSet::Section> MappedPrefixSet::Sections() const {
+  const Header* header = mMapping.DataAs<Header>();
+  return Span(reinterpret_cast<const Section*>(header + 1),
+              header->mSectionCount);
+}
+
+bool MappedPrefixSet::Matches(const Completion& aCompletion) const {
+  const uint8_t* data = mMapping.DataAs<uint8_t>();
+
+  for (const Section& section : Sections()) {
+    const uint8_t* prefixes = data + section.mOffset;
+    uint32_t begin = 0;
+    uint32_t end = section.mLength / section.mPrefixSize;
+
+    while (end > begin) {
+      uint32_t mid = begin + (end - begin) / 2;
+      int cmp = memcmp(aCompletion.buf, prefixes + mid * section.mPrefixSize,
+                       section.mPrefixSize);
+      if (cmp < 0) {
+        end = mid;
+      } else if (cmp > 0) {
+        begin = mid + 1;
+      } else {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/* static */
+void MappedPrefixSet::SetShared(MappedPrefixSetMap&& aSets) {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  if (!sSharedPrefixSets) {
+    if (PastShutdownPhase(ShutdownPhase::XPCOMShutdownFinal)) {
+      return;
+    }
+    sSharedPrefixSets = new MappedPrefixSetMap();
+    ClearOnShutdown(&sSharedPrefixSets);
+  }
+  *sSharedPrefixSets = std::move(aSets);
+
+  LOG(("MappedPrefixSet: sharing %u prefix sets", sSharedPrefixSets->Count()));
+
+  if (XRE_IsParentProcess()) {
+    dom::ContentParent::BroadcastURLClassifierPrefixSets();
+  }
+}
+
+/* static */
+const MappedPrefixSetMap& MappedPrefixSet::Shared() {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  static const MappedPrefixSetMap sEmpty;
+  return sSharedPrefixSets ? *sSharedPrefixSets : sEmpty;
+}
+
+}  // namespace safebrowsing
+}  // namespace mozilla
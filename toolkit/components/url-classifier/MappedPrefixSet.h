@@ -0,0 +1,105 @@
+//* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef MappedPrefixSet_h__
+#define MappedPrefixSet_h__
+
+#include "Entries.h"
+#include "mozilla/ipc/SharedMemoryHandle.h"
+#include "mozilla/ipc/SharedMemoryMapping.h"
+#include "mozilla/RefPtr.h"
+#include "mozilla/Span.h"
+#include "nsISupportsImpl.h"
+#include "nsTHashMap.h"
+
+class nsIFile;
+
+namespace mozilla {
+namespace safebrowsing {
+
+class MappedPrefixSet;
+
+using MappedPrefixSetMap =
+    nsTHashMap<nsCStringHashKey, RefPtr<MappedPrefixSet>>;
+
+// The prefixes of a V4 table in a read-only layout that is used in place,
+// without building a VariableLengthPrefixSet.  LookupCacheV4 writes it next
+// to the .vlpset file whenever it rewrites that file.  The parent copies it
+// into a frozen shared memory region and sends that to the content processes,
+// so they can rule out the URLs that match no prefix without a round trip to
+// the parent.
+//
+// File layout, native byte order:
+//   Header
+//   Section[Header::mSectionCount]
+//   the lexicographically sorted prefixes of every section
+class MappedPrefixSet final {
+ public:
+  NS_INLINE_DECL_THREADSAFE_REFCOUNTING(MappedPrefixSet)
+
+  // The prefix strings are in the format VariableLengthPrefixSet::
+  // GetPrefixes() returns them, 4-byte prefixes included.
+  static nsresult WriteFile(nsIFile* aFile, const PrefixStringMap& aPrefixes);
+
+  // Parent process, copies aFile into a shared memory region.  Returns null
+  // if the file is missing or malformed.
+  static already_AddRefed<MappedPrefixSet> CreateFromFile(nsIFile* aFile);
+  // Parent process, for tables whose file isn't up to date.
+  static already_AddRefed<MappedPrefixSet> CreateFromPrefixes(
+      const PrefixStringMap& aPrefixes);
+  // Content processes, maps a region the parent sent.
+  static already_AddRefed<MappedPrefixSet> Create(
+      const ipc::ReadOnlySharedMemoryHandle& aHandle);
+
+  ipc::ReadOnlySharedMemoryHandle CloneHandle() const {
+    return mHandle.Clone();
+  }
+
+  // Whether a prefix of aCompletion is in the table, the same answer
+  // LookupCacheV4::Has() gives before looking at the full hash cache.
+  bool Matches(const Completion& aCompletion) const;
+
+  // The sets of the tables content processes can check locally, by table
+  // name.  Main thread only.  Setting them in the parent process also sends
+  // them to all content processes.
+  static void SetShared(MappedPrefixSetMap&& aSets);
+  static const MappedPrefixSetMap& Shared();
+
+  static constexpr uint32_t MAGIC = 0x534d5053;  // "SPMS"
+  static constexpr uint32_t VERSION = 1;
+
+ private:
+  struct Header {
+    uint32_t mMagic;
+    uint32_t mVersion;
+    uint32_t mSectionCount;
+  };
+
+  struct Section {
+    uint32_t mPrefixSize;
+    // From the start of the file.
+    uint32_t mOffset;
+    uint32_t mLength;
+  };
+
+  MappedPrefixSet() = default;
+  ~MappedPrefixSet() = default;
+
+  static nsresult GetLayout(const PrefixStringMap& aPrefixes,
+                            nsTArray<uint32_t>& aSizes, Header& aHeader,
+                            nsTArray<Section>& aSections,
+                            uint32_t* aTotalSize);
+
+  bool Validate() const;
+  Span<const Section> Sections() const;
+
+  ipc::ReadOnlySharedMemoryHandle mHandle;
+  ipc::ReadOnlySharedMemoryMapping mMapping;
+};
+
+}  // namespace safebrowsing
+}  // namespace mozilla
+
+#endif
@@ -31,6 +31,7 @@
 #include "mozilla/Mutex.h"
 #include "mozilla/Preferences.h"
 #include "mozilla/ScopeExit.h"
+#include "mozilla/StaticPrefs_urlclassifier.h"
 #include "mozilla/TimeStamp.h"
 #include "mozilla/glean/UrlClassifierMetrics.h"
 #include "mozilla/Unused.h"
@@ -38,6 +39,7 @@
 #include "prnetdb.h"
 #include "Entries.h"
 #include "Classifier.h"
+#include "MappedPrefixSet.h"
 #include "ProtocolParser.h"
 #include "mozilla/Attributes.h"
 #include "nsIHttpChannel.h"
@@ -864,6 +866,7 @@ nsresult nsUrlClassifierDBServiceWorker::NotifyUpdateObserver(
   updateObserver.swap(mUpdateObserver);
 
   if (NS_SUCCEEDED(mUpdateStatus)) {
+    PublishMappedPrefixSets();
     LOG(("Notifying success: %d", mUpdateWaitSec));
     updateObserver->UpdateSuccess(mUpdateWaitSec);
   } else {
@@ -1139,10 +1142,28 @@ nsresult nsUrlClassifierDBServiceWorker::OpenDb() {
   NS_ENSURE_SUCCESS(rv, rv);
 
   mClassifier = classifier;
+  PublishMappedPrefixSets();
 
   return NS_OK;
 }
 
+void nsUrlClassifierDBServiceWorker::PublishMappedPrefixSets() {
+  MOZ_ASSERT(!NS_IsMainThread(), "Must be on the background thread");
+  MOZ_ASSERT(mClassifier);
+
+  // With the pref off, an empty map unshares the sets sent before.
+  MappedPrefixSetMap sets;
+  if (StaticPrefs::urlclassifier_shared_prefix_sets_enabled()) {
+    mClassifier->GetMappedPrefixSets(sets);
+  }
+
+  NS_DispatchToMainThread(NS_NewRunnableFunction(
+      "nsUrlClassifierDBServiceWorker::PublishMappedPrefixSets",
+      [sets = std::move(sets)]() mutable {
+        MappedPrefixSet::SetShared(std::move(sets));
+      }));
+}
+
 NS_IMETHODIMP
 nsUrlClassifierDBServiceWorker::ClearLastResults() {
   MOZ_ASSERT(!NS_IsMainThread(), "Must be on the background thread");
@@ -2432,6 +2453,68 @@ nsUrlClassifierDBServiceWorker* nsUrlClassifierDBService::GetWorker() {
   return service->mWorker;
 }
 
+// Content processes only.  Returns true if aKey matches no prefix of the
+// tables of aFeatures, using the prefix sets the parent shared, in which case
+// aCallback is called without results and the parent isn't asked.  Returns
+// false if a prefix matches or a table isn't shared, the parent knows more.
+static bool ClassifyLocalWithMappedPrefixSets(
+    const nsACString& aKey,
+    const nsTArray<RefPtr<nsIUrlClassifierFeature>>& aFeatures,
+    nsIUrlClassifierFeature::listType aListType,
+    nsIUrlClassifierFeatureCallback* aCallback) {
+  MOZ_ASSERT(XRE_IsContentProcess());
+
+  if (!StaticPrefs::urlclassifier_shared_prefix_sets_enabled()) {
+    return false;
+  }
+
+  const MappedPrefixSetMap& shared = MappedPrefixSet::Shared();
+  if (shared.IsEmpty()) {
+    return false;
+  }
+
+  nsTArray<RefPtr<MappedPrefixSet>> sets;
+  for (nsIUrlClassifierFeature* feature : aFeatures) {
+    nsTArray<nsCString> tables;
+    nsresult rv = feature->GetTables(aListType, tables);
+    if (NS_WARN_IF(NS_FAILED(rv))) {
+      return false;
+    }
+
+    for (const nsCString& table : tables) {
+      RefPtr<MappedPrefixSet> set = shared.Get(table);
+      if (!set) {
+        return false;
+      }
+      sets.AppendElement(std::move(set));
+    }
+  }
+
+  // The same fragments FeatureHolder::DoLocalLookup() checks.
+  nsTArray<nsCString> fragments;
+  LookupCache::GetLookupFragments(aKey, &fragments);
+  for (const nsCString& fragment : fragments) {
+    Completion lookupHash;
+    lookupHash.FromPlaintext(fragment);
+    for (MappedPrefixSet* set : sets) {
+      if (set->Matches(lookupHash)) {
+        return false;
+      }
+    }
+  }
+
+  LOG(("No prefix of the shared prefix sets matches, not asking the parent"));
+
+  nsCOMPtr<nsIUrlClassifierFeatureCallback> callback(aCallback);
+  NS_DispatchToMainThread(NS_NewRunnableFunction(
+      "nsUrlClassifierDBService::AsyncClassifyLocalWithFeatures",
+      [callback]() {
+        nsTArray<RefPtr<nsIUrlClassifierFeatureResult>> results;
+        callback->OnClassifyComplete(results);
+      }));
+  return true;
+}
+
 NS_IMETHODIMP
 nsUrlClassifierDBService::AsyncClassifyLocalWithFeatures(
     nsIURI* aURI, const nsTArray<RefPtr<nsIUrlClassifierFeature>>& aFeatures,
@@ -2466,6 +2549,11 @@ nsUrlClassifierDBService::AsyncClassifyLocalWithFeatures(
     using namespace mozilla::dom;
     using namespace mozilla::ipc;
 
+    if (ClassifyLocalWithMappedPrefixSets(key, aFeatures, aListType,
+                                          aCallback)) {
+      return NS_OK;
+    }
+
     ContentChild* content = ContentChild::GetSingleton();
     if (NS_WARN_IF(!content || content->IsShuttingDown())) {
       return NS_ERROR_FAILURE;
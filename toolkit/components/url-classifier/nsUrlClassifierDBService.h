@@ -208,6 +208,10 @@ class nsUrlClassifierDBServiceWorker final : public nsIUrlClassifierDBService {
 
   nsresult NotifyUpdateObserver(nsresult aUpdateStatus);
 
+  // Hands the mapped prefix sets of the tables in use to the main thread,
+  // which shares them with the content processes.
+  void PublishMappedPrefixSets();
+
   // Reset the in-progress update stream
   void ResetStream();
 
@@ -0,0 +1,90 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "LookupCacheV4.h"
+#include "MappedPrefixSet.h"
+#include "nsAppDirectoryServiceDefs.h"
+#include "nsDirectoryServiceUtils.h"
+#include "nsIFile.h"
+
+#include "Common.h"
+
+static already_AddRefed<MappedPrefixSet> WriteAndMap(LookupCacheV4* aCache) {
+  PrefixStringMap prefixes;
+  EXPECT_NS_SUCCEEDED(aCache->GetPrefixes(prefixes));
+
+  nsCOMPtr<nsIFile> file;
+  NS_GetSpecialDirectory(NS_APP_USER_PROFILE_50_DIR, getter_AddRefs(file));
+  file->AppendNative("mapped-prefixset-test.vlpmap"_ns);
+
+  EXPECT_NS_SUCCEEDED(MappedPrefixSet::WriteFile(file, prefixes));
+  RefPtr<MappedPrefixSet> set = MappedPrefixSet::CreateFromFile(file);
+  file->Remove(false);
+  return set.forget();
+}
+
+TEST(UrlClassifierMappedPrefixSet, MatchesLikeLookupCache)
+{
+  _PrefixArray array = {
+      _Prefix("alph"),   _Prefix("brav"),    _Prefix("char"),
+      _Prefix("bravo"),  _Prefix("charlie"), _Prefix("delta!"),
+      _Prefix("echo12"), CreatePrefixFromURL("www.example.com/", 32),
+  };
+  RefPtr<LookupCacheV4> cache = SetupLookupCache<LookupCacheV4>(array);
+
+  RefPtr<MappedPrefixSet> set = WriteAndMap(cache);
+  ASSERT_TRUE(set);
+
+  // Every prefix matches, padded to a full hash.
+  for (const _Prefix& prefix : array) {
+    nsCString fullHash(prefix);
+    fullHash.SetLength(COMPLETE_SIZE);
+    for (uint32_t i = prefix.Length(); i < COMPLETE_SIZE; i++) {
+      fullHash.SetCharAt('z', i);
+    }
+    Completion complete;
+    complete.Assign(fullHash);
+    ASSERT_TRUE(set->Matches(complete));
+  }
+
+  // And random hashes give the same answer as the lookup cache.
+  srand(time(nullptr));
+  for (uint32_t i = 0; i < 1000; i++) {
+    char buf[COMPLETE_SIZE];
+    for (char& c : buf) {
+      c = char(rand() % 256);
+    }
+    Completion complete;
+    complete.Assign(nsDependentCSubstring(buf, COMPLETE_SIZE));
+
+    bool has, confirmed;
+    uint32_t matchLength;
+    ASSERT_NS_SUCCEEDED(cache->Has(complete, &has, &matchLength, &confirmed));
+    ASSERT_EQ(set->Matches(complete), has);
+  }
+}
+
+TEST(UrlClassifierMappedPrefixSet, RejectsMalformed)
+{
+  nsCOMPtr<nsIFile> file;
+  NS_GetSpecialDirectory(NS_APP_USER_PROFILE_50_DIR, getter_AddRefs(file));
+  file->AppendNative("mapped-prefixset-bad.vlpmap"_ns);
+
+  // A prefix string that isn't a multiple of its prefix size.
+  PrefixStringMap prefixes;
+  prefixes.InsertOrUpdate(5, MakeUnique<nsCString>("abcdefg"_ns));
+  ASSERT_NS_FAILED(MappedPrefixSet::WriteFile(file, prefixes));
+
+  // A truncated file.
+  prefixes.Clear();
+  prefixes.InsertOrUpdate(5, MakeUnique<nsCString>("abcdefghij"_ns));
+  ASSERT_NS_SUCCEEDED(MappedPrefixSet::WriteFile(file, prefixes));
+  int64_t size;
+  ASSERT_NS_SUCCEEDED(file->GetFileSize(&size));
+  ASSERT_NS_SUCCEEDED(file->SetFileSize(size - 1));
+  ASSERT_FALSE(RefPtr<MappedPrefixSet>(MappedPrefixSet::CreateFromFile(file)));
+
+  file->Remove(false);
+}
@@ -6,6 +6,7 @@
 #include "Classifier.h"
 #include "HashStore.h"
 #include "mozilla/Components.h"
+#include "mozilla/Preferences.h"
 #include "mozilla/Unused.h"
 #include "nsAppDirectoryServiceDefs.h"
 #include "nsICryptoHash.h"
@@ -20,6 +21,7 @@
 #define GTEST_SAFEBROWSING_DIR "safebrowsing"_ns
 #define GTEST_TABLE "gtest-malware-proto"_ns
 #define GTEST_PREFIXFILE "gtest-malware-proto.vlpset"_ns
+#define GTEST_DELTAFILE "gtest-malware-proto.vlpdelta"_ns
 
 // This function removes common elements of inArray and outArray from
 // outArray. This is used by partial update testcase to ensure partial update
@@ -143,12 +145,10 @@ static void VerifyPrefixSet(PrefixStringMap& expected) {
   NS_GetSpecialDirectory(NS_APP_USER_PROFILE_50_DIR, getter_AddRefs(file));
   file->AppendNative(GTEST_SAFEBROWSING_DIR);
 
-  RefPtr<LookupCacheV4> lookup =
-      new LookupCacheV4(GTEST_TABLE, "test"_ns, file);
+  // Open() also replays the delta log of partial updates.
+  RefPtr<LookupCacheV4> lookup = new LookupCacheV4(GTEST_TABLE, ""_ns, file);
   lookup->Init();
-
-  file->AppendNative(GTEST_PREFIXFILE);
-  lookup->LoadFromFile(file);
+  lookup->Open();
 
   PrefixStringMap prefixesInFile;
   lookup->GetPrefixes(prefixesInFile);
@@ -784,3 +784,74 @@ TEST(UrlClassifierTableUpdateV4, EmptyUpdate2)
 
   Clear();
 }
+
+static bool StoreFileExists(const nsACString& aLeafName) {
+  nsCOMPtr<nsIFile> file;
+  NS_GetSpecialDirectory(NS_APP_USER_PROFILE_50_DIR, getter_AddRefs(file));
+  file->AppendNative(GTEST_SAFEBROWSING_DIR);
+  file->AppendNative(aLeafName);
+
+  bool exists = false;
+  file->Exists(&exists);
+  return exists;
+}
+
+// Small partial updates go to the delta log and are replayed on load, a full
+// update folds the log back into the prefix file.
+TEST(UrlClassifierTableUpdateV4, PartialUpdatesDeltaLog)
+{
+  mozilla::Preferences::SetBool("urlclassifier.update.delta_log.enabled", true);
+
+  _PrefixArray fArray;
+  {
+    PrefixStringMap fMap;
+    nsCString sha256;
+
+    CreateRandomSortedPrefixArray(10000, 4, 4, fArray);
+    CreateRandomSortedPrefixArray(2000, 5, 32, fArray);
+    PrefixArrayToPrefixStringMap(fArray, fMap);
+    CalculateSHA256(fArray, sha256);
+
+    testFullUpdate(fMap, &sha256);
+    ASSERT_FALSE(StoreFileExists(GTEST_DELTAFILE));
+  }
+
+  for (uint32_t i = 0; i < 3; i++) {
+    _PrefixArray pArray, mergedArray;
+    PrefixStringMap pMap, mergedMap;
+    nsCString sha256;
+
+    CreateRandomSortedPrefixArray(20, 4, 4, pArray);
+    CreateRandomSortedPrefixArray(5, 5, 32, pArray);
+    RemoveIntersection(fArray, pArray);
+    PrefixArrayToPrefixStringMap(pArray, pMap);
+
+    nsTArray<uint32_t> removal;
+    CreateRandomRemovalIndices(10, fArray.Length(), removal);
+    RemoveElements(removal, fArray);
+
+    MergeAndSortArray(fArray, pArray, mergedArray);
+    PrefixArrayToPrefixStringMap(mergedArray, mergedMap);
+    CalculateSHA256(mergedArray, sha256);
+
+    testPartialUpdate(pMap, &removal, &sha256, mergedMap);
+    ASSERT_TRUE(StoreFileExists(GTEST_DELTAFILE));
+    fArray = std::move(mergedArray);
+  }
+
+  {
+    _PrefixArray array;
+    PrefixStringMap map;
+    nsCString sha256;
+
+    CreateRandomSortedPrefixArray(1000, 4, 4, array);
+    PrefixArrayToPrefixStringMap(array, map);
+    CalculateSHA256(array, sha256);
+
+    testFullUpdate(map, &sha256);
+    ASSERT_FALSE(StoreFileExists(GTEST_DELTAFILE));
+  }
+
+  mozilla::Preferences::ClearUser("urlclassifier.update.delta_log.enabled");
+  Clear();
+}
@@ -255,6 +255,12 @@ BOOL WINAPI GetThreadInformation(
 #  include <ucontext.h>
 #endif
 
+#if defined(GP_OS_linux)
+#  include <linux/perf_event.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
 using namespace mozilla;
 using namespace mozilla::literals::ProportionValue_literals;
 
@@ -434,6 +440,9 @@ static uint32_t AvailableFeatures() {
 #if !defined(HAVE_CPU_FREQ_SUPPORT)
   ProfilerFeature::ClearCPUFrequency(features);
 #endif
+#if !defined(GP_OS_linux)
+  ProfilerFeature::ClearHardwareCounters(features);
+#endif
 
   return features;
 }
@@ -1050,6 +1059,82 @@ void locked_profiler_remove_sampled_counter(PSLockRef aLock,
   CorePS::RemoveCounter(aLock, aCounter);
 }
 
+#if defined(GP_OS_linux)
+// A hardware performance counter of one thread, read through perf_event.
+// The counts are cumulative, so they can be sampled at any rate.
+class PerfEventCounter final : public BaseProfilerCount {
+ public:
+  PerfEventCounter(const char* aLabel, const char* aDescription,
+                   uint64_t aConfig, ProfilerThreadId aThreadId)
+      : BaseProfilerCount(aLabel, "PMU", aDescription) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = aConfig;
+    // Only counting the thread's user-space code is allowed with the default
+    // kernel.perf_event_paranoid setting.
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    long fd = syscall(__NR_perf_event_open, &attr, aThreadId.ToNumber(), -1,
+                      -1, 0);
+    mFd = fd < 0 ? -1 : static_cast<int>(fd);
+  }
+
+  ~PerfEventCounter() {
+    if (IsValid()) {
+      close(mFd);
+    }
+  }
+
+  PerfEventCounter(const PerfEventCounter&) = delete;
+  PerfEventCounter& operator=(const PerfEventCounter&) = delete;
+
+  // False if the kernel or the sandbox doesn't let us count this event.
+  bool IsValid() const { return mFd >= 0; }
+
+  CountSample Sample() override {
+    CountSample result = {
+        .count = 0,
+        .number = 0,
+        .isSampleNew = false,
+    };
+    uint64_t value;
+    if (read(mFd, &value, sizeof(value)) != sizeof(value)) {
+      return result;
+    }
+    result.count = static_cast<int64_t>(value);
+    result.isSampleNew = value != mLastValue;
+    mLastValue = value;
+    return result;
+  }
+
+ private:
+  int mFd;
+  uint64_t mLastValue = 0;
+};
+
+struct PerfEventCounterInfo {
+  const char* mLabel;
+  const char* mDescription;
+  uint64_t mConfig;
+};
+
+static constexpr PerfEventCounterInfo kMainThreadPerfEventCounters[] = {
+    {"Main thread cycles", "CPU cycles spent running the main thread",
+     PERF_COUNT_HW_CPU_CYCLES},
+    {"Main thread instructions", "Instructions retired by the main thread",
+     PERF_COUNT_HW_INSTRUCTIONS},
+    {"Main thread cache misses",
+     "Last level cache misses caused by the main thread",
+     PERF_COUNT_HW_CACHE_MISSES},
+    {"Main thread branch misses",
+     "Mispredicted branches taken by the main thread",
+     PERF_COUNT_HW_BRANCH_MISSES},
+};
+#endif
+
 class SamplerThread;
 
 static SamplerThread* NewSamplerThread(PSLockRef aLock, uint32_t aGeneration,
@@ -1192,6 +1277,21 @@ class ActivePS {
     if (ProfilerFeature::HasCPUFrequency(aFeatures)) {
       mMaybeCPUFreq = new ProfilerCPUFreq();
     }
+
+#if defined(GP_OS_linux)
+    if (ProfilerFeature::HasHardwareCounters(aFeatures)) {
+      for (const auto& info : kMainThreadPerfEventCounters) {
+        auto counter = MakeUnique<PerfEventCounter>(
+            info.mLabel, info.mDescription, info.mConfig,
+            profiler_main_thread_id());
+        if (!counter->IsValid()) {
+          continue;
+        }
+        locked_profiler_add_sampled_counter(aLock, counter.get());
+        MOZ_RELEASE_ASSERT(mHardwareCounters.append(std::move(counter)));
+      }
+    }
+#endif
   }
 
   ~ActivePS() {
@@ -1296,6 +1396,13 @@ class ActivePS {
       sInstance->mMaybePowerCounters = nullptr;
     }
 
+#if defined(GP_OS_linux)
+    for (const auto& counter : sInstance->mHardwareCounters) {
+      locked_profiler_remove_sampled_counter(aLock, counter.get());
+    }
+    sInstance->mHardwareCounters.clear();
+#endif
+
     if (sInstance->mMaybeCPUFreq) {
       delete sInstance->mMaybeCPUFreq;
       sInstance->mMaybeCPUFreq = nullptr;
@@ -1873,6 +1980,12 @@ class ActivePS {
   // Used to collect cpu frequency, if the CPU frequency feature is on.
   ProfilerCPUFreq* mMaybeCPUFreq;
 
+#if defined(GP_OS_linux)
+  // The counters of the hardware counters feature that the kernel let us
+  // open.
+  Vector<UniquePtr<PerfEventCounter>> mHardwareCounters;
+#endif
+
   // The current sampler thread. This class is not responsible for destroying
   // the SamplerThread object; the Destroy() method returns it so the caller
   // can destroy it.
@@ -42,6 +42,15 @@
 #  define POWER_HELP "Not supported on this platform."
 #endif
 
+#if defined(__linux__) && !defined(__ANDROID__)
+#  define HARDWARE_COUNTERS_HELP                                         \
+    "Record the CPU cycles, instructions, cache misses and branch "      \
+    "misses of the main thread with each sample. Requires the sysctl "   \
+    "kernel.perf_event_paranoid to be 2 or lower."
+#else
+#  define HARDWARE_COUNTERS_HELP "Not supported on this platform."
+#endif
+
 // Higher-order macro containing all the feature info in one place. Define
 // |MACRO| appropriately to extract the relevant parts. Note that the number
 // values are used internally only and so can be changed without consequence.
@@ -135,7 +144,9 @@
                                                                            \
   MACRO(27, "flows", Flows,                                                \
         "Include all flow-related markers. These markers show the program" \
-        "better but can cause more overhead in some places than normal.")
+        "better but can cause more overhead in some places than normal.") \
+                                                                           \
+  MACRO(28, "hwcounters", HardwareCounters, HARDWARE_COUNTERS_HELP)
 
 // *** Synchronize with lists in BaseProfilerState.h and geckoProfiler.json ***
 
@@ -4,9 +4,12 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include "nsPrintfCString.h"
 #include "nsThreadUtils.h"
 #include "mozilla/AppShutdown.h"
 #include "mozilla/DebugOnly.h"
+#include "mozilla/Maybe.h"
+#include "mozilla/ProfilerMarkers.h"
 #include "mozilla/RLBoxSandboxPool.h"
 #ifdef MOZ_USING_WASM_SANDBOXING
 #  include "wasm2c_rt_mem.h"
@@ -64,24 +67,30 @@ void RLBoxSandboxPool::Push(UniquePtr<RLBoxSandboxDataBase> sbxData) {
 
 UniquePtr<RLBoxSandboxPoolData> RLBoxSandboxPool::PopOrCreate(
     uint64_t aMinSize) {
-  MutexAutoLock lock(mMutex);
-
   UniquePtr<RLBoxSandboxDataBase> sbxData;
 
-  if (!mPool.IsEmpty()) {
-    const int64_t lastIndex = ReleaseAssertedCast<int64_t>(mPool.Length()) - 1;
-    for (int64_t i = lastIndex; i >= 0; i--) {
-      if (mPool[i]->mSize >= aMinSize) {
-        sbxData = std::move(mPool[i]);
-        mPool.RemoveElementAt(i);
-
-        // If we reuse a sandbox from the pool, reset the timer to clear the
-        // pool
-        CancelTimer();
-        if (!mPool.IsEmpty()) {
-          StartTimer();
-        }
-        break;
+  {
+    MutexAutoLock lock(mMutex);
+
+    // Reuse the smallest sandbox that is large enough, so that the larger
+    // ones stay available for the requests that need them.
+    Maybe<size_t> bestIndex;
+    for (size_t i = 0; i < mPool.Length(); i++) {
+      if (mPool[i]->mSize >= aMinSize &&
+          (!bestIndex || mPool[i]->mSize < mPool[*bestIndex]->mSize)) {
+        bestIndex = Some(i);
+      }
+    }
+
+    if (bestIndex) {
+      sbxData = std::move(mPool[*bestIndex]);
+      mPool.RemoveElementAt(*bestIndex);
+
+      // If we reuse a sandbox from the pool, reset the timer to clear the
+      // pool
+      CancelTimer();
+      if (!mPool.IsEmpty()) {
+        StartTimer();
       }
     }
   }
@@ -99,6 +108,11 @@ UniquePtr<RLBoxSandboxPoolData> RLBoxSandboxPool::PopOrCreate(
     // sandbox.
     const uint64_t chosenCapacity = static_cast<uint64_t>(1) << 32;
 #endif
+    // Creating a sandbox reserves and initializes its memory, so it's done
+    // without holding the lock, to not block the other threads sharing the
+    // pool.
+    AUTO_PROFILER_MARKER_TEXT("RLBoxSandboxPool::CreateSandboxData", OTHER, {},
+                              nsPrintfCString("%" PRIu64, chosenCapacity));
     sbxData = CreateSandboxData(chosenCapacity);
     NS_ENSURE_TRUE(sbxData, nullptr);
   }
@@ -45,10 +45,11 @@ class RLBoxSandboxPool : public nsITimerCallback, public nsINamed {
         mMutex("RLBoxSandboxPool::mMutex") {};
 
   void Push(UniquePtr<RLBoxSandboxDataBase> sbx);
-  // PopOrCreate returns a sandbox from the pool if the pool is not empty and
-  // tries to mint a new one otherwise. If creating a new sandbox fails, the
-  // function returns a nullptr. The parameter aMinSize is the minimum size of
-  // the sandbox memory.
+  // PopOrCreate returns the smallest sandbox from the pool that is large
+  // enough and tries to mint a new one otherwise. If creating a new sandbox
+  // fails, the function returns a nullptr. The parameter aMinSize is the
+  // minimum size of the sandbox memory. CreateSandboxData may be called on
+  // several threads at once.
   UniquePtr<RLBoxSandboxPoolData> PopOrCreate(uint64_t aMinSize = 0);
 
  protected:
@@ -172,11 +172,13 @@
 #include "mozilla/Likely.h"
 #include "mozilla/LinkedList.h"
 #include "mozilla/MemoryReporting.h"
+#include "mozilla/Monitor.h"
 #include "mozilla/MruCache.h"
 #include "mozilla/PoisonIOInterposer.h"
 #include "mozilla/ProfilerLabels.h"
 #include "mozilla/ProfilerMarkers.h"
 #include "mozilla/SegmentedVector.h"
+#include "mozilla/StaticPrefs_dom.h"
 #include "mozilla/glean/XpcomMetrics.h"
 #include "mozilla/ThreadLocal.h"
 #include "mozilla/UniquePtr.h"
@@ -1130,6 +1132,7 @@ enum ccIsManual { CCIsNotManual = false, CCIsManual = true };
 ////////////////////////////////////////////////////////////////////////
 
 class JSPurpleBuffer;
+class CCBackgroundScan;
 
 class nsCycleCollector : public nsIMemoryReporter {
  public:
@@ -1175,6 +1178,10 @@ class nsCycleCollector : public nsIMemoryReporter {
 
   RefPtr<JSPurpleBuffer> mJSPurpleBuffer;
 
+  // The scan of the graph running in the background, if any.
+  RefPtr<CCBackgroundScan> mBackgroundScan;
+  friend class CCBackgroundScan;
+
  private:
   virtual ~nsCycleCollector();
 
@@ -1248,8 +1255,12 @@ class nsCycleCollector : public nsIMemoryReporter {
   void BeginCollection(CCReason aReason, ccIsManual aIsManual,
                        nsICycleCollectorListener* aManualListener);
   void MarkRoots(SliceBudget& aBudget);
+  bool ShouldScanInBackground(bool aFullySynchGraphBuild,
+                              const SliceBudget& aBudget);
+  void StartBackgroundScan();
   void ScanRoots(bool aFullySynchGraphBuild);
   void ScanIncrementalRoots();
+  void ScanGraph(bool aFullySynchGraphBuild);
   void ScanWhiteNodes(bool aFullySynchGraphBuild);
   void ScanBlackNodes();
   void ScanWeakMaps();
@@ -1260,6 +1271,67 @@ class nsCycleCollector : public nsIMemoryReporter {
   void CleanupAfterCollection();
 };
 
+// The passes of ScanRoots that only read and color the graph, which take
+// time proportional to the size of the graph, run on a background thread
+// while the main thread keeps running between two slices of an incremental
+// CC. They don't look at the objects themselves, whose refcounts were
+// recorded while building the graph. Objects that are AddRef'd or released
+// in the meantime end up in the purple buffer, like during graph building,
+// and are treated as incremental roots once more after the scan.
+class CCBackgroundScan final {
+ public:
+  NS_INLINE_DECL_THREADSAFE_REFCOUNTING(CCBackgroundScan)
+
+  explicit CCBackgroundScan(nsCycleCollector* aCollector)
+      : mCollector(aCollector), mMonitor("CCBackgroundScan::mMonitor") {}
+
+  // Scans the graph unless another thread already started to.
+  void Run() {
+    {
+      MonitorAutoLock lock(mMonitor);
+      if (mState != State::Pending) {
+        return;
+      }
+      mState = State::Running;
+    }
+
+    mCollector->ScanGraph(/* aFullySynchGraphBuild = */ false);
+
+    MonitorAutoLock lock(mMonitor);
+    mState = State::Done;
+    lock.NotifyAll();
+  }
+
+  bool IsRunning() {
+    MonitorAutoLock lock(mMonitor);
+    return mState == State::Running;
+  }
+
+  // Called by the collector. Scans the graph itself if the background
+  // thread didn't get to it yet.
+  void Finish() {
+    Run();
+    MonitorAutoLock lock(mMonitor);
+    while (mState != State::Done) {
+      lock.Wait();
+    }
+  }
+
+ private:
+  ~CCBackgroundScan() = default;
+
+  enum class State { Pending, Running, Done };
+
+  // Only used by the thread running the scan, the collector doesn't go away
+  // before the scan is done.
+  nsCycleCollector* const mCollector;
+  Monitor mMonitor MOZ_UNANNOTATED;
+  State mState = State::Pending;
+};
+
+// Smaller graphs are scanned quickly enough on the main thread.
+static const uint32_t kMinBackgroundScanNodeCount = 10000;
+
 NS_IMPL_ISUPPORTS(nsCycleCollector, nsIMemoryReporter)
 
 /**
@@ -3148,30 +3220,89 @@ void nsCycleCollector::ScanBlackNodes() {
   NS_ASSERTION(!failed, "Ran out of memory in ScanBlackNodes");
 }
 
-void nsCycleCollector::ScanRoots(bool aFullySynchGraphBuild) {
+// This only looks at the graph, so it may run on a background thread, see
+// CCBackgroundScan.
+void nsCycleCollector::ScanGraph(bool aFullySynchGraphBuild) {
+  TimeLog timeLog;
+  ScanWhiteNodes(aFullySynchGraphBuild);
+  timeLog.Checkpoint("ScanRoots::ScanWhiteNodes");
+
+  ScanBlackNodes();
+  timeLog.Checkpoint("ScanRoots::ScanBlackNodes");
+
+  // Scanning weak maps must be done last.
+  ScanWeakMaps();
+  timeLog.Checkpoint("ScanRoots::ScanWeakMaps");
+}
+
+bool nsCycleCollector::ShouldScanInBackground(bool aFullySynchGraphBuild,
+                                              const SliceBudget& aBudget) {
+  // The logger wants to know about all the incremental roots, and their
+  // state when the scan starts.
+  return !aFullySynchGraphBuild && !aBudget.isUnlimited() && !mLogger &&
+         NS_IsMainThread() &&
+         mGraph.MapCount() >= kMinBackgroundScanNodeCount &&
+         StaticPrefs::dom_cycle_collector_background_scan();
+}
+
+void nsCycleCollector::StartBackgroundScan() {
   JS::AutoAssertNoGC nogc;
   AutoRestore<bool> ar(mScanInProgress);
   MOZ_RELEASE_ASSERT(!mScanInProgress);
   mScanInProgress = true;
   mWhiteNodeCount = 0;
   MOZ_ASSERT(mIncrementalPhase == ScanAndCollectWhitePhase);
+  MOZ_ASSERT(!mBackgroundScan);
 
   JS::AutoEnterCycleCollection autocc(Runtime()->Runtime());
 
-  if (!aFullySynchGraphBuild) {
-    ScanIncrementalRoots();
+  // The refcounts of the objects that changed since their traversal don't
+  // match the graph, ScanWhiteNodes must not look at them.
+  ScanIncrementalRoots();
+
+  mBackgroundScan = new CCBackgroundScan(this);
+  nsresult rv = NS_DispatchBackgroundTask(
+      NS_NewRunnableFunction("CCBackgroundScan",
+                             [scan = mBackgroundScan] { scan->Run(); }));
+  if (NS_FAILED(rv)) {
+    // ScanRoots will scan the graph on the main thread.
+    NS_WARNING("Failed to dispatch the CC background scan");
   }
+}
+
+void nsCycleCollector::ScanRoots(bool aFullySynchGraphBuild) {
+  JS::AutoAssertNoGC nogc;
+  AutoRestore<bool> ar(mScanInProgress);
+  MOZ_RELEASE_ASSERT(!mScanInProgress);
+  mScanInProgress = true;
+  MOZ_ASSERT(mIncrementalPhase == ScanAndCollectWhitePhase);
+
+  JS::AutoEnterCycleCollection autocc(Runtime()->Runtime());
 
   TimeLog timeLog;
-  ScanWhiteNodes(aFullySynchGraphBuild);
-  timeLog.Checkpoint("ScanRoots::ScanWhiteNodes");
+  if (mBackgroundScan) {
+    MOZ_ASSERT(!aFullySynchGraphBuild);
+    mBackgroundScan->Finish();
+    mBackgroundScan = nullptr;
+    timeLog.Checkpoint("ScanRoots::FinishBackgroundScan");
+
+    // Objects may have been stored somewhere while the graph was scanned.
+    // This is done in the same slice as CollectWhite so that nothing can
+    // change again before we unlink.
+    ScanIncrementalRoots();
 
-  ScanBlackNodes();
-  timeLog.Checkpoint("ScanRoots::ScanBlackNodes");
+    // Flooding black may have changed what the weak maps keep alive.
+    ScanWeakMaps();
+    timeLog.Checkpoint("ScanRoots::ScanWeakMaps");
+  } else {
+    mWhiteNodeCount = 0;
 
-  // Scanning weak maps must be done last.
-  ScanWeakMaps();
-  timeLog.Checkpoint("ScanRoots::ScanWeakMaps");
+    if (!aFullySynchGraphBuild) {
+      ScanIncrementalRoots();
+    }
+
+    ScanGraph(aFullySynchGraphBuild);
+  }
 
   if (mLogger) {
     mLogger->BeginResults();
@@ -3373,6 +3504,11 @@ nsCycleCollector::nsCycleCollector()
 nsCycleCollector::~nsCycleCollector() {
   MOZ_ASSERT(!mJSPurpleBuffer, "Didn't call JSPurpleBuffer::Destroy?");
 
+  if (mBackgroundScan) {
+    // The scan uses the graph.
+    mBackgroundScan->Finish();
+  }
+
   UnregisterWeakMemoryReporter(this);
 }
 
@@ -3685,6 +3821,20 @@ bool nsCycleCollector::Collect(CCReason aReason, ccIsManual aIsManual,
                         (mResults.mNumSlices < 3 && !aPreferShorterSlices);
         break;
       case ScanAndCollectWhitePhase:
+        if (!mBackgroundScan &&
+            ShouldScanInBackground(startedIdle, aBudget)) {
+          AUTO_PROFILER_LABEL_CATEGORY_PAIR(GCCC_ScanRoots);
+          PrintPhase("StartBackgroundScan");
+          StartBackgroundScan();
+          // Let the main thread run while the graph is scanned.
+          continueSlice = false;
+          break;
+        }
+        if (mBackgroundScan && !aBudget.isUnlimited() &&
+            mBackgroundScan->IsRunning()) {
+          continueSlice = false;
+          break;
+        }
         // We do ScanRoots and CollectWhite in a single slice to ensure
         // that we won't unlink a live object if a weak reference is
         // promoted to a strong reference after ScanRoots has finished.
@@ -410,6 +410,20 @@ class ThreadSafeAutoRefCnt {
     return result;
   }
 
+  // Increments the count unless it is zero, for objects that stay reachable
+  // after their last release until something else destroys them.  Returns
+  // whether it did.  Relaxed for the same reasons as operator++().
+  MOZ_ALWAYS_INLINE bool IncrementIfNonZero() {
+    nsrefcnt count = mValue.load(std::memory_order_relaxed);
+    do {
+      if (count == 0) {
+        return false;
+      }
+    } while (!mValue.compare_exchange_weak(count, count + 1,
+                                           std::memory_order_relaxed));
+    return true;
+  }
+
   MOZ_ALWAYS_INLINE nsrefcnt operator=(nsrefcnt aValue) {
     // Use release semantics since we're not sure what the caller is
     // doing.
@@ -1367,6 +1367,39 @@ class JemallocHeapReporter final : public nsIMemoryReporter {
       "heap-chunksize", KIND_OTHER, UNITS_BYTES, stats.chunksize,
       "Size of chunks.");
 
+    if (stats.thread_caches > 0) {
+      MOZ_COLLECT_REPORT(
+        "heap-thread-cache/threads", KIND_OTHER, UNITS_COUNT,
+        stats.thread_caches,
+"The number of threads with a cache of small heap allocations.");
+
+      MOZ_COLLECT_REPORT(
+        "heap-thread-cache/bytes", KIND_OTHER, UNITS_BYTES,
+        stats.thread_cache_bytes,
+"Memory freed by the application that threads keep in their caches of small "
+"allocations.  This is part of 'heap/committed/allocated'.");
+
+      MOZ_COLLECT_REPORT(
+        "heap-thread-cache/hits", KIND_OTHER, UNITS_COUNT_CUMULATIVE,
+        stats.thread_cache_hits,
+"The number of small allocations served by a thread cache without taking the "
+"arena lock.");
+
+      MOZ_COLLECT_REPORT(
+        "heap-thread-cache/misses", KIND_OTHER, UNITS_COUNT_CUMULATIVE,
+        stats.thread_cache_misses,
+"The number of small allocations that had to refill a thread cache from the "
+"arena.");
+    }
+
+    if (stats.chunks_dirty > 0) {
+      MOZ_COLLECT_REPORT(
+        "heap-chunks-dirty", KIND_OTHER, UNITS_BYTES, stats.chunks_dirty,
+"Memory of free heap chunks kept resident because releasing it would split "
+"the huge page it shares with a chunk in use.  This is not part of the 'heap' "
+"tree.");
+    }
+
 #ifdef MOZ_PHC
     mozilla::phc::MemoryUsage usage;
     mozilla::phc::PHCMemoryUsage(usage);
@@ -2014,29 +2047,44 @@ nsresult nsMemoryReporterManager::StartGettingReports() {
   return NS_OK;
 }
 
-void nsMemoryReporterManager::DispatchReporter(
-    nsIMemoryReporter* aReporter, bool aIsAsync,
-    nsIHandleReportCallback* aHandleReport, nsISupports* aHandleReportData,
-    bool aAnonymize) {
+void nsMemoryReporterManager::DispatchReporter(nsIMemoryReporter* aReporter,
+                                               bool aIsAsync) {
   MOZ_ASSERT(mPendingReportersState);
 
+  mPendingReportersState->mReporters.AppendElement(
+      PendingReportersState::QueuedReporter{aReporter, aIsAsync});
+  mPendingReportersState->mReportsPending++;
+}
+
+// MainThread only
+void nsMemoryReporterManager::DispatchNextReporter() {
+  PendingReportersState* s = mPendingReportersState;
+  // An async reporter may have ended the report already.
+  if (!s || s->mNextReporter == s->mReporters.Length()) {
+    return;
+  }
+
   // Grab refs to everything used in the lambda function.
   RefPtr<nsMemoryReporterManager> self = this;
-  nsCOMPtr<nsIMemoryReporter> reporter = aReporter;
-  nsCOMPtr<nsIHandleReportCallback> handleReport = aHandleReport;
-  nsCOMPtr<nsISupports> handleReportData = aHandleReportData;
+  nsCOMPtr<nsIMemoryReporter> reporter =
+      s->mReporters[s->mNextReporter].mReporter.forget();
+  bool isAsync = s->mReporters[s->mNextReporter].mIsAsync;
+  s->mNextReporter++;
+  nsCOMPtr<nsIHandleReportCallback> handleReport = s->mHandleReport;
+  nsCOMPtr<nsISupports> handleReportData = s->mHandleReportData;
+  bool anonymize = s->mAnonymize;
 
   nsCOMPtr<nsIRunnable> event = NS_NewRunnableFunction(
       "nsMemoryReporterManager::DispatchReporter",
-      [self, reporter, aIsAsync, handleReport, handleReportData, aAnonymize]() {
-        reporter->CollectReports(handleReport, handleReportData, aAnonymize);
-        if (!aIsAsync) {
+      [self, reporter, isAsync, handleReport, handleReportData, anonymize]() {
+        reporter->CollectReports(handleReport, handleReportData, anonymize);
+        self->DispatchNextReporter();
+        if (!isAsync) {
           self->EndReport();
         }
       });
 
   NS_DispatchToMainThread(event);
-  mPendingReportersState->mReportsPending++;
 }
 
 NS_IMETHODIMP
@@ -2067,7 +2115,8 @@ nsMemoryReporterManager::GetReportsForThisProcessExtended(
 #endif
 
   mPendingReportersState = new PendingReportersState(
-      aFinishReporting, aFinishReportingData, aDMDFile);
+      aHandleReport, aHandleReportData, aAnonymize, aFinishReporting,
+      aFinishReportingData, aDMDFile);
 
   {
     mozilla::MutexAutoLock autoLock(mMutex);
@@ -2076,29 +2125,27 @@ nsMemoryReporterManager::GetReportsForThisProcessExtended(
     // them measuring changes caused by other reporters' dynamic structures.
     // Note that all eternal reporters need to be sync, too.
     for (const auto& entry : *mStrongEternalReporters) {
-      DispatchReporter(entry, false, aHandleReport, aHandleReportData,
-                       aAnonymize);
+      DispatchReporter(entry, false);
     }
     // Process our self-reporting (not in any array/table). Note that when
     // we test, we expect to execute only reporters in the swapped-in tables.
     if (!mIsRegistrationBlocked) {
-      DispatchReporter(this, false, aHandleReport, aHandleReportData,
-                       aAnonymize);
+      DispatchReporter(this, false);
     }
 
     // Now process additional reporters. Note that these are executed in an
     // unforeseeable order (due to the hashtables being keyed on pointers).
     for (const auto& entry : *mStrongReporters) {
-      DispatchReporter(entry.GetKey(), entry.GetData(), aHandleReport,
-                       aHandleReportData, aAnonymize);
+      DispatchReporter(entry.GetKey(), entry.GetData());
     }
     for (const auto& entry : *mWeakReporters) {
       nsCOMPtr<nsIMemoryReporter> reporter = entry.GetKey();
-      DispatchReporter(reporter, entry.GetData(), aHandleReport,
-                       aHandleReportData, aAnonymize);
+      DispatchReporter(reporter, entry.GetData());
     }
   }
 
+  DispatchNextReporter();
+
   return NS_OK;
 }
 
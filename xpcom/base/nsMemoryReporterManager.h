@@ -226,9 +226,9 @@ class nsMemoryReporterManager final : public nsIMemoryReporterManager,
   // No [[nodiscard]] here because ignoring the result is common and reasonable.
   nsresult FinishReporting();
 
-  void DispatchReporter(nsIMemoryReporter* aReporter, bool aIsAsync,
-                        nsIHandleReportCallback* aHandleReport,
-                        nsISupports* aHandleReportData, bool aAnonymize);
+  // Queues aReporter to run once the reporters queued before it have run.
+  void DispatchReporter(nsIMemoryReporter* aReporter, bool aIsAsync);
+  void DispatchNextReporter();
 
   static void TimeoutCallback(nsITimer* aTimer, void* aData);
   // Note: this timeout needs to be long enough to allow for the
@@ -291,9 +291,24 @@ class nsMemoryReporterManager final : public nsIMemoryReporterManager,
   // reporters. The callback and file handle used when all memory reporters
   // have finished are also stored here.
   struct PendingReportersState {
-    // Number of memory reporters currently running.
+    struct QueuedReporter {
+      nsCOMPtr<nsIMemoryReporter> mReporter;
+      bool mIsAsync;
+    };
+
+    // Number of memory reporters currently queued or running.
     uint32_t mReportsPending;
 
+    // The reporters, which are dispatched one at a time so that the events
+    // dispatched while they run don't wait for all of them, and the index of
+    // the next one to dispatch.
+    nsTArray<QueuedReporter> mReporters;
+    size_t mNextReporter;
+
+    nsCOMPtr<nsIHandleReportCallback> mHandleReport;
+    nsCOMPtr<nsISupports> mHandleReportData;
+    bool mAnonymize;
+
     // Callback for when all memory reporters have completed.
     nsCOMPtr<nsIFinishReportingCallback> mFinishReporting;
     nsCOMPtr<nsISupports> mFinishReportingData;
@@ -301,9 +316,15 @@ class nsMemoryReporterManager final : public nsIMemoryReporterManager,
     // File handle to write a DMD report to if requested.
     FILE* mDMDFile;
 
-    PendingReportersState(nsIFinishReportingCallback* aFinishReporting,
+    PendingReportersState(nsIHandleReportCallback* aHandleReport,
+                          nsISupports* aHandleReportData, bool aAnonymize,
+                          nsIFinishReportingCallback* aFinishReporting,
                           nsISupports* aFinishReportingData, FILE* aDMDFile)
         : mReportsPending(0),
+          mNextReporter(0),
+          mHandleReport(aHandleReport),
+          mHandleReportData(aHandleReportData),
+          mAnonymize(aAnonymize),
           mFinishReporting(aFinishReporting),
           mFinishReportingData(aFinishReportingData),
           mDMDFile(aDMDFile) {}
@@ -185,8 +185,8 @@ struct ContractEntry final {
  *
  * The entire set of static category entries is read at startup and loaded into
  * the category manager's dynamic hash tables, so there is memory and
- * initialization overhead for each entry in these tables. This may be further
- * optimized in the future to reduce some of that overhead.
+ * initialization overhead for each entry in these tables. The tables are sized
+ * for the static entries up front, and point directly to the static strings.
  */
 struct StaticCategoryEntry final {
   StringOffset mEntry;
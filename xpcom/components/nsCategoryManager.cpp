@@ -32,6 +32,7 @@
 #include "mozilla/SimpleEnumerator.h"
 
 #include "ManifestParser.h"
+#include "StaticComponents.h"
 #include "nsSimpleEnumerator.h"
 
 using namespace mozilla;
@@ -221,8 +222,9 @@ static nsresult CreateEntryEnumerator(nsTHashtable<CategoryLeaf>& aTable,
 // CategoryNode implementations
 //
 
-CategoryNode* CategoryNode::Create(CategoryAllocator* aArena) {
-  return new (aArena) CategoryNode();
+CategoryNode* CategoryNode::Create(CategoryAllocator* aArena,
+                                   uint32_t aInitialLength) {
+  return new (aArena) CategoryNode(aInitialLength);
 }
 
 CategoryNode::~CategoryNode() = default;
@@ -283,6 +285,26 @@ nsresult CategoryNode::AddLeaf(const nsACString& aEntryName,
   return NS_OK;
 }
 
+void CategoryNode::AddStaticLeaves(
+    const mozilla::xpcom::StaticCategory& aCategory) {
+  MutexAutoLock lock(mLock);
+  for (const auto& entry : aCategory) {
+    if (!entry.Active()) {
+      continue;
+    }
+    // These point directly to static storage.
+    nsCString name = entry.Entry();
+    nsCString value = entry.Value();
+    MOZ_ASSERT(name.IsLiteral() && value.IsLiteral());
+
+    CategoryLeaf* leaf = mTable.PutEntry(name.get(), fallible);
+    if (!leaf) {
+      return;
+    }
+    leaf->value = value.get();
+  }
+}
+
 void CategoryNode::DeleteLeaf(const nsACString& aEntryName) {
   // we don't throw any errors, because it normally doesn't matter
   // and it makes JS a lot cleaner
@@ -344,7 +366,9 @@ nsresult nsCategoryManager::Create(REFNSIID aIID, void** aResult) {
 }
 
 nsCategoryManager::nsCategoryManager()
-    : mLock("nsCategoryManager"), mSuppressNotifications(false) {}
+    : mTable(mozilla::xpcom::kStaticCategoryCount),
+      mLock("nsCategoryManager"),
+      mSuppressNotifications(false) {}
 
 void nsCategoryManager::InitMemoryReporter() {
   RegisterWeakMemoryReporter(this);
@@ -530,6 +554,32 @@ void nsCategoryManager::AddCategoryEntry(const nsACString& aCategoryName,
   }
 }
 
+void nsCategoryManager::AddStaticCategory(
+    const mozilla::xpcom::StaticCategory& aCategory) {
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(mSuppressNotifications);
+
+  nsCString name = aCategory.Name();
+  MOZ_ASSERT(name.IsLiteral());
+
+  CategoryNode* category;
+  {
+    MutexAutoLock lock(mLock);
+    category = mTable
+                   .GetOrInsertWith(name.get(),
+                                    [&] {
+                                      return UniquePtr<CategoryNode>{
+                                          CategoryNode::Create(
+                                              &mArena, aCategory.mCount)};
+                                    })
+                   .get();
+  }
+
+  if (category) {
+    category->AddStaticLeaves(aCategory);
+  }
+}
+
 NS_IMETHODIMP
 nsCategoryManager::DeleteCategoryEntry(const nsACString& aCategoryName,
                                        const nsACString& aEntryName,
@@ -18,6 +18,10 @@
 
 class nsIMemoryReporter;
 
+namespace mozilla::xpcom {
+struct StaticCategory;
+}  // namespace mozilla::xpcom
+
 typedef mozilla::ArenaAllocator<1024 * 8, 8> CategoryAllocator;
 
 /* 16d222a6-1dd2-11b2-b693-f38b02c021b2 */
@@ -54,6 +58,10 @@ class CategoryNode {
 
   void DeleteLeaf(const nsACString& aEntryName);
 
+  // Adds the active entries of aCategory, replacing existing values. The
+  // static strings are used as they are, without being copied.
+  void AddStaticLeaves(const mozilla::xpcom::StaticCategory& aCategory);
+
   void Clear() {
     mozilla::MutexAutoLock lock(mLock);
     mTable.Clear();
@@ -68,14 +76,17 @@ class CategoryNode {
   nsresult Enumerate(nsISimpleEnumerator** aResult);
 
   // CategoryNode is arena-allocated, with the strings
-  static CategoryNode* Create(CategoryAllocator* aArena);
+  static CategoryNode* Create(
+      CategoryAllocator* aArena,
+      uint32_t aInitialLength = PLDHashTable::kDefaultInitialLength);
   ~CategoryNode();
   void operator delete(void*) {}
 
   size_t SizeOfExcludingThis(mozilla::MallocSizeOf aMallocSizeOf);
 
  private:
-  CategoryNode() : mLock("CategoryLeaf") {}
+  explicit CategoryNode(uint32_t aInitialLength)
+      : mTable(aInitialLength), mLock("CategoryLeaf") {}
 
   void* operator new(size_t aSize, CategoryAllocator* aArena);
 
@@ -112,6 +123,14 @@ class nsCategoryManager final : public nsICategoryManager,
     return AddCategoryEntry(aCategory, aKey, aValue, aReplace, oldValue);
   }
 
+  /**
+   * Adds the active entries of a category declared in a static component
+   * manifest. This is to be used by nsComponentManagerImpl on startup, while
+   * notifications are suppressed: the category and its entries are looked up
+   * once, and their tables are sized for the static entries up front.
+   */
+  void AddStaticCategory(const mozilla::xpcom::StaticCategory& aCategory);
+
   static nsresult Create(REFNSIID aIID, void** aResult);
   void InitMemoryReporter();
 
@@ -351,11 +351,7 @@ nsresult nsComponentManagerImpl::Init() {
 
   auto* catMan = nsCategoryManager::GetSingleton();
   for (const auto& cat : gStaticCategories) {
-    for (const auto& entry : cat) {
-      if (entry.Active()) {
-        catMan->AddCategoryEntry(cat.Name(), entry.Entry(), entry.Value());
-      }
-    }
+    catMan->AddStaticCategory(cat);
   }
 
   // This needs to be initialized late enough, so that preferences service can
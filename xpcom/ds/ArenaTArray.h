@@ -0,0 +1,216 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_ArenaTArray_h
+#define mozilla_ArenaTArray_h
+
+#include <cstddef>
+#include <cstring>
+
+#include "mozilla/ArenaAllocator.h"
+#include "mozilla/Assertions.h"
+#include "mozilla/MemoryReporting.h"
+#include "mozilla/mozalloc.h"
+#include "nsTArray.h"
+
+namespace mozilla {
+
+/**
+ * An arena for the buffers of ArenaTArrays, for code that creates lots of
+ * short-lived arrays, like reflow.  Growing an ArenaTArray bump-allocates a
+ * new buffer from the arena, freeing one does nothing, and all of them are
+ * released at once when the outermost AutoTArrayArena of the thread ends.
+ *
+ * Example usage:
+ *
+ *   TArrayArena mArena;
+ *   ...
+ *   {
+ *     AutoTArrayArena scope(mArena);
+ *     ArenaTArray<nsIFrame*> frames;
+ *     ...
+ *   }
+ *
+ * ArenaTArrays that allocate inside an AutoTArrayArena must not outlive it:
+ * they can't be stored in frame properties, or moved into an nsTArray.
+ * Outside of any AutoTArrayArena they allocate from the heap.
+ */
+class TArrayArena final {
+ public:
+  TArrayArena() = default;
+  TArrayArena(const TArrayArena&) = delete;
+  TArrayArena& operator=(const TArrayArena&) = delete;
+
+  ~TArrayArena() {
+    MOZ_ASSERT(sCurrent != this, "Destroying the current TArrayArena");
+  }
+
+  // The arena new ArenaTArray buffers on this thread come from, if any.
+  static TArrayArena* GetCurrent() { return sCurrent; }
+
+  size_t SizeOfExcludingThis(MallocSizeOf aMallocSizeOf) const {
+    return mAllocator.SizeOfExcludingThis(aMallocSizeOf);
+  }
+
+ private:
+  friend class AutoTArrayArena;
+  friend struct TArrayArenaAllocator;
+
+  static constexpr size_t kAlignment = alignof(std::max_align_t);
+
+  // Precedes every buffer, so that we know where a buffer comes from and how
+  // much of it to copy when it grows.
+  struct alignas(kAlignment) BufferHeader {
+    // Null for buffers allocated from the heap.
+    TArrayArena* mArena;
+    size_t mSize;
+  };
+
+  static BufferHeader* HeaderOf(void* aPtr) {
+    return static_cast<BufferHeader*>(aPtr) - 1;
+  }
+
+  static void* Allocate(size_t aSize) {
+    TArrayArena* arena = sCurrent;
+    void* p = arena ? arena->mAllocator.Allocate(sizeof(BufferHeader) + aSize)
+                    : moz_xmalloc(sizeof(BufferHeader) + aSize);
+    auto* header = static_cast<BufferHeader*>(p);
+    header->mArena = arena;
+    header->mSize = aSize;
+#ifdef DEBUG
+    if (arena) {
+      arena->mLiveBuffers++;
+    }
+#endif
+    return header + 1;
+  }
+
+  static void* Reallocate(void* aPtr, size_t aSize) {
+    BufferHeader* header = HeaderOf(aPtr);
+    TArrayArena* arena = header->mArena;
+    if (!arena) {
+      header = static_cast<BufferHeader*>(
+          moz_xrealloc(header, sizeof(BufferHeader) + aSize));
+      header->mSize = aSize;
+      return header + 1;
+    }
+
+    MOZ_ASSERT(arena == sCurrent, "ArenaTArray outlived its AutoTArrayArena");
+    if (aSize <= header->mSize) {
+      return aPtr;
+    }
+    auto* newHeader = static_cast<BufferHeader*>(
+        arena->mAllocator.Allocate(sizeof(BufferHeader) + aSize));
+    newHeader->mArena = arena;
+    newHeader->mSize = aSize;
+    memcpy(newHeader + 1, aPtr, header->mSize);
+    return newHeader + 1;
+  }
+
+  static void Free(void* aPtr) {
+    BufferHeader* header = HeaderOf(aPtr);
+    if (!header->mArena) {
+      free(header);
+      return;
+    }
+    MOZ_ASSERT(header->mArena == sCurrent,
+               "ArenaTArray outlived its AutoTArrayArena");
+#ifdef DEBUG
+    header->mArena->mLiveBuffers--;
+#endif
+  }
+
+  void Clear() {
+    MOZ_ASSERT(!mLiveBuffers, "ArenaTArray outlived its AutoTArrayArena");
+    mAllocator.Clear();
+  }
+
+  ArenaAllocator<16 * 1024, kAlignment> mAllocator;
+#ifdef DEBUG
+  size_t mLiveBuffers = 0;
+#endif
+
+  static inline thread_local TArrayArena* sCurrent = nullptr;
+};
+
+/**
+ * Makes aArena the arena of the ArenaTArrays created on this thread until
+ * the scope ends, and then frees everything they allocated from it.  Nested
+ * scopes keep using the arena of the outermost one, so that arrays created
+ * during a nested reflow of another document are released with the arrays
+ * of the outer reflow.
+ */
+class MOZ_RAII AutoTArrayArena final {
+ public:
+  explicit AutoTArrayArena(TArrayArena& aArena)
+      : mArena(TArrayArena::sCurrent ? nullptr : &aArena) {
+    if (mArena) {
+      TArrayArena::sCurrent = mArena;
+    }
+  }
+
+  ~AutoTArrayArena() {
+    if (mArena) {
+      TArrayArena::sCurrent = nullptr;
+      mArena->Clear();
+    }
+  }
+
+ private:
+  TArrayArena* mArena;
+};
+
+// The nsTArray allocator of ArenaTArray.  Arena buffers never fail to
+// allocate, so fallible operations on ArenaTArrays behave like infallible
+// ones.
+struct TArrayArenaAllocator : nsTArrayInfallibleAllocatorBase {
+  static constexpr bool kUsesHeap = false;
+
+  static void* Malloc(size_t aSize) MOZ_NONNULL_RETURN {
+    return TArrayArena::Allocate(aSize);
+  }
+  static void* Realloc(void* aPtr, size_t aSize) MOZ_NONNULL_RETURN {
+    return TArrayArena::Reallocate(aPtr, aSize);
+  }
+
+  static void Free(void* aPtr) { TArrayArena::Free(aPtr); }
+  static void SizeTooBig(size_t aSize) { NS_ABORT_OOM(aSize); }
+};
+
+//
+// ArenaTArray is an nsTArray whose buffer comes from the current
+// TArrayArena.  It can't exchange buffers with arrays using other
+// allocators, but it converts to a const nsTArray<E>& like FallibleTArray.
+//
+template <class E>
+class MOZ_GSL_OWNER ArenaTArray
+    : public nsTArray_Impl<E, TArrayArenaAllocator> {
+  // Growing a heap buffer must keep it on the heap, so it has to go through
+  // Realloc rather than Malloc.
+  static_assert(nsTArray_RelocationStrategy<E>::Type::allowRealloc,
+                "ArenaTArray elements must be memmovable");
+
+ public:
+  typedef nsTArray_Impl<E, TArrayArenaAllocator> base_type;
+  typedef ArenaTArray<E> self_type;
+  typedef typename base_type::size_type size_type;
+
+  ArenaTArray() = default;
+  explicit ArenaTArray(size_type aCapacity) : base_type(aCapacity) {}
+
+  ArenaTArray(self_type&& aOther) noexcept : base_type(std::move(aOther)) {}
+  self_type& operator=(self_type&& aOther) {
+    base_type::operator=(std::move(aOther));
+    return *this;
+  }
+
+  ArenaTArray(const self_type&) = delete;
+  self_type& operator=(const self_type&) = delete;
+};
+
+}  // namespace mozilla
+
+#endif  // mozilla_ArenaTArray_h
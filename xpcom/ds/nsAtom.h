@@ -177,6 +177,11 @@ class nsDynamicAtom : public nsAtom {
     return count;
   }
 
+  // Takes a reference only if the atom is in use, so an unused one that GC
+  // may be about to remove isn't resurrected.  For lookups that don't hold the
+  // atom table lock, see nsAtomSubTable::Lookup().
+  bool TryAddRef() { return mRefCnt.IncrementIfNonZero(); }
+
   mozilla::StringBuffer* StringBuffer() const { return mStringBuffer; }
 
   const char16_t* String() const {
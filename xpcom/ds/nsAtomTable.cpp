@@ -5,12 +5,16 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "mozilla/Assertions.h"
+#include "mozilla/Atomics.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/HashFunctions.h"
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/MemoryReporting.h"
 #include "mozilla/MruCache.h"
-#include "mozilla/RWLock.h"
+#include "mozilla/Mutex.h"
 #include "mozilla/TextUtils.h"
+#include "mozilla/ThreadLocal.h"
+#include "mozilla/UniquePtr.h"
 #include "nsHashKeys.h"
 #include "nsThreadUtils.h"
 
@@ -19,9 +23,10 @@
 #include "nsGkAtoms.h"
 #include "nsPrintfCString.h"
 #include "nsString.h"
+#include "nsTArray.h"
 #include "nsUnicharUtils.h"
-#include "PLDHashTable.h"
 #include "prenv.h"
+#include "prthread.h"
 
 // There are two kinds of atoms handled by this module.
 //
@@ -165,13 +170,6 @@ struct AtomTableKey {
   uint32_t mHash;
 };
 
-struct AtomTableEntry : public PLDHashEntryHdr {
-  // These references are either to dynamic atoms, in which case they are
-  // non-owning, or they are to static atoms, which aren't really refcounted.
-  // See the comment at the top of this file for more details.
-  nsAtom* MOZ_NON_OWNING_REF mAtom;
-};
-
 struct AtomCache : public MruCache<AtomTableKey, nsAtom*, AtomCache> {
   static HashNumber Hash(const AtomTableKey& aKey) { return aKey.mHash; }
   static bool Match(const AtomTableKey& aKey, const nsAtom* aVal) {
@@ -184,6 +182,66 @@ struct AtomCache : public MruCache<AtomTableKey, nsAtom*, AtomCache> {
 static AtomCache sRecentlyUsedSmallMainThreadAtoms;
 static AtomCache sRecentlyUsedLargeMainThreadAtoms;
 
+// Lookups of atoms that exist don't lock, see nsAtomSubTable::Lookup().  They
+// announce themselves in one of these stripes of counters instead, and GC
+// waits until none that could still see an atom or slot array it removed is
+// running before freeing it.  Every thread sticks to one stripe so it doesn't
+// share the cache line with others, and each stripe has a counter per
+// sLookupEpoch parity so GC only has to wait for the lookups that started
+// before it flipped the epoch, see WaitForLockFreeLookups().
+//
+// This is a simple form of RCU.  Like everything else about the lock-free
+// lookups it relies on the counters, the epoch and the slots being
+// sequentially consistent atomics: GC removes atoms from the table before it
+// reads the counters, so a lookup it doesn't see counted can't find them.
+static constexpr size_t kNumLookupStripes = 64;
+
+struct alignas(64) LookupStripe {
+  Atomic<uint32_t> mCounts[2];
+};
+
+static LookupStripe sLookupStripes[kNumLookupStripes];
+static Atomic<uint32_t> sLookupEpoch;
+static Atomic<uint32_t> sNextLookupStripe;
+// One more than the index of the current thread's stripe, or zero if it
+// hasn't been assigned one yet.
+static MOZ_THREAD_LOCAL(uint32_t) sLookupStripe;
+
+class MOZ_RAII AutoLockFreeLookup {
+ public:
+  AutoLockFreeLookup() {
+    uint32_t stripe = sLookupStripe.get();
+    if (MOZ_UNLIKELY(!stripe)) {
+      stripe = sNextLookupStripe++ % kNumLookupStripes + 1;
+      sLookupStripe.set(stripe);
+    }
+    mCount = &sLookupStripes[stripe - 1].mCounts[sLookupEpoch & 1];
+    ++*mCount;
+  }
+
+  ~AutoLockFreeLookup() { --*mCount; }
+
+ private:
+  Atomic<uint32_t>* mCount;
+};
+
+// Waits until all lock-free lookups that were running when this was called
+// have finished.
+static void WaitForLockFreeLookups() {
+  MOZ_ASSERT(NS_IsMainThread());
+
+  // New lookups count themselves under the other parity, so this ends even
+  // while more keep starting.  One that read the old epoch, but only counted
+  // itself after we checked its stripe, also reads the slots after that and
+  // can't find what the caller removed.
+  uint32_t epoch = sLookupEpoch++;
+  for (auto& stripe : sLookupStripes) {
+    while (stripe.mCounts[epoch & 1] != 0) {
+      PR_Sleep(PR_INTERVAL_NO_WAIT);
+    }
+  }
+}
+
 // In order to reduce locking contention for concurrent atomization, we segment
 // the atom table into N subtables, each with a separate lock. If the hash
 // values we use to select the subtable are evenly distributed, this reduces the
@@ -191,32 +249,76 @@ static AtomCache sRecentlyUsedLargeMainThreadAtoms;
 //
 // NB: This is somewhat similar to the technique used by Java's
 // ConcurrentHashTable.
+//
+// Each subtable is an open addressing table with linear probing.  Its slots
+// are atomic so Lookup() can search them without the lock, which only the
+// writers take.  A slot goes from empty to holding an atom, and only GC
+// replaces atoms, with tombstones, which insertions reuse.  A lookup thus
+// never misses an atom that was in the table the whole time it ran.  Growing
+// the table publishes a new slot array, the replaced ones are freed by GC.
 class nsAtomSubTable {
   friend class nsAtomTable;
-  mozilla::RWLock mLock;
-  PLDHashTable mTable;
+
+  struct Slot {
+    // The hash of mAtom, set before mAtom.  Lookups only use it to skip
+    // slots, a stale value is harmless.
+    Atomic<uint32_t, Relaxed> mHash;
+    Atomic<nsAtom*> mAtom;
+  };
+
+  struct Slots {
+    explicit Slots(uint32_t aLog2Capacity)
+        : mLog2Capacity(aLog2Capacity),
+          mSlots(MakeUnique<Slot[]>(Capacity())) {}
+
+    uint32_t Capacity() const { return 1u << mLog2Capacity; }
+    uint32_t Mask() const { return Capacity() - 1; }
+    uint32_t Start(uint32_t aHash) const {
+      // Use the high bits, SelectSubTable() used the low ones.
+      return ScrambleHashCode(aHash) >> (32 - mLog2Capacity);
+    }
+
+    const uint32_t mLog2Capacity;
+    UniquePtr<Slot[]> mSlots;
+    // Slot arrays replaced since the last GC.
+    UniquePtr<Slots> mNextRetired;
+  };
+
+  mozilla::Mutex mLock;
+  // Only written with mLock held.
+  Atomic<Slots*> mSlots;
+  uint32_t mCount MOZ_GUARDED_BY(mLock) = 0;
+  uint32_t mTombstones MOZ_GUARDED_BY(mLock) = 0;
+  UniquePtr<Slots> mRetired MOZ_GUARDED_BY(mLock);
+
   nsAtomSubTable();
-  void GCLocked(GCKind aKind) MOZ_REQUIRES(mLock);
+  ~nsAtomSubTable();
+
+  // Returns the atom, addrefed, if it's in the table and in use, without
+  // locking.  Returns null otherwise, the caller then has to take mLock and
+  // use Search().
+  already_AddRefed<nsAtom> Lookup(const AtomTableKey& aKey);
+
+  nsAtom* Search(const AtomTableKey& aKey) MOZ_REQUIRES(mLock);
+  void Add(nsAtom* aAtom) MOZ_REQUIRES(mLock);
+  void Rebuild(uint32_t aLog2Capacity) MOZ_REQUIRES(mLock);
+
+  // Removes the unused dynamic atoms and appends them to aDead.  They, and
+  // the retired slot arrays moved to aRetired, must only be freed after
+  // WaitForLockFreeLookups().
+  void GCLocked(GCKind aKind, nsTArray<nsDynamicAtom*>& aDead,
+                UniquePtr<Slots>& aRetired) MOZ_REQUIRES(mLock);
   void AddSizeOfExcludingThisLocked(MallocSizeOf aMallocSizeOf,
-                                    AtomsSizes& aSizes)
-      MOZ_REQUIRES_SHARED(mLock);
+                                    AtomsSizes& aSizes) MOZ_REQUIRES(mLock);
 
-  AtomTableEntry* Search(AtomTableKey& aKey) const MOZ_REQUIRES_SHARED(mLock) {
-    // XXX There's no LockedForReadingByCurrentThread();
-    return static_cast<AtomTableEntry*>(mTable.Search(&aKey));
-  }
-
-  AtomTableEntry* Add(AtomTableKey& aKey) MOZ_REQUIRES(mLock) {
-    MOZ_ASSERT(mLock.LockedForWritingByCurrentThread());
-    return static_cast<AtomTableEntry*>(mTable.Add(&aKey));  // Infallible
-  }
+  static constexpr uint32_t kInitialLog2Capacity = 4;
 };
 
 // The outer atom table, which coordinates access to the inner array of
 // subtables.
 class nsAtomTable {
  public:
-  nsAtomSubTable& SelectSubTable(AtomTableKey& aKey);
+  nsAtomSubTable& SelectSubTable(const AtomTableKey& aKey);
   void AddSizeOfIncludingThis(MallocSizeOf aMallocSizeOf, AtomsSizes& aSizes);
   void GC(GCKind aKind);
   already_AddRefed<nsAtom> Atomize(const nsAString& aUTF16String,
@@ -231,11 +333,6 @@ class nsAtomTable {
   // counting.
   size_t RacySlowCount();
 
-  // This hash table op is a static member of this class so that it can take
-  // advantage of |friend| declarations.
-  static void AtomTableClearEntry(PLDHashTable* aTable,
-                                  PLDHashEntryHdr* aEntry);
-
   // We achieve measurable reduction in locking contention in parallel CSS
   // parsing by increasing the number of subtables up to 128. This has been
   // measured to have neglible impact on the performance of initialization, GC,
@@ -263,26 +360,10 @@ class nsAtomTable {
   // pages loaded, but in those cases the actual atoms will dominate memory
   // usage and the overhead of extra tables will be negligible. We're mostly
   // interested in the fixed cost for nearly-empty content processes.
-  constexpr static size_t kNumSubTables = 512;  // Must be power of two.
-
-  // The atom table very quickly gets 10,000+ entries in it (or even 100,000+).
-  // But choosing the best initial subtable length has some subtleties: we add
-  // ~2700 static atoms at start-up, and then we start adding and removing
-  // dynamic atoms. If we make the tables too big to start with, when the first
-  // dynamic atom gets removed from a given table the load factor will be < 25%
-  // and we will shrink it.
   //
-  // So we first make the simplifying assumption that the atoms are more or less
-  // evenly-distributed across the subtables (which is the case empirically).
-  // Then, we take the total atom count when the first dynamic atom is removed
-  // (~2700), divide that across the N subtables, and the largest capacity that
-  // will allow each subtable to be > 25% full with that count.
-  //
-  // So want an initial subtable capacity less than (2700 / N) * 4 = 10800 / N.
-  // Rounding down to the nearest power of two gives us 8192 / N. Since the
-  // capacity is double the initial length, we end up with (4096 / N) per
-  // subtable.
-  constexpr static size_t kInitialSubTableSize = 4096 / kNumSubTables;
+  // Lookups of existing atoms no longer lock, so the subtables now only
+  // spread the insertions of new atoms.
+  constexpr static size_t kNumSubTables = 512;  // Must be power of two.
 
  private:
   nsAtomSubTable mSubTables[kNumSubTables];
@@ -291,41 +372,23 @@ class nsAtomTable {
 // Static singleton instance for the atom table.
 static nsAtomTable* gAtomTable;
 
-static PLDHashNumber AtomTableGetHash(const void* aKey) {
-  const AtomTableKey* k = static_cast<const AtomTableKey*>(aKey);
-  return k->mHash;
-}
-
-static bool AtomTableMatchKey(const PLDHashEntryHdr* aEntry, const void* aKey) {
-  const AtomTableEntry* he = static_cast<const AtomTableEntry*>(aEntry);
-  const AtomTableKey* k = static_cast<const AtomTableKey*>(aKey);
-
-  if (k->mUTF8String) {
+static bool AtomMatchesKey(const nsAtom* aAtom, const AtomTableKey& aKey) {
+  if (aKey.mUTF8String) {
     bool err = false;
-    return (CompareUTF8toUTF16(nsDependentCSubstring(
-                                   k->mUTF8String, k->mUTF8String + k->mLength),
-                               nsDependentAtomString(he->mAtom), &err) == 0) &&
+    return (CompareUTF8toUTF16(
+                nsDependentCSubstring(aKey.mUTF8String,
+                                      aKey.mUTF8String + aKey.mLength),
+                nsDependentAtomString(aAtom), &err) == 0) &&
            !err;
   }
 
-  return he->mAtom->Equals(k->mUTF16String, k->mLength);
-}
-
-void nsAtomTable::AtomTableClearEntry(PLDHashTable* aTable,
-                                      PLDHashEntryHdr* aEntry) {
-  auto* entry = static_cast<AtomTableEntry*>(aEntry);
-  entry->mAtom = nullptr;
-}
-
-static void AtomTableInitEntry(PLDHashEntryHdr* aEntry, const void* aKey) {
-  static_cast<AtomTableEntry*>(aEntry)->mAtom = nullptr;
+  return aAtom->Equals(aKey.mUTF16String, aKey.mLength);
 }
 
-static const PLDHashTableOps AtomTableOps = {
-    AtomTableGetHash, AtomTableMatchKey, PLDHashTable::MoveEntryStub,
-    nsAtomTable::AtomTableClearEntry, AtomTableInitEntry};
+// Marks the slots of atoms removed by GC.
+static nsAtom* const kTombstone = reinterpret_cast<nsAtom*>(uintptr_t(1));
 
-nsAtomSubTable& nsAtomTable::SelectSubTable(AtomTableKey& aKey) {
+nsAtomSubTable& nsAtomTable::SelectSubTable(const AtomTableKey& aKey) {
   // There are a few considerations around how we select subtables.
   //
   // First, we want entries to be evenly distributed across the subtables. This
@@ -337,9 +400,9 @@ nsAtomSubTable& nsAtomTable::SelectSubTable(AtomTableKey& aKey) {
   // entry's position within the subtable. If we used the exact same bits used
   // by the subtables, then each subtable would compute the same position for
   // every entry it observes, leading to pessimal performance. In this case,
-  // we're using PLDHashTable, whose primary hash function uses the N leftmost
-  // bits of the hash value (where N is the log2 capacity of the table). This
-  // means we should prefer the rightmost bits here.
+  // the subtables use the leftmost bits of the scrambled hash value (see
+  // nsAtomSubTable::Slots::Start()). This means we should prefer the
+  // rightmost bits here.
   //
   // Note that the below is equivalent to mHash % kNumSubTables, a replacement
   // which an optimizing compiler should make, but let's avoid any doubt.
@@ -353,7 +416,7 @@ void nsAtomTable::AddSizeOfIncludingThis(MallocSizeOf aMallocSizeOf,
   MOZ_ASSERT(NS_IsMainThread());
   aSizes.mTable += aMallocSizeOf(this);
   for (auto& table : mSubTables) {
-    AutoReadLock lock(table.mLock);
+    MutexAutoLock lock(table.mLock);
     table.AddSizeOfExcludingThisLocked(aMallocSizeOf, aSizes);
   }
 }
@@ -365,11 +428,23 @@ void nsAtomTable::GC(GCKind aKind) {
 
   // Note that this is effectively an incremental GC, since only one subtable
   // is locked at a time.
+  nsTArray<nsDynamicAtom*> dead;
+  UniquePtr<nsAtomSubTable::Slots> retired;
   for (auto& table : mSubTables) {
-    AutoWriteLock lock(table.mLock);
-    table.GCLocked(aKind);
+    MutexAutoLock lock(table.mLock);
+    table.GCLocked(aKind, dead, retired);
   }
 
+  // Lock-free lookups may still be looking at the removed atoms and the
+  // replaced slot arrays.
+  if (!dead.IsEmpty() || retired) {
+    WaitForLockFreeLookups();
+  }
+  for (nsDynamicAtom* atom : dead) {
+    nsDynamicAtom::Destroy(atom);
+  }
+  nsDynamicAtom::gUnusedAtomCount -= int32_t(dead.Length());
+
   // We would like to assert that gUnusedAtomCount matches the number of atoms
   // we found in the table which we removed. However, there are two problems
   // with this:
@@ -388,7 +463,8 @@ void nsAtomTable::GC(GCKind aKind) {
   // Note that, barring refcounting bugs, an atom can only go from a zero
   // refcount to a non-zero refcount while the atom table lock is held, so
   // so we won't try to resurrect a zero refcount atom while trying to delete
-  // it.
+  // it.  Lock-free lookups only take a reference to atoms that already have
+  // one, see nsDynamicAtom::TryAddRef().
 
   MOZ_ASSERT_IF(aKind == GCKind::Shutdown,
                 nsDynamicAtom::gUnusedAtomCount == 0);
@@ -399,8 +475,8 @@ size_t nsAtomTable::RacySlowCount() {
   GC(GCKind::RegularOperation);
   size_t count = 0;
   for (auto& table : mSubTables) {
-    AutoReadLock lock(table.mLock);
-    count += table.mTable.EntryCount();
+    MutexAutoLock lock(table.mLock);
+    count += table.mCount;
   }
 
   return count;
@@ -408,27 +484,122 @@ size_t nsAtomTable::RacySlowCount() {
 
 nsAtomSubTable::nsAtomSubTable()
     : mLock("Atom Sub-Table Lock"),
-      mTable(&AtomTableOps, sizeof(AtomTableEntry),
-             nsAtomTable::kInitialSubTableSize) {}
+      mSlots(new Slots(kInitialLog2Capacity)) {}
+
+nsAtomSubTable::~nsAtomSubTable() { delete mSlots; }
+
+already_AddRefed<nsAtom> nsAtomSubTable::Lookup(const AtomTableKey& aKey) {
+  AutoLockFreeLookup lookup;
 
-void nsAtomSubTable::GCLocked(GCKind aKind) {
+  Slots* slots = mSlots;
+  for (uint32_t i = slots->Start(aKey.mHash);; i = (i + 1) & slots->Mask()) {
+    Slot& slot = slots->mSlots[i];
+    nsAtom* atom = slot.mAtom;
+    if (!atom) {
+      return nullptr;
+    }
+    if (atom == kTombstone || slot.mHash != aKey.mHash ||
+        !AtomMatchesKey(atom, aKey)) {
+      continue;
+    }
+    if (atom->IsStatic()) {
+      return already_AddRefed<nsAtom>(atom);
+    }
+    // An unused atom may be about to be removed by GC.
+    return atom->AsDynamic()->TryAddRef() ? already_AddRefed<nsAtom>(atom)
+                                          : nullptr;
+  }
+}
+
+nsAtom* nsAtomSubTable::Search(const AtomTableKey& aKey) {
+  mLock.AssertCurrentThreadOwns();
+
+  Slots* slots = mSlots;
+  for (uint32_t i = slots->Start(aKey.mHash);; i = (i + 1) & slots->Mask()) {
+    Slot& slot = slots->mSlots[i];
+    nsAtom* atom = slot.mAtom;
+    if (!atom) {
+      return nullptr;
+    }
+    if (atom != kTombstone && slot.mHash == aKey.mHash &&
+        AtomMatchesKey(atom, aKey)) {
+      return atom;
+    }
+  }
+}
+
+void nsAtomSubTable::Add(nsAtom* aAtom) {
+  mLock.AssertCurrentThreadOwns();
+
+  // Keep at least a quarter of the slots empty, so probing stays short and
+  // always ends.
+  Slots* slots = mSlots;
+  if ((mCount + mTombstones + 1) * 4 > slots->Capacity() * 3) {
+    Rebuild(std::max<uint32_t>(kInitialLog2Capacity,
+                               CeilingLog2((mCount + 1) * 2)));
+    slots = mSlots;
+  }
+
+  for (uint32_t i = slots->Start(aAtom->hash());; i = (i + 1) & slots->Mask()) {
+    Slot& slot = slots->mSlots[i];
+    nsAtom* atom = slot.mAtom;
+    if (!atom || atom == kTombstone) {
+      if (atom == kTombstone) {
+        mTombstones--;
+      }
+      slot.mHash = aAtom->hash();
+      slot.mAtom = aAtom;
+      mCount++;
+      return;
+    }
+  }
+}
+
+void nsAtomSubTable::Rebuild(uint32_t aLog2Capacity) {
+  mLock.AssertCurrentThreadOwns();
+
+  Slots* old = mSlots;
+  auto* slots = new Slots(aLog2Capacity);
+  for (uint32_t i = 0; i < old->Capacity(); i++) {
+    nsAtom* atom = old->mSlots[i].mAtom;
+    if (!atom || atom == kTombstone) {
+      continue;
+    }
+    uint32_t j = slots->Start(atom->hash());
+    while (slots->mSlots[j].mAtom) {
+      j = (j + 1) & slots->Mask();
+    }
+    slots->mSlots[j].mHash = atom->hash();
+    slots->mSlots[j].mAtom = atom;
+  }
+  mTombstones = 0;
+
+  // Lock-free lookups may still be searching the old array.
+  mSlots = slots;
+  old->mNextRetired = std::move(mRetired);
+  mRetired.reset(old);
+}
+
+void nsAtomSubTable::GCLocked(GCKind aKind, nsTArray<nsDynamicAtom*>& aDead,
+                              UniquePtr<Slots>& aRetired) {
   MOZ_ASSERT(NS_IsMainThread());
-  MOZ_ASSERT(mLock.LockedForWritingByCurrentThread());
+  mLock.AssertCurrentThreadOwns();
 
-  int32_t removedCount = 0;  // A non-atomic temporary for cheaper increments.
   nsAutoCString nonZeroRefcountAtoms;
   uint32_t nonZeroRefcountAtomsCount = 0;
-  for (auto i = mTable.Iter(); !i.Done(); i.Next()) {
-    auto* entry = static_cast<AtomTableEntry*>(i.Get());
-    if (entry->mAtom->IsStatic()) {
+  Slots* slots = mSlots;
+  for (uint32_t i = 0; i < slots->Capacity(); i++) {
+    Slot& slot = slots->mSlots[i];
+    nsAtom* atom = slot.mAtom;
+    if (!atom || atom == kTombstone || atom->IsStatic()) {
       continue;
     }
 
-    nsAtom* atom = entry->mAtom;
     if (atom->IsDynamic() && atom->AsDynamic()->mRefCnt == 0) {
-      i.Remove();
-      nsDynamicAtom::Destroy(atom->AsDynamic());
-      ++removedCount;
+      slot.mAtom = kTombstone;
+      mCount--;
+      mTombstones++;
+      aDead.AppendElement(atom->AsDynamic());
     }
 #ifdef NS_FREE_PERMANENT_DATA
     else if (aKind == GCKind::Shutdown && PR_GetEnv("XPCOM_MEM_BLOAT_LOG")) {
@@ -454,7 +625,20 @@ void nsAtomSubTable::GCLocked(GCKind aKind) {
     NS_ASSERTION(nonZeroRefcountAtomsCount == 0, msg.get());
   }
 
-  nsDynamicAtom::gUnusedAtomCount -= removedCount;
+  // Shrink tables that became mostly empty, and clean up tombstones.
+  uint32_t log2Capacity = std::max<uint32_t>(
+      kInitialLog2Capacity, CeilingLog2(std::max(mCount, 1u) * 2));
+  if (log2Capacity + 2 < slots->mLog2Capacity ||
+      mTombstones * 4 > slots->Capacity()) {
+    Rebuild(log2Capacity);
+  }
+
+  while (mRetired) {
+    UniquePtr<Slots> next = std::move(mRetired->mNextRetired);
+    mRetired->mNextRetired = std::move(aRetired);
+    aRetired = std::move(mRetired);
+    mRetired = std::move(next);
+  }
 }
 
 void nsDynamicAtom::GCAtomTable() {
@@ -473,6 +657,10 @@ void NS_InitAtomTable() {
   MOZ_ASSERT(NS_IsMainThread());
   MOZ_ASSERT(!gAtomTable);
 
+  if (!sLookupStripe.init()) {
+    MOZ_CRASH("Failed to initialize the atom table's thread-local");
+  }
+
   // We register static atoms immediately so they're available for use as early
   // as possible.
   gAtomTable = new nsAtomTable();
@@ -502,10 +690,19 @@ void NS_AddSizeOfAtoms(MallocSizeOf aMallocSizeOf, AtomsSizes& aSizes) {
 
 void nsAtomSubTable::AddSizeOfExcludingThisLocked(MallocSizeOf aMallocSizeOf,
                                                   AtomsSizes& aSizes) {
-  aSizes.mTable += mTable.ShallowSizeOfExcludingThis(aMallocSizeOf);
-  for (auto iter = mTable.Iter(); !iter.Done(); iter.Next()) {
-    auto* entry = static_cast<AtomTableEntry*>(iter.Get());
-    entry->mAtom->AddSizeOfIncludingThis(aMallocSizeOf, aSizes);
+  Slots* slots = mSlots;
+  aSizes.mTable += aMallocSizeOf(slots) + aMallocSizeOf(slots->mSlots.get());
+  for (uint32_t i = 0; i < slots->Capacity(); i++) {
+    nsAtom* atom = slots->mSlots[i].mAtom;
+    if (atom && atom != kTombstone) {
+      atom->AddSizeOfIncludingThis(aMallocSizeOf, aSizes);
+    }
+  }
+
+  for (Slots* retired = mRetired.get(); retired;
+       retired = retired->mNextRetired.get()) {
+    aSizes.mTable +=
+        aMallocSizeOf(retired) + aMallocSizeOf(retired->mSlots.get());
   }
 }
 
@@ -528,9 +725,8 @@ void nsAtomTable::RegisterStaticAtoms(const nsStaticAtom* aAtoms,
 
     AtomTableKey key(atom);
     nsAtomSubTable& table = SelectSubTable(key);
-    AutoWriteLock lock(table.mLock);
-    AtomTableEntry* he = table.Add(key);
-    if (he->mAtom) {
+    MutexAutoLock lock(table.mLock);
+    if (nsAtom* existing = table.Search(key)) {
       // There are two ways we could get here.
       // - Register two static atoms with the same string.
       // - Create a dynamic atom and then register a static atom with the same
@@ -538,10 +734,10 @@ void nsAtomTable::RegisterStaticAtoms(const nsStaticAtom* aAtoms,
       // Both cases can cause subtle bugs, and are disallowed. We're
       // programming in C++ here, not Smalltalk.
       nsAutoCString name;
-      he->mAtom->ToUTF8String(name);
+      existing->ToUTF8String(name);
       MOZ_CRASH_UNSAFE_PRINTF("Atom for '%s' already exists", name.get());
     }
-    he->mAtom = const_cast<nsStaticAtom*>(atom);
+    table.Add(const_cast<nsStaticAtom*>(atom));
   }
 }
 
@@ -562,18 +758,13 @@ already_AddRefed<nsAtom> nsAtomTable::Atomize(const nsACString& aUTF8String) {
     return Atomize(str, HashString(str));
   }
   nsAtomSubTable& table = SelectSubTable(key);
-  {
-    AutoReadLock lock(table.mLock);
-    if (AtomTableEntry* he = table.Search(key)) {
-      return do_AddRef(he->mAtom);
-    }
+  if (RefPtr<nsAtom> atom = table.Lookup(key)) {
+    return atom.forget();
   }
 
-  AutoWriteLock lock(table.mLock);
-  AtomTableEntry* he = table.Add(key);
-
-  if (he->mAtom) {
-    return do_AddRef(he->mAtom);
+  MutexAutoLock lock(table.mLock);
+  if (nsAtom* atom = table.Search(key)) {
+    return do_AddRef(atom);
   }
 
   nsString str;
@@ -581,7 +772,7 @@ already_AddRefed<nsAtom> nsAtomTable::Atomize(const nsACString& aUTF8String) {
   MOZ_ASSERT(str.GetStringBuffer(), "Should create a string buffer");
   RefPtr<nsAtom> atom = dont_AddRef(nsDynamicAtom::Create(str, key.mHash));
 
-  he->mAtom = atom;
+  table.Add(atom);
 
   return atom.forget();
 }
@@ -599,23 +790,18 @@ already_AddRefed<nsAtom> nsAtomTable::Atomize(const nsAString& aUTF16String,
                                               uint32_t aHash) {
   AtomTableKey key(aUTF16String.Data(), aUTF16String.Length(), aHash);
   nsAtomSubTable& table = SelectSubTable(key);
-  {
-    AutoReadLock lock(table.mLock);
-    if (AtomTableEntry* he = table.Search(key)) {
-      return do_AddRef(he->mAtom);
-    }
+  if (RefPtr<nsAtom> atom = table.Lookup(key)) {
+    return atom.forget();
   }
-  AutoWriteLock lock(table.mLock);
-  AtomTableEntry* he = table.Add(key);
 
-  if (he->mAtom) {
-    RefPtr<nsAtom> atom = he->mAtom;
-    return atom.forget();
+  MutexAutoLock lock(table.mLock);
+  if (nsAtom* atom = table.Search(key)) {
+    return do_AddRef(atom);
   }
 
   RefPtr<nsAtom> atom =
       dont_AddRef(nsDynamicAtom::Create(aUTF16String, key.mHash));
-  he->mAtom = atom;
+  table.Add(atom);
 
   return atom.forget();
 }
@@ -645,22 +831,19 @@ already_AddRefed<nsAtom> nsAtomTable::AtomizeMainThread(
   }
 
   nsAtomSubTable& table = SelectSubTable(key);
-  {
-    AutoReadLock lock(table.mLock);
-    if (AtomTableEntry* he = table.Search(key)) {
-      p.Set(he->mAtom);
-      return do_AddRef(he->mAtom);
-    }
+  retVal = table.Lookup(key);
+  if (retVal) {
+    p.Set(retVal);
+    return retVal.forget();
   }
 
-  AutoWriteLock lock(table.mLock);
-  AtomTableEntry* he = table.Add(key);
-  if (he->mAtom) {
-    retVal = he->mAtom;
+  MutexAutoLock lock(table.mLock);
+  if (nsAtom* atom = table.Search(key)) {
+    retVal = atom;
   } else {
     RefPtr<nsAtom> newAtom =
         dont_AddRef(nsDynamicAtom::Create(aUTF16String, key.mHash));
-    he->mAtom = newAtom;
+    table.Add(newAtom);
     retVal = std::move(newAtom);
   }
 
@@ -689,10 +872,11 @@ nsStaticAtom* NS_GetStaticAtom(const nsAString& aUTF16String) {
 nsStaticAtom* nsAtomTable::GetStaticAtom(const nsAString& aUTF16String) {
   AtomTableKey key(aUTF16String.Data(), aUTF16String.Length());
   nsAtomSubTable& table = SelectSubTable(key);
-  AutoReadLock lock(table.mLock);
-  AtomTableEntry* he = table.Search(key);
-  return he && he->mAtom->IsStatic() ? static_cast<nsStaticAtom*>(he->mAtom)
-                                     : nullptr;
+  // Static atoms are never removed, so this doesn't need to keep the atom
+  // alive.
+  RefPtr<nsAtom> atom = table.Lookup(key);
+  return atom && atom->IsStatic() ? static_cast<nsStaticAtom*>(atom.get())
+                                  : nullptr;
 }
 
 void ToLowerCaseASCII(RefPtr<nsAtom>& aAtom) {
@@ -156,6 +156,8 @@ nsTArray_base<Alloc, RelocationStrategy>::EnsureCapacityImpl(
   MOZ_ASSERT(aCapacity > mHdr->mCapacity,
              "Should have been checked by caller (EnsureCapacity)");
 
+  using Allocator = BufferAlloc<ActualAlloc>;
+
   // If the requested memory allocation exceeds size_type(-1)/2, then
   // our doubling algorithm may not be able to allocate it.
   // Additionally, if it exceeds uint32_t(-1) then we couldn't fit in the
@@ -170,7 +172,7 @@ nsTArray_base<Alloc, RelocationStrategy>::EnsureCapacityImpl(
 
   if (HasEmptyHeader()) {
     // Malloc() new data
-    Header* header = static_cast<Header*>(ActualAlloc::Malloc(reqSize));
+    Header* header = static_cast<Header*>(Allocator::Malloc(reqSize));
     if (!header) {
       return ActualAlloc::FailureResult();
     }
@@ -205,7 +207,7 @@ nsTArray_base<Alloc, RelocationStrategy>::EnsureCapacityImpl(
   Header* header;
   if (UsesAutoArrayBuffer() || !RelocationStrategy::allowRealloc) {
     // Malloc() and copy
-    header = static_cast<Header*>(ActualAlloc::Malloc(bytesToAlloc));
+    header = static_cast<Header*>(Allocator::Malloc(bytesToAlloc));
     if (!header) {
       return ActualAlloc::FailureResult();
     }
@@ -214,11 +216,11 @@ nsTArray_base<Alloc, RelocationStrategy>::EnsureCapacityImpl(
         header, mHdr, Length(), aElemSize);
 
     if (!UsesAutoArrayBuffer()) {
-      ActualAlloc::Free(mHdr);
+      Allocator::Free(mHdr);
     }
   } else {
     // Realloc() existing data
-    header = static_cast<Header*>(ActualAlloc::Realloc(mHdr, bytesToAlloc));
+    header = static_cast<Header*>(Allocator::Realloc(mHdr, bytesToAlloc));
     if (!header) {
       return ActualAlloc::FailureResult();
     }
@@ -247,6 +249,8 @@ void nsTArray_base<Alloc, RelocationStrategy>::ShrinkCapacity(
     return;
   }
 
+  using Allocator = BufferAlloc<nsTArrayFallibleAllocator>;
+
   size_type length = Length();
 
   if (IsAutoArray() && GetAutoArrayBuffer(aElemAlign)->mCapacity >= length) {
@@ -257,14 +261,14 @@ void nsTArray_base<Alloc, RelocationStrategy>::ShrinkCapacity(
     RelocationStrategy::RelocateNonOverlappingRegion(header + 1, mHdr + 1,
                                                      length, aElemSize);
 
-    nsTArrayFallibleAllocator::Free(mHdr);
+    Allocator::Free(mHdr);
     mHdr = header;
     return;
   }
 
   if (length == 0) {
     MOZ_ASSERT(!IsAutoArray(), "autoarray should have fit 0 elements");
-    nsTArrayFallibleAllocator::Free(mHdr);
+    Allocator::Free(mHdr);
     mHdr = EmptyHdr();
     return;
   }
@@ -274,8 +278,7 @@ void nsTArray_base<Alloc, RelocationStrategy>::ShrinkCapacity(
   Header* newHeader;
   if (!RelocationStrategy::allowRealloc) {
     // Malloc() and copy.
-    newHeader =
-        static_cast<Header*>(nsTArrayFallibleAllocator::Malloc(newSize));
+    newHeader = static_cast<Header*>(Allocator::Malloc(newSize));
     if (!newHeader) {
       return;
     }
@@ -283,11 +286,10 @@ void nsTArray_base<Alloc, RelocationStrategy>::ShrinkCapacity(
     RelocationStrategy::RelocateNonOverlappingRegionWithHeader(
         newHeader, mHdr, Length(), aElemSize);
 
-    nsTArrayFallibleAllocator::Free(mHdr);
+    Allocator::Free(mHdr);
   } else {
     // Realloc() existing data.
-    newHeader =
-        static_cast<Header*>(nsTArrayFallibleAllocator::Realloc(mHdr, newSize));
+    newHeader = static_cast<Header*>(Allocator::Realloc(mHdr, newSize));
     if (!newHeader) {
       return;
     }
@@ -308,7 +310,7 @@ void nsTArray_base<Alloc, RelocationStrategy>::ShrinkCapacityToZero(
 
   const bool isAutoArray = IsAutoArray();
 
-  nsTArrayFallibleAllocator::Free(mHdr);
+  BufferAlloc<nsTArrayFallibleAllocator>::Free(mHdr);
 
   if (isAutoArray) {
     mHdr = GetAutoArrayBufferUnsafe(aElemAlign);
@@ -459,6 +461,9 @@ typename ActualAlloc::ResultTypeProxy
 nsTArray_base<Alloc, RelocationStrategy>::SwapArrayElements(
     nsTArray_base<Allocator, RelocationStrategy>& aOther, size_type aElemSize,
     size_t aElemAlign) {
+  static_assert(CanShareBuffersWith<Allocator>,
+                "Can't swap the buffers of arrays using these allocators");
+
   // EnsureNotUsingAutoArrayBuffer will set mHdr = sEmptyTArrayHeader even if we
   // have an auto buffer.  We need to point mHdr back to our auto buffer before
   // we return, otherwise we'll forget that we have an auto buffer at all!
@@ -566,6 +571,8 @@ void nsTArray_base<Alloc, RelocationStrategy>::MoveInit(
   // where the target array is empty with no allocated heap storage. It is
   // provided and used to simplify template instantiation and enable better code
   // generation.
+  static_assert(CanShareBuffersWith<Allocator>,
+                "Can't move the buffer of an array using another allocator");
 
   MOZ_ASSERT(Length() == 0);
   MOZ_ASSERT(Capacity() == 0 || (IsAutoArray() && UsesAutoArrayBuffer()));
@@ -627,6 +634,8 @@ void nsTArray_base<Alloc, RelocationStrategy>::MoveConstructNonAutoArray(
   // We know that we are not an (Copyable)AutoTArray and we know that we are
   // empty, so don't use SwapArrayElements which doesn't know either of these
   // facts and is very complex.
+  static_assert(CanShareBuffersWith<Allocator>,
+                "Can't move the buffer of an array using another allocator");
 
   if (aOther.IsEmpty()) {
     return;
@@ -674,7 +683,8 @@ bool nsTArray_base<Alloc, RelocationStrategy>::EnsureNotUsingAutoArrayBuffer(
 
     size_type size = sizeof(Header) + Length() * aElemSize;
 
-    Header* header = static_cast<Header*>(ActualAlloc::Malloc(size));
+    Header* header =
+        static_cast<Header*>(BufferAlloc<ActualAlloc>::Malloc(size));
     if (!header) {
       return false;
     }
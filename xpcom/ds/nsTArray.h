@@ -89,6 +89,7 @@ class ResponsiveImageCandidate;
 class ServiceWorkerRegistrationData;
 namespace indexedDB {
 class SerializedStructuredCloneReadInfo;
+class ObjectStoreAddPutParams;
 class ObjectStoreCursorResponse;
 class IndexCursorResponse;
 }  // namespace indexedDB
@@ -199,7 +200,10 @@ struct nsTArrayInfallibleResult {};
 
 //
 // nsTArray*Allocators must all use the same |free()|, to allow swap()'ing
-// between fallible and infallible variants.
+// between fallible and infallible variants.  Allocators that hand out buffers
+// from somewhere else, like nsTArrayArenaAllocator, set kUsesHeap to false;
+// their arrays then always use them for their buffers, and can't exchange
+// buffers with arrays using any other allocator.
 //
 
 struct nsTArrayFallibleAllocatorBase {
@@ -242,6 +246,8 @@ struct nsTArrayInfallibleAllocatorBase {
 };
 
 struct nsTArrayFallibleAllocator : nsTArrayFallibleAllocatorBase {
+  static constexpr bool kUsesHeap = true;
+
   static void* Malloc(size_t aSize) { return malloc(aSize); }
   static void* Realloc(void* aPtr, size_t aSize) {
     return realloc(aPtr, aSize);
@@ -252,6 +258,8 @@ struct nsTArrayFallibleAllocator : nsTArrayFallibleAllocatorBase {
 };
 
 struct nsTArrayInfallibleAllocator : nsTArrayInfallibleAllocatorBase {
+  static constexpr bool kUsesHeap = true;
+
   static void* Malloc(size_t aSize) MOZ_NONNULL_RETURN {
     return moz_xmalloc(aSize);
   }
@@ -418,8 +426,8 @@ struct nsTArray_SafeElementAtHelper<mozilla::OwningNonNull<E>, Derived>
 template <class Alloc, class RelocationStrategy>
 class nsTArray_base {
   // Allow swapping elements with |nsTArray_base|s created using a
-  // different allocator.  This is kosher because all allocators use
-  // the same free().
+  // different allocator.  This is kosher because all heap allocators use
+  // the same free(); see CanShareBuffersWith.
   template <class XAlloc, class XRelocationStrategy>
   friend class nsTArray_base;
 
@@ -458,6 +466,18 @@ class nsTArray_base {
   nsTArray_base(const nsTArray_base&);
   nsTArray_base& operator=(const nsTArray_base&);
 
+  // The allocator that allocates our buffers when an operation asks
+  // ActualAlloc for one.  For arrays whose Alloc doesn't use the heap, this
+  // is always Alloc, and ActualAlloc only decides how failures are reported.
+  template <typename ActualAlloc>
+  using BufferAlloc = std::conditional_t<Alloc::kUsesHeap, ActualAlloc, Alloc>;
+
+  // Whether we can take over the buffers of arrays using Allocator.
+  template <class Allocator>
+  static constexpr bool CanShareBuffersWith =
+      std::is_same_v<Alloc, Allocator> ||
+      (Alloc::kUsesHeap && Allocator::kUsesHeap);
+
   // Resize the storage if necessary to achieve the requested capacity.
   // @param aCapacity The requested number of array elements.
   // @param aElemSize The size of an array element.
@@ -855,6 +875,8 @@ MOZ_DECLARE_RELOCATE_USING_MOVE_CONSTRUCTOR(
 MOZ_DECLARE_RELOCATE_USING_MOVE_CONSTRUCTOR(
     mozilla::dom::ipc::StructuredCloneData)
 MOZ_DECLARE_RELOCATE_USING_MOVE_CONSTRUCTOR(mozilla::dom::ClonedMessageData)
+MOZ_DECLARE_RELOCATE_USING_MOVE_CONSTRUCTOR(
+    mozilla::dom::indexedDB::ObjectStoreAddPutParams)
 MOZ_DECLARE_RELOCATE_USING_MOVE_CONSTRUCTOR(
     mozilla::dom::indexedDB::ObjectStoreCursorResponse)
 MOZ_DECLARE_RELOCATE_USING_MOVE_CONSTRUCTOR(
@@ -1172,7 +1194,9 @@ class nsTArray_Impl
   // "Shallow" prefix.
   [[nodiscard]] size_t ShallowSizeOfExcludingThis(
       mozilla::MallocSizeOf aMallocSizeOf) const {
-    if (this->UsesAutoArrayBuffer() || this->HasEmptyHeader()) {
+    // Buffers that aren't on the heap are measured with whatever owns them.
+    if (!Alloc::kUsesHeap || this->UsesAutoArrayBuffer() ||
+        this->HasEmptyHeader()) {
       return 0;
     }
     return aMallocSizeOf(this->Hdr());
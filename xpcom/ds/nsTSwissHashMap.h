@@ -0,0 +1,489 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef XPCOM_DS_NSTSWISSHASHMAP_H_
+#define XPCOM_DS_NSTSWISSHASHMAP_H_
+
+#include <new>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include <utility>
+
+#include "mozilla/Assertions.h"
+#include "mozilla/Attributes.h"
+#include "mozilla/HashFunctions.h"
+#include "mozilla/MathAlgorithms.h"
+#include "mozilla/MemoryReporting.h"
+#include "mozilla/OperatorNewExtensions.h"
+#include "mozilla/mozalloc.h"
+#include "nsTHashMap.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define NS_SWISS_HASHTABLE_SSE2
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#  define NS_SWISS_HASHTABLE_NEON
+#  include <arm_neon.h>
+#endif
+
+namespace mozilla::detail {
+
+// The metadata of nsTSwissHashtable: one control byte per slot, in groups of
+// kSwissGroupWidth that are matched against a byte at once.  A control byte
+// is kSwissEmpty, kSwissDeleted, or the low 7 bits of the scrambled hash of
+// the entry in the slot.
+static constexpr uint32_t kSwissGroupWidth = 16;
+static constexpr uint8_t kSwissEmpty = 0x80;
+static constexpr uint8_t kSwissDeleted = 0xfe;
+
+// The slots of a group whose control byte matched, lowest first.
+class SwissBitMask {
+ public:
+#ifdef NS_SWISS_HASHTABLE_NEON
+  // NEON has no movemask, a match is a bit per nibble instead.
+  static constexpr uint32_t kShift = 2;
+  static constexpr uint64_t kLaneBits = 0x8888888888888888ull;
+#else
+  static constexpr uint32_t kShift = 0;
+  static constexpr uint64_t kLaneBits = 0xffffull;
+#endif
+
+  explicit SwissBitMask(uint64_t aMask) : mMask(aMask & kLaneBits) {}
+
+  explicit operator bool() const { return mMask != 0; }
+  uint32_t Lowest() const { return CountTrailingZeroes64(mMask) >> kShift; }
+  void ClearLowest() { mMask &= mMask - 1; }
+
+ private:
+  uint64_t mMask;
+};
+
+class SwissGroup {
+ public:
+  explicit SwissGroup(const uint8_t* aCtrl) {
+#if defined(NS_SWISS_HASHTABLE_SSE2)
+    mCtrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aCtrl));
+#elif defined(NS_SWISS_HASHTABLE_NEON)
+    mCtrl = vld1q_u8(aCtrl);
+#else
+    memcpy(mCtrl, aCtrl, kSwissGroupWidth);
+#endif
+  }
+
+  SwissBitMask Match(uint8_t aByte) const {
+#if defined(NS_SWISS_HASHTABLE_SSE2)
+    __m128i eq = _mm_cmpeq_epi8(mCtrl, _mm_set1_epi8(char(aByte)));
+    return SwissBitMask(uint32_t(_mm_movemask_epi8(eq)));
+#elif defined(NS_SWISS_HASHTABLE_NEON)
+    return FromNeon(vceqq_u8(mCtrl, vdupq_n_u8(aByte)));
+#else
+    uint64_t mask = 0;
+    for (uint32_t i = 0; i < kSwissGroupWidth; i++) {
+      mask |= uint64_t(mCtrl[i] == aByte) << i;
+    }
+    return SwissBitMask(mask);
+#endif
+  }
+
+  // The empty or deleted slots, the only control bytes with the high bit set.
+  SwissBitMask MatchFree() const {
+#if defined(NS_SWISS_HASHTABLE_SSE2)
+    return SwissBitMask(uint32_t(_mm_movemask_epi8(mCtrl)));
+#elif defined(NS_SWISS_HASHTABLE_NEON)
+    return FromNeon(vcltq_s8(vreinterpretq_s8_u8(mCtrl), vdupq_n_s8(0)));
+#else
+    uint64_t mask = 0;
+    for (uint32_t i = 0; i < kSwissGroupWidth; i++) {
+      mask |= uint64_t(mCtrl[i] >> 7) << i;
+    }
+    return SwissBitMask(mask);
+#endif
+  }
+
+  SwissBitMask MatchEmpty() const { return Match(kSwissEmpty); }
+
+ private:
+#if defined(NS_SWISS_HASHTABLE_SSE2)
+  __m128i mCtrl;
+#elif defined(NS_SWISS_HASHTABLE_NEON)
+  static SwissBitMask FromNeon(uint8x16_t aEq) {
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(aEq), 4);
+    return SwissBitMask(vget_lane_u64(vreinterpret_u64_u8(narrowed), 0));
+  }
+
+  uint8x16_t mCtrl;
+#else
+  uint8_t mCtrl[kSwissGroupWidth];
+#endif
+};
+
+}  // namespace mozilla::detail
+
+/**
+ * A hash table with the hash key classes of nsTHashtable, for lookup-heavy
+ * tables that can do without the nsBaseHashtable API.  Use it through
+ * nsTSwissHashMap.
+ *
+ * PLDHashTable probes over the entries, which each hold the full key hash, so
+ * every probe touches another cache line.  This table keeps a control byte
+ * per slot apart from the entries instead, 7 bits of the hash of the slot's
+ * key, and probes a group of 16 slots at once with SSE2 or NEON, only
+ * looking at the entries whose byte matches.  Most lookups touch one line of
+ * control bytes and one entry.
+ *
+ * Unlike nsBaseHashtable the data is not converted, Get() returns a pointer
+ * to it.  Adding or removing entries invalidates those pointers and any
+ * iterator.  Entries must be movable.
+ *
+ * @param KeyClass a wrapper-class for the hashtable key, see nsHashKeys.h
+ * @param DataType the datatype stored in the hashtable
+ */
+template <class KeyClass, class DataType>
+class nsTSwissHashtable {
+  using SwissGroup = mozilla::detail::SwissGroup;
+  static constexpr uint32_t kGroupWidth = mozilla::detail::kSwissGroupWidth;
+
+ public:
+  using KeyType = typename KeyClass::KeyType;
+  using KeyTypePointer = typename KeyClass::KeyTypePointer;
+
+  class EntryType : public KeyClass {
+   public:
+    template <typename... Args>
+    explicit EntryType(KeyTypePointer aKey, Args&&... aArgs)
+        : KeyClass(aKey), mData(std::forward<Args>(aArgs)...) {}
+    EntryType(EntryType&& aOther) = default;
+
+    const DataType& GetData() const { return mData; }
+    DataType* GetModifiableData() { return &mData; }
+
+   private:
+    DataType mData;
+  };
+
+  static_assert(alignof(EntryType) <= kGroupWidth,
+                "Entries follow the control bytes in the same allocation");
+
+  nsTSwissHashtable() = default;
+
+  nsTSwissHashtable(nsTSwissHashtable&& aOther)
+      : mCtrl(std::exchange(aOther.mCtrl, nullptr)),
+        mLog2Groups(std::exchange(aOther.mLog2Groups, 0)),
+        mCount(std::exchange(aOther.mCount, 0)),
+        mDeleted(std::exchange(aOther.mDeleted, 0)) {}
+
+  nsTSwissHashtable& operator=(nsTSwissHashtable&& aOther) {
+    if (this != &aOther) {
+      Clear();
+      mCtrl = std::exchange(aOther.mCtrl, nullptr);
+      mLog2Groups = std::exchange(aOther.mLog2Groups, 0);
+      mCount = std::exchange(aOther.mCount, 0);
+      mDeleted = std::exchange(aOther.mDeleted, 0);
+    }
+    return *this;
+  }
+
+  ~nsTSwissHashtable() { Clear(); }
+
+  uint32_t Count() const { return mCount; }
+  bool IsEmpty() const { return mCount == 0; }
+
+  bool Contains(KeyType aKey) const { return !!Find(aKey); }
+
+  /**
+   * Returns the data for aKey, or null if there is none.
+   */
+  DataType* Get(KeyType aKey) {
+    EntryType* entry = Find(aKey);
+    return entry ? entry->GetModifiableData() : nullptr;
+  }
+  const DataType* Get(KeyType aKey) const {
+    const EntryType* entry = Find(aKey);
+    return entry ? &entry->GetData() : nullptr;
+  }
+
+  /**
+   * Returns the data for aKey, first constructing it from aArgs if there is
+   * none.
+   */
+  template <typename... Args>
+  DataType& LookupOrInsert(KeyType aKey, Args&&... aArgs) {
+    KeyTypePointer key = KeyClass::KeyToPointer(aKey);
+    uint32_t hash = Scramble(KeyClass::HashKey(key));
+    if (EntryType* entry = Find(key, hash)) {
+      return *entry->GetModifiableData();
+    }
+    return *Insert(key, hash, std::forward<Args>(aArgs)...)
+                ->GetModifiableData();
+  }
+
+  /**
+   * Sets the data for aKey, adding an entry if there is none.
+   */
+  template <typename U>
+  DataType& InsertOrUpdate(KeyType aKey, U&& aData) {
+    KeyTypePointer key = KeyClass::KeyToPointer(aKey);
+    uint32_t hash = Scramble(KeyClass::HashKey(key));
+    if (EntryType* entry = Find(key, hash)) {
+      *entry->GetModifiableData() = std::forward<U>(aData);
+      return *entry->GetModifiableData();
+    }
+    return *Insert(key, hash, std::forward<U>(aData))->GetModifiableData();
+  }
+
+  /**
+   * Removes the entry for aKey.  Returns whether there was one.
+   */
+  bool Remove(KeyType aKey) {
+    EntryType* entry = Find(aKey);
+    if (!entry) {
+      return false;
+    }
+    RemoveEntry(entry);
+    return true;
+  }
+
+  void Clear() {
+    if (!mCtrl) {
+      return;
+    }
+    for (EntryType& entry : *this) {
+      entry.~EntryType();
+    }
+    free(mCtrl);
+    mCtrl = nullptr;
+    mLog2Groups = 0;
+    mCount = 0;
+    mDeleted = 0;
+  }
+
+  size_t ShallowSizeOfExcludingThis(mozilla::MallocSizeOf aMallocSizeOf) const {
+    return aMallocSizeOf(mCtrl);
+  }
+
+  size_t ShallowSizeOfIncludingThis(mozilla::MallocSizeOf aMallocSizeOf) const {
+    return aMallocSizeOf(this) + ShallowSizeOfExcludingThis(aMallocSizeOf);
+  }
+
+  template <typename EntryT>
+  class Iterator {
+   public:
+    Iterator(const uint8_t* aCtrl, EntryT* aEntries, uint32_t aIndex,
+             uint32_t aCapacity)
+        : mCtrl(aCtrl),
+          mEntries(aEntries),
+          mIndex(aIndex),
+          mCapacity(aCapacity) {
+      SkipFree();
+    }
+
+    EntryT& operator*() const { return mEntries[mIndex]; }
+    EntryT* operator->() const { return &mEntries[mIndex]; }
+
+    Iterator& operator++() {
+      mIndex++;
+      SkipFree();
+      return *this;
+    }
+
+    bool operator==(const Iterator& aOther) const {
+      return mIndex == aOther.mIndex;
+    }
+    bool operator!=(const Iterator& aOther) const {
+      return mIndex != aOther.mIndex;
+    }
+
+   private:
+    void SkipFree() {
+      while (mIndex < mCapacity && (mCtrl[mIndex] & 0x80)) {
+        mIndex++;
+      }
+    }
+
+    const uint8_t* mCtrl;
+    EntryT* mEntries;
+    uint32_t mIndex;
+    uint32_t mCapacity;
+  };
+
+  Iterator<EntryType> begin() {
+    return Iterator<EntryType>(mCtrl, Entries(), 0, Capacity());
+  }
+  Iterator<EntryType> end() {
+    return Iterator<EntryType>(mCtrl, Entries(), Capacity(), Capacity());
+  }
+  Iterator<const EntryType> begin() const {
+    return Iterator<const EntryType>(mCtrl, Entries(), 0, Capacity());
+  }
+  Iterator<const EntryType> end() const {
+    return Iterator<const EntryType>(mCtrl, Entries(), Capacity(),
+                                     Capacity());
+  }
+
+ private:
+  // Like PLDHashTable, scramble the hash so keys whose hash is the key itself
+  // still spread over the groups.
+  static uint32_t Scramble(mozilla::HashNumber aHash) {
+    return mozilla::ScrambleHashCode(aHash);
+  }
+  static uint8_t H2(uint32_t aHash) { return aHash & 0x7f; }
+
+  uint32_t NumGroups() const { return mCtrl ? 1u << mLog2Groups : 0; }
+  uint32_t Capacity() const { return NumGroups() * kGroupWidth; }
+  // Keep an eighth of the slots free so probing stays short and ends.
+  uint32_t MaxLoad() const { return Capacity() - Capacity() / 8; }
+
+  EntryType* Entries() const {
+    return reinterpret_cast<EntryType*>(mCtrl + Capacity());
+  }
+
+  // The groups a key is looked for in, starting with the one its hash picks.
+  // Triangular steps visit every group of a power of two count.
+  class ProbeSeq {
+   public:
+    ProbeSeq(uint32_t aHash, uint32_t aLog2Groups)
+        : mMask((1u << aLog2Groups) - 1),
+          mGroup(aLog2Groups ? aHash >> (32 - aLog2Groups) : 0) {}
+
+    uint32_t Group() const { return mGroup; }
+    void Next() {
+      mStride++;
+      mGroup = (mGroup + mStride) & mMask;
+    }
+
+   private:
+    uint32_t mMask;
+    uint32_t mGroup;
+    uint32_t mStride = 0;
+  };
+
+  EntryType* Find(KeyType aKey) const {
+    KeyTypePointer key = KeyClass::KeyToPointer(aKey);
+    return Find(key, Scramble(KeyClass::HashKey(key)));
+  }
+
+  EntryType* Find(KeyTypePointer aKey, uint32_t aHash) const {
+    if (!mCtrl) {
+      return nullptr;
+    }
+    EntryType* entries = Entries();
+    for (ProbeSeq seq(aHash, mLog2Groups);; seq.Next()) {
+      uint32_t base = seq.Group() * kGroupWidth;
+      SwissGroup group(mCtrl + base);
+      for (auto match = group.Match(H2(aHash)); match; match.ClearLowest()) {
+        EntryType* entry = &entries[base + match.Lowest()];
+        if (entry->KeyEquals(aKey)) {
+          return entry;
+        }
+      }
+      if (group.MatchEmpty()) {
+        return nullptr;
+      }
+    }
+  }
+
+  // The first empty or deleted slot for aHash.
+  uint32_t FindFree(uint32_t aHash) const {
+    for (ProbeSeq seq(aHash, mLog2Groups);; seq.Next()) {
+      uint32_t base = seq.Group() * kGroupWidth;
+      if (auto slots = SwissGroup(mCtrl + base).MatchFree()) {
+        return base + slots.Lowest();
+      }
+    }
+  }
+
+  template <typename... Args>
+  EntryType* Insert(KeyTypePointer aKey, uint32_t aHash, Args&&... aArgs) {
+    if (mCount + mDeleted + 1 > MaxLoad()) {
+      // Only grow if the table is actually getting full, rather than full of
+      // deleted slots.
+      uint32_t log2Groups = mCtrl ? mLog2Groups : 0;
+      if (mCtrl && mCount + 1 > MaxLoad() / 2) {
+        log2Groups++;
+      }
+      Rehash(log2Groups);
+    }
+
+    uint32_t index = FindFree(aHash);
+    if (mCtrl[index] == kSwissDeletedByte) {
+      mDeleted--;
+    }
+    mCtrl[index] = H2(aHash);
+    mCount++;
+    return new (mozilla::KnownNotNull, &Entries()[index])
+        EntryType(aKey, std::forward<Args>(aArgs)...);
+  }
+
+  void RemoveEntry(EntryType* aEntry) {
+    uint32_t index = aEntry - Entries();
+    aEntry->~EntryType();
+    mCount--;
+    // Lookups stop at the first group with an empty slot, so in such a group
+    // the slot can be marked empty again rather than deleted.
+    uint32_t base = index & ~(kGroupWidth - 1);
+    if (SwissGroup(mCtrl + base).MatchEmpty()) {
+      mCtrl[index] = kSwissEmptyByte;
+    } else {
+      mCtrl[index] = kSwissDeletedByte;
+      mDeleted++;
+    }
+  }
+
+  void Rehash(uint32_t aLog2Groups) {
+    MOZ_RELEASE_ASSERT(aLog2Groups < 27, "Hash table too big");
+
+    uint8_t* oldCtrl = mCtrl;
+    EntryType* oldEntries = Entries();
+    uint32_t oldCapacity = Capacity();
+
+    uint32_t capacity = (1u << aLog2Groups) * kGroupWidth;
+    mCtrl = static_cast<uint8_t*>(
+        moz_xmalloc(capacity + size_t(capacity) * sizeof(EntryType)));
+    memset(mCtrl, kSwissEmptyByte, capacity);
+    mLog2Groups = aLog2Groups;
+    mDeleted = 0;
+
+    EntryType* entries = Entries();
+    for (uint32_t i = 0; i < oldCapacity; i++) {
+      if (oldCtrl[i] & 0x80) {
+        continue;
+      }
+      EntryType& entry = oldEntries[i];
+      uint32_t hash =
+          Scramble(KeyClass::HashKey(KeyClass::KeyToPointer(entry.GetKey())));
+      uint32_t index = FindFree(hash);
+      mCtrl[index] = H2(hash);
+      new (mozilla::KnownNotNull, &entries[index]) EntryType(std::move(entry));
+      entry.~EntryType();
+    }
+    free(oldCtrl);
+  }
+
+  static constexpr uint8_t kSwissEmptyByte = mozilla::detail::kSwissEmpty;
+  static constexpr uint8_t kSwissDeletedByte = mozilla::detail::kSwissDeleted;
+
+  // The control bytes, followed by the entries, in one allocation.  Null
+  // until the first insertion.
+  uint8_t* mCtrl = nullptr;
+  uint32_t mLog2Groups = 0;
+  uint32_t mCount = 0;
+  uint32_t mDeleted = 0;
+};
+
+/**
+ * Like nsTHashMap, with the hash key class picked from KeyType the same way.
+ */
+template <class KeyType, class DataType>
+using nsTSwissHashMap =
+    nsTSwissHashtable<typename mozilla::detail::nsKeyClass<KeyType>::type,
+                      DataType>;
+
+#undef NS_SWISS_HASHTABLE_SSE2
+#undef NS_SWISS_HASHTABLE_NEON
+
+#endif  // XPCOM_DS_NSTSWISSHASHMAP_H_
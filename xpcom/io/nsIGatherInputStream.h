@@ -0,0 +1,50 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef nsIGatherInputStream_h
+#define nsIGatherInputStream_h
+
+#include "mozilla/Span.h"
+#include "nsISupports.h"
+
+class nsIInputStream;
+
+// Called with the buffers of several consecutive segments of the stream at
+// once.  *aConsumed must be set to the number of bytes consumed from their
+// start, counting across segments.  Any returned failure code ends the read,
+// the same as for nsWriteSegmentFun.
+using nsGatherSegmentFun = nsresult (*)(
+    nsIInputStream* aInStream, void* aClosure,
+    mozilla::Span<const mozilla::Span<const char>> aSegments,
+    uint32_t* aConsumed);
+
+#define NS_IGATHERINPUTSTREAM_IID \
+  {0xd7c2d2eb, 0x390a, 0x4ef9, {0xb3, 0x8b, 0xc3, 0x7b, 0x79, 0xad, 0xb0, 0xfe}}
+
+// Implemented by buffered input streams that can hand several of their
+// internal segments to a single writer call, so that they can be written
+// with one vectored write and without being copied first.
+class NS_NO_VTABLE nsIGatherInputStream : public nsISupports {
+ public:
+  NS_INLINE_DECL_STATIC_IID(NS_IGATHERINPUTSTREAM_IID)
+
+  // The most segments passed to a single aWriter call, PR_MAX_IOVECTOR_SIZE.
+  static constexpr uint32_t kMaxSegments = 16;
+
+  // Like nsIInputStream::ReadSegments(), except that aWriter is called only
+  // once, with the segments that can be read right now, up to aCount bytes.
+  // The segments stay valid and the stream doesn't advance until aWriter
+  // returns.
+  virtual nsresult ReadGathered(nsGatherSegmentFun aWriter, void* aClosure,
+                                uint32_t aCount, uint32_t* aReadCount) = 0;
+};
+
+#define NS_DECL_NSIGATHERINPUTSTREAM                                        \
+  virtual nsresult ReadGathered(nsGatherSegmentFun aWriter, void* aClosure, \
+                                uint32_t aCount, uint32_t* aReadCount)      \
+      override;
+
+#endif  // nsIGatherInputStream_h
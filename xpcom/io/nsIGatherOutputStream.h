@@ -0,0 +1,34 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef nsIGatherOutputStream_h
+#define nsIGatherOutputStream_h
+
+#include "mozilla/Span.h"
+#include "nsISupports.h"
+
+#define NS_IGATHEROUTPUTSTREAM_IID \
+  {0x4464505b, 0xf1f0, 0x4f45, {0xbb, 0x0d, 0x2d, 0x15, 0x86, 0xb0, 0xe1, 0xea}}
+
+// Implemented by unbuffered output streams that can write several buffers
+// with a single vectored write, see nsIGatherInputStream.
+class NS_NO_VTABLE nsIGatherOutputStream : public nsISupports {
+ public:
+  NS_INLINE_DECL_STATIC_IID(NS_IGATHEROUTPUTSTREAM_IID)
+
+  // Like nsIOutputStream::Write() for the concatenation of aSegments.  Can
+  // write less than all of them, *aCountWritten counts across segments.
+  virtual nsresult WriteGathered(
+      mozilla::Span<const mozilla::Span<const char>> aSegments,
+      uint32_t* aCountWritten) = 0;
+};
+
+#define NS_DECL_NSIGATHEROUTPUTSTREAM                           \
+  virtual nsresult WriteGathered(                               \
+      mozilla::Span<const mozilla::Span<const char>> aSegments, \
+      uint32_t* aCountWritten) override;
+
+#endif  // nsIGatherOutputStream_h
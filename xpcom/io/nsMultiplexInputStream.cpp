@@ -57,6 +57,8 @@ NS_INTERFACE_MAP_BEGIN(nsMultiplexInputStream)
                                      IsInputStreamLength())
   NS_INTERFACE_MAP_ENTRY_CONDITIONAL(nsIAsyncInputStreamLength,
                                      IsAsyncInputStreamLength())
+  NS_INTERFACE_MAP_ENTRY_CONDITIONAL(nsIGatherInputStream,
+                                     IsGatherInputStream())
   NS_INTERFACE_MAP_ENTRY_AMBIGUOUS(nsISupports, nsIMultiplexInputStream)
   NS_IMPL_QUERY_CLASSINFO(nsMultiplexInputStream)
 NS_INTERFACE_MAP_END
@@ -93,7 +95,8 @@ nsMultiplexInputStream::nsMultiplexInputStream()
       mAsyncWaitRequestedCount(0),
       mSeekableStreams(0),
       mIPCSerializableStreams(0),
-      mCloneableStreams(0) {}
+      mCloneableStreams(0),
+      mGatherStreams(0) {}
 
 NS_IMETHODIMP
 nsMultiplexInputStream::GetCount(uint32_t* aCount) {
@@ -364,6 +367,125 @@ nsresult nsMultiplexInputStream::ReadSegCb(nsIInputStream* aIn, void* aClosure,
   return rv;
 }
 
+NS_IMETHODIMP
+nsMultiplexInputStream::ReadGathered(nsGatherSegmentFun aWriter,
+                                     void* aClosure, uint32_t aCount,
+                                     uint32_t* aResult) {
+  MutexAutoLock lock(mLock);
+
+  *aResult = 0;
+  if (mStatus == NS_BASE_STREAM_CLOSED) {
+    return NS_OK;
+  }
+  if (NS_FAILED(mStatus)) {
+    return mStatus;
+  }
+
+  NS_ASSERTION(aWriter, "missing aWriter");
+  MOZ_ASSERT(IsGatherInputStream());
+
+  nsresult rv = NS_OK;
+  uint32_t len = mStreams.Length();
+  while (mCurrentStream < len && aCount) {
+    ReadGatheredState state;
+    state.mThisStream = this;
+    state.mWriter = aWriter;
+    state.mClosure = aClosure;
+    for (uint32_t i = mCurrentStream; i < len; ++i) {
+      state.mStreams.AppendElement(
+          GatherStream{mStreams[i].mGatherStream, !!mStreams[i].mAsyncStream});
+      state.mReads.AppendElement(0);
+    }
+    state.mLevel = 0;
+    state.mGathered = 0;
+    state.mCount = aCount;
+    state.mConsumed = 0;
+    state.mWriterResult = NS_OK;
+    state.mWriterCalled = false;
+
+    uint32_t read;
+    rv = state.mStreams[0].mStream->ReadGathered(ReadGatheredCb, &state,
+                                                 aCount, &read);
+    if (NS_FAILED(rv)) {
+      break;
+    }
+
+    // if stream is empty, then advance to the next stream.
+    if (!state.mWriterCalled) {
+      NextStream();
+      continue;
+    }
+
+    // The writer was called once, with the segments of one or more
+    // substreams.  The substreams before the last one read from are done.
+    state.mReads[0] = read;
+    for (uint32_t i = 0; i < state.mReads.Length() && state.mReads[i]; ++i) {
+      if (i) {
+        NextStream();
+      }
+      mStartedReadingCurrent = true;
+      mStreams[mCurrentStream].mCurrentPos += state.mReads[i];
+      *aResult += state.mReads[i];
+    }
+    break;
+  }
+
+  // if we successfully read some data, then this call succeeded.
+  return *aResult ? NS_OK : rv;
+}
+
+nsresult nsMultiplexInputStream::ReadGatheredCb(
+    nsIInputStream* aIn, void* aClosure, Span<const Span<const char>> aSegments,
+    uint32_t* aConsumed) {
+  ReadGatheredState* state = static_cast<ReadGatheredState*>(aClosure);
+  uint32_t level = state->mLevel;
+  uint32_t start = state->mGathered;
+
+  uint32_t given = 0;
+  bool complete = true;
+  for (const auto& segment : aSegments) {
+    given += segment.Length();
+    if (state->mSegments.Length() == nsIGatherInputStream::kMaxSegments) {
+      complete = false;
+      continue;
+    }
+    state->mSegments.AppendElement(segment);
+    state->mGathered += segment.Length();
+  }
+  uint32_t gathered = state->mGathered - start;
+
+  // A substream that isn't async and gives less than it was asked for is
+  // at its end, so the segments of the next one can be written along with
+  // its own.  The writer is called by the innermost callback.
+  uint32_t next = level + 1;
+  if (complete && given < state->mCount - start &&
+      !state->mStreams[level].mAsync && next < state->mStreams.Length() &&
+      state->mSegments.Length() < nsIGatherInputStream::kMaxSegments) {
+    state->mLevel = next;
+    uint32_t read;
+    nsresult rv = state->mStreams[next].mStream->ReadGathered(
+        ReadGatheredCb, state, state->mCount - state->mGathered, &read);
+    if (NS_SUCCEEDED(rv)) {
+      state->mReads[next] = read;
+    }
+  }
+
+  if (!state->mWriterCalled) {
+    state->mWriterCalled = true;
+    state->mWriterResult =
+        (state->mWriter)(state->mThisStream, state->mClosure,
+                         state->mSegments, &state->mConsumed);
+  }
+  if (NS_FAILED(state->mWriterResult)) {
+    return state->mWriterResult;
+  }
+
+  *aConsumed = state->mConsumed > start
+                   ? std::min(state->mConsumed - start, gathered)
+                   : 0;
+  return NS_OK;
+}
+
 NS_IMETHODIMP
 nsMultiplexInputStream::IsNonBlocking(bool* aNonBlocking) {
   MutexAutoLock lock(mLock);
@@ -1384,6 +1506,8 @@ void nsMultiplexInputStream::UpdateQIMap(StreamData& aStream) {
   mIsIPCSerializableStream = (mIPCSerializableStreams == length);
   MAYBE_UPDATE_VALUE(mCloneableStreams, nsICloneableInputStream)
   mIsCloneableStream = (mCloneableStreams == length);
+  MAYBE_UPDATE_VALUE_REAL(mGatherStreams, aStream.mGatherStream)
+  mIsGatherInputStream = (mGatherStreams == length);
   // nsMultiplexInputStream is nsIAsyncInputStream if at least 1 of the
   // substream implements that interface
   if (!mIsAsyncInputStream && aStream.mAsyncStream) {
@@ -1418,3 +1542,7 @@ bool nsMultiplexInputStream::IsInputStreamLength() const {
 bool nsMultiplexInputStream::IsAsyncInputStreamLength() const {
   return mIsAsyncInputStreamLength;
 }
+
+bool nsMultiplexInputStream::IsGatherInputStream() const {
+  return mIsGatherInputStream;
+}
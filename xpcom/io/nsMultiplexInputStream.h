@@ -14,6 +14,7 @@
 
 #include "nsIBufferedStreams.h"
 #include "nsICloneableInputStream.h"
+#include "nsIGatherInputStream.h"
 #include "nsIMultiplexInputStream.h"
 #include "nsISeekableStream.h"
 #include "nsCOMPtr.h"
@@ -44,7 +45,8 @@ class nsMultiplexInputStream final : public nsIMultiplexInputStream,
                                      public nsIAsyncInputStream,
                                      public nsIInputStreamCallback,
                                      public nsIInputStreamLength,
-                                     public nsIAsyncInputStreamLength {
+                                     public nsIAsyncInputStreamLength,
+                                     public nsIGatherInputStream {
  public:
   nsMultiplexInputStream();
 
@@ -59,6 +61,7 @@ class nsMultiplexInputStream final : public nsIMultiplexInputStream,
   NS_DECL_NSIINPUTSTREAMCALLBACK
   NS_DECL_NSIINPUTSTREAMLENGTH
   NS_DECL_NSIASYNCINPUTSTREAMLENGTH
+  NS_DECL_NSIGATHERINPUTSTREAM
 
   // This is used for nsIAsyncInputStream::AsyncWait
   void AsyncWaitCompleted();
@@ -84,6 +87,7 @@ class nsMultiplexInputStream final : public nsIMultiplexInputStream,
 
       mAsyncStream = do_QueryInterface(mBufferedStream);
       mSeekableStream = do_QueryInterface(mBufferedStream);
+      mGatherStream = do_QueryInterface(mBufferedStream);
 
       return NS_OK;
     }
@@ -98,6 +102,8 @@ class nsMultiplexInputStream final : public nsIMultiplexInputStream,
     nsCOMPtr<nsIAsyncInputStream> mAsyncStream;
     // This can be null.
     nsCOMPtr<nsISeekableStream> mSeekableStream;
+    // This can be null.
+    nsCOMPtr<nsIGatherInputStream> mGatherStream;
 
     uint64_t mCurrentPos;
   };
@@ -115,7 +121,7 @@ class nsMultiplexInputStream final : public nsIMultiplexInputStream,
   nsresult AsyncWaitInternal();
 
   // This method updates mSeekableStreams, mTellableStreams,
-  // mIPCSerializableStreams and mCloneableStreams values.
+  // mIPCSerializableStreams, mCloneableStreams and mGatherStreams values.
   void UpdateQIMap(StreamData& aStream) MOZ_REQUIRES(mLock);
 
   struct MOZ_STACK_CLASS ReadSegmentsState {
@@ -126,6 +132,28 @@ class nsMultiplexInputStream final : public nsIMultiplexInputStream,
     bool mDone;
   };
 
+  struct GatherStream {
+    nsIGatherInputStream* mStream;
+    bool mAsync;
+  };
+
+  struct MOZ_STACK_CLASS ReadGatheredState {
+    nsCOMPtr<nsIInputStream> mThisStream;
+    nsGatherSegmentFun mWriter;
+    void* mClosure;
+    // The substreams from the current one on, and what was read from each.
+    AutoTArray<GatherStream, 4> mStreams;
+    AutoTArray<uint32_t, 4> mReads;
+    // The index in mStreams of the substream being gathered from.
+    uint32_t mLevel;
+    AutoTArray<Span<const char>, nsIGatherInputStream::kMaxSegments> mSegments;
+    uint32_t mGathered;
+    uint32_t mCount;
+    uint32_t mConsumed;
+    nsresult mWriterResult;
+    bool mWriterCalled;
+  };
+
   void SerializedComplexityInternal(uint32_t aMaxSize, uint32_t* aSizeUsed,
                                     uint32_t* aPipes, uint32_t* aTransferables,
                                     bool* aSerializeAsPipe);
@@ -134,12 +162,17 @@ class nsMultiplexInputStream final : public nsIMultiplexInputStream,
                             const char* aFromRawSegment, uint32_t aToOffset,
                             uint32_t aCount, uint32_t* aWriteCount);
 
+  static nsresult ReadGatheredCb(nsIInputStream* aIn, void* aClosure,
+                                 Span<const Span<const char>> aSegments,
+                                 uint32_t* aConsumed);
+
   bool IsSeekable() const;
   bool IsIPCSerializable() const;
   bool IsCloneable() const;
   bool IsAsyncInputStream() const;
   bool IsInputStreamLength() const;
   bool IsAsyncInputStreamLength() const;
+  bool IsGatherInputStream() const;
 
   Mutex mLock;  // Protects access to all data members.
 
@@ -161,6 +194,7 @@ class nsMultiplexInputStream final : public nsIMultiplexInputStream,
   uint32_t mSeekableStreams MOZ_GUARDED_BY(mLock);
   uint32_t mIPCSerializableStreams MOZ_GUARDED_BY(mLock);
   uint32_t mCloneableStreams MOZ_GUARDED_BY(mLock);
+  uint32_t mGatherStreams MOZ_GUARDED_BY(mLock);
 
   // These are Atomics so that we can check them in QueryInterface without
   // taking a lock (to look at mStreams.Length() and the numbers above)
@@ -168,6 +202,7 @@ class nsMultiplexInputStream final : public nsIMultiplexInputStream,
   Atomic<bool, Relaxed> mIsSeekableStream{true};
   Atomic<bool, Relaxed> mIsIPCSerializableStream{true};
   Atomic<bool, Relaxed> mIsCloneableStream{true};
+  Atomic<bool, Relaxed> mIsGatherInputStream{true};
 
   Atomic<bool, Relaxed> mIsAsyncInputStream{false};
   Atomic<bool, Relaxed> mIsInputStreamLength{false};
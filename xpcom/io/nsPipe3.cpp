@@ -10,6 +10,7 @@
 #include "mozilla/ReentrantMonitor.h"
 #include "nsIBufferedStreams.h"
 #include "nsICloneableInputStream.h"
+#include "nsIGatherInputStream.h"
 #include "nsIPipe.h"
 #include "nsIEventTarget.h"
 #include "nsITellableStream.h"
@@ -191,7 +192,8 @@ class nsPipeInputStream final : public nsIAsyncInputStream,
                                 public nsICloneableInputStream,
                                 public nsIClassInfo,
                                 public nsIBufferedInputStream,
-                                public nsIInputStreamPriority {
+                                public nsIInputStreamPriority,
+                                public nsIGatherInputStream {
  public:
   NS_DECL_THREADSAFE_ISUPPORTS
   NS_DECL_NSIINPUTSTREAM
@@ -202,6 +204,7 @@ class nsPipeInputStream final : public nsIAsyncInputStream,
   NS_DECL_NSICLASSINFO
   NS_DECL_NSIBUFFEREDINPUTSTREAM
   NS_DECL_NSIINPUTSTREAMPRIORITY
+  NS_DECL_NSIGATHERINPUTSTREAM
 
   explicit nsPipeInputStream(nsPipe* aPipe)
       : mPipe(aPipe),
@@ -1193,6 +1196,7 @@ NS_INTERFACE_TABLE_HEAD(nsPipeInputStream)
     NS_INTERFACE_TABLE_ENTRY(nsPipeInputStream, nsIBufferedInputStream)
     NS_INTERFACE_TABLE_ENTRY(nsPipeInputStream, nsIClassInfo)
     NS_INTERFACE_TABLE_ENTRY(nsPipeInputStream, nsIInputStreamPriority)
+    NS_INTERFACE_TABLE_ENTRY(nsPipeInputStream, nsIGatherInputStream)
     NS_INTERFACE_TABLE_ENTRY_AMBIGUOUS(nsPipeInputStream, nsIInputStream,
                                        nsIAsyncInputStream)
     NS_INTERFACE_TABLE_ENTRY_AMBIGUOUS(nsPipeInputStream, nsISupports,
@@ -1405,6 +1409,100 @@ nsPipeInputStream::ReadSegments(nsWriteSegmentFun aWriter, void* aClosure,
   return rv;
 }
 
+NS_IMETHODIMP
+nsPipeInputStream::ReadGathered(nsGatherSegmentFun aWriter, void* aClosure,
+                                uint32_t aCount, uint32_t* aReadCount) {
+  LOG(("III ReadGathered [this=%p count=%u]\n", this, aCount));
+
+  *aReadCount = 0;
+  uint32_t consumed = 0;
+  while (aCount) {
+    AutoReadSegment segment(mPipe, mReadState, aCount);
+    nsresult rv = segment.Status();
+    if (NS_FAILED(rv)) {
+      if (rv == NS_BASE_STREAM_WOULD_BLOCK) {
+        // pipe is empty
+        if (!mBlocking) {
+          return rv;
+        }
+        // wait for some data to be written to the pipe
+        rv = Wait();
+        if (NS_SUCCEEDED(rv)) {
+          continue;
+        }
+      }
+      // ignore this error, just return.
+      if (rv == NS_BASE_STREAM_CLOSED) {
+        return NS_OK;
+      }
+      mPipe->OnInputStreamException(this, rv);
+      return rv;
+    }
+
+    AutoTArray<Span<const char>, kMaxSegments> segments;
+    segments.AppendElement(Span(segment.Data(), segment.Length()));
+    uint32_t gathered = segment.Length();
+    {
+      ReentrantMonitorAutoEnter mon(mPipe->mReentrantMonitor);
+
+      // The segments after the first one are only read if the first one was
+      // read up to its end.  Otherwise the writer appended to it since the
+      // read began and the data would be out of order.
+      char* cursor;
+      char* limit;
+      mPipe->PeekSegment(mReadState, 0, cursor, limit);
+      if (segment.Data() + segment.Length() == limit) {
+        for (uint32_t i = 1; i < kMaxSegments && gathered < aCount; ++i) {
+          mPipe->PeekSegment(mReadState, i, cursor, limit);
+          if (cursor == limit) {
+            break;
+          }
+          uint32_t length = std::min(static_cast<uint32_t>(limit - cursor),
+                                     aCount - gathered);
+          segments.AppendElement(Span<const char>(cursor, length));
+          gathered += length;
+        }
+      }
+    }
+
+    // The following segments can't be freed while the first one is being
+    // read, so they are only released once aWriter is done with them.
+    rv = aWriter(static_cast<nsIAsyncInputStream*>(this), aClosure, segments,
+                 &consumed);
+    if (NS_FAILED(rv)) {
+      // any errors returned from the writer end here: do not
+      // propagate to the caller of ReadGathered.
+      return NS_OK;
+    }
+
+    MOZ_DIAGNOSTIC_ASSERT(consumed <= gathered);
+    uint32_t advance = std::min(consumed, segment.Length());
+    if (advance) {
+      segment.Advance(advance);
+    }
+    *aReadCount += advance;
+    mLogicalOffset += advance;
+    consumed -= advance;
+    break;
+  }
+
+  while (consumed) {
+    AutoReadSegment segment(mPipe, mReadState, consumed);
+    if (NS_FAILED(segment.Status())) {
+      // The stream was closed and drained meanwhile.
+      break;
+    }
+
+    uint32_t advance = segment.Length();
+    segment.Advance(advance);
+    *aReadCount += advance;
+    mLogicalOffset += advance;
+    consumed -= advance;
+  }
+
+  return NS_OK;
+}
+
 NS_IMETHODIMP
 nsPipeInputStream::Read(char* aToBuf, uint32_t aBufLen, uint32_t* aReadCount) {
   return ReadSegments(NS_CopySegmentToBuffer, aToBuf, aBufLen, aReadCount);
@@ -14,6 +14,7 @@
 #include "nsStreamUtils.h"
 #include "nsReadableUtils.h"
 #include "nsICloneableInputStream.h"
+#include "nsIGatherInputStream.h"
 #include "nsISeekableStream.h"
 #include "nsISupportsPrimitives.h"
 #include "nsCRT.h"
@@ -47,7 +48,8 @@ class nsStringInputStream final : public nsIStringInputStream,
                                   public nsISeekableStream,
                                   public nsISupportsCString,
                                   public nsIIPCSerializableInputStream,
-                                  public nsICloneableInputStream {
+                                  public nsICloneableInputStream,
+                                  public nsIGatherInputStream {
  public:
   NS_DECL_THREADSAFE_ISUPPORTS
   NS_DECL_NSIINPUTSTREAM
@@ -58,6 +60,7 @@ class nsStringInputStream final : public nsIStringInputStream,
   NS_DECL_NSISUPPORTSCSTRING
   NS_DECL_NSIIPCSERIALIZABLEINPUTSTREAM
   NS_DECL_NSICLONEABLEINPUTSTREAM
+  NS_DECL_NSIGATHERINPUTSTREAM
 
   nsStringInputStream() = default;
 
@@ -111,7 +114,7 @@ NS_IMPL_QUERY_INTERFACE_CI(nsStringInputStream, nsIStringInputStream,
                            nsIInputStream, nsISupportsCString,
                            nsISeekableStream, nsITellableStream,
                            nsIIPCSerializableInputStream,
-                           nsICloneableInputStream)
+                           nsICloneableInputStream, nsIGatherInputStream)
 NS_IMPL_CI_INTERFACE_GETTER(nsStringInputStream, nsIStringInputStream,
                             nsIInputStream, nsISupportsCString,
                             nsISeekableStream, nsITellableStream,
@@ -332,6 +335,60 @@ nsStringInputStream::ReadSegments(nsWriteSegmentFun aWriter, void* aClosure,
   return NS_OK;
 }
 
+/////////
+// nsIGatherInputStream implementation
+/////////
+
+NS_IMETHODIMP
+nsStringInputStream::ReadGathered(nsGatherSegmentFun aWriter, void* aClosure,
+                                  uint32_t aCount, uint32_t* aResult) {
+  ReentrantMonitorAutoEnter lock(mMon);
+
+  NS_ASSERTION(aResult, "null ptr");
+  NS_ASSERTION(Length() >= mOffset, "bad stream state");
+
+  if (Closed()) {
+    return NS_BASE_STREAM_CLOSED;
+  }
+
+  *aResult = 0;
+
+  // We may be at end-of-file
+  size_t maxCount = LengthRemaining();
+  if (maxCount == 0) {
+    return NS_OK;
+  }
+
+  if (aCount > maxCount) {
+    aCount = maxCount;
+  }
+
+  RefPtr<StreamBufferSource> source = mSource;
+  size_t offset = mOffset;
+
+  Span<const char> segment = source->Data().Subspan(offset, aCount);
+  uint32_t consumed = 0;
+  nsresult rv = aWriter(this, aClosure, Span(&segment, 1), &consumed);
+
+  if (Closed()) {
+    NS_WARNING("nsStringInputStream was closed during ReadGathered");
+    return NS_OK;
+  }
+
+  MOZ_RELEASE_ASSERT(mSource == source, "String was replaced!");
+  MOZ_RELEASE_ASSERT(mOffset == offset, "Nested read operation!");
+
+  if (NS_SUCCEEDED(rv)) {
+    NS_ASSERTION(consumed <= aCount,
+                 "writer should not consume more than we gave it");
+    mOffset = offset + consumed;
+    *aResult = consumed;
+  }
+
+  // errors returned from the writer end here!
+  return NS_OK;
+}
+
 NS_IMETHODIMP
 nsStringInputStream::IsNonBlocking(bool* aNonBlocking) {
   *aNonBlocking = true;
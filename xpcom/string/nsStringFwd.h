@@ -36,6 +36,8 @@ class nsTString;
 template <typename T, size_t N>
 class nsTAutoStringN;
 template <typename T>
+class nsTCompactString;
+template <typename T>
 class nsTDependentString;
 template <typename T>
 class nsTDependentSubstring;
@@ -69,6 +71,7 @@ using nsString = nsTString<char16_t>;
 using nsAutoString = nsTAutoString<char16_t>;
 template <size_t N>
 using nsAutoStringN = nsTAutoStringN<char16_t, N>;
+using nsCompactString = nsTCompactString<char16_t>;
 using nsDependentString = nsTDependentString<char16_t>;
 using nsDependentSubstring = nsTDependentSubstring<char16_t>;
 using nsFmtString = nsTFmtString<char16_t>;
@@ -85,6 +88,7 @@ using nsCString = nsTString<char>;
 using nsAutoCString = nsTAutoString<char>;
 template <size_t N>
 using nsAutoCStringN = nsTAutoStringN<char, N>;
+using nsCompactCString = nsTCompactString<char>;
 using nsDependentCString = nsTDependentString<char>;
 using nsDependentCSubstring = nsTDependentSubstring<char>;
 using nsFmtCString = nsTFmtString<char>;
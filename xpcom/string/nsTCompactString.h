@@ -0,0 +1,248 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef nsTCompactString_h
+#define nsTCompactString_h
+
+#include <cstring>
+
+#include "mozilla/Assertions.h"
+#include "mozilla/MemoryReporting.h"
+#include "mozilla/RefPtr.h"
+#include "mozilla/StringBuffer.h"
+#include "nsDebug.h"
+#include "nsTDependentString.h"
+
+/**
+ * nsTCompactString is an immutable string for members of structs that are
+ * stored in large numbers and usually hold short strings, like header names
+ * or attribute values.  It stores up to kInlineCapacity characters (22 for
+ * char and 10 for char16_t on 64-bit platforms) inline, in three words, and
+ * longer ones in a shared StringBuffer like nsTString does.  Unlike
+ * nsTAutoStringN, it is memmovable, so it can be stored in nsTArrays.
+ *
+ * It is not an nsTSubstring: use AsString() to pass it to functions taking
+ * one, and ToString() to copy it into a string, which shares its buffer if it
+ * has one.
+ */
+template <typename T>
+class nsTCompactString {
+  static constexpr size_t kStorageSize = 3 * sizeof(void*);
+
+ public:
+  typedef T char_type;
+  typedef nsTSubstring<T> substring_type;
+  typedef nsTDependentString<T> dependent_string_type;
+  typedef uint32_t size_type;
+
+  // Keeps one character for the terminator, and the last byte of the storage
+  // for the inline length.
+  static constexpr size_type kInlineCapacity =
+      (kStorageSize - 1) / sizeof(char_type) - 1;
+
+  nsTCompactString() { SetInlineLength(0); }
+
+  explicit nsTCompactString(const substring_type& aString)
+      : nsTCompactString() {
+    Assign(aString);
+  }
+
+  nsTCompactString(const nsTCompactString& aOther) : nsTCompactString() {
+    Assign(aOther);
+  }
+
+  nsTCompactString(nsTCompactString&& aOther) {
+    memcpy(mStorage, aOther.mStorage, kStorageSize);
+    aOther.SetInlineLength(0);
+  }
+
+  ~nsTCompactString() { RefPtr<mozilla::StringBuffer> buffer = TakeBuffer(); }
+
+  nsTCompactString& operator=(const substring_type& aString) {
+    Assign(aString);
+    return *this;
+  }
+
+  nsTCompactString& operator=(const nsTCompactString& aOther) {
+    Assign(aOther);
+    return *this;
+  }
+
+  nsTCompactString& operator=(nsTCompactString&& aOther) {
+    if (this != &aOther) {
+      RefPtr<mozilla::StringBuffer> buffer = TakeBuffer();
+      memcpy(mStorage, aOther.mStorage, kStorageSize);
+      aOther.SetInlineLength(0);
+    }
+    return *this;
+  }
+
+  size_type Length() const {
+    return IsInline() ? InlineLength() : HeapLength();
+  }
+  bool IsEmpty() const { return Length() == 0; }
+
+  // The null-terminated characters.
+  const char_type* get() const {
+    return IsInline() ? InlineData() : HeapData();
+  }
+
+  dependent_string_type AsString() const {
+    return dependent_string_type(get(), Length());
+  }
+
+  void ToString(substring_type& aString) const {
+    if (IsInline()) {
+      aString.Assign(InlineData(), InlineLength());
+    } else {
+      aString.Assign(mozilla::StringBuffer::FromData(HeapData()),
+                     HeapLength());
+    }
+  }
+
+  bool Equals(const substring_type& aString) const {
+    return AsString().Equals(aString);
+  }
+  bool operator==(const substring_type& aString) const {
+    return Equals(aString);
+  }
+  bool operator!=(const substring_type& aString) const {
+    return !Equals(aString);
+  }
+  bool operator==(const nsTCompactString& aOther) const {
+    return Equals(aOther.AsString());
+  }
+  bool operator!=(const nsTCompactString& aOther) const {
+    return !Equals(aOther.AsString());
+  }
+
+  void Assign(const substring_type& aString) {
+    mozilla::StringBuffer* buffer = aString.GetStringBuffer();
+    if (buffer && aString.Length() > kInlineCapacity) {
+      buffer->AddRef();
+      SetBuffer(already_AddRefed<mozilla::StringBuffer>(buffer),
+                aString.Length());
+      return;
+    }
+    Assign(aString.BeginReading(), aString.Length());
+  }
+
+  void Assign(const nsTCompactString& aOther) {
+    if (this == &aOther) {
+      return;
+    }
+    if (aOther.IsInline()) {
+      Assign(aOther.InlineData(), aOther.InlineLength());
+      return;
+    }
+    mozilla::StringBuffer* buffer =
+        mozilla::StringBuffer::FromData(aOther.HeapData());
+    buffer->AddRef();
+    SetBuffer(already_AddRefed<mozilla::StringBuffer>(buffer),
+              aOther.HeapLength());
+  }
+
+  void Assign(const char_type* aData, size_type aLength) {
+    if (aLength > kInlineCapacity) {
+      RefPtr<mozilla::StringBuffer> buffer =
+          mozilla::StringBuffer::Create(aData, aLength);
+      if (!buffer) {
+        NS_ABORT_OOM((aLength + 1) * sizeof(char_type));
+      }
+      SetBuffer(buffer.forget(), aLength);
+      return;
+    }
+
+    // aData may point into our own buffer, keep it alive until we're done.
+    RefPtr<mozilla::StringBuffer> oldBuffer = TakeBuffer();
+    memmove(InlineData(), aData, aLength * sizeof(char_type));
+    SetInlineLength(aLength);
+  }
+
+  void Truncate() {
+    RefPtr<mozilla::StringBuffer> buffer = TakeBuffer();
+    SetInlineLength(0);
+  }
+
+  size_t SizeOfExcludingThisIfUnshared(
+      mozilla::MallocSizeOf aMallocSizeOf) const {
+    if (IsInline()) {
+      return 0;
+    }
+    return mozilla::StringBuffer::FromData(HeapData())
+        ->SizeOfIncludingThisIfUnshared(aMallocSizeOf);
+  }
+
+ private:
+  // The last byte of the storage holds the length of inline strings, or
+  // kHeapTag if the storage starts with the data pointer and the length of
+  // a StringBuffer.
+  static constexpr uint8_t kHeapTag = 0xff;
+  static_assert(kInlineCapacity < kHeapTag);
+
+  uint8_t Tag() const {
+    return reinterpret_cast<const uint8_t*>(mStorage)[kStorageSize - 1];
+  }
+  void SetTag(uint8_t aTag) {
+    reinterpret_cast<uint8_t*>(mStorage)[kStorageSize - 1] = aTag;
+  }
+
+  bool IsInline() const { return Tag() != kHeapTag; }
+
+  size_type InlineLength() const { return Tag(); }
+
+  char_type* InlineData() { return mStorage; }
+  const char_type* InlineData() const { return mStorage; }
+
+  void SetInlineLength(size_type aLength) {
+    MOZ_ASSERT(aLength <= kInlineCapacity);
+    InlineData()[aLength] = char_type(0);
+    SetTag(uint8_t(aLength));
+  }
+
+  char_type* HeapData() const {
+    char_type* data;
+    memcpy(&data, mStorage, sizeof(data));
+    return data;
+  }
+
+  size_type HeapLength() const {
+    size_type length;
+    memcpy(&length,
+           reinterpret_cast<const uint8_t*>(mStorage) + sizeof(char_type*),
+           sizeof(length));
+    return length;
+  }
+
+  // Leaves the string empty if it had a buffer.
+  already_AddRefed<mozilla::StringBuffer> TakeBuffer() {
+    if (IsInline()) {
+      return nullptr;
+    }
+    mozilla::StringBuffer* buffer =
+        mozilla::StringBuffer::FromData(HeapData());
+    SetInlineLength(0);
+    return already_AddRefed<mozilla::StringBuffer>(buffer);
+  }
+
+  void SetBuffer(already_AddRefed<mozilla::StringBuffer> aBuffer,
+                 size_type aLength) {
+    // Releases our old buffer after taking the new one, which may be the
+    // same.
+    RefPtr<mozilla::StringBuffer> oldBuffer = TakeBuffer();
+    char_type* data = static_cast<char_type*>(aBuffer.take()->Data());
+    MOZ_ASSERT(data[aLength] == char_type(0),
+               "data should be null terminated");
+    memcpy(mStorage, &data, sizeof(data));
+    memcpy(reinterpret_cast<uint8_t*>(mStorage) + sizeof(data), &aLength,
+           sizeof(aLength));
+    SetTag(kHeapTag);
+  }
+
+  alignas(void*) char_type mStorage[kStorageSize / sizeof(char_type)];
+};
+
+#endif  // nsTCompactString_h
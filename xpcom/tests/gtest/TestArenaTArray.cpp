@@ -0,0 +1,111 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/ArenaTArray.h"
+#include "nsIMemoryReporter.h"  // MOZ_MALLOC_SIZE_OF
+#include "nsPrintfCString.h"
+#include "nsString.h"
+
+#include "gtest/gtest.h"
+
+using mozilla::ArenaTArray;
+using mozilla::AutoTArrayArena;
+using mozilla::TArrayArena;
+
+MOZ_DEFINE_MALLOC_SIZE_OF(TestSizeOf);
+
+TEST(ArenaTArray, AllocatesFromCurrentArena)
+{
+  TArrayArena arena;
+  EXPECT_FALSE(TArrayArena::GetCurrent());
+  {
+    AutoTArrayArena scope(arena);
+    EXPECT_EQ(TArrayArena::GetCurrent(), &arena);
+
+    ArenaTArray<uint32_t> array;
+    for (uint32_t i = 0; i < 10000; i++) {
+      array.AppendElement(i);
+    }
+    for (uint32_t i = 0; i < 10000; i++) {
+      ASSERT_EQ(array[i], i);
+    }
+    EXPECT_GE(arena.SizeOfExcludingThis(TestSizeOf),
+              10000 * sizeof(uint32_t));
+    // The buffer is measured with the arena, not with the array.
+    EXPECT_EQ(array.ShallowSizeOfExcludingThis(TestSizeOf), 0u);
+
+    array.Compact();
+    EXPECT_EQ(array.Length(), 10000u);
+    EXPECT_EQ(array.LastElement(), 9999u);
+  }
+  EXPECT_FALSE(TArrayArena::GetCurrent());
+  EXPECT_EQ(arena.SizeOfExcludingThis(TestSizeOf), 0u);
+}
+
+TEST(ArenaTArray, NestedScopesUseOutermostArena)
+{
+  TArrayArena outer;
+  TArrayArena inner;
+  AutoTArrayArena outerScope(outer);
+  ArenaTArray<uint32_t> array;
+  {
+    AutoTArrayArena innerScope(inner);
+    EXPECT_EQ(TArrayArena::GetCurrent(), &outer);
+    array.SetLength(1000);
+  }
+  EXPECT_EQ(inner.SizeOfExcludingThis(TestSizeOf), 0u);
+  EXPECT_GE(outer.SizeOfExcludingThis(TestSizeOf), 1000 * sizeof(uint32_t));
+
+  // The buffer outlived the inner scope, so it's still usable.
+  array[999] = 1;
+  array.AppendElement(2u);
+  EXPECT_EQ(array[999], 1u);
+  EXPECT_EQ(array.LastElement(), 2u);
+}
+
+TEST(ArenaTArray, HeapOutsideOfScope)
+{
+  ArenaTArray<nsCString> array;
+  for (uint32_t i = 0; i < 100; i++) {
+    array.AppendElement(nsPrintfCString("%u", i));
+  }
+
+  // A heap buffer stays on the heap when it grows inside a scope.
+  TArrayArena arena;
+  {
+    AutoTArrayArena scope(arena);
+    for (uint32_t i = 100; i < 1000; i++) {
+      array.AppendElement(nsPrintfCString("%u", i));
+    }
+  }
+  EXPECT_EQ(arena.SizeOfExcludingThis(TestSizeOf), 0u);
+  EXPECT_TRUE(array[999].EqualsLiteral("999"));
+}
+
+TEST(ArenaTArray, MoveAndSwap)
+{
+  TArrayArena arena;
+  AutoTArrayArena scope(arena);
+
+  ArenaTArray<uint32_t> a;
+  a.AppendElements(std::initializer_list<uint32_t>{1, 2, 3});
+  ArenaTArray<uint32_t> b(std::move(a));
+  EXPECT_TRUE(a.IsEmpty());
+  EXPECT_EQ(b.Length(), 3u);
+
+  ArenaTArray<uint32_t> c;
+  c.AppendElement(4u);
+  c.SwapElements(b);
+  EXPECT_EQ(b.Length(), 1u);
+  EXPECT_EQ(c.Length(), 3u);
+  EXPECT_EQ(c[2], 3u);
+
+  a = std::move(c);
+  EXPECT_TRUE(c.IsEmpty());
+  const nsTArray<uint32_t>& view = a;
+  EXPECT_EQ(view.Length(), 3u);
+  EXPECT_EQ(view[0], 1u);
+}
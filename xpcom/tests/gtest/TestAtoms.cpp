@@ -13,6 +13,7 @@
 #include "nsThreadUtils.h"
 
 #include "gtest/gtest.h"
+#include "gtest/MozGTestBench.h"  // For MOZ_GTEST_BENCH
 #include "mozilla/gtest/MozAssertions.h"
 
 using namespace mozilla;
@@ -174,4 +175,77 @@ TEST(Atoms, ConcurrentAccessing)
   EXPECT_EQ(NS_GetUnusedAtomCount(), int32_t(1));
 }
 
+static const char16_t* const kLookupAtoms[] = {
+    u"Lookup Atom 0", u"Lookup Atom 1", u"Lookup Atom 2", u"Lookup Atom 3",
+    u"Lookup Atom 4", u"Lookup Atom 5", u"Lookup Atom 6", u"Lookup Atom 7",
+};
+
+static void LookupAtoms(void*) {
+  for (int i = 0; i < 20000; i++) {
+    const char16_t* str = kLookupAtoms[i % std::size(kLookupAtoms)];
+    RefPtr<nsAtom> atom = NS_Atomize(nsDependentString(str));
+    EXPECT_TRUE(atom->Equals(nsDependentString(str)));
+
+    // Atoms nobody else holds, so GC keeps removing them while the lock-free
+    // lookups run.
+    nsAutoString transient;
+    transient.AppendPrintf("Transient Atom %d", i % 100);
+    RefPtr<nsAtom> other = NS_Atomize(transient);
+    EXPECT_TRUE(other->Equals(transient));
+  }
+}
+
+TEST(Atoms, ConcurrentLookupAndGC)
+{
+  static const size_t kThreadCount = 4;
+
+  nsTArray<RefPtr<nsAtom>> held;
+  for (const char16_t* str : kLookupAtoms) {
+    held.AppendElement(NS_Atomize(nsDependentString(str)));
+  }
+
+  PRThread* threads[kThreadCount];
+  for (size_t i = 0; i < kThreadCount; i++) {
+    threads[i] = PR_CreateThread(PR_USER_THREAD, LookupAtoms, nullptr,
+                                 PR_PRIORITY_NORMAL, PR_GLOBAL_THREAD,
+                                 PR_JOINABLE_THREAD, 0);
+    EXPECT_TRUE(threads[i]);
+  }
+
+  for (int i = 0; i < 200; i++) {
+    NS_GetNumberOfAtoms();
+  }
+
+  for (size_t i = 0; i < kThreadCount; i++) {
+    EXPECT_EQ(PR_SUCCESS, PR_JoinThread(threads[i]));
+  }
+
+  // The atoms the threads looked up are still the ones we hold.
+  for (size_t i = 0; i < std::size(kLookupAtoms); i++) {
+    RefPtr<nsAtom> atom = NS_Atomize(nsDependentString(kLookupAtoms[i]));
+    EXPECT_EQ(atom, held[i]);
+  }
+}
+
+static void AtomizeExistingAtom(void*) {
+  for (int i = 0; i < 100000; i++) {
+    RefPtr<nsAtom> atom = NS_Atomize(u"An Existing Atom"_ns);
+  }
+}
+
+MOZ_GTEST_BENCH(Atoms, PerfConcurrentAtomizeExisting, [] {
+  static const size_t kThreadCount = 8;
+
+  RefPtr<nsAtom> held = NS_Atomize(u"An Existing Atom"_ns);
+  PRThread* threads[kThreadCount];
+  for (size_t i = 0; i < kThreadCount; i++) {
+    threads[i] = PR_CreateThread(PR_USER_THREAD, AtomizeExistingAtom, nullptr,
+                                 PR_PRIORITY_NORMAL, PR_GLOBAL_THREAD,
+                                 PR_JOINABLE_THREAD, 0);
+  }
+  for (size_t i = 0; i < kThreadCount; i++) {
+    PR_JoinThread(threads[i]);
+  }
+});
+
 }  // namespace TestAtoms
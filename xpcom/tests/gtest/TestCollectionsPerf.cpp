@@ -0,0 +1,236 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// Microbenchmarks of the XPCOM and MFBT containers and of the allocation
+// patterns they produce, so that changes to them can be compared.  Like the
+// other MOZ_GTEST_BENCH tests, they report PERFHERDER_DATA lines in
+// optimized builds, and only check that they run in debug builds.  Hash
+// sets are measured by xpcom/rust/gtest/bench-collections, strings by
+// TestStrings.cpp and atoms by TestAtoms.cpp.
+//
+// To run them locally:
+//
+//   ./mach gtest 'CollectionsPerf.*'
+
+#include "gtest/gtest.h"
+#include "gtest/MozGTestBench.h"  // For MOZ_GTEST_BENCH
+#include "mozilla/BufferList.h"
+#include "mozilla/HashTable.h"
+#include "mozilla/SegmentedVector.h"
+#include "mozilla/mozalloc.h"
+#include "nsPrintfCString.h"
+#include "nsString.h"
+#include "nsTArray.h"
+#include "nsTHashMap.h"
+
+using namespace mozilla;
+
+namespace TestCollectionsPerf {
+
+static constexpr uint32_t kNumElements = 100000;
+static constexpr uint32_t kNumLookups = 1000000;
+
+// A deterministic sequence of keys, without duplicates in the first
+// kNumElements results.
+static uint32_t Key(uint32_t aIndex) { return aIndex * 2654435761u; }
+
+static void BenchTArrayAppend() {
+  nsTArray<uint32_t> array;
+  for (uint32_t i = 0; i < kNumElements; i++) {
+    array.AppendElement(Key(i));
+  }
+  MOZ_RELEASE_ASSERT(array.Length() == kNumElements);
+}
+
+static void BenchTArrayAppendWithCapacity() {
+  nsTArray<uint32_t> array(kNumElements);
+  for (uint32_t i = 0; i < kNumElements; i++) {
+    array.AppendElement(Key(i));
+  }
+  MOZ_RELEASE_ASSERT(array.Length() == kNumElements);
+}
+
+static void BenchTArrayInsertSorted() {
+  nsTArray<uint32_t> array;
+  for (uint32_t i = 0; i < kNumElements / 10; i++) {
+    array.InsertElementSorted(Key(i));
+  }
+  MOZ_RELEASE_ASSERT(array.Length() == kNumElements / 10);
+}
+
+static void BenchTArraySort() {
+  nsTArray<uint32_t> array(kNumElements);
+  for (uint32_t i = 0; i < kNumElements; i++) {
+    array.AppendElement(Key(i));
+  }
+  array.Sort();
+  MOZ_RELEASE_ASSERT(array[0] <= array[kNumElements - 1]);
+}
+
+static void BenchTArrayStrings() {
+  nsTArray<nsCString> array;
+  for (uint32_t i = 0; i < kNumElements; i++) {
+    array.AppendElement(nsPrintfCString("element-%u", i));
+  }
+  // Removing from the front moves every other element.
+  for (uint32_t i = 0; i < 100; i++) {
+    array.RemoveElementAt(0);
+  }
+  MOZ_RELEASE_ASSERT(array.Length() == kNumElements - 100);
+}
+
+template <typename Map>
+static void FillMap(Map& aMap) {
+  for (uint32_t i = 0; i < kNumElements; i++) {
+    aMap.InsertOrUpdate(Key(i), i);
+  }
+}
+
+static void BenchTHashMapIntegers() {
+  nsTHashMap<uint32_t, uint32_t> map;
+  FillMap(map);
+
+  uint32_t found = 0;
+  for (uint32_t i = 0; i < kNumLookups; i++) {
+    // Half of the lookups fail.
+    found += map.Contains(Key(i % (2 * kNumElements)));
+  }
+  MOZ_RELEASE_ASSERT(found == kNumLookups / 2);
+
+  for (uint32_t i = 0; i < kNumElements; i++) {
+    map.Remove(Key(i));
+  }
+  MOZ_RELEASE_ASSERT(map.IsEmpty());
+}
+
+static void BenchTHashMapStrings() {
+  nsTArray<nsCString> keys(kNumElements);
+  for (uint32_t i = 0; i < kNumElements; i++) {
+    keys.AppendElement(nsPrintfCString("key-%u", Key(i)));
+  }
+
+  nsTHashMap<nsCStringHashKey, uint32_t> map;
+  for (uint32_t i = 0; i < kNumElements; i++) {
+    map.InsertOrUpdate(keys[i], i);
+  }
+
+  uint32_t found = 0;
+  for (uint32_t i = 0; i < kNumLookups; i++) {
+    found += map.Contains(keys[(i * 13) % kNumElements]);
+  }
+  MOZ_RELEASE_ASSERT(found == kNumLookups);
+}
+
+static void BenchMozHashMapIntegers() {
+  HashMap<uint32_t, uint32_t> map;
+  for (uint32_t i = 0; i < kNumElements; i++) {
+    MOZ_RELEASE_ASSERT(map.put(Key(i), i));
+  }
+
+  uint32_t found = 0;
+  for (uint32_t i = 0; i < kNumLookups; i++) {
+    found += map.has(Key(i % (2 * kNumElements)));
+  }
+  MOZ_RELEASE_ASSERT(found == kNumLookups / 2);
+
+  for (uint32_t i = 0; i < kNumElements; i++) {
+    map.remove(Key(i));
+  }
+  MOZ_RELEASE_ASSERT(map.empty());
+}
+
+static void BenchSegmentedVector() {
+  SegmentedVector<uint64_t> vector;
+  for (uint32_t i = 0; i < 10 * kNumElements; i++) {
+    vector.InfallibleAppend(uint64_t(Key(i)));
+  }
+
+  uint64_t sum = 0;
+  for (auto iter = vector.Iter(); !iter.Done(); iter.Next()) {
+    sum += iter.Get();
+  }
+  MOZ_RELEASE_ASSERT(sum);
+
+  vector.PopLastN(vector.Length() / 2);
+  MOZ_RELEASE_ASSERT(vector.Length() == 5 * kNumElements);
+}
+
+static void BenchBufferList() {
+  // Writes and reads the kind of small chunks IPC messages are made of.
+  char chunk[100];
+  memset(chunk, 'x', sizeof(chunk));
+
+  BufferList<InfallibleAllocPolicy> buffers(0, 0, 4096);
+  for (uint32_t i = 0; i < kNumElements; i++) {
+    MOZ_RELEASE_ASSERT(buffers.WriteBytes(chunk, 1 + i % sizeof(chunk)));
+  }
+
+  auto iter = buffers.Iter();
+  size_t read = 0;
+  for (uint32_t i = 0; i < kNumElements; i++) {
+    size_t size = 1 + i % sizeof(chunk);
+    MOZ_RELEASE_ASSERT(buffers.ReadBytes(iter, chunk, size));
+    read += size;
+  }
+  MOZ_RELEASE_ASSERT(read == buffers.Size());
+}
+
+// Allocates and frees blocks of the given sizes, either as soon as they are
+// allocated, in the order they were allocated or in the reverse order.
+enum class FreeOrder { Immediate, Fifo, Lifo };
+
+static void BenchMalloc(size_t aMinSize, size_t aMaxSize, FreeOrder aOrder) {
+  static constexpr uint32_t kBatchSize = 1000;
+  void* blocks[kBatchSize];
+
+  for (uint32_t batch = 0; batch < kNumElements / kBatchSize; batch++) {
+    for (uint32_t i = 0; i < kBatchSize; i++) {
+      size_t size = aMinSize + Key(i) % (aMaxSize - aMinSize + 1);
+      blocks[i] = moz_xmalloc(size);
+      // Touch the block, so that the allocation can't be elided.
+      *static_cast<volatile char*>(blocks[i]) = char(i);
+      if (aOrder == FreeOrder::Immediate) {
+        free(blocks[i]);
+      }
+    }
+    if (aOrder == FreeOrder::Fifo) {
+      for (uint32_t i = 0; i < kBatchSize; i++) {
+        free(blocks[i]);
+      }
+    } else if (aOrder == FreeOrder::Lifo) {
+      for (uint32_t i = kBatchSize; i > 0; i--) {
+        free(blocks[i - 1]);
+      }
+    }
+  }
+}
+
+MOZ_GTEST_BENCH(CollectionsPerf, TArrayAppend, BenchTArrayAppend);
+MOZ_GTEST_BENCH(CollectionsPerf, TArrayAppendWithCapacity,
+                BenchTArrayAppendWithCapacity);
+MOZ_GTEST_BENCH(CollectionsPerf, TArrayInsertSorted, BenchTArrayInsertSorted);
+MOZ_GTEST_BENCH(CollectionsPerf, TArraySort, BenchTArraySort);
+MOZ_GTEST_BENCH(CollectionsPerf, TArrayStrings, BenchTArrayStrings);
+
+MOZ_GTEST_BENCH(CollectionsPerf, THashMapIntegers, BenchTHashMapIntegers);
+MOZ_GTEST_BENCH(CollectionsPerf, THashMapStrings, BenchTHashMapStrings);
+MOZ_GTEST_BENCH(CollectionsPerf, MozHashMapIntegers, BenchMozHashMapIntegers);
+
+MOZ_GTEST_BENCH(CollectionsPerf, SegmentedVector, BenchSegmentedVector);
+MOZ_GTEST_BENCH(CollectionsPerf, BufferList, BenchBufferList);
+
+MOZ_GTEST_BENCH(CollectionsPerf, MallocSmallImmediate,
+                [] { BenchMalloc(8, 64, FreeOrder::Immediate); });
+MOZ_GTEST_BENCH(CollectionsPerf, MallocSmallFifo,
+                [] { BenchMalloc(8, 64, FreeOrder::Fifo); });
+MOZ_GTEST_BENCH(CollectionsPerf, MallocSmallLifo,
+                [] { BenchMalloc(8, 64, FreeOrder::Lifo); });
+MOZ_GTEST_BENCH(CollectionsPerf, MallocMixedFifo,
+                [] { BenchMalloc(8, 4096, FreeOrder::Fifo); });
+MOZ_GTEST_BENCH(CollectionsPerf, MallocLargeLifo,
+                [] { BenchMalloc(4096, 65536, FreeOrder::Lifo); });
+
+}  // namespace TestCollectionsPerf
@@ -0,0 +1,95 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <atomic>
+
+#include "gtest/gtest.h"
+#include "mozilla/Atomics.h"
+#include "mozilla/DispatchChannel.h"
+#include "mozilla/gtest/MozAssertions.h"
+#include "mozilla/SpinEventLoopUntil.h"
+#include "nsIThread.h"
+#include "nsThreadUtils.h"
+
+using mozilla::DispatchChannel;
+
+namespace TestDispatchChannel {
+
+static void SendFromThread(DispatchChannel<uint32_t>* aChannel,
+                           uint32_t aCount) {
+  nsCOMPtr<nsIThread> producer;
+  ASSERT_NS_SUCCEEDED(NS_NewNamedThread("DispatchProducer",
+                                        getter_AddRefs(producer)));
+  RefPtr<DispatchChannel<uint32_t>> channel = aChannel;
+  producer->Dispatch(NS_NewRunnableFunction("SendAll", [channel, aCount] {
+    for (uint32_t i = 0; i < aCount; i++) {
+      uint32_t item = i;
+      MOZ_RELEASE_ASSERT(channel->Send(std::move(item)));
+    }
+  }));
+  producer->Shutdown();
+}
+
+static void CheckDelivery(int aCapacity, uint32_t aCount) {
+  uint32_t received = 0;
+  bool ordered = true;
+  RefPtr<DispatchChannel<uint32_t>> channel = new DispatchChannel<uint32_t>(
+      "TestDispatchChannel", GetMainThreadSerialEventTarget(), aCapacity,
+      [&](uint32_t&& aItem) {
+        ordered = ordered && aItem == received;
+        received++;
+      });
+
+  SendFromThread(channel, aCount);
+  mozilla::SpinEventLoopUntil("TestDispatchChannel"_ns,
+                              [&] { return received == aCount; });
+  EXPECT_EQ(received, aCount);
+  EXPECT_TRUE(ordered);
+}
+
+TEST(DispatchChannel, DeliversInOrder)
+{
+  CheckDelivery(1024, 100000);
+}
+
+// The producer outruns the main thread, so many of the items go through the
+// overflow queue.
+TEST(DispatchChannel, DeliversInOrderWhenFull)
+{
+  CheckDelivery(4, 10000);
+}
+
+TEST(DispatchChannel, HandlesItemsSentWhileBusy)
+{
+  nsCOMPtr<nsIThread> consumer;
+  ASSERT_NS_SUCCEEDED(
+      NS_NewNamedThread("DispatchConsumer", getter_AddRefs(consumer)));
+
+  std::atomic<uint32_t> received{0};
+  RefPtr<DispatchChannel<uint32_t>> channel = new DispatchChannel<uint32_t>(
+      "TestDispatchChannel", consumer, 64,
+      [&](uint32_t&& aItem) { received++; });
+
+  // Only the first item sent while the consumer is busy dispatches a drain.
+  mozilla::Atomic<bool> blocked{true};
+  consumer->Dispatch(NS_NewRunnableFunction("Block", [&] {
+    while (blocked) {
+    }
+  }));
+  for (uint32_t i = 0; i < 32; i++) {
+    uint32_t item = i;
+    EXPECT_TRUE(channel->Send(std::move(item)));
+  }
+  blocked = false;
+  // The drain runnable was dispatched before this one.
+  consumer->Dispatch(NS_NewRunnableFunction("Check", [] {}),
+                     NS_DISPATCH_SYNC);
+  EXPECT_EQ(received, 32u);
+
+  consumer->Shutdown();
+}
+
+}  // namespace TestDispatchChannel
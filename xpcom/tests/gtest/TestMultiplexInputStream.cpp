@@ -11,6 +11,7 @@
 #include "nsIAsyncInputStream.h"
 #include "nsComponentManagerUtils.h"
 #include "nsIAsyncOutputStream.h"
+#include "nsIGatherInputStream.h"
 #include "nsIInputStream.h"
 #include "nsIMultiplexInputStream.h"
 #include "nsIPipe.h"
@@ -684,6 +685,87 @@ TEST(MultiplexInputStream, Bufferable)
   ASSERT_TRUE(!strncmp(buf3, "Hello world", size));
 }
 
+struct GatherResult {
+  nsCString mData;
+  uint32_t mSegments = 0;
+  uint32_t mConsume = UINT32_MAX;
+};
+
+static nsresult GatherSegments(
+    nsIInputStream* aInStream, void* aClosure,
+    mozilla::Span<const mozilla::Span<const char>> aSegments,
+    uint32_t* aConsumed) {
+  GatherResult* result = static_cast<GatherResult*>(aClosure);
+  uint32_t consumed = 0;
+  for (const auto& segment : aSegments) {
+    uint32_t length =
+        std::min<uint32_t>(segment.Length(), result->mConsume - consumed);
+    result->mData.Append(segment.Elements(), length);
+    consumed += length;
+  }
+  result->mSegments += aSegments.Length();
+  *aConsumed = consumed;
+  return NS_OK;
+}
+
+TEST(MultiplexInputStream, ReadGathered)
+{
+  nsCOMPtr<nsIMultiplexInputStream> multiplexStream =
+      do_CreateInstance("@mozilla.org/io/multiplex-input-stream;1");
+
+  nsCOMPtr<nsIInputStream> headers;
+  ASSERT_NS_SUCCEEDED(
+      NS_NewCStringInputStream(getter_AddRefs(headers), "Hello "_ns));
+
+  // 4 bytes segments.
+  nsCOMPtr<nsIAsyncInputStream> pipeIn;
+  nsCOMPtr<nsIAsyncOutputStream> pipeOut;
+  NS_NewPipe2(getter_AddRefs(pipeIn), getter_AddRefs(pipeOut), true, true, 4,
+              8);
+  const char body[] = "world, how are you?";
+  uint32_t written;
+  ASSERT_NS_SUCCEEDED(pipeOut->Write(body, strlen(body), &written));
+  ASSERT_EQ(written, strlen(body));
+  ASSERT_NS_SUCCEEDED(pipeOut->Close());
+
+  ASSERT_NS_SUCCEEDED(multiplexStream->AppendStream(headers));
+  ASSERT_NS_SUCCEEDED(multiplexStream->AppendStream(pipeIn));
+
+  nsCOMPtr<nsIGatherInputStream> gather = do_QueryInterface(multiplexStream);
+  ASSERT_TRUE(!!gather);
+
+  // The string and all the segments of the pipe are passed at once.
+  GatherResult result;
+  result.mConsume = 12;
+  uint32_t read;
+  ASSERT_NS_SUCCEEDED(
+      gather->ReadGathered(GatherSegments, &result, 1024, &read));
+  EXPECT_EQ(read, 12u);
+  EXPECT_EQ(result.mSegments, 6u);
+  EXPECT_TRUE(result.mData.EqualsLiteral("Hello world,"));
+
+  // The rest starts in the middle of a pipe segment.
+  result = GatherResult();
+  ASSERT_NS_SUCCEEDED(
+      gather->ReadGathered(GatherSegments, &result, 1024, &read));
+  EXPECT_EQ(read, 13u);
+  EXPECT_EQ(result.mSegments, 4u);
+  EXPECT_TRUE(result.mData.EqualsLiteral(" how are you?"));
+
+  result = GatherResult();
+  ASSERT_NS_SUCCEEDED(
+      gather->ReadGathered(GatherSegments, &result, 1024, &read));
+  EXPECT_EQ(read, 0u);
+  EXPECT_EQ(result.mSegments, 0u);
+
+  // Streams that have to be buffered can't be gathered from.
+  nsCOMPtr<nsIInputStream> nonBufferable =
+      new NonBufferableStringStream("Hello"_ns);
+  ASSERT_NS_SUCCEEDED(multiplexStream->AppendStream(nonBufferable));
+  gather = do_QueryInterface(multiplexStream);
+  ASSERT_FALSE(!!gather);
+}
+
 TEST(MultiplexInputStream, QILengthInputStream)
 {
   nsCString buf;
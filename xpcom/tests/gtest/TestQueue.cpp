@@ -183,4 +183,29 @@ TEST(Queue, PushPopSequence)
   }
 }
 
+TEST(Queue, ElementAt)
+{
+  // Covers a wrapped around head page, and a head page followed by others.
+  for (uint32_t pop = 0; pop < 8; ++pop) {
+    for (uint32_t push = 0; push < 32; ++push) {
+      Queue<uint32_t, 8> queue;
+      uint32_t serial = 0;
+      for (uint32_t i = 0; i < 7; ++i) {
+        queue.Push(serial++);
+      }
+      for (uint32_t i = 0; i < pop && !queue.IsEmpty(); ++i) {
+        queue.Pop();
+      }
+      for (uint32_t i = 0; i < push; ++i) {
+        queue.Push(serial++);
+      }
+
+      uint32_t first = serial - queue.Count();
+      for (uint32_t i = 0; i < queue.Count(); ++i) {
+        EXPECT_EQ(queue.ElementAt(i), first + i);
+      }
+    }
+  }
+}
+
 }  // namespace TestQueue
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 #include "nsASCIIMask.h"
 #include "nsCharSeparatedTokenizer.h"
+#include "nsCompactString.h"
 #include "nsPrintfCString.h"
 #include "nsString.h"
 #include "mozilla/StringBuffer.h"
@@ -1190,6 +1191,53 @@ TEST_F(Strings, stringbuffer) {
   EXPECT_EQ(buf, buf2);
 }
 
+TEST_F(Strings, compact_string) {
+  nsCompactCString str;
+  EXPECT_TRUE(str.IsEmpty());
+  EXPECT_STREQ(str.get(), "");
+
+  str = "content-type"_ns;
+  EXPECT_EQ(str.Length(), 12u);
+  EXPECT_STREQ(str.get(), "content-type");
+  EXPECT_TRUE(str == "content-type"_ns);
+  EXPECT_EQ(str.SizeOfExcludingThisIfUnshared(moz_malloc_size_of), 0u);
+
+  // Strings that don't fit inline share the buffer of the string they are
+  // assigned from, and with strings they are copied to.
+  nsCString longStr;
+  longStr.AssignLiteral("strict-transport-security-and-more");
+  longStr.SetCapacity(64);
+  ASSERT_TRUE(longStr.GetStringBuffer());
+  str = longStr;
+  EXPECT_TRUE(str.Equals(longStr));
+  nsCString copy;
+  str.ToString(copy);
+  EXPECT_EQ(copy.GetStringBuffer(), longStr.GetStringBuffer());
+
+  nsCompactCString copied(str);
+  nsCompactCString moved(std::move(str));
+  EXPECT_TRUE(str.IsEmpty());
+  EXPECT_TRUE(moved == copied);
+  EXPECT_TRUE(moved.AsString().Equals(longStr));
+
+  // Assigning from our own characters keeps them alive.
+  moved = Substring(moved.AsString(), 0, 6);
+  EXPECT_STREQ(moved.get(), "strict");
+  moved.Truncate();
+  EXPECT_TRUE(moved.IsEmpty());
+
+  nsCompactString wide(u"0123456789"_ns);
+  EXPECT_EQ(wide.Length(), 10u);
+  wide = u"0123456789abcdef"_ns;
+  EXPECT_TRUE(wide.AsString().EqualsLiteral("0123456789abcdef"));
+
+  nsTArray<nsCompactCString> array;
+  for (uint32_t i = 0; i < 100; i++) {
+    array.AppendElement(nsCompactCString(nsPrintfCString("header-%u", i)));
+  }
+  EXPECT_STREQ(array[99].get(), "header-99");
+}
+
 TEST_F(Strings, voided) {
   const char kData[] = "hello world";
 
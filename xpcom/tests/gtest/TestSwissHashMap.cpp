@@ -0,0 +1,189 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "nsTSwissHashMap.h"
+
+#include "gtest/gtest.h"
+#include "gtest/MozGTestBench.h"  // For MOZ_GTEST_BENCH
+#include "mozilla/UniquePtr.h"
+#include "nsAtom.h"
+#include "nsPrintfCString.h"
+#include "nsString.h"
+#include "nsTArray.h"
+#include "nsTHashMap.h"
+
+using namespace mozilla;
+
+namespace TestSwissHashMap {
+
+TEST(SwissHashMap, Basic)
+{
+  nsTSwissHashMap<uint32_t, uint32_t> map;
+  EXPECT_TRUE(map.IsEmpty());
+  EXPECT_FALSE(map.Get(1));
+  EXPECT_FALSE(map.Remove(1));
+
+  map.InsertOrUpdate(1, 10u);
+  EXPECT_EQ(map.Count(), 1u);
+  EXPECT_EQ(*map.Get(1), 10u);
+
+  map.InsertOrUpdate(1, 11u);
+  EXPECT_EQ(map.Count(), 1u);
+  EXPECT_EQ(*map.Get(1), 11u);
+
+  EXPECT_EQ(map.LookupOrInsert(1, 12u), 11u);
+  EXPECT_EQ(map.LookupOrInsert(2, 20u), 20u);
+  EXPECT_EQ(map.Count(), 2u);
+
+  EXPECT_TRUE(map.Remove(1));
+  EXPECT_FALSE(map.Contains(1));
+  EXPECT_TRUE(map.Contains(2));
+  EXPECT_EQ(map.Count(), 1u);
+
+  map.Clear();
+  EXPECT_TRUE(map.IsEmpty());
+  EXPECT_FALSE(map.Contains(2));
+}
+
+TEST(SwissHashMap, GrowAndRemove)
+{
+  static const uint32_t kCount = 10000;
+
+  nsTSwissHashMap<uint32_t, uint32_t> map;
+  for (uint32_t i = 0; i < kCount; i++) {
+    map.InsertOrUpdate(i, i * 2);
+  }
+  EXPECT_EQ(map.Count(), kCount);
+
+  for (uint32_t i = 0; i < kCount; i += 2) {
+    EXPECT_TRUE(map.Remove(i));
+  }
+  EXPECT_EQ(map.Count(), kCount / 2);
+
+  for (uint32_t i = 0; i < kCount; i++) {
+    uint32_t* data = map.Get(i);
+    if (i % 2) {
+      ASSERT_TRUE(data);
+      EXPECT_EQ(*data, i * 2);
+    } else {
+      EXPECT_FALSE(data);
+    }
+  }
+
+  uint32_t iterated = 0;
+  for (const auto& entry : map) {
+    EXPECT_EQ(entry.GetKey() % 2, 1u);
+    EXPECT_EQ(entry.GetData(), entry.GetKey() * 2);
+    iterated++;
+  }
+  EXPECT_EQ(iterated, kCount / 2);
+}
+
+TEST(SwissHashMap, Churn)
+{
+  // Keeps the table at the same size while filling it with deleted slots,
+  // which must not make lookups miss or loop.
+  nsTSwissHashMap<uint32_t, uint32_t> map;
+  for (uint32_t i = 0; i < 100000; i++) {
+    map.InsertOrUpdate(i, i);
+    if (i >= 50) {
+      EXPECT_TRUE(map.Remove(i - 50));
+    }
+  }
+  EXPECT_EQ(map.Count(), 50u);
+  for (uint32_t i = 100000 - 50; i < 100000; i++) {
+    EXPECT_TRUE(map.Contains(i));
+  }
+}
+
+TEST(SwissHashMap, StringKeysAndMovableData)
+{
+  nsTSwissHashMap<nsCString, UniquePtr<uint32_t>> map;
+  for (uint32_t i = 0; i < 1000; i++) {
+    map.InsertOrUpdate(nsPrintfCString("key%u", i), MakeUnique<uint32_t>(i));
+  }
+  for (uint32_t i = 0; i < 1000; i++) {
+    UniquePtr<uint32_t>* data = map.Get(nsPrintfCString("key%u", i));
+    ASSERT_TRUE(data);
+    EXPECT_EQ(**data, i);
+  }
+  EXPECT_FALSE(map.Contains("key1000"_ns));
+
+  nsTSwissHashMap<nsCString, UniquePtr<uint32_t>> moved(std::move(map));
+  EXPECT_TRUE(map.IsEmpty());
+  EXPECT_EQ(moved.Count(), 1000u);
+  EXPECT_TRUE(moved.Contains("key999"_ns));
+}
+
+// The benchmarks below compare lookups in nsTHashMap and nsTSwissHashMap for
+// the kinds of keys of the lookup-heavy tables in DOM and layout: atoms,
+// like the id and name maps of documents (IdentifierMapEntry), and pointers,
+// like the style sharing caches.
+
+static const uint32_t kBenchTableSize = 2000;
+static const uint32_t kBenchLookups = 1000000;
+
+static nsTArray<RefPtr<nsAtom>> MakeAtoms() {
+  nsTArray<RefPtr<nsAtom>> atoms;
+  for (uint32_t i = 0; i < kBenchTableSize; i++) {
+    atoms.AppendElement(NS_Atomize(nsPrintfCString("bench-element-id-%u", i)));
+  }
+  return atoms;
+}
+
+template <typename Map>
+static void BenchAtomLookups() {
+  nsTArray<RefPtr<nsAtom>> atoms = MakeAtoms();
+  Map map;
+  // Half of the lookups miss, like getElementById() for ids not in the
+  // document yet.
+  for (uint32_t i = 0; i < kBenchTableSize; i += 2) {
+    map.InsertOrUpdate(atoms[i], i);
+  }
+
+  uint32_t found = 0;
+  for (uint32_t i = 0; i < kBenchLookups; i++) {
+    if (map.Contains(atoms[(i * 7) % kBenchTableSize])) {
+      found++;
+    }
+  }
+  EXPECT_EQ(found, kBenchLookups / 2);
+}
+
+template <typename Map>
+static void BenchPointerLookups() {
+  nsTArray<UniquePtr<uint64_t>> objects;
+  for (uint32_t i = 0; i < kBenchTableSize; i++) {
+    objects.AppendElement(MakeUnique<uint64_t>(i));
+  }
+  Map map;
+  for (uint32_t i = 0; i < kBenchTableSize; i++) {
+    map.InsertOrUpdate(objects[i].get(), i);
+  }
+
+  uint64_t sum = 0;
+  for (uint32_t i = 0; i < kBenchLookups; i++) {
+    sum += map.Contains(objects[(i * 13) % kBenchTableSize].get());
+  }
+  EXPECT_EQ(sum, uint64_t(kBenchLookups));
+}
+
+MOZ_GTEST_BENCH(SwissHashMap, PerfAtomLookupsPLDHash,
+                [] { BenchAtomLookups<nsTHashMap<nsAtom*, uint32_t>>(); });
+
+MOZ_GTEST_BENCH(SwissHashMap, PerfAtomLookupsSwiss, [] {
+  BenchAtomLookups<nsTSwissHashMap<nsAtom*, uint32_t>>();
+});
+
+MOZ_GTEST_BENCH(SwissHashMap, PerfPointerLookupsPLDHash, [] {
+  BenchPointerLookups<nsTHashMap<uint64_t*, uint32_t>>();
+});
+
+MOZ_GTEST_BENCH(SwissHashMap, PerfPointerLookupsSwiss, [] {
+  BenchPointerLookups<nsTSwissHashMap<uint64_t*, uint32_t>>();
+});
+
+}  // namespace TestSwissHashMap
@@ -9,6 +9,7 @@
 #include <stdint.h>  // uint32_t
 
 #include "nsString.h"                // nsACString
+#include "nsTArray.h"                // nsTArray
 #include "nsThreadUtils.h"           // NS_ProcessNextEvent
 #include "mozilla/Atomics.h"         // Atomic
 #include "mozilla/EventQueue.h"      // EventQueuePriority
@@ -211,4 +212,106 @@ TEST(TaskController, RescheduleOrderOffMainThread)
   ASSERT_TRUE(logger3.GetLog() == "333");
 }
 
+class SpawningTask : public Task {
+ public:
+  SpawningTask(Atomic<uint32_t>* aRunCount, uint32_t aChildCount)
+      : Task(Kind::OffMainThreadOnly, EventQueuePriority::Normal),
+        mRunCount(aRunCount),
+        mChildCount(aChildCount) {}
+
+  TaskResult Run() override {
+    // Tasks added from a pool thread go to the queue of that thread, the
+    // other pool threads have to steal them.
+    for (uint32_t i = 0; i < mChildCount; i++) {
+      TaskController::Get()->AddTask(
+          MakeAndAddRef<SpawningTask>(mRunCount, 0));
+    }
+    (*mRunCount)++;
+    mIsDone = true;
+    return TaskResult::Complete;
+  }
+
+#ifdef MOZ_COLLECTING_RUNNABLE_TELEMETRY
+  bool GetName(nsACString& aName) override {
+    aName.AssignLiteral("SpawningTask");
+    return true;
+  }
+#endif
+
+  bool IsDone() const { return mIsDone; }
+
+ private:
+  Atomic<uint32_t>* mRunCount;
+  uint32_t mChildCount;
+  Atomic<bool> mIsDone{false};
+};
+
+class CheckDependenciesTask : public Task {
+ public:
+  explicit CheckDependenciesTask(nsTArray<RefPtr<SpawningTask>>&& aTasks)
+      : Task(Kind::MainThreadOnly, EventQueuePriority::Normal),
+        mTasks(std::move(aTasks)) {}
+
+  TaskResult Run() override {
+    for (const auto& task : mTasks) {
+      EXPECT_TRUE(task->IsDone());
+    }
+    mIsDone = true;
+    return TaskResult::Complete;
+  }
+
+#ifdef MOZ_COLLECTING_RUNNABLE_TELEMETRY
+  bool GetName(nsACString& aName) override {
+    aName.AssignLiteral("CheckDependenciesTask");
+    return true;
+  }
+#endif
+
+  bool IsDone() const { return mIsDone; }
+
+ private:
+  nsTArray<RefPtr<SpawningTask>> mTasks;
+  bool mIsDone = false;
+};
+
+TEST(TaskController, StealTasksAddedOffMainThread)
+{
+  static const uint32_t kTaskCount = 16;
+  static const uint32_t kChildCount = 100;
+
+  Atomic<uint32_t> runCount(0);
+  nsTArray<RefPtr<SpawningTask>> tasks;
+  for (uint32_t i = 0; i < kTaskCount; i++) {
+    tasks.AppendElement(new SpawningTask(&runCount, kChildCount));
+  }
+
+  // These tasks have no dependencies so they bypass the task graph, the
+  // graph still has to run the main thread task once they are all done.
+  RefPtr<CheckDependenciesTask> mainThreadTask =
+      new CheckDependenciesTask(tasks.Clone());
+  for (const auto& task : tasks) {
+    mainThreadTask->AddDependency(task);
+  }
+  for (const auto& task : tasks) {
+    TaskController::Get()->AddTask(do_AddRef(task));
+  }
+  TaskController::Get()->AddTask(do_AddRef(mainThreadTask));
+
+  uint32_t count = 0;
+  while (!mainThreadTask->IsDone() && count < 100) {
+    while (NS_ProcessNextEvent(nullptr, false)) {
+    }
+    PR_Sleep(PR_MillisecondsToInterval(100));
+    count++;
+  }
+  ASSERT_TRUE(mainThreadTask->IsDone());
+
+  count = 0;
+  while (runCount != kTaskCount * (kChildCount + 1) && count < 100) {
+    PR_Sleep(PR_MillisecondsToInterval(100));
+    count++;
+  }
+  ASSERT_EQ(runCount, kTaskCount * (kChildCount + 1));
+}
+
 }  // namespace TestTaskController
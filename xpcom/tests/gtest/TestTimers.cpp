@@ -926,3 +926,42 @@ TEST(Timers, HighResFuncCallback)
       "TestTimers::HighResFuncCallback"_ns,
       [&] { return !first.IsNull() && !second.IsNull() && !third.IsNull(); });
 }
+
+TEST(Timers, FiringOrderAcrossWheelLevels)
+{
+  // Delays that put the timers in the first two levels of the timer wheel,
+  // added out of order, some canceled.
+  static const uint32_t kTimerCount = 100;
+  nsTArray<nsCOMPtr<nsITimer>> timers;
+  nsTArray<TimeStamp> timeouts;
+  nsTArray<uint32_t> fired;
+  for (uint32_t i = 0; i < kTimerCount; i++) {
+    const uint32_t delay = (i * 37) % kTimerCount * 3;
+    nsCOMPtr<nsITimer> timer;
+    MOZ_ALWAYS_SUCCEEDS(NS_NewTimerWithCallback(
+        getter_AddRefs(timer), [&, i](nsITimer*) { fired.AppendElement(i); },
+        delay, nsITimer::TYPE_ONE_SHOT,
+        "TestTimers::FiringOrderAcrossWheelLevels"));
+    timers.AppendElement(std::move(timer));
+    // A little after the actual timeout.
+    timeouts.AppendElement(TimeStamp::Now() +
+                           TimeDuration::FromMilliseconds(delay));
+  }
+  uint32_t canceled = 0;
+  for (uint32_t i = 0; i < kTimerCount; i += 7) {
+    timers[i]->Cancel();
+    canceled++;
+  }
+
+  SpinEventLoopUntil<ProcessFailureBehavior::IgnoreAndContinue>(
+      "TestTimers::FiringOrderAcrossWheelLevels"_ns,
+      [&] { return fired.Length() == kTimerCount - canceled; });
+
+  for (size_t i = 0; i < fired.Length(); i++) {
+    EXPECT_NE(fired[i] % 7, 0u);
+    if (i > 0) {
+      EXPECT_LE(timeouts[fired[i - 1]],
+                timeouts[fired[i]] + TimeDuration::FromMilliseconds(1));
+    }
+  }
+}
@@ -0,0 +1,176 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef mozilla_DispatchChannel_h
+#define mozilla_DispatchChannel_h
+
+#include <atomic>
+#include <functional>
+
+#include "mozilla/Mutex.h"
+#include "mozilla/Queue.h"
+#include "mozilla/SPSCQueue.h"
+#include "nsCOMPtr.h"
+#include "nsIEventTarget.h"
+#include "nsISupportsImpl.h"
+#include "nsThreadUtils.h"
+
+namespace mozilla {
+
+/**
+ * DispatchChannel delivers items from one producer thread to a handler that
+ * runs on an event target, for producer/consumer pairs that exchange items
+ * at a high rate.  Dispatching a runnable per item allocates it, and takes
+ * the lock and signals the condition variable of the target's event queue.
+ * A channel instead moves the items into a lock-free SPSCQueue, and only
+ * dispatches a runnable to the target when it isn't already running or
+ * about to run one, which then hands every item it finds to the handler.
+ *
+ * Example usage:
+ *
+ *   RefPtr<DispatchChannel<Packet>> channel = new DispatchChannel<Packet>(
+ *       "Packets", GetMainThreadSerialEventTarget(), 1024,
+ *       [](Packet&& aPacket) { ... });
+ *
+ *   // On the producer thread:
+ *   channel->Send(std::move(packet));
+ *
+ * Send() is only safe to call from one thread at a time; use a channel for
+ * every producer thread.  Items are handled in the order they were sent.  If
+ * the queue is full, items go to a locked overflow queue until the target
+ * catches up, so sending never fails while the target accepts runnables.
+ */
+template <typename T>
+class DispatchChannel final {
+ public:
+  NS_INLINE_DECL_THREADSAFE_REFCOUNTING(DispatchChannel)
+
+  using Handler = std::function<void(T&&)>;
+
+  // The most items a single runnable hands to the handler before yielding
+  // to the other events of the target.
+  static constexpr uint32_t kMaxBatchSize = 256;
+
+  DispatchChannel(const char* aName, nsIEventTarget* aTarget,
+                  int aCapacity, Handler&& aHandler)
+      : mName(aName),
+        mTarget(aTarget),
+        mHandler(std::move(aHandler)),
+        mQueue(aCapacity) {
+    MOZ_ASSERT(mTarget);
+  }
+
+  /**
+   * Queues aItem for the handler.  Returns false, and drops the item, if the
+   * target doesn't accept runnables anymore.
+   */
+  bool Send(T&& aItem) {
+    if (!mOverflowing.load(std::memory_order_acquire) &&
+        mQueue.Enqueue(aItem)) {
+      return MaybeScheduleDrain();
+    }
+
+    {
+      MutexAutoLock lock(mOverflowMutex);
+      mOverflow.Push(std::move(aItem));
+      mOverflowing.store(true, std::memory_order_release);
+    }
+    return MaybeScheduleDrain();
+  }
+
+ private:
+  ~DispatchChannel() = default;
+
+  bool MaybeScheduleDrain() {
+    if (mDrainScheduled.exchange(true)) {
+      // The target will see the item before it stops draining.
+      return true;
+    }
+    return ScheduleDrain();
+  }
+
+  bool ScheduleDrain() {
+    nsresult rv = mTarget->Dispatch(
+        NewRunnableMethod(mName, this, &DispatchChannel::Drain),
+        NS_DISPATCH_NORMAL);
+    if (NS_FAILED(rv)) {
+      mDrainScheduled = false;
+      return false;
+    }
+    return true;
+  }
+
+  bool HasItems() {
+    return mQueue.AvailableRead() ||
+           mOverflowing.load(std::memory_order_acquire);
+  }
+
+  void Drain() {
+    // The target may be a thread pool, but drains never overlap.
+    mQueue.ResetConsumerThreadId();
+
+    uint32_t handled = 0;
+    for (;;) {
+      T item;
+      while (handled < kMaxBatchSize && mQueue.Dequeue(&item, 1)) {
+        mHandler(std::move(item));
+        handled++;
+      }
+      if (handled < kMaxBatchSize &&
+          mOverflowing.load(std::memory_order_acquire)) {
+        // The producer doesn't use the queue again until we have taken the
+        // overflow, so once the items it queued before overflowing are
+        // handled, the overflow comes next.
+        while (mQueue.Dequeue(&item, 1)) {
+          mHandler(std::move(item));
+          handled++;
+        }
+        Queue<T> overflow;
+        {
+          MutexAutoLock lock(mOverflowMutex);
+          overflow = std::move(mOverflow);
+          mOverflowing.store(false, std::memory_order_release);
+        }
+        while (!overflow.IsEmpty()) {
+          mHandler(overflow.Pop());
+          handled++;
+        }
+        continue;
+      }
+
+      if (handled >= kMaxBatchSize && HasItems()) {
+        // Keep mDrainScheduled set, so that the producer doesn't dispatch
+        // another runnable.
+        ScheduleDrain();
+        return;
+      }
+
+      mDrainScheduled.store(false);
+      // Pairs with the exchange in MaybeScheduleDrain: either the producer
+      // sees that no drain is scheduled, or we see its item.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (!HasItems() || mDrainScheduled.exchange(true)) {
+        return;
+      }
+    }
+  }
+
+  const char* const mName;
+  const nsCOMPtr<nsIEventTarget> mTarget;
+  const Handler mHandler;
+
+  SPSCQueue<T> mQueue;
+  std::atomic<bool> mDrainScheduled{false};
+
+  // Set while the items sent after the queue filled up wait in mOverflow.
+  std::atomic<bool> mOverflowing{false};
+  Mutex mOverflowMutex MOZ_UNANNOTATED{"DispatchChannel::mOverflowMutex"};
+  Queue<T> mOverflow;
+};
+
+}  // namespace mozilla
+
+#endif  // mozilla_DispatchChannel_h
@@ -167,6 +167,21 @@ class Queue {
     return mHead->mEvents[mOffsetHead];
   }
 
+  // The element aIndex elements after the first one.
+  T& ElementAt(size_t aIndex) {
+    MOZ_ASSERT(aIndex < mCount);
+    if (aIndex < mHeadLength) {
+      return mHead->mEvents[(mOffsetHead + aIndex) % ItemsPerPage];
+    }
+    aIndex -= mHeadLength;
+    Page* page = mHead->mNext;
+    while (aIndex >= ItemsPerPage) {
+      page = page->mNext;
+      aIndex -= ItemsPerPage;
+    }
+    return page->mEvents[aIndex];
+  }
+
   size_t Count() const { return mCount; }
 
   size_t ShallowSizeOfExcludingThis(MallocSizeOf aMallocSizeOf) const {
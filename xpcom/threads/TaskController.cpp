@@ -24,7 +24,9 @@
 #include "mozilla/ScopeExit.h"
 #include "mozilla/FlowMarkers.h"
 #include "mozilla/StaticPrefs_memory.h"
+#include "mozilla/ThreadLocal.h"
 #include "nsIThreadInternal.h"
+#include "nsPrintfCString.h"
 #include "nsThread.h"
 #include "prenv.h"
 #include "prsystem.h"
@@ -38,21 +40,77 @@ std::atomic<uint64_t> Task::sCurrentTaskSeqNo = 0;
 const int32_t kMinimumPoolThreadCount = 2;
 const int32_t kMaximumPoolThreadCount = 8;
 
+// Priority keys order tasks by priority, zero meaning no task, so that pool
+// threads can compare the work of the others without locking them.
+static uint64_t PriorityKey(Task* aTask) {
+  return uint64_t(aTask->GetPriority()) + 1;
+}
+
 struct PoolThread {
   const size_t mIndex;
   PRThread* mThread = nullptr;
 
+  // Protects mQueue and mRunningTask, and ensures wakeups aren't lost.
+  Mutex mMutex MOZ_UNANNOTATED;
   CondVar mThreadCV;
+
+  // Protected by the graph mutex.
   RefPtr<Task> mCurrentTask;
 
   // This may be higher than mCurrentTask's priority due to priority
   // propagation. This is -only- valid when mCurrentTask != nullptr.
   uint32_t mEffectiveTaskPriority = 0;
 
-  PoolThread(size_t aIndex, Mutex& aGraphMutex)
-      : mIndex(aIndex), mThreadCV(aGraphMutex, "PoolThread::mThreadCV") {}
+  // The priority key of mEffectiveTaskPriority while mCurrentTask is set,
+  // zero otherwise. Written under the graph mutex.
+  std::atomic<uint64_t> mCurrentTaskKey = 0;
+
+  // Tasks that bypass the task graph, see TaskController::AddPoolQueueTask.
+  std::set<RefPtr<Task>, Task::PriorityCompare> mQueue;
+  // The priority key of the first task of mQueue, written under mMutex.
+  std::atomic<uint64_t> mQueueKey = 0;
+
+  // The task from a queue this thread is running, if any, so that it can be
+  // interrupted for a higher priority task.
+  RefPtr<Task> mRunningTask;
+  std::atomic<uint64_t> mRunningTaskKey = 0;
+
+  // Written under mMutex. Cleared by the thread that wakes this one.
+  bool mSleeping = false;
+
+  explicit PoolThread(size_t aIndex)
+      : mIndex(aIndex),
+        mMutex("PoolThread::mMutex"),
+        mThreadCV(mMutex, "PoolThread::mThreadCV") {}
+
+  void PushTask(RefPtr<Task>&& aTask) {
+    mMutex.AssertCurrentThreadOwns();
+    mQueue.insert(std::move(aTask));
+    mQueueKey = PriorityKey(*mQueue.begin());
+  }
+
+  RefPtr<Task> TakeFirstTask() {
+    mMutex.AssertCurrentThreadOwns();
+    if (mQueue.empty()) {
+      return nullptr;
+    }
+    RefPtr<Task> task = *mQueue.begin();
+    mQueue.erase(mQueue.begin());
+    mQueueKey = mQueue.empty() ? 0 : PriorityKey(*mQueue.begin());
+    return task;
+  }
+
+  // Interrupts the queued task this thread runs if it has a lower priority.
+  void MaybeInterruptRunningTask(uint32_t aPriority) {
+    MutexAutoLock lock(mMutex);
+    if (mRunningTask && mRunningTask->GetPriority() < aPriority) {
+      mRunningTask->RequestInterrupt(aPriority);
+    }
+  }
 };
 
+static MOZ_THREAD_LOCAL(PoolThread*) sCurrentPoolThread;
+
 /* static */
 int32_t TaskController::GetPoolThreadCount() {
   if (PR_GetEnv("MOZ_TASKCONTROLLER_THREADCOUNT")) {
@@ -341,16 +399,21 @@ void TaskController::InitializeThreadPool() {
   MOZ_ASSERT(!mThreadPoolInitialized);
   mThreadPoolInitialized = true;
 
+  MOZ_RELEASE_ASSERT(sCurrentPoolThread.init());
+
+  // Pool threads look at the queues of each other, so they must all exist
+  // before the first thread starts.
   int32_t poolSize = GetPoolThreadCount();
   for (int32_t i = 0; i < poolSize; i++) {
-    auto thread = MakeUnique<PoolThread>(i, mGraphMutex);
+    mPoolThreads.emplace_back(MakeUnique<PoolThread>(i));
+  }
+  for (auto& thread : mPoolThreads) {
     thread->mThread =
         PR_CreateThread(PR_USER_THREAD, ThreadFuncPoolThread, thread.get(),
                         PR_PRIORITY_NORMAL, PR_GLOBAL_THREAD,
                         PR_JOINABLE_THREAD, nsIThreadManager::LargeStackSize());
     MOZ_RELEASE_ASSERT(thread->mThread,
                        "Failed to create TaskController pool thread");
-    mPoolThreads.emplace_back(std::move(thread));
   }
 
   mIdleThreadCount = mPoolThreads.size();
@@ -399,6 +462,7 @@ void TaskController::ShutdownThreadPoolInternal() {
     MutexAutoLock lock(mGraphMutex);
     mShuttingDown = true;
     for (auto& thread : mPoolThreads) {
+      MutexAutoLock threadLock(thread->mMutex);
       thread->mThreadCV.NotifyAll();
     }
   }
@@ -417,76 +481,294 @@ void TaskController::RunPoolThread(PoolThread* aThread) {
   threadName.AppendInt(static_cast<int64_t>(aThread->mIndex));
   AUTO_PROFILER_REGISTER_THREAD(threadName.get());
 
-  MutexAutoLock lock(mGraphMutex);
+  sCurrentPoolThread.set(aThread);
+
   while (!mShuttingDown) {
-    if (!aThread->mCurrentTask) {
-      AUTO_PROFILER_LABEL("TaskController::RunPoolThread", IDLE);
-      aThread->mThreadCV.Wait();
-      continue;
+    // A task the graph gave this thread waits while the queues have tasks
+    // with a higher priority.
+    uint64_t currentTaskKey = aThread->mCurrentTaskKey;
+    if (RefPtr<Task> task = TakePoolQueueTask(aThread, currentTaskKey)) {
+      RunPoolQueueTask(aThread, std::move(task));
+    } else if (currentTaskKey) {
+      RunGraphTask(aThread);
+    } else {
+      WaitForPoolTask(aThread);
     }
+  }
 
-    Task* task = aThread->mCurrentTask;
-    bool taskCompleted = false;
+#ifdef DEBUG
+  {
+    MutexAutoLock lock(mGraphMutex);
+    MOZ_ASSERT(mThreadableTasks.empty());
+  }
+#endif
 
-    {
-      MutexAutoUnlock unlock(mGraphMutex);
-      taskCompleted = RunTask(task) == Task::TaskResult::Complete;
-    }
+  sCurrentPoolThread.set(nullptr);
+
+  IOInterposer::UnregisterCurrentThread();
+}
+
+void TaskController::RunGraphTask(PoolThread* aThread) {
+  MutexAutoLock lock(mGraphMutex);
+  MOZ_ASSERT(aThread->mCurrentTask);
 
-    task->mInProgress = false;
+  Task* task = aThread->mCurrentTask;
+  bool taskCompleted = false;
 
+  {
+    MutexAutoUnlock unlock(mGraphMutex);
+    taskCompleted = RunTask(task) == Task::TaskResult::Complete;
+  }
+
+  task->mInProgress = false;
+
+  if (!taskCompleted) {
+    // Presumably this task was interrupted, leave its dependencies
+    // unresolved and reinsert into the queue.
+    auto insertion = mThreadableTasks.insert(aThread->mCurrentTask);
+    MOZ_ASSERT(insertion.second);
+    task->mIterator = insertion.first;
+  } else {
+    task->mCompleted = true;
+#ifdef DEBUG
+    task->mIsInGraph = false;
+#endif
+    task->mDependencies.clear();
+    // This may have unblocked a main thread task. We could do this only
+    // if there was a main thread task before this one in the dependency
+    // chain.
+    mMayHaveMainThreadTask = true;
+    // Since this could have multiple dependencies thare are restricted
+    // to the main thread. Let's make sure that's awake.
+    EnsureMainThreadTasksScheduled();
+
+    MaybeInterruptTask(GetHighestPriorityMTTask(), lock);
+  }
+
+  // Clear the current task to mark ourselves idle.
+  RefPtr<Task> lastTask = aThread->mCurrentTask.forget();
+  aThread->mCurrentTaskKey = 0;
+  mIdleThreadCount++;
+  MOZ_ASSERT(mIdleThreadCount <= mPoolThreads.size());
+
+  // Dispatch any other tasks that depended on this one.
+  DispatchThreadableTasks(lock);
+
+  // Ensure the last task is released before we enter the wait state. This
+  // happens outside the lock. This is required since it's perfectly feasible
+  // for task destructors to post events themselves.
+  {
+    MutexAutoUnlock unlock(mGraphMutex);
+    lastTask = nullptr;
+  }
+}
+
+void TaskController::RunPoolQueueTask(PoolThread* aThread,
+                                      RefPtr<Task>&& aTask) {
+  {
+    MutexAutoLock lock(aThread->mMutex);
+    aThread->mRunningTask = aTask;
+    aThread->mRunningTaskKey = PriorityKey(aTask);
+  }
+
+  bool taskCompleted = RunTask(aTask) == Task::TaskResult::Complete;
+
+  {
+    MutexAutoLock lock(aThread->mMutex);
+    aThread->mRunningTask = nullptr;
+    aThread->mRunningTaskKey = 0;
     if (!taskCompleted) {
-      // Presumably this task was interrupted, leave its dependencies
-      // unresolved and reinsert into the queue.
-      auto insertion = mThreadableTasks.insert(aThread->mCurrentTask);
-      MOZ_ASSERT(insertion.second);
-      task->mIterator = insertion.first;
-    } else {
-      task->mCompleted = true;
+      // Interrupted, run it again once there is nothing more important.
+      aThread->PushTask(std::move(aTask));
+      return;
+    }
+  }
+
 #ifdef DEBUG
-      task->mIsInGraph = false;
+  aTask->mIsInGraph = false;
 #endif
-      task->mDependencies.clear();
-      // This may have unblocked a main thread task. We could do this only
-      // if there was a main thread task before this one in the dependency
-      // chain.
-      mMayHaveMainThreadTask = true;
-      // Since this could have multiple dependencies thare are restricted
-      // to the main thread. Let's make sure that's awake.
-      EnsureMainThreadTasksScheduled();
-
-      MaybeInterruptTask(GetHighestPriorityMTTask(), lock);
+  // This pairs with AddDependency() setting mHasDependents before the
+  // dependent task checks mCompleted: either that task sees this one
+  // completed, or we see it may be waiting and update the graph.
+  aTask->mCompleted = true;
+  if (aTask->mHasDependents) {
+    MutexAutoLock lock(mGraphMutex);
+    mMayHaveMainThreadTask = true;
+    EnsureMainThreadTasksScheduled();
+    MaybeInterruptTask(GetHighestPriorityMTTask(), lock);
+    DispatchThreadableTasks(lock);
+  }
+
+  // Release the task outside of any lock, its destructor may post events.
+  aTask = nullptr;
+}
+
+RefPtr<Task> TaskController::TakePoolQueueTask(PoolThread* aThread,
+                                               uint64_t aAboveKey) {
+  PoolThread* victim = aThread;
+  uint64_t victimKey = aThread->mQueueKey;
+  for (auto& thread : mPoolThreads) {
+    uint64_t key = thread->mQueueKey;
+    if (key > victimKey) {
+      victim = thread.get();
+      victimKey = key;
     }
+  }
+  if (victimKey <= aAboveKey) {
+    return nullptr;
+  }
 
-    // Clear the current task to mark ourselves idle.
-    RefPtr<Task> lastTask = aThread->mCurrentTask.forget();
-    mIdleThreadCount++;
-    MOZ_ASSERT(mIdleThreadCount <= mPoolThreads.size());
+  RefPtr<Task> task;
+  {
+    MutexAutoLock lock(victim->mMutex);
+    task = victim->TakeFirstTask();
+  }
 
-    // Dispatch any other tasks that depended on this one.
-    DispatchThreadableTasks(lock);
+  if (task && victim != aThread &&
+      profiler_thread_is_being_profiled_for_markers()) {
+    PROFILER_MARKER_TEXT("TaskController::Steal", OTHER, {},
+                         nsPrintfCString("From TaskController #%zu, priority "
+                                         "%u",
+                                         victim->mIndex, task->GetPriority()));
+  }
+  return task;
+}
 
-    // Ensure the last task is released before we enter the wait state. This
-    // happens outside the lock. This is required since it's perfectly feasible
-    // for task destructors to post events themselves.
-    {
-      MutexAutoUnlock unlock(mGraphMutex);
-      lastTask = nullptr;
+bool TaskController::HasPoolQueueTasks() const {
+  for (const auto& thread : mPoolThreads) {
+    if (thread->mQueueKey) {
+      return true;
     }
   }
+  return false;
+}
 
-  MOZ_ASSERT(mThreadableTasks.empty());
+void TaskController::WaitForPoolTask(PoolThread* aThread) {
+  TimeStamp idleStart;
+  if (profiler_thread_is_being_profiled_for_markers()) {
+    idleStart = TimeStamp::Now();
+  }
 
-  IOInterposer::UnregisterCurrentThread();
+  {
+    MutexAutoLock lock(aThread->mMutex);
+    aThread->mSleeping = true;
+    // This pairs with AddPoolQueueTask() checking mSleepingThreadCount after
+    // adding a task: either we see the task, or it sees us sleeping.
+    mSleepingThreadCount++;
+    while (aThread->mSleeping) {
+      if (mShuttingDown || aThread->mCurrentTaskKey || HasPoolQueueTasks()) {
+        aThread->mSleeping = false;
+        mSleepingThreadCount--;
+        break;
+      }
+      AUTO_PROFILER_LABEL("TaskController::RunPoolThread", IDLE);
+      aThread->mThreadCV.Wait();
+    }
+  }
+
+  if (!idleStart.IsNull()) {
+    PROFILER_MARKER_UNTYPED("TaskController::Idle", IDLE,
+                            MarkerTiming::IntervalUntilNowFrom(idleStart));
+  }
+}
+
+bool TaskController::WakePoolThread(PoolThread* aPreferred) {
+  if (!mSleepingThreadCount) {
+    return false;
+  }
+
+  size_t count = mPoolThreads.size();
+  for (size_t i = 0; i < count; i++) {
+    PoolThread* thread = mPoolThreads[(aPreferred->mIndex + i) % count].get();
+    MutexAutoLock lock(thread->mMutex);
+    if (thread->mSleeping) {
+      // Claim the thread so that the next wakeup goes to another one.
+      thread->mSleeping = false;
+      mSleepingThreadCount--;
+      thread->mThreadCV.Notify();
+      return true;
+    }
+  }
+  return false;
+}
+
+void TaskController::AddPoolQueueTask(RefPtr<Task>&& aTask) {
+  MOZ_ASSERT(aTask->GetKind() == Task::Kind::OffMainThreadOnly);
+  MOZ_ASSERT(aTask->mDependencies.empty());
+
+  // The graph never schedules this task itself, tasks depending on it just
+  // wait for it to complete.
+  aTask->mInPoolQueue = true;
+  aTask->mInProgress = true;
+
+  // Tasks added by pool threads stay on that thread, where their data is
+  // likely to still be in the cache, unless another thread steals them.
+  PoolThread* thread = sCurrentPoolThread.get();
+  if (!thread) {
+    thread = mPoolThreads[mNextPoolQueue++ % mPoolThreads.size()].get();
+  }
+
+  uint32_t priority = aTask->GetPriority();
+  {
+    MutexAutoLock lock(thread->mMutex);
+    thread->PushTask(std::move(aTask));
+  }
+
+  if (WakePoolThread(thread)) {
+    return;
+  }
+
+  // All threads are busy, interrupt the lowest priority queued task that
+  // runs if this one is more important, as MaybeInterruptTask() does for
+  // the tasks of the graph.
+  PoolThread* lowest = nullptr;
+  uint64_t lowestKey = UINT64_MAX;
+  for (auto& other : mPoolThreads) {
+    uint64_t key = other->mRunningTaskKey;
+    if (key && key < lowestKey) {
+      lowest = other.get();
+      lowestKey = key;
+    }
+  }
+  if (lowest && lowestKey < uint64_t(priority) + 1) {
+    lowest->MaybeInterruptRunningTask(priority);
+  }
+}
+
+void TaskController::PrepareToAddTask(Task* aTask) {
+  if (profiler_is_active_and_unpaused()) {
+    aTask->mInsertionTime = TimeStamp::Now();
+  }
+
+#ifdef DEBUG
+  aTask->mIsInGraph = true;
+
+  for (const RefPtr<Task>& otherTask : aTask->mDependencies) {
+    MOZ_ASSERT(!otherTask->mTaskManager ||
+               otherTask->mTaskManager == aTask->mTaskManager);
+  }
+#endif
+
+  LogTask::LogDispatch(aTask);
+  PROFILER_MARKER("TaskController::AddTask", OTHER, {}, FlowMarker,
+                  Flow::FromPointer(aTask));
 }
 
 void TaskController::AddTask(already_AddRefed<Task>&& aTask) {
   RefPtr<Task> task(aTask);
 
   if (task->GetKind() == Task::Kind::OffMainThreadOnly) {
-    MutexAutoLock lock(mPoolInitializationMutex);
-    if (!mThreadPoolInitialized) {
-      InitializeThreadPool();
+    {
+      MutexAutoLock lock(mPoolInitializationMutex);
+      if (!mThreadPoolInitialized) {
+        InitializeThreadPool();
+      }
+    }
+
+    if (task->mDependencies.empty()) {
+      PrepareToAddTask(task);
+      AddPoolQueueTask(std::move(task));
+      return;
     }
   }
 
@@ -503,22 +785,7 @@ void TaskController::AddTask(already_AddRefed<Task>&& aTask) {
     task->mPriorityModifier = manager->mCurrentPriorityModifier;
   }
 
-  if (profiler_is_active_and_unpaused()) {
-    task->mInsertionTime = TimeStamp::Now();
-  }
-
-#ifdef DEBUG
-  task->mIsInGraph = true;
-
-  for (const RefPtr<Task>& otherTask : task->mDependencies) {
-    MOZ_ASSERT(!otherTask->mTaskManager ||
-               otherTask->mTaskManager == task->mTaskManager);
-  }
-#endif
-
-  LogTask::LogDispatch(task);
-  PROFILER_MARKER("TaskController::AddTask", OTHER, {}, FlowMarker,
-                  Flow::FromPointer(task.get()));
+  PrepareToAddTask(task);
 
   std::pair<std::set<RefPtr<Task>, Task::PriorityCompare>::iterator, bool>
       insertion;
@@ -568,10 +835,23 @@ bool TaskController::MaybeDispatchOneThreadableTask(
   MOZ_ASSERT(mIdleThreadCount != 0);
   thread->mCurrentTask = task;
   thread->mEffectiveTaskPriority = effetivePriority;
-  thread->mThreadCV.Notify();
+  thread->mCurrentTaskKey = uint64_t(effetivePriority) + 1;
   task->mInProgress = true;
   mIdleThreadCount--;
 
+  {
+    MutexAutoLock lock(thread->mMutex);
+    if (thread->mSleeping) {
+      thread->mSleeping = false;
+      mSleepingThreadCount--;
+      thread->mThreadCV.Notify();
+    } else if (thread->mRunningTask &&
+               thread->mRunningTask->GetPriority() < effetivePriority) {
+      // The thread runs a queued task, which may be less important.
+      thread->mRunningTask->RequestInterrupt(effetivePriority);
+    }
+  }
+
   return true;
 }
 
@@ -602,14 +882,22 @@ TaskController::TaskToRun TaskController::TakeThreadableTaskToRun(
 PoolThread* TaskController::SelectThread(const MutexAutoLock& aProofOfLock) {
   MOZ_ASSERT(mIdleThreadCount != 0);
 
-  // This just picks the first free thread.
+  // This picks the first free thread, preferring the ones that aren't busy
+  // with tasks from their queue either.
+  PoolThread* selected = nullptr;
   for (auto& thread : mPoolThreads) {
     if (!thread->mCurrentTask) {
-      return thread.get();
+      if (!thread->mRunningTaskKey) {
+        return thread.get();
+      }
+      if (!selected) {
+        selected = thread.get();
+      }
     }
   }
 
-  MOZ_CRASH("Couldn't find idle thread");
+  MOZ_RELEASE_ASSERT(selected, "Couldn't find idle thread");
+  return selected;
 }
 
 void TaskController::WaitForTaskOrMessage() {
@@ -673,6 +961,24 @@ void TaskController::ProcessPendingMTTask(bool aMayWait) {
 }
 
 void TaskController::ReprioritizeTask(Task* aTask, uint32_t aPriority) {
+  if (aTask->mInPoolQueue) {
+    // Whichever queue the task is in now. The task set compares priorities,
+    // so this must be done under the lock of that queue.
+    for (auto& thread : mPoolThreads) {
+      MutexAutoLock lock(thread->mMutex);
+      auto iter = thread->mQueue.find(aTask);
+      if (iter != thread->mQueue.end()) {
+        RefPtr<Task> task = *iter;
+        thread->mQueue.erase(iter);
+        task->mPriority = aPriority;
+        thread->PushTask(std::move(task));
+        return;
+      }
+    }
+    MOZ_ASSERT_UNREACHABLE("Reprioritizing a task that isn't queued");
+    return;
+  }
+
   MutexAutoLock lock(mGraphMutex);
   std::set<RefPtr<Task>, Task::PriorityCompare>* queue = &mMainThreadTasks;
   if (aTask->GetKind() == Task::Kind::OffMainThreadOnly) {
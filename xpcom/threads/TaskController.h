@@ -157,6 +157,7 @@ class Task {
   void AddDependency(Task* aTask) {
     MOZ_ASSERT(aTask);
     MOZ_ASSERT(!mIsInGraph);
+    aTask->mHasDependents = true;
     mDependencies.insert(aTask);
   }
 
@@ -238,12 +239,22 @@ class Task {
 
   // Access to these variables is protected by the GraphMutex.
   Kind mKind;
-  bool mCompleted = false;
   bool mInProgress = false;
+  // Whether this task runs from the queue of a pool thread rather than from
+  // the task graph. Set before the task is added and never changed.
+  bool mInPoolQueue = false;
 #ifdef DEBUG
   bool mIsInGraph = false;
 #endif
 
+  // These are also accessed without the GraphMutex by the pool threads
+  // running tasks from their queues.
+  std::atomic<bool> mCompleted = false;
+  // Set once another task depends on this one, so that completing the task
+  // from a pool thread queue only needs to update the task graph when some
+  // task may be waiting for it.
+  std::atomic<bool> mHasDependents = false;
+
   static std::atomic<uint64_t> sCurrentTaskSeqNo;
   int64_t mSeqNo;
   uint32_t mPriority;
@@ -394,6 +405,21 @@ class TaskController {
   bool MaybeDispatchOneThreadableTask(const MutexAutoLock& aProofOfLock);
   PoolThread* SelectThread(const MutexAutoLock& aProofOfLock);
 
+  // Off main thread tasks without dependencies bypass the task graph: they
+  // go to the queue of a pool thread, and pool threads that run out of work
+  // steal the highest priority task of the other queues.
+  void AddPoolQueueTask(RefPtr<Task>&& aTask);
+  // The highest priority queued task with a priority key above aAboveKey,
+  // preferring aThread's own queue over stealing.
+  RefPtr<Task> TakePoolQueueTask(PoolThread* aThread, uint64_t aAboveKey);
+  void RunPoolQueueTask(PoolThread* aThread, RefPtr<Task>&& aTask);
+  void RunGraphTask(PoolThread* aThread);
+  void WaitForPoolTask(PoolThread* aThread);
+  bool HasPoolQueueTasks() const;
+  // Wakes a sleeping pool thread, aPreferred if it sleeps. Returns false if
+  // all of them are busy.
+  bool WakePoolThread(PoolThread* aPreferred);
+
   struct TaskToRun {
     RefPtr<Task> mTask;
     uint32_t mEffectiveTaskPriority = 0;
@@ -409,6 +435,8 @@ class TaskController {
   void RunPoolThread(PoolThread* aThread);
   friend struct PoolThread;
 
+  void PrepareToAddTask(Task* aTask);
+
   // This protects access to the task graph.
   Mutex mGraphMutex MOZ_UNANNOTATED;
 
@@ -424,6 +452,13 @@ class TaskController {
   // thread, so no locking is needed to access this.
   std::vector<UniquePtr<PoolThread>> mPoolThreads;
 
+  // Number of pool threads waiting for work, so that adding a task to a pool
+  // thread queue doesn't look for a thread to wake when none sleeps.
+  std::atomic<size_t> mSleepingThreadCount = 0;
+  // The queue that tasks added from outside the pool go to.
+  std::atomic<size_t> mNextPoolQueue = 0;
+  std::atomic<bool> mShuttingDown = false;
+
   CondVar mMainThreadCV;
 
   // Variables below are protected by mGraphMutex.
@@ -443,7 +478,6 @@ class TaskController {
 
   // This ensures we keep running the main thread if we processed a task there.
   bool mMayHaveMainThreadTask = true;
-  bool mShuttingDown = false;
 
 #ifdef MOZ_MEMORY
   // Flag if we should trigger deferred idle purging in mozjemalloc.
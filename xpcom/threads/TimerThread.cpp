@@ -16,6 +16,8 @@
 #include "mozilla/ChaosMode.h"
 #include "mozilla/ArenaAllocator.h"
 #include "mozilla/ArrayUtils.h"
+#include "mozilla/MathAlgorithms.h"
+#include "mozilla/Maybe.h"
 #include "mozilla/OperatorNewExtensions.h"
 #include "mozilla/StaticPrefs_timer.h"
 
@@ -573,12 +575,8 @@ nsresult TimerThread::Shutdown() {
     // might potentially call some code reentering the same lock
     // that leads to unexpected behavior or deadlock.
     // See bug 422472.
-    timers.SetCapacity(mTimers.Length());
-    for (Entry& entry : mTimers) {
-      if (entry.Value()) {
-        timers.AppendElement(entry.Take());
-      }
-    }
+    mTimers.ForEach(
+        [&](Entry& aEntry) { timers.AppendElement(aEntry.Take()); });
 
     mTimers.Clear();
   }
@@ -615,66 +613,233 @@ struct IntervalComparator {
 #ifdef DEBUG
 void TimerThread::VerifyTimerListConsistency() const {
   mMonitor.AssertCurrentThreadOwns();
+  mTimers.VerifyConsistency();
+}
 
-  // Find the first non-canceled timer (and check its cached timeout if we find
-  // it).
-  const size_t timerCount = mTimers.Length();
-  size_t lastNonCanceledTimerIndex = 0;
-  while (lastNonCanceledTimerIndex < timerCount &&
-         !mTimers[lastNonCanceledTimerIndex].Value()) {
-    ++lastNonCanceledTimerIndex;
-  }
-  MOZ_ASSERT(lastNonCanceledTimerIndex == timerCount ||
-             mTimers[lastNonCanceledTimerIndex].Value());
-  MOZ_ASSERT(lastNonCanceledTimerIndex == timerCount ||
-             mTimers[lastNonCanceledTimerIndex].Value()->mTimeout ==
-                 mTimers[lastNonCanceledTimerIndex].Timeout());
-
-  // Verify that mTimers is sorted and the cached timeouts are consistent.
-  for (size_t timerIndex = lastNonCanceledTimerIndex + 1;
-       timerIndex < timerCount; ++timerIndex) {
-    if (mTimers[timerIndex].Value()) {
-      MOZ_ASSERT(mTimers[timerIndex].Timeout() ==
-                 mTimers[timerIndex].Value()->mTimeout);
-      MOZ_ASSERT(mTimers[timerIndex].Timeout() >=
-                 mTimers[lastNonCanceledTimerIndex].Timeout());
-      lastNonCanceledTimerIndex = timerIndex;
+void TimerThread::TimerWheel::VerifyConsistency() const {
+  size_t count = 0;
+  for (uint32_t level = 0; level < kLevels; level++) {
+    for (uint32_t slot = 0; slot < kSlots; slot++) {
+      const nsTArray<Entry>& entries = mSlots[level][slot];
+      MOZ_ASSERT(entries.IsEmpty() == !(mOccupied[level] & (1ull << slot)));
+      for (size_t i = 0; i < entries.Length(); i++) {
+        const Entry& entry = entries[i];
+        MOZ_ASSERT(entry.Value());
+        MOZ_ASSERT(entry.Timeout() == entry.Value()->mTimeout);
+        const Location location = LocationFor(entry.Timeout());
+        MOZ_ASSERT(location.mLevel == level && location.mSlot == slot);
+        // Level 0 is sorted.
+        MOZ_ASSERT_IF(level == 0 && i > 0,
+                      entries[i - 1].Timeout() <= entry.Timeout());
+      }
+      count += entries.Length();
     }
   }
+  for (const Entry& entry : mOverflow) {
+    MOZ_ASSERT(entry.Value());
+    MOZ_ASSERT(entry.Timeout() == entry.Value()->mTimeout);
+    MOZ_ASSERT(LocationFor(entry.Timeout()).mLevel == kLevels);
+  }
+  count += mOverflow.Length();
+  MOZ_ASSERT(count == mCount);
 }
 #endif
 
-size_t TimerThread::ComputeTimerInsertionIndex(const TimeStamp& timeout) const {
-  mMonitor.AssertCurrentThreadOwns();
+uint64_t TimerThread::TimerWheel::TickFor(const TimeStamp& aTimeout) const {
+  if (aTimeout <= mBase) {
+    return 0;
+  }
+  return uint64_t((aTimeout - mBase).ToMilliseconds());
+}
+
+TimerThread::TimerWheel::Location TimerThread::TimerWheel::LocationFor(
+    const TimeStamp& aTimeout) const {
+  // Timers due before the cursor go in its slot.
+  const uint64_t tick = std::max(TickFor(aTimeout), mCursor);
+  for (uint32_t level = 0; level < kLevels; level++) {
+    const uint32_t higherBits = (level + 1) * kSlotBits;
+    if ((tick >> higherBits) == (mCursor >> higherBits)) {
+      return {level, uint32_t(tick >> (level * kSlotBits)) % kSlots};
+    }
+  }
+  return {kLevels, 0};
+}
+
+bool TimerThread::TimerWheel::Place(Entry&& aEntry, bool aFallible) {
+  const Location location = LocationFor(aEntry.Timeout());
+  nsTArray<Entry>& slot = SlotAt(location);
+  // Keep level 0 sorted, after the timers with the same timeout.  New timers
+  // are usually due last.
+  size_t index = slot.Length();
+  if (location.mLevel == 0) {
+    while (index > 0 && slot[index - 1].Timeout() > aEntry.Timeout()) {
+      --index;
+    }
+  }
+  if (!aFallible) {
+    slot.InsertElementAt(index, std::move(aEntry));
+  } else if (!slot.InsertElementAt(index, std::move(aEntry), fallible)) {
+    return false;
+  }
+  if (location.mLevel < kLevels) {
+    mOccupied[location.mLevel] |= 1ull << location.mSlot;
+  }
+  ++mCount;
+  return true;
+}
 
-  const size_t timerCount = mTimers.Length();
+bool TimerThread::TimerWheel::Insert(nsTimerImpl& aTimer) {
+  if (mCount == 0) {
+    // Start over, to keep the ticks small.
+    mBase = aTimer.mTimeout;
+    mCursor = 0;
+  }
+  return Place(Entry{aTimer}, /* aFallible */ true);
+}
 
-  size_t firstGtIndex = 0;
-  while (firstGtIndex < timerCount &&
-         (!mTimers[firstGtIndex].Value() ||
-          mTimers[firstGtIndex].Timeout() <= timeout)) {
-    ++firstGtIndex;
+void TimerThread::TimerWheel::RemoveAt(const Location& aLocation,
+                                       size_t aIndex) {
+  nsTArray<Entry>& slot = SlotAt(aLocation);
+  slot.RemoveElementAt(aIndex);
+  if (slot.IsEmpty() && aLocation.mLevel < kLevels) {
+    mOccupied[aLocation.mLevel] &= ~(1ull << aLocation.mSlot);
   }
+  --mCount;
+}
 
-  return firstGtIndex;
+bool TimerThread::TimerWheel::Remove(nsTimerImpl& aTimer) {
+  const Location location = LocationFor(aTimer.mTimeout);
+  nsTArray<Entry>& slot = SlotAt(location);
+  for (size_t i = 0; i < slot.Length(); ++i) {
+    if (slot[i].Value() == &aTimer) {
+      RemoveAt(location, i);
+      return true;
+    }
+  }
+  return false;
+}
+
+const TimerThread::Entry& TimerThread::TimerWheel::First() const {
+  MOZ_ASSERT(!IsEmpty());
+  const Entry* first = nullptr;
+  ForEachInOrder([&](const Entry& aEntry) {
+    first = &aEntry;
+    return false;
+  });
+  return *first;
+}
+
+already_AddRefed<nsTimerImpl> TimerThread::TimerWheel::TakeFirst() {
+  const Entry& first = First();
+  const Location location = LocationFor(first.Timeout());
+  const size_t index = &first - SlotAt(location).Elements();
+  RefPtr<nsTimerImpl> timer = SlotAt(location)[index].Take();
+  RemoveAt(location, index);
+  return timer.forget();
+}
+
+void TimerThread::TimerWheel::Cascade(nsTArray<Entry>& aSlot) {
+  nsTArray<Entry> entries = std::move(aSlot);
+  mCount -= entries.Length();
+  for (Entry& entry : entries) {
+    Place(std::move(entry), /* aFallible */ false);
+  }
+}
+
+uint64_t TimerThread::TimerWheel::LaterSlots(uint32_t aLevel) const {
+  const uint32_t slot = (mCursor >> (aLevel * kSlotBits)) % kSlots;
+  return slot == kSlots - 1 ? 0 : mOccupied[aLevel] & (~0ull << (slot + 1));
+}
+
+void TimerThread::TimerWheel::MoveCursor(uint64_t aCursor) {
+  MOZ_ASSERT(aCursor > mCursor);
+  const uint64_t oldCursor = mCursor;
+  mCursor = aCursor;
+
+  // The cursor entered the slots that hold the timers it's now closest to,
+  // move them down, from the highest level on.
+  constexpr uint32_t kWheelBits = kLevels * kSlotBits;
+  if ((aCursor >> kWheelBits) != (oldCursor >> kWheelBits)) {
+    Cascade(mOverflow);
+  }
+  for (uint32_t level = kLevels - 1; level > 0; level--) {
+    const uint32_t slot = (aCursor >> (level * kSlotBits)) % kSlots;
+    if (mOccupied[level] & (1ull << slot)) {
+      mOccupied[level] &= ~(1ull << slot);
+      Cascade(mSlots[level][slot]);
+    }
+  }
+}
+
+void TimerThread::TimerWheel::AdvanceTo(const TimeStamp& aNow) {
+  static_assert(kSlots == 64, "mOccupied has a bit per slot");
+  if (IsEmpty()) {
+    return;
+  }
+
+  const uint64_t target = TickFor(aNow);
+  while (mCursor < target) {
+    const uint32_t cursorSlot = mCursor % kSlots;
+    if (mOccupied[0] & (1ull << cursorSlot)) {
+      // Never move past a timer.
+      return;
+    }
+
+    if (uint64_t slots = LaterSlots(0)) {
+      mCursor = std::min(mCursor - cursorSlot + CountTrailingZeroes64(slots),
+                         target);
+      continue;
+    }
+
+    // Only higher levels have timers, the lowest one's first slot holds the
+    // next ones.
+    uint64_t next = UINT64_MAX;
+    uint32_t level = 1;
+    for (; level < kLevels; level++) {
+      if (uint64_t slots = LaterSlots(level)) {
+        const uint32_t higherBits = (level + 1) * kSlotBits;
+        next = ((mCursor >> higherBits) << higherBits) |
+               (uint64_t(CountTrailingZeroes64(slots)) << (level * kSlotBits));
+        break;
+      }
+    }
+    if (level == kLevels) {
+      for (const Entry& entry : mOverflow) {
+        next = std::min(next, TickFor(entry.Timeout()));
+      }
+    }
+    MoveCursor(std::min(next, target));
+  }
+}
+
+void TimerThread::TimerWheel::Clear() {
+  for (auto& level : mSlots) {
+    for (auto& slot : level) {
+      slot.Clear();
+    }
+  }
+  mOverflow.Clear();
+  for (uint64_t& occupied : mOccupied) {
+    occupied = 0;
+  }
+  mCount = 0;
 }
 
 TimeStamp TimerThread::ComputeWakeupTimeFromTimers() const {
   mMonitor.AssertCurrentThreadOwns();
 
-  // Timer list should be non-empty and first timer should always be
-  // non-canceled at this point and we rely on that here.
+  // Timer list should be non-empty at this point and we rely on that here.
   MOZ_ASSERT(!mTimers.IsEmpty());
-  MOZ_ASSERT(mTimers[0].Value());
 
-  // Overview: Find the last timer in the list that can be "bundled" together in
-  // the same wake-up with mTimers[0] and use its timeout as our target wake-up
-  // time.
+  // Overview: Find the last timer in firing order that can be "bundled"
+  // together in the same wake-up with the first one and use its timeout as our
+  // target wake-up time.
+  const Entry& first = mTimers.First();
 
   // bundleWakeup is when we should wake up in order to be able to fire all of
   // the timers in our selected bundle. It will always be the timeout of the
   // last timer in the bundle.
-  TimeStamp bundleWakeup = mTimers[0].Timeout();
+  TimeStamp bundleWakeup = first.Timeout();
 
   // cutoffTime is the latest that we can wake up for the timers currently
   // accepted into the bundle. These needs to be updated as we go through the
@@ -684,22 +849,18 @@ TimeStamp TimerThread::ComputeWakeupTimeFromTimers() const {
   const TimeDuration maxTimerDelay = TimeDuration::FromMilliseconds(
       StaticPrefs::timer_maximum_firing_delay_tolerance_ms());
   TimeStamp cutoffTime =
-      bundleWakeup + ComputeAcceptableFiringDelay(mTimers[0].Delay(),
-                                                  minTimerDelay, maxTimerDelay);
-
-  const size_t timerCount = mTimers.Length();
-  for (size_t entryIndex = 1; entryIndex < timerCount; ++entryIndex) {
-    const Entry& curEntry = mTimers[entryIndex];
-    const nsTimerImpl* curTimer = curEntry.Value();
-    if (!curTimer) {
-      // Canceled timer - skip it
-      continue;
+      bundleWakeup + ComputeAcceptableFiringDelay(first.Delay(), minTimerDelay,
+                                                  maxTimerDelay);
+
+  mTimers.ForEachInOrder([&](const Entry& aEntry) {
+    if (&aEntry == &first) {
+      return true;
     }
 
-    const TimeStamp curTimerDue = curEntry.Timeout();
+    const TimeStamp curTimerDue = aEntry.Timeout();
     if (curTimerDue > cutoffTime) {
       // Can't include this timer in the bundle - it fires too late.
-      break;
+      return false;
     }
 
     // This timer can be included in the bundle. Update bundleWakeup and
@@ -707,16 +868,17 @@ TimeStamp TimerThread::ComputeWakeupTimeFromTimers() const {
     bundleWakeup = curTimerDue;
     cutoffTime = std::min(
         curTimerDue + ComputeAcceptableFiringDelay(
-                          curEntry.Delay(), minTimerDelay, maxTimerDelay),
+                          aEntry.Delay(), minTimerDelay, maxTimerDelay),
         cutoffTime);
     MOZ_ASSERT(bundleWakeup <= cutoffTime);
-  }
+    return true;
+  });
 
 #if !defined(XP_WIN)
   // Due to the fact that, on Windows, each TimeStamp object holds two distinct
   // "values", this assert is not valid there. See bug 1829983 for the details.
-  MOZ_ASSERT(bundleWakeup - mTimers[0].Timeout() <=
-             ComputeAcceptableFiringDelay(mTimers[0].Delay(), minTimerDelay,
+  MOZ_ASSERT(bundleWakeup - first.Timeout() <=
+             ComputeAcceptableFiringDelay(first.Delay(), minTimerDelay,
                                           maxTimerDelay));
 #endif
 
@@ -828,19 +990,18 @@ TimerThread::Run() {
       }
 #endif
 
-      RemoveLeadingCanceledTimersInternal();
+      mTimers.AdvanceTo(now);
 
       if (!mTimers.IsEmpty()) {
-        if (now + allowedEarlyFiring >= mTimers[0].Value()->mTimeout) {
+        if (now + allowedEarlyFiring >= mTimers.First().Timeout()) {
         next:
           // NB: AddRef before the Release under RemoveTimerInternal to avoid
           // mRefCnt passing through zero, in case all other refs than the one
-          // from mTimers have gone away (the last non-mTimers[i]-ref's Release
+          // from mTimers have gone away (the last non-mTimers-ref's Release
           // must be racing with us, blocked in gThread->RemoveTimer waiting
           // for TimerThread::mMonitor, under nsTimerImpl::Release.
 
-          RefPtr<nsTimerImpl> timerRef(mTimers[0].Take());
-          RemoveFirstTimerInternal();
+          RefPtr<nsTimerImpl> timerRef(mTimers.TakeFirst());
           MOZ_LOG(GetTimerLog(), LogLevel::Debug,
                   ("Timer thread woke up %fms from when it was supposed to\n",
                    fabs((now - timerRef->mTimeout).ToMilliseconds())));
@@ -864,10 +1025,8 @@ TimerThread::Run() {
         }
       }
 
-      RemoveLeadingCanceledTimersInternal();
-
       if (!mTimers.IsEmpty()) {
-        TimeStamp timeout = mTimers[0].Value()->mTimeout;
+        TimeStamp timeout = mTimers.First().Timeout();
 
         // Don't wait at all (even for PR_INTERVAL_NO_WAIT) if the next timer
         // is due now or overdue.
@@ -1071,11 +1230,7 @@ nsresult TimerThread::RemoveTimer(nsTimerImpl* aTimer,
 #endif
 
   // Note: The timer thread is *not* awoken.
-  // The removed-timer entry is just left null, and will be reused (by a new or
-  // re-set timer) or discarded (when the timer thread logic handles non-null
-  // timers around it).
-  // If this was the front timer, and in the unlikely case that its entry is not
-  // soon reused by a re-set timer, the timer thread will wake up at the
+  // If this was the front timer, the timer thread will wake up at the
   // previously-scheduled time, but will quickly notice that there is no actual
   // pending timer, and will restart its wait until the following real timeout.
 
@@ -1112,33 +1267,39 @@ TimeStamp TimerThread::FindNextFireTimeForCurrentThread(TimeStamp aDefault,
   MonitorAutoLock lock(mMonitor);
   AUTO_TIMERS_STATS(TimerThread_FindNextFireTimeForCurrentThread);
 
-  for (const Entry& entry : mTimers) {
-    const nsTimerImpl* timer = entry.Value();
-    if (timer) {
-      if (entry.Timeout() > aDefault) {
-        return aDefault;
-      }
-
-      // Don't yield to timers created with the *_LOW_PRIORITY type.
-      if (!timer->IsLowPriority()) {
-        bool isOnCurrentThread = false;
-        nsresult rv =
-            timer->mEventTarget->IsOnCurrentThread(&isOnCurrentThread);
-        if (NS_SUCCEEDED(rv) && isOnCurrentThread) {
-          return entry.Timeout();
-        }
-      }
+  Maybe<TimeStamp> result;
+  mTimers.ForEachInOrder([&](const Entry& aEntry) {
+    const nsTimerImpl* timer = aEntry.Value();
+    if (aEntry.Timeout() > aDefault) {
+      result.emplace(aDefault);
+      return false;
+    }
 
-      if (aSearchBound == 0) {
-        // Couldn't find any non-low priority timers for the current thread.
-        // Return a compromise between a very short and a long idle time.
-        TimeStamp fallbackDeadline =
-            TimeStamp::Now() + TimeDuration::FromMilliseconds(16);
-        return fallbackDeadline < aDefault ? fallbackDeadline : aDefault;
+    // Don't yield to timers created with the *_LOW_PRIORITY type.
+    if (!timer->IsLowPriority()) {
+      bool isOnCurrentThread = false;
+      nsresult rv = timer->mEventTarget->IsOnCurrentThread(&isOnCurrentThread);
+      if (NS_SUCCEEDED(rv) && isOnCurrentThread) {
+        result.emplace(aEntry.Timeout());
+        return false;
       }
+    }
 
-      --aSearchBound;
+    if (aSearchBound == 0) {
+      // Couldn't find any non-low priority timers for the current thread.
+      // Return a compromise between a very short and a long idle time.
+      TimeStamp fallbackDeadline =
+          TimeStamp::Now() + TimeDuration::FromMilliseconds(16);
+      result.emplace(fallbackDeadline < aDefault ? fallbackDeadline
+                                                 : aDefault);
+      return false;
     }
+
+    --aSearchBound;
+    return true;
+  });
+  if (result) {
+    return *result;
   }
 
   // No timers for this thread, return the default.
@@ -1157,74 +1318,7 @@ bool TimerThread::AddTimerInternal(nsTimerImpl& aTimer) {
 
   LogTimerEvent::LogDispatch(&aTimer);
 
-  const TimeStamp& timeout = aTimer.mTimeout;
-  const size_t insertionIndex = ComputeTimerInsertionIndex(timeout);
-
-  if (insertionIndex != 0 && !mTimers[insertionIndex - 1].Value()) {
-    // Very common scenario in practice: The timer just before the insertion
-    // point is canceled, overwrite it.
-    AUTO_TIMERS_STATS(TimerThread_AddTimerInternal_overwrite_before);
-    mTimers[insertionIndex - 1] = Entry{aTimer};
-    return true;
-  }
-
-  const size_t length = mTimers.Length();
-  if (insertionIndex == length) {
-    // We're at the end (including it's the very first insertion), add new timer
-    // at the end.
-    AUTO_TIMERS_STATS(TimerThread_AddTimerInternal_append);
-    return mTimers.AppendElement(Entry{aTimer}, mozilla::fallible);
-  }
-
-  if (!mTimers[insertionIndex].Value()) {
-    // The timer at the insertion point is canceled, overwrite it.
-    AUTO_TIMERS_STATS(TimerThread_AddTimerInternal_overwrite);
-    mTimers[insertionIndex] = Entry{aTimer};
-    return true;
-  }
-
-  // The new timer has to be inserted.
-  AUTO_TIMERS_STATS(TimerThread_AddTimerInternal_insert);
-  // The capacity should be checked first, because if it needs to be increased
-  // and the memory allocation fails, only the new timer should be lost.
-  if (length == mTimers.Capacity() && mTimers[length - 1].Value()) {
-    // We have reached capacity, and the last entry is not canceled, so we
-    // really want to increase the capacity in case the extra slot is required.
-    // To force-expand the array, append a canceled-timer entry with a timestamp
-    // far in the future.
-    // This empty Entry may be used below to receive the moved-from previous
-    // entry. If not, it may be used in a later call if we need to append a new
-    // timer at the end.
-    AUTO_TIMERS_STATS(TimerThread_AddTimerInternal_insert_expand);
-    if (!mTimers.AppendElement(
-            Entry{mTimers[length - 1].Timeout() +
-                  TimeDuration::FromSeconds(365.0 * 24.0 * 60.0 * 60.0)},
-            mozilla::fallible)) {
-      return false;
-    }
-  }
-
-  // Extract the timer at the insertion point, and put the new timer in its
-  // place.
-  Entry extractedEntry = std::exchange(mTimers[insertionIndex], Entry{aTimer});
-  // Following entries can be pushed until we hit a canceled timer or the end.
-  for (size_t i = insertionIndex + 1; i < length; ++i) {
-    Entry& entryRef = mTimers[i];
-    if (!entryRef.Value()) {
-      // Canceled entry, overwrite it with the extracted entry from before.
-      COUNT_TIMERS_STATS(TimerThread_AddTimerInternal_insert_overwrite);
-      entryRef = std::move(extractedEntry);
-      return true;
-    }
-    // Write extracted entry from before, and extract current entry.
-    COUNT_TIMERS_STATS(TimerThread_AddTimerInternal_insert_shifts);
-    std::swap(entryRef, extractedEntry);
-  }
-  // We've reached the end of the list, with still one extracted entry to
-  // re-insert. We've checked the capacity above, this cannot fail.
-  COUNT_TIMERS_STATS(TimerThread_AddTimerInternal_insert_append);
-  mTimers.AppendElement(std::move(extractedEntry));
-  return true;
+  return mTimers.Insert(aTimer);
 }
 
 // This function must be called from within a lock
@@ -1238,35 +1332,14 @@ bool TimerThread::RemoveTimerInternal(nsTimerImpl& aTimer) {
     return false;
   }
   AUTO_TIMERS_STATS(TimerThread_RemoveTimerInternal_in_list);
-  for (auto& entry : mTimers) {
-    if (entry.Value() == &aTimer) {
-      entry.Forget();
-      return true;
-    }
+  if (mTimers.Remove(aTimer)) {
+    return true;
   }
   MOZ_ASSERT(!aTimer.IsInTimerThread(),
              "Not found in the list but it should be!?");
   return false;
 }
 
-void TimerThread::RemoveLeadingCanceledTimersInternal() {
-  mMonitor.AssertCurrentThreadOwns();
-  AUTO_TIMERS_STATS(TimerThread_RemoveLeadingCanceledTimersInternal);
-
-  size_t toRemove = 0;
-  while (toRemove < mTimers.Length() && !mTimers[toRemove].Value()) {
-    ++toRemove;
-  }
-  mTimers.RemoveElementsAt(0, toRemove);
-}
-
-void TimerThread::RemoveFirstTimerInternal() {
-  mMonitor.AssertCurrentThreadOwns();
-  AUTO_TIMERS_STATS(TimerThread_RemoveFirstTimerInternal);
-  MOZ_ASSERT(!mTimers.IsEmpty());
-  mTimers.RemoveElementAt(0);
-}
-
 void TimerThread::PostTimerEvent(already_AddRefed<nsTimerImpl> aTimerRef) {
   mMonitor.AssertCurrentThreadOwns();
   AUTO_TIMERS_STATS(TimerThread_PostTimerEvent);
@@ -1524,13 +1597,8 @@ nsresult TimerThread::GetTimers(nsTArray<RefPtr<nsITimer>>& aRetVal) {
   nsTArray<RefPtr<nsTimerImpl>> timers;
   {
     MonitorAutoLock lock(mMonitor);
-    for (const auto& entry : mTimers) {
-      nsTimerImpl* timer = entry.Value();
-      if (!timer) {
-        continue;
-      }
-      timers.AppendElement(timer);
-    }
+    mTimers.ForEach(
+        [&](const Entry& aEntry) { timers.AppendElement(aEntry.Value()); });
   }
 
   for (nsTimerImpl* timer : timers) {
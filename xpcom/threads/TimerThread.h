@@ -16,6 +16,8 @@
 
 #include "nsTArray.h"
 
+#include <algorithm>
+
 #include "mozilla/Attributes.h"
 #include "mozilla/HalTypes.h"
 #include "mozilla/Monitor.h"
@@ -69,8 +71,6 @@ class TimerThread final : public mozilla::Runnable, public nsIObserver {
   bool AddTimerInternal(nsTimerImpl& aTimer) MOZ_REQUIRES(mMonitor);
   bool RemoveTimerInternal(nsTimerImpl& aTimer)
       MOZ_REQUIRES(mMonitor, aTimer.mMutex);
-  void RemoveLeadingCanceledTimersInternal() MOZ_REQUIRES(mMonitor);
-  void RemoveFirstTimerInternal() MOZ_REQUIRES(mMonitor);
   nsresult Init() MOZ_REQUIRES(mMonitor);
 
   void PostTimerEvent(already_AddRefed<nsTimerImpl> aTimerRef)
@@ -105,10 +105,6 @@ class TimerThread final : public mozilla::Runnable, public nsIObserver {
       aTimerImpl.SetIsInTimerThread(true);
     }
 
-    // Create an already-canceled entry with the given timeout.
-    explicit Entry(TimeStamp aTimeout)
-        : mTimeout(std::move(aTimeout)), mTimerImpl(nullptr) {}
-
     // Don't allow copies, otherwise which one would manage `IsInTimerThread`?
     Entry(const Entry&) = delete;
     Entry& operator=(const Entry&) = delete;
@@ -126,15 +122,6 @@ class TimerThread final : public mozilla::Runnable, public nsIObserver {
 
     nsTimerImpl* Value() const { return mTimerImpl; }
 
-    void Forget() {
-      if (MOZ_UNLIKELY(!mTimerImpl)) {
-        return;
-      }
-      mTimerImpl->mMutex.AssertCurrentThreadOwns();
-      mTimerImpl->SetIsInTimerThread(false);
-      mTimerImpl = nullptr;
-    }
-
     // Called with the Monitor held, but not the TimerImpl's mutex
     already_AddRefed<nsTimerImpl> Take() {
       if (MOZ_LIKELY(mTimerImpl)) {
@@ -157,11 +144,6 @@ class TimerThread final : public mozilla::Runnable, public nsIObserver {
     RefPtr<nsTimerImpl> mTimerImpl;
   };
 
-  // Computes and returns the index in mTimers at which a new timer with the
-  // specified timeout should be inserted in order to maintain "sorted" order.
-  size_t ComputeTimerInsertionIndex(const TimeStamp& timeout) const
-      MOZ_REQUIRES(mMonitor);
-
   // Computes and returns when we should next try to wake up in order to handle
   // the triggering of the timers in mTimers. Currently this is very simple and
   // we always just plan to wake up for the next timer in the list. In the
@@ -185,17 +167,109 @@ class TimerThread final : public mozilla::Runnable, public nsIObserver {
 #endif
 
 #ifdef DEBUG
-  // Checks mTimers to see if any entries are out of order or any cached
-  // timeouts are incorrect and will assert if any inconsistency is found. Has
-  // no side effects other than asserting so has no use in non-DEBUG builds.
+  // Checks mTimers to see if any entries are out of order or in the wrong slot,
+  // or any cached timeouts are incorrect, and will assert if any inconsistency
+  // is found. Has no side effects other than asserting so has no use in
+  // non-DEBUG builds.
   void VerifyTimerListConsistency() const MOZ_REQUIRES(mMonitor);
 #endif
 
-  // mTimers is maintained in a "pseudo-sorted" order wrt the timeouts.
-  // Specifcally, mTimers is sorted according to the timeouts *if you ignore the
-  // canceled entries* (those whose mTimerImpl is nullptr). Notably this means
-  // that you cannot use a binary search on this list.
-  nsTArray<Entry> mTimers MOZ_GUARDED_BY(mMonitor);
+  // The timers, in a hierarchical timing wheel keyed by their timeouts in
+  // milliseconds since mBase ("ticks").  Each level has kSlots slots, a slot of
+  // level L holding the timers whose ticks agree with mCursor above the bits
+  // of level L, and have the slot's index at level L.  So a timer goes in the
+  // lowest level whose slot range still contains it, and is moved down a level
+  // once the cursor reaches its slot.  Adding and removing a timer only
+  // touches its slot.  Timers more than kSlots^kLevels ticks away wait in
+  // mOverflow.
+  //
+  // The slots of level 0 are sorted by timeout, so the timers keep firing in
+  // the exact order of their timeouts, the ones with equal timeouts in the
+  // order they were added.  The cursor follows the current time, but only
+  // moves over empty slots, and timers due before it go in its slot, so it is
+  // never past any timer.
+  class TimerWheel final {
+   public:
+    bool IsEmpty() const { return mCount == 0; }
+
+    // Returns false if the insertion failed.
+    bool Insert(nsTimerImpl& aTimer);
+    // Returns false if aTimer isn't in the wheel.
+    bool Remove(nsTimerImpl& aTimer);
+
+    // Moves the cursor up to aNow, but not past any timer.
+    void AdvanceTo(const TimeStamp& aNow);
+
+    // The timer that fires first.  Must not be empty.
+    const Entry& First() const;
+    already_AddRefed<nsTimerImpl> TakeFirst();
+
+    // Calls aFunc with the entries in firing order, until it returns false.
+    // Only the slots it reaches beyond level 0 are sorted, so stopping early
+    // is cheap.
+    template <typename F>
+    void ForEachInOrder(F&& aFunc) const;
+
+    // Calls aFunc with every entry, in no particular order.
+    template <typename F>
+    void ForEach(F&& aFunc) {
+      for (auto& level : mSlots) {
+        for (auto& slot : level) {
+          for (Entry& entry : slot) {
+            aFunc(entry);
+          }
+        }
+      }
+      for (Entry& entry : mOverflow) {
+        aFunc(entry);
+      }
+    }
+
+    void Clear();
+
+#ifdef DEBUG
+    void VerifyConsistency() const;
+#endif
+
+   private:
+    static constexpr uint32_t kLevels = 4;
+    static constexpr uint32_t kSlotBits = 6;
+    static constexpr uint32_t kSlots = 1 << kSlotBits;
+
+    struct Location {
+      // kLevels for mOverflow.
+      uint32_t mLevel;
+      uint32_t mSlot;
+    };
+
+    uint64_t TickFor(const TimeStamp& aTimeout) const;
+    Location LocationFor(const TimeStamp& aTimeout) const;
+    nsTArray<Entry>& SlotAt(const Location& aLocation) {
+      return aLocation.mLevel == kLevels
+                 ? mOverflow
+                 : mSlots[aLocation.mLevel][aLocation.mSlot];
+    }
+
+    // Returns false if the insertion failed, which only aFallible allows.
+    bool Place(Entry&& aEntry, bool aFallible);
+    void RemoveAt(const Location& aLocation, size_t aIndex);
+    // Places the timers of aSlot again, relative to the current cursor.
+    void Cascade(nsTArray<Entry>& aSlot);
+    // The slots of aLevel after the cursor's that hold timers.
+    uint64_t LaterSlots(uint32_t aLevel) const;
+    // Moves the cursor over empty slots to aCursor.
+    void MoveCursor(uint64_t aCursor);
+
+    TimeStamp mBase;
+    uint64_t mCursor = 0;
+    size_t mCount = 0;
+    // Which slots of each level hold timers.
+    uint64_t mOccupied[kLevels] = {};
+    nsTArray<Entry> mSlots[kLevels][kSlots];
+    nsTArray<Entry> mOverflow;
+  };
+
+  TimerWheel mTimers MOZ_GUARDED_BY(mMonitor);
 
   // Set only at the start of the thread's Run():
   uint32_t mAllowedEarlyFiringMicroseconds MOZ_GUARDED_BY(mMonitor);
@@ -244,4 +318,44 @@ class TimerThread final : public mozilla::Runnable, public nsIObserver {
   void PrintStatistics() const;
 #endif
 };
+
+template <typename F>
+void TimerThread::TimerWheel::ForEachInOrder(F&& aFunc) const {
+  for (uint32_t slot = mCursor % kSlots; slot < kSlots; slot++) {
+    for (const Entry& entry : mSlots[0][slot]) {
+      if (!aFunc(entry)) {
+        return;
+      }
+    }
+  }
+
+  AutoTArray<const Entry*, 32> sorted;
+  auto visitSorted = [&](const nsTArray<Entry>& aSlot) {
+    sorted.ClearAndRetainStorage();
+    for (const Entry& entry : aSlot) {
+      sorted.AppendElement(&entry);
+    }
+    std::stable_sort(sorted.Elements(), sorted.Elements() + sorted.Length(),
+                     [](const Entry* aA, const Entry* aB) {
+                       return aA->Timeout() < aB->Timeout();
+                     });
+    for (const Entry* entry : sorted) {
+      if (!aFunc(*entry)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  for (uint32_t level = 1; level < kLevels; level++) {
+    uint32_t cursorSlot = (mCursor >> (level * kSlotBits)) % kSlots;
+    for (uint32_t slot = cursorSlot + 1; slot < kSlots; slot++) {
+      if (!visitSorted(mSlots[level][slot])) {
+        return;
+      }
+    }
+  }
+  visitSorted(mOverflow);
+}
+
 #endif /* TimerThread_h___ */